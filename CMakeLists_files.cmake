@@ -37,29 +37,41 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/timestepping/SimulatorReport.cpp
   opm/simulators/flow/countGlobalCells.cpp
   opm/simulators/flow/KeywordValidation.cpp
+  opm/simulators/linalg/BinarySystemDump.cpp
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.cpp
   opm/simulators/linalg/FlexibleSolver1.cpp
   opm/simulators/linalg/FlexibleSolver2.cpp
   opm/simulators/linalg/FlexibleSolver3.cpp
   opm/simulators/linalg/FlexibleSolver4.cpp
+  opm/simulators/linalg/FlexibleSolver5.cpp
+  opm/simulators/linalg/FlexibleSolver6.cpp
   opm/simulators/linalg/setupPropertyTree.cpp
   opm/simulators/utils/PartiallySupportedFlowKeywords.cpp
   opm/simulators/utils/readDeck.cpp
   opm/simulators/utils/UnsupportedFlowKeywords.cpp
   opm/simulators/timestepping/TimeStepControl.cpp
+  opm/simulators/timestepping/TimeStepTuningCache.cpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
   opm/simulators/timestepping/SimulatorTimer.cpp
   opm/simulators/timestepping/gatherConvergenceReport.cpp
+  opm/simulators/utils/allGatherNames.cpp
+  opm/simulators/utils/CostAccounting.cpp
   opm/simulators/utils/DeferredLogger.cpp
   opm/simulators/utils/gatherDeferredLogger.cpp
+  opm/simulators/utils/HardwareCounters.cpp
+  opm/simulators/utils/MemoryAccounting.cpp
   opm/simulators/utils/ParallelFileMerger.cpp
   opm/simulators/utils/ParallelRestart.cpp
+  opm/simulators/utils/RuntimeMetrics.cpp
+  opm/simulators/utils/ScopedTimers.cpp
+  opm/simulators/utils/sumAndMax.cpp
   opm/simulators/wells/ALQState.cpp
   opm/simulators/wells/GasLiftSingleWellGeneric.cpp
   opm/simulators/wells/GasLiftStage2.cpp
   opm/simulators/wells/GlobalWellInfo.cpp
   opm/simulators/wells/GroupState.cpp
   opm/simulators/wells/ParallelWellInfo.cpp
+  opm/simulators/wells/PerfData.cpp
   opm/simulators/wells/TargetCalculator.cpp
   opm/simulators/wells/VFPHelpers.cpp
   opm/simulators/wells/VFPProdProperties.cpp
@@ -84,6 +96,7 @@ if(OPENCL_FOUND)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/BILU0.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/Reorder.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/ChowPatelIlu.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/CPR.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/opencl.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/openclKernels.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/openclSolverBackend.cpp)
@@ -100,6 +113,13 @@ if(HAVE_FPGA)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/MultisegmentWellContribution.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/WellContributions.cpp)
 endif()
+if(HAVE_ROCSPARSE)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/rocsparseSolverBackend.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/BdaBridge.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/WellContributions.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/WellContributionsRocsparse.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/MultisegmentWellContribution.cpp)
+endif()
 
 if(MPI_FOUND)
   list(APPEND MAIN_SOURCE_FILES opm/simulators/utils/ParallelEclipseState.cpp
@@ -112,10 +132,18 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_equil.cc
   tests/test_ecl_output.cc
   tests/test_blackoil_amg.cpp
+  tests/test_adaptivesolverselector.cpp
+  tests/test_linearsolverautotuner.cpp
+  tests/test_binarycheckpoint.cpp
+  tests/test_firsttouchallocator.cpp
   tests/test_convergencereport.cpp
   tests/test_flexiblesolver.cpp
   tests/test_preconditionerfactory.cpp
   tests/test_graphcoloring.cpp
+  tests/test_blockspmv.cpp
+  tests/test_linearsystemview.cpp
+  tests/test_linearsystemscaling.cpp
+  tests/test_binarysystemdump.cpp
   tests/test_vfpproperties.cpp
   tests/test_milu.cpp
   tests/test_multmatrixtransposed.cpp
@@ -133,6 +161,13 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_keyword_validator.cpp
   tests/test_GroupState.cpp
   tests/test_ALQState.cpp
+  tests/test_PerfData.cpp
+  tests/test_segmenttreesolver.cpp
+  tests/test_sequentialsplitting.cpp
+  tests/test_chaincondensation.cpp
+  tests/test_timestepcontrol.cpp
+  tests/test_timesteptuningcache.cpp
+  tests/test_runtimemetrics.cpp
   )
 
 if(MPI_FOUND)
@@ -213,6 +248,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/aquifers/BlackoilAquiferModel.hpp
   opm/simulators/aquifers/BlackoilAquiferModel_impl.hpp
   opm/simulators/linalg/bda/BdaBridge.hpp
+  opm/simulators/linalg/bda/BdaCommunication.hpp
   opm/simulators/linalg/bda/BdaResult.hpp
   opm/simulators/linalg/bda/BdaSolver.hpp
   opm/simulators/linalg/bda/BILU0.hpp
@@ -220,6 +256,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/bda/cuda_header.hpp
   opm/simulators/linalg/bda/cusparseSolverBackend.hpp
   opm/simulators/linalg/bda/ChowPatelIlu.hpp
+  opm/simulators/linalg/bda/CPR.hpp
   opm/simulators/linalg/bda/FPGAMatrix.hpp
   opm/simulators/linalg/bda/FPGABILU0.hpp
   opm/simulators/linalg/bda/FPGASolverBackend.hpp
@@ -229,29 +266,44 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/bda/opencl.hpp
   opm/simulators/linalg/bda/openclKernels.hpp
   opm/simulators/linalg/bda/openclSolverBackend.hpp
+  opm/simulators/linalg/bda/rocsparse_header.hpp
+  opm/simulators/linalg/bda/rocsparseSolverBackend.hpp
   opm/simulators/linalg/bda/MultisegmentWellContribution.hpp
   opm/simulators/linalg/bda/WellContributions.hpp
   opm/simulators/linalg/amgcpr.hh
   opm/simulators/linalg/twolevelmethodcpr.hh
+  opm/simulators/linalg/AdaptiveSolverSelector.hpp
+  opm/simulators/linalg/BinarySystemDump.hpp
+  opm/simulators/linalg/blockSpMV.hpp
+  opm/simulators/linalg/ChainCondensation.hpp
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp
+  opm/simulators/linalg/FirstTouchAllocator.hpp
   opm/simulators/linalg/FlexibleSolver.hpp
   opm/simulators/linalg/FlexibleSolver_impl.hpp
   opm/simulators/linalg/FlowLinearSolverParameters.hpp
   opm/simulators/linalg/GraphColoring.hpp
   opm/simulators/linalg/ISTLSolverEbos.hpp
   opm/simulators/linalg/ISTLSolverEbosFlexible.hpp
+  opm/simulators/linalg/LinearSolverAutotuner.hpp
+  opm/simulators/linalg/LinearSystemScaling.hpp
+  opm/simulators/linalg/LinearSystemView.hpp
   opm/simulators/linalg/MatrixBlock.hpp
   opm/simulators/linalg/MatrixMarketSpecializations.hpp
   opm/simulators/linalg/OwningBlockPreconditioner.hpp
+  opm/simulators/linalg/OwningRestrictedAdditiveSchwarz.hpp
   opm/simulators/linalg/OwningTwoLevelPreconditioner.hpp
   opm/simulators/linalg/ParallelOverlappingILU0.hpp
   opm/simulators/linalg/ParallelRestrictedAdditiveSchwarz.hpp
   opm/simulators/linalg/ParallelIstlInformation.hpp
+  opm/simulators/linalg/PipelinedSolvers.hpp
   opm/simulators/linalg/PressureSolverPolicy.hpp
   opm/simulators/linalg/PressureTransferPolicy.hpp
   opm/simulators/linalg/PreconditionerFactory.hpp
   opm/simulators/linalg/PreconditionerWithUpdate.hpp
+  opm/simulators/linalg/RecycledGMResSolver.hpp
+  opm/simulators/linalg/SequentialSplitting.hpp
   opm/simulators/linalg/WellOperators.hpp
+  opm/simulators/linalg/WellSystemBlocksProvider.hpp
   opm/simulators/linalg/WriteSystemMatrixHelper.hpp
   opm/simulators/linalg/findOverlapRowsAndColumns.hpp
   opm/simulators/linalg/getQuasiImpesWeights.hpp
@@ -262,17 +314,26 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/timestepping/ConvergenceReport.hpp
   opm/simulators/timestepping/TimeStepControl.hpp
   opm/simulators/timestepping/TimeStepControlInterface.hpp
+  opm/simulators/timestepping/TimeStepTuningCache.hpp
   opm/simulators/timestepping/SimulatorTimer.hpp
   opm/simulators/timestepping/SimulatorTimerInterface.hpp
   opm/simulators/timestepping/gatherConvergenceReport.hpp
   opm/simulators/utils/ParallelFileMerger.hpp
+  opm/simulators/utils/BinaryCheckpoint.hpp
+  opm/simulators/utils/allGatherNames.hpp
+  opm/simulators/utils/CostAccounting.hpp
   opm/simulators/utils/DeferredLoggingErrorHelpers.hpp
   opm/simulators/utils/DeferredLogger.hpp
   opm/simulators/utils/gatherDeferredLogger.hpp
+  opm/simulators/utils/HardwareCounters.hpp
+  opm/simulators/utils/MemoryAccounting.hpp
   opm/simulators/utils/moduleVersion.hpp
   opm/simulators/utils/ParallelEclipseState.hpp
   opm/simulators/utils/ParallelRestart.hpp
+  opm/simulators/utils/RuntimeMetrics.hpp
   opm/simulators/utils/PropsCentroidsDataHandle.hpp
+  opm/simulators/utils/ScopedTimers.hpp
+  opm/simulators/utils/sumAndMax.hpp
   opm/simulators/wells/PerforationData.hpp
   opm/simulators/wells/RateConverter.hpp
   opm/simulators/utils/readDeck.hpp
@@ -282,6 +343,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/wells/GlobalWellInfo.hpp
   opm/simulators/wells/GroupState.hpp
   opm/simulators/wells/ALQState.hpp
+  opm/simulators/wells/PerfData.hpp
   opm/simulators/wells/WGState.hpp
   opm/simulators/wells/VFPProperties.hpp
   opm/simulators/wells/VFPHelpers.hpp
@@ -297,11 +359,14 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/wells/MultisegmentWell.hpp
   opm/simulators/wells/MultisegmentWell_impl.hpp
   opm/simulators/wells/MSWellHelpers.hpp
+  opm/simulators/wells/SegmentTreeSolver.hpp
   opm/simulators/wells/BlackoilWellModel.hpp
   opm/simulators/wells/BlackoilWellModel_impl.hpp
   opm/simulators/wells/ParallelWellInfo.hpp
   )
 
 list (APPEND EXAMPLE_SOURCE_FILES
+  examples/flow_linsolve_bench.cpp
+  examples/flow_wellkernels_bench.cpp
   examples/printvfp.cpp
   )
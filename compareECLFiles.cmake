@@ -165,6 +165,40 @@ function(add_test_compare_parallel_restarted_simulation)
                        PROPERTIES RUN_SERIAL 1)
 endfunction()
 
+###########################################################################
+# TEST: add_test_performance
+###########################################################################
+
+# Input:
+#   - casename: basename (no extension)
+#
+# Details:
+#   - This test class runs a simulation with a fixed number of processes
+#     and threads and compares the time of the timers to a baseline. The
+#     tests are run with ctest -C performance.
+function(add_test_performance)
+  set(oneValueArgs CASENAME FILENAME SIMULATOR PROCS THREADS REL_TOL ABS_TOL DIR)
+  set(multiValueArgs TEST_ARGS)
+  cmake_parse_arguments(PARAM "$" "${oneValueArgs}" "${multiValueArgs}" ${ARGN} )
+  if(NOT PARAM_DIR)
+    set(PARAM_DIR ${PARAM_CASENAME})
+  endif()
+  set(TEST_NAME performance_${PARAM_SIMULATOR}+${PARAM_CASENAME}_np${PARAM_PROCS}_t${PARAM_THREADS})
+  set(RESULT_PATH ${BASE_RESULT_PATH}/performance/${PARAM_SIMULATOR}+${PARAM_CASENAME}_np${PARAM_PROCS}_t${PARAM_THREADS})
+  set(TEST_ARGS ${OPM_TESTS_ROOT}/${PARAM_DIR}/${PARAM_FILENAME} ${PARAM_TEST_ARGS})
+  opm_add_test(${TEST_NAME} NO_COMPILE
+               EXE_NAME ${PARAM_SIMULATOR}
+               DRIVER_ARGS ${OPM_TESTS_ROOT}/${PARAM_DIR} ${RESULT_PATH}
+                           ${PROJECT_BINARY_DIR}/bin
+                           ${PARAM_FILENAME}
+                           ${PARAM_PROCS} ${PARAM_THREADS}
+                           ${PARAM_REL_TOL} ${PARAM_ABS_TOL}
+                           ${OPM_PERFORMANCE_BASELINE_DIR}
+               TEST_ARGS ${TEST_ARGS}
+               CONFIGURATION performance)
+  set_tests_properties(${TEST_NAME} PROPERTIES RUN_SERIAL 1)
+endfunction()
+
 if(NOT TARGET test-suite)
   add_custom_target(test-suite)
 endif()
@@ -1096,3 +1130,47 @@ if(MPI_FOUND)
                                        DIR udq_actionx
                                        TEST_ARGS --linear-solver-reduction=1e-7 --tolerance-cnv=5e-6 --tolerance-mb=1e-6)
 endif()
+
+# Performance tests. The baselines depend on the machine, the first run
+# on a machine stores them in OPM_PERFORMANCE_BASELINE_DIR.
+set(OPM_PERFORMANCE_BASELINE_DIR ${PROJECT_BINARY_DIR}/tests/performance-baselines
+    CACHE PATH "Directory of the baseline timers of the performance tests")
+opm_set_test_driver(${PROJECT_SOURCE_DIR}/tests/run-performanceTest.sh "")
+
+# Slower by more than 10% and by more than 0.5 seconds fails.
+set(perf_rel_tol 0.1)
+set(perf_abs_tol 0.5)
+
+add_test_performance(CASENAME spe1
+                     FILENAME SPE1CASE1
+                     SIMULATOR flow
+                     PROCS 1
+                     THREADS 1
+                     REL_TOL ${perf_rel_tol}
+                     ABS_TOL ${perf_abs_tol})
+
+add_test_performance(CASENAME spe9
+                     FILENAME SPE9_CP_SHORT
+                     SIMULATOR flow
+                     PROCS 1
+                     THREADS 1
+                     REL_TOL ${perf_rel_tol}
+                     ABS_TOL ${perf_abs_tol})
+
+add_test_performance(CASENAME norne
+                     FILENAME NORNE_ATW2013
+                     SIMULATOR flow
+                     PROCS 1
+                     THREADS 2
+                     REL_TOL ${perf_rel_tol}
+                     ABS_TOL ${perf_abs_tol})
+
+if(MPI_FOUND)
+  add_test_performance(CASENAME norne
+                       FILENAME NORNE_ATW2013
+                       SIMULATOR flow
+                       PROCS 4
+                       THREADS 1
+                       REL_TOL ${perf_rel_tol}
+                       ABS_TOL ${perf_abs_tol})
+endif()
@@ -71,7 +71,10 @@ namespace Opm {
  *
  * \brief Helper class for grid instantiation of ECL file-format using problems.
  *
- * This class uses Dune::ALUGrid as the simulation grid.
+ * This class uses Dune::ALUGrid as the simulation grid. The grid is not adapted
+ * during the simulation: the macro grid of ALUGrid is the ECL grid, i.e., its cells
+ * can only be refined but not coarsened, and the properties, transmissibilities and
+ * well connections of the problem are computed once for the cells of the ECL grid.
  */
 template <class TypeTag>
 class EclAluGridVanguard : public EclBaseVanguard<TypeTag>
@@ -108,6 +108,13 @@ public:
                      unsigned timeIdx OPM_UNUSED) const
     { }
 
+    /*!
+     * \brief The cells of every numerical aquifer in the order in which they
+     *        are connected, for the linear solver to condense them.
+     */
+    std::vector<std::vector<int>> numericalAquiferChains() const
+    { return {}; }
+
     /*!
      * \brief This method is called after each Newton-Raphson successful iteration.
      *
@@ -40,6 +40,7 @@
 
 #include <array>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -72,6 +73,14 @@ struct SchedRestart {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct ParseDeckOnAllRanks {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct DeckCacheDir {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct EclOutputInterval {
     using type = UndefinedProperty;
 };
@@ -98,6 +107,21 @@ struct ZoltanImbalanceTol {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct PartitionMethod {
+    using type = UndefinedProperty;
+};
+
+template<class TypeTag, class MyTypeTag>
+struct PartitionFile {
+    using type = UndefinedProperty;
+};
+
+template<class TypeTag, class MyTypeTag>
+struct OverlapLayers {
+    using type = UndefinedProperty;
+};
+
 template<class TypeTag, class MyTypeTag>
 struct AllowDistributedWells {
     using type = UndefinedProperty;
@@ -128,6 +152,14 @@ struct SchedRestart<TypeTag, TTag::EclBaseVanguard> {
     static constexpr bool value = true;
 };
 template<class TypeTag>
+struct ParseDeckOnAllRanks<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct DeckCacheDir<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
 struct EdgeWeightsMethod<TypeTag, TTag::EclBaseVanguard> {
     static constexpr int value = 1;
 };
@@ -145,6 +177,21 @@ struct ZoltanImbalanceTol<TypeTag, TTag::EclBaseVanguard> {
     static constexpr double value = 1.1;
 };
 
+template<class TypeTag>
+struct PartitionMethod<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr auto value = "zoltan";
+};
+
+template<class TypeTag>
+struct PartitionFile<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr auto value = "";
+};
+
+template<class TypeTag>
+struct OverlapLayers<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr int value = 1;
+};
+
 template<class TypeTag>
 struct AllowDistributedWells<TypeTag, TTag::EclBaseVanguard> {
     static constexpr bool value = false;
@@ -207,6 +254,10 @@ public:
                              "Use strict mode for parsing - all errors are collected before the applicaton exists.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, SchedRestart,
                              "When restarting: should we try to initialize wells and groups from historical SCHEDULE section.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, ParseDeckOnAllRanks,
+                             "Parse the deck on every process instead of parsing it on the root process and broadcasting the result.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, DeckCacheDir,
+                             "Directory for a cache of parsed decks and grid partitionings. Unchanged decks are read from the cache instead of being parsed and partitioned again.");
         EWOMS_REGISTER_PARAM(TypeTag, int, EdgeWeightsMethod,
                              "Choose edge-weighing strategy: 0=uniform, 1=trans, 2=log(trans).");
         EWOMS_REGISTER_PARAM(TypeTag, bool, OwnerCellsFirst,
@@ -215,6 +266,12 @@ public:
                              "Perform partitioning for parallel runs on a single process.");
         EWOMS_REGISTER_PARAM(TypeTag, double, ZoltanImbalanceTol,
                              "Tolerable imbalance of the loadbalancing provided by Zoltan (default: 1.1).");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, PartitionMethod,
+                             "Method for partitioning the grid for parallel runs: 'zoltan' (graph partitioning), 'zlayers' (layers of the Cartesian grid), 'rcb' (recursive coordinate bisection of the cell centers) or 'file' (read from the file given by --partition-file).");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, PartitionFile,
+                             "File with the process of every cell for --partition-method=file, e.g. the output of METIS or KaHIP. It holds one integer per active cell or per cell of the Cartesian grid.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, OverlapLayers,
+                             "Number of layers of overlap cells around the cells owned by each process. More layers give the restricted additive Schwarz preconditioner (ras) larger subdomains.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, AllowDistributedWells,
                              "Allow the perforations of a well to be distributed to interior of multiple processes");
         // register here for the use in the tests without BlackoildModelParametersEbos
@@ -236,9 +293,14 @@ public:
         ownersFirst_ = EWOMS_GET_PARAM(TypeTag, bool, OwnerCellsFirst);
         serialPartitioning_ = EWOMS_GET_PARAM(TypeTag, bool, SerialPartitioning);
         zoltanImbalanceTol_ = EWOMS_GET_PARAM(TypeTag, double, ZoltanImbalanceTol);
+        partitionMethod_ = EWOMS_GET_PARAM(TypeTag, std::string, PartitionMethod);
+        partitionFile_ = EWOMS_GET_PARAM(TypeTag, std::string, PartitionFile);
+        overlapLayers_ = EWOMS_GET_PARAM(TypeTag, int, OverlapLayers);
         enableDistributedWells_ = EWOMS_GET_PARAM(TypeTag, bool, AllowDistributedWells);
         ignoredKeywords_ = EWOMS_GET_PARAM(TypeTag, std::string, IgnoreKeywords);
         eclStrictParsing_ = EWOMS_GET_PARAM(TypeTag, bool, EclStrictParsing);
+        parseDeckOnAllRanks_ = EWOMS_GET_PARAM(TypeTag, bool, ParseDeckOnAllRanks);
+        deckCacheDir_ = EWOMS_GET_PARAM(TypeTag, std::string, DeckCacheDir);
         int output_param = EWOMS_GET_PARAM(TypeTag, int, EclOutputInterval);
         if (output_param >= 0)
             outputInterval_ = output_param;
@@ -297,8 +359,10 @@ public:
      */
     int compressedIndex(int cartesianCellIdx) const
     {
-        int index = cartesianToCompressed_[cartesianCellIdx];
-        return index;
+        auto index_pair = cartesianToCompressed_.find(cartesianCellIdx);
+        if (index_pair == cartesianToCompressed_.end())
+            return -1;
+        return index_pair->second;
     }
 
     /*!
@@ -399,10 +463,11 @@ protected:
     void updateCartesianToCompressedMapping_()
     {
         size_t num_cells = asImp_().grid().leafGridView().size(0);
-        cartesianToCompressed_.resize(cartesianSize(), -1);
+        cartesianToCompressed_.clear();
+        cartesianToCompressed_.reserve(num_cells);
         for (unsigned i = 0; i < num_cells; ++i) {
             unsigned cartesianCellIdx = cartesianIndex(i);
-            cartesianToCompressed_[cartesianCellIdx] = i;
+            cartesianToCompressed_.emplace(cartesianCellIdx, i);
         }
     }
 
@@ -482,7 +547,9 @@ protected:
     /*! \brief Mapping between cartesian and compressed cells.
      *  It is initialized the first time it is called
      */
-    std::vector<int> cartesianToCompressed_;
+    // Only holds the local cells, a dense array of the Cartesian size would
+    // dominate the memory of large grids with few active cells.
+    std::unordered_map<int, int> cartesianToCompressed_;
 
     /*! \brief Cell center depths
      */
@@ -133,9 +133,12 @@ public:
 #if HAVE_MPI
         this->doLoadBalance_(this->edgeWeightsMethod(), this->ownersFirst(),
                              this->serialPartitioning(), this->enableDistributedWells(),
-                             this->zoltanImbalanceTol(), this->gridView(),
+                             this->zoltanImbalanceTol(), this->partitionMethod(),
+                             this->partitionFile(), this->overlapLayers(),
+                             this->gridView(),
                              this->schedule(), this->centroids_,
-                             this->eclState(), this->parallelWells_);
+                             this->eclState(), this->parallelWells_,
+                             this->deckCacheDir());
 #endif
 
         this->allocCartMapper();
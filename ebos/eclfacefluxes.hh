@@ -0,0 +1,117 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::EclFaceFluxes
+ */
+#ifndef EWOMS_ECL_FACE_FLUXES_HH
+#define EWOMS_ECL_FACE_FLUXES_HH
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup EclBlackOilSimulator
+ *
+ * \brief The phase fluxes over the interior faces of every cell, as computed
+ *        by the flux module for the current solution.
+ *
+ * The flux module records the fluxes whenever it evaluates a face at the
+ * current time, so that after the linearization of a Newton iteration they
+ * are available to models which are solved after the flow, like the tracers,
+ * without another pass over the grid. Nothing is recorded unless enabled.
+ */
+template <class Scalar, unsigned numPhases>
+class EclFaceFluxes
+{
+public:
+    struct Face
+    {
+        //! \brief Global index of the cell on the other side of the face.
+        unsigned exterior;
+        //! \brief Global index of the upstream cell of every phase.
+        std::array<unsigned, numPhases> upstream;
+        //! \brief Volume flux times face area of every phase, out of the cell.
+        std::array<Scalar, numPhases> flux;
+    };
+
+    /*!
+     * \brief Start recording the fluxes of the numFaces[cellIdx] interior faces
+     *        of every cell.
+     */
+    void enable(const std::vector<unsigned>& numFaces)
+    {
+        offsets_.assign(numFaces.size() + 1, 0);
+        for (std::size_t cellIdx = 0; cellIdx < numFaces.size(); ++cellIdx)
+            offsets_[cellIdx + 1] = offsets_[cellIdx] + numFaces[cellIdx];
+        faces_.resize(offsets_.back());
+        updated_ = false;
+    }
+
+    bool enabled() const
+    { return !offsets_.empty(); }
+
+    /*!
+     * \brief Record a face of a cell. Faces of different cells may be recorded
+     *        concurrently.
+     */
+    void record(unsigned cellIdx, unsigned faceIdx, const Face& face)
+    {
+        faces_[offsets_[cellIdx] + faceIdx] = face;
+        if (!updated_.load(std::memory_order_relaxed))
+            updated_.store(true, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Forget that the fluxes were recorded, e.g. at the beginning of a
+     *        time step.
+     */
+    void invalidate()
+    { updated_ = false; }
+
+    /*!
+     * \brief Whether the fluxes have been recorded since the last invalidate().
+     */
+    bool updated() const
+    { return updated_; }
+
+    unsigned numFaces(unsigned cellIdx) const
+    { return offsets_[cellIdx + 1] - offsets_[cellIdx]; }
+
+    const Face& face(unsigned cellIdx, unsigned faceIdx) const
+    { return faces_[offsets_[cellIdx] + faceIdx]; }
+
+private:
+    std::vector<std::size_t> offsets_;
+    std::vector<Face> faces_;
+    std::atomic<bool> updated_{false};
+};
+
+} // namespace Opm
+
+#endif
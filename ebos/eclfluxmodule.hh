@@ -31,6 +31,8 @@
 #ifndef EWOMS_ECL_FLUX_MODULE_HH
 #define EWOMS_ECL_FLUX_MODULE_HH
 
+#include <ebos/eclfacefluxes.hh>
+
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 #include <opm/models/blackoil/blackoilproperties.hh>
 #include <opm/models/utils/signum.hh>
@@ -106,6 +108,7 @@ class EclTransExtensiveQuantities
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using MaterialLaw = GetPropType<TypeTag, Properties::MaterialLaw>;
+    using Indices = GetPropType<TypeTag, Properties::Indices>;
 
     enum { dimWorld = GridView::dimensionworld };
     enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
@@ -226,30 +229,22 @@ protected:
 
         Scalar trans = problem.transmissibility(elemCtx, interiorDofIdx_, exteriorDofIdx_);
         Scalar faceArea = scvf.area();
-        Scalar thpres = problem.thresholdPressure(I, J);
-
-        // estimate the gravity correction: for performance reasons we use a simplified
-        // approach for this flux module that assumes that gravity is constant and always
-        // acts into the downwards direction. (i.e., no centrifuge experiments, sorry.)
-        Scalar g = elemCtx.problem().gravity()[dimWorld - 1];
+        Scalar thpres = problem.thresholdPressure(elemCtx, interiorDofIdx_, exteriorDofIdx_);
 
         const auto& intQuantsIn = elemCtx.intensiveQuantities(interiorDofIdx_, timeIdx);
         const auto& intQuantsEx = elemCtx.intensiveQuantities(exteriorDofIdx_, timeIdx);
 
-        // this is quite hacky because the dune grid interface does not provide a
-        // cellCenterDepth() method (so we ask the problem to provide it). The "good"
-        // solution would be to take the Z coordinate of the element centroids, but since
-        // ECL seems to like to be inconsistent on that front, it needs to be done like
-        // here...
-        Scalar zIn = problem.dofCenterDepth(elemCtx, interiorDofIdx_, timeIdx);
-        Scalar zEx = problem.dofCenterDepth(elemCtx, exteriorDofIdx_, timeIdx);
-
-        // the distances from the DOF's depths. (i.e., the additional depth of the
-        // exterior DOF)
-        Scalar distZ = zIn - zEx;
+        // estimate the gravity correction: for performance reasons we use a simplified
+        // approach for this flux module that assumes that gravity is constant and always
+        // acts into the downwards direction. (i.e., no centrifuge experiments, sorry.)
+        // The gravity times the additional depth of the exterior DOF is prefetched per
+        // face by the problem, from the cell center depths of the grid: the dune grid
+        // interface does not provide a cellCenterDepth() method, and the Z coordinate
+        // of the element centroids is inconsistent with ECL.
+        Scalar distZg = problem.gravityDepthDifference(elemCtx, interiorDofIdx_, exteriorDofIdx_);
 
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!phaseIsEnabled_(phaseIdx) || !FluidSystem::phaseIsActive(phaseIdx))
                 continue;
 
             // check shortcut: if the mobility of the phase is zero in the interior as
@@ -274,9 +269,9 @@ protected:
             Evaluation pressureExterior = Toolbox::value(intQuantsEx.fluidState().pressure(phaseIdx));
             if (enableExtbo) // added stability; particulary useful for solvent migrating in pure water
                              // where the solvent fraction displays a 0/1 behaviour ...
-                pressureExterior += Toolbox::value(rhoAvg)*(distZ*g);
+                pressureExterior += Toolbox::value(rhoAvg)*distZg;
             else
-                pressureExterior += rhoAvg*(distZ*g);
+                pressureExterior += rhoAvg*distZg;
 
             pressureDifference_[phaseIdx] = pressureExterior - pressureInterior;
 
@@ -354,6 +349,24 @@ protected:
                 volumeFlux_[phaseIdx] =
                     pressureDifference_[phaseIdx]*(Toolbox::value(up.mobility(phaseIdx))*Toolbox::value(transMult)*(-trans/faceArea));
         }
+
+        // record the fluxes of the current solution for the models which are
+        // solved after the flow
+        auto& faceFluxes = problem.faceFluxes();
+        if (timeIdx == 0 && faceFluxes.enabled()) {
+            typename EclFaceFluxes<Scalar, numPhases>::Face face;
+            face.exterior = J;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                if (!phaseIsEnabled_(phaseIdx) || !FluidSystem::phaseIsActive(phaseIdx)) {
+                    face.upstream[phaseIdx] = I;
+                    face.flux[phaseIdx] = 0.0;
+                    continue;
+                }
+                face.upstream[phaseIdx] = stencil.globalSpaceIndex(upIdx_[phaseIdx]);
+                face.flux[phaseIdx] = Toolbox::value(volumeFlux_[phaseIdx])*faceArea;
+            }
+            faceFluxes.record(I, scvfIdx, face);
+        }
     }
 
     /*!
@@ -399,7 +412,7 @@ protected:
         Scalar distZ = zIn - zEx;
 
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!phaseIsEnabled_(phaseIdx) || !FluidSystem::phaseIsActive(phaseIdx))
                 continue;
 
             // do the gravity correction: compute the hydrostatic pressure for the
@@ -477,6 +490,18 @@ protected:
     {}
 
 private:
+    // Whether the primary variables of the model include the phase at all. The
+    // phases which are disabled at compile time are skipped without asking the
+    // fluid system, and the code for them is removed from the unrolled phase loops.
+    static constexpr bool phaseIsEnabled_(unsigned phaseIdx)
+    {
+        if (phaseIdx == FluidSystem::waterPhaseIdx)
+            return Indices::waterEnabled;
+        if (phaseIdx == FluidSystem::oilPhaseIdx)
+            return Indices::oilEnabled;
+        return Indices::gasEnabled;
+    }
+
     Implementation& asImp_()
     { return *static_cast<Implementation*>(this); }
 
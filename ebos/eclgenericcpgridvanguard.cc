@@ -28,7 +28,9 @@
 #include <ebos/eclmpiserializer.hh>
 #endif
 
+#include <opm/common/ErrorMacros.hpp>
 #include <opm/common/utility/ActiveGridCells.hpp>
+#include <opm/common/utility/FileSystem.hpp>
 #include <opm/grid/cpgrid/GridHelpers.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/simulators/utils/ParallelEclipseState.hpp>
@@ -46,9 +48,19 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <fstream>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+#include <unistd.h>
 
 namespace Opm {
 
@@ -72,17 +84,228 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::releaseEquilGrid()
 }
 
 #if HAVE_MPI
+namespace {
+
+// The name of the file of a cached partitioning of the grid. It depends on
+// everything which decides whether a partitioning is valid and how it is
+// computed: the active cells, the well connections, the number of processes
+// and the partitioning options.
+std::string partitionCacheFile(const std::string& cacheDir,
+                               const std::vector<int>& globalCell,
+                               const std::vector<Well>& wells,
+                               int mpiSize,
+                               Dune::EdgeWeightMethod edgeWeightsMethod,
+                               bool serialPartitioning,
+                               bool enableDistributedWells,
+                               double zoltanImbalanceTol)
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto add = [&hash](const auto& value)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (std::size_t i = 0; i < sizeof(value); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    add(globalCell.size());
+    for (const int cell : globalCell)
+        add(cell);
+    for (const auto& well : wells) {
+        for (const char c : well.name())
+            add(c);
+        for (const auto& connection : well.getConnections())
+            add(connection.global_index());
+    }
+    add(mpiSize);
+    add(static_cast<int>(edgeWeightsMethod));
+    add(serialPartitioning);
+    add(enableDistributedWells);
+    add(zoltanImbalanceTol);
+
+    return fmt::format("{}/{:016x}.OPMPART", cacheDir, hash);
+}
+
+// The process of every cell, empty unless the file holds a partitioning of
+// numCells cells on mpiSize processes.
+std::vector<int> readPartition(const std::string& fileName, std::size_t numCells, int mpiSize)
+{
+    std::ifstream is(fileName, std::ios::binary);
+    std::uint64_t size = 0;
+    if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)) || size != numCells)
+        return {};
+
+    std::vector<int> parts(numCells);
+    if (!is.read(reinterpret_cast<char*>(parts.data()), numCells * sizeof(int)))
+        return {};
+    for (const int part : parts)
+        if (part < 0 || part >= mpiSize)
+            return {};
+    return parts;
+}
+
+void writePartition(const std::string& fileName, const std::vector<int>& parts)
+{
+    // other runs may read the cache at the same time, they only see
+    // complete files.
+    const std::string tmpFile = fileName + ".tmp" + std::to_string(::getpid());
+    std::error_code ec;
+    Opm::filesystem::create_directories(Opm::filesystem::path(fileName).parent_path(), ec);
+    {
+        std::ofstream os(tmpFile, std::ios::binary);
+        const std::uint64_t size = parts.size();
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os.write(reinterpret_cast<const char*>(parts.data()), parts.size() * sizeof(int));
+        if (!os) {
+            Opm::filesystem::remove(tmpFile, ec);
+            OpmLog::warning("Writing the partitioning cache file '" + fileName + "' failed");
+            return;
+        }
+    }
+    Opm::filesystem::rename(tmpFile, fileName, ec);
+    if (ec)
+        Opm::filesystem::remove(tmpFile, ec);
+}
+
+// The process of every cell read from a text file with one integer per
+// active cell or per cell of the Cartesian grid, like the partitionings
+// written by METIS or KaHIP. Empty if the file is not usable.
+std::vector<int> readPartitionFile(const std::string& fileName,
+                                   const std::vector<int>& globalCell,
+                                   int cartesianSize,
+                                   int mpiSize)
+{
+    std::ifstream is(fileName);
+    if (!is) {
+        OpmLog::error("Cannot open the partitioning file '" + fileName + "'");
+        return {};
+    }
+
+    std::vector<int> fileParts;
+    int part;
+    while (is >> part)
+        fileParts.push_back(part);
+    if (!is.eof()) {
+        OpmLog::error("The partitioning file '" + fileName + "' holds other entries than integers");
+        return {};
+    }
+
+    std::vector<int> parts;
+    if (fileParts.size() == globalCell.size())
+        parts = std::move(fileParts);
+    else if (fileParts.size() == static_cast<std::size_t>(cartesianSize)) {
+        parts.reserve(globalCell.size());
+        for (const int cell : globalCell)
+            parts.push_back(fileParts[cell]);
+    }
+    else {
+        OpmLog::error(fmt::format("The partitioning file '{}' has {} entries, expected one per active cell ({}) "
+                                  "or per cell of the Cartesian grid ({})",
+                                  fileName, fileParts.size(), globalCell.size(), cartesianSize));
+        return {};
+    }
+
+    for (const int p : parts) {
+        if (p < 0 || p >= mpiSize) {
+            OpmLog::error(fmt::format("The partitioning file '{}' assigns cells to process {}, "
+                                      "but the run only uses {} processes", fileName, p, mpiSize));
+            return {};
+        }
+    }
+    return parts;
+}
+
+// Layers of the Cartesian grid of about the same number of layers per process.
+std::vector<int> zLayerPartition(const Dune::CpGrid& grid,
+                                 const Dune::CartesianIndexMapper<Dune::CpGrid>& cartMapper,
+                                 int mpiSize)
+{
+    const int nz = cartMapper.cartesianDimensions()[2];
+    const int layersPerProc = nz / mpiSize;
+    if (grid.size(0) > 0 && layersPerProc == 0) {
+        OpmLog::error(fmt::format("Partitioning into layers needs at least as many layers ({}) as processes ({})",
+                                  nz, mpiSize));
+        return {};
+    }
+
+    std::vector<int> parts(grid.size(0));
+    std::array<int, 3> ijk;
+    for (std::size_t cellIdx = 0; cellIdx < parts.size(); ++cellIdx) {
+        cartMapper.cartesianCoordinate(cartMapper.cartesianIndex(cellIdx), ijk);
+        parts[cellIdx] = std::min(mpiSize - 1, ijk[2] / layersPerProc);
+    }
+    return parts;
+}
+
+// Recursive coordinate bisection of the cell centers: the cells are split
+// across the direction of the largest extent into two sets whose sizes are
+// proportional to the number of processes of each half.
+std::vector<int> rcbPartition(const Dune::CpGrid& grid, int mpiSize)
+{
+    using Point = std::array<double, 3>;
+    std::vector<Point> centers;
+    centers.reserve(grid.size(0));
+    for (const auto& element : elements(grid.leafGridView())) {
+        const auto center = element.geometry().center();
+        centers.push_back({center[0], center[1], center[2]});
+    }
+
+    std::vector<int> cells(centers.size());
+    std::iota(cells.begin(), cells.end(), 0);
+    std::vector<int> parts(centers.size(), 0);
+
+    const auto bisect = [&centers, &parts](auto& self, auto first, auto last,
+                                           int firstPart, int numParts) -> void
+    {
+        if (numParts == 1 || first == last) {
+            std::for_each(first, last, [&parts, firstPart](int cell) { parts[cell] = firstPart; });
+            return;
+        }
+
+        Point lower = centers[*first];
+        Point upper = lower;
+        std::for_each(first, last, [&](int cell) {
+            for (int d = 0; d < 3; ++d) {
+                lower[d] = std::min(lower[d], centers[cell][d]);
+                upper[d] = std::max(upper[d], centers[cell][d]);
+            }
+        });
+        int axis = 0;
+        for (int d = 1; d < 3; ++d)
+            if (upper[d] - lower[d] > upper[axis] - lower[axis])
+                axis = d;
+
+        const int numLeft = numParts / 2;
+        const auto mid = first + std::distance(first, last) * numLeft / numParts;
+        std::nth_element(first, mid, last, [&centers, axis](int a, int b)
+                         { return centers[a][axis] < centers[b][axis]; });
+        self(self, first, mid, firstPart, numLeft);
+        self(self, mid, last, firstPart + numLeft, numParts - numLeft);
+    };
+    bisect(bisect, cells.begin(), cells.end(), 0, mpiSize);
+
+    return parts;
+}
+
+}
+
 template<class ElementMapper, class GridView, class Scalar>
 void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dune::EdgeWeightMethod edgeWeightsMethod,
                                                                              bool ownersFirst,
                                                                              bool serialPartitioning,
                                                                              bool enableDistributedWells,
                                                                              double zoltanImbalanceTol,
+                                                                             const std::string& partitionMethod,
+                                                                             const std::string& partitionFile,
+                                                                             int overlapLayers,
                                                                              const GridView& gridv,
                                                                              const Schedule& schedule,
                                                                              std::vector<double>& centroids,
                                                                              EclipseState& eclState1,
-                                                                             EclGenericVanguard::ParallelWellStruct& parallelWells)
+                                                                             EclGenericVanguard::ParallelWellStruct& parallelWells,
+                                                                             const std::string& partitionCacheDir)
 {
     int mpiSize = 1;
     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
@@ -106,7 +329,59 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
         std::vector<double> faceTrans;
         int loadBalancerSet = externalLoadBalancer.has_value();
         grid_->comm().broadcast(&loadBalancerSet, 1, 0);
-        if (!loadBalancerSet){
+
+        // The partitioning by one of the methods besides Zoltan, computed on
+        // the root process.
+        if (partitionMethod != "zoltan" && partitionMethod != "file" &&
+            partitionMethod != "zlayers" && partitionMethod != "rcb")
+        {
+            OPM_THROW(std::invalid_argument, "Unknown partition method '" << partitionMethod
+                      << "', use one of 'zoltan', 'zlayers', 'rcb' or 'file'");
+        }
+        const bool usePartitioner = !loadBalancerSet && partitionMethod != "zoltan";
+        std::vector<int> partitionerParts;
+        if (usePartitioner) {
+            int partitionerFailed = 0;
+            if (grid_->comm().rank() == 0) {
+                if (partitionMethod == "file") {
+                    OpmLog::info("Reading the partitioning of the grid from the file '" + partitionFile + "'");
+                    partitionerParts = readPartitionFile(partitionFile, grid_->globalCell(),
+                                                         cartesianIndexMapper_->cartesianSize(), mpiSize);
+                }
+                else if (partitionMethod == "zlayers")
+                    partitionerParts = zLayerPartition(*grid_, *cartesianIndexMapper_, mpiSize);
+                else
+                    partitionerParts = rcbPartition(*grid_, mpiSize);
+                partitionerFailed = partitionerParts.size() != static_cast<std::size_t>(grid_->size(0));
+            }
+            grid_->comm().broadcast(&partitionerFailed, 1, 0);
+            if (partitionerFailed)
+                OPM_THROW(std::runtime_error, "Partitioning the grid with the method '" << partitionMethod << "' failed");
+        }
+
+        // A partitioning which an earlier run has computed for the same grid,
+        // wells and options replaces the partitioning by Zoltan, which takes a
+        // lot of time for large grids. Any partitioning gives the same results.
+        const auto wells = schedule.getWellsatEnd();
+        std::string partitionCachePath;
+        std::vector<int> globalCell;
+        std::vector<int> cachedParts;
+        int partitionCached = 0;
+        if (!loadBalancerSet && !usePartitioner && !partitionCacheDir.empty()) {
+            if (grid_->comm().rank() == 0) {
+                globalCell = grid_->globalCell();
+                partitionCachePath = partitionCacheFile(partitionCacheDir, globalCell, wells, mpiSize,
+                                                   edgeWeightsMethod, serialPartitioning,
+                                                   enableDistributedWells, zoltanImbalanceTol);
+                cachedParts = readPartition(partitionCachePath, globalCell.size(), mpiSize);
+                partitionCached = !cachedParts.empty();
+                if (partitionCached)
+                    OpmLog::info("Reading the partitioning of the grid from the cache file '" + partitionCachePath + "'");
+            }
+            grid_->comm().broadcast(&partitionCached, 1, 0);
+        }
+
+        if (!loadBalancerSet && !usePartitioner && !partitionCached){
             faceTrans.resize(numFaces, 0.0);
             ElementMapper elemMapper(gridv, Dune::mcmgElementLayout());
             auto elemIt = gridView.template begin</*codim=*/0>();
@@ -133,8 +408,6 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
 
         //distribute the grid and switch to the distributed view.
         {
-            const auto wells = schedule.getWellsatEnd();
-
             try
             {
                 auto& eclState = dynamic_cast<ParallelEclipseState&>(eclState1);
@@ -154,13 +427,21 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
                     {
                         parts =  (*externalLoadBalancer)(*grid_);
                     }
-                    parallelWells = std::get<1>(grid_->loadBalance(handle, parts, &wells, ownersFirst, false, 1));
+                    parallelWells = std::get<1>(grid_->loadBalance(handle, parts, &wells, ownersFirst, false, overlapLayers));
+                }
+                else if (usePartitioner)
+                {
+                    parallelWells = std::get<1>(grid_->loadBalance(handle, partitionerParts, &wells, ownersFirst, false, overlapLayers));
+                }
+                else if (partitionCached)
+                {
+                    parallelWells = std::get<1>(grid_->loadBalance(handle, cachedParts, &wells, ownersFirst, false, overlapLayers));
                 }
                 else
                 {
                     parallelWells =
                         std::get<1>(grid_->loadBalance(handle, edgeWeightsMethod, &wells, serialPartitioning,
-                                                       faceTrans.data(), ownersFirst, false, 1, true, zoltanImbalanceTol,
+                                                       faceTrans.data(), ownersFirst, false, overlapLayers, true, zoltanImbalanceTol,
                                                        enableDistributedWells));
                 }
             }
@@ -175,6 +456,9 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
         }
         grid_->switchToDistributedView();
 
+        if (!loadBalancerSet && !usePartitioner && !partitionCached && !partitionCacheDir.empty())
+            storePartition_(partitionCachePath, globalCell);
+
         cartesianIndexMapper_.reset();
 
         // Calling Schedule::filterConnections would remove any perforated
@@ -184,6 +468,46 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
     }
 }
 
+template<class ElementMapper, class GridView, class Scalar>
+void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::storePartition_(const std::string& partitionCachePath,
+                                                                              const std::vector<int>& globalCell)
+{
+    // gather the global cells of the interior cells of all processes
+    const auto& comm = grid_->comm();
+    std::vector<int> interiorCells;
+    const auto& gridView = grid_->leafGridView();
+    const auto& indexSet = gridView.indexSet();
+    const auto& distributedGlobalCell = grid_->globalCell();
+    auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+    const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+    for (; elemIt != elemEndIt; ++elemIt)
+        interiorCells.push_back(distributedGlobalCell[indexSet.index(*elemIt)]);
+
+    int numInterior = interiorCells.size();
+    std::vector<int> sizes(comm.size());
+    comm.gather(&numInterior, sizes.data(), 1, 0);
+    std::vector<int> displacements(comm.size() + 1, 0);
+    std::partial_sum(sizes.begin(), sizes.end(), displacements.begin() + 1);
+    std::vector<int> allInteriorCells(displacements.back());
+    comm.gatherv(interiorCells.data(), numInterior, allInteriorCells.data(),
+                 sizes.data(), displacements.data(), 0);
+
+    if (comm.rank() != 0)
+        return;
+
+    std::unordered_map<int, int> cellIndex;
+    for (std::size_t cellIdx = 0; cellIdx < globalCell.size(); ++cellIdx)
+        cellIndex[globalCell[cellIdx]] = cellIdx;
+
+    std::vector<int> parts(globalCell.size(), -1);
+    for (int rank = 0; rank < comm.size(); ++rank)
+        for (int i = displacements[rank]; i < displacements[rank + 1]; ++i)
+            parts[cellIndex.at(allInteriorCells[i])] = rank;
+
+    if (std::find(parts.begin(), parts.end(), -1) == parts.end())
+        writePartition(partitionCachePath, parts);
+}
+
 template<class ElementMapper, class GridView, class Scalar>
 void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::distributeFieldProps_(EclipseState& eclState1)
 {
@@ -31,6 +31,8 @@
 #include <opm/grid/CpGrid.hpp>
 
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace Opm {
 
@@ -111,10 +113,19 @@ protected:
     void doLoadBalance_(Dune::EdgeWeightMethod edgeWeightsMethod,
                         bool ownersFirst, bool serialPartitioning,
                         bool enableDistributedWells, double zoltanImbalanceTol,
+                        const std::string& partitionMethod,
+                        const std::string& partitionFile,
+                        int overlapLayers,
                         const GridView& gridv, const Schedule& schedule,
                         std::vector<double>& centroids,
                         EclipseState& eclState,
-                        EclGenericVanguard::ParallelWellStruct& parallelWells);
+                        EclGenericVanguard::ParallelWellStruct& parallelWells,
+                        const std::string& partitionCacheDir);
+
+    // Store the partitioning of the distributed grid in a cache file, globalCell
+    // are the global cells of the undistributed grid on the root process.
+    void storePartition_(const std::string& partitionCachePath,
+                         const std::vector<int>& globalCell);
 
     void distributeFieldProps_(EclipseState& eclState);
 #endif
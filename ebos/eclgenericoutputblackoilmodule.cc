@@ -37,10 +37,12 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/SummaryState.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 namespace {
 
@@ -526,18 +528,25 @@ addRftDataToWells(data::Wells& wellDatas, size_t reportStepNum)
                 connectionData.index = index;
                 count++;
             }
-            wellDatas.emplace(std::make_pair(well.name(), wellData));
+            wellDatas.emplace(well.name(), std::move(wellData));
         }
 
+        // One lookup per map and connection, RFT reports of models with
+        // many wells otherwise spend most of their time here.
+        auto assignIfPresent = [](const std::map<size_t, Scalar>& values,
+                                  const size_t index, double& target)
+        {
+            const auto it = values.find(index);
+            if (it != values.end())
+                target = it->second;
+        };
+
         data::Well& wellData = wellDatas.at(well.name());
         for (auto& connectionData: wellData.connections) {
             const auto index = connectionData.index;
-            if (oilConnectionPressures_.count(index) > 0)
-                connectionData.cell_pressure = oilConnectionPressures_.at(index);
-            if (waterConnectionSaturations_.count(index) > 0)
-                connectionData.cell_saturation_water = waterConnectionSaturations_.at(index);
-            if (gasConnectionSaturations_.count(index) > 0)
-                connectionData.cell_saturation_gas = gasConnectionSaturations_.at(index);
+            assignIfPresent(oilConnectionPressures_, index, connectionData.cell_pressure);
+            assignIfPresent(waterConnectionSaturations_, index, connectionData.cell_saturation_water);
+            assignIfPresent(gasConnectionSaturations_, index, connectionData.cell_saturation_gas);
         }
     }
     oilConnectionPressures_.clear();
@@ -766,36 +775,6 @@ setRestart(const data::Solution& sol,
         ppcw_[elemIdx] = sol.data("PPCW")[globalDofIndex];
 }
 
-template<class FluidSystem,class Scalar>
-typename EclGenericOutputBlackoilModule<FluidSystem,Scalar>::ScalarBuffer
-EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-regionSum(const ScalarBuffer& property,
-          const std::vector<int>& regionId,
-          size_t maxNumberOfRegions,
-          const Comm& comm)
-{
-        ScalarBuffer totals(maxNumberOfRegions, 0.0);
-
-        if (property.empty())
-            return totals;
-
-        assert(regionId.size() == property.size());
-        for (size_t j = 0; j < regionId.size(); ++j) {
-            const int regionIdx = regionId[j] - 1;
-            // the cell is not attributed to any region. ignore it!
-            if (regionIdx < 0)
-                continue;
-
-            assert(regionIdx < static_cast<int>(maxNumberOfRegions));
-            totals[regionIdx] += property[j];
-        }
-
-        for (size_t i = 0; i < maxNumberOfRegions; ++i)
-            totals[i] = comm.sum(totals[i]);
-
-        return totals;
-    }
-
 template<class FluidSystem, class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 doAllocBuffers(unsigned bufferSize,
@@ -803,6 +782,7 @@ doAllocBuffers(unsigned bufferSize,
                const bool substep,
                const bool log,
                const bool isRestart,
+               const bool summaryOnly,
                const bool vapparsActive,
                const bool enableHysteresis,
                unsigned numTracers)
@@ -882,7 +862,9 @@ doAllocBuffers(unsigned bufferSize,
     // 1) when we want to restart
     // 2) when it is ask for by the user via restartConfig
     // 3) when it is not a substep
-    if (!isRestart && (!schedule_.write_rst_file(reportStepNum, log) || substep))
+    // and not for the evaluation of the summary, the restart fields are
+    // filled again right before they are written
+    if (!isRestart && (summaryOnly || !schedule_.write_rst_file(reportStepNum, log) || substep))
         return;
 
     // always output saturation of active phases
@@ -1444,15 +1426,6 @@ outputFipLogImpl(const Inplace& inplace) const
     }
 }
 
-template<class FluidSystem,class Scalar>
-int EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-regionMax(const std::vector<int>& region,
-          const Comm& comm)
-{
-    const auto max_value = region.empty() ? 0 : *std::max_element(region.begin(), region.end());
-    return comm.max(max_value);
-}
-
 template<class FluidSystem,class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 update(Inplace& inplace,
@@ -1469,32 +1442,78 @@ update(Inplace& inplace,
     inplace.add( phase, sum );
 }
 
-template<class FluidSystem,class Scalar>
-void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-makeRegionSum(Inplace& inplace,
-              const std::string& region_name,
-              const Comm& comm)
-{
-    const auto& region = this->regions_.at(region_name);
-    std::size_t ntFip = this->regionMax(region, comm);
-
-    update(inplace, region_name, Inplace::Phase::PressurePV, ntFip, this->regionSum(this->pressureTimesPoreVolume_, region, ntFip, comm));
-    update(inplace, region_name, Inplace::Phase::HydroCarbonPV, ntFip, this->regionSum(this->hydrocarbonPoreVolume_, region, ntFip, comm));
-    update(inplace, region_name, Inplace::Phase::PressureHydroCarbonPV, ntFip, this->regionSum(this->pressureTimesHydrocarbonVolume_, region, ntFip, comm));
-
-    for (const auto& phase : Inplace::phases())
-        update(inplace, region_name, phase, ntFip, this->regionSum(this->fip_[phase], region, ntFip, comm));
-}
-
 template<class FluidSystem,class Scalar>
 Inplace EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 accumulateRegionSums(const Comm& comm)
 {
     Inplace inplace;
 
-    for (const auto& [region_name, _] : this->regions_) {
-        (void)_;
-        makeRegionSum(inplace, region_name, comm);
+    // The quantities which are summed per region, in the order in which
+    // they are added to the Inplace object.
+    std::vector<Inplace::Phase> phases {
+        Inplace::Phase::PressurePV,
+        Inplace::Phase::HydroCarbonPV,
+        Inplace::Phase::PressureHydroCarbonPV
+    };
+    std::vector<const ScalarBuffer*> properties {
+        &this->pressureTimesPoreVolume_,
+        &this->hydrocarbonPoreVolume_,
+        &this->pressureTimesHydrocarbonVolume_
+    };
+    for (const auto& phase : Inplace::phases()) {
+        phases.push_back(phase);
+        properties.push_back(&this->fip_[phase]);
+    }
+
+    // The number of regions of all the region sets, with one collective.
+    std::vector<int> ntFip;
+    for (const auto& [region_name, region] : this->regions_) {
+        (void)region_name;
+        ntFip.push_back(region.empty() ? 0 : *std::max_element(region.begin(), region.end()));
+    }
+    comm.max(ntFip.data(), ntFip.size());
+
+    // The sums of all the quantities over all the region sets, with one
+    // collective. Empty quantities contribute zeros, the buffer has the
+    // same layout on all processes.
+    std::vector<std::size_t> offset(ntFip.size() + 1, 0);
+    for (std::size_t setIdx = 0; setIdx < ntFip.size(); ++setIdx)
+        offset[setIdx + 1] = offset[setIdx] + properties.size() * ntFip[setIdx];
+
+    ScalarBuffer totals(offset.back(), 0.0);
+    std::size_t setIdx = 0;
+    for (const auto& [region_name, region] : this->regions_) {
+        (void)region_name;
+        for (std::size_t propIdx = 0; propIdx < properties.size(); ++propIdx) {
+            const auto& property = *properties[propIdx];
+            if (property.empty())
+                continue;
+
+            assert(region.size() == property.size());
+            Scalar* propertyTotals = totals.data() + offset[setIdx] + propIdx * ntFip[setIdx];
+            for (std::size_t j = 0; j < region.size(); ++j) {
+                const int regionIdx = region[j] - 1;
+                // the cell is not attributed to any region. ignore it!
+                if (regionIdx < 0)
+                    continue;
+
+                assert(regionIdx < ntFip[setIdx]);
+                propertyTotals[regionIdx] += property[j];
+            }
+        }
+        ++setIdx;
+    }
+    comm.sum(totals.data(), totals.size());
+
+    setIdx = 0;
+    for (const auto& [region_name, region] : this->regions_) {
+        (void)region;
+        for (std::size_t propIdx = 0; propIdx < properties.size(); ++propIdx) {
+            const auto first = totals.begin() + offset[setIdx] + propIdx * ntFip[setIdx];
+            update(inplace, region_name, phases[propIdx], ntFip[setIdx],
+                   std::vector<double>(first, first + ntFip[setIdx]));
+        }
+        ++setIdx;
     }
 
     // The first time the outputFipLog function is run we store the inplace values in
@@ -1519,6 +1538,48 @@ sum(const ScalarBuffer& v)
     return std::accumulate(v.begin(), v.end(), Scalar{0});
 }
 
+template<class FluidSystem,class Scalar>
+std::size_t EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
+bufferBytes() const
+{
+    std::size_t bytes = 0;
+    auto add = [&bytes](const ScalarBuffer& v)
+    {
+        bytes += v.capacity() * sizeof(Scalar);
+    };
+
+    for (const auto& buffer : {&gasFormationVolumeFactor_, &hydrocarbonPoreVolume_,
+                               &pressureTimesPoreVolume_, &pressureTimesHydrocarbonVolume_,
+                               &oilPressure_, &temperature_, &rs_, &rv_, &overburdenPressure_,
+                               &oilSaturationPressure_, &sSol_, &cPolymer_, &cFoam_, &cSalt_,
+                               &extboX_, &extboY_, &extboZ_, &mFracOil_, &mFracGas_, &mFracCo2_,
+                               &soMax_, &pcSwMdcOw_, &krnSwMdcOw_, &pcSwMdcGo_, &krnSwMdcGo_,
+                               &ppcw_, &gasDissolutionFactor_, &oilVaporizationFactor_,
+                               &bubblePointPressure_, &dewPointPressure_, &rockCompPorvMultiplier_,
+                               &swMax_, &minimumOilPressure_, &saturatedOilFormationVolumeFactor_,
+                               &rockCompTransMultiplier_})
+        add(*buffer);
+
+    for (int phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        add(saturation_[phaseIdx]);
+        add(invB_[phaseIdx]);
+        add(density_[phaseIdx]);
+        add(viscosity_[phaseIdx]);
+        add(relativePermeability_[phaseIdx]);
+    }
+
+    for (const auto& buffer : tracerConcentrations_)
+        add(buffer);
+
+    for (const auto& [phase, buffer] : fip_)
+        add(buffer);
+
+    for (const auto& [name, region] : regions_)
+        bytes += region.capacity() * sizeof(int);
+
+    return bytes;
+}
+
 template<class FluidSystem,class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 updateSummaryRegionValues(const Inplace& inplace,
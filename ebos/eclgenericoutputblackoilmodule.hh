@@ -135,6 +135,9 @@ public:
         return this->initialInplace_.value();
     }
 
+    //! \brief Bytes of the per cell output buffers.
+    std::size_t bufferBytes() const;
+
 protected:
     using ScalarBuffer = std::vector<Scalar>;
     using StringBuffer = std::vector<std::string>;
@@ -227,6 +230,7 @@ protected:
                         const bool substep,
                         const bool log,
                         const bool isRestart,
+                        const bool summaryOnly,
                         const bool vapparsActive,
                         const bool enableHysteresis,
                         unsigned numTracers);
@@ -250,10 +254,6 @@ protected:
 
     void outputFipLogImpl(const Inplace& inplace) const;
 
-    void makeRegionSum(Inplace& inplace,
-                       const std::string& region_name,
-                       const Comm& comm);
-
     Inplace accumulateRegionSums(const Comm& comm);
 
     void updateSummaryRegionValues(const Inplace& inplace,
@@ -273,15 +273,6 @@ protected:
                                          const ScalarBuffer& pressurePv,
                                          const ScalarBuffer& pv,
                                          bool hydrocarbon);
-    // Sum Fip values over regions.
-    static ScalarBuffer regionSum(const ScalarBuffer& property,
-                                  const std::vector<int>& regionId,
-                                  size_t maxNumberOfRegions,
-                                  const Comm& comm);
-
-    static int regionMax(const std::vector<int>& region,
-                         const Comm& comm);
-
     static void update(Inplace& inplace,
                        const std::string& region_name,
                        Inplace::Phase phase,
@@ -34,6 +34,8 @@
 #include <opm/parser/eclipse/EclipseState/Tables/OverburdTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/RockwnodTable.hpp>
 
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/polyhedralgrid.hh>
 
@@ -45,6 +47,7 @@
 
 #include <boost/date_time.hpp>
 
+#include <algorithm>
 #include <limits>
 #include <stdexcept>
 #include <iostream>
@@ -616,6 +619,38 @@ maxPolymerAdsorption(unsigned elemIdx) const
     return maxPolymerAdsorption_[elemIdx];
 }
 
+template<class GridView, class FluidSystem, class Scalar>
+void EclGenericProblem<GridView,FluidSystem,Scalar>::
+writeCheckpoint_(std::ostream& os) const
+{
+    BinaryCheckpoint::write(os, maxOilSaturation_);
+    BinaryCheckpoint::write(os, maxPolymerAdsorption_);
+    BinaryCheckpoint::write(os, maxWaterSaturation_);
+    BinaryCheckpoint::write(os, minOilPressure_);
+    BinaryCheckpoint::write(os, lastRv_);
+    BinaryCheckpoint::write(os, maxDRv_);
+    BinaryCheckpoint::write(os, convectiveDrs_);
+    BinaryCheckpoint::write(os, lastRs_);
+    BinaryCheckpoint::write(os, maxDRs_);
+    BinaryCheckpoint::write(os, dRsDtOnlyFreeGas_);
+}
+
+template<class GridView, class FluidSystem, class Scalar>
+void EclGenericProblem<GridView,FluidSystem,Scalar>::
+readCheckpoint_(std::istream& is)
+{
+    BinaryCheckpoint::read(is, maxOilSaturation_);
+    BinaryCheckpoint::read(is, maxPolymerAdsorption_);
+    BinaryCheckpoint::read(is, maxWaterSaturation_);
+    BinaryCheckpoint::read(is, minOilPressure_);
+    BinaryCheckpoint::read(is, lastRv_);
+    BinaryCheckpoint::read(is, maxDRv_);
+    BinaryCheckpoint::read(is, convectiveDrs_);
+    BinaryCheckpoint::read(is, lastRs_);
+    BinaryCheckpoint::read(is, maxDRs_);
+    BinaryCheckpoint::read(is, dRsDtOnlyFreeGas_);
+}
+
 template<class GridView, class FluidSystem, class Scalar>
 void EclGenericProblem<GridView,FluidSystem,Scalar>::
 initDRSDT_(size_t numDof,
@@ -623,21 +658,33 @@ initDRSDT_(size_t numDof,
 {
     // deal with DRSDT
     unsigned ntpvt = eclState_.runspec().tabdims().getNumPVTTables();
-    //TODO We may want to only allocate these properties only if active.
-    //But since they may be activated at later time we need some more
-    //intrastructure to handle it
     if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-        maxDRv_.resize(ntpvt, 1e30);
-        lastRv_.resize(numDof, 0.0);
         maxDRs_.resize(ntpvt, 1e30);
         dRsDtOnlyFreeGas_.resize(ntpvt, false);
-        lastRs_.resize(numDof, 0.0);
         maxDRv_.resize(ntpvt, 1e30);
-        lastRv_.resize(numDof, 0.0);
-        maxOilSaturation_.resize(numDof, 0.0);
-        if (drsdtConvective_(episodeIdx)) {
-            convectiveDrs_.resize(numDof, 1.0);
+
+        // the per cell quantities are only allocated if DRSDT, DRVDT or VAPPARS
+        // are used by any report step of the schedule. they may be activated at a
+        // later time, so all report steps need to be considered.
+        bool useDrsdt = false;
+        bool useDrsdtConvective = false;
+        bool useDrvdt = false;
+        bool useVappars = false;
+        for (int stepIdx = std::max(episodeIdx, 0); stepIdx < static_cast<int>(schedule_.size()); ++stepIdx) {
+            useDrsdt = useDrsdt || drsdtActive_(stepIdx);
+            useDrsdtConvective = useDrsdtConvective || drsdtConvective_(stepIdx);
+            useDrvdt = useDrvdt || drvdtActive_(stepIdx);
+            useVappars = useVappars || vapparsActive(stepIdx);
         }
+
+        if (useDrsdt)
+            lastRs_.resize(numDof, 0.0);
+        if (useDrsdtConvective)
+            convectiveDrs_.resize(numDof, 1.0);
+        if (useDrvdt)
+            lastRv_.resize(numDof, 0.0);
+        if (useVappars)
+            maxOilSaturation_.resize(numDof, 0.0);
     }
 }
 
@@ -32,6 +32,7 @@
 #include <opm/material/common/Tabulated1DFunction.hpp>
 
 #include <array>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -129,6 +130,14 @@ public:
     void setPorosity(Scalar poro, unsigned elementIdx, unsigned timeIdx = 0)
     { referencePorosity_[timeIdx][elementIdx] = poro; }
 
+    /*!
+     * \brief Returns the reference porosities of all elements
+     *
+     * This allows e.g. the Python bindings to access the porosities in place.
+     */
+    std::vector<Scalar>& referencePorosities(unsigned timeIdx = 0)
+    { return referencePorosity_[timeIdx]; }
+
     /*!
      * \brief Returns the initial solvent saturation for a given a cell index
      */
@@ -189,6 +198,12 @@ public:
     bool vapparsActive(int episodeIdx) const;
 
 protected:
+    // Write and read the history dependent per element quantities, i.e. the
+    // extrema tracked for hysteresis and the DRSDT/DRVDT state, in a binary
+    // checkpoint.
+    void writeCheckpoint_(std::ostream& os) const;
+    void readCheckpoint_(std::istream& is);
+
     bool drsdtActive_(int episodeIdx) const;
     bool drvdtActive_(int episodeIdx) const;
     bool drsdtConvective_(int episodeIdx) const;
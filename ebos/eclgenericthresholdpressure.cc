@@ -47,6 +47,7 @@
 #include <algorithm>
 #include <cassert>
 #include <stdexcept>
+#include <utility>
 
 namespace Opm {
 
@@ -63,6 +64,7 @@ EclGenericThresholdPressure(const CartesianIndexMapper& cartMapper,
     , elementMapper_(elementMapper)
     , eclState_(eclState)
     , deck_(deck)
+    , enableThresholdPressure_(false)
     , enableExperiments_(enableExperiments)
 {
 }
@@ -71,9 +73,22 @@ template<class Grid, class GridView, class ElementMapper,class Scalar>
 Scalar EclGenericThresholdPressure<Grid,GridView,ElementMapper,Scalar>::
 thresholdPressure(int elem1Idx, int elem2Idx) const
 {
-    if (!enableThresholdPressure_)
+    if (!enableThresholdPressure_ || faceOffsets_.empty())
         return 0.0;
 
+    for (unsigned faceIdx = faceOffsets_[elem1Idx]; faceIdx < faceOffsets_[elem1Idx + 1]; ++faceIdx) {
+        if (faceNeighbors_[faceIdx] == static_cast<unsigned>(elem2Idx))
+            return faceThpres_[faceIdx];
+    }
+
+    return 0.0;
+}
+
+template<class Grid, class GridView, class ElementMapper,class Scalar>
+Scalar EclGenericThresholdPressure<Grid,GridView,ElementMapper,Scalar>::
+regionThresholdPressure_(int elem1Idx, int elem2Idx) const
+{
+
     if (enableExperiments_) {
         // threshold pressure accross faults
         if (!thpresftValues_.empty()) {
@@ -103,12 +118,56 @@ thresholdPressure(int elem1Idx, int elem2Idx) const
     unsigned short equilRegion1Idx = elemEquilRegion_[elem1Idx];
     unsigned short equilRegion2Idx = elemEquilRegion_[elem2Idx];
 
-    if (equilRegion1Idx == equilRegion2Idx)
+    if (equilRegion1Idx == equilRegion2Idx || thpres_.empty())
         return 0.0;
 
     return thpres_[equilRegion1Idx*numEquilRegions_ + equilRegion2Idx];
 }
 
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclGenericThresholdPressure<Grid,GridView,ElementMapper,Scalar>::
+updateFaceThresholdPressures_()
+{
+    unsigned numElements = gridView_.size(/*codim=*/0);
+
+    // the threshold pressures of the faces of each element, in the order of the
+    // elements of the grid view
+    std::vector<std::vector<std::pair<unsigned, Scalar>>> elemFaces(numElements);
+    auto elemIt = gridView_.template begin</*codim=*/ 0>();
+    const auto& elemEndIt = gridView_.template end</*codim=*/ 0>();
+    for (; elemIt != elemEndIt; ++elemIt) {
+        const auto& elem = *elemIt;
+        unsigned elemIdx = elementMapper_.index(elem);
+        auto isIt = gridView_.ibegin(elem);
+        const auto& isEndIt = gridView_.iend(elem);
+        for (; isIt != isEndIt; ++ isIt) {
+            const auto& intersection = *isIt;
+            if (intersection.boundary() || !intersection.neighbor())
+                continue;
+
+            unsigned neighborIdx = elementMapper_.index(intersection.outside());
+            Scalar pth = regionThresholdPressure_(elemIdx, neighborIdx);
+            if (pth > 0.0)
+                elemFaces[elemIdx].emplace_back(neighborIdx, pth);
+        }
+    }
+
+    faceOffsets_.assign(numElements + 1, 0);
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+        faceOffsets_[elemIdx + 1] = faceOffsets_[elemIdx] + elemFaces[elemIdx].size();
+
+    faceNeighbors_.resize(faceOffsets_.back());
+    faceThpres_.resize(faceOffsets_.back());
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        unsigned faceIdx = faceOffsets_[elemIdx];
+        for (const auto& [neighborIdx, pth] : elemFaces[elemIdx]) {
+            faceNeighbors_[faceIdx] = neighborIdx;
+            faceThpres_[faceIdx] = pth;
+            ++faceIdx;
+        }
+    }
+}
+
 template<class Grid, class GridView, class ElementMapper, class Scalar>
 void EclGenericThresholdPressure<Grid,GridView,ElementMapper,Scalar>::
 finishInit()
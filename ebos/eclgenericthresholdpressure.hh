@@ -57,6 +57,9 @@ public:
      * a hack: First of all threshold pressures in general are unphysical, and second,
      * they should be different for the fluid phase but are not. Anyway, this seems to be
      * E100's way of doing things, so we do it the same way.
+     *
+     * The value is taken from the per face storage which is set up by finishInit(),
+     * i.e., it is zero before that and for the faces which do not exhibit a threshold.
      */
     Scalar thresholdPressure(int elem1Idx, int elem2Idx) const;
 
@@ -74,7 +77,11 @@ public:
      * This is used for the restart capability.
      */
     void setFromRestart(const std::vector<Scalar>& values)
-    { thpres_ = values; }
+    {
+        thpres_ = values;
+        if (!faceOffsets_.empty())
+            updateFaceThresholdPressures_();
+    }
 
 protected:
     /*!
@@ -88,6 +95,14 @@ protected:
 
     void extractThpresft_(const DeckKeyword& thpresftKeyword);
 
+    // store the threshold pressure of every face of the grid which exhibits one. This
+    // must be called whenever the threshold pressures of the regions or faults change.
+    void updateFaceThresholdPressures_();
+
+    // compute the threshold pressure of a face from the EQUIL regions and faults of the
+    // adjacent elements.
+    Scalar regionThresholdPressure_(int elem1Idx, int elem2Idx) const;
+
     const CartesianIndexMapper& cartMapper_;
     const GridView& gridView_;
     const ElementMapper& elementMapper_;
@@ -98,6 +113,13 @@ protected:
     unsigned numEquilRegions_;
     std::vector<unsigned char> elemEquilRegion_;
 
+    // the faces of each element which exhibit a threshold pressure: the faces of
+    // element i are [faceOffsets_[i], faceOffsets_[i + 1]). faces without a threshold
+    // pressure are not stored, so most elements do not have any.
+    std::vector<unsigned> faceOffsets_;
+    std::vector<unsigned> faceNeighbors_;
+    std::vector<Scalar> faceThpres_;
+
     // threshold pressure accross faults. EXPERIMENTAL!
     std::vector<Scalar> thpresftValues_;
     std::vector<int> cartElemFaultIdx_;
@@ -42,9 +42,14 @@
 #include <ebos/femcpgridcompat.hh>
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <set>
 #include <stdexcept>
+#include <utility>
 
 namespace Opm {
 
@@ -169,6 +174,7 @@ doInit(bool enabled, size_t numGridDof,
     using NeighborSet = std::set<unsigned>;
     std::vector<NeighborSet> neighbors(numGridDof);
 
+    numInteriorFaces_.resize(numGridDof);
     Stencil stencil(gridView_, dofMapper_);
     auto elemIt = gridView_.template begin<0>();
     const auto elemEndIt = gridView_.template end<0>();
@@ -178,6 +184,7 @@ doInit(bool enabled, size_t numGridDof,
 
         for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
             unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+            numInteriorFaces_[myIdx] = stencil.numInteriorFaces();
 
             for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
                 unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
@@ -211,13 +218,21 @@ doInit(bool enabled, size_t numGridDof,
 }
 
 template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
-bool EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
-linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
+void EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+prepareLinearSolve_()
 {
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
     Dune::FMatrixPrecision<Scalar>::set_singular_limit(1.e-30);
     Dune::FMatrixPrecision<Scalar>::set_absolute_limit(1.e-30);
 #endif
+    using TracerPreconditioner = Dune::SeqILU< TracerMatrix,TracerVector,TracerVector>;
+    tracerPreconditioner_ = std::make_unique<TracerPreconditioner>(*tracerMatrix_, 0, 1); // results in ILU0
+}
+
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+bool EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+linearSolve_(TracerVector& x, TracerVector& b)
+{
     x = 0.0;
     Scalar tolerance = 1e-2;
     int maxIter = 100;
@@ -226,14 +241,12 @@ linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
     using TracerSolver = Dune::BiCGSTABSolver<TracerVector>;
     using TracerOperator = Dune::MatrixAdapter<TracerMatrix,TracerVector,TracerVector>;
     using TracerScalarProduct = Dune::SeqScalarProduct<TracerVector>;
-    using TracerPreconditioner = Dune::SeqILU< TracerMatrix,TracerVector,TracerVector>;
 
-    TracerOperator tracerOperator(M);
+    TracerOperator tracerOperator(*tracerMatrix_);
     TracerScalarProduct tracerScalarProduct;
-    TracerPreconditioner tracerPreconditioner(M, 0, 1); // results in ILU0
 
     TracerSolver solver (tracerOperator, tracerScalarProduct,
-                         tracerPreconditioner, tolerance, maxIter,
+                         *tracerPreconditioner_, tolerance, maxIter,
                          verbosity);
 
     Dune::InverseOperatorResult result;
@@ -243,6 +256,177 @@ linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
     return result.converged;
 }
 
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+void EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+prepareReorderedSolve_()
+{
+    const std::size_t numCells = phaseVolume0_.size();
+
+    // the outflow of a cell depends on its own concentration and the inflow
+    // on the concentration of the upstream neighbour
+    diagonal_.resize(numCells);
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        diagonal_[cellIdx] = phaseVolume0_[cellIdx] * volumeOverDt_[cellIdx];
+    upstreamOffsets_.assign(numCells + 1, 0);
+    for (const auto& face : faces_) {
+        if (face.upstream == face.cell)
+            diagonal_[face.cell] += face.flux;
+        else if (face.flux != 0.0)
+            ++upstreamOffsets_[face.cell + 1];
+    }
+    std::partial_sum(upstreamOffsets_.begin(), upstreamOffsets_.end(), upstreamOffsets_.begin());
+    upstreamCells_.resize(upstreamOffsets_.back());
+    upstreamCoefficients_.resize(upstreamOffsets_.back());
+    std::vector<unsigned> position(upstreamOffsets_.begin(), upstreamOffsets_.end() - 1);
+    for (const auto& face : faces_) {
+        if (face.upstream == face.cell || face.flux == 0.0)
+            continue;
+        const unsigned k = position[face.cell]++;
+        upstreamCells_[k] = face.upstream;
+        upstreamCoefficients_[k] = face.flux;
+    }
+
+    // Tarjan's algorithm, which finds a component after all components
+    // upstream of it, i.e. in an order in which they can be solved
+    constexpr unsigned unvisited = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> index(numCells, unvisited);
+    std::vector<unsigned> lowLink(numCells);
+    std::vector<char> onStack(numCells, false);
+    std::vector<unsigned> stack;
+    // the cells being visited and the next of their upstream couplings
+    std::vector<std::pair<unsigned, unsigned>> visiting;
+    unsigned nextIndex = 0;
+
+    componentCells_.clear();
+    componentOffsets_.assign(1, 0);
+    for (unsigned root = 0; root < numCells; ++root) {
+        if (index[root] != unvisited)
+            continue;
+
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        onStack[root] = true;
+        visiting.emplace_back(root, upstreamOffsets_[root]);
+        while (!visiting.empty()) {
+            const unsigned cellIdx = visiting.back().first;
+            unsigned& k = visiting.back().second;
+            if (k < upstreamOffsets_[cellIdx + 1]) {
+                const unsigned upIdx = upstreamCells_[k++];
+                if (index[upIdx] == unvisited) {
+                    index[upIdx] = lowLink[upIdx] = nextIndex++;
+                    stack.push_back(upIdx);
+                    onStack[upIdx] = true;
+                    visiting.emplace_back(upIdx, upstreamOffsets_[upIdx]);
+                }
+                else if (onStack[upIdx])
+                    lowLink[cellIdx] = std::min(lowLink[cellIdx], index[upIdx]);
+                continue;
+            }
+
+            visiting.pop_back();
+            if (!visiting.empty()) {
+                const unsigned parentIdx = visiting.back().first;
+                lowLink[parentIdx] = std::min(lowLink[parentIdx], lowLink[cellIdx]);
+            }
+            if (lowLink[cellIdx] == index[cellIdx]) {
+                unsigned memberIdx;
+                do {
+                    memberIdx = stack.back();
+                    stack.pop_back();
+                    onStack[memberIdx] = false;
+                    componentCells_.push_back(memberIdx);
+                } while (memberIdx != cellIdx);
+                componentOffsets_.push_back(componentCells_.size());
+            }
+        }
+    }
+
+    // the level of a component is one more than the highest level of the
+    // components upstream of it
+    const std::size_t numComponents = componentOffsets_.size() - 1;
+    std::vector<unsigned> componentOfCell(numCells);
+    for (unsigned componentIdx = 0; componentIdx < numComponents; ++componentIdx)
+        for (unsigned k = componentOffsets_[componentIdx]; k < componentOffsets_[componentIdx + 1]; ++k)
+            componentOfCell[componentCells_[k]] = componentIdx;
+
+    std::vector<unsigned> level(numComponents, 0);
+    unsigned numLevels = 0;
+    for (unsigned componentIdx = 0; componentIdx < numComponents; ++componentIdx) {
+        for (unsigned k = componentOffsets_[componentIdx]; k < componentOffsets_[componentIdx + 1]; ++k) {
+            const unsigned cellIdx = componentCells_[k];
+            for (unsigned l = upstreamOffsets_[cellIdx]; l < upstreamOffsets_[cellIdx + 1]; ++l) {
+                const unsigned upComponentIdx = componentOfCell[upstreamCells_[l]];
+                if (upComponentIdx != componentIdx)
+                    level[componentIdx] = std::max(level[componentIdx], level[upComponentIdx] + 1);
+            }
+        }
+        numLevels = std::max(numLevels, level[componentIdx] + 1);
+    }
+
+    levelOffsets_.assign(numLevels + 1, 0);
+    for (unsigned componentIdx = 0; componentIdx < numComponents; ++componentIdx)
+        ++levelOffsets_[level[componentIdx] + 1];
+    std::partial_sum(levelOffsets_.begin(), levelOffsets_.end(), levelOffsets_.begin());
+    levelComponents_.resize(numComponents);
+    position.assign(levelOffsets_.begin(), levelOffsets_.end() - 1);
+    for (unsigned componentIdx = 0; componentIdx < numComponents; ++componentIdx)
+        levelComponents_[position[level[componentIdx]]++] = componentIdx;
+}
+
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+void EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+reorderedSolve_(TracerVector& x, const TracerVector& b) const
+{
+    x = 0.0;
+    for (std::size_t levelIdx = 0; levelIdx + 1 < levelOffsets_.size(); ++levelIdx) {
+        const auto levelBegin = static_cast<std::ptrdiff_t>(levelOffsets_[levelIdx]);
+        const auto levelEnd = static_cast<std::ptrdiff_t>(levelOffsets_[levelIdx + 1]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+        for (std::ptrdiff_t k = levelBegin; k < levelEnd; ++k)
+            solveComponent_(levelComponents_[k], x, b);
+    }
+}
+
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+void EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+solveComponent_(unsigned componentIdx, TracerVector& x, const TracerVector& b) const
+{
+    const auto solveCell = [this, &x, &b](unsigned cellIdx)
+    {
+        Scalar rhs = b[cellIdx][0];
+        for (unsigned k = upstreamOffsets_[cellIdx]; k < upstreamOffsets_[cellIdx + 1]; ++k)
+            rhs -= upstreamCoefficients_[k] * x[upstreamCells_[k]][0];
+        return rhs / diagonal_[cellIdx];
+    };
+
+    const unsigned begin = componentOffsets_[componentIdx];
+    const unsigned end = componentOffsets_[componentIdx + 1];
+    if (end - begin == 1) {
+        x[componentCells_[begin]][0] = solveCell(componentCells_[begin]);
+        return;
+    }
+
+    // the cells of a circulating flow path are solved by Gauss-Seidel
+    // iterations, which converge since the Jacobian is diagonally dominant
+    const Scalar tolerance = 1e-10;
+    const int maxIter = 100;
+    for (int iter = 0; iter < maxIter; ++iter) {
+        Scalar maxChange = 0.0;
+        Scalar maxValue = 0.0;
+        for (unsigned k = begin; k < end; ++k) {
+            const unsigned cellIdx = componentCells_[k];
+            const Scalar value = solveCell(cellIdx);
+            maxChange = std::max(maxChange, std::abs(value - x[cellIdx][0]));
+            maxValue = std::max(maxValue, std::abs(value));
+            x[cellIdx][0] = value;
+        }
+        if (maxChange <= tolerance * maxValue)
+            break;
+    }
+}
+
 #if HAVE_DUNE_FEM
 template class EclGenericTracerModel<Dune::CpGrid,
                                      Dune::GridView<Dune::Fem::GridPart2GridViewTraits<Dune::Fem::AdaptiveLeafGridPart<Dune::CpGrid, Dune::PartitionIteratorType(4), false>>>,
@@ -34,9 +34,11 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 
 #include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/preconditioner.hh>
 
 #include <dune/common/version.hh>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -83,7 +85,44 @@ protected:
                 size_t oilPhaseIdx,
                 size_t waterPhaseIdx);
 
-    bool linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b);
+    /*!
+     * \brief Factorize the tracer matrix for the following linear solves.
+     */
+    void prepareLinearSolve_();
+
+    /*!
+     * \brief Solve with the tracer matrix factorized by the last prepareLinearSolve_().
+     */
+    bool linearSolve_(TracerVector& x, TracerVector& b);
+
+    /*!
+     * \brief Order the cells upwind for reorderedSolve_() from the coefficients
+     *        of the last linearization.
+     *
+     * The transport of a tracer couples a cell to its upstream neighbours
+     * only, hence its Jacobian is triangular if the cells are sorted along
+     * the flow. Cells on circulating flow paths form strongly connected
+     * components which are solved together.
+     */
+    void prepareReorderedSolve_();
+
+    /*!
+     * \brief Solve the transport Jacobian by substitution, component by
+     *        component in upwind order.
+     *
+     * Components which do not depend on each other are solved concurrently.
+     */
+    void reorderedSolve_(TracerVector& x, const TracerVector& b) const;
+
+    // The contribution of one interior face of a cell to the flux out of
+    // the cell is flux times the concentration of the upstream cell.
+    struct TracerFace
+    {
+        unsigned cell;
+        unsigned exterior;
+        unsigned upstream;
+        Scalar flux;
+    };
 
     const GridView& gridView_;
     const EclipseState& eclState_;
@@ -97,7 +136,35 @@ protected:
     TracerMatrix *tracerMatrix_;
     TracerVector tracerResidual_;
     std::vector<int> cartToGlobal_;
+    std::vector<unsigned> numInteriorFaces_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> storageOfTimeIndex1_;
+
+    // The coefficients of the tracer equations of the phase of the last
+    // linearization, which are the same for all tracers of the phase.
+    // phaseVolume1_ is empty if the storage cache is enabled.
+    std::vector<Scalar> phaseVolume0_;
+    std::vector<Scalar> phaseVolume1_;
+    std::vector<Scalar> volumeOverDt_;
+    std::vector<TracerFace> faces_;
+    std::unique_ptr<Dune::Preconditioner<TracerVector, TracerVector>> tracerPreconditioner_;
+
+    // The transport Jacobian of the reordered solver, i.e. the diagonal and
+    // the coupling of every cell to its upstream neighbours, by cell.
+    std::vector<Scalar> diagonal_;
+    std::vector<unsigned> upstreamOffsets_;
+    std::vector<unsigned> upstreamCells_;
+    std::vector<Scalar> upstreamCoefficients_;
+
+    // The cells of the strongly connected components of the upwind graph,
+    // component by component, and the components sorted by level. The
+    // components of a level only depend on those of the previous levels.
+    std::vector<unsigned> componentOffsets_;
+    std::vector<unsigned> componentCells_;
+    std::vector<unsigned> levelOffsets_;
+    std::vector<unsigned> levelComponents_;
+
+private:
+    void solveComponent_(unsigned componentIdx, TracerVector& x, const TracerVector& b) const;
 };
 
 } // namespace Opm
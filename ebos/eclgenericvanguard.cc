@@ -262,7 +262,8 @@ void EclGenericVanguard::init()
     readDeck(myRank, fileName_, deck_, eclState_, eclSchedule_,
              eclSummaryConfig_, std::move(errorGuard), python,
              std::move(parseContext_), /* initFromRestart = */ false,
-             /* checkDeck = */ enableExperiments_, outputInterval_);
+             /* checkDeck = */ enableExperiments_, outputInterval_,
+             parseDeckOnAllRanks_, deckCacheDir_);
 
     this->summaryState_ = std::make_unique<SummaryState>( TimeService::from_time_t(this->eclSchedule_->getStartTime() ));
     this->udqState_ = std::make_unique<UDQState>( this->eclSchedule_->getUDQConfig(0).params().undefinedValue() );
@@ -244,6 +244,33 @@ public:
     double zoltanImbalanceTol() const
     { return zoltanImbalanceTol_; }
 
+    /*!
+     * \brief Parameter that selects the method for partitioning the grid.
+     */
+    const std::string& partitionMethod() const
+    { return partitionMethod_; }
+
+    /*!
+     * \brief Parameter that sets the file to read the partitioning of the grid
+     *        from if the partition method is "file".
+     */
+    const std::string& partitionFile() const
+    { return partitionFile_; }
+
+    /*!
+     * \brief Parameter that sets the number of layers of overlap cells of
+     *        every process.
+     */
+    int overlapLayers() const
+    { return overlapLayers_; }
+
+    /*!
+     * \brief Parameter that sets the directory for caching the parsed deck and
+     *        the partitioning of the grid, if not empty.
+     */
+    const std::string& deckCacheDir() const
+    { return deckCacheDir_; }
+
     /*!
      * \brief Whether perforations of a well might be distributed.
      */
@@ -284,9 +311,14 @@ protected:
     bool ownersFirst_;
     bool serialPartitioning_;
     double zoltanImbalanceTol_;
+    std::string partitionMethod_;
+    std::string partitionFile_;
+    int overlapLayers_;
     bool enableDistributedWells_;
     std::string ignoredKeywords_;
     bool eclStrictParsing_;
+    bool parseDeckOnAllRanks_;
+    std::string deckCacheDir_;
     std::optional<int> outputInterval_;
     bool useMultisegmentWell_;
     bool enableExperiments_;
@@ -52,6 +52,11 @@
 #include <mpi.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
 namespace {
 
 /*!
@@ -114,6 +119,7 @@ struct EclWriteTasklet : public Opm::TaskletInterface
     double secondsElapsed_;
     Opm::RestartValue restartValue_;
     bool writeDoublePrecision_;
+    std::shared_ptr<std::atomic<int>> numPendingWrites_;
 
     explicit EclWriteTasklet(const Opm::Action::State& actionState,
                              const Opm::SummaryState& summaryState,
@@ -123,7 +129,8 @@ struct EclWriteTasklet : public Opm::TaskletInterface
                              bool isSubStep,
                              double secondsElapsed,
                              Opm::RestartValue restartValue,
-                             bool writeDoublePrecision)
+                             bool writeDoublePrecision,
+                             std::shared_ptr<std::atomic<int>> numPendingWrites)
         : actionState_(actionState)
         , summaryState_(summaryState)
         , udqState_(udqState)
@@ -131,9 +138,18 @@ struct EclWriteTasklet : public Opm::TaskletInterface
         , reportStepNum_(reportStepNum)
         , isSubStep_(isSubStep)
         , secondsElapsed_(secondsElapsed)
-        , restartValue_(restartValue)
+        , restartValue_(std::move(restartValue))
         , writeDoublePrecision_(writeDoublePrecision)
-    { }
+        , numPendingWrites_(std::move(numPendingWrites))
+    {
+        ++(*numPendingWrites_);
+    }
+
+    // the tasklet is released by the runner once it has been run
+    ~EclWriteTasklet()
+    {
+        --(*numPendingWrites_);
+    }
 
     // callback to eclIO serial writeTimeStep method
     void run()
@@ -149,6 +165,51 @@ struct EclWriteTasklet : public Opm::TaskletInterface
     }
 };
 
+// writes the INIT and EGRID files
+struct EclWriteInitTasklet : public Opm::TaskletInterface
+{
+    Opm::EclipseIO& eclIO_;
+    Opm::data::Solution trans_;
+    std::map<std::string, std::vector<int>> integerVectors_;
+    std::vector<Opm::NNCdata> nnc_;
+
+    explicit EclWriteInitTasklet(Opm::EclipseIO& eclIO,
+                                 Opm::data::Solution trans,
+                                 std::map<std::string, std::vector<int>> integerVectors,
+                                 std::vector<Opm::NNCdata> nnc)
+        : eclIO_(eclIO)
+        , trans_(std::move(trans))
+        , integerVectors_(std::move(integerVectors))
+        , nnc_(std::move(nnc))
+    {
+    }
+
+    void run()
+    {
+        eclIO_.writeInitial(std::move(trans_), std::move(integerVectors_), nnc_);
+    }
+};
+
+// writes the summary ministeps which were queued during a report step, in
+// the order in which they were queued
+struct EclWriteBatchTasklet : public Opm::TaskletInterface
+{
+    std::vector<std::shared_ptr<Opm::TaskletInterface>> tasklets_;
+
+    explicit EclWriteBatchTasklet(std::vector<std::shared_ptr<Opm::TaskletInterface>> tasklets)
+        : tasklets_(std::move(tasklets))
+    {
+    }
+
+    void run()
+    {
+        for (auto& tasklet : tasklets_) {
+            tasklet->run();
+            tasklet.reset();
+        }
+    }
+};
+
 }
 
 namespace Opm {
@@ -164,7 +225,9 @@ EclGenericWriter(const Schedule& schedule,
                  const Dune::CartesianIndexMapper<Grid>& cartMapper,
                  const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
                  const TransmissibilityType& globalTrans,
-                 bool enableAsyncOutput)
+                 bool enableAsyncOutput,
+                 int maxPendingWrites,
+                 int summaryBatchSize)
     : collectToIORank_(grid,
                        equilGrid,
                        gridView,
@@ -179,6 +242,9 @@ EclGenericWriter(const Schedule& schedule,
     , cartMapper_(cartMapper)
     , equilCartMapper_(equilCartMapper)
     , equilGrid_(equilGrid)
+    , numPendingWrites_(std::make_shared<std::atomic<int>>(0))
+    , maxPendingWrites_(std::max(maxPendingWrites, 1))
+    , summaryBatchSize_(std::max(summaryBatchSize, 1))
 {
     if (collectToIORank_.isIORank()) {
         eclIO_.reset(new EclipseIO(eclState_,
@@ -205,6 +271,15 @@ EclGenericWriter(const Schedule& schedule,
     taskletRunner_.reset(new TaskletRunner(numWorkerThreads));
 }
 
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+~EclGenericWriter()
+{
+    // the queued summary ministeps must reach the disk before the output
+    // thread is stopped
+    flushSummaryBatch_();
+}
+
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
 const EclipseIO& EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
 eclIO() const
@@ -223,7 +298,19 @@ writeInit()
             integerVectors.emplace("MPI_RANK", collectToIORank_.globalRanks());
         auto cartMap = cartesianToCompressed(equilGrid_->size(0),
                                              UgGridHelpers::globalCell(*equilGrid_));
-        eclIO_->writeInitial(computeTrans_(cartMap), integerVectors, exportNncStructure_(cartMap));
+        auto initTasklet = std::make_shared<EclWriteInitTasklet>(*eclIO_,
+                                                                 computeTrans_(cartMap),
+                                                                 std::move(integerVectors),
+                                                                 exportNncStructure_(cartMap));
+
+        // in a parallel run, the simulator thread of the I/O rank works on the
+        // distributed properties, so the files can be written by the output
+        // thread while the first time step is computed. the transmissibilities
+        // are computed beforehand, the global ones are released after this.
+        if (collectToIORank_.isParallel())
+            taskletRunner_->dispatch(std::move(initTasklet));
+        else
+            initTasklet->run();
     }
 }
 
@@ -427,19 +514,54 @@ doWriteOutput(const int                     reportStepNum,
         restartValue.addExtra("OPMEXTRA", std::vector<double>(1, nextStepSize));
     }
 
-    // first, create a tasklet to write the data for the current time
-    // step to disk
+    // create a tasklet to write the data for the current time step to disk
     auto eclWriteTasklet = std::make_shared<EclWriteTasklet>(
         actionState, summaryState, udqState, *this->eclIO_,
-        reportStepNum, isSubStep, curTime, std::move(restartValue), doublePrecision);
+        reportStepNum, isSubStep, curTime, std::move(restartValue), doublePrecision,
+        this->numPendingWrites_);
+
+    // the ministeps only write a summary record each. these are queued and
+    // written in one go at the end of the report step, or once the queue is
+    // full, instead of issuing a few small writes for every ministep.
+    if (isSubStep && this->summaryBatchSize_ > 1) {
+        this->summaryBatch_.push_back(std::move(eclWriteTasklet));
+        if (static_cast<int>(this->summaryBatch_.size()) >= this->summaryBatchSize_)
+            this->flushSummaryBatch_();
+        return;
+    }
+
+    this->flushSummaryBatch_();
+    this->dispatchWrite_(std::move(eclWriteTasklet), 1);
+}
 
-    // then, make sure that the previous I/O request has been completed
-    // and the number of incomplete tasklets does not increase between
-    // time steps
-    this->taskletRunner_->barrier();
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+flushSummaryBatch_()
+{
+    if (this->summaryBatch_.empty())
+        return;
 
-    // finally, start a new output writing job
-    this->taskletRunner_->dispatch(std::move(eclWriteTasklet));
+    const int numWrites = this->summaryBatch_.size();
+    auto batchTasklet = std::make_shared<EclWriteBatchTasklet>(std::move(this->summaryBatch_));
+    this->summaryBatch_.clear();
+    this->dispatchWrite_(std::move(batchTasklet), numWrites);
+}
+
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+dispatchWrite_(std::shared_ptr<TaskletInterface> tasklet, int numWrites)
+{
+    // first, make sure that the number of incomplete I/O requests does not
+    // exceed the limit, the queued requests hold a copy of the global data.
+    // the writes of the tasklet itself and the summary ministeps which are
+    // still queued are pending, but not dispatched yet.
+    const int numDispatched = *this->numPendingWrites_ - numWrites
+        - static_cast<int>(this->summaryBatch_.size());
+    if (numDispatched >= this->maxPendingWrites_)
+        this->taskletRunner_->barrier();
+
+    // then, start a new output writing job
+    this->taskletRunner_->dispatch(std::move(tasklet));
 }
 
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
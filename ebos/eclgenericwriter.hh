@@ -33,8 +33,10 @@
 
 #include <opm/models/parallel/tasklets.hh>
 
+#include <atomic>
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -70,12 +72,21 @@ public:
                      const Dune::CartesianIndexMapper<Grid>& cartMapper,
                      const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
                      const TransmissibilityType& globalTrans,
-                     bool enableAsyncOutput);
+                     bool enableAsyncOutput,
+                     int maxPendingWrites,
+                     int summaryBatchSize);
+
+    ~EclGenericWriter();
 
     const EclipseIO& eclIO() const;
 
     void writeInit();
 
+    //! \brief Number of output writes which have not completed, including
+    //!        the summary ministeps which are queued for a batched write.
+    int numPendingWrites() const
+    { return *numPendingWrites_; }
+
 protected:
     void doWriteOutput(const int                     reportStepNum,
                        const bool                    isSubStep,
@@ -119,8 +130,17 @@ protected:
     const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper_;
     const EquilGrid* equilGrid_;
     std::vector<std::size_t> wbp_index_list_;
+    // number of write tasklets which have not been completed
+    std::shared_ptr<std::atomic<int>> numPendingWrites_;
+    int maxPendingWrites_;
+    // summary ministeps are queued and written together, at most this many
+    int summaryBatchSize_;
+    std::vector<std::shared_ptr<TaskletInterface>> summaryBatch_;
 
 private:
+    void flushSummaryBatch_();
+    void dispatchWrite_(std::shared_ptr<TaskletInterface> tasklet, int numWrites);
+
     data::Solution computeTrans_(const std::unordered_map<int,int>& cartesianToActive) const;
     std::vector<NNCdata> exportNncStructure_(const std::unordered_map<int,int>& cartesianToActive) const;
 };
@@ -306,6 +306,18 @@ public:
         data.serializeOp(*this);
     }
 
+    //! \brief Returns the size of the serialized data in bytes.
+    //! \tparam T Type of class to serialize
+    //! \param data Class to serialize
+    template<class T>
+    size_t packSize(T& data)
+    {
+        m_op = Operation::PACKSIZE;
+        m_packSize = 0;
+        data.serializeOp(*this);
+        return m_packSize;
+    }
+
     //! \brief Call this to de-serialize data.
     //! \tparam T Type of class to de-serialize
     //! \param data Class to de-serialize
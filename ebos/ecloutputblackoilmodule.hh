@@ -28,9 +28,13 @@
 #define EWOMS_ECL_OUTPUT_BLACK_OIL_MODULE_HH
 
 #include <array>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <opm/models/blackoil/blackoilproperties.hh>
 
@@ -139,6 +143,11 @@ public:
             }
         }
 
+        // the block summary vectors of every cell, processElement() does not
+        // have to look at the vectors of the other cells
+        for (auto& val : this->blockData_)
+            this->blockNodes_[val.first.second - 1].push_back(&val);
+
         for (const auto& global_index : wbp_index_list) {
             if (collectToIORank.isCartIdxOnThisRank(global_index - 1))
                 this->wbpData_[global_index] = 0.0;
@@ -159,8 +168,12 @@ public:
     /*!
      * \brief Allocate memory for the scalar fields we would like to
      *        write to ECL output files
+     *
+     * If summaryOnly is true, only the fields needed for the summary, the
+     * fluid in place and the RFT data are allocated.
      */
-    void allocBuffers(unsigned bufferSize, unsigned reportStepNum, const bool substep, const bool log, const bool isRestart)
+    void allocBuffers(unsigned bufferSize, unsigned reportStepNum, const bool substep, const bool log, const bool isRestart,
+                      const bool summaryOnly)
     {
         if (!std::is_same<Discretization, EcfvDiscretization<TypeTag> >::value)
             return;
@@ -170,6 +183,7 @@ public:
                              substep,
                              log,
                              isRestart,
+                             summaryOnly,
                              simulator_.problem().vapparsActive(std::max(simulator_.episodeIndex(), 0)),
                              simulator_.problem().materialLawManager()->enableHysteresis(),
                              simulator_.problem().tracerModel().numTracers());
@@ -457,10 +471,11 @@ public:
 
             // Adding block data
             const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-            for (auto& val: this->blockData_) {
-                const auto& key = val.first;
-                int cartesianIdxBlock = key.second - 1;
-                if (cartesianIdx == cartesianIdxBlock) {
+            const auto blockNodes = this->blockNodes_.find(cartesianIdx);
+            if (blockNodes != this->blockNodes_.end()) {
+                for (auto* node : blockNodes->second) {
+                    auto& val = *node;
+                    const auto& key = val.first;
                     if ((key.first == "BWSAT") || (key.first == "BSWAT"))
                         val.second = getValue(fs.saturation(waterPhaseIdx));
                     else if ((key.first == "BGSAT") || (key.first == "BSGAS"))
@@ -505,14 +520,17 @@ public:
             }
 
             // Adding Well RFT data
-            if (this->oilConnectionPressures_.count(cartesianIdx) > 0) {
-                this->oilConnectionPressures_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
+            if (auto it = this->oilConnectionPressures_.find(cartesianIdx);
+                it != this->oilConnectionPressures_.end()) {
+                it->second = getValue(fs.pressure(oilPhaseIdx));
             }
-            if (this->waterConnectionSaturations_.count(cartesianIdx) > 0) {
-                this->waterConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(waterPhaseIdx));
+            if (auto it = this->waterConnectionSaturations_.find(cartesianIdx);
+                it != this->waterConnectionSaturations_.end()) {
+                it->second = getValue(fs.saturation(waterPhaseIdx));
             }
-            if (this->gasConnectionSaturations_.count(cartesianIdx) > 0) {
-                this->gasConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(gasPhaseIdx));
+            if (auto it = this->gasConnectionSaturations_.find(cartesianIdx);
+                it != this->gasConnectionSaturations_.end()) {
+                it->second = getValue(fs.saturation(gasPhaseIdx));
             }
             if (this->wbpData_.count(cartesianIdx) > 0)
                 this->wbpData_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
@@ -706,6 +724,8 @@ private:
     }
 
     const Simulator& simulator_;
+    // the entries of blockData_ by Cartesian cell index
+    std::unordered_map<int, std::vector<std::map<std::pair<std::string, int>, double>::value_type*>> blockNodes_;
 };
 
 } // namespace Opm
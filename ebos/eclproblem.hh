@@ -61,6 +61,7 @@
 #include "eclthresholdpressure.hh"
 #include "ecldummygradientcalculator.hh"
 #include "eclfluxmodule.hh"
+#include "eclfacefluxes.hh"
 #include "eclbaseaquifermodel.hh"
 #include "eclnewtonmethod.hh"
 #include "ecltracermodel.hh"
@@ -68,8 +69,13 @@
 #include "eclgenericproblem.hh"
 
 #include <opm/core/props/satfunc/RelpermDiagnostics.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+#if HAVE_MPI
+#include <opm/simulators/utils/ParallelEclipseState.hpp>
+#endif
 
 #include <opm/models/utils/pffgridvector.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/models/blackoil/blackoilmodel.hh>
 #include <opm/models/discretization/ecfv/ecfvdiscretization.hh>
 
@@ -98,12 +104,14 @@
 #include <dune/common/version.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
+#include <dune/grid/io/file/vtk/common.hh>
 
 #include <opm/output/eclipse/EclipseIO.hpp>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
 #include <set>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -206,6 +214,10 @@ struct EclEnableTuning {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct EclSkipUnchangedRelpermDiagnostics {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct OutputMode {
     using type = UndefinedProperty;
 };
@@ -433,6 +445,19 @@ struct EnableVtkOutput<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+// If the VTK output is enabled, write it as appended raw binary data, which is
+// neither converted to text nor base64 encoded ...
+template<class TypeTag>
+struct VtkOutputFormat<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = Dune::VTK::appendedraw;
+};
+
+// ... and in a separate thread, like the ECL output
+template<class TypeTag>
+struct EnableAsyncVtkOutput<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = true;
+};
+
 // ... but enable the ECL output by default
 template<class TypeTag>
 struct EnableEclOutput<TypeTag,TTag::EclBaseProblem> {
@@ -445,6 +470,18 @@ struct EnableAsyncEclOutput<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = true;
 };
 
+// Wait for the previous ECL output request before the next one is queued
+template<class TypeTag>
+struct EclOutputMaxPendingWrites<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = 1;
+};
+
+// Write the summary ministeps of a report step together, or every 100 ministeps
+template<class TypeTag>
+struct EclOutputSummaryBatchSize<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = 100;
+};
+
 // By default, use single precision for the ECL formated results
 template<class TypeTag>
 struct EclOutputDoublePrecision<TypeTag, TTag::EclBaseProblem> {
@@ -551,6 +588,11 @@ struct EnableTracerModel<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+template<class TypeTag>
+struct EnableReorderedTracerSolver<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
 // By default, simulators derived from the EclBaseProblem are production simulators,
 // i.e., experimental features must be explicitly enabled at compile time
 template<class TypeTag>
@@ -573,6 +615,10 @@ template<class TypeTag>
 struct EclEnableTuning<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
+template<class TypeTag>
+struct EclSkipUnchangedRelpermDiagnostics<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
 
 template<class TypeTag>
 struct OutputMode<TypeTag, TTag::EclBaseProblem> {
@@ -697,6 +743,8 @@ public:
                              "The frequencies of which time steps are serialized to disk");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTracerModel,
                              "Transport tracers found in the deck.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableReorderedTracerSolver,
+                             "Solve the tracers cell by cell in upwind order instead of by an iterative linear solver");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EclEnableDriftCompensation,
                              "Enable partial compensation of systematic mass losses via the source term of the next time step");
         if constexpr (enableExperiments)
@@ -708,6 +756,8 @@ public:
                              "Factor by which the time step is reduced after convergence failure");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EclEnableTuning,
                              "Honor some aspects of the TUNING keyword from the ECL deck.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EclSkipUnchangedRelpermDiagnostics,
+                             "Skip the saturation function diagnostics if the deck is unchanged since they were last done");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputMode,
                              "Specify which messages are going to be printed. Valid values are: none, log, all (default)");
 
@@ -810,8 +860,26 @@ public:
         this->restartShrinkFactor_ = EWOMS_GET_PARAM(TypeTag, Scalar, EclRestartShrinkFactor);
         this->maxFails_ = EWOMS_GET_PARAM(TypeTag, unsigned, MaxTimeStepDivisions);
 
-        RelpermDiagnostics relpermDiagnostics;
-        relpermDiagnostics.diagnosis(vanguard.eclState(), vanguard.cartesianIndexMapper());
+        // the diagnostics of the end point scaling are done for the interior cells of
+        // every process.
+        const auto& comm = this->gridView().comm();
+        const std::string diagnosticsHashFile = vanguard.eclState().getIOConfig().fullBasePath() + ".RPDIAG";
+        if (!EWOMS_GET_PARAM(TypeTag, bool, EclSkipUnchangedRelpermDiagnostics)
+            || !RelpermDiagnostics::upToDate(vanguard.deck(), diagnosticsHashFile, comm))
+        {
+            std::vector<bool> isInterior;
+            if (comm.size() > 1) {
+                isInterior.resize(this->gridView().size(/*codim=*/0));
+                auto elemIt = this->gridView().template begin</*codim=*/0>();
+                const auto& elemEndIt = this->gridView().template end</*codim=*/0>();
+                for (; elemIt != elemEndIt; ++elemIt)
+                    isInterior[this->elementMapper().index(*elemIt)] = elemIt->partitionType() == Dune::InteriorEntity;
+            }
+            RelpermDiagnostics relpermDiagnostics;
+            relpermDiagnostics.diagnosis(vanguard.eclState(), vanguard.cartesianIndexMapper(), comm, isInterior);
+        }
+        else
+            OpmLog::info("The saturation function diagnostics are skipped since the deck is unchanged.");
     }
 
     /*!
@@ -931,6 +999,13 @@ public:
 
         simulator.vanguard().releaseGlobalTransmissibilities();
 
+#if HAVE_MPI
+        // the global properties broadcast for the INIT file and the
+        // diagnostics are not needed for the time steps
+        if (auto* parallelEclState = dynamic_cast<ParallelEclipseState*>(&simulator.vanguard().eclState()))
+            parallelEclState->releaseGlobalPropsCache();
+#endif
+
         // after finishing the initialization and writing the initial solution, we move
         // to the first "real" episode/report step
         // for restart the episode index and start is already set
@@ -960,12 +1035,27 @@ public:
         // reload the current episode/report step from the deck
         beginEpisode();
 
+        // the history dependent quantities of the elements
+        res.deserializeSectionBegin("EclProblem");
+        auto& is = res.deserializeStream();
+        this->readCheckpoint_(is);
+        std::vector<Scalar> drift;
+        BinaryCheckpoint::read(is, drift);
+        if (drift.size() != drift_.size()*numEq)
+            throw std::runtime_error("The checkpoint does not match the grid of the simulation");
+        for (unsigned globalDofIdx = 0; globalDofIdx < drift_.size(); ++globalDofIdx)
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                drift_[globalDofIdx][eqIdx] = drift[globalDofIdx*numEq + eqIdx];
+        res.deserializeSectionEnd();
+
         // deserialize the wells
         wellModel_.deserialize(res);
 
         if (enableAquifers_)
             // deserialize the aquifer
             aquiferModel_.deserialize(res);
+
+        tracerModel_.deserialize(res);
     }
 
     /*!
@@ -977,10 +1067,22 @@ public:
     template <class Restarter>
     void serialize(Restarter& res)
     {
+        res.serializeSectionBegin("EclProblem");
+        auto& os = res.serializeStream();
+        this->writeCheckpoint_(os);
+        std::vector<Scalar> drift(drift_.size()*numEq);
+        for (unsigned globalDofIdx = 0; globalDofIdx < drift_.size(); ++globalDofIdx)
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                drift[globalDofIdx*numEq + eqIdx] = drift_[globalDofIdx][eqIdx];
+        BinaryCheckpoint::write(os, drift);
+        res.serializeSectionEnd();
+
         wellModel_.serialize(res);
 
         if (enableAquifers_)
             aquiferModel_.serialize(res);
+
+        tracerModel_.serialize(res);
     }
 
     int episodeIndex() const
@@ -1051,22 +1153,21 @@ public:
                              this->simulator().timeStepSize(),
                              this->simulator().endTime());
 
-        // update maximum water saturation and minimum pressure
-        // used when ROCKCOMP is activated
-        const bool invalidateFromMaxWaterSat = updateMaxWaterSaturation_();
-        const bool invalidateFromMinPressure = updateMinPressure_();
+        // A time step which is repeated after a failed attempt starts from the
+        // same solution as the failed attempt. The maxima and minima below have
+        // already been updated with that solution, so the grid sweeps and the
+        // update of the intensive quantities can be skipped.
+        if (timeStepCompleted_) {
+            if (updateExplicitQuantities_())
+                this->model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
 
-        // update hysteresis and max oil saturation used in vappars
-        const bool invalidateFromHyst = updateHysteresis_();
-        const bool invalidateFromMaxOilSat = updateMaxOilSaturation_();
-
-        // the derivatives may have change
-        bool invalidateIntensiveQuantities = invalidateFromMaxWaterSat || invalidateFromMinPressure || invalidateFromHyst || invalidateFromMaxOilSat;
-        if (invalidateIntensiveQuantities)
-            this->model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+            // the maximum polymer adsorption is taken from the updated
+            // intensive quantities
+            if constexpr (enablePolymer)
+                updateMaxPolymerAdsorption_();
 
-        if constexpr (getPropValue<TypeTag, Properties::EnablePolymer>())
-            updateMaxPolymerAdsorption_();
+            timeStepCompleted_ = false;
+        }
 
         wellModel_.beginTimeStep();
         if (enableAquifers_)
@@ -1115,6 +1216,11 @@ public:
         }
 #endif // NDEBUG
 
+        timeStepCompleted_ = true;
+
+        // the wells and aquifers use the intensive quantities of the final solution
+        updateKeptIntensiveQuantities_();
+
         auto& simulator = this->simulator();
         wellModel_.endTimeStep();
         if (enableAquifers_)
@@ -1252,15 +1358,15 @@ public:
 
         Action::Context context( summaryState, schedule[reportStep].wlist_manager() );
         auto now = TimeStampUTC( schedule.getStartTime() ) + std::chrono::duration<double>(sim_time);
-        std::string ts;
-        {
+        // The time stamp is only formatted for the log messages of the
+        // actions that are evaluated.
+        auto timeStamp = [&now, reportStep]() {
             std::ostringstream os;
             os << std::setw(4) <<                      std::to_string(now.year())  << '/'
                << std::setw(2) << std::setfill('0') << std::to_string(now.month()) << '/'
                << std::setw(2) << std::setfill('0') << std::to_string(now.day()) << "  report:" << std::to_string(reportStep);
-
-            ts = os.str();
-        }
+            return os.str();
+        };
 
         for (const auto& pyaction : actions.pending_python()) {
             pyaction->run(ecl_state, schedule, reportStep, summaryState);
@@ -1268,7 +1374,10 @@ public:
 
         bool commit_wellstate = false;
         auto simTime = asTimeT(now);
+        std::string ts;
         for (const auto& action : actions.pending(actionState, simTime)) {
+            if (ts.empty())
+                ts = timeStamp();
             auto actionResult = action->eval(context);
             if (actionResult) {
                 std::string wells_string;
@@ -1403,12 +1512,86 @@ public:
     const typename Vanguard::TransmissibilityType& eclTransmissibilities() const
     { return transmissibilities_; }
 
+    /*!
+     * \brief Set the transmissibilities of some intersections between two elements,
+     *        e.g. from the Python bindings, between two time steps.
+     *
+     * The values are kept until all transmissibilities are recomputed, e.g. due to
+     * a geometry keyword in the SCHEDULE section.
+     */
+    void setTransmissibilities(const std::vector<unsigned>& elem1Idx,
+                               const std::vector<unsigned>& elem2Idx,
+                               const std::vector<Scalar>& trans)
+    {
+        if (elem1Idx.size() != trans.size() || elem2Idx.size() != trans.size())
+            throw std::invalid_argument("The number of elements and transmissibilities differ");
+
+        // throws before anything is modified if an intersection does not exist
+        for (std::size_t faceIdx = 0; faceIdx < trans.size(); ++faceIdx)
+            transmissibilities_.transmissibility(elem1Idx[faceIdx], elem2Idx[faceIdx]);
+
+        for (std::size_t faceIdx = 0; faceIdx < trans.size(); ++faceIdx)
+            transmissibilities_.setTransmissibility(elem1Idx[faceIdx], elem2Idx[faceIdx], trans[faceIdx]);
+        updatePffDofData_();
+    }
+
+    /*!
+     * \brief Set the permeabilities of all elements, e.g. from the Python bindings,
+     *        between two time steps and recompute the transmissibilities from them.
+     *
+     * The connection factors of the wells are not recomputed.
+     */
+    void setPermeabilities(const std::vector<DimMatrix>& perm)
+    {
+        if (perm.size() != this->model().numGridDof())
+            throw std::invalid_argument("Expected one permeability per element");
+
+        for (unsigned elemIdx = 0; elemIdx < perm.size(); ++elemIdx)
+            transmissibilities_.setPermeability(elemIdx, perm[elemIdx]);
+        transmissibilities_.update(true, /*extractPermeability=*/false);
+        updatePffDofData_();
+    }
+
     /*!
      * \copydoc BlackOilBaseProblem::thresholdPressure
      */
     Scalar thresholdPressure(unsigned elem1Idx, unsigned elem2Idx) const
     { return thresholdPressures_.thresholdPressure(elem1Idx, elem2Idx); }
 
+    /*!
+     * \brief Return the threshold pressure for the face between the center element of
+     *        a context and one of its neighbors.
+     *
+     * This is the same value as thresholdPressure(elem1Idx, elem2Idx), but it is
+     * taken from the prefetched per face data instead of being looked up via the
+     * EQUIL regions of the elements.
+     */
+    template <class Context>
+    Scalar thresholdPressure(const Context& context,
+                             [[maybe_unused]] unsigned fromDofLocalIdx,
+                             unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx).thresholdPressure;
+    }
+
+    /*!
+     * \brief Return the gravity times the depth of the center element of a context
+     *        minus the depth of one of its neighbors.
+     *
+     * This is the hydrostatic pressure difference per density between the centers
+     * of the two elements, prefetched per face since gravity and cell depths do not
+     * change during a simulation.
+     */
+    template <class Context>
+    Scalar gravityDepthDifference(const Context& context,
+                                  [[maybe_unused]] unsigned fromDofLocalIdx,
+                                  unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx).gravityDepthDifference;
+    }
+
     const EclThresholdPressure<TypeTag>& thresholdPressure() const
     { return thresholdPressures_; }
 
@@ -1418,6 +1601,62 @@ public:
     const EclTracerModel<TypeTag>& tracerModel() const
     { return tracerModel_; }
 
+    /*!
+     * \brief The fluxes over the interior faces recorded by the flux module.
+     *
+     * The fluxes are a cache of the extensive quantities, hence they can be
+     * recorded through a constant problem.
+     */
+    EclFaceFluxes<Scalar, numPhases>& faceFluxes() const
+    { return faceFluxes_; }
+
+    /*!
+     * \brief Returns the intensive quantities of a cell for the current solution,
+     *        or nullptr if they are not available.
+     *
+     * These are the cached intensive quantities of the model. If the model does not
+     * cache the intensive quantities (EnableIntensiveQuantityCache=false), only those
+     * of the cells passed to keepIntensiveQuantities() are available, i.e., the ones
+     * of the cells connected to the wells and the aquifers.
+     */
+    const IntensiveQuantities* cachedIntensiveQuantities(unsigned globalDofIdx) const
+    {
+        if (this->model().storeIntensiveQuantities())
+            return this->model().cachedIntensiveQuantities(globalDofIdx, /*timeIdx=*/0);
+
+        if (globalDofIdx >= keptIntensiveQuantitiesIdx_.size() || keptIntensiveQuantitiesIdx_[globalDofIdx] < 0)
+            return nullptr;
+        return &keptIntensiveQuantities_[keptIntensiveQuantitiesIdx_[globalDofIdx]];
+    }
+
+    /*!
+     * \brief Keep the intensive quantities of some cells if the model does not cache
+     *        them, and evaluate those of all kept cells for the current solution.
+     */
+    void keepIntensiveQuantities(const std::vector<int>& cells)
+    {
+        if (this->model().storeIntensiveQuantities())
+            return;
+
+        keptIntensiveQuantitiesIdx_.resize(this->model().numGridDof(), -1);
+        for (const int cellIdx : cells) {
+            if (cellIdx >= 0 && keptIntensiveQuantitiesIdx_[cellIdx] < 0) {
+                keptIntensiveQuantitiesIdx_[cellIdx] = keptIntensiveQuantities_.size();
+                keptIntensiveQuantities_.emplace_back();
+            }
+        }
+        updateKeptIntensiveQuantities_();
+    }
+
+    /*!
+     * \brief The memory used by the intensive quantities kept by the problem.
+     */
+    std::size_t keptIntensiveQuantitiesBytes() const
+    {
+        return keptIntensiveQuantities_.capacity()*sizeof(IntensiveQuantities)
+            + keptIntensiveQuantitiesIdx_.capacity()*sizeof(int);
+    }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::porosity
      *
@@ -1807,6 +2046,8 @@ public:
         // this point, because determining the threshold pressures may require to access
         // the initial solution.
         thresholdPressures_.finishInit();
+        // the threshold pressures of the faces are prefetched as well.
+        updatePffDofData_();
 
         updateCompositionChangeLimits_();
 
@@ -1898,6 +2139,12 @@ public:
     const EclipseIO& eclIO() const
     { return eclWriter_->eclIO(); }
 
+    int numPendingOutputWrites() const
+    { return eclWriter_->numPendingWrites(); }
+
+    std::size_t outputBufferBytes() const
+    { return eclWriter_->eclOutputModule().bufferBytes(); }
+
     bool nonTrivialBoundaryConditions() const
     { return nonTrivialBoundaryConditions_; }
 
@@ -2006,6 +2253,29 @@ public:
     }
 
 private:
+    // evaluate the intensive quantities of the cells which are kept if the model
+    // does not cache them
+    void updateKeptIntensiveQuantities_()
+    {
+        if (keptIntensiveQuantities_.empty())
+            return;
+
+        ElementContext elemCtx(this->simulator());
+        const auto& gridView = this->gridView();
+        auto elemIt = gridView.template begin</*codim=*/0>();
+        const auto& elemEndIt = gridView.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            const int keptIdx = keptIntensiveQuantitiesIdx_[this->elementMapper().index(elem)];
+            if (keptIdx < 0)
+                continue;
+
+            elemCtx.updatePrimaryStencil(elem);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            keptIntensiveQuantities_[keptIdx] = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+        }
+    }
+
     // update the parameters needed for DRSDT and DRVDT
     void updateCompositionChangeLimits_()
     {
@@ -2107,94 +2377,104 @@ private:
         }
     }
 
-    bool updateMaxOilSaturation_()
+    // Update the hysteresis parameters of the material laws, the maximum oil and
+    // water saturations and the minimum oil pressure with the solution of the
+    // last time step. All of them are updated in a single pass over the grid
+    // which uses the cached intensive quantities, and only those which are
+    // used by the deck are touched. Returns whether the intensive quantities
+    // need to be updated.
+    bool updateExplicitQuantities_()
     {
-        const auto& simulator = this->simulator();
-        int episodeIdx = this->episodeIndex();
+        // hysteresis and max oil saturation used in VAPPARS
+        const bool updateHysteresis = materialLawManager_->enableHysteresis();
+        const bool updateMaxOilSat = this->vapparsActive(this->episodeIndex());
+        // max water saturation and min pressure used when ROCKCOMP is activated
+        const bool updateMaxWaterSat = !this->maxWaterSaturation_.empty();
+        const bool updateMinPressure = !this->minOilPressure_.empty();
+
+        if (!updateHysteresis && !updateMaxOilSat && !updateMaxWaterSat && !updateMinPressure)
+            return false;
+
+        if (updateMaxWaterSat)
+            this->maxWaterSaturation_[/*timeIdx=*/1] = this->maxWaterSaturation_[/*timeIdx=*/0];
 
-        // we use VAPPARS
-        if (this->vapparsActive(episodeIdx)) {
+        // we need to update the data for _all_ elements (i.e., not just the
+        // interior ones) to avoid desynchronization of the processes in the
+        // parallel case! Every element only writes to its own entries, so the
+        // elements can be processed concurrently.
+        const auto& simulator = this->simulator();
+        const auto& model = this->model();
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
             ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
+            auto elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
                 const Element& elem = *elemIt;
+                const unsigned compressedDofIdx = this->elementMapper().index(elem);
 
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                const IntensiveQuantities* iqPtr = model.cachedIntensiveQuantities(compressedDofIdx, /*timeIdx=*/0);
+                if (!iqPtr) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    iqPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
+                const auto& iq = *iqPtr;
                 const auto& fs = iq.fluidState();
 
-                Scalar So = decay<Scalar>(fs.saturation(oilPhaseIdx));
-
-                this->maxOilSaturation_[compressedDofIdx] = std::max(this->maxOilSaturation_[compressedDofIdx], So);
-            }
-
-            // we need to invalidate the intensive quantities cache here because the
-            // derivatives of Rs and Rv will most likely have changed
-            return true;
-        }
-
-        return false;
-    }
-
-    bool updateMaxWaterSaturation_()
-    {
-        // water compaction is activated in ROCKCOMP
-        if (this->maxWaterSaturation_.empty())
-            return false;
-
-        this->maxWaterSaturation_[/*timeIdx=*/1] = this->maxWaterSaturation_[/*timeIdx=*/0];
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
+                if (updateMaxWaterSat) {
+                    Scalar Sw = decay<Scalar>(fs.saturation(waterPhaseIdx));
+                    this->maxWaterSaturation_[compressedDofIdx] = std::max(this->maxWaterSaturation_[compressedDofIdx], Sw);
+                }
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                if (updateMinPressure)
+                    this->minOilPressure_[compressedDofIdx] =
+                        std::min(this->minOilPressure_[compressedDofIdx],
+                                 getValue(fs.pressure(oilPhaseIdx)));
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+                if (updateHysteresis)
+                    materialLawManager_->updateHysteresis(fs, compressedDofIdx);
 
-            Scalar Sw = decay<Scalar>(fs.saturation(waterPhaseIdx));
-            this->maxWaterSaturation_[compressedDofIdx] = std::max(this->maxWaterSaturation_[compressedDofIdx], Sw);
+                if (updateMaxOilSat) {
+                    Scalar So = decay<Scalar>(fs.saturation(oilPhaseIdx));
+                    this->maxOilSaturation_[compressedDofIdx] = std::max(this->maxOilSaturation_[compressedDofIdx], So);
+                }
+            }
         }
 
+        // the derivatives of e.g. Rs and Rv will most likely have changed
         return true;
     }
 
-    bool updateMinPressure_()
+    void updateMaxPolymerAdsorption_()
     {
-        // IRREVERS option is used in ROCKCOMP
-        if (this->minOilPressure_.empty())
-            return false;
-
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        // we need to update the max polymer adsoption data for all elements
+        const auto& simulator = this->simulator();
+        const auto& model = this->model();
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            auto elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                const unsigned compressedDofIdx = this->elementMapper().index(elem);
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+                const IntensiveQuantities* iqPtr = model.cachedIntensiveQuantities(compressedDofIdx, /*timeIdx=*/0);
+                if (!iqPtr) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    iqPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
 
-            this->minOilPressure_[compressedDofIdx] =
-                std::min(this->minOilPressure_[compressedDofIdx],
-                         getValue(fs.pressure(oilPhaseIdx)));
+                this->maxPolymerAdsorption_[compressedDofIdx] = std::max(this->maxPolymerAdsorption_[compressedDofIdx],
+                                                                         scalarValue(iqPtr->polymerAdsorption()));
+            }
         }
-
-        return true;
     }
 
     void readMaterialParameters_()
@@ -2374,8 +2654,10 @@ private:
                     this->solventSaturation_[elemIdx] = ssol;
             }
 
-            this->lastRs_[elemIdx] = elemFluidState.Rs();
-            this->lastRv_[elemIdx] = elemFluidState.Rv();
+            if (!this->lastRs_.empty())
+                this->lastRs_[elemIdx] = elemFluidState.Rs();
+            if (!this->lastRv_.empty())
+                this->lastRv_[elemIdx] = elemFluidState.Rv();
 
             if constexpr (enablePolymer)
                  this->polymerConcentration_[elemIdx] = eclWriter_->eclOutputModule().getPolymerConcentration(elemIdx);
@@ -2599,60 +2881,14 @@ private:
         }
     }
 
-    // update the hysteresis parameters of the material laws for the whole grid
-    bool updateHysteresis_()
-    {
-        if (!materialLawManager_->enableHysteresis())
-            return false;
-
-        // we need to update the hysteresis data for _all_ elements (i.e., not just the
-        // interior ones) to avoid desynchronization of the processes in the parallel case!
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
-        }
-        return true;
-    }
-
-    void updateMaxPolymerAdsorption_()
-    {
-        // we need to update the max polymer adsoption data for all elements
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-
-            this->maxPolymerAdsorption_[compressedDofIdx] = std::max(this->maxPolymerAdsorption_[compressedDofIdx],
-                                                                     scalarValue(intQuants.polymerAdsorption()));
-        }
-    }
-
     struct PffDofData_
     {
         ConditionalStorage<enableEnergy, Scalar> thermalHalfTransIn;
         ConditionalStorage<enableEnergy, Scalar> thermalHalfTransOut;
         ConditionalStorage<enableDiffusion, Scalar> diffusivity;
         Scalar transmissibility;
+        Scalar thresholdPressure;
+        Scalar gravityDepthDifference;
     };
 
     // update the prefetch friendly data object
@@ -2670,6 +2906,10 @@ private:
             if (localDofIdx != 0) {
                 unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
                 dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
+                dofData.thresholdPressure = thresholdPressures_.thresholdPressure(globalCenterElemIdx, globalElemIdx);
+                const auto& vanguard = this->simulator().vanguard();
+                dofData.gravityDepthDifference =
+                    this->gravity_[dim - 1]*(vanguard.cellCenterDepth(globalCenterElemIdx) - vanguard.cellCenterDepth(globalElemIdx));
 
                 if constexpr (enableEnergy) {
                     *dofData.thermalHalfTransIn = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
@@ -2879,6 +3119,9 @@ private:
     bool enableDriftCompensation_;
     GlobalEqVector drift_;
 
+    // false between the beginning of a time step and its successful end
+    bool timeStepCompleted_ = true;
+
     EclWellModel wellModel_;
     bool enableAquifers_;
     EclAquiferModel aquiferModel_;
@@ -2888,6 +3131,12 @@ private:
 
     PffGridVector<GridView, Stencil, PffDofData_, DofMapper> pffDofData_;
     TracerModel tracerModel_;
+    mutable EclFaceFluxes<Scalar, numPhases> faceFluxes_;
+
+    // the intensive quantities of the cells of the wells and aquifers if the model
+    // does not cache them, and their index for every cell (-1 if not kept)
+    std::vector<IntensiveQuantities> keptIntensiveQuantities_;
+    std::vector<int> keptIntensiveQuantitiesIdx_;
 
     std::vector<bool> freebcX_;
     std::vector<bool> freebcXMinus_;
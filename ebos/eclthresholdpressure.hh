@@ -31,6 +31,7 @@
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 #include <opm/models/common/multiphasebaseproperties.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 #include <ebos/eclgenericthresholdpressure.hh>
 
 #include <opm/material/densead/Evaluation.hpp>
@@ -92,6 +93,8 @@ public:
             this->computeDefaultThresholdPressures_();
             this->applyExplicitThresholdPressures_();
         }
+        if (this->enableThresholdPressure_)
+            this->updateFaceThresholdPressures_();
     }
 
 private:
@@ -102,62 +105,75 @@ private:
         const auto& gridView = vanguard.gridView();
 
         typedef MathToolbox<Evaluation> Toolbox;
+        using GridView = GetPropType<TypeTag, Properties::GridView>;
         // loop over the whole grid and compute the maximum gravity adjusted pressure
-        // difference between two EQUIL regions.
-        auto elemIt = gridView.template begin</*codim=*/ 0>();
-        const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
-        ElementContext elemCtx(simulator_);
-        for (; elemIt != elemEndIt; ++elemIt) {
+        // difference between two EQUIL regions. each thread accumulates the maxima of
+        // its elements which are then merged.
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            std::vector<Scalar> thpresDefault(this->thpresDefault_.size(), 0.0);
+            ElementContext elemCtx(simulator_);
+            auto elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const auto& elem = *elemIt;
+                if (elem.partitionType() != Dune::InteriorEntity)
+                    continue;
 
-            const auto& elem = *elemIt;
-            if (elem.partitionType() != Dune::InteriorEntity)
-                continue;
+                elemCtx.updateAll(elem);
+                const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
 
-            elemCtx.updateAll(elem);
-            const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+                for (unsigned scvfIdx = 0; scvfIdx < stencil.numInteriorFaces(); ++ scvfIdx) {
+                    const auto& face = stencil.interiorFace(scvfIdx);
 
-            for (unsigned scvfIdx = 0; scvfIdx < stencil.numInteriorFaces(); ++ scvfIdx) {
-                const auto& face = stencil.interiorFace(scvfIdx);
+                    unsigned i = face.interiorIndex();
+                    unsigned j = face.exteriorIndex();
 
-                unsigned i = face.interiorIndex();
-                unsigned j = face.exteriorIndex();
+                    unsigned insideElemIdx = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
+                    unsigned outsideElemIdx = elemCtx.globalSpaceIndex(j, /*timeIdx=*/0);
 
-                unsigned insideElemIdx = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
-                unsigned outsideElemIdx = elemCtx.globalSpaceIndex(j, /*timeIdx=*/0);
+                    unsigned equilRegionInside = this->elemEquilRegion_[insideElemIdx];
+                    unsigned equilRegionOutside = this->elemEquilRegion_[outsideElemIdx];
 
-                unsigned equilRegionInside = this->elemEquilRegion_[insideElemIdx];
-                unsigned equilRegionOutside = this->elemEquilRegion_[outsideElemIdx];
+                    if (equilRegionInside == equilRegionOutside)
+                        // the current face is not at the boundary between EQUIL regions!
+                        continue;
 
-                if (equilRegionInside == equilRegionOutside)
-                    // the current face is not at the boundary between EQUIL regions!
-                    continue;
+                    // don't include connections with negligible flow
+                    const Evaluation& trans = simulator_.problem().transmissibility(elemCtx, i, j);
+                    Scalar faceArea = face.area();
+                    if (std::abs(faceArea*getValue(trans)) < 1e-18)
+                        continue;
 
-                // don't include connections with negligible flow
-                const Evaluation& trans = simulator_.problem().transmissibility(elemCtx, i, j);
-                Scalar faceArea = face.area();
-                if (std::abs(faceArea*getValue(trans)) < 1e-18)
-                    continue;
+                    // determine the maximum difference of the pressure of any phase over the
+                    // intersection
+                    Scalar pth = 0.0;
+                    const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, /*timeIdx=*/0);
+                    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                        unsigned upIdx = extQuants.upstreamIndex(phaseIdx);
+                        const auto& up = elemCtx.intensiveQuantities(upIdx, /*timeIdx=*/0);
 
-                // determine the maximum difference of the pressure of any phase over the
-                // intersection
-                Scalar pth = 0.0;
-                const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, /*timeIdx=*/0);
-                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                    unsigned upIdx = extQuants.upstreamIndex(phaseIdx);
-                    const auto& up = elemCtx.intensiveQuantities(upIdx, /*timeIdx=*/0);
-
-                    if (up.mobility(phaseIdx) > 0.0) {
-                        Scalar phaseVal = Toolbox::value(extQuants.pressureDifference(phaseIdx));
-                        pth = std::max(pth, std::abs(phaseVal));
+                        if (up.mobility(phaseIdx) > 0.0) {
+                            Scalar phaseVal = Toolbox::value(extQuants.pressureDifference(phaseIdx));
+                            pth = std::max(pth, std::abs(phaseVal));
+                        }
                     }
-                }
 
-                int offset1 = equilRegionInside*this->numEquilRegions_ + equilRegionOutside;
-                int offset2 = equilRegionOutside*this->numEquilRegions_ + equilRegionInside;
+                    int offset1 = equilRegionInside*this->numEquilRegions_ + equilRegionOutside;
+                    int offset2 = equilRegionOutside*this->numEquilRegions_ + equilRegionInside;
 
-                this->thpresDefault_[offset1] = std::max(this->thpresDefault_[offset1], pth);
-                this->thpresDefault_[offset2] = std::max(this->thpresDefault_[offset2], pth);
+                    thpresDefault[offset1] = std::max(thpresDefault[offset1], pth);
+                    thpresDefault[offset2] = std::max(thpresDefault[offset2], pth);
+                }
             }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            for (unsigned i = 0; i < thpresDefault.size(); ++i)
+                this->thpresDefault_[i] = std::max(this->thpresDefault_[i], thpresDefault[i]);
         }
 
         // make sure that the threshold pressures is consistent for parallel
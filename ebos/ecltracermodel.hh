@@ -32,6 +32,10 @@
 
 #include <opm/models/utils/propertysystem.hh>
 
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -42,6 +46,11 @@ struct EnableTracerModel {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct EnableReorderedTracerSolver {
+    using type = UndefinedProperty;
+};
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -101,6 +110,11 @@ public:
         bool enabled = EWOMS_GET_PARAM(TypeTag, bool, EnableTracerModel);
         this->doInit(enabled, simulator_.model().numGridDof(),
                      gasPhaseIdx, oilPhaseIdx, waterPhaseIdx);
+        useReorderedSolver_ = EWOMS_GET_PARAM(TypeTag, bool, EnableReorderedTracerSolver);
+
+        // let the flow linearization record the fluxes the tracers are transported by
+        if (this->numTracers() > 0)
+            simulator_.problem().faceFluxes().enable(this->numInteriorFaces_);
     }
 
     void beginTimeStep()
@@ -109,6 +123,7 @@ public:
             return;
 
         this->tracerConcentrationInitial_ = this->tracerConcentration_;
+        simulator_.problem().faceFluxes().invalidate();
 
         // compute storageCache
         ElementContext elemCtx(simulator_);
@@ -133,17 +148,35 @@ public:
         if (this->numTracers()==0)
             return;
 
-        for (int tracerIdx = 0; tracerIdx < this->numTracers(); ++ tracerIdx){
+        // The Jacobian only depends on the phase of the tracer, it is
+        // linearized and factorized once for all tracers of a phase.
+        for (int phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (std::find(this->tracerPhaseIdx_.begin(), this->tracerPhaseIdx_.end(), phaseIdx) == this->tracerPhaseIdx_.end())
+                continue;
 
-            typename BaseType::TracerVector dx(this->tracerResidual_.size());
-            // Newton step (currently the system is linear, converge in one iteration)
-            for (int iter = 0; iter < 5; ++ iter){
-                linearize_(tracerIdx);
-                this->linearSolve_(*this->tracerMatrix_, dx, this->tracerResidual_);
-                this->tracerConcentration_[tracerIdx] -= dx;
+            linearizeMatrix_(phaseIdx);
+            if (useReorderedSolver_)
+                this->prepareReorderedSolve_();
+            else
+                this->prepareLinearSolve_();
+
+            for (int tracerIdx = 0; tracerIdx < this->numTracers(); ++ tracerIdx){
+                if (this->tracerPhaseIdx_[tracerIdx] != phaseIdx)
+                    continue;
 
-                if (dx.two_norm()<1e-2)
-                    break;
+                typename BaseType::TracerVector dx(this->tracerResidual_.size());
+                // Newton step (currently the system is linear, converge in one iteration)
+                for (int iter = 0; iter < 5; ++ iter){
+                    assembleResidual_(tracerIdx);
+                    if (useReorderedSolver_)
+                        this->reorderedSolve_(dx, this->tracerResidual_);
+                    else
+                        this->linearSolve_(dx, this->tracerResidual_);
+                    this->tracerConcentration_[tracerIdx] -= dx;
+
+                    if (dx.two_norm()<1e-2)
+                        break;
+                }
             }
         }
     }
@@ -153,8 +186,20 @@ public:
      *        to the hard disk.
      */
     template <class Restarter>
-    void serialize(Restarter&)
-    { /* not implemented */ }
+    void serialize(Restarter& res)
+    {
+        res.serializeSectionBegin("EclTracerModel");
+        auto& os = res.serializeStream();
+        BinaryCheckpoint::write(os, this->tracerNames_);
+        std::vector<Scalar> values;
+        for (const auto& concentration : this->tracerConcentration_) {
+            values.assign(concentration.size(), 0.0);
+            for (std::size_t globalDofIdx = 0; globalDofIdx < concentration.size(); ++globalDofIdx)
+                values[globalDofIdx] = concentration[globalDofIdx][0];
+            BinaryCheckpoint::write(os, values);
+        }
+        res.serializeSectionEnd();
+    }
 
     /*!
      * \brief This method restores the complete state of the tracer
@@ -163,8 +208,21 @@ public:
      * It is the inverse of the serialize() method.
      */
     template <class Restarter>
-    void deserialize(Restarter&)
-    { /* not implemented */ }
+    void deserialize(Restarter& res)
+    {
+        res.deserializeSectionBegin("EclTracerModel");
+        auto& is = res.deserializeStream();
+        BinaryCheckpoint::readExpected(is, this->tracerNames_, "tracers");
+        std::vector<Scalar> values;
+        for (auto& concentration : this->tracerConcentration_) {
+            BinaryCheckpoint::read(is, values);
+            if (values.size() != concentration.size())
+                throw std::runtime_error("The checkpoint does not match the grid of the tracers");
+            for (std::size_t globalDofIdx = 0; globalDofIdx < concentration.size(); ++globalDofIdx)
+                concentration[globalDofIdx][0] = values[globalDofIdx];
+        }
+        res.deserializeSectionEnd();
+    }
 
 protected:
     // evaluate storage term for all tracers in a single cell
@@ -195,47 +253,95 @@ protected:
                     * variable<LhsEval>(this->tracerConcentration_[tracerIdx][globalDofIdx][0], 0);
     }
 
-    // evaluate the tracerflux over one face
-    void computeFlux_(TracerEvaluation & tracerFlux,
-                      const ElementContext& elemCtx,
-                      unsigned scvfIdx,
-                      unsigned timeIdx,
-                      const int tracerIdx)
-
+    // the phase volume of a cell, which is the derivative of its tracer storage
+    template <class IntensiveQuantities>
+    Scalar phaseVolume_(const IntensiveQuantities& intQuants,
+                        const int phaseIdx) const
     {
-        const auto& stencil = elemCtx.stencil(timeIdx);
-        const auto& scvf = stencil.interiorFace(scvfIdx);
+        const auto& fs = intQuants.fluidState();
+        Scalar phaseVolume =
+            decay<Scalar>(fs.saturation(phaseIdx))
+            *decay<Scalar>(fs.invB(phaseIdx))
+            *decay<Scalar>(intQuants.porosity());
 
-        const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, timeIdx);
-        unsigned inIdx = extQuants.interiorIndex();
+        // avoid singular matrix if no water is present.
+        return max(phaseVolume, 1e-10);
+    }
 
-        const int tracerPhaseIdx = this->tracerPhaseIdx_[tracerIdx];
+    // Linearize the tracer equations of a phase: assemble the Jacobian and
+    // record the coefficients from which assembleResidual_() computes the
+    // residual of a tracer of the phase without another pass over the grid.
+    void linearizeMatrix_(const int phaseIdx)
+    {
+        const size_t numGridDof = simulator_.model().numGridDof();
+        this->phaseVolume0_.resize(numGridDof);
+        this->phaseVolume1_.resize(simulator_.model().enableStorageCache() ? 0 : numGridDof);
+        this->volumeOverDt_.resize(numGridDof);
 
-        unsigned upIdx = extQuants.upstreamIndex(tracerPhaseIdx);
-        int globalUpIdx = elemCtx.globalSpaceIndex(upIdx, timeIdx);
+        if (!recordCoefficientsFromFaceFluxes_(phaseIdx))
+            recordCoefficients_(phaseIdx);
 
-        const auto& intQuants = elemCtx.intensiveQuantities(upIdx, timeIdx);
-        const auto& fs = intQuants.fluidState();
+        // the reordered solver sets up its Jacobian from the coefficients
+        if (useReorderedSolver_)
+            return;
 
-        Scalar A = scvf.area();
-        Scalar v = decay<Scalar>(extQuants.volumeFlux(tracerPhaseIdx));
-        Scalar b = decay<Scalar>(fs.invB(this->tracerPhaseIdx_[tracerIdx]));
-        Scalar c = this->tracerConcentration_[tracerIdx][globalUpIdx];
+        (*this->tracerMatrix_) = 0.0;
+        for (size_t I = 0; I < numGridDof; ++I)
+            (*this->tracerMatrix_)[I][I][0][0] = this->phaseVolume0_[I] * this->volumeOverDt_[I];
+        for (const auto& face : this->faces_) {
+            // the flux only depends on the concentration of the cell if it is upstream
+            const Scalar derivative = face.upstream == face.cell ? face.flux : 0.0;
+            (*this->tracerMatrix_)[face.exterior][face.cell][0][0] = -derivative;
+            (*this->tracerMatrix_)[face.cell][face.exterior][0][0] = derivative;
+        }
+    }
 
-        if (inIdx == upIdx)
-            tracerFlux = A*v*b*variable<TracerEvaluation>(c, 0);
-        else
-            tracerFlux = A*v*b*c;
+    // Record the coefficients of a phase from the fluxes and the cached
+    // intensive quantities of the last linearization of the flow, which was
+    // done for the converged solution. Returns false if they are not available.
+    bool recordCoefficientsFromFaceFluxes_(const int phaseIdx)
+    {
+        const auto& faceFluxes = simulator_.problem().faceFluxes();
+        if (!faceFluxes.updated())
+            return false;
+
+        const auto& model = simulator_.model();
+        const size_t numGridDof = model.numGridDof();
+        const Scalar dt = simulator_.timeStepSize();
+        this->faces_.clear();
+        for (size_t I = 0; I < numGridDof; ++I) {
+            const auto* intQuants0 = model.cachedIntensiveQuantities(I, /*timeIdx=*/0);
+            if (!intQuants0)
+                return false;
+
+            this->volumeOverDt_[I] = model.dofTotalVolume(I)/dt;
+            this->phaseVolume0_[I] = phaseVolume_(*intQuants0, phaseIdx);
+            if (!this->phaseVolume1_.empty()) {
+                const auto* intQuants1 = model.cachedIntensiveQuantities(I, /*timeIdx=*/1);
+                if (!intQuants1)
+                    return false;
+                this->phaseVolume1_[I] = phaseVolume_(*intQuants1, phaseIdx);
+            }
 
+            for (unsigned faceIdx = 0; faceIdx < faceFluxes.numFaces(I); ++faceIdx) {
+                const auto& face = faceFluxes.face(I, faceIdx);
+                const unsigned upIdx = face.upstream[phaseIdx];
+                const auto* upQuants = model.cachedIntensiveQuantities(upIdx, /*timeIdx=*/0);
+                if (!upQuants)
+                    return false;
+                const Scalar b = decay<Scalar>(upQuants->fluidState().invB(phaseIdx));
+                this->faces_.push_back({static_cast<unsigned>(I), face.exterior, upIdx,
+                                        face.flux[phaseIdx]*b});
+            }
+        }
+        return true;
     }
 
-    void linearize_(int tracerIdx)
+    // Record the coefficients of a phase in a pass over the grid.
+    void recordCoefficients_(const int phaseIdx)
     {
-        (*this->tracerMatrix_) = 0.0;
-        this->tracerResidual_ = 0.0;
+        this->faces_.clear();
 
-        size_t numGridDof =  simulator_.model().numGridDof();
-        std::vector<double> volumes(numGridDof, 0.0);
         ElementContext elemCtx(simulator_);
         auto elemIt = simulator_.gridView().template begin</*codim=*/0>();
         auto elemEndIt = simulator_.gridView().template end</*codim=*/0>();
@@ -253,32 +359,45 @@ protected:
             Scalar dt = elemCtx.simulator().timeStepSize();
 
             size_t I = elemCtx.globalSpaceIndex(/*dofIdx=*/ 0, /*timIdx=*/0);
-            volumes[I] = scvVolume;
-            TracerEvaluation localStorage;
-            TracerEvaluation storageOfTimeIndex0;
-            Scalar storageOfTimeIndex1;
-            computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
-            if (elemCtx.enableStorageCache())
-                storageOfTimeIndex1 = this->storageOfTimeIndex1_[tracerIdx][I];
-            else
-                computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
+            this->volumeOverDt_[I] = scvVolume/dt;
+            this->phaseVolume0_[I] = phaseVolume_(elemCtx.intensiveQuantities(0, /*timeIdx=*/0), phaseIdx);
+            if (!this->phaseVolume1_.empty())
+                this->phaseVolume1_[I] = phaseVolume_(elemCtx.intensiveQuantities(0, /*timeIdx=*/1), phaseIdx);
 
-            localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
-            this->tracerResidual_[I][0] += localStorage.value(); //residual + flux
-            (*this->tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
             size_t numInteriorFaces = elemCtx.numInteriorFaces(/*timIdx=*/0);
             for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
-                TracerEvaluation flux;
                 const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
                 unsigned j = face.exteriorIndex();
                 unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
-                computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIdx);
-                this->tracerResidual_[I][0] += flux.value(); //residual + flux
-                (*this->tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
-                (*this->tracerMatrix_)[I][J][0][0] = flux.derivative(0);
+
+                const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, /*timeIdx=*/0);
+                unsigned upIdx = extQuants.upstreamIndex(phaseIdx);
+                const auto& fs = elemCtx.intensiveQuantities(upIdx, /*timeIdx=*/0).fluidState();
+                Scalar A = face.area();
+                Scalar v = decay<Scalar>(extQuants.volumeFlux(phaseIdx));
+                Scalar b = decay<Scalar>(fs.invB(phaseIdx));
+                this->faces_.push_back({static_cast<unsigned>(I), J,
+                                        static_cast<unsigned>(elemCtx.globalSpaceIndex(upIdx, /*timeIdx=*/0)),
+                                        A*v*b});
             }
+        }
+    }
 
+    // Assemble the residual of a tracer from the coefficients of the last
+    // linearizeMatrix_() of its phase.
+    void assembleResidual_(int tracerIdx)
+    {
+        const auto& concentration = this->tracerConcentration_[tracerIdx];
+        const size_t numGridDof = concentration.size();
+        for (size_t I = 0; I < numGridDof; ++I) {
+            const Scalar storageOfTimeIndex1 = this->phaseVolume1_.empty()
+                ? this->storageOfTimeIndex1_[tracerIdx][I]
+                : this->phaseVolume1_[I] * this->tracerConcentrationInitial_[tracerIdx][I];
+            this->tracerResidual_[I][0] =
+                (this->phaseVolume0_[I] * concentration[I] - storageOfTimeIndex1) * this->volumeOverDt_[I];
         }
+        for (const auto& face : this->faces_)
+            this->tracerResidual_[face.cell][0] += face.flux * concentration[face.upstream];
 
         // Wells
         const int episodeIdx = simulator_.episodeIndex();
@@ -310,6 +429,7 @@ protected:
     }
 
     Simulator& simulator_;
+    bool useReorderedSolver_ = false;
 };
 
 } // namespace Opm
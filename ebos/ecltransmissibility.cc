@@ -36,6 +36,8 @@
 #include <opm/parser/eclipse/EclipseState/Grid/TransMult.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#include <opm/models/parallel/threadedentityiterator.hh>
+
 #if HAVE_DUNE_FEM
 #include <dune/fem/gridpart/adaptiveleafgridpart.hh>
 #include <dune/fem/gridpart/common/gridpart2gridview.hh>
@@ -44,11 +46,18 @@
 
 #include <fmt/format.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <exception>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -114,7 +123,7 @@ template<class Grid, class GridView, class ElementMapper, class Scalar>
 Scalar EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 transmissibilityBoundary(unsigned elemIdx, unsigned boundaryFaceIdx) const
 {
-    return transBoundary_.at(std::make_pair(elemIdx, boundaryFaceIdx));
+    return transBoundary_.at(directionalIsId(elemIdx, boundaryFaceIdx)).trans;
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
@@ -128,7 +137,7 @@ template<class Grid, class GridView, class ElementMapper, class Scalar>
 Scalar EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 thermalHalfTransBoundary(unsigned insideElemIdx, unsigned boundaryFaceIdx) const
 {
-    return thermalHalfTransBoundary_.at(std::make_pair(insideElemIdx, boundaryFaceIdx));
+    return transBoundary_.at(directionalIsId(insideElemIdx, boundaryFaceIdx)).thermalHalfTrans;
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
@@ -144,7 +153,14 @@ diffusivity(unsigned elemIdx1, unsigned elemIdx2) const
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
 void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
-update(bool global)
+setTransmissibility(unsigned elemIdx1, unsigned elemIdx2, Scalar trans)
+{
+    trans_.at(isId(elemIdx1, elemIdx2)) = trans;
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+update(bool global, bool extractPermeability)
 {
     const auto& cartDims = cartMapper_.cartesianDimensions();
     auto& transMult = eclState_.getTransMult();
@@ -156,7 +172,8 @@ update(bool global)
     const bool updateDiffusivity = eclState_.getSimulationConfig().isDiffusive() && enableDiffusivity_;
     unsigned numElements = elemMapper.size();
 
-    extractPermeability_();
+    if (extractPermeability || permeability_.size() != numElements)
+        extractPermeability_();
 
     // calculate the axis specific centroids of all elements
     std::array<std::vector<DimVector>, dimWorld> axisCentroids;
@@ -202,8 +219,6 @@ update(bool global)
     if (enableEnergy_) {
         thermalHalfTrans_.clear();
         thermalHalfTrans_.reserve(numElements*6*1.05);
-
-        thermalHalfTransBoundary_.clear();
     }
 
     // if diffusion is enabled, let's do the same for the "diffusivity"
@@ -225,247 +240,299 @@ update(bool global)
         comm.broadcast(&useSmallestMultiplier, 1, 0);
     }
 
-    // compute the transmissibilities for all intersections
-    elemIt = gridView_.template begin</*codim=*/ 0>();
-    for (; elemIt != elemEndIt; ++elemIt) {
-        const auto& elem = *elemIt;
-        unsigned elemIdx = elemMapper.index(elem);
-
-        auto isIt = gridView_.ibegin(elem);
-        const auto& isEndIt = gridView_.iend(elem);
-        unsigned boundaryIsIdx = 0;
-        for (; isIt != isEndIt; ++ isIt) {
-            // store intersection, this might be costly
-            const auto& intersection = *isIt;
+    // compute the transmissibilities for all intersections. every element is
+    // handed to exactly one thread by a shared iterator, the threads collect
+    // their values before they are inserted into the hash maps.
+    struct FaceValues
+    {
+        std::vector<std::pair<std::uint64_t, Scalar>> trans;
+        std::vector<std::pair<std::uint64_t, Scalar>> thermalHalfTrans;
+        std::vector<std::pair<std::uint64_t, Scalar>> diffusivity;
+        std::vector<std::pair<std::uint64_t, BoundaryTrans>> transBoundary;
+    };
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    std::vector<FaceValues> threadValues(numThreads);
+    std::exception_ptr exceptionPtr = nullptr;
+    ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
 
-            // deal with grid boundaries
-            if (intersection.boundary()) {
-                // compute the transmissibilty for the boundary intersection
-                const auto& geometry = intersection.geometry();
-                const auto& faceCenterInside = geometry.center();
-
-                auto faceAreaNormal = intersection.centerUnitOuterNormal();
-                faceAreaNormal *= geometry.volume();
-
-                Scalar transBoundaryIs;
-                computeHalfTrans_(transBoundaryIs,
-                                  faceAreaNormal,
-                                  intersection.indexInInside(),
-                                  distanceVector_(faceCenterInside,
-                                                  intersection.indexInInside(),
-                                                  elemIdx,
-                                                  axisCentroids),
-                                  permeability_[elemIdx]);
-
-                // normally there would be two half-transmissibilities that would be
-                // averaged. on the grid boundary there only is the half
-                // transmissibility of the interior element.
-                transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
-
-                // for boundary intersections we also need to compute the thermal
-                // half transmissibilities
-                if (enableEnergy_) {
-                    Scalar transBoundaryEnergyIs;
-                    computeHalfDiffusivity_(transBoundaryEnergyIs,
-                                            faceAreaNormal,
-                                            distanceVector_(faceCenterInside,
-                                                            intersection.indexInInside(),
-                                                            elemIdx,
-                                                            axisCentroids),
-                                            1.0);
-                    thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
-                        transBoundaryEnergyIs;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(numThreads)
+#endif
+    {
+        int threadId = 0;
+#ifdef _OPENMP
+        threadId = omp_get_thread_num();
+#endif
+        auto& values = threadValues[threadId];
+        try {
+            auto threadElemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(threadElemIt); threadElemIt = threadedElemIt.increment()) {
+                const auto& elem = *threadElemIt;
+                unsigned elemIdx = elemMapper.index(elem);
+
+                auto isIt = gridView_.ibegin(elem);
+                const auto& isEndIt = gridView_.iend(elem);
+                unsigned boundaryIsIdx = 0;
+                for (; isIt != isEndIt; ++ isIt) {
+                    // store intersection, this might be costly
+                    const auto& intersection = *isIt;
+
+                    // deal with grid boundaries
+                    if (intersection.boundary()) {
+                        // compute the transmissibilty for the boundary intersection
+                        const auto& geometry = intersection.geometry();
+                        const auto& faceCenterInside = geometry.center();
+
+                        auto faceAreaNormal = intersection.centerUnitOuterNormal();
+                        faceAreaNormal *= geometry.volume();
+
+                        Scalar transBoundaryIs;
+                        computeHalfTrans_(transBoundaryIs,
+                                          faceAreaNormal,
+                                          intersection.indexInInside(),
+                                          distanceVector_(faceCenterInside,
+                                                          intersection.indexInInside(),
+                                                          elemIdx,
+                                                          axisCentroids),
+                                          permeability_[elemIdx]);
+
+                        // normally there would be two half-transmissibilities that would be
+                        // averaged. on the grid boundary there only is the half
+                        // transmissibility of the interior element.
+                        //
+                        // for boundary intersections we also need to compute the thermal
+                        // half transmissibilities. they are stored with the hydraulic one,
+                        // such that a boundary flux needs a single lookup for both.
+                        Scalar transBoundaryEnergyIs = 0.0;
+                        if (enableEnergy_) {
+                            computeHalfDiffusivity_(transBoundaryEnergyIs,
+                                                    faceAreaNormal,
+                                                    distanceVector_(faceCenterInside,
+                                                                    intersection.indexInInside(),
+                                                                    elemIdx,
+                                                                    axisCentroids),
+                                                    1.0);
+                        }
+                        values.transBoundary.emplace_back(directionalIsId(elemIdx, boundaryIsIdx),
+                                                          BoundaryTrans{transBoundaryIs, transBoundaryEnergyIs});
+
+                        ++ boundaryIsIdx;
+                        continue;
+                    }
+
+                    if (!intersection.neighbor()) {
+                        // elements can be on process boundaries, i.e. they are not on the
+                        // domain boundary yet they don't have neighbors.
+                        ++ boundaryIsIdx;
+                        continue;
+                    }
+
+                    const auto& outsideElem = intersection.outside();
+                    unsigned outsideElemIdx = elemMapper.index(outsideElem);
+
+                    unsigned insideCartElemIdx = cartMapper_.cartesianIndex(elemIdx);
+                    unsigned outsideCartElemIdx = cartMapper_.cartesianIndex(outsideElemIdx);
+
+                    // we only need to calculate a face's transmissibility
+                    // once...
+                    if (insideCartElemIdx > outsideCartElemIdx)
+                        continue;
+
+                    // local indices of the faces of the inside and
+                    // outside elements which contain the intersection
+                    int insideFaceIdx  = intersection.indexInInside();
+                    int outsideFaceIdx = intersection.indexInOutside();
+
+                    if (insideFaceIdx == -1) {
+                        // NNC. Set zero transmissibility, as it will be
+                        // *added to* by applyNncToGridTrans_() later.
+                        assert(outsideFaceIdx == -1);
+                        values.trans.emplace_back(isId(elemIdx, outsideElemIdx), 0.0);
+                        continue;
+                    }
+
+                    DimVector faceCenterInside;
+                    DimVector faceCenterOutside;
+                    DimVector faceAreaNormal;
+
+                    typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
+                    computeFaceProperties(intersection,
+                                          elemIdx,
+                                          insideFaceIdx,
+                                          outsideElemIdx,
+                                          outsideFaceIdx,
+                                          faceCenterInside,
+                                          faceCenterOutside,
+                                          faceAreaNormal,
+                                          isCpGrid);
+
+                    Scalar halfTrans1;
+                    Scalar halfTrans2;
+
+                    computeHalfTrans_(halfTrans1,
+                                      faceAreaNormal,
+                                      insideFaceIdx,
+                                      distanceVector_(faceCenterInside,
+                                                      intersection.indexInInside(),
+                                                      elemIdx,
+                                                      axisCentroids),
+                                      permeability_[elemIdx]);
+                    computeHalfTrans_(halfTrans2,
+                                      faceAreaNormal,
+                                      outsideFaceIdx,
+                                      distanceVector_(faceCenterOutside,
+                                                      intersection.indexInOutside(),
+                                                      outsideElemIdx,
+                                                      axisCentroids),
+                                      permeability_[outsideElemIdx]);
+
+                    applyNtg_(halfTrans1, insideFaceIdx, elemIdx, ntg);
+                    applyNtg_(halfTrans2, outsideFaceIdx, outsideElemIdx, ntg);
+
+                    // convert half transmissibilities to full face
+                    // transmissibilities using the harmonic mean
+                    Scalar trans;
+                    if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
+                        // avoid division by zero
+                        trans = 0.0;
+                    else
+                        trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
+
+                    // apply the full face transmissibility multipliers
+                    // for the inside ...
+
+                    if (useSmallestMultiplier)
+                    {
+                        // Currently PINCH(4) is never queries and hence  PINCH(4) == TOPBOT is assumed
+                        // and in this branch PINCH(5) == ALL holds
+                        applyAllZMultipliers_(trans, insideFaceIdx, outsideFaceIdx, insideCartElemIdx,
+                                              outsideCartElemIdx, transMult, cartDims,
+                                              /* pinchTop= */ false);
+                    }
+                    else
+                    {
+                        applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
+                        // ... and outside elements
+                        applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
+                    }
+
+                    // apply the region multipliers (cf. the MULTREGT keyword)
+                    FaceDir::DirEnum faceDir;
+                    switch (insideFaceIdx) {
+                    case 0:
+                    case 1:
+                        faceDir = FaceDir::XPlus;
+                        break;
+
+                    case 2:
+                    case 3:
+                        faceDir = FaceDir::YPlus;
+                        break;
+
+                    case 4:
+                    case 5:
+                        faceDir = FaceDir::ZPlus;
+                        break;
+
+                    default:
+                        throw std::logic_error("Could not determine a face direction");
+                    }
+
+                    trans *= transMult.getRegionMultiplier(insideCartElemIdx,
+                                                           outsideCartElemIdx,
+                                                           faceDir);
+
+                    values.trans.emplace_back(isId(elemIdx, outsideElemIdx), trans);
+
+                    // update the "thermal half transmissibility" for the intersection
+                    if (enableEnergy_) {
+
+                        Scalar halfDiffusivity1;
+                        Scalar halfDiffusivity2;
+
+                        computeHalfDiffusivity_(halfDiffusivity1,
+                                                faceAreaNormal,
+                                                distanceVector_(faceCenterInside,
+                                                                intersection.indexInInside(),
+                                                                elemIdx,
+                                                                axisCentroids),
+                                                1.0);
+                        computeHalfDiffusivity_(halfDiffusivity2,
+                                                faceAreaNormal,
+                                                distanceVector_(faceCenterOutside,
+                                                                intersection.indexInOutside(),
+                                                                outsideElemIdx,
+                                                                axisCentroids),
+                                                1.0);
+                        //TODO Add support for multipliers
+                        values.thermalHalfTrans.emplace_back(directionalIsId(elemIdx, outsideElemIdx), halfDiffusivity1);
+                        values.thermalHalfTrans.emplace_back(directionalIsId(outsideElemIdx, elemIdx), halfDiffusivity2);
+                   }
+
+                    // update the "diffusive half transmissibility" for the intersection
+                    if (updateDiffusivity) {
+
+                        Scalar halfDiffusivity1;
+                        Scalar halfDiffusivity2;
+
+                        computeHalfDiffusivity_(halfDiffusivity1,
+                                                faceAreaNormal,
+                                                distanceVector_(faceCenterInside,
+                                                                intersection.indexInInside(),
+                                                                elemIdx,
+                                                                axisCentroids),
+                                                porosity_[elemIdx]);
+                        computeHalfDiffusivity_(halfDiffusivity2,
+                                                faceAreaNormal,
+                                                distanceVector_(faceCenterOutside,
+                                                                intersection.indexInOutside(),
+                                                                outsideElemIdx,
+                                                                axisCentroids),
+                                                porosity_[outsideElemIdx]);
+
+                        applyNtg_(halfDiffusivity1, insideFaceIdx, elemIdx, ntg);
+                        applyNtg_(halfDiffusivity2, outsideFaceIdx, outsideElemIdx, ntg);
+
+                        //TODO Add support for multipliers
+                        Scalar diffusivity;
+                        if (std::abs(halfDiffusivity1) < 1e-30 || std::abs(halfDiffusivity2) < 1e-30)
+                            // avoid division by zero
+                            diffusivity = 0.0;
+                        else
+                            diffusivity = 1.0 / (1.0/halfDiffusivity1 + 1.0/halfDiffusivity2);
+
+
+                        values.diffusivity.emplace_back(isId(elemIdx, outsideElemIdx), diffusivity);
+                   }
                 }
-
-                ++ boundaryIsIdx;
-                continue;
-            }
-
-            if (!intersection.neighbor()) {
-                // elements can be on process boundaries, i.e. they are not on the
-                // domain boundary yet they don't have neighbors.
-                ++ boundaryIsIdx;
-                continue;
-            }
-
-            const auto& outsideElem = intersection.outside();
-            unsigned outsideElemIdx = elemMapper.index(outsideElem);
-
-            unsigned insideCartElemIdx = cartMapper_.cartesianIndex(elemIdx);
-            unsigned outsideCartElemIdx = cartMapper_.cartesianIndex(outsideElemIdx);
-
-            // we only need to calculate a face's transmissibility
-            // once...
-            if (insideCartElemIdx > outsideCartElemIdx)
-                continue;
-
-            // local indices of the faces of the inside and
-            // outside elements which contain the intersection
-            int insideFaceIdx  = intersection.indexInInside();
-            int outsideFaceIdx = intersection.indexInOutside();
-
-            if (insideFaceIdx == -1) {
-                // NNC. Set zero transmissibility, as it will be
-                // *added to* by applyNncToGridTrans_() later.
-                assert(outsideFaceIdx == -1);
-                trans_[isId(elemIdx, outsideElemIdx)] = 0.0;
-                continue;
             }
-
-            DimVector faceCenterInside;
-            DimVector faceCenterOutside;
-            DimVector faceAreaNormal;
-
-            typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
-            computeFaceProperties(intersection,
-                                  elemIdx,
-                                  insideFaceIdx,
-                                  outsideElemIdx,
-                                  outsideFaceIdx,
-                                  faceCenterInside,
-                                  faceCenterOutside,
-                                  faceAreaNormal,
-                                  isCpGrid);
-
-            Scalar halfTrans1;
-            Scalar halfTrans2;
-
-            computeHalfTrans_(halfTrans1,
-                              faceAreaNormal,
-                              insideFaceIdx,
-                              distanceVector_(faceCenterInside,
-                                              intersection.indexInInside(),
-                                              elemIdx,
-                                              axisCentroids),
-                              permeability_[elemIdx]);
-            computeHalfTrans_(halfTrans2,
-                              faceAreaNormal,
-                              outsideFaceIdx,
-                              distanceVector_(faceCenterOutside,
-                                              intersection.indexInOutside(),
-                                              outsideElemIdx,
-                                              axisCentroids),
-                              permeability_[outsideElemIdx]);
-
-            applyNtg_(halfTrans1, insideFaceIdx, elemIdx, ntg);
-            applyNtg_(halfTrans2, outsideFaceIdx, outsideElemIdx, ntg);
-
-            // convert half transmissibilities to full face
-            // transmissibilities using the harmonic mean
-            Scalar trans;
-            if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
-                // avoid division by zero
-                trans = 0.0;
-            else
-                trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
-
-            // apply the full face transmissibility multipliers
-            // for the inside ...
-
-            if (useSmallestMultiplier)
-            {
-                // Currently PINCH(4) is never queries and hence  PINCH(4) == TOPBOT is assumed
-                // and in this branch PINCH(5) == ALL holds
-                applyAllZMultipliers_(trans, insideFaceIdx, outsideFaceIdx, insideCartElemIdx,
-                                      outsideCartElemIdx, transMult, cartDims,
-                                      /* pinchTop= */ false);
-            }
-            else
-            {
-                applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
-                // ... and outside elements
-                applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
-            }
-
-            // apply the region multipliers (cf. the MULTREGT keyword)
-            FaceDir::DirEnum faceDir;
-            switch (insideFaceIdx) {
-            case 0:
-            case 1:
-                faceDir = FaceDir::XPlus;
-                break;
-
-            case 2:
-            case 3:
-                faceDir = FaceDir::YPlus;
-                break;
-
-            case 4:
-            case 5:
-                faceDir = FaceDir::ZPlus;
-                break;
-
-            default:
-                throw std::logic_error("Could not determine a face direction");
-            }
-
-            trans *= transMult.getRegionMultiplier(insideCartElemIdx,
-                                                   outsideCartElemIdx,
-                                                   faceDir);
-
-            trans_[isId(elemIdx, outsideElemIdx)] = trans;
-
-            // update the "thermal half transmissibility" for the intersection
-            if (enableEnergy_) {
-
-                Scalar halfDiffusivity1;
-                Scalar halfDiffusivity2;
-
-                computeHalfDiffusivity_(halfDiffusivity1,
-                                        faceAreaNormal,
-                                        distanceVector_(faceCenterInside,
-                                                        intersection.indexInInside(),
-                                                        elemIdx,
-                                                        axisCentroids),
-                                        1.0);
-                computeHalfDiffusivity_(halfDiffusivity2,
-                                        faceAreaNormal,
-                                        distanceVector_(faceCenterOutside,
-                                                        intersection.indexInOutside(),
-                                                        outsideElemIdx,
-                                                        axisCentroids),
-                                        1.0);
-                //TODO Add support for multipliers
-                thermalHalfTrans_[directionalIsId(elemIdx, outsideElemIdx)] = halfDiffusivity1;
-                thermalHalfTrans_[directionalIsId(outsideElemIdx, elemIdx)] = halfDiffusivity2;
-           }
-
-            // update the "diffusive half transmissibility" for the intersection
-            if (updateDiffusivity) {
-
-                Scalar halfDiffusivity1;
-                Scalar halfDiffusivity2;
-
-                computeHalfDiffusivity_(halfDiffusivity1,
-                                        faceAreaNormal,
-                                        distanceVector_(faceCenterInside,
-                                                        intersection.indexInInside(),
-                                                        elemIdx,
-                                                        axisCentroids),
-                                        porosity_[elemIdx]);
-                computeHalfDiffusivity_(halfDiffusivity2,
-                                        faceAreaNormal,
-                                        distanceVector_(faceCenterOutside,
-                                                        intersection.indexInOutside(),
-                                                        outsideElemIdx,
-                                                        axisCentroids),
-                                        porosity_[outsideElemIdx]);
-
-                applyNtg_(halfDiffusivity1, insideFaceIdx, elemIdx, ntg);
-                applyNtg_(halfDiffusivity2, outsideFaceIdx, outsideElemIdx, ntg);
-
-                //TODO Add support for multipliers
-                Scalar diffusivity;
-                if (std::abs(halfDiffusivity1) < 1e-30 || std::abs(halfDiffusivity2) < 1e-30)
-                    // avoid division by zero
-                    diffusivity = 0.0;
-                else
-                    diffusivity = 1.0 / (1.0/halfDiffusivity1 + 1.0/halfDiffusivity2);
-
-
-                diffusivity_[isId(elemIdx, outsideElemIdx)] = diffusivity;
-           }
         }
+        catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            exceptionPtr = std::current_exception();
+        }
+    }
+
+    if (exceptionPtr)
+        std::rethrow_exception(exceptionPtr);
+
+    // A face may be visited more than once if two elements share several
+    // intersections. The last value wins as in a serial loop; all visits of
+    // a face are done for the same element and thus by the same thread.
+    for (const auto& values : threadValues) {
+        for (const auto& [id, value] : values.trans)
+            trans_.insert_or_assign(id, value);
+        for (const auto& [id, value] : values.thermalHalfTrans)
+            thermalHalfTrans_.insert_or_assign(id, value);
+        for (const auto& [id, value] : values.diffusivity)
+            diffusivity_.insert_or_assign(id, value);
+        for (const auto& [id, value] : values.transBoundary)
+            transBoundary_.insert_or_assign(id, value);
     }
 
     // potentially overwrite and/or modify  transmissibilities based on input from deck
@@ -68,11 +68,27 @@ public:
     const DimMatrix& permeability(unsigned elemIdx) const
     { return permeability_[elemIdx]; }
 
+    /*!
+     * \brief Set the permeability for an element.
+     *
+     * The value is used by the next update() which does not extract the
+     * permeabilities from the deck.
+     */
+    void setPermeability(unsigned elemIdx, const DimMatrix& perm)
+    { permeability_[elemIdx] = perm; }
+
     /*!
      * \brief Return the transmissibility for the intersection between two elements.
      */
     Scalar transmissibility(unsigned elemIdx1, unsigned elemIdx2) const;
 
+    /*!
+     * \brief Set the transmissibility for the intersection between two elements.
+     *
+     * The intersection must exist. The value is kept until the next update().
+     */
+    void setTransmissibility(unsigned elemIdx1, unsigned elemIdx2, Scalar trans);
+
     /*!
      * \brief Return the transmissibility for a given boundary segment.
      */
@@ -122,9 +138,11 @@ public:
      * \brief Compute all transmissibilities
      *
      * \param global If true, update is called on all processes
+     * \param extractPermeability If false, the permeabilities which have been set
+     *        by setPermeability() are used instead of those of the deck.
      * Also, this updates the "thermal half transmissibilities" if energy is enabled.
      */
-    void update(bool global);
+    void update(bool global, bool extractPermeability = true);
 
 protected:
     void updateFromEclState_(bool global);
@@ -238,8 +256,13 @@ protected:
     const Grid& grid_;
     const std::vector<double>& centroids_;
     Scalar transmissibilityThreshold_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> transBoundary_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
+    // the hydraulic and thermal half transmissibilities of a boundary segment
+    struct BoundaryTrans
+    {
+        Scalar trans;
+        Scalar thermalHalfTrans;
+    };
+    std::unordered_map<std::uint64_t, BoundaryTrans> transBoundary_;
     bool enableEnergy_;
     bool enableDiffusivity_;
     std::unordered_map<std::uint64_t, Scalar> thermalHalfTrans_;
@@ -54,6 +54,7 @@
 #include <map>
 #include <unordered_set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -140,8 +141,17 @@ public:
         WellConnectionsMap wellCompMap;
         computeWellConnectionsMap_(episodeIdx, wellCompMap);
 
-        if (wasRestarted || wellTopologyChanged_(eclState, deckSchedule, episodeIdx))
-            updateWellTopology_(episodeIdx, wellCompMap, gridDofIsPenetrated_);
+        if (wasRestarted || wellTopologyChanged_(eclState, deckSchedule, episodeIdx)) {
+            // connection events which only open, shut or modify existing
+            // connections leave the DOFs of the wells unchanged. In this case
+            // the auxiliary modules and thus the sparsity pattern of the
+            // Jacobian are kept and only the well parameters are updated below.
+            auto topology = computeWellTopology_(wellCompMap);
+            if (wasRestarted || gridDofIsPenetrated_.empty() || topology != wellTopology_) {
+                updateWellTopology_(episodeIdx, wellCompMap, gridDofIsPenetrated_);
+                wellTopology_ = std::move(topology);
+            }
+        }
 
         // set those parameters of the wells which do not change the topology of the
         // linearized system of equations
@@ -764,6 +774,14 @@ protected:
         }
     }
 
+    std::map<int, const Well*> computeWellTopology_(const WellConnectionsMap& wellConnections) const
+    {
+        std::map<int, const Well*> topology;
+        for (const auto& conn : wellConnections)
+            topology.emplace_hint(topology.end(), conn.first, conn.second.second.get());
+        return topology;
+    }
+
     void computeWellConnectionsMap_(unsigned reportStepIdx OPM_UNUSED, WellConnectionsMap& cartesianIdxToConnectionMap)
     {
         const auto& deckSchedule = simulator_.vanguard().schedule();
@@ -873,6 +891,8 @@ protected:
 
     std::vector<std::shared_ptr<Well> > wells_;
     std::vector<bool> gridDofIsPenetrated_;
+    // the well of every connected Cartesian cell, as of the last topology update
+    std::map<int, const Well*> wellTopology_;
     std::map<std::string, int> wellNameToIndex_;
     std::map<std::string, std::array<Scalar, numPhases> > wellTotalInjectedVolume_;
     std::map<std::string, std::array<Scalar, numPhases> > wellTotalProducedVolume_;
@@ -33,11 +33,13 @@
 
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
+#include <opm/simulators/utils/CostAccounting.hpp>
 #include <opm/simulators/utils/ParallelRestart.hpp>
 
 #include <ebos/eclgenericwriter.hh>
 
 #include <string>
+#include <vector>
 
 namespace Opm::Properties {
 
@@ -50,9 +52,17 @@ struct EnableAsyncEclOutput {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct EclOutputMaxPendingWrites {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct EclOutputDoublePrecision {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct EclOutputSummaryBatchSize {
+    using type = UndefinedProperty;
+};
 
 } // namespace Opm::Properties
 
@@ -107,6 +117,10 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclOutput,
                              "Write the ECL-formated results in a non-blocking way (i.e., using a separate thread).");
+        EWOMS_REGISTER_PARAM(TypeTag, int, EclOutputMaxPendingWrites,
+                             "The maximum number of ECL output requests which are queued for writing before the simulation waits for them to complete.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, EclOutputSummaryBatchSize,
+                             "The maximum number of summary ministeps which are kept in memory before they are written. The ministeps are always written at the end of a report step, 1 writes every ministep immediately.");
     }
 
     // The Simulator object should preferably have been const - the
@@ -123,7 +137,9 @@ public:
                    simulator.vanguard().cartesianIndexMapper(),
                    simulator.vanguard().grid().comm().rank() == 0 ? &simulator.vanguard().equilCartesianIndexMapper() : nullptr,
                    simulator.vanguard().grid().comm().size() > 1 ? simulator.vanguard().globalTransmissibility() : problem.eclTransmissibilities(),
-                   EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncEclOutput))
+                   EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncEclOutput),
+                   EWOMS_GET_PARAM(TypeTag, int, EclOutputMaxPendingWrites),
+                   EWOMS_GET_PARAM(TypeTag, int, EclOutputSummaryBatchSize))
         , simulator_(simulator)
     {
         this->eclOutputModule_ = std::make_unique<EclOutputBlackOilModule<TypeTag>>(simulator, this->wbp_index_list_, this->collectToIORank_);
@@ -177,7 +193,7 @@ public:
 
         const auto localAquiferData = simulator_.problem().aquiferModel().aquiferData();
 
-        this->prepareLocalCellData(isSubStep, reportStepNum);
+        this->prepareLocalCellData(isSubStep, reportStepNum, /*summaryOnly=*/true);
 
         if (this->collectToIORank_.isParallel())
             this->collectToIORank_.collect({},
@@ -224,7 +240,7 @@ public:
     {
         const int reportStepNum = simulator_.episodeIndex() + 1;
 
-        this->prepareLocalCellData(isSubStep, reportStepNum);
+        this->prepareLocalCellData(isSubStep, reportStepNum, /*summaryOnly=*/false);
         this->eclOutputModule_->outputErrorLog(simulator_.gridView().comm());
 
         // output using eclWriter if enabled
@@ -238,6 +254,12 @@ public:
         if (! isSubStep) {
             this->eclOutputModule_->assignToSolution(localCellData);
 
+            const auto& costs = CostAccounting::instance();
+            if (costs.enabled()) {
+                localCellData.insert("COSTPERCELL", UnitSystem::measure::identity,
+                                     costs.cellCosts(), data::TargetType::RESTART_AUXILIARY);
+            }
+
             // add cell data to perforations for Rft output
             this->eclOutputModule_->addRftDataToWells(localWellData, reportStepNum);
         }
@@ -301,16 +323,20 @@ public:
 
         const auto& gridView = simulator_.vanguard().gridView();
         unsigned numElements = gridView.size(/*codim=*/0);
-        eclOutputModule_->allocBuffers(numElements, restartStepIdx, /*isSubStep=*/false, /*log=*/false, /*isRestart*/ true);
+        eclOutputModule_->allocBuffers(numElements, restartStepIdx, /*isSubStep=*/false, /*log=*/false, /*isRestart*/ true, /*summaryOnly=*/false);
 
         {
             SummaryState& summaryState = simulator_.vanguard().summaryState();
             Action::State& actionState = simulator_.vanguard().actionState();
+            std::vector<int> globalCells(numElements);
+            for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+                globalCells[elemIdx] = this->collectToIORank_.localIdxToGlobalIdx(elemIdx);
+
+            // the restart solution only holds the cells of this process
             auto restartValues = loadParallelRestart(this->eclIO_.get(), actionState, summaryState, solutionKeys, extraKeys,
-                                                     gridView.grid().comm());
+                                                     globalCells, gridView.grid().comm());
             for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
-                unsigned globalIdx = this->collectToIORank_.localIdxToGlobalIdx(elemIdx);
-                eclOutputModule_->setRestart(restartValues.solution, elemIdx, globalIdx);
+                eclOutputModule_->setRestart(restartValues.solution, elemIdx, elemIdx);
             }
 
             if (inputThpres.active()) {
@@ -358,14 +384,16 @@ private:
     { return simulator_.vanguard().schedule(); }
 
     void prepareLocalCellData(const bool isSubStep,
-                              const int  reportStepNum)
+                              const int  reportStepNum,
+                              const bool summaryOnly)
     {
         const auto& gridView = simulator_.vanguard().gridView();
         const int numElements = gridView.size(/*codim=*/0);
         const bool log = this->collectToIORank_.isIORank();
 
         eclOutputModule_->allocBuffers(numElements, reportStepNum,
-                                      isSubStep, log, /*isRestart*/ false);
+                                      isSubStep, log, /*isRestart*/ false,
+                                      summaryOnly);
 
         ElementContext elemCtx(simulator_);
         ElementIterator elemIt = gridView.template begin</*codim=*/0>();
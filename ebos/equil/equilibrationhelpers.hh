@@ -37,8 +37,12 @@
 #include <opm/parser/eclipse/EclipseState/InitConfig/Equil.hpp>
 #include <opm/common/utility/numeric/RootFinders.hpp>
 
+#include <array>
 #include <cmath>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 /*
@@ -69,6 +73,10 @@
   const int cell,
   const double targetPc,
   const bool increasing = false)
+
+  template <class FluidSystem, class MaterialLaw, class MaterialLawManager>
+  class InverseCapPressTables;
+
   template <class FluidSystem, class MaterialLaw, class MaterialLawManager>
   double satFromSumOfPcs(const MaterialLawManager& materialLawManager,
   const int phase1,
@@ -841,6 +849,147 @@ double satFromPc(const MaterialLawManager& materialLawManager,
 }
 
 
+/// Tabulated inverse of the capillary pressure functions of the
+/// saturation regions.
+///
+/// The capillary pressure function of each saturation region and phase is
+/// sampled once, using a representative cell of the region. Inverting the
+/// capillary pressure of a cell whose scaled end points are identical to
+/// those of the representative cell then is a binary search for the
+/// bracketing samples and a root-find on that short interval, which
+/// converges in very few iterations. The result is the same as the one of
+/// satFromPc() up to the root-finding tolerance. Cells with other end
+/// points fall back to satFromPc().
+template <class FluidSystem, class MaterialLaw, class MaterialLawManager>
+class InverseCapPressTables
+{
+public:
+    InverseCapPressTables(const MaterialLawManager& materialLawManager,
+                          const int numCells,
+                          const int numSamples = 200)
+        : materialLawManager_(materialLawManager)
+    {
+        if (materialLawManager.enableHysteresis())
+            return;
+
+        for (int cell = 0; cell < numCells; ++cell) {
+            const auto satRegion = static_cast<std::size_t>(materialLawManager.satnumRegionIdx(cell));
+            if (satRegion >= tables_.size())
+                tables_.resize(satRegion + 1);
+
+            for (const int phase : {FluidSystem::waterPhaseIdx, FluidSystem::gasPhaseIdx}) {
+                auto& table = tables_[satRegion][phase];
+                if (table.cell < 0 && FluidSystem::phaseIsActive(phase))
+                    this->sample_(table, phase, cell, numSamples);
+            }
+        }
+    }
+
+    /// Compute saturation of some phase corresponding to a given capillary
+    /// pressure, like satFromPc().
+    double satFromPc(const int phase,
+                     const int cell,
+                     const double targetPc,
+                     const bool increasing = false) const
+    {
+        const Table* table = this->table_(phase, cell);
+        if (table == nullptr)
+            return ::Opm::EQUIL::satFromPc<FluidSystem, MaterialLaw>
+                (materialLawManager_, phase, cell, targetPc, increasing);
+
+        // h is pc(s) - targetPc oriented such that it decreases from the
+        // first sample to the last one, i.e., in the direction in which
+        // satFromPc() searches.
+        const auto& sat = table->sat;
+        const auto& pc = table->pc;
+        const double sign = increasing ? -1.0 : 1.0;
+        const auto h = [&pc, sign, targetPc](const std::size_t k)
+        { return sign*(pc[k] - targetPc); };
+
+        const std::size_t last = sat.size() - 1;
+        const std::size_t first = 0;
+        if ((increasing ? -h(last) : h(first)) <= 0.0)
+            return increasing ? sat[last] : sat[first];
+        else if ((increasing ? -h(first) : h(last)) >= 0.0)
+            return increasing ? sat[first] : sat[last];
+
+        // the first sample for which h is not positive
+        std::size_t lo = first;
+        std::size_t hi = last;
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo)/2;
+            if (h(mid) > 0.0)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        if (h(hi) == 0.0)
+            return sat[hi];
+
+        const PcEq<FluidSystem, MaterialLaw, MaterialLawManager> f(materialLawManager_, phase, cell, targetPc);
+        const double tol = 1e-10;
+        const int maxIter = -2*static_cast<int>(std::log2(tol)) + 10;
+        int usedIterations = -1;
+        return RegulaFalsiBisection<ThrowOnError>::solve(f, sat[lo], sat[hi], maxIter, tol, usedIterations);
+    }
+
+private:
+    using EpsInfo = std::decay_t<decltype(std::declval<MaterialLawManager>().oilWaterScaledEpsInfoDrainage(0))>;
+
+    struct Table
+    {
+        int cell{-1};
+        EpsInfo epsInfo;
+        // saturations in increasing order and the capillary pressure
+        // (Po - Pw or Pg - Po) at them. empty if not monotonous.
+        std::vector<double> sat;
+        std::vector<double> pc;
+    };
+
+    void sample_(Table& table, const int phase, const int cell, const int numSamples)
+    {
+        table.cell = cell;
+        table.epsInfo = materialLawManager_.oilWaterScaledEpsInfoDrainage(cell);
+
+        const double smin = minSaturations<FluidSystem>(materialLawManager_, phase, cell);
+        const double smax = maxSaturations<FluidSystem>(materialLawManager_, phase, cell);
+        const PcEq<FluidSystem, MaterialLaw, MaterialLawManager> pc(materialLawManager_, phase, cell, 0.0);
+        table.sat.resize(numSamples);
+        table.pc.resize(numSamples);
+        for (int k = 0; k < numSamples; ++k) {
+            table.sat[k] = (k == numSamples - 1) ? smax : smin + k*(smax - smin)/(numSamples - 1);
+            table.pc[k] = pc(table.sat[k]);
+        }
+
+        bool nonIncreasing = true;
+        bool nonDecreasing = true;
+        for (int k = 1; k < numSamples; ++k) {
+            nonIncreasing = nonIncreasing && table.pc[k] <= table.pc[k - 1];
+            nonDecreasing = nonDecreasing && table.pc[k] >= table.pc[k - 1];
+        }
+        if (!(nonIncreasing || nonDecreasing)) {
+            table.sat.clear();
+            table.pc.clear();
+        }
+    }
+
+    const Table* table_(const int phase, const int cell) const
+    {
+        if (tables_.empty())
+            return nullptr;
+
+        const auto& table = tables_[materialLawManager_.satnumRegionIdx(cell)][phase];
+        if (table.sat.size() < 2 || !(materialLawManager_.oilWaterScaledEpsInfoDrainage(cell) == table.epsInfo))
+            return nullptr;
+
+        return &table;
+    }
+
+    const MaterialLawManager& materialLawManager_;
+    std::vector<std::array<Table, FluidSystem::numPhases>> tables_;
+};
+
+
 /// Functor for inverting a sum of capillary pressure functions.
 /// Function represented is
 ///   f(s) = pc1(s) + pc2(1 - s) - targetPc
@@ -58,6 +58,8 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <exception>
+#include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <type_traits>
@@ -827,6 +829,11 @@ public:
     /// Convenience type alias
     using PTable = PressureTable<FluidSystem, Region>;
 
+    /// Tabulated inverse capillary pressure functions.
+    using InverseTables = InverseCapPressTables<
+        FluidSystem, typename MaterialLawManager::MaterialLaw, MaterialLawManager
+    >;
+
     /// Constructor
     ///
     /// \param[in,out] matLawMgr Read/write reference to a material law
@@ -848,11 +855,20 @@ public:
         , swatInit_ (rhs.swatInit_)
         , sat_      (rhs.sat_)
         , press_    (rhs.press_)
+        , evalPt_   (rhs.evalPt_)
+        , inverseTables_(rhs.inverseTables_)
     {
         // Note: We don't need to do anything to the 'fluidState_' here.
-        this->setEvaluationPoint(*rhs.evalPt_.position,
-                                 *rhs.evalPt_.region,
-                                 *rhs.evalPt_.ptable);
+    }
+
+    /// Use tabulated inverse capillary pressure functions instead of
+    /// inverting the capillary pressure curves of each cell.
+    ///
+    /// \param[in] tables Inverse capillary pressure functions.  Must
+    ///    outlive this object.
+    void setInverseCapPressTables(const InverseTables& tables)
+    {
+        this->inverseTables_ = &tables;
     }
 
     /// Disabled assignment operator.
@@ -957,6 +973,9 @@ private:
     /// Evaluated capillary pressures from current set of material laws.
     std::array<double, FluidSystem::numPhases> matLawCapPress_;
 
+    /// Tabulated inverse capillary pressure functions, if any.
+    const InverseTables* inverseTables_{nullptr};
+
     /// Capture the input evaluation point information in internal state.
     ///
     /// \param[in] x Specific geometric point (depth within a specific cell).
@@ -1405,6 +1424,11 @@ invertCapPress(const double   pc,
                const PhaseIdx phasePos,
                const bool     isincr) const
 {
+    if (this->inverseTables_ != nullptr) {
+        return this->inverseTables_->satFromPc
+            (static_cast<int>(phasePos), this->evalPt_.position->cell, pc, isincr);
+    }
+
     return satFromPc<FluidSystem, MaterialLaw>
         (this->matLawMgr_, static_cast<int>(phasePos),
          this->evalPt_.position->cell, pc, isincr);
@@ -1893,6 +1917,13 @@ private:
         auto psat   = PhaseSat { materialLawManager, this->swatInit_ };
         auto vspan  = std::array<double, 2>{};
 
+        // Invert the capillary pressure curves by table lookup rather than
+        // by a root-find on the full saturation range of every cell.
+        const auto inverseTables = typename PhaseSat::InverseTables {
+            materialLawManager, static_cast<int>(this->cellCenterDepth_.size())
+        };
+        psat.setInverseCapPressTables(inverseTables);
+
         std::vector<int> regionIsEmpty(rec.size(), 0);
         for (size_t r = 0; r < rec.size(); ++r) {
             const auto& cells = reg.cells(r);
@@ -1948,8 +1979,9 @@ private:
         }
     }
 
-    template <class CellRange, class EquilibrationMethod>
+    template <class CellRange, class PhaseSat, class EquilibrationMethod>
     void cellLoop(const CellRange&      cells,
+                  const PhaseSat&       psat,
                   EquilibrationMethod&& eqmethod)
     {
         const auto oilPos = FluidSystem::oilPhaseIdx;
@@ -1960,33 +1992,65 @@ private:
         const auto gasActive = FluidSystem::phaseIsActive(gasPos);
         const auto watActive = FluidSystem::phaseIsActive(watPos);
 
-        auto pressures   = Details::PhaseQuantityValue{};
-        auto saturations = Details::PhaseQuantityValue{};
-        auto Rs          = 0.0;
-        auto Rv          = 0.0;
+        // The cells are equilibrated independently of each other, except
+        // that SWATINIT modifies the material laws of the cells, which is
+        // therefore done in sequence.
+        const int numCells = std::distance(cells.begin(), cells.end());
+        const int minCellsForThreading = 1000;
+        [[maybe_unused]] const bool threaded =
+            this->swatInit_.empty() && (numCells >= minCellsForThreading);
+
+        std::exception_ptr exception;
+#ifdef _OPENMP
+#pragma omp parallel if(threaded)
+#endif
+        {
+            auto threadPsat  = psat;
+            auto pressures   = Details::PhaseQuantityValue{};
+            auto saturations = Details::PhaseQuantityValue{};
+            auto Rs          = 0.0;
+            auto Rv          = 0.0;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                const auto cell = *std::next(cells.begin(), cellIdx);
+                try {
+                    eqmethod(cell, threadPsat, pressures, saturations, Rs, Rv);
+                }
+                catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    exception = std::current_exception();
+                    continue;
+                }
 
-        for (const auto& cell : cells) {
-            eqmethod(cell, pressures, saturations, Rs, Rv);
+                if (oilActive) {
+                    this->pp_ [oilPos][cell] = pressures.oil;
+                    this->sat_[oilPos][cell] = saturations.oil;
+                }
 
-            if (oilActive) {
-                this->pp_ [oilPos][cell] = pressures.oil;
-                this->sat_[oilPos][cell] = saturations.oil;
-            }
+                if (gasActive) {
+                    this->pp_ [gasPos][cell] = pressures.gas;
+                    this->sat_[gasPos][cell] = saturations.gas;
+                }
 
-            if (gasActive) {
-                this->pp_ [gasPos][cell] = pressures.gas;
-                this->sat_[gasPos][cell] = saturations.gas;
-            }
+                if (watActive) {
+                    this->pp_ [watPos][cell] = pressures.water;
+                    this->sat_[watPos][cell] = saturations.water;
+                }
 
-            if (watActive) {
-                this->pp_ [watPos][cell] = pressures.water;
-                this->sat_[watPos][cell] = saturations.water;
+                if (oilActive && gasActive) {
+                    this->rs_[cell] = Rs;
+                    this->rv_[cell] = Rv;
+                }
             }
+        }
 
-            if (oilActive && gasActive) {
-                this->rs_[cell] = Rs;
-                this->rv_[cell] = Rv;
-            }
+        if (exception) {
+            std::rethrow_exception(exception);
         }
     }
 
@@ -1999,8 +2063,9 @@ private:
         using CellPos = typename PhaseSat::Position;
         using CellID  = std::remove_cv_t<std::remove_reference_t<
             decltype(std::declval<CellPos>().cell)>>;
-        this->cellLoop(cells, [this, &eqreg,  &ptable, &psat]
+        this->cellLoop(cells, psat, [this, &eqreg, &ptable]
             (const CellID                 cell,
+             PhaseSat&                    threadPsat,
              Details::PhaseQuantityValue& pressures,
              Details::PhaseQuantityValue& saturations,
              double&                      Rs,
@@ -2010,8 +2075,8 @@ private:
                 cell, cellCenterDepth_[cell]
             };
 
-            saturations = psat.deriveSaturations(pos, eqreg, ptable);
-            pressures   = psat.correctedPhasePressures();
+            saturations = threadPsat.deriveSaturations(pos, eqreg, ptable);
+            pressures   = threadPsat.correctedPhasePressures();
 
             const auto temp = this->temperature_[cell];
 
@@ -2034,8 +2099,9 @@ private:
         using CellID  = std::remove_cv_t<std::remove_reference_t<
             decltype(std::declval<CellPos>().cell)>>;
 
-        this->cellLoop(cells, [this, acc, &eqreg, &ptable, &psat]
+        this->cellLoop(cells, psat, [this, acc, &eqreg, &ptable]
             (const CellID                 cell,
+             PhaseSat&                    threadPsat,
              Details::PhaseQuantityValue& pressures,
              Details::PhaseQuantityValue& saturations,
              double&                      Rs,
@@ -2048,8 +2114,8 @@ private:
             for (const auto& [depth, frac] : Details::horizontalSubdivision(cell, cellZSpan_[cell], acc)) {
                 const auto pos = CellPos { cell, depth };
 
-                saturations.axpy(psat.deriveSaturations(pos, eqreg, ptable), frac);
-                pressures  .axpy(psat.correctedPhasePressures(), frac);
+                saturations.axpy(threadPsat.deriveSaturations(pos, eqreg, ptable), frac);
+                pressures  .axpy(threadPsat.correctedPhasePressures(), frac);
 
                 totfrac += frac;
             }
@@ -87,7 +87,10 @@ static inline int startEbos(int argc, char **argv)
                  deckFilename,
                  EWOMS_GET_PARAM(TypeTag, std::string, OutputDir),
                  EWOMS_GET_PARAM(TypeTag, std::string, OutputMode),
-                 outputCout, "STDOUT_LOGGER");
+                 outputCout, "STDOUT_LOGGER",
+                 // ebos does not remove the log files of the other ranks
+                 // at the end of the run, keep writing them
+                 /*log_all_ranks=*/true);
 
     // Call the main function. Parameters are already registered
     // They should not be registered again
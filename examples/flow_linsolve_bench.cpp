@@ -0,0 +1,205 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark a FlexibleSolver configuration on a linear system that flow
+// has dumped to the reports directory with --linear-solver-verbosity=11
+// (or any other system in the MatrixMarket format). Wells are part of the
+// system if it was dumped with --matrix-add-well-contributions=true.
+// Since there is no simulator, CPR always uses quasi-IMPES weights.
+//
+// Usage: flow_linsolve_bench <solver.json> <matrix.mm> <rhs.mm> [repeats]
+
+#include <config.h>
+
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/simulators/linalg/MatrixMarketSpecializations.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixmarket.hh>
+#include <dune/istl/operators.hh>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+// The block size from the "% ISTL_STRUCT blocked N N" line that
+// Dune::storeMatrixMarket writes, 1 for a plain MatrixMarket file.
+int blockSize(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Could not read matrix file " + filename);
+    }
+    std::string line;
+    while (std::getline(file, line) && !line.empty() && line[0] == '%') {
+        std::istringstream words(line);
+        std::string percent, structure, blocked;
+        int rows = 1;
+        if ((words >> percent >> structure >> blocked >> rows)
+            && structure == "ISTL_STRUCT" && blocked == "blocked") {
+            return rows;
+        }
+    }
+    return 1;
+}
+
+template <int bz>
+void benchmark(const boost::property_tree::ptree& prm,
+               const std::string& matrixFilename,
+               const std::string& rhsFilename,
+               const int repeats)
+{
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    Matrix matrix;
+    {
+        std::ifstream file(matrixFilename);
+        Dune::readMatrixMarket(matrix, file);
+    }
+    Vector rhs;
+    {
+        std::ifstream file(rhsFilename);
+        if (!file) {
+            throw std::runtime_error("Could not read rhs file " + rhsFilename);
+        }
+        Dune::readMatrixMarket(rhs, file);
+    }
+    if (rhs.size() != matrix.N()) {
+        throw std::runtime_error("The sizes of the matrix and the rhs do not match");
+    }
+    std::cout << "Matrix: " << matrix.N() << " block rows of size " << bz << ", "
+              << matrix.nonzeroes() << " nonzero blocks\n";
+
+    // The throughput of the matrix vector product, as a reference for the
+    // memory bandwidth bound parts of the solver.
+    {
+        Vector x(rhs.size());
+        Vector y(rhs.size());
+        x = 1.0;
+        const int products = 20;
+        Dune::Timer timer;
+        for (int i = 0; i < products; ++i) {
+            matrix.mv(x, y);
+        }
+        const double seconds = timer.stop();
+        const double flops = 2.0 * matrix.nonzeroes() * bz * bz * products;
+        std::cout << "Matrix vector product: " << std::setprecision(3)
+                  << flops / seconds * 1e-9 << " GFLOP/s\n";
+    }
+
+    const std::string precondType = prm.get<std::string>("preconditioner.type", "");
+    std::function<Vector()> weightsCalculator;
+    if (precondType.rfind("cpr", 0) == 0) {
+        const bool transpose = precondType == "cprt";
+        const int pressureVarIndex = prm.get<int>("preconditioner.pressure_var_index", 1);
+        weightsCalculator = [&matrix, pressureVarIndex, transpose]() {
+            return Opm::Amg::getQuasiImpesWeights<Matrix, Vector>(matrix, pressureVarIndex, transpose);
+        };
+    }
+
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    Operator op(matrix);
+    std::cout << std::setw(6) << "Run" << std::setw(12) << "Setup [s]" << std::setw(12) << "Apply [s]"
+              << std::setw(8) << "Its" << std::setw(12) << "Reduction" << std::setw(11) << "Converged" << '\n';
+    double totalSetup = 0.0;
+    double totalApply = 0.0;
+    for (int run = 0; run < repeats; ++run) {
+        Dune::Timer setupTimer;
+        Dune::FlexibleSolver<Matrix, Vector> solver(op, prm, weightsCalculator);
+        const double setup = setupTimer.stop();
+
+        Vector x(rhs.size());
+        x = 0.0;
+        Vector b = rhs;
+        Dune::InverseOperatorResult result;
+        Dune::Timer applyTimer;
+        solver.apply(x, b, result);
+        const double apply = applyTimer.stop();
+
+        totalSetup += setup;
+        totalApply += apply;
+        std::cout << std::setw(6) << run << std::setprecision(4) << std::fixed
+                  << std::setw(12) << setup << std::setw(12) << apply
+                  << std::setw(8) << result.iterations << std::scientific << std::setprecision(3)
+                  << std::setw(12) << result.reduction << std::setw(11) << (result.converged ? "yes" : "no")
+                  << std::defaultfloat << '\n';
+    }
+    std::cout << "Average: setup " << totalSetup / repeats << " s, apply " << totalApply / repeats << " s\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <solver.json> <matrix.mm> <rhs.mm> [repeats]\n"
+                  << "The solver configuration is the property tree of the FlexibleSolver,\n"
+                  << "as accepted by flow with --linsolver=<file>.json.\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        boost::property_tree::ptree prm;
+        {
+            std::ifstream file(argv[1]);
+            if (!file) {
+                throw std::runtime_error(std::string("Could not read solver configuration ") + argv[1]);
+            }
+            boost::property_tree::read_json(file, prm);
+        }
+        const std::string matrixFilename = argv[2];
+        const std::string rhsFilename = argv[3];
+        const int repeats = argc > 4 ? std::max(std::stoi(argv[4]), 1) : 3;
+
+        switch (blockSize(matrixFilename)) {
+        case 1: benchmark<1>(prm, matrixFilename, rhsFilename, repeats); break;
+        case 2: benchmark<2>(prm, matrixFilename, rhsFilename, repeats); break;
+        case 3: benchmark<3>(prm, matrixFilename, rhsFilename, repeats); break;
+        case 4: benchmark<4>(prm, matrixFilename, rhsFilename, repeats); break;
+        default:
+            throw std::runtime_error("Only block sizes 1 to 4 are supported");
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,322 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Microbenchmarks of the well model kernels on synthetic wells. The driver
+// writes a deck with a standard well and a multisegment well, both
+// perforated in every cell of a column, sets up the simulator on it and
+// times
+//   - the assembly of the standard well equations,
+//   - the perforation rates of the standard well (computePerfRate()),
+//   - the assembly of the multisegment well equations,
+//   - the bhp interpolation in a production VFP table, and
+//   - the productivity index of the standard well.
+// Like Google Benchmark, every kernel is called in batches of growing size
+// until a batch runs for at least the given time, and the time per call of
+// that batch is reported. The wells are assembled without inner iterations,
+// so the assembly benchmarks time assembleWellEqWithoutIteration().
+//
+// Usage: flow_wellkernels_bench [perforations] [segments] [vfp_points] [min_time]
+
+#include <config.h>
+
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
+#include <opm/parser/eclipse/Units/Units.hpp>
+
+#include <opm/material/densead/Evaluation.hpp>
+
+#include <opm/simulators/flow/FlowMainEbos.hpp>
+#include <opm/simulators/utils/DeferredLogger.hpp>
+#include <opm/simulators/wells/BlackoilWellModel.hpp>
+#include <opm/simulators/wells/MultisegmentWell.hpp>
+#include <opm/simulators/wells/StandardWell.hpp>
+#include <opm/simulators/wells/VFPProdProperties.hpp>
+#include <opm/simulators/wells/WellProdIndexCalculator.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using TypeTag = Opm::Properties::TTag::EclFlowProblem;
+using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+using StdWell = Opm::StandardWell<TypeTag>;
+using MSWell = Opm::MultisegmentWell<TypeTag>;
+
+// Keeps the compiler from optimising the benchmarked calls away.
+volatile double sink = 0.0;
+
+// Calls the kernel in batches of growing size until a batch takes at least
+// minTime seconds, then prints the time per call of that batch.
+template <class Kernel>
+void runBenchmark(const std::string& name, const double minTime, Kernel&& kernel)
+{
+    long iterations = 1;
+    while (true) {
+        Dune::Timer timer;
+        for (long i = 0; i < iterations; ++i) {
+            kernel();
+        }
+        const double seconds = timer.stop();
+        if (seconds >= minTime || iterations >= (1L << 30)) {
+            std::cout << std::left << std::setw(40) << name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(1)
+                      << seconds / iterations * 1e9 << " ns"
+                      << std::setw(14) << iterations << std::defaultfloat << '\n';
+            return;
+        }
+        const long estimate = seconds > 0.0 ? static_cast<long>(1.4 * iterations * minTime / seconds) : 10 * iterations;
+        iterations = std::max(2 * iterations, estimate);
+    }
+}
+
+// A dead oil deck on a column of numCells cells. The standard well PROD
+// and the multisegment well MSW, with numSegments segments below its top
+// segment, are perforated in every cell and both produce at a bhp below
+// the initial reservoir pressure.
+std::string syntheticDeck(const int numCells, const int numSegments)
+{
+    const double dz = 2.0;
+    std::ostringstream deck;
+    deck << "RUNSPEC\n"
+         << "WATER\nOIL\nGAS\nMETRIC\n"
+         << "DIMENS\n 2 1 " << numCells << " /\n"
+         << "TABDIMS\n 1 1 40 20 1 20 /\n"
+         << "EQLDIMS\n 1 /\n"
+         << "WELLDIMS\n 2 " << numCells << " 1 2 /\n"
+         << "WSEGDIMS\n 1 " << numSegments + 1 << " 1 /\n"
+         << "START\n 1 JAN 2021 /\n"
+         << "GRID\n"
+         << "DX\n " << 2 * numCells << "*100 /\n"
+         << "DY\n " << 2 * numCells << "*100 /\n"
+         << "DZ\n " << 2 * numCells << "*" << dz << " /\n"
+         << "TOPS\n 2*2000 /\n"
+         << "PERMX\n " << 2 * numCells << "*100 /\n"
+         << "PERMY\n " << 2 * numCells << "*100 /\n"
+         << "PERMZ\n " << 2 * numCells << "*10 /\n"
+         << "PORO\n " << 2 * numCells << "*0.3 /\n"
+         << "PROPS\n"
+         << "PVDO\n 50 1.10 1.0\n 200 1.05 1.2\n 400 1.02 1.4 /\n"
+         << "PVDG\n 50 0.020 0.015\n 200 0.005 0.020\n 400 0.003 0.025 /\n"
+         << "PVTW\n 200 1.0 4.0E-5 0.5 0.0 /\n"
+         << "SWOF\n 0.2 0 1 0\n 1.0 1 0 0 /\n"
+         << "SGOF\n 0.0 0 1 0\n 0.8 1 0 0 /\n"
+         << "DENSITY\n 800 1000 1 /\n"
+         << "ROCK\n 200 1.0E-5 /\n"
+         << "SOLUTION\n"
+         << "EQUIL\n 2000 200 3000 0 1000 0 /\n"
+         << "SCHEDULE\n"
+         << "WELSPECS\n"
+         << " 'PROD' 'G' 1 1 2000 'OIL' /\n"
+         << " 'MSW' 'G' 2 1 2000 'OIL' /\n"
+         << "/\n"
+         << "COMPDAT\n"
+         << " 'PROD' 1 1 1 " << numCells << " 'OPEN' 1* 1* 0.2 /\n"
+         << " 'MSW' 2 1 1 " << numCells << " 'OPEN' 1* 1* 0.2 /\n"
+         << "/\n"
+         << "WELSEGS\n"
+         << " 'MSW' 2000 0 1* 'INC' 'HF-' /\n"
+         << " 2 " << numSegments + 1 << " 1 1 " << numCells * dz / numSegments << ' '
+         << numCells * dz / numSegments << " 0.2 1.0E-5 /\n"
+         << "/\n"
+         << "COMPSEGS\n"
+         << " 'MSW' /\n";
+    for (int k = 0; k < numCells; ++k) {
+        deck << " 2 1 " << k + 1 << " 1 " << k * dz << ' ' << (k + 1) * dz << " /\n";
+    }
+    deck << "/\n"
+         << "WCONPROD\n"
+         << " 'PROD' 'OPEN' 'BHP' 5* 100 /\n"
+         << " 'MSW' 'OPEN' 'BHP' 5* 100 /\n"
+         << "/\n"
+         << "TSTEP\n 1 /\n"
+         << "END\n";
+    return deck.str();
+}
+
+std::unique_ptr<Simulator> initSimulator(const std::string& deckFilename)
+{
+    const std::string deckArg = "--ecl-deck-file-name=" + deckFilename;
+    const char* argv[] = {
+        "flow_wellkernels_bench",
+        deckArg.c_str(),
+        "--enable-ecl-output=false",
+        "--use-inner-iterations-wells=false",
+        "--use-inner-iterations-ms-wells=false"
+    };
+    Opm::FlowMainEbos<TypeTag>::setupParameters_(sizeof(argv) / sizeof(argv[0]), const_cast<char**>(argv));
+    return std::make_unique<Simulator>();
+}
+
+void benchmarkWells(const int numPerforations, const int numSegments, const double minTime)
+{
+    const std::string deckFilename = "WELLKERNELS_BENCH.DATA";
+    {
+        std::ofstream deck(deckFilename);
+        if (!deck) {
+            throw std::runtime_error("Could not write " + deckFilename);
+        }
+        deck << syntheticDeck(numPerforations, numSegments);
+    }
+    auto simulator = initSimulator(deckFilename);
+
+    // The same preparation as at the start of the first time step.
+    const double dt = 86400.0;
+    simulator->model().applyInitialSolution();
+    simulator->setEpisodeIndex(-1);
+    simulator->setEpisodeLength(0.0);
+    simulator->startNextEpisode(/*episodeStartTime=*/0.0, /*episodeLength=*/1e30);
+    simulator->setTimeStepSize(dt);
+    simulator->model().newtonMethod().setIterationIndex(0);
+    auto& wellModel = simulator->problem().wellModel();
+    wellModel.beginReportStep(0);
+    wellModel.beginTimeStep();
+    wellModel.updatePerforationIntensiveQuantities();
+    Opm::DeferredLogger deferredLogger;
+    wellModel.calculateExplicitQuantities(deferredLogger);
+    wellModel.prepareTimeStep(deferredLogger);
+    wellModel.updateWellControls(deferredLogger, /*checkGroupControls=*/true);
+    wellModel.initPrimaryVariablesEvaluation();
+
+    auto stdWell = std::dynamic_pointer_cast<StdWell>(wellModel.getWell("PROD"));
+    auto msWell = std::dynamic_pointer_cast<MSWell>(wellModel.getWell("MSW"));
+    if (!stdWell || !msWell) {
+        throw std::logic_error("The synthetic wells are not set up as standard and multisegment wells");
+    }
+    auto& wellState = wellModel.wellState();
+    const auto& groupState = wellModel.groupState();
+
+    const std::string sizes = "/" + std::to_string(numPerforations);
+    runBenchmark("StandardWell::assembleWellEq" + sizes, minTime, [&]() {
+        stdWell->assembleWellEq(*simulator, dt, wellState, groupState, deferredLogger);
+    });
+
+    std::vector<double> rates;
+    const double bhp = 100.0 * Opm::unit::barsa;
+    runBenchmark("StandardWell::computePerfRate" + sizes, minTime, [&]() {
+        stdWell->computeWellRatesWithBhp(*simulator, bhp, rates, deferredLogger);
+        sink = rates[0];
+    });
+
+    runBenchmark("MultisegmentWell::assembleWellEq" + sizes + "/" + std::to_string(numSegments), minTime, [&]() {
+        msWell->assembleWellEq(*simulator, dt, wellState, groupState, deferredLogger);
+    });
+
+    const Opm::WellProdIndexCalculator piCalculator(simulator->vanguard().schedule().getWell("PROD", 0));
+    const std::vector<double> mobility(numPerforations, 1.0e-3);
+    runBenchmark("WellProdIndexCalculator" + sizes, minTime, [&]() {
+        sink = Opm::wellProdIndStandard(piCalculator, mobility);
+    });
+}
+
+// A table with numPoints points on every axis. The bhp is a plane in the
+// axis values, as in the VFP unit tests.
+void benchmarkVfp(const int numPoints, const double minTime)
+{
+    std::vector<double> axis(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        axis[i] = static_cast<double>(i) / (numPoints - 1);
+    }
+    const int n = numPoints;
+    std::vector<double> data(n * n * n * n * n);
+    for (int thp = 0; thp < n; ++thp) {
+        for (int wfr = 0; wfr < n; ++wfr) {
+            for (int gfr = 0; gfr < n; ++gfr) {
+                for (int alq = 0; alq < n; ++alq) {
+                    for (int flo = 0; flo < n; ++flo) {
+                        data[(((thp * n + wfr) * n + gfr) * n + alq) * n + flo]
+                            = axis[thp] + 2 * axis[wfr] + 3 * axis[gfr] + 4 * axis[alq] + 5 * axis[flo];
+                    }
+                }
+            }
+        }
+    }
+    const Opm::VFPProdTable table(1, 1000.0,
+                                  Opm::VFPProdTable::FLO_TYPE::FLO_OIL,
+                                  Opm::VFPProdTable::WFR_TYPE::WFR_WOR,
+                                  Opm::VFPProdTable::GFR_TYPE::GFR_GOR,
+                                  Opm::VFPProdTable::ALQ_TYPE::ALQ_UNDEF,
+                                  axis, axis, axis, axis, axis, data);
+    Opm::VFPProdProperties properties;
+    properties.addTable(table);
+
+    // Spread the queries over the table so that the interval search does
+    // not always hit the same interval.
+    const int numQueries = 64;
+    std::vector<double> queries(numQueries);
+    unsigned long random = 42;
+    for (auto& q : queries) {
+        random = random * 1103515245 + 12345;
+        q = 0.05 + 0.9 * static_cast<double>(random % 1000) / 1000.0;
+    }
+
+    const std::string sizes = "/" + std::to_string(numPoints);
+    int query = 0;
+    runBenchmark("VFPProdProperties::bhp<double>" + sizes, minTime, [&]() {
+        const double q = queries[query++ % numQueries];
+        sink = properties.bhp(1, 0.2 * q, q, 0.5 * q, q, 0.0);
+    });
+
+    // The evaluation type of a three phase standard well.
+    using EvalWell = Opm::DenseAd::Evaluation<double, -1, 7u>;
+    runBenchmark("VFPProdProperties::bhp<EvalWell>" + sizes, minTime, [&]() {
+        const double q = queries[query++ % numQueries];
+        const EvalWell aqua(7, 0.2 * q);
+        const EvalWell liquid(7, q);
+        const EvalWell vapour(7, 0.5 * q);
+        sink = properties.bhp(1, aqua, liquid, vapour, q, 0.0).value();
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    try {
+        const int numPerforations = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 10;
+        const int numSegments = argc > 2 ? std::max(std::stoi(argv[2]), 1) : numPerforations;
+        const int vfpPoints = argc > 3 ? std::max(std::stoi(argv[3]), 2) : 10;
+        const double minTime = argc > 4 ? std::stod(argv[4]) : 0.5;
+
+        std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+                  << std::setw(17) << "Time" << std::setw(14) << "Iterations" << '\n';
+        benchmarkWells(numPerforations, numSegments, minTime);
+        benchmarkVfp(vfpPoints, minTime);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n'
+                  << "Usage: " << argv[0] << " [perforations] [segments] [vfp_points] [min_time]\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+// Entry point of a flow model plugin. Compiled once per plugin, with
+// FLOW_PLUGIN_MODEL set to the name of the model as used by its functions,
+// e.g. GasOil for flowEbosGasOilSetDeck() and flowEbosGasOilMain().
+
+#include <flow/flow_ebos_plugin.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+
+#include <memory>
+
+#ifndef FLOW_PLUGIN_MODEL
+#error "FLOW_PLUGIN_MODEL must be defined when building a flow plugin"
+#endif
+
+#define FLOW_PLUGIN_FUNCTION_(model, suffix) flowEbos##model##suffix
+#define FLOW_PLUGIN_FUNCTION(model, suffix) FLOW_PLUGIN_FUNCTION_(model, suffix)
+
+namespace Opm {
+
+#ifndef FLOW_PLUGIN_NO_SETDECK
+void FLOW_PLUGIN_FUNCTION(FLOW_PLUGIN_MODEL, SetDeck)(double setupTime, std::unique_ptr<Deck> deck,
+                                                      std::unique_ptr<EclipseState> eclState,
+                                                      std::unique_ptr<Schedule> schedule,
+                                                      std::unique_ptr<SummaryConfig> summaryConfig);
+#endif
+int FLOW_PLUGIN_FUNCTION(FLOW_PLUGIN_MODEL, Main)(int argc, char** argv, bool outputCout, bool outputFiles);
+
+}
+
+extern "C"
+__attribute__((visibility("default")))
+int opmFlowPluginMain(double setupTime,
+                      Opm::Deck* deck,
+                      Opm::EclipseState* eclState,
+                      Opm::Schedule* schedule,
+                      Opm::SummaryConfig* summaryConfig,
+                      int argc, char** argv,
+                      bool outputCout, bool outputFiles)
+{
+    std::unique_ptr<Opm::Deck> deckPtr(deck);
+    std::unique_ptr<Opm::EclipseState> eclStatePtr(eclState);
+    std::unique_ptr<Opm::Schedule> schedulePtr(schedule);
+    std::unique_ptr<Opm::SummaryConfig> summaryConfigPtr(summaryConfig);
+
+#ifndef FLOW_PLUGIN_NO_SETDECK
+    if (eclStatePtr)
+        Opm::FLOW_PLUGIN_FUNCTION(FLOW_PLUGIN_MODEL, SetDeck)(setupTime, std::move(deckPtr),
+                                                              std::move(eclStatePtr),
+                                                              std::move(schedulePtr),
+                                                              std::move(summaryConfigPtr));
+#else
+    static_cast<void>(setupTime);
+#endif
+
+    return Opm::FLOW_PLUGIN_FUNCTION(FLOW_PLUGIN_MODEL, Main)(argc, argv, outputCout, outputFiles);
+}
@@ -0,0 +1,45 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef FLOW_EBOS_PLUGIN_HPP
+#define FLOW_EBOS_PLUGIN_HPP
+
+namespace Opm {
+
+class Deck;
+class EclipseState;
+class Schedule;
+class SummaryConfig;
+
+}
+
+/// Name of the entry point exported by every flow model plugin.
+#define FLOW_PLUGIN_ENTRY_POINT "opmFlowPluginMain"
+
+/// Entry point of a flow model plugin, i.e. a shared library which contains
+/// one of the models of flow besides blackoil. The plugin takes ownership of
+/// the parsed input, which may be null if the model parses the deck itself.
+extern "C" {
+typedef int (*OpmFlowPluginMain)(double setupTime,
+                                 Opm::Deck* deck,
+                                 Opm::EclipseState* eclState,
+                                 Opm::Schedule* schedule,
+                                 Opm::SummaryConfig* summaryConfig,
+                                 int argc, char** argv,
+                                 bool outputCout, bool outputFiles);
+}
+
+#endif // FLOW_EBOS_PLUGIN_HPP
@@ -0,0 +1,176 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+// Implementations of the model functions of flow which forward to the model
+// plugins, for a flow binary which only contains the blackoil model. The
+// SetDeck() functions keep the parsed input until the Main() function of the
+// same model loads its plugin and hands the input over.
+
+#include <flow/flow_ebos_plugin.hpp>
+
+#include <flow/flow_ebos_gasoil.hpp>
+#include <flow/flow_ebos_oilwater.hpp>
+#include <flow/flow_ebos_gaswater.hpp>
+#include <flow/flow_ebos_solvent.hpp>
+#include <flow/flow_ebos_polymer.hpp>
+#include <flow/flow_ebos_extbo.hpp>
+#include <flow/flow_ebos_foam.hpp>
+#include <flow/flow_ebos_brine.hpp>
+#include <flow/flow_ebos_oilwater_brine.hpp>
+#include <flow/flow_ebos_energy.hpp>
+#include <flow/flow_ebos_oilwater_polymer.hpp>
+#include <flow/flow_ebos_oilwater_polymer_injectivity.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+
+#include <dlfcn.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct PendingInput
+{
+    double setupTime = 0.0;
+    std::unique_ptr<Opm::Deck> deck;
+    std::unique_ptr<Opm::EclipseState> eclState;
+    std::unique_ptr<Opm::Schedule> schedule;
+    std::unique_ptr<Opm::SummaryConfig> summaryConfig;
+};
+
+PendingInput pendingInput;
+
+void setPendingInput(double setupTime,
+                     std::unique_ptr<Opm::Deck> deck,
+                     std::unique_ptr<Opm::EclipseState> eclState,
+                     std::unique_ptr<Opm::Schedule> schedule,
+                     std::unique_ptr<Opm::SummaryConfig> summaryConfig)
+{
+    pendingInput.setupTime = setupTime;
+    pendingInput.deck = std::move(deck);
+    pendingInput.eclState = std::move(eclState);
+    pendingInput.schedule = std::move(schedule);
+    pendingInput.summaryConfig = std::move(summaryConfig);
+}
+
+// The directories searched for the plugins: those in OPM_FLOW_PLUGIN_PATH,
+// then the install and the build directory.
+std::vector<std::string> pluginDirectories()
+{
+    std::vector<std::string> dirs;
+    if (const char* path = std::getenv("OPM_FLOW_PLUGIN_PATH")) {
+        std::string paths(path);
+        std::string::size_type begin = 0;
+        while (begin <= paths.size()) {
+            auto end = paths.find(':', begin);
+            if (end == std::string::npos)
+                end = paths.size();
+            if (end > begin)
+                dirs.push_back(paths.substr(begin, end - begin));
+            begin = end + 1;
+        }
+    }
+#ifdef FLOW_PLUGIN_INSTALL_DIR
+    dirs.push_back(FLOW_PLUGIN_INSTALL_DIR);
+#endif
+#ifdef FLOW_PLUGIN_BUILD_DIR
+    dirs.push_back(FLOW_PLUGIN_BUILD_DIR);
+#endif
+    return dirs;
+}
+
+int runPlugin(const std::string& model, int argc, char** argv, bool outputCout, bool outputFiles)
+{
+    const std::string fileName = "libflow_plugin_" + model + ".so";
+    void* handle = nullptr;
+    std::string errors;
+    for (const auto& dir : pluginDirectories()) {
+        handle = dlopen((dir + "/" + fileName).c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle)
+            break;
+        errors += std::string("\n  ") + dlerror();
+    }
+    if (!handle) {
+        if (outputCout)
+            std::cerr << "The flow plugin for the " << model << " model could not be loaded:"
+                      << errors << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto entry = reinterpret_cast<OpmFlowPluginMain>(dlsym(handle, FLOW_PLUGIN_ENTRY_POINT));
+    if (!entry) {
+        if (outputCout)
+            std::cerr << "The flow plugin " << fileName << " is invalid: " << dlerror() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the plugin is never unloaded, as objects created by it may outlive the run
+    auto input = std::move(pendingInput);
+    return entry(input.setupTime,
+                 input.deck.release(),
+                 input.eclState.release(),
+                 input.schedule.release(),
+                 input.summaryConfig.release(),
+                 argc, argv, outputCout, outputFiles);
+}
+
+} // anonymous namespace
+
+#define FLOW_PLUGIN_FORWARD_SETDECK(model)                                    \
+    void flowEbos##model##SetDeck(double setupTime, std::unique_ptr<Deck> deck, \
+                                  std::unique_ptr<EclipseState> eclState,    \
+                                  std::unique_ptr<Schedule> schedule,        \
+                                  std::unique_ptr<SummaryConfig> summaryConfig) \
+    {                                                                         \
+        setPendingInput(setupTime, std::move(deck), std::move(eclState),      \
+                        std::move(schedule), std::move(summaryConfig));       \
+    }
+
+#define FLOW_PLUGIN_FORWARD_MAIN(model, name)                                 \
+    int flowEbos##model##Main(int argc, char** argv, bool outputCout, bool outputFiles) \
+    {                                                                         \
+        return runPlugin(name, argc, argv, outputCout, outputFiles);          \
+    }
+
+#define FLOW_PLUGIN_FORWARD(model, name)                                      \
+    FLOW_PLUGIN_FORWARD_SETDECK(model)                                        \
+    FLOW_PLUGIN_FORWARD_MAIN(model, name)
+
+namespace Opm {
+
+FLOW_PLUGIN_FORWARD(Brine, "brine")
+FLOW_PLUGIN_FORWARD(Energy, "energy")
+FLOW_PLUGIN_FORWARD(Extbo, "extbo")
+FLOW_PLUGIN_FORWARD(Foam, "foam")
+FLOW_PLUGIN_FORWARD(GasOil, "gasoil")
+FLOW_PLUGIN_FORWARD(GasWater, "gaswater")
+FLOW_PLUGIN_FORWARD(OilWater, "oilwater")
+FLOW_PLUGIN_FORWARD(OilWaterPolymer, "oilwater_polymer")
+FLOW_PLUGIN_FORWARD(Polymer, "polymer")
+FLOW_PLUGIN_FORWARD(Solvent, "solvent")
+FLOW_PLUGIN_FORWARD(OilWaterBrine, "oilwater_brine")
+FLOW_PLUGIN_FORWARD_MAIN(OilWaterPolymerInjectivity, "oilwater_polymer_injectivity")
+
+}
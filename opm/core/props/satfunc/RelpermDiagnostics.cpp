@@ -22,6 +22,7 @@
 
 #include <opm/material/fluidmatrixinteractions/EclEpsScalingPoints.hpp>
 
+#include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/SatfuncPropertyInitializers.hpp>
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
@@ -39,6 +40,53 @@
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/polyhedralgrid.hh>
 
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <streambuf>
+
+namespace {
+
+    // FNV-1a hash of the characters written to a stream.
+    class HashBuffer : public std::streambuf
+    {
+    public:
+        std::size_t hash() const
+        {
+            return static_cast<std::size_t>(hash_);
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                add_(traits_type::to_char_type(c));
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            for (std::streamsize i = 0; i < n; ++i) {
+                add_(s[i]);
+            }
+            return n;
+        }
+
+    private:
+        void add_(const char c)
+        {
+            hash_ ^= static_cast<unsigned char>(c);
+            hash_ *= 1099511628211ULL;
+        }
+
+        std::uint64_t hash_ = 14695981039346656037ULL;
+    };
+
+} // anonymous namespace
+
 namespace Opm{
 
     bool RelpermDiagnostics::phaseCheck_(const EclipseState& es)
@@ -731,7 +779,9 @@ namespace Opm{
 
     template <class CartesianIndexMapper>
     void RelpermDiagnostics::diagnosis(const EclipseState& eclState,
-                                       const CartesianIndexMapper& cartesianIndexMapper)
+                                       const CartesianIndexMapper& cartesianIndexMapper,
+                                       const Communication& comm,
+                                       const std::vector<bool>& isInterior)
     {
         OpmLog::info("\n===============Saturation Functions Diagnostics===============\n");
         bool doDiagnostics = phaseCheck_(eclState);
@@ -740,62 +790,157 @@ namespace Opm{
         satFamilyCheck_(eclState);
         tableCheck_(eclState);
         unscaledEndPointsCheck_(eclState);
-        scaledEndPointsCheck_(eclState, cartesianIndexMapper);
+        scaledEndPointsCheck_(eclState, cartesianIndexMapper, comm, isInterior);
+    }
+
+    std::size_t RelpermDiagnostics::deckHash(const Deck& deck)
+    {
+        HashBuffer buffer;
+        std::ostream os(&buffer);
+        os << deck;
+        os.flush();
+        return buffer.hash();
+    }
+
+    bool RelpermDiagnostics::upToDate(const Deck& deck,
+                                      const std::string& hashFile,
+                                      const Communication& comm)
+    {
+        int unchanged = 0;
+        if (comm.rank() == 0) {
+            const std::size_t hash = deckHash(deck);
+            std::size_t previousHash = 0;
+            std::ifstream is(hashFile);
+            unchanged = (is >> previousHash) && (previousHash == hash);
+            if (!unchanged) {
+                std::ofstream os(hashFile);
+                os << hash << '\n';
+            }
+        }
+        comm.broadcast(&unchanged, 1, 0);
+        return unchanged != 0;
     }
 
     template <class CartesianIndexMapper>
     void RelpermDiagnostics::scaledEndPointsCheck_(const EclipseState& eclState,
-                                                   const CartesianIndexMapper& cartesianIndexMapper)
+                                                   const CartesianIndexMapper& cartesianIndexMapper,
+                                                   const Communication& comm,
+                                                   const std::vector<bool>& isInterior)
     {
         // All end points are subject to round-off errors, checks should account for it
         const float tolerance = 1e-6;
         const int nc = cartesianIndexMapper.compressedSize();
         const bool threepoint = eclState.runspec().endpointScaling().threepoint();
+        const bool blackOil = fluidSystem_ == FluidSystem::BlackOil;
         scaledEpsInfo_.resize(nc);
         EclEpsGridProperties epsGridProperties(eclState, false);
         const std::string tag = "Scaled endpoints";
-        for (int c = 0; c < nc; ++c) {
-            const std::string satnumIdx = std::to_string(epsGridProperties.satRegion(c));
-            std::string cellIdx;
-            {
-                std::array<int, 3> ijk;
-                cartesianIndexMapper.cartesianCoordinate(c, ijk);
-                cellIdx = "(" + std::to_string(ijk[0]) + ", " +
-                    std::to_string(ijk[1]) + ", " +
-                    std::to_string(ijk[2]) + ")";
-            }
-            scaledEpsInfo_[c].extractScaled(eclState, epsGridProperties, c);
 
-            // SGU <= 1.0 - SWL
-            if (scaledEpsInfo_[c].Sgu > (1.0 - scaledEpsInfo_[c].Swl + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGU exceed 1.0 - SWL";
-                OpmLog::warning(tag, msg);
+        // For every check, the number of offending cells and the offending
+        // cell of lowest Cartesian index, which is reported as an example.
+        constexpr int numChecks = 4;
+        const std::array<std::string, numChecks> violations = {
+            "SGU exceed 1.0 - SWL",
+            "SGL exceed 1.0 - SWU",
+            "SOWCR + SWCR exceed 1.0",
+            "SOGCR + SGCR + SWL exceed 1.0"
+        };
+        std::array<int, numChecks> numCells{};
+        std::array<int, numChecks> firstCell;
+        std::array<int, numChecks> firstSatnum{};
+        firstCell.fill(std::numeric_limits<int>::max());
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            std::array<int, numChecks> threadNumCells{};
+            std::array<int, numChecks> threadFirstCell;
+            std::array<int, numChecks> threadFirstSatnum{};
+            threadFirstCell.fill(std::numeric_limits<int>::max());
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int c = 0; c < nc; ++c) {
+                if (!isInterior.empty() && !isInterior[c])
+                    continue;
+
+                auto& epsInfo = scaledEpsInfo_[c];
+                epsInfo.extractScaled(eclState, epsGridProperties, c);
+
+                const std::array<bool, numChecks> violated = {
+                    // SGU <= 1.0 - SWL
+                    epsInfo.Sgu > (1.0 - epsInfo.Swl + tolerance),
+                    // SGL <= 1.0 - SWU
+                    epsInfo.Sgl > (1.0 - epsInfo.Swu + tolerance),
+                    // Mobilility check.
+                    threepoint && blackOil && (epsInfo.Sowcr + epsInfo.Swcr) >= (1.0 + tolerance),
+                    threepoint && blackOil && (epsInfo.Sogcr + epsInfo.Sgcr + epsInfo.Swl) >= (1.0 + tolerance)
+                };
+
+                const int cartIdx = cartesianIndexMapper.cartesianIndex(c);
+                for (int check = 0; check < numChecks; ++check) {
+                    if (!violated[check])
+                        continue;
+                    ++threadNumCells[check];
+                    if (cartIdx < threadFirstCell[check]) {
+                        threadFirstCell[check] = cartIdx;
+                        threadFirstSatnum[check] = epsGridProperties.satRegion(c);
+                    }
+                }
             }
 
-            // SGL <= 1.0 - SWU
-            if (scaledEpsInfo_[c].Sgl > (1.0 - scaledEpsInfo_[c].Swu + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGL exceed 1.0 - SWU";
-                OpmLog::warning(tag, msg);
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            for (int check = 0; check < numChecks; ++check) {
+                numCells[check] += threadNumCells[check];
+                if (threadFirstCell[check] < firstCell[check]) {
+                    firstCell[check] = threadFirstCell[check];
+                    firstSatnum[check] = threadFirstSatnum[check];
+                }
             }
+        }
 
-            if (threepoint && fluidSystem_ == FluidSystem::BlackOil) {
-                // Mobilility check.
-                if ((scaledEpsInfo_[c].Sowcr + scaledEpsInfo_[c].Swcr) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOWCR + SWCR exceed 1.0";
-                    OpmLog::warning(tag, msg);
-                }
+        // the process which holds the example cell knows its region
+        const auto localFirstCell = firstCell;
+        comm.sum(numCells.data(), numChecks);
+        comm.min(firstCell.data(), numChecks);
+        for (int check = 0; check < numChecks; ++check) {
+            if (localFirstCell[check] != firstCell[check])
+                firstSatnum[check] = std::numeric_limits<int>::min();
+        }
+        comm.max(firstSatnum.data(), numChecks);
 
-            if ((scaledEpsInfo_[c].Sogcr + scaledEpsInfo_[c].Sgcr + scaledEpsInfo_[c].Swl) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOGCR + SGCR + SWL exceed 1.0";
-                    OpmLog::warning(tag, msg);
-                }
+        if (comm.rank() != 0)
+            return;
+
+        const auto& dims = cartesianIndexMapper.cartesianDimensions();
+        for (int check = 0; check < numChecks; ++check) {
+            if (numCells[check] == 0)
+                continue;
+
+            const int cartIdx = firstCell[check];
+            const std::string cellIdx = "(" + std::to_string(cartIdx % dims[0]) + ", " +
+                std::to_string((cartIdx / dims[0]) % dims[1]) + ", " +
+                std::to_string(cartIdx / (dims[0]*dims[1])) + ")";
+            const std::string satnumIdx = std::to_string(firstSatnum[check]);
+            if (numCells[check] == 1) {
+                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", " + violations[check];
+                OpmLog::warning(tag, msg);
+            }
+            else {
+                const std::string msg = "For scaled endpoints input, " + violations[check] + " in " + std::to_string(numCells[check])
+                    + " cells, e.g., in cell" + cellIdx + " SATNUM = " + satnumIdx;
+                OpmLog::warning(tag, msg);
             }
         }
     }
 
 #define INSTANCE_DIAGNOSIS(...) \
-    template void RelpermDiagnostics::diagnosis<Dune::CartesianIndexMapper<__VA_ARGS__>>(const EclipseState&, const Dune::CartesianIndexMapper<__VA_ARGS__>&); \
-    template void RelpermDiagnostics::scaledEndPointsCheck_<Dune::CartesianIndexMapper<__VA_ARGS__>>(const EclipseState&, const Dune::CartesianIndexMapper<__VA_ARGS__>&);
+    template void RelpermDiagnostics::diagnosis<Dune::CartesianIndexMapper<__VA_ARGS__>>(const EclipseState&, const Dune::CartesianIndexMapper<__VA_ARGS__>&, const Communication&, const std::vector<bool>&); \
+    template void RelpermDiagnostics::scaledEndPointsCheck_<Dune::CartesianIndexMapper<__VA_ARGS__>>(const EclipseState&, const Dune::CartesianIndexMapper<__VA_ARGS__>&, const Communication&, const std::vector<bool>&);
 
     INSTANCE_DIAGNOSIS(Dune::CpGrid)
     INSTANCE_DIAGNOSIS(Dune::PolyhedralGrid<3,3>)
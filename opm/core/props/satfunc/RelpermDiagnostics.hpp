@@ -20,6 +20,8 @@
 #ifndef OPM_RELPERMDIAGNOSTICS_HEADER_INCLUDED
 #define OPM_RELPERMDIAGNOSTICS_HEADER_INCLUDED
 
+#include <cstddef>
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -27,10 +29,19 @@
 #include "config.h"
 #endif // HAVE_CONFIG_H
 
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
 #include <opm/material/fluidmatrixinteractions/EclEpsScalingPoints.hpp>
 
 namespace Opm {
 
+    class Deck;
     class EclipseState;
     class MiscTable;
     class MsfnTable;
@@ -45,14 +56,39 @@ namespace Opm {
     class RelpermDiagnostics
     {
     public:
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
         ///This function is used to diagnosis relperm in
         ///eclipse data file. Errors and warings will be
         ///output if they're found.
+        ///The scaled end points are checked for the local cells
+        ///of every process, and the number of offending cells
+        ///is summed up and reported by rank 0.
         ///\param[in] eclState  eclipse state.
-        ///\param[in] grid      unstructured grid.
+        ///\param[in] cartesianIndexMapper  mapper of the local cells.
+        ///\param[in] comm      communication of the processes.
+        ///\param[in] isInterior  whether a local cell is owned by this
+        ///                       process. All cells are if empty.
         template <class CartesianIndexMapper>
         void diagnosis(const EclipseState& eclState,
-                       const CartesianIndexMapper& cartesianIndexMapper);
+                       const CartesianIndexMapper& cartesianIndexMapper,
+                       const Communication& comm = Dune::MPIHelper::getCollectiveCommunication(),
+                       const std::vector<bool>& isInterior = {});
+
+        ///Hash of the deck, which identifies the input of the
+        ///diagnostics on reruns.
+        static std::size_t deckHash(const Deck& deck);
+
+        ///Whether the diagnostics of an unchanged deck are
+        ///recorded in hashFile. Otherwise, the hash of the deck
+        ///is written to hashFile by rank 0.
+        ///\param[in] deck      input deck.
+        ///\param[in] hashFile  file holding the hash of the deck
+        ///                     of the last diagnostics.
+        ///\param[in] comm      communication of the processes.
+        static bool upToDate(const Deck& deck,
+                             const std::string& hashFile,
+                             const Communication& comm);
 
     private:
         enum FluidSystem {
@@ -92,7 +128,9 @@ namespace Opm {
 
         template <class CartesianIndexMapper>
         void scaledEndPointsCheck_(const EclipseState& eclState,
-                                   const CartesianIndexMapper& cartesianIndexMapper);
+                                   const CartesianIndexMapper& cartesianIndexMapper,
+                                   const Communication& comm,
+                                   const std::vector<bool>& isInterior);
 
         ///For every table, need to deal with case by case.
         void swofTableCheck_(const SwofTable& swofTables,
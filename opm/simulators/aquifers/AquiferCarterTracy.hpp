@@ -69,6 +69,22 @@ public:
         comm.sum(&this->fluxValue_, 1);
     }
 
+    void writeCheckpoint(std::ostream& os) const override
+    {
+        Base::writeCheckpoint(os);
+        BinaryCheckpoint::write(os, this->fluxValue_);
+        BinaryCheckpoint::write(os, this->dimensionless_time_);
+        BinaryCheckpoint::write(os, this->dimensionless_pressure_);
+    }
+
+    void readCheckpoint(std::istream& is) override
+    {
+        Base::readCheckpoint(is);
+        BinaryCheckpoint::read(is, this->fluxValue_);
+        BinaryCheckpoint::read(is, this->dimensionless_time_);
+        BinaryCheckpoint::read(is, this->dimensionless_pressure_);
+    }
+
     data::AquiferData aquiferData() const
     {
         data::AquiferData data;
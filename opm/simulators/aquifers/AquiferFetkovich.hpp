@@ -68,6 +68,18 @@ public:
         aquifer_pressure_ = aquiferPressure();
     }
 
+    void writeCheckpoint(std::ostream& os) const override
+    {
+        Base::writeCheckpoint(os);
+        BinaryCheckpoint::write(os, this->aquifer_pressure_);
+    }
+
+    void readCheckpoint(std::istream& is) override
+    {
+        Base::readCheckpoint(is);
+        BinaryCheckpoint::read(is, this->aquifer_pressure_);
+    }
+
     data::AquiferData aquiferData() const
     {
         // TODO: how to unify the two functions?
@@ -29,12 +29,18 @@
 
 #include <opm/output/data/Aquifer.hpp>
 
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
 #include <opm/material/common/MathToolbox.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/fluidstates/BlackOilFluidState.hpp>
 
 #include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -106,6 +112,42 @@ public:
         initQuantities();
     }
 
+    // Write and read the dynamic state of the aquifer in a binary checkpoint,
+    // including the derivatives of the cumulative influx.
+    virtual void writeCheckpoint(std::ostream& os) const
+    {
+        std::vector<Scalar> flux(1 + Eval::numVars);
+        flux[0] = this->W_flux_.value();
+        for (int i = 0; i < Eval::numVars; ++i) {
+            flux[1 + i] = this->W_flux_.derivative(i);
+        }
+        BinaryCheckpoint::write(os, flux);
+        BinaryCheckpoint::write(os, this->pa0_);
+        BinaryCheckpoint::write(os, this->pressure_previous_);
+        BinaryCheckpoint::write(os, this->solution_set_from_restart_);
+    }
+
+    virtual void readCheckpoint(std::istream& is)
+    {
+        std::vector<Scalar> flux;
+        BinaryCheckpoint::read(is, flux);
+        if (flux.size() != static_cast<std::size_t>(1 + Eval::numVars)) {
+            throw std::runtime_error("The checkpoint does not match the aquifer " + std::to_string(this->aquiferID()));
+        }
+        this->W_flux_.setValue(flux[0]);
+        for (int i = 0; i < Eval::numVars; ++i) {
+            this->W_flux_.setDerivative(i, flux[1 + i]);
+        }
+        BinaryCheckpoint::read(is, this->pa0_);
+        std::vector<Scalar> pressure_previous;
+        BinaryCheckpoint::read(is, pressure_previous);
+        if (pressure_previous.size() != this->pressure_previous_.size()) {
+            throw std::runtime_error("The checkpoint does not match the aquifer " + std::to_string(this->aquiferID()));
+        }
+        this->pressure_previous_ = std::move(pressure_previous);
+        BinaryCheckpoint::read(is, this->solution_set_from_restart_);
+    }
+
     void beginTimeStep()
     {
         ElementContext elemCtx(ebos_simulator_);
@@ -127,30 +169,45 @@ public:
         }
     }
 
-    template <class Context>
-    void addToSource(RateVector& rates,
-                     const Context& context,
-                     const unsigned spaceIdx,
-                     const unsigned timeIdx)
+    // Compute the water influx of the connections of this process from the
+    // cached intensive quantities of the connected cells. This only modifies
+    // the aquifer itself, so different aquifers can be updated concurrently.
+    void updateInflowRates()
     {
-        const unsigned cellIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        const auto& problem = this->ebos_simulator_.problem();
+        for (std::size_t idx = 0; idx < this->size(); ++idx) {
+            const int cellIdx = this->connectedCells_[idx];
+            if (cellIdx < 0)
+                continue;
 
-        const int idx = this->cellToConnectionIdx_[cellIdx];
-        if (idx < 0)
-            return;
+            const auto& intQuants = *problem.cachedIntensiveQuantities(cellIdx);
+
+            // This is the pressure at td + dt
+            this->updateCellPressure(this->pressure_current_, idx, intQuants);
+            this->updateCellDensity(idx, intQuants);
+            this->calculateInflowRate(idx, this->ebos_simulator_);
+        }
+    }
 
-        // We are dereferencing the value of IntensiveQuantities because
-        // cachedIntensiveQuantities return a const pointer to
-        // IntensiveQuantities of that particular cell_id
-        const auto& intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
+    // Add the influx computed by updateInflowRates() to the sources of the
+    // connected cells, where sources[sourceIdx[cellIdx]] is the source of a
+    // cell.
+    void addToSources(std::vector<Eval>& sources, const std::vector<int>& sourceIdx) const
+    {
+        for (std::size_t idx = 0; idx < this->size(); ++idx) {
+            const int cellIdx = this->connectedCells_[idx];
+            if (cellIdx < 0)
+                continue;
 
-        // This is the pressure at td + dt
-        this->updateCellPressure(this->pressure_current_, idx, intQuants);
-        this->updateCellDensity(idx, intQuants);
-        this->calculateInflowRate(idx, context.simulator());
+            sources[sourceIdx[cellIdx]] += this->Qai_[idx];
+        }
+    }
 
-        rates[BlackoilIndices::conti0EqIdx + FluidSystem::waterCompIdx]
-            += this->Qai_[idx] / context.dofVolume(spaceIdx, timeIdx);
+    // The cell of every connection, -1 if it is not an interior cell of this
+    // process.
+    const std::vector<int>& connectedCells() const
+    {
+        return this->connectedCells_;
     }
 
     std::size_t size() const {
@@ -213,6 +270,7 @@ protected:
     // Grid variables
     std::vector<Scalar> faceArea_connected_;
     std::vector<int> cellToConnectionIdx_;
+    std::vector<int> connectedCells_;
 
     // Quantities at each grid id
     std::vector<Scalar> cell_depth_;
@@ -241,6 +299,7 @@ protected:
         // denom_face_areas is the sum of the areas connected to an aquifer
         Scalar denom_face_areas = 0.;
         this->cellToConnectionIdx_.resize(this->ebos_simulator_.gridView().size(/*codim=*/0), -1);
+        this->connectedCells_.resize(this->size(), -1);
         const auto& gridView = this->ebos_simulator_.vanguard().gridView();
         for (size_t idx = 0; idx < this->size(); ++idx) {
             const auto global_index = this->connections_[idx].global_index;
@@ -254,6 +313,7 @@ protected:
                 continue;
 
             this->cellToConnectionIdx_[cell_index] = idx;
+            this->connectedCells_[idx] = cell_index;
             this->cell_depth_.at(idx) = this->ebos_simulator_.vanguard().cellCenterDepth(cell_index);
         }
         // get areas for all connections
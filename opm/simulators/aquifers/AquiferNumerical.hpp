@@ -23,6 +23,12 @@
 
 #include <opm/output/data/Aquifer.hpp>
 #include <opm/parser/eclipse/EclipseState/Aquifer/NumericalAquifer/SingleNumericalAquifer.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <vector>
 
 namespace Opm
 {
@@ -57,6 +63,7 @@ public:
     , flux_rate_(0.)
     , cumulative_flux_(0.)
     , global_cell_(global_cell)
+    , num_cells_(aquifer.numCells())
     {
         this->cell_to_aquifer_cell_idx_.resize(this->ebos_simulator_.gridView().size(/*codim=*/0), -1);
 
@@ -104,17 +111,54 @@ public:
         this->cumulative_flux_ = 0.;
     }
 
+    // The cells of the aquifer are part of the primary variables, only the
+    // integrated quantities are written to the checkpoints.
+    void writeCheckpoint(std::ostream& os) const
+    {
+        BinaryCheckpoint::write(os, this->init_pressure_);
+        BinaryCheckpoint::write(os, this->pressure_);
+        BinaryCheckpoint::write(os, this->flux_rate_);
+        BinaryCheckpoint::write(os, this->cumulative_flux_);
+    }
+
+    void readCheckpoint(std::istream& is)
+    {
+        BinaryCheckpoint::read(is, this->init_pressure_);
+        BinaryCheckpoint::read(is, this->pressure_);
+        BinaryCheckpoint::read(is, this->flux_rate_);
+        BinaryCheckpoint::read(is, this->cumulative_flux_);
+    }
+
     int aquiferID() const
     {
         return static_cast<int>(this->id_);
     }
 
+    // The cells of the aquifer in the order of the aquifer, in which they
+    // are connected to each other. Empty if the aquifer is not completely
+    // on this process.
+    std::vector<int> chainCells() const
+    {
+        std::vector<int> cells(this->num_cells_, -1);
+        for (size_t cell_idx = 0; cell_idx < this->cell_to_aquifer_cell_idx_.size(); ++cell_idx) {
+            const int idx = this->cell_to_aquifer_cell_idx_[cell_idx];
+            if (idx >= 0) {
+                cells[idx] = cell_idx;
+            }
+        }
+        if (std::find(cells.begin(), cells.end(), -1) != cells.end()) {
+            return {};
+        }
+        return cells;
+    }
+
 private:
     const size_t id_;
     const Simulator& ebos_simulator_;
     double flux_rate_; // aquifer influx rate
     double cumulative_flux_; // cumulative aquifer influx
     const int* global_cell_; // mapping to global index
+    const size_t num_cells_;
     double init_pressure_;
     double pressure_; // aquifer pressure
 
@@ -179,8 +223,10 @@ private:
             if (elem.partitionType() != Dune::InteriorEntity) {
                 continue;
             }
-            // elem_ctx.updatePrimaryStencil(elem);
-            elem_ctx.updateStencil(elem);
+            // the primary stencil does not query the intersections of the grid, the
+            // full stencil with its face geometries is only built for the one cell
+            // which is needed below
+            elem_ctx.updatePrimaryStencil(elem);
 
             const size_t cell_index = elem_ctx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
             const int idx = this->cell_to_aquifer_cell_idx_[cell_index];
@@ -188,6 +234,7 @@ private:
             if (idx != 0) {
                 continue;
             }
+            elem_ctx.updateStencil(elem);
             elem_ctx.updateAllIntensiveQuantities();
             elem_ctx.updateAllExtensiveQuantities();
 
@@ -35,6 +35,7 @@
 #include <opm/simulators/aquifers/AquiferCarterTracy.hpp>
 #include <opm/simulators/aquifers/AquiferFetkovich.hpp>
 #include <opm/simulators/aquifers/AquiferNumerical.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
 
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/polyhedralgrid.hh>
@@ -44,6 +45,10 @@
 
 #include <opm/material/densead/Math.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
 #include <vector>
 #include <type_traits>
 
@@ -81,6 +86,8 @@ class BlackoilAquiferModel
 {
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using RateVector = GetPropType<TypeTag, Properties::RateVector>;
+    using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using Indices = GetPropType<TypeTag, Properties::Indices>;
 
 
 public:
@@ -91,6 +98,8 @@ public:
 
     void beginEpisode();
     void beginTimeStep();
+    // compute the water influx of the analytic aquifers into every connected
+    // cell for the current solution.
     void beginIteration();
     // add the water rate due to aquifers to the source term.
     template <class Context>
@@ -101,6 +110,10 @@ public:
 
     data::Aquifers aquiferData() const;
 
+    // the cells of every numerical aquifer in the order in which they are
+    // connected, for the linear solver to condense them
+    std::vector<std::vector<int>> numericalAquiferChains() const;
+
     template <class Restarter>
     void serialize(Restarter& res);
 
@@ -114,6 +127,7 @@ protected:
 
     typedef AquiferCarterTracy<TypeTag> AquiferCarterTracy_object;
     typedef AquiferFetkovich<TypeTag> AquiferFetkovich_object;
+    using Eval = typename AquiferInterface<TypeTag>::Eval;
 
     Simulator& simulator_;
 
@@ -123,9 +137,23 @@ protected:
     mutable std::vector<AquiferFetkovich_object> aquifers_Fetkovich;
     std::vector<AquiferNumerical<TypeTag>> aquifers_numerical;
 
+    // The cells connected to an analytic aquifer and their water influx for
+    // the solution of the current Newton iteration, which is looked up by
+    // addToSource() during the linearization.
+    std::vector<int> cellToSourceIdx_;
+    std::vector<int> sourceCells_;
+    std::vector<Eval> sources_;
+
     // This initialization function is used to connect the parser objects with the ones needed by AquiferCarterTracy
     void init();
 
+    void initSources_();
+    void updateSourceIntensiveQuantities_() const;
+
+    // the numbers of Carter-Tracy, Fetkovich and numerical aquifers, which a
+    // checkpoint must match
+    std::array<std::uint64_t, 3> numAquifers_() const;
+
     bool aquiferActive() const;
     bool aquiferCarterTracyActive() const;
     bool aquiferFetkovichActive() const;
@@ -55,6 +55,8 @@ BlackoilAquiferModel<TypeTag>::initialSolutionApplied()
             aquifer.initialSolutionApplied();
         }
     }
+
+    initSources_();
 }
 
 template <typename TypeTag>
@@ -90,6 +92,43 @@ template <typename TypeTag>
 void
 BlackoilAquiferModel<TypeTag>::beginIteration()
 {
+    if (sources_.empty()) {
+        return;
+    }
+
+    updateSourceIntensiveQuantities_();
+
+    // The inflow rates of the aquifers are computed concurrently, and then
+    // added to the sources in the same order as by a sequential loop.
+    std::vector<AquiferInterface<TypeTag>*> aquifers;
+    for (auto& aquifer : aquifers_CarterTracy) {
+        aquifers.push_back(&aquifer);
+    }
+    for (auto& aquifer : aquifers_Fetkovich) {
+        aquifers.push_back(&aquifer);
+    }
+    const int numAquifers = aquifers.size();
+    std::vector<std::exception_ptr> exceptions(numAquifers);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (numAquifers > 1)
+#endif
+    for (int aquiferIdx = 0; aquiferIdx < numAquifers; ++aquiferIdx) {
+        try {
+            aquifers[aquiferIdx]->updateInflowRates();
+        } catch (...) {
+            exceptions[aquiferIdx] = std::current_exception();
+        }
+    }
+    for (const auto& exc : exceptions) {
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+    }
+
+    std::fill(sources_.begin(), sources_.end(), 0.0);
+    for (const auto* aquifer : aquifers) {
+        aquifer->addToSources(sources_, cellToSourceIdx_);
+    }
 }
 
 template <typename TypeTag>
@@ -116,16 +155,18 @@ BlackoilAquiferModel<TypeTag>::addToSource(RateVector& rates,
                                            unsigned spaceIdx,
                                            unsigned timeIdx) const
 {
-    if (aquiferCarterTracyActive()) {
-        for (auto& aquifer : aquifers_CarterTracy) {
-            aquifer.addToSource(rates, context, spaceIdx, timeIdx);
-        }
+    if (sources_.empty()) {
+        return;
     }
-    if (aquiferFetkovichActive()) {
-        for (auto& aquifer : aquifers_Fetkovich) {
-            aquifer.addToSource(rates, context, spaceIdx, timeIdx);
-        }
+
+    const unsigned cellIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+    const int idx = cellToSourceIdx_[cellIdx];
+    if (idx < 0) {
+        return;
     }
+
+    rates[Indices::conti0EqIdx + FluidSystem::waterCompIdx]
+        += sources_[idx] / context.dofVolume(spaceIdx, timeIdx);
 }
 
 template <typename TypeTag>
@@ -164,19 +205,50 @@ BlackoilAquiferModel<TypeTag>::endEpisode()
 template <typename TypeTag>
 template <class Restarter>
 void
-BlackoilAquiferModel<TypeTag>::serialize(Restarter& /* res */)
+BlackoilAquiferModel<TypeTag>::serialize(Restarter& res)
 {
-    // TODO (?)
-    throw std::logic_error("BlackoilAquiferModel::serialize() is not yet implemented");
+    res.serializeSectionBegin("BlackoilAquiferModel");
+    auto& os = res.serializeStream();
+    BinaryCheckpoint::write(os, this->numAquifers_());
+    for (const auto& aquifer : aquifers_CarterTracy) {
+        aquifer.writeCheckpoint(os);
+    }
+    for (const auto& aquifer : aquifers_Fetkovich) {
+        aquifer.writeCheckpoint(os);
+    }
+    for (const auto& aquifer : aquifers_numerical) {
+        aquifer.writeCheckpoint(os);
+    }
+    res.serializeSectionEnd();
 }
 
 template <typename TypeTag>
 template <class Restarter>
 void
-BlackoilAquiferModel<TypeTag>::deserialize(Restarter& /* res */)
+BlackoilAquiferModel<TypeTag>::deserialize(Restarter& res)
 {
-    // TODO (?)
-    throw std::logic_error("BlackoilAquiferModel::deserialize() is not yet implemented");
+    // The aquifers are created from the deck in the same order as when the
+    // checkpoint was written.
+    res.deserializeSectionBegin("BlackoilAquiferModel");
+    auto& is = res.deserializeStream();
+    BinaryCheckpoint::readExpected(is, this->numAquifers_(), "aquifers");
+    for (auto& aquifer : aquifers_CarterTracy) {
+        aquifer.readCheckpoint(is);
+    }
+    for (auto& aquifer : aquifers_Fetkovich) {
+        aquifer.readCheckpoint(is);
+    }
+    for (auto& aquifer : aquifers_numerical) {
+        aquifer.readCheckpoint(is);
+    }
+    res.deserializeSectionEnd();
+}
+
+template <typename TypeTag>
+std::array<std::uint64_t, 3>
+BlackoilAquiferModel<TypeTag>::numAquifers_() const
+{
+    return {aquifers_CarterTracy.size(), aquifers_Fetkovich.size(), aquifers_numerical.size()};
 }
 
 // Initialize the aquifers in the deck
@@ -215,6 +287,78 @@ BlackoilAquiferModel<TypeTag>::init()
         }
     }
 }
+// Collect the cells connected to the analytic aquifers
+template <typename TypeTag>
+void
+BlackoilAquiferModel<TypeTag>::initSources_()
+{
+    cellToSourceIdx_.clear();
+    sourceCells_.clear();
+    sources_.clear();
+    if (!aquiferCarterTracyActive() && !aquiferFetkovichActive()) {
+        return;
+    }
+
+    cellToSourceIdx_.resize(simulator_.gridView().size(/*codim=*/0), -1);
+    const auto addCells = [this](const auto& aquifer)
+    {
+        for (const int cellIdx : aquifer.connectedCells()) {
+            if (cellIdx < 0 || cellToSourceIdx_[cellIdx] >= 0) {
+                continue;
+            }
+            cellToSourceIdx_[cellIdx] = sourceCells_.size();
+            sourceCells_.push_back(cellIdx);
+        }
+    };
+    for (const auto& aquifer : aquifers_CarterTracy) {
+        addCells(aquifer);
+    }
+    for (const auto& aquifer : aquifers_Fetkovich) {
+        addCells(aquifer);
+    }
+    sources_.resize(sourceCells_.size(), 0.0);
+}
+
+// Normally the intensive quantities of the connected cells have been cached
+// for the current solution by the Newton update, otherwise evaluate them.
+template <typename TypeTag>
+void
+BlackoilAquiferModel<TypeTag>::updateSourceIntensiveQuantities_() const
+{
+    // If the model does not cache the intensive quantities, the problem keeps
+    // those of the connected cells.
+    const auto& model = simulator_.model();
+    if (!model.storeIntensiveQuantities()) {
+        simulator_.problem().keepIntensiveQuantities(sourceCells_);
+        return;
+    }
+
+    const bool all_cached = std::all_of(sourceCells_.begin(), sourceCells_.end(),
+                                        [&model](const int cellIdx)
+                                        { return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr; });
+    if (all_cached) {
+        return;
+    }
+
+    ElementContext elemCtx(simulator_);
+    const auto& gridView = simulator_.gridView();
+    const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+    for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+         elemIt != elemEndIt;
+         ++elemIt)
+    {
+        const int elemIdx = gridView.indexSet().index(*elemIt);
+        if (cellToSourceIdx_[elemIdx] < 0 ||
+            model.cachedIntensiveQuantities(elemIdx, /*timeIdx=*/0) != nullptr) {
+            continue;
+        }
+        elemCtx.updatePrimaryStencil(*elemIt);
+        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        model.updateCachedIntensiveQuantities(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                              elemIdx, /*timeIdx=*/0);
+    }
+}
+
 template <typename TypeTag>
 bool
 BlackoilAquiferModel<TypeTag>::aquiferCarterTracyActive() const
@@ -235,6 +379,19 @@ BlackoilAquiferModel<TypeTag>::aquiferNumericalActive() const
     return !(this->aquifers_numerical.empty());
 }
 
+template<typename TypeTag>
+std::vector<std::vector<int>> BlackoilAquiferModel<TypeTag>::numericalAquiferChains() const
+{
+    std::vector<std::vector<int>> chains;
+    for (const auto& aqu : this->aquifers_numerical) {
+        auto cells = aqu.chainCells();
+        if (!cells.empty()) {
+            chains.push_back(std::move(cells));
+        }
+    }
+    return chains;
+}
+
 template<typename TypeTag>
 data::Aquifers BlackoilAquiferModel<TypeTag>::aquiferData() const {
     data::Aquifers data;
@@ -26,6 +26,7 @@
 
 #include <ebos/eclproblem.hh>
 #include <opm/models/utils/start.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 
@@ -39,6 +40,9 @@
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/utils/CostAccounting.hpp>
+#include <opm/simulators/utils/ScopedTimers.hpp>
+#include <opm/simulators/utils/sumAndMax.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
@@ -50,7 +54,9 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/simulators/linalg/ISTLSolverEbos.hpp>
+#include <opm/simulators/linalg/SequentialSplitting.hpp>
 
+#include <dune/istl/operators.hh>
 #include <dune/istl/owneroverlapcopy.hh>
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
 #include <dune/common/parallel/communication.hh>
@@ -67,6 +73,7 @@
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <utility>
 
 namespace Opm::Properties {
 
@@ -153,6 +160,7 @@ namespace Opm {
 
         using Simulator = GetPropType<TypeTag, Properties::Simulator>;
         using Grid = GetPropType<TypeTag, Properties::Grid>;
+        using GridView = GetPropType<TypeTag, Properties::GridView>;
         using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
         using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
         using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
@@ -215,6 +223,14 @@ namespace Opm {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
             convergence_reports_.reserve(300); // Often insufficient, but avoids frequent moves.
+            if (param_.sequential_implicit_ && isParallel()) {
+                OPM_THROW(std::runtime_error, "Sequential implicit iterations are only supported in serial runs");
+            }
+            // The pressure and transport stages split the Jacobian matrix
+            // only, the well coupling must therefore be part of the matrix.
+            if (param_.sequential_implicit_ && !param_.matrix_add_well_contributions_) {
+                OPM_THROW(std::runtime_error, "Sequential implicit iterations require --matrix-add-well-contributions=true");
+            }
         }
 
         bool isParallel() const
@@ -230,10 +246,17 @@ namespace Opm {
             SimulatorReportSingle report;
             Dune::Timer perfTimer;
             perfTimer.start();
+            relative_change_valid_ = false;
             // update the solution variables in ebos
+            bool extrapolate = false;
             if ( timer.lastStepFailed() ) {
                 ebosSimulator_.model().updateFailed();
             } else {
+                if (param_.extrapolate_solution_) {
+                    // The last converged step started from solution(1).
+                    previous_solution_ = ebosSimulator_.model().solution(/*timeIdx=*/1);
+                    extrapolate = last_step_length_ > 0.0;
+                }
                 ebosSimulator_.model().advanceTimeLevel();
             }
 
@@ -247,6 +270,13 @@ namespace Opm {
 
             ebosSimulator_.problem().beginTimeStep();
 
+            // After beginTimeStep(), which updates the hysteresis and the other
+            // history dependent quantities with the converged solution.
+            if (extrapolate) {
+                extrapolateSolution_(timer.currentStepLength() / last_step_length_);
+            }
+            last_step_length_ = timer.currentStepLength();
+
             unsigned numDof = ebosSimulator_.model().numGridDof();
             wasSwitched_.resize(numDof);
             std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
@@ -275,6 +305,7 @@ namespace Opm {
                                                  const SimulatorTimerInterface& timer,
                                                  NonlinearSolverType& nonlinear_solver)
         {
+            ScopedTimer iterationTimer("newton iteration");
             SimulatorReportSingle report;
             failureReport_ = SimulatorReportSingle();
             Dune::Timer perfTimer;
@@ -284,6 +315,7 @@ namespace Opm {
                 // For each iteration we store in a vector the norms of the residual of
                 // the mass balance for each active phase, the well flux and the well equations.
                 residual_norms_history_.clear();
+                convergence_distance_history_.clear();
                 current_relaxation_ = 1.0;
                 dx_old_ = 0.0;
                 convergence_reports_.push_back({timer.reportStepNum(), timer.currentStepNum(), {}});
@@ -293,6 +325,7 @@ namespace Opm {
             report.total_linearizations = 1;
 
             try {
+                ScopedTimer assemblyTimer("assembly");
                 report += assembleReservoir(timer, iteration);
                 report.assemble_time += perfTimer.stop();
             }
@@ -308,6 +341,7 @@ namespace Opm {
             perfTimer.start();
             // the step is not considered converged until at least minIter iterations is done
             {
+                ScopedTimer convergenceTimer("convergence");
                 auto convrep = getConvergence(timer, iteration,residual_norms);
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
@@ -322,6 +356,18 @@ namespace Opm {
             }
             report.update_time += perfTimer.stop();
             residual_norms_history_.push_back(residual_norms);
+            convergence_distance_history_.push_back(convergence_distance_);
+
+            if (!report.converged && param_.abort_hopeless_newton_
+                && newtonIsHopeless_(iteration, nonlinear_solver.maxIter())) {
+                failureReport_ += report;
+                const std::string msg = "Solver convergence failure - Newton iterations will not converge within "
+                    + std::to_string(nonlinear_solver.maxIter()) + " iterations.";
+                if (terminal_output_) {
+                    OpmLog::debug(msg);
+                }
+                OPM_THROW_NOLOG(TooManyIterations, msg);
+            }
             if (!report.converged) {
                 perfTimer.reset();
                 perfTimer.start();
@@ -336,21 +382,50 @@ namespace Opm {
 
                 // apply the Schur compliment of the well model to the reservoir linearized
                 // equations
-                wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
-                                      ebosSimulator().model().linearizer().residual());
+                {
+                    ScopedTimer wellTimer("well linearization");
+                    wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
+                                          ebosSimulator().model().linearizer().residual());
+                }
 
                 // Solve the linear system.
+                auto& linearSolver = ebosSimulator_.model().newtonMethod().linearSolver();
+                linearSolver.setAdaptiveReduction(forcingTerm_(iteration));
+                linearSolver.setReusePreconditioner(reusePreconditioner_(iteration));
                 linear_solve_setup_time_ = 0.0;
+                // The sequential implicit iterations alternate between the
+                // pressure and the transport stage, starting with the pressure.
+                const bool pressureStage = param_.sequential_implicit_ && iteration % 2 == 0;
+                const bool transportStage = param_.sequential_implicit_ && !pressureStage;
+                const bool warmStart = param_.linear_solver_warm_start_ && iteration == 0
+                    && !param_.sequential_implicit_ && warmStartGuess_(x);
+                linearSolver.setUseInitialGuess(warmStart);
                 try {
-                    solveJacobianSystem(x);
+                    ScopedTimer solveTimer("linear solve");
+                    if (pressureStage) {
+                        report.total_linear_iterations += solvePressureStage_(x);
+                    } else {
+                        if (transportStage) {
+                            restrictToTransport_();
+                        }
+                        solveJacobianSystem(x, warmStart);
+                        report.total_linear_iterations += linearIterationsLastSolve();
+                    }
+                    if (param_.linear_solver_warm_start_ && iteration == 0 && !param_.sequential_implicit_) {
+                        storeFirstUpdate_(x);
+                    }
                     report.linear_solve_setup_time += linear_solve_setup_time_;
-                    report.linear_solve_time += perfTimer.stop();
-                    report.total_linear_iterations += linearIterationsLastSolve();
+                    const double solveTime = perfTimer.stop();
+                    report.linear_solve_time += solveTime;
+                    report.pressure_time += pressureStage ? solveTime : 0.0;
+                    report.transport_time += transportStage ? solveTime : 0.0;
                 }
                 catch (...) {
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
-                    report.total_linear_iterations += linearIterationsLastSolve();
+                    if (!pressureStage) {
+                        report.total_linear_iterations += linearIterationsLastSolve();
+                    }
 
                     failureReport_ += report;
                     throw; // re-throw up
@@ -358,6 +433,7 @@ namespace Opm {
 
                 perfTimer.reset();
                 perfTimer.start();
+                ScopedTimer updateTimer("update");
 
                 // handling well state update before oscillation treatment is a decision based
                 // on observation to avoid some big performance degeneration under some circumstances.
@@ -433,73 +509,21 @@ namespace Opm {
             Scalar resultDelta = 0.0;
             Scalar resultDenom = 0.0;
 
-            const auto& elemMapper = ebosSimulator_.model().elementMapper();
             const auto& gridView = ebosSimulator_.gridView();
-            auto elemIt = gridView.template begin</*codim=*/0>();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const auto& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
-
-                unsigned globalElemIdx = elemMapper.index(elem);
-                const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
-
-                Scalar pressureNew;
-                pressureNew = priVarsNew[Indices::pressureSwitchIdx];
-
-                Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationNew = 1.0;
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                    saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
-                }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
-                    saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
-                }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                    saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
-                }
-
-                const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
-
-                Scalar pressureOld;
-                pressureOld = priVarsOld[Indices::pressureSwitchIdx];
-
-                Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationOld = 1.0;
-
-                // NB fix me! adding pressures changes to satutation changes does not make sense
-                Scalar tmp = pressureNew - pressureOld;
-                resultDelta += tmp*tmp;
-                resultDenom += pressureNew*pressureNew;
-
-                if (FluidSystem::numActivePhases() > 1) {
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                        saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
-                    }
-
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) &&
-                        priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
-                    {
-                        saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
-                    }
+            if (relative_change_valid_) {
+                // Measured by the last update of the solution.
+                resultDelta = relative_change_delta_;
+                resultDenom = relative_change_denom_;
+            } else {
+                const auto& elemMapper = ebosSimulator_.model().elementMapper();
+                for (const auto& elem : elements(gridView)) {
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue;
 
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                        saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
-                    }
-                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
-                        Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
-                        resultDelta += tmpSat*tmpSat;
-                        resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
-                        assert(std::isfinite(resultDelta));
-                        assert(std::isfinite(resultDenom));
-                    }
+                    const unsigned globalElemIdx = elemMapper.index(elem);
+                    addRelativeChange_(ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx],
+                                       ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx],
+                                       resultDelta, resultDenom);
                 }
             }
 
@@ -520,19 +544,26 @@ namespace Opm {
 
         /// Solve the Jacobian system Jx = r where J is the Jacobian and
         /// r is the residual.
-        void solveJacobianSystem(BVector& x)
+        /// \param[in, out] x            the solution
+        /// \param[in] useInitialGuess   start from the values of x instead of zero
+        void solveJacobianSystem(BVector& x, const bool useInitialGuess = false)
         {
 
             auto& ebosJac = ebosSimulator_.model().linearizer().jacobian();
             auto& ebosResid = ebosSimulator_.model().linearizer().residual();
 
             // set initial guess
-            x = 0.0;
+            if (!useInitialGuess) {
+                x = 0.0;
+            }
 
             auto& ebosSolver = ebosSimulator_.model().newtonMethod().linearSolver();
             Dune::Timer perfTimer;
             perfTimer.start();
-            ebosSolver.prepare(ebosJac, ebosResid);
+            {
+                ScopedTimer setupTimer("setup");
+                ebosSolver.prepare(ebosJac, ebosResid);
+            }
             linear_solve_setup_time_ = perfTimer.stop();
             ebosSolver.setResidual(ebosResid);
             // actually, the error needs to be calculated after setResidual in order to
@@ -540,14 +571,70 @@ namespace Opm {
             // discretizations does not need to be synchronized across processes to be
             // consistent, this is not relevant for OPM-flow...
             ebosSolver.setMatrix(ebosJac);
+            ScopedTimer iterationsTimer("iterations");
             ebosSolver.solve(x);
        }
 
 
 
+        /// Linear solve of the pressure stage of a sequential implicit
+        /// iteration. Returns the number of linear iterations.
+        int solvePressureStage_(BVector& x)
+        {
+            const auto& jacobian = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            const auto& residual = ebosSimulator_.model().linearizer().residual();
+            const int pressureIdx = Indices::pressureSwitchIdx;
+
+            Dune::Timer perfTimer;
+            perfTimer.start();
+            const auto weights = Amg::getQuasiImpesWeights<Mat, BVector>(jacobian, pressureIdx, /*transpose=*/false);
+            SequentialSplitting::assemblePressureSystem(jacobian, residual, weights, pressureIdx,
+                                                        pressure_matrix_, pressure_residual_);
+            PressureOperator op(pressure_matrix_);
+            boost::property_tree::ptree prm;
+            prm.put("solver", "bicgstab");
+            // Tighter than a CPR coarse solve, there is no smoothing afterwards.
+            prm.put("tol", 1e-3);
+            prm.put("maxiter", 200);
+            prm.put("preconditioner.type", "amg");
+            PressureSolver solver(op, prm);
+            linear_solve_setup_time_ = perfTimer.stop();
+
+            PressureVector dp(pressure_residual_.size());
+            dp = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(dp, pressure_residual_, result);
+            if (!result.converged) {
+                OPM_THROW_NOLOG(NumericalIssue, "Convergence failure for the linear solver of the pressure stage.");
+            }
+
+            x = 0.0;
+            for (std::size_t cell = 0; cell < x.size(); ++cell) {
+                x[cell][pressureIdx] = dp[cell][0];
+            }
+            return result.iterations;
+        }
+
+        /// Turn the Jacobian system into the one of the transport stage of
+        /// a sequential implicit iteration.
+        void restrictToTransport_()
+        {
+            auto& jacobian = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            auto& residual = ebosSimulator_.model().linearizer().residual();
+            const int pressureIdx = Indices::pressureSwitchIdx;
+            const auto weights = Amg::getQuasiImpesWeights<Mat, BVector>(jacobian, pressureIdx, /*transpose=*/false);
+            SequentialSplitting::restrictToTransport(jacobian, residual, weights, pressureIdx);
+        }
+
         /// Apply an update to the primary variables.
         void updateSolution(const BVector& dx)
         {
+            if (param_.localized_newton_tolerance_ > 0.0) {
+                updateSolutionLocalized_(dx);
+                relative_change_valid_ = false;
+                return;
+            }
+
             auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
             SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
 
@@ -558,8 +645,37 @@ namespace Opm {
                                                     // oil model do not care about the
                                                     // residual
 
-            // if the solution is updated, the intensive quantities need to be recalculated
-            ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+            // if the solution is updated, the intensive quantities need to be
+            // recalculated. The same pass measures the relative change of the
+            // solution for the time step control, which then does not need a
+            // sweep of its own if this was the last update of the step.
+            auto& ebosModel = ebosSimulator_.model();
+            const auto& elemMapper = ebosModel.elementMapper();
+            const SolutionVector& oldSolution = ebosModel.solution(/*timeIdx=*/1);
+            Scalar resultDelta = 0.0;
+            Scalar resultDenom = 0.0;
+            ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(ebosSimulator_.gridView());
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:resultDelta, resultDenom)
+#endif
+            {
+                ElementContext elemCtx(ebosSimulator_);
+                auto elemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const auto& elem = *elemIt;
+                    const unsigned cellIdx = elemMapper.index(elem);
+                    ebosModel.invalidateIntensiveQuantitiesCacheEntry(cellIdx, /*timeIdx=*/0);
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+
+                    if (elem.partitionType() == Dune::InteriorEntity) {
+                        addRelativeChange_(solution[cellIdx], oldSolution[cellIdx], resultDelta, resultDenom);
+                    }
+                }
+            }
+            relative_change_delta_ = resultDelta;
+            relative_change_denom_ = resultDenom;
+            relative_change_valid_ = true;
         }
 
         /// Return true if output to cout is wanted.
@@ -581,8 +697,8 @@ namespace Opm {
             if( comm.size() > 1 )
             {
                 // global reduction
-                std::vector< Scalar > sumBuffer;
-                std::vector< Scalar > maxBuffer;
+                std::vector< double > sumBuffer;
+                std::vector< double > maxBuffer;
                 const int numComp = B_avg.size();
                 sumBuffer.reserve( 2*numComp + 1 ); // +1 for pvSum
                 maxBuffer.reserve( numComp );
@@ -596,11 +712,8 @@ namespace Opm {
                 // Compute total pore volume
                 sumBuffer.push_back( pvSum );
 
-                // compute global sum
-                comm.sum( sumBuffer.data(), sumBuffer.size() );
-
-                // compute global max
-                comm.max( maxBuffer.data(), maxBuffer.size() );
+                // compute global sum and max in one collective
+                sumAndMax( comm, sumBuffer, maxBuffer );
 
                 // restore values to local variables
                 for( int compIdx = 0, buffIdx = 0; compIdx < numComp; ++compIdx, ++buffIdx )
@@ -635,23 +748,30 @@ namespace Opm {
 
             const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
 
-            ElementContext elemCtx(ebosSimulator_);
+            // The intensive quantities are up to date after the linearization,
+            // the cached ones are used instead of evaluating them again unless
+            // the model does not cache them. The pore volumes are kept for
+            // computeCnvErrorPv().
+            const auto& elemMapper = ebosModel.elementMapper();
             const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            interior_pore_volumes_.clear();
+            ElementContext elemCtx(ebosSimulator_);
 
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
+            for (const auto& elem : elements(gridView, Dune::Partitions::interior))
             {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                const unsigned cell_idx = elemMapper.index(elem);
+                const auto* intQuantsPtr = ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0);
+                if (!intQuantsPtr) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    intQuantsPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
+                const auto& intQuants = *intQuantsPtr;
                 const auto& fs = intQuants.fluidState();
 
                 const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
                 pvSumLocal += pvValue;
+                interior_pore_volumes_.emplace_back(cell_idx, pvValue);
 
                 for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
                 {
@@ -730,21 +850,15 @@ namespace Opm {
             return pvSumLocal;
         }
 
+        // Uses the pore volumes of the interior cells stored by localConvergenceData().
         double computeCnvErrorPv(const std::vector<Scalar>& B_avg, double dt)
         {
             double errorPV{};
-            const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
             const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
-            const auto& gridView = ebosSimulator().gridView();
-            ElementContext elemCtx(ebosSimulator_);
+            auto& costs = CostAccounting::instance();
 
-            for (const auto& elem: elements(gridView, Dune::Partitions::interiorBorder))
+            for (const auto& [cell_idx, pvValue] : interior_pore_volumes_)
             {
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
                 const auto& cellResidual = ebosResid[cell_idx];
                 bool cnvViolated = false;
 
@@ -758,6 +872,9 @@ namespace Opm {
                 if (cnvViolated)
                 {
                     errorPV += pvValue;
+                    if (costs.enabled()) {
+                        costs.addCellIteration(cell_idx);
+                    }
                 }
             }
 
@@ -794,11 +911,15 @@ namespace Opm {
             // Finish computation
             std::vector<Scalar> CNV(numComp);
             std::vector<Scalar> mass_balance_residual(numComp);
+            convergence_distance_ = 0.0;
             for ( int compIdx = 0; compIdx < numComp; ++compIdx )
             {
                 CNV[compIdx]                    = B_avg[compIdx] * dt * maxCoeff[compIdx];
                 mass_balance_residual[compIdx]  = std::abs(B_avg[compIdx]*R_sum[compIdx]) * dt / pvSum;
                 residual_norms.push_back(CNV[compIdx]);
+                convergence_distance_ = std::max({convergence_distance_,
+                                                  double(CNV[compIdx] / tol_cnv),
+                                                  double(mass_balance_residual[compIdx] / tol_mb)});
             }
 
             // Setup component names, only the first time the function is run.
@@ -993,9 +1114,46 @@ namespace Opm {
         long int global_nc_;
 
         std::vector<std::vector<double>> residual_norms_history_;
+        // Largest reservoir residual relative to its tolerance, of the last
+        // convergence check and of every iteration of the current step.
+        double convergence_distance_ = 0.0;
+        std::vector<double> convergence_distance_history_;
+        // Sums of relativeChange() of the interior cells on this process,
+        // measured by the last update of the solution in the current step.
+        Scalar relative_change_delta_ = 0.0;
+        Scalar relative_change_denom_ = 0.0;
+        bool relative_change_valid_ = false;
+
+        using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+        using PressureVector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+        using PressureOperator = Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector>;
+        using PressureSolver = Dune::FlexibleSolver<PressureMatrix, PressureVector>;
+        // Pressure system of the sequential implicit iterations, the
+        // sparsity pattern is kept between the iterations.
+        PressureMatrix pressure_matrix_;
+        PressureVector pressure_residual_;
+
         double current_relaxation_;
         BVector dx_old_;
 
+        // Index and pore volume of the interior cells, from the last convergence check.
+        std::vector<std::pair<unsigned, double>> interior_pore_volumes_;
+
+        // Solution at the beginning of the last converged time step and the length
+        // of that step, used to extrapolate the initial guess of the next step.
+        SolutionVector previous_solution_;
+        double last_step_length_ = 0.0;
+
+        // Linear solver reduction of the last Newton iteration, see forcingTerm_().
+        double forcing_term_ = 0.0;
+
+        // Update of the first Newton iteration of the last time step, the
+        // meaning of the primary variables it was computed for and the length
+        // of that step, only used with --linear-solver-warm-start=true.
+        BVector first_update_;
+        std::vector<typename PrimaryVariables::PrimaryVarsMeaning> first_update_meaning_;
+        double first_update_step_length_ = 0.0;
+
         std::vector<StepReport> convergence_reports_;
     public:
         /// return the StandardWells object
@@ -1021,6 +1179,288 @@ namespace Opm {
         double dsMax() const { return param_.ds_max_; }
         double drMaxRel() const { return param_.dr_max_rel_; }
         double maxResidualAllowed() const { return param_.max_residual_allowed_; }
+
+        /// Whether the Newton method is predicted to not converge within
+        /// maxIter iterations. The rate of convergence is the geometric mean
+        /// over the last three iterations of the reduction of the largest
+        /// reservoir residual relative to its tolerance. The prediction
+        /// assumes linear convergence, which overestimates the iterations of
+        /// a Newton method close to the solution, and still needs twice the
+        /// remaining iterations before it gives up.
+        bool newtonIsHopeless_(const int iteration, const int maxIter) const
+        {
+            const int window = 3;
+            const auto& distance = convergence_distance_history_;
+            if (iteration < window || distance.size() <= static_cast<std::size_t>(window))
+                return false;
+
+            const double current = distance.back();
+            const double start = distance[distance.size() - 1 - window];
+            // The reservoir equations are converged, the wells are not.
+            if (!(current > 1.0) || !(start > 0.0))
+                return false;
+
+            const double rate = std::pow(current / start, 1.0 / window);
+            if (rate >= 1.0)
+                return true;
+
+            const double needed = std::log(current) / -std::log(rate);
+            return needed > 2.0 * (maxIter - iteration);
+        }
+
+        static double maxResidualNorm_(const std::vector<double>& norms)
+        {
+            return norms.empty() ? 0.0 : *std::max_element(norms.begin(), norms.end());
+        }
+
+        /// Whether the linear solve of this Newton iteration may keep the
+        /// preconditioner of the previous iteration, i.e. if the last
+        /// iteration reduced the largest CNV residual at least by the
+        /// preconditioner reuse contraction. The Krylov solver still uses the
+        /// new Jacobian, only the preconditioner is built from an older one.
+        bool reusePreconditioner_(const int iteration) const
+        {
+            const double maxContraction = param_.preconditioner_reuse_contraction_;
+            if (maxContraction <= 0.0 || iteration == 0 || residual_norms_history_.size() < 2)
+                return false;
+
+            const double norm = maxResidualNorm_(residual_norms_history_.back());
+            const double prevNorm = maxResidualNorm_(residual_norms_history_[residual_norms_history_.size() - 2]);
+            return prevNorm > 0.0 && norm <= maxContraction * prevNorm;
+        }
+
+        /// Linear solver reduction for this Newton iteration, zero for the
+        /// configured reduction. The Eisenstat-Walker forcing term (choice 2,
+        /// gamma = 0.9, alpha = 2) from the largest CNV residual of this and
+        /// the previous iteration, limited by the maximum adaptive reduction.
+        /// It is not made smaller than needed to reduce the CNV residual to
+        /// half the CNV tolerance.
+        double forcingTerm_(const int iteration)
+        {
+            const double maxForcingTerm = param_.max_adaptive_linear_reduction_;
+            if (maxForcingTerm <= 0.0)
+                return 0.0;
+
+            const double norm = maxResidualNorm_(residual_norms_history_.back());
+            if (!(norm > 0.0))
+                return 0.0;
+
+            const double gamma = 0.9;
+            const double alpha = 2.0;
+            double eta = maxForcingTerm;
+            if (iteration > 0 && residual_norms_history_.size() > 1) {
+                const double prevNorm = maxResidualNorm_(residual_norms_history_[residual_norms_history_.size() - 2]);
+                if (prevNorm > 0.0) {
+                    eta = gamma * std::pow(norm / prevNorm, alpha);
+                    // Safeguard against a forcing term decreasing faster than the residual.
+                    const double safeguard = gamma * std::pow(forcing_term_, alpha);
+                    if (safeguard > 0.1)
+                        eta = std::max(eta, safeguard);
+                }
+            }
+            eta = std::max(eta, 0.5 * param_.tolerance_cnv_ / norm);
+            forcing_term_ = std::min(eta, maxForcingTerm);
+            return forcing_term_;
+        }
+
+        /// Set x to the first update of the last time step, scaled by the ratio
+        /// of the step lengths, as initial guess of the linear solve of the
+        /// first Newton iteration. The cells whose primary variables have
+        /// been switched since then start from zero. Returns false if there
+        /// is no such update.
+        bool warmStartGuess_(BVector& x) const
+        {
+            if (first_update_.size() != x.size() || !(first_update_step_length_ > 0.0))
+                return false;
+
+            const double factor = ebosSimulator_.timeStepSize() / first_update_step_length_;
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            for (std::size_t cellIdx = 0; cellIdx < x.size(); ++cellIdx) {
+                if (solution[cellIdx].primaryVarsMeaning() != first_update_meaning_[cellIdx]) {
+                    x[cellIdx] = 0.0;
+                    continue;
+                }
+                x[cellIdx] = first_update_[cellIdx];
+                x[cellIdx] *= factor;
+            }
+            return true;
+        }
+
+        /// Keep the update x of the first Newton iteration for the warm start
+        /// of the next time step.
+        void storeFirstUpdate_(const BVector& x)
+        {
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            first_update_ = x;
+            first_update_meaning_.resize(solution.size());
+            for (std::size_t cellIdx = 0; cellIdx < solution.size(); ++cellIdx) {
+                first_update_meaning_[cellIdx] = solution[cellIdx].primaryVarsMeaning();
+            }
+            first_update_step_length_ = ebosSimulator_.timeStepSize();
+        }
+
+        /// Extrapolate the primary variables linearly in time, using the
+        /// solution at the beginning of the last step, factor is the ratio of
+        /// the new and the last step length. The changes are limited like the
+        /// Newton updates. Cells whose primary variables were switched during
+        /// the last step, or which would get a negative saturation or ratio,
+        /// keep the converged solution.
+        void extrapolateSolution_(const double factor)
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            SolutionVector& solution = ebosModel.solution(/*timeIdx=*/0);
+
+            for (std::size_t cellIdx = 0; cellIdx < solution.size(); ++cellIdx) {
+                const auto& priVarsOld = previous_solution_[cellIdx];
+                auto priVars = solution[cellIdx];
+                if (priVars.primaryVarsMeaning() != priVarsOld.primaryVarsMeaning())
+                    continue;
+
+                const Scalar p = priVars[Indices::pressureSwitchIdx];
+                const Scalar dpMax = dpMaxRel() * std::abs(p);
+                const Scalar dp = factor * (p - priVarsOld[Indices::pressureSwitchIdx]);
+                priVars[Indices::pressureSwitchIdx] = p + std::clamp(dp, -dpMax, dpMax);
+
+                bool valid = true;
+                Scalar so = 1.0;
+                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && FluidSystem::numActivePhases() > 1) {
+                    const Scalar sw = priVars[Indices::waterSaturationIdx];
+                    const Scalar dsw = factor * (sw - priVarsOld[Indices::waterSaturationIdx]);
+                    priVars[Indices::waterSaturationIdx] = sw + std::clamp(dsw, -dsMax(), dsMax());
+                    so -= priVars[Indices::waterSaturationIdx];
+                    valid = valid && priVars[Indices::waterSaturationIdx] >= 0.0;
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    const Scalar x = priVars[Indices::compositionSwitchIdx];
+                    const Scalar dx = factor * (x - priVarsOld[Indices::compositionSwitchIdx]);
+                    if (priVars.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                        priVars[Indices::compositionSwitchIdx] = x + std::clamp(dx, -dsMax(), dsMax());
+                        so -= priVars[Indices::compositionSwitchIdx];
+                    }
+                    else {
+                        const Scalar drMax = drMaxRel() * std::abs(x);
+                        priVars[Indices::compositionSwitchIdx] = x + std::clamp(dx, -drMax, drMax);
+                    }
+                    valid = valid && priVars[Indices::compositionSwitchIdx] >= 0.0;
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    valid = valid && so >= 0.0;
+                }
+
+                if (valid)
+                    solution[cellIdx] = priVars;
+            }
+
+            ebosModel.invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+        }
+
+        // Add the contribution of a cell to the sums of relativeChange().
+        static void addRelativeChange_(const PrimaryVariables& priVarsNew,
+                                       const PrimaryVariables& priVarsOld,
+                                       Scalar& resultDelta,
+                                       Scalar& resultDenom)
+        {
+            Scalar pressureNew;
+            pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+
+            Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
+            Scalar oilSaturationNew = 1.0;
+            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
+                oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
+            }
+
+            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
+                oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
+            }
+
+            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
+            }
+
+            Scalar pressureOld;
+            pressureOld = priVarsOld[Indices::pressureSwitchIdx];
+
+            Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
+            Scalar oilSaturationOld = 1.0;
+
+            // NB fix me! adding pressures changes to satutation changes does not make sense
+            Scalar tmp = pressureNew - pressureOld;
+            resultDelta += tmp*tmp;
+            resultDenom += pressureNew*pressureNew;
+
+            if (FluidSystem::numActivePhases() > 1) {
+                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
+                    oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) &&
+                    priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
+                {
+                    saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
+                    oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
+                }
+                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
+                    Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
+                    resultDelta += tmpSat*tmpSat;
+                    resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
+                    assert(std::isfinite(resultDelta));
+                    assert(std::isfinite(resultDenom));
+                }
+            }
+        }
+
+        /// Apply an update to the primary variables, dropping the updates of
+        /// the cells which change by less than the localized Newton tolerance.
+        /// Only the cells whose primary variables change get new intensive
+        /// quantities, the others keep the cached ones.
+        void updateSolutionLocalized_(const BVector& dx)
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            SolutionVector& solution = ebosModel.solution(/*timeIdx=*/0);
+            const SolutionVector oldSolution = solution;
+
+            const double tol = param_.localized_newton_tolerance_;
+            BVector localDx = dx;
+            for (std::size_t cellIdx = 0; cellIdx < localDx.size(); ++cellIdx) {
+                bool smallUpdate = true;
+                for (std::size_t pvIdx = 0; pvIdx < localDx[cellIdx].size(); ++pvIdx) {
+                    const double scale = std::max(1.0, std::abs(double(oldSolution[cellIdx][pvIdx])));
+                    smallUpdate = smallUpdate && std::abs(localDx[cellIdx][pvIdx]) <= tol*scale;
+                }
+                if (smallUpdate)
+                    localDx[cellIdx] = 0.0;
+            }
+
+            ebosModel.newtonMethod().update_(/*nextSolution=*/solution,
+                                             /*curSolution=*/solution,
+                                             /*update=*/localDx,
+                                             /*resid=*/localDx);
+
+            // Compare the solutions rather than the updates, the primary
+            // variables of a cell may be switched without an update.
+            const auto& elemMapper = ebosModel.elementMapper();
+            ElementContext elemCtx(ebosSimulator_);
+            for (const auto& elem : elements(ebosSimulator_.gridView())) {
+                const unsigned cellIdx = elemMapper.index(elem);
+                if (solution[cellIdx] == oldSolution[cellIdx]
+                    && solution[cellIdx].primaryVarsMeaning() == oldSolution[cellIdx].primaryVarsMeaning())
+                    continue;
+
+                ebosModel.invalidateIntensiveQuantitiesCacheEntry(cellIdx, /*timeIdx=*/0);
+                elemCtx.updatePrimaryStencil(elem);
+                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            }
+        }
+
         double linear_solve_setup_time_;
     public:
         std::vector<bool> wasSwitched_;
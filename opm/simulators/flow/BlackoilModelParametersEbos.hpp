@@ -100,6 +100,34 @@ struct UseUpdateStabilization {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct LocalizedNewtonTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ExtrapolateSolution {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct MaxAdaptiveLinearReduction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct PreconditionerReuseContraction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverWarmStart {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AbortHopelessNewton {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialImplicit {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct MatrixAddWellContributions {
     using type = UndefinedProperty;
 };
@@ -150,6 +178,22 @@ struct MaxInnerIterWells {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct SkipInnerIterPressureChange {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellConnectionPressureTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellTestStepInterval {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct NetworkMaxNewtonIterations {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct AlternativeWellRateInit {
     using type = UndefinedProperty;
 };
@@ -229,6 +273,37 @@ struct UseUpdateStabilization<TypeTag, TTag::FlowModelParameters> {
     static constexpr bool value = true;
 };
 template<class TypeTag>
+struct LocalizedNewtonTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct ExtrapolateSolution<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct MaxAdaptiveLinearReduction<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct PreconditionerReuseContraction<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct LinearSolverWarmStart<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct AbortHopelessNewton<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct SequentialImplicit<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
 struct MatrixAddWellContributions<TypeTag, TTag::FlowModelParameters> {
     static constexpr bool value = false;
 };
@@ -259,6 +334,24 @@ struct MaxInnerIterWells<TypeTag, TTag::FlowModelParameters> {
     static constexpr int value = 50;
 };
 template<class TypeTag>
+struct SkipInnerIterPressureChange<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct WellConnectionPressureTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct WellTestStepInterval<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 1;
+};
+template<class TypeTag>
+struct NetworkMaxNewtonIterations<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 20;
+};
+template<class TypeTag>
 struct AlternativeWellRateInit<TypeTag, TTag::FlowModelParameters> {
     static constexpr bool value = true;
 };
@@ -355,6 +448,22 @@ namespace Opm
         /// Maximum inner iteration number for standard wells
         int max_inner_iter_wells_;
 
+        /// Maximum change of the connection cell pressures for which the inner
+        /// iterations of an already converged well are skipped, 0 disables skipping
+        double skip_inner_iter_pressure_change_;
+
+        /// Relative change of the perforation pressures and rates of a standard
+        /// well below which its connection densities and pressure differences
+        /// are reused, 0 only reuses them for unchanged inputs
+        double well_connection_pressure_tolerance_;
+
+        /// Number of time steps between the evaluations of the WTEST well tests
+        int well_test_step_interval_;
+
+        /// Maximum number of Newton iterations for the network node pressures,
+        /// 0 computes them in a single pass from the current rates
+        int network_max_newton_iterations_;
+
         /// Maximum iteration number of the well equation solution
         int max_welleq_iter_;
 
@@ -368,12 +477,48 @@ namespace Opm
         /// Solve well equation initially
         bool solve_welleq_initially_;
 
+        /// Check the operability of the producers under BHP and THP control
+        bool check_well_operability_;
+
         /// Update scaling factors for mass balance equations
         bool update_equations_scaling_;
 
         /// Try to detect oscillation or stagnation.
         bool use_update_stabilization_;
 
+        /// Newton updates of a cell smaller than this tolerance times
+        /// max(1, |x|) in all primary variables are dropped, and the
+        /// intensive quantities of the cell are not recomputed. Zero disables it.
+        double localized_newton_tolerance_;
+
+        /// Start the Newton method of a time step from the solution extrapolated
+        /// linearly in time from the last two converged steps.
+        bool extrapolate_solution_;
+
+        /// Largest residual reduction required from the linear solver when the
+        /// reduction is adapted to the convergence of the Newton method with
+        /// the Eisenstat-Walker forcing terms. Zero disables the adaptation.
+        double max_adaptive_linear_reduction_;
+
+        /// The linear solver keeps the preconditioner of the previous Newton
+        /// iteration if the largest CNV residual was reduced at least by this
+        /// factor in that iteration. Zero disables it.
+        double preconditioner_reuse_contraction_;
+
+        /// Start the linear solve of the first Newton iteration of a time step
+        /// from the first update of the previous step, scaled by the ratio of
+        /// the step lengths, instead of from zero.
+        bool linear_solver_warm_start_;
+
+        /// Give up a time step before the maximum number of Newton iterations
+        /// if the residuals say that it will not converge in time.
+        bool abort_hopeless_newton_;
+
+        /// Alternate between Newton iterations for the pressure alone and
+        /// for the other primary variables at fixed pressure, instead of
+        /// fully implicit iterations.
+        bool sequential_implicit_;
+
         /// Whether to use MultisegmentWell to handle multisegment wells
         /// it is something temporary before the multisegment well model is considered to be
         /// well developed and tested.
@@ -411,11 +556,23 @@ namespace Opm
             regularization_factor_ms_wells_ = EWOMS_GET_PARAM(TypeTag, Scalar, RegularizationFactorMsw);
             use_inner_iterations_wells_ = EWOMS_GET_PARAM(TypeTag, bool, UseInnerIterationsWells);
             max_inner_iter_wells_ = EWOMS_GET_PARAM(TypeTag, int, MaxInnerIterWells);
+            skip_inner_iter_pressure_change_ = EWOMS_GET_PARAM(TypeTag, Scalar, SkipInnerIterPressureChange);
+            well_connection_pressure_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, WellConnectionPressureTolerance);
+            well_test_step_interval_ = EWOMS_GET_PARAM(TypeTag, int, WellTestStepInterval);
+            network_max_newton_iterations_ = EWOMS_GET_PARAM(TypeTag, int, NetworkMaxNewtonIterations);
             maxSinglePrecisionTimeStep_ = EWOMS_GET_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays) *24*60*60;
             max_strict_iter_ = EWOMS_GET_PARAM(TypeTag, int, MaxStrictIter);
             solve_welleq_initially_ = EWOMS_GET_PARAM(TypeTag, bool, SolveWelleqInitially);
+            check_well_operability_ = EWOMS_GET_PARAM(TypeTag, bool, EnableWellOperabilityCheck);
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
+            localized_newton_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedNewtonTolerance);
+            extrapolate_solution_ = EWOMS_GET_PARAM(TypeTag, bool, ExtrapolateSolution);
+            max_adaptive_linear_reduction_ = EWOMS_GET_PARAM(TypeTag, Scalar, MaxAdaptiveLinearReduction);
+            preconditioner_reuse_contraction_ = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerReuseContraction);
+            linear_solver_warm_start_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverWarmStart);
+            abort_hopeless_newton_ = EWOMS_GET_PARAM(TypeTag, bool, AbortHopelessNewton);
+            sequential_implicit_ = EWOMS_GET_PARAM(TypeTag, bool, SequentialImplicit);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
@@ -444,6 +601,10 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, int, StrictInnerIterMsWells, "Number of inner iterations for multi-segment wells with strict tolerance");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseInnerIterationsWells, "Use nested iterations for standard wells");
             EWOMS_REGISTER_PARAM(TypeTag, int, MaxInnerIterWells, "Maximum number of inner iterations for standard wells");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, SkipInnerIterPressureChange, "Skip the inner iterations of a well whose previous inner iterations converged, while its control is unchanged and no connection cell pressure has changed by more than this value (in Pascal). Zero means never skip");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, WellConnectionPressureTolerance, "Reuse the connection densities and pressure differences of a standard well while the bottom-hole pressure, the perforation pressures and the well and perforation rates changed by less than this relative tolerance. Zero reuses them only if these are unchanged");
+            EWOMS_REGISTER_PARAM(TypeTag, int, WellTestStepInterval, "Number of time steps between the evaluations of the WTEST well tests. The wells that become due for testing in between are tested together at the next evaluation");
+            EWOMS_REGISTER_PARAM(TypeTag, int, NetworkMaxNewtonIterations, "Maximum number of Newton iterations for the network node pressures, with the rates of the wells at THP control estimated from their inflow performance. Zero computes the node pressures in a single pass from the current rates");
             EWOMS_REGISTER_PARAM(TypeTag, bool, AlternativeWellRateInit, "Use alternative well rate initialization procedure");
             EWOMS_REGISTER_PARAM(TypeTag, Scalar, RegularizationFactorMsw, "Regularization factor for ms wells");
             EWOMS_REGISTER_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays, "Maximum time step size where single precision floating point arithmetic can be used solving for the linear systems of equations");
@@ -451,6 +612,13 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, SolveWelleqInitially, "Fully solve the well equations before each iteration of the reservoir model");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UpdateEquationsScaling, "Update scaling factors for mass balance equations during the run");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedNewtonTolerance, "Drop the Newton updates of the cells which change by less than this tolerance (relative, or absolute below one) and skip their intensive quantities update. Zero disables it");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ExtrapolateSolution, "Start the Newton method of a time step from the solution extrapolated linearly in time from the last two converged time steps");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, MaxAdaptiveLinearReduction, "Adapt the linear solver reduction to the convergence of the Newton method (Eisenstat-Walker forcing terms), between --linear-solver-reduction and this value. Zero disables it");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, PreconditionerReuseContraction, "Keep the linear solver preconditioner of the previous Newton iteration if that iteration reduced the largest CNV residual at least by this factor. Zero disables it");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverWarmStart, "Start the linear solve of the first Newton iteration of a time step from the first Newton update of the previous step, scaled by the ratio of the step lengths. The linear solver starts from zero instead if the residual of this guess is larger than the right hand side");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, AbortHopelessNewton, "Chop the time step before the maximum number of Newton iterations if the reduction of the reservoir residuals in the last iterations is too slow to converge in time");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, SequentialImplicit, "Use sequential implicit Newton iterations, alternating between a pressure and a transport stage. Serial runs with --matrix-add-well-contributions=true only");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableWellOperabilityCheck, "Enable the well operability checking");
         }
@@ -133,11 +133,6 @@ namespace Opm
             EWOMS_HIDE_PARAM(TypeTag, EnableGravity);
             EWOMS_HIDE_PARAM(TypeTag, EnableGridAdaptation);
 
-            // this parameter is actually used in eWoms, but the flow well model
-            // hard-codes the assumption that the intensive quantities cache is enabled,
-            // so flow crashes. Let's hide the parameter for that reason.
-            EWOMS_HIDE_PARAM(TypeTag, EnableIntensiveQuantityCache);
-
             // thermodynamic hints are not implemented/required by the eWoms blackoil
             // model
             EWOMS_HIDE_PARAM(TypeTag, EnableThermodynamicHints);
@@ -76,12 +76,23 @@ namespace KeywordValidation
 
     void
     KeywordValidator::validateDeck(const Deck& deck, const ParseContext& parse_context, ErrorGuard& error_guard) const
+    {
+        reportErrors(validate(deck), parse_context, error_guard);
+    }
+
+    std::vector<ValidationError> KeywordValidator::validate(const Deck& deck) const
     {
         // Make a vector with all problems encountered in the deck.
         std::vector<ValidationError> errors;
         for (const auto& keyword : deck)
             validateDeckKeyword(keyword, errors);
+        return errors;
+    }
 
+    void KeywordValidator::reportErrors(const std::vector<ValidationError>& errors,
+                                        const ParseContext& parse_context,
+                                        ErrorGuard& error_guard)
+    {
         // First report non-critical problems as a warning.
         auto warning_report = get_error_report(errors, false);
         if (!warning_report.empty()) {
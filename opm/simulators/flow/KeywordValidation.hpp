@@ -25,6 +25,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Opm
@@ -51,8 +52,9 @@ namespace KeywordValidation
         std::optional<std::string> message; // An optional message to show if an illegal item is encountered
     };
 
-    // This is used to list unsupported kewyords.
-    using UnsupportedKeywords = std::map<std::string, UnsupportedKeywordProperties>;
+    // This is used to list unsupported kewyords. Hashed, since it is looked up
+    // for every keyword of a deck.
+    using UnsupportedKeywords = std::unordered_map<std::string, UnsupportedKeywordProperties>;
 
     // This is used to list the partially supported items of a keyword:
     template <typename T>
@@ -60,7 +62,7 @@ namespace KeywordValidation
 
     // This is used to list the keywords that have partially supported items:
     template <typename T>
-    using PartiallySupportedKeywords = std::map<std::string, PartiallySupportedKeywordItems<T>>;
+    using PartiallySupportedKeywords = std::unordered_map<std::string, PartiallySupportedKeywordItems<T>>;
 
     // This contains the information needed to report a single error occurence.
     // The validator will construct a vector of these, copying the relevant
@@ -81,6 +83,8 @@ namespace KeywordValidation
     // them, the result will be an empty string.
     std::string get_error_report(const std::vector<ValidationError>& errors, const bool critical);
 
+    // The keyword lists are referenced, not copied, by the validator, so they
+    // must outlive it.
     class KeywordValidator
     {
     public:
@@ -98,6 +102,16 @@ namespace KeywordValidation
         // reported, and execution of the program is halted.
         void validateDeck(const Deck& deck, const ParseContext& parse_context, ErrorGuard& error_guard) const;
 
+        // Collect the problems of all keywords of a deck without reporting
+        // them. This only reads the deck, so it can run concurrently with
+        // other code which reads the deck.
+        std::vector<ValidationError> validate(const Deck& deck) const;
+
+        // Report the problems found by validate() like validateDeck() does.
+        static void reportErrors(const std::vector<ValidationError>& errors,
+                                 const ParseContext& parse_context,
+                                 ErrorGuard& error_guard);
+
         // Validate a single deck keyword. If a problem is encountered, add the
         // relevant information to the errors vector.
         void validateDeckKeyword(const DeckKeyword& keyword, std::vector<ValidationError>& errors) const;
@@ -118,9 +132,9 @@ namespace KeywordValidation
                                   const PartiallySupportedKeywords<T>& partially_supported_options,
                                   std::vector<ValidationError>& errors) const;
 
-        const UnsupportedKeywords m_keywords;
-        const PartiallySupportedKeywords<std::string> m_string_items;
-        const PartiallySupportedKeywords<int> m_int_items;
+        const UnsupportedKeywords& m_keywords;
+        const PartiallySupportedKeywords<std::string>& m_string_items;
+        const PartiallySupportedKeywords<int>& m_int_items;
     };
 
 
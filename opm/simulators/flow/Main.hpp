@@ -151,6 +151,22 @@ namespace Opm
         {
         }
 
+        // Run an already parsed case, e.g. to parse the input of an ensemble only
+        // once. The deck file name, which sets the output names, is taken from the
+        // IO configuration. Serial runs only, a distributed grid needs the input in
+        // a ParallelEclipseState.
+        Main(std::unique_ptr<Deck> deck,
+             std::unique_ptr<EclipseState> eclipseState,
+             std::unique_ptr<Schedule> schedule,
+             std::unique_ptr<SummaryConfig> summaryConfig)
+            : Main(eclipseState->getIOConfig().fullBasePath())
+        {
+            deck_ = std::move(deck);
+            eclipseState_ = std::move(eclipseState);
+            schedule_ = std::move(schedule);
+            summaryConfig_ = std::move(summaryConfig);
+        }
+
         int runDynamic()
         {
             int exitCode = EXIT_SUCCESS;
@@ -440,7 +456,8 @@ namespace Opm
                                           deckFilename,
                                           outputDir,
                                           EWOMS_GET_PARAM(PreTypeTag, std::string, OutputMode),
-                                          outputCout_, "STDOUT_LOGGER");
+                                          outputCout_, "STDOUT_LOGGER",
+                                          EWOMS_GET_PARAM(PreTypeTag, bool, EnableLoggingFalloutWarning));
                 auto parseContext =
                     std::make_unique<ParseContext>(std::vector<std::pair<std::string , InputError::Action>>
                                                    {{ParseContext::PARSE_RANDOM_SLASH, InputError::IGNORE},
@@ -463,7 +480,9 @@ namespace Opm
 
                 readDeck(mpiRank, deckFilename, deck_, eclipseState_, schedule_,
                          summaryConfig_, nullptr, python, std::move(parseContext),
-                         init_from_restart_file, outputCout_, outputInterval);
+                         init_from_restart_file, outputCout_, outputInterval,
+                         EWOMS_GET_PARAM(PreTypeTag, bool, ParseDeckOnAllRanks),
+                         EWOMS_GET_PARAM(PreTypeTag, std::string, DeckCacheDir));
 
                 setupTime_ = externalSetupTimer.elapsed();
                 outputFiles_ = (outputMode != FileOutputMode::OUTPUT_NONE);
@@ -27,12 +27,23 @@
 #include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 #include <opm/simulators/aquifers/BlackoilAquiferModel.hpp>
+#include <opm/simulators/utils/CostAccounting.hpp>
+#include <opm/simulators/utils/MemoryAccounting.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
+#if HAVE_MPI
+#include <opm/simulators/utils/ParallelSerialization.hpp>
+#endif
+#include <opm/simulators/utils/RuntimeMetrics.hpp>
+#include <opm/simulators/utils/ScopedTimers.hpp>
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <fstream>
+#include <optional>
+#include <string>
+
 namespace Opm::Properties {
 
 template<class TypeTag, class MyTypeTag>
@@ -43,6 +54,34 @@ template<class TypeTag, class MyTypeTag>
 struct EnableTuning {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct TimerCsvFileName {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct TraceFilePrefix {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct TraceMinDuration {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EnableHardwareCounters {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EnableCostAccounting {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct MetricsFileName {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EnableMemoryAccounting {
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct EnableTerminalOutput<TypeTag, TTag::EclFlowProblem> {
@@ -56,6 +95,35 @@ template<class TypeTag>
 struct EnableTuning<TypeTag, TTag::EclFlowProblem> {
     static constexpr bool value = false;
 };
+template<class TypeTag>
+struct TimerCsvFileName<TypeTag, TTag::EclFlowProblem> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct TraceFilePrefix<TypeTag, TTag::EclFlowProblem> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct TraceMinDuration<TypeTag, TTag::EclFlowProblem> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 10.0;
+};
+template<class TypeTag>
+struct EnableHardwareCounters<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct EnableCostAccounting<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct MetricsFileName<TypeTag, TTag::EclFlowProblem> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct EnableMemoryAccounting<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
 
 } // namespace Opm::Properties
 
@@ -132,6 +200,20 @@ public:
                              "Use adaptive time stepping between report steps");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTuning,
                              "Honor some aspects of the TUNING keyword.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, TimerCsvFileName,
+                             "Write the minimum, average and maximum over all processes of the time spent in the timed parts of the simulator in every report step to this CSV file. Empty disables it");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, TraceFilePrefix,
+                             "Write a timeline of the timed parts of the simulator of every process to <prefix>.<rank>.json, in the Chrome trace event format. Empty disables it");
+        EWOMS_REGISTER_PARAM(TypeTag, double, TraceMinDuration,
+                             "Leave the timed parts shorter than this many microseconds out of the timeline of --trace-file-prefix");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableHardwareCounters,
+                             "Count cycles, instructions and cache misses of the main thread of every process in the timed parts of the simulator, with the Linux perf_event interface. This also times the inner kernels of the linear solver, e.g. the matrix-vector products and the ILU applications");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableCostAccounting,
+                             "Record the Newton iterations in which every cell violates the CNV tolerance, written as COSTPERCELL to the restart files, and the assembly and solve time of every well, printed at the end of the run");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, MetricsFileName,
+                             "Rewrite this JSON file after every report step with the progress of the simulation: simulated time, time steps, chops, iterations, simulated days per hour, memory high-water mark of every process and pending output writes. Empty disables it");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableMemoryAccounting,
+                             "Print the memory held by the Jacobian, the linear solver, the intensive quantity cache, the output buffers, the well states, the schedule and the eclipse state, over all processes, at the start and after every report step");
     }
 
     /// Run the simulation.
@@ -160,6 +242,45 @@ public:
         totalTimer_ = std::make_unique<time::StopWatch>();
         totalTimer_->start();
 
+        timerCsvFileName_ = EWOMS_GET_PARAM(TypeTag, std::string, TimerCsvFileName);
+        if (!timerCsvFileName_.empty() && grid().comm().rank() == 0) {
+            std::ofstream csv(timerCsvFileName_);
+            csv << "report step,timer,calls,min,average,max\n";
+        }
+
+        traceFilePrefix_ = EWOMS_GET_PARAM(TypeTag, std::string, TraceFilePrefix);
+        if (!traceFilePrefix_.empty()) {
+            // line up the timelines of the processes
+            grid().comm().barrier();
+            TimerRegistry::instance().startTrace(EWOMS_GET_PARAM(TypeTag, double, TraceMinDuration));
+        }
+
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableHardwareCounters)) {
+            TimerRegistry::instance().enableKernelTimers();
+            const bool available = TimerRegistry::instance().enableHardwareCounters();
+            if (grid().comm().min(static_cast<int>(available)) == 0 && terminalOutput_) {
+                OpmLog::warning("Hardware counters are unavailable on some processes, "
+                                "check /proc/sys/kernel/perf_event_paranoid");
+            }
+        }
+
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableCostAccounting)) {
+            CostAccounting::instance().enable(grid().size(0));
+        }
+
+        metricsFileName_ = EWOMS_GET_PARAM(TypeTag, std::string, MetricsFileName);
+
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableMemoryAccounting)) {
+            auto& memoryAccounting = MemoryAccounting::instance();
+            memoryAccounting.enable();
+#if HAVE_MPI
+            // every process holds a copy
+            memoryAccounting.set("schedule", serializedSize(schedule()));
+            memoryAccounting.set("eclipse state", serializedSize(eclState()));
+#endif
+            printMemoryAccounting_("Memory at the start");
+        }
+
         // adaptive time stepping
         bool enableAdaptive = EWOMS_GET_PARAM(TypeTag, bool, EnableAdaptiveTimeStepping);
         bool enableTUNING = EWOMS_GET_PARAM(TypeTag, bool, EnableTuning);
@@ -220,6 +341,7 @@ public:
             ebosSimulator_.setTimeStepSize(0.0);
 
             wellModel_().beginReportStep(timer.currentStepNum());
+            ScopedTimer outputTimer("output");
             ebosSimulator_.problem().writeOutput();
 
             report_.success.output_write_time += perfTimer.stop();
@@ -227,6 +349,10 @@ public:
 
         // Run a multiple steps of the solver depending on the time step control.
         solverTimer_->start();
+        const auto timersAtStart = TimerRegistry::instance().entries();
+        std::optional<ScopedTimer> reportStepTimer;
+        reportStepTimer.emplace("report step");
+        const double assembleAndSolveTimeAtStart = assembleAndSolveTime_();
 
         auto solver = createSolver(wellModel_());
 
@@ -272,20 +398,29 @@ public:
         perfTimer.start();
         const double nextstep = adaptiveTimeStepping_ ? adaptiveTimeStepping_->suggestedNextStep() : -1.0;
         ebosSimulator_.problem().setNextTimeStepSize(nextstep);
-        ebosSimulator_.problem().writeOutput();
+        {
+            ScopedTimer outputTimer("output");
+            ebosSimulator_.problem().writeOutput();
+        }
         report_.success.output_write_time += perfTimer.stop();
 
         solver->model().endReportStep();
 
         // take time that was used to solve system for this reportStep
         solverTimer_->stop();
+        reportStepTimer.reset();
 
         // update timing.
         report_.success.solver_time += solverTimer_->secsSinceStart();
+        logLoadImbalance_(assembleAndSolveTime_() - assembleAndSolveTimeAtStart);
+        writeTimerCsv_(timer.currentStepNum(), timersAtStart);
 
         // Increment timer, remember well state.
         ++timer;
 
+        writeMetrics_(timer);
+        printMemoryAccounting_("Memory at report step " + std::to_string(timer.reportStepNum()));
+
         if (terminalOutput_) {
             if (!timer.initialStep()) {
                 const std::string version = moduleVersionName();
@@ -309,10 +444,42 @@ public:
             Dune::Timer finalOutputTimer;
             finalOutputTimer.start();
 
+            ScopedTimer outputTimer("output");
             ebosSimulator_.problem().finalizeOutput();
             report_.success.output_write_time += finalOutputTimer.stop();
         }
 
+        // collective, all processes take part
+        const auto timerStatistics = TimerRegistry::instance().statistics(grid().comm());
+        if (terminalOutput_ && !timerStatistics.empty()) {
+            std::ostringstream ss;
+            ss << "Timers, over all processes:\n";
+            TimerRegistry::print(ss, timerStatistics);
+            OpmLog::info(ss.str());
+        }
+
+        if (CostAccounting::instance().enabled()) {
+            // collective, all processes take part
+            const auto wellCosts = CostAccounting::instance().wellCosts(grid().comm());
+            if (terminalOutput_ && !wellCosts.empty()) {
+                std::ostringstream ss;
+                ss << "Well costs, over all processes:\n";
+                CostAccounting::print(ss, wellCosts);
+                OpmLog::info(ss.str());
+            }
+        }
+
+        if (!traceFilePrefix_.empty()) {
+            const int rank = grid().comm().rank();
+            std::ofstream trace(traceFilePrefix_ + "." + std::to_string(rank) + ".json");
+            TimerRegistry::instance().writeChromeTrace(trace, rank);
+            const auto dropped = TimerRegistry::instance().droppedTraceEvents();
+            if (dropped > 0) {
+                OpmLog::warning("The timeline of process " + std::to_string(rank) + " is incomplete, "
+                                + std::to_string(dropped) + " events were dropped");
+            }
+        }
+
         // Stop timer and create timing report
         totalTimer_->stop();
         report_.success.total_time = totalTimer_->secsSinceStart();
@@ -350,6 +517,103 @@ protected:
         OpmLog::note(ss.str());
     }
 
+    // Assembly and linear solve time of this process, including the failed steps.
+    double assembleAndSolveTime_() const
+    {
+        return report_.success.assemble_time + report_.success.linear_solve_time
+            + report_.failure.assemble_time + report_.failure.linear_solve_time;
+    }
+
+    // Log by how much the assembly and linear solve time of the slowest
+    // process in the report step exceeds the average over all processes.
+    void logLoadImbalance_(const double localTime) const
+    {
+        const auto& comm = grid().comm();
+        if (comm.size() == 1)
+            return;
+
+        const double maxTime = comm.max(localTime);
+        const double averageTime = comm.sum(localTime) / comm.size();
+        if (terminalOutput_ && averageTime > 0.0) {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(1)
+               << "Load imbalance of the report step: " << 100.0*(maxTime/averageTime - 1.0) << "%"
+               << " (assembly and linear solve, slowest process " << maxTime
+               << " seconds, average " << averageTime << " seconds)";
+            OpmLog::debug(ss.str());
+        }
+    }
+
+    // Append the timers of the report step to the CSV file, if enabled.
+    void writeTimerCsv_(const int reportStep, const TimerRegistry::Entries& timersAtStart) const
+    {
+        if (timerCsvFileName_.empty())
+            return;
+
+        const auto statistics = TimerRegistry::instance().statistics(grid().comm(), timersAtStart);
+        if (grid().comm().rank() == 0) {
+            std::ofstream csv(timerCsvFileName_, std::ios::app);
+            TimerRegistry::writeCsv(csv, std::to_string(reportStep), statistics);
+        }
+    }
+
+    // Update the memory of the subsystems owned by the simulator and print
+    // the memory of all subsystems, if enabled.
+    void printMemoryAccounting_(const std::string& title) const
+    {
+        auto& memoryAccounting = MemoryAccounting::instance();
+        if (!memoryAccounting.enabled())
+            return;
+
+        using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
+        constexpr auto historySize = getPropValue<TypeTag, Properties::TimeDiscHistorySize>();
+        const bool cached = EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache);
+        memoryAccounting.set("intensive quantities",
+                             cached
+                             ? historySize * ebosSimulator_.model().numGridDof() * sizeof(IntensiveQuantities)
+                             : ebosSimulator_.problem().keptIntensiveQuantitiesBytes());
+        memoryAccounting.set("output buffers", ebosSimulator_.problem().outputBufferBytes());
+        memoryAccounting.set("well states", wellModel_().wellStateMemoryUsage());
+
+        // collective, all processes take part
+        const auto statistics = memoryAccounting.statistics(grid().comm());
+        if (terminalOutput_) {
+            std::ostringstream ss;
+            ss << title << ", over all processes:\n";
+            MemoryAccounting::print(ss, statistics);
+            OpmLog::info(ss.str());
+        }
+    }
+
+    // Rewrite the metrics file, if enabled.
+    void writeMetrics_(const SimulatorTimer& timer) const
+    {
+        if (metricsFileName_.empty())
+            return;
+
+        const auto& comm = grid().comm();
+        const double peakMemory = RuntimeMetrics::processPeakMemory();
+        RuntimeMetrics metrics;
+        metrics.peakMemory.resize(comm.size());
+        comm.gather(&peakMemory, metrics.peakMemory.data(), 1, 0);
+        if (comm.rank() != 0)
+            return;
+
+        metrics.reportStep = timer.currentStepNum();
+        metrics.simulatedDays = unit::convert::to(timer.simulationTimeElapsed(), unit::day);
+        metrics.totalDays = unit::convert::to(timer.totalTime(), unit::day);
+        metrics.wallSeconds = totalTimer_->secsSinceStart();
+        for (const auto& stepReport : report_.stepreports) {
+            ++(stepReport.converged ? metrics.steps : metrics.chops);
+        }
+        metrics.newtonIterations = report_.success.total_newton_iterations
+            + report_.failure.total_newton_iterations;
+        metrics.linearIterations = report_.success.total_linear_iterations
+            + report_.failure.total_linear_iterations;
+        metrics.pendingWrites = ebosSimulator_.problem().numPendingOutputWrites();
+        metrics.writeJsonFile(metricsFileName_);
+    }
+
     const EclipseState& eclState() const
     { return ebosSimulator_.vanguard().eclState(); }
 
@@ -385,6 +649,9 @@ protected:
     std::unique_ptr<time::StopWatch> solverTimer_;
     std::unique_ptr<time::StopWatch> totalTimer_;
     std::unique_ptr<TimeStepper> adaptiveTimeStepping_;
+    std::string timerCsvFileName_;
+    std::string traceFilePrefix_;
+    std::string metricsFileName_;
 };
 
 } // namespace Opm
@@ -27,6 +27,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Opm::Pybind
@@ -40,6 +41,7 @@ namespace Opm::Pybind
         using FluidSystem = GetPropType<TypeTag, Opm::Properties::FluidSystem>;
         using Indices = GetPropType<TypeTag, Opm::Properties::Indices>;
         using GridView = GetPropType<TypeTag, Opm::Properties::GridView>;
+        using PrimaryVariables = GetPropType<TypeTag, Opm::Properties::PrimaryVariables>;
 
     public:
         PyMaterialState(Simulator *ebosSimulator)
@@ -48,7 +50,30 @@ namespace Opm::Pybind
         std::unique_ptr<double []> getCellVolumes( std::size_t *size);
         std::unique_ptr<double []> getPorosity( std::size_t *size);
         void setPorosity(const double *poro, std::size_t size);
+        // The diagonal of the permeability tensors, three values per cell.
+        // Setting them recomputes the transmissibilities.
+        std::unique_ptr<double []> getPermeability( std::size_t *size);
+        void setPermeability(const double *perm, std::size_t size);
+        void setTransmissibilities(const int *cells1, const int *cells2,
+                                   const double *trans, std::size_t size);
+
+        // The storage of the porosities and of the primary variables of
+        // the current solution, for views which are valid as long as the
+        // simulator lives. The primary variables of a cell are numEq
+        // consecutive values, and the cells are cellStride bytes apart.
+        double *porosityData( std::size_t *size);
+        double *primaryVariablesData( std::size_t *size, std::size_t *numEq,
+                                      std::size_t *cellStride);
+        // Fill numPhases values per cell from the cached intensive
+        // quantities of the current solution, in the phase order of the
+        // fluid system.
+        std::size_t numPhases() const;
+        void getPressures(double *pressures, std::size_t size);
+        void getSaturations(double *saturations, std::size_t size);
     private:
+        template <class Getter>
+        void getPhaseQuantity_(double *values, std::size_t size, const Getter& getter);
+
         Simulator *ebosSimulator_;
     };
 
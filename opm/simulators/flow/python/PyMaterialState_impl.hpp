@@ -66,4 +66,162 @@ setPorosity(const double *poro, std::size_t size)
         problem.setPorosity(poro[dofIdx], dofIdx);
     }
 }
+
+template <class TypeTag>
+std::unique_ptr<double []>
+PyMaterialState<TypeTag>::
+getPermeability( std::size_t *size)
+{
+    Problem &problem = ebosSimulator_->problem();
+    Model &model = ebosSimulator_->model();
+    const std::size_t numDof = model.numGridDof();
+    *size = 3 * numDof;
+    auto array = std::make_unique<double []>(*size);
+    for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+        const auto &perm = problem.intrinsicPermeability(dofIdx);
+        for (unsigned dimIdx = 0; dimIdx < 3; ++dimIdx) {
+            array[3 * dofIdx + dimIdx] = perm[dimIdx][dimIdx];
+        }
+    }
+    return array;
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+setPermeability(const double *perm, std::size_t size)
+{
+    Problem &problem = ebosSimulator_->problem();
+    Model &model = ebosSimulator_->model();
+    const std::size_t numDof = model.numGridDof();
+    if (3 * numDof != size) {
+        std::ostringstream message;
+        message << "Cannot set permeability. Expected array of size: "
+                << 3 * numDof << ", got array of size: " << size;
+        throw std::runtime_error(message.str());
+    }
+    using DimMatrix = std::remove_cv_t<std::remove_reference_t<
+        decltype(problem.intrinsicPermeability(0u))>>;
+    std::vector<DimMatrix> permeability(numDof, DimMatrix(0.0));
+    for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+        for (unsigned dimIdx = 0; dimIdx < 3; ++dimIdx) {
+            permeability[dofIdx][dimIdx][dimIdx] = perm[3 * dofIdx + dimIdx];
+        }
+    }
+    problem.setPermeabilities(permeability);
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+setTransmissibilities(const int *cells1, const int *cells2,
+                      const double *trans, std::size_t size)
+{
+    Problem &problem = ebosSimulator_->problem();
+    const std::size_t numDof = ebosSimulator_->model().numGridDof();
+    std::vector<unsigned> elem1Idx(size), elem2Idx(size);
+    for (std::size_t faceIdx = 0; faceIdx < size; ++faceIdx) {
+        if (cells1[faceIdx] < 0 || cells2[faceIdx] < 0
+            || static_cast<std::size_t>(cells1[faceIdx]) >= numDof
+            || static_cast<std::size_t>(cells2[faceIdx]) >= numDof) {
+            throw std::runtime_error("Cannot set transmissibilities. Cell index out of range");
+        }
+        elem1Idx[faceIdx] = cells1[faceIdx];
+        elem2Idx[faceIdx] = cells2[faceIdx];
+    }
+    try {
+        problem.setTransmissibilities(elem1Idx, elem2Idx,
+                                      std::vector<double>(trans, trans + size));
+    }
+    catch (const std::out_of_range&) {
+        throw std::runtime_error("Cannot set transmissibilities. The cells are not neighbours");
+    }
+}
+
+template <class TypeTag>
+double *
+PyMaterialState<TypeTag>::
+porosityData( std::size_t *size)
+{
+    auto &porosity = ebosSimulator_->problem().referencePorosities(/*timeIdx*/0);
+    *size = porosity.size();
+    return porosity.data();
+}
+
+template <class TypeTag>
+double *
+PyMaterialState<TypeTag>::
+primaryVariablesData( std::size_t *size, std::size_t *numEq, std::size_t *cellStride)
+{
+    auto &solution = ebosSimulator_->model().solution(/*timeIdx*/0);
+    *size = solution.size();
+    *numEq = PrimaryVariables::dimension;
+    *cellStride = sizeof(PrimaryVariables);
+    if (solution.size() == 0) {
+        return nullptr;
+    }
+    return &solution[0][0];
+}
+
+template <class TypeTag>
+std::size_t
+PyMaterialState<TypeTag>::
+numPhases() const
+{
+    return FluidSystem::numPhases;
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+getPressures(double *pressures, std::size_t size)
+{
+    getPhaseQuantity_(pressures, size,
+                      [](const auto &fs, unsigned phaseIdx)
+                      { return fs.pressure(phaseIdx); });
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+getSaturations(double *saturations, std::size_t size)
+{
+    getPhaseQuantity_(saturations, size,
+                      [](const auto &fs, unsigned phaseIdx)
+                      { return fs.saturation(phaseIdx); });
+}
+
+template <class TypeTag>
+template <class Getter>
+void
+PyMaterialState<TypeTag>::
+getPhaseQuantity_(double *values, std::size_t size, const Getter& getter)
+{
+    Model &model = ebosSimulator_->model();
+    const std::size_t numDof = model.numGridDof();
+    constexpr std::size_t numPhases = FluidSystem::numPhases;
+    if (size != numDof * numPhases) {
+        std::ostringstream message;
+        message << "Expected array of size: " << numDof * numPhases
+                << ", got array of size: " << size;
+        throw std::runtime_error(message.str());
+    }
+    for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+        if (!model.cachedIntensiveQuantities(dofIdx, /*timeIdx*/0)) {
+            throw std::runtime_error("The intensive quantities of the current "
+                                     "solution are not available");
+        }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int dofIdx = 0; dofIdx < static_cast<int>(numDof); ++dofIdx) {
+        const auto &fs = model.cachedIntensiveQuantities(dofIdx, /*timeIdx*/0)->fluidState();
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            values[dofIdx * numPhases + phaseIdx] = FluidSystem::phaseIsActive(phaseIdx)
+                ? getValue(getter(fs, phaseIdx)) : 0.0;
+        }
+    }
+}
 } //namespace Opm::Pybind
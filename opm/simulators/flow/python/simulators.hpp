@@ -26,6 +26,9 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include <string>
+#include <vector>
+
 namespace py = pybind11;
 
 namespace Opm::Pybind {
@@ -37,16 +40,53 @@ private:
 
 public:
     BlackOilSimulator( const std::string &deckFilename);
+    // Simulate a copy of already parsed input, e.g. one realisation of an
+    // ensemble sharing the parsed deck, with modified properties.
+    BlackOilSimulator( const Opm::Deck& deck,
+                       const Opm::EclipseState& eclipseState,
+                       const Opm::Schedule& schedule,
+                       const Opm::SummaryConfig& summaryConfig);
+    py::array_t<double> getPermeability();
     py::array_t<double> getPorosity();
+    // Views of the storage of the simulator, which keep the simulator alive.
+    py::array_t<double> getPorosityView();
+    py::array_t<double> getPrimaryVariablesView();
+    // One row per cell and one column per phase of the fluid system.
+    py::array_t<double> getPressures();
+    py::array_t<double> getSaturations();
+    // The surface rates of all wells, one row per well in the order of
+    // getWellNames() and one column per active phase.
+    std::vector<std::string> getWellNames();
+    py::array_t<double> getWellRates();
     int run();
+    // Change the permeabilities and transmissibilities between two steps,
+    // without initializing the simulator again.
+    void setPermeability(
+         py::array_t<double, py::array::c_style | py::array::forcecast> array);
     void setPorosity(
          py::array_t<double, py::array::c_style | py::array::forcecast> array);
+    void setTransmissibilities(
+         py::array_t<int, py::array::c_style | py::array::forcecast> cells1,
+         py::array_t<int, py::array::c_style | py::array::forcecast> cells2,
+         py::array_t<double, py::array::c_style | py::array::forcecast> trans);
+    void setWellRates(
+         py::array_t<double, py::array::c_style | py::array::forcecast> array);
     int step();
     int stepInit();
     int stepCleanup();
 
 private:
+    std::unique_ptr<Opm::Main> createMain_();
+    void checkInitialized_(const char *method) const;
+    // The wells in the order of their index in the well state.
+    std::vector<std::string> wellNames_() const;
+
     const std::string deckFilename_;
+    // The parsed input, if not constructed from the deck file name.
+    std::unique_ptr<Opm::Deck> deck_;
+    std::unique_ptr<Opm::EclipseState> eclipseState_;
+    std::unique_ptr<Opm::Schedule> schedule_;
+    std::unique_ptr<Opm::SummaryConfig> summaryConfig_;
     bool hasRunInit_ = false;
     bool hasRunCleanup_ = false;
 
@@ -0,0 +1,141 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ADAPTIVESOLVERSELECTOR_HEADER_INCLUDED
+#define OPM_ADAPTIVESOLVERSELECTOR_HEADER_INCLUDED
+
+#include <algorithm>
+
+namespace Opm
+{
+
+/// Chooses between the accelerated (BdaBridge) and the Dune linear solver
+/// from their measured run times.
+///
+/// At the start of every report step both solvers are tried alternately,
+/// starting with the accelerator, for trialSolves() solves each. The one
+/// with the lower average time is used for the rest of the report step. If
+/// the accelerator did not converge during the trial, Dune is chosen right
+/// away. When the accelerator was chosen but later does not converge, or
+/// needs more than iterationRatio times the largest iteration count seen
+/// during its trial, the selector switches to Dune until the next report
+/// step.
+///
+/// The caller must pass the same times on all processes of a parallel run,
+/// e.g. the maximum over all processes, so that all processes choose the
+/// same solver.
+class AdaptiveSolverSelector
+{
+public:
+    AdaptiveSolverSelector(int trialSolves, double iterationRatio)
+        : trialSolves_(std::max(trialSolves, 1)),
+          iterationRatio_(iterationRatio)
+    {
+        newReportStep();
+    }
+
+    /// Restart the trial phase.
+    void newReportStep()
+    {
+        inTrial_ = true;
+        useAccelerator_ = true;
+        trialCount_ = 0;
+        for (auto& s : stats_) {
+            s = Stats();
+        }
+    }
+
+    /// Whether the next linear system should be solved with the accelerator.
+    bool useAccelerator() const
+    {
+        return useAccelerator_;
+    }
+
+    /// Record the outcome of a linear solve.
+    /// \param[in] accelerator  true if the solve was done with the accelerator,
+    ///                         including a Dune fallback after non-convergence
+    /// \param[in] seconds      wall time of the solve
+    /// \param[in] iterations   linear iterations of the accelerator, or of Dune
+    /// \param[in] converged    true if the chosen solver converged
+    /// \return                 true if the trial ended or the selector switched back to Dune
+    bool report(bool accelerator, double seconds, int iterations, bool converged)
+    {
+        if (inTrial_) {
+            Stats& s = stats_[accelerator ? 1 : 0];
+            s.seconds += seconds;
+            s.maxIterations = std::max(s.maxIterations, iterations);
+            ++s.solves;
+            ++trialCount_;
+            if (accelerator && !converged) {
+                inTrial_ = false;
+                useAccelerator_ = false;
+                return true;
+            }
+            if (trialCount_ >= 2 * trialSolves_) {
+                inTrial_ = false;
+                useAccelerator_ = averageSeconds(true) < averageSeconds(false);
+                return true;
+            }
+            useAccelerator_ = (trialCount_ % 2) == 0;
+        } else if (accelerator && useAccelerator_) {
+            const double limit = iterationRatio_ * std::max(stats_[1].maxIterations, 1);
+            if (!converged || iterations > limit) {
+                useAccelerator_ = false;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// True while both solvers are being timed.
+    bool inTrial() const
+    {
+        return inTrial_;
+    }
+
+    /// Average time per solve in the trial of the current report step, 0 if none.
+    double averageSeconds(bool accelerator) const
+    {
+        const Stats& s = stats_[accelerator ? 1 : 0];
+        return s.solves > 0 ? s.seconds / s.solves : 0.0;
+    }
+
+    int trialSolves() const
+    {
+        return trialSolves_;
+    }
+
+private:
+    struct Stats {
+        double seconds = 0.0;
+        int solves = 0;
+        int maxIterations = 0;
+    };
+
+    int trialSolves_;
+    double iterationRatio_;
+    bool inTrial_ = true;
+    bool useAccelerator_ = true;
+    int trialCount_ = 0;
+    Stats stats_[2]; // 0: Dune, 1: accelerator
+};
+
+} // namespace Opm
+
+#endif // OPM_ADAPTIVESOLVERSELECTOR_HEADER_INCLUDED
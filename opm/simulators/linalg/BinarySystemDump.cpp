@@ -0,0 +1,170 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+
+    const char magic[] = "OPMSYS01";
+    constexpr std::size_t magicSize = sizeof(magic) - 1;
+
+    template <class T>
+    void writeValue(std::ostream& os, const T value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    T readValue(std::istream& is)
+    {
+        T value;
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!is) {
+            throw std::runtime_error("Unexpected end of binary system file");
+        }
+        return value;
+    }
+
+    template <class Stored, class T>
+    void writeArray(std::ostream& os, const std::vector<T>& array)
+    {
+        writeValue<std::int64_t>(os, array.size());
+        if constexpr (std::is_same_v<Stored, T>) {
+            os.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(T));
+        } else {
+            for (const auto& value : array) {
+                writeValue<Stored>(os, value);
+            }
+        }
+    }
+
+    template <class Stored, class T>
+    std::vector<T> readArray(std::istream& is)
+    {
+        const auto size = readValue<std::int64_t>(is);
+        if (size < 0) {
+            throw std::runtime_error("Invalid array size in binary system file");
+        }
+        std::vector<T> array(size);
+        if constexpr (std::is_same_v<Stored, T>) {
+            is.read(reinterpret_cast<char*>(array.data()), size * sizeof(T));
+            if (!is) {
+                throw std::runtime_error("Unexpected end of binary system file");
+            }
+        } else {
+            for (auto& value : array) {
+                value = readValue<Stored>(is);
+            }
+        }
+        return array;
+    }
+
+    void writeMatrix(std::ostream& os, const Opm::Helper::SparseBlockMatrix& matrix)
+    {
+        writeValue<std::int64_t>(os, matrix.rows);
+        writeValue<std::int64_t>(os, matrix.cols);
+        writeValue<std::int32_t>(os, matrix.blockRows);
+        writeValue<std::int32_t>(os, matrix.blockCols);
+        writeArray<std::int64_t>(os, matrix.rowStart);
+        writeArray<std::int32_t>(os, matrix.columns);
+        writeArray<double>(os, matrix.values);
+    }
+
+    Opm::Helper::SparseBlockMatrix readMatrix(std::istream& is)
+    {
+        Opm::Helper::SparseBlockMatrix matrix;
+        matrix.rows = readValue<std::int64_t>(is);
+        matrix.cols = readValue<std::int64_t>(is);
+        matrix.blockRows = readValue<std::int32_t>(is);
+        matrix.blockCols = readValue<std::int32_t>(is);
+        matrix.rowStart = readArray<std::int64_t, long>(is);
+        matrix.columns = readArray<std::int32_t, int>(is);
+        matrix.values = readArray<double, double>(is);
+        const std::size_t blockSize = matrix.blockRows * matrix.blockCols;
+        const bool empty = matrix.rows == 0 && matrix.rowStart.empty();
+        if ((!empty && matrix.rowStart.size() != static_cast<std::size_t>(matrix.rows + 1))
+            || matrix.values.size() != matrix.columns.size() * blockSize) {
+            throw std::runtime_error("Inconsistent matrix in binary system file");
+        }
+        return matrix;
+    }
+
+} // anonymous namespace
+
+namespace Opm
+{
+namespace Helper
+{
+
+    void writeBinarySystem(std::ostream& os, const BinarySystem& system)
+    {
+        os.write(magic, magicSize);
+        writeMatrix(os, system.matrix);
+        writeArray<double>(os, system.rhs);
+        writeArray<std::uint8_t>(os, system.ghostRows);
+        writeValue<std::int64_t>(os, system.wells.size());
+        for (const auto& well : system.wells) {
+            writeArray<char>(os, std::vector<char>(well.name.begin(), well.name.end()));
+            writeValue<std::uint8_t>(os, well.inverseD);
+            writeMatrix(os, well.B);
+            writeMatrix(os, well.C);
+            writeMatrix(os, well.D);
+        }
+        if (!os) {
+            throw std::runtime_error("Could not write binary system file");
+        }
+    }
+
+    BinarySystem readBinarySystem(std::istream& is)
+    {
+        char header[magicSize];
+        is.read(header, magicSize);
+        if (!is || std::string(header, magicSize) != magic) {
+            throw std::runtime_error("Not a binary system file");
+        }
+        BinarySystem system;
+        system.matrix = readMatrix(is);
+        system.rhs = readArray<double, double>(is);
+        system.ghostRows = readArray<std::uint8_t, unsigned char>(is);
+        const auto numWells = readValue<std::int64_t>(is);
+        for (std::int64_t w = 0; w < numWells; ++w) {
+            WellSystemBlocks well;
+            const auto name = readArray<char, char>(is);
+            well.name.assign(name.begin(), name.end());
+            well.inverseD = readValue<std::uint8_t>(is) != 0;
+            well.B = readMatrix(is);
+            well.C = readMatrix(is);
+            well.D = readMatrix(is);
+            system.wells.push_back(std::move(well));
+        }
+        return system;
+    }
+
+} // namespace Helper
+} // namespace Opm
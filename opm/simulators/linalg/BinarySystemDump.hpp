@@ -0,0 +1,114 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BINARYSYSTEMDUMP_HEADER_INCLUDED
+#define OPM_BINARYSYSTEMDUMP_HEADER_INCLUDED
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+namespace Helper
+{
+    /// A block sparse matrix in the BSR format, with every block stored
+    /// row by row.
+    struct SparseBlockMatrix
+    {
+        long rows = 0;
+        long cols = 0;
+        int blockRows = 0;
+        int blockCols = 0;
+        std::vector<long> rowStart;
+        std::vector<int> columns;
+        std::vector<double> values;
+
+        /// Copy a Dune::BCRSMatrix of static or dynamic blocks.
+        template <class Matrix>
+        static SparseBlockMatrix from(const Matrix& matrix)
+        {
+            SparseBlockMatrix result;
+            result.rows = matrix.N();
+            result.cols = matrix.M();
+            result.rowStart.reserve(matrix.N() + 1);
+            result.rowStart.push_back(0);
+            result.columns.reserve(matrix.nonzeroes());
+            for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    const auto& block = *col;
+                    if (result.columns.empty()) {
+                        result.blockRows = block.N();
+                        result.blockCols = block.M();
+                        result.values.reserve(matrix.nonzeroes() * block.N() * block.M());
+                    }
+                    result.columns.push_back(col.index());
+                    for (std::size_t i = 0; i < block.N(); ++i) {
+                        for (std::size_t j = 0; j < block.M(); ++j) {
+                            result.values.push_back(block[i][j]);
+                        }
+                    }
+                }
+                result.rowStart.push_back(result.columns.size());
+            }
+            return result;
+        }
+    };
+
+    /// The blocks of the equations of a well that is not part of the
+    /// reservoir matrix A. The well enters the reservoir equations as
+    /// A - C^T D^-1 B, B and C have a block row per well unknown block
+    /// (segment) and a block column per cell.
+    struct WellSystemBlocks
+    {
+        std::string name;
+        SparseBlockMatrix B;
+        SparseBlockMatrix C;
+        SparseBlockMatrix D;
+        /// D holds D^-1 (standard wells only store the inverse).
+        bool inverseD = false;
+    };
+
+    /// A linear system of one process.
+    struct BinarySystem
+    {
+        SparseBlockMatrix matrix;
+        std::vector<double> rhs;
+        /// 1 for the rows of overlap (ghost) cells, 0 for owned cells.
+        std::vector<unsigned char> ghostRows;
+        std::vector<WellSystemBlocks> wells;
+    };
+
+    /// Write a system in the binary format, native byte order. The format
+    /// starts with the 8 characters "OPMSYS01", followed by the matrix, the
+    /// rhs, the ghost rows and the wells. Every array is preceded by its
+    /// length as a 64 bit integer, a matrix is written as rows, cols (64
+    /// bit), blockRows, blockCols (32 bit) and the arrays rowStart (64 bit),
+    /// columns (32 bit) and values.
+    void writeBinarySystem(std::ostream& os, const BinarySystem& system);
+
+    /// Read a system written by writeBinarySystem(), throws
+    /// std::runtime_error if the stream does not hold one.
+    BinarySystem readBinarySystem(std::istream& is);
+
+} // namespace Helper
+} // namespace Opm
+
+#endif // OPM_BINARYSYSTEMDUMP_HEADER_INCLUDED
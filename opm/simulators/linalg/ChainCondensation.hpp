@@ -0,0 +1,303 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CHAINCONDENSATION_HEADER_INCLUDED
+#define OPM_CHAINCONDENSATION_HEADER_INCLUDED
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// Condensation of one-dimensional chains of cells, like the cells of a
+/// numerical aquifer, out of a linear system.
+///
+/// The cells of a chain may only be coupled to their predecessor and
+/// successor in the chain, and to any cells outside of the chains. Writing
+/// the system as [A B; C D] [x; y] = [b; c] with y the chain cells,
+/// condense() replaces the rows and columns of the chain cells by the
+/// identity and solves the remaining system with the Schur complement
+/// A - B D^-1 C, whose second part is applied by this operator like the
+/// wells are applied. D is block tridiagonal and factorized once per
+/// matrix, and recover() computes y after the solve.
+///
+/// Chains whose cells are coupled otherwise are left in the matrix.
+template <class Matrix, class Vector>
+class ChainCondensation : public Dune::LinearOperator<Vector, Vector>
+{
+public:
+    using Base = Dune::LinearOperator<Vector, Vector>;
+    using field_type = typename Base::field_type;
+    using Block = typename Matrix::block_type;
+    using VectorBlock = typename Vector::block_type;
+
+    explicit ChainCondensation(const std::vector<std::vector<int>>& chains)
+    {
+        for (const auto& cells : chains) {
+            if (!cells.empty()) {
+                chains_.emplace_back();
+                chains_.back().cells = cells;
+            }
+        }
+    }
+
+    /// The number of chains which are condensed, known after the first condense().
+    std::size_t numChains() const
+    {
+        return chains_.size();
+    }
+
+    /// Move the chains out of the system A x = b, keeping their
+    /// coefficients for apply() and recover().
+    void condense(Matrix& A, Vector& b)
+    {
+        if (!patternChecked_) {
+            checkPattern_(A);
+        }
+
+        for (auto& chain : chains_) {
+            extract_(chain, A, b);
+            factorize_(chain);
+
+            // b - B D^-1 c
+            const auto z = solveChain_(chain, chain.rhs);
+            for (const auto& coupling : chain.fromChain) {
+                coupling.block.mmv(z[coupling.position], b[coupling.cell]);
+            }
+        }
+    }
+
+    /// y -= B D^-1 C x, i.e. the operator adds to y like the well operator.
+    void apply(const Vector& x, Vector& y) const override
+    {
+        applyscaleadd(1.0, x, y);
+    }
+
+    /// y -= alpha B D^-1 C x
+    void applyscaleadd(field_type alpha, const Vector& x, Vector& y) const override
+    {
+        for (const auto& chain : chains_) {
+            std::vector<VectorBlock> r(chain.cells.size(), VectorBlock(0.0));
+            for (const auto& coupling : chain.toChain) {
+                coupling.block.umv(x[coupling.cell], r[coupling.position]);
+            }
+            auto z = solveChain_(chain, r);
+            for (const auto& coupling : chain.fromChain) {
+                auto zk = z[coupling.position];
+                zk *= alpha;
+                coupling.block.mmv(zk, y[coupling.cell]);
+            }
+        }
+    }
+
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+
+    /// Compute the solution of the chain cells, y = D^-1 (c - C x), from
+    /// the solution of the other cells.
+    void recover(Vector& x) const
+    {
+        for (const auto& chain : chains_) {
+            auto r = chain.rhs;
+            for (const auto& coupling : chain.toChain) {
+                coupling.block.mmv(x[coupling.cell], r[coupling.position]);
+            }
+            const auto z = solveChain_(chain, r);
+            for (std::size_t k = 0; k < chain.cells.size(); ++k) {
+                x[chain.cells[k]] = z[k];
+            }
+        }
+    }
+
+private:
+    // A block coupling a cell outside of the chains to the cell at a
+    // position of a chain.
+    struct Coupling
+    {
+        int cell;
+        std::size_t position;
+        Block block;
+    };
+
+    struct Chain
+    {
+        std::vector<int> cells;
+        // D: the blocks coupling a cell to its predecessor, itself and its successor
+        std::vector<Block> lower;
+        std::vector<Block> diagonal;
+        std::vector<Block> upper;
+        // the block LU factors of D: the inverted pivots and the eliminated upper blocks
+        std::vector<Block> pivotInverse;
+        std::vector<Block> eliminatedUpper;
+        // C and B
+        std::vector<Coupling> toChain;
+        std::vector<Coupling> fromChain;
+        // c
+        std::vector<VectorBlock> rhs;
+    };
+
+    // Drop the chains which are coupled to other cells of the chains than
+    // their neighbours, or which share cells.
+    void checkPattern_(const Matrix& A)
+    {
+        std::vector<int> chainOfCell(A.N(), -1);
+        std::vector<std::size_t> positionOfCell(A.N(), 0);
+        std::vector<bool> valid(chains_.size(), true);
+        for (std::size_t chainIdx = 0; chainIdx < chains_.size(); ++chainIdx) {
+            const auto& cells = chains_[chainIdx].cells;
+            for (std::size_t k = 0; k < cells.size(); ++k) {
+                if (chainOfCell[cells[k]] >= 0) {
+                    valid[chainIdx] = false;
+                    valid[chainOfCell[cells[k]]] = false;
+                }
+                chainOfCell[cells[k]] = chainIdx;
+                positionOfCell[cells[k]] = k;
+            }
+        }
+
+        for (std::size_t chainIdx = 0; chainIdx < chains_.size(); ++chainIdx) {
+            const auto& cells = chains_[chainIdx].cells;
+            for (std::size_t k = 0; k < cells.size() && valid[chainIdx]; ++k) {
+                const auto& row = A[cells[k]];
+                for (auto col = row.begin(); col != row.end(); ++col) {
+                    const int other = chainOfCell[col.index()];
+                    if (other < 0) {
+                        continue;
+                    }
+                    const std::size_t position = positionOfCell[col.index()];
+                    if (other != static_cast<int>(chainIdx) || position + 1 < k || position > k + 1) {
+                        valid[chainIdx] = false;
+                        if (other != static_cast<int>(chainIdx)) {
+                            valid[other] = false;
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<Chain> validChains;
+        for (std::size_t chainIdx = 0; chainIdx < chains_.size(); ++chainIdx) {
+            if (valid[chainIdx]) {
+                validChains.push_back(std::move(chains_[chainIdx]));
+            }
+        }
+        chains_ = std::move(validChains);
+        patternChecked_ = true;
+    }
+
+    // Copy the coefficients of a chain and replace them by the identity.
+    void extract_(Chain& chain, Matrix& A, Vector& b) const
+    {
+        const auto& cells = chain.cells;
+        const std::size_t n = cells.size();
+        chain.lower.assign(n, Block(0.0));
+        chain.diagonal.assign(n, Block(0.0));
+        chain.upper.assign(n, Block(0.0));
+        chain.toChain.clear();
+        chain.fromChain.clear();
+        chain.rhs.resize(n);
+
+        for (std::size_t k = 0; k < n; ++k) {
+            const int cell = cells[k];
+            auto& row = A[cell];
+            for (auto col = row.begin(); col != row.end(); ++col) {
+                const int j = col.index();
+                if (j == cell) {
+                    chain.diagonal[k] = *col;
+                    *col = 0.0;
+                    for (int i = 0; i < Block::rows; ++i) {
+                        (*col)[i][i] = 1.0;
+                    }
+                    continue;
+                }
+
+                if (k > 0 && j == cells[k - 1]) {
+                    chain.lower[k] = *col;
+                }
+                else if (k + 1 < n && j == cells[k + 1]) {
+                    chain.upper[k] = *col;
+                }
+                else {
+                    chain.toChain.push_back({j, k, *col});
+                    auto ji = A[j].find(cell);
+                    if (ji != A[j].end()) {
+                        chain.fromChain.push_back({j, k, *ji});
+                        *ji = 0.0;
+                    }
+                }
+                *col = 0.0;
+            }
+            chain.rhs[k] = b[cell];
+            b[cell] = 0.0;
+        }
+    }
+
+    // Block LU factorization of the tridiagonal D without pivoting between
+    // cells, i.e. the Thomas algorithm.
+    static void factorize_(Chain& chain)
+    {
+        const std::size_t n = chain.cells.size();
+        chain.pivotInverse.resize(n);
+        chain.eliminatedUpper.resize(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            Block pivot = chain.diagonal[k];
+            if (k > 0) {
+                Block product = chain.lower[k];
+                product.rightmultiply(chain.eliminatedUpper[k - 1]);
+                pivot -= product;
+            }
+            pivot.invert();
+            chain.pivotInverse[k] = pivot;
+            chain.eliminatedUpper[k] = pivot;
+            chain.eliminatedUpper[k].rightmultiply(chain.upper[k]);
+        }
+    }
+
+    // D^-1 r
+    static std::vector<VectorBlock> solveChain_(const Chain& chain, const std::vector<VectorBlock>& r)
+    {
+        const std::size_t n = chain.cells.size();
+        std::vector<VectorBlock> z(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            VectorBlock rk = r[k];
+            if (k > 0) {
+                chain.lower[k].mmv(z[k - 1], rk);
+            }
+            chain.pivotInverse[k].mv(rk, z[k]);
+        }
+        for (std::size_t k = n - 1; k-- > 0; ) {
+            chain.eliminatedUpper[k].mmv(z[k + 1], z[k]);
+        }
+        return z;
+    }
+
+    std::vector<Chain> chains_;
+    bool patternChecked_ = false;
+};
+
+} // namespace Opm
+
+#endif // OPM_CHAINCONDENSATION_HEADER_INCLUDED
@@ -0,0 +1,137 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FIRSTTOUCHALLOCATOR_HEADER_INCLUDED
+#define OPM_FIRSTTOUCHALLOCATOR_HEADER_INCLUDED
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace Opm
+{
+
+namespace Details
+{
+    /// Allocations of at least this size are aligned to it, which is the
+    /// size of a transparent huge page on x86-64.
+    constexpr std::size_t firstTouchHugePageSize = std::size_t(2) << 20;
+
+    /// Distance between the bytes written when touching the pages.
+    constexpr std::size_t firstTouchPageSize = 4096;
+
+    inline bool firstTouchIsLarge(const std::size_t bytes)
+    {
+        return bytes >= firstTouchHugePageSize;
+    }
+
+    inline void* firstTouchAllocate(const std::size_t bytes)
+    {
+        if (!firstTouchIsLarge(bytes)) {
+            return ::operator new(bytes);
+        }
+        const std::size_t alignedBytes
+            = (bytes + firstTouchHugePageSize - 1) / firstTouchHugePageSize * firstTouchHugePageSize;
+        void* ptr = std::aligned_alloc(firstTouchHugePageSize, alignedBytes);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // Only advice, fails silently if transparent huge pages are disabled.
+        madvise(ptr, alignedBytes, MADV_HUGEPAGE);
+#endif
+        // Touch the pages in the same static partition that the threaded
+        // loops over the rows use, such that the kernel places every page
+        // on the NUMA node of the thread that will work on it.
+        auto* bytePtr = static_cast<char*>(ptr);
+        const long long numPages = static_cast<long long>(alignedBytes / firstTouchPageSize);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long long p = 0; p < numPages; ++p) {
+            bytePtr[p * firstTouchPageSize] = 0;
+        }
+        return ptr;
+    }
+
+    inline void firstTouchDeallocate(void* ptr, const std::size_t bytes)
+    {
+        if (firstTouchIsLarge(bytes)) {
+            std::free(ptr);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+} // namespace Details
+
+/// An allocator for the large arrays of the linear solver.
+///
+/// Small allocations are passed on to operator new. Large ones are aligned
+/// to huge pages, which are requested with madvise() where available, and
+/// their pages are first written in parallel with OpenMP. On a machine
+/// with several NUMA nodes the memory therefore ends up distributed over
+/// the nodes of the threads instead of on the node of the master thread,
+/// even if the values are written by the master thread afterwards.
+template <class T>
+class FirstTouchAllocator
+{
+public:
+    using value_type = T;
+
+    FirstTouchAllocator() noexcept = default;
+
+    template <class U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(const std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(Details::firstTouchAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, const std::size_t n) noexcept
+    {
+        Details::firstTouchDeallocate(ptr, n * sizeof(T));
+    }
+};
+
+template <class T, class U>
+bool operator==(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&) noexcept
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&) noexcept
+{
+    return false;
+}
+
+} // namespace Opm
+
+#endif // OPM_FIRSTTOUCHALLOCATOR_HEADER_INCLUDED
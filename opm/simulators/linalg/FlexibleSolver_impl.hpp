@@ -23,6 +23,7 @@
 
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
 #include <opm/simulators/linalg/PreconditionerFactory.hpp>
+#include <opm/simulators/linalg/RecycledGMResSolver.hpp>
 #include <opm/simulators/linalg/matrixblock.hh>
 
 #include <dune/common/fmatrix.hh>
@@ -112,6 +113,11 @@ namespace Dune
                                                                                     weightsCalculator,
                                                                                     comm);
         scalarproduct_ = Dune::createScalarProduct<VectorType, Comm>(comm, op.category());
+        if (op.category() == Dune::SolverCategory::overlapping) {
+            fusedproducts_ = std::make_shared<Dune::FusedScalarProducts<VectorType>>(comm, op.getmat().N());
+        } else {
+            fusedproducts_ = std::make_shared<Dune::FusedScalarProducts<VectorType>>();
+        }
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -133,6 +139,7 @@ namespace Dune
                                                                               child ? *child : pt(),
                                                                               weightsCalculator);
         scalarproduct_ = std::make_shared<Dune::SeqScalarProduct<VectorType>>();
+        fusedproducts_ = std::make_shared<Dune::FusedScalarProducts<VectorType>>();
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -168,6 +175,33 @@ namespace Dune
                                                                         restart, // desired residual reduction factor
                                                                         maxiter, // maximum number of iterations
                                                                         verbosity));
+        } else if (solver_type == "pbicgstab") {
+            linsolver_.reset(new Dune::PipelinedBiCGSTABSolver<VectorType>(*linearoperator_for_solver_,
+                                                                           fusedproducts_,
+                                                                           *preconditioner_,
+                                                                           tol, // desired residual reduction factor
+                                                                           maxiter, // maximum number of iterations
+                                                                           verbosity));
+        } else if (solver_type == "lowsyncgmres") {
+            int restart = prm.get<int>("restart", 15);
+            linsolver_.reset(new Dune::LowSyncGMResSolver<VectorType>(*linearoperator_for_solver_,
+                                                                      fusedproducts_,
+                                                                      *preconditioner_,
+                                                                      tol, // desired residual reduction factor
+                                                                      restart,
+                                                                      maxiter, // maximum number of iterations
+                                                                      verbosity));
+        } else if (solver_type == "recycledgmres") {
+            int restart = prm.get<int>("restart", 15);
+            int recycle = prm.get<int>("recycle", 4);
+            linsolver_.reset(new Dune::RecycledGMResSolver<VectorType>(*linearoperator_for_solver_,
+                                                                       fusedproducts_,
+                                                                       *preconditioner_,
+                                                                       tol, // desired residual reduction factor
+                                                                       restart,
+                                                                       maxiter, // maximum number of iterations
+                                                                       recycle, // number of stored corrections
+                                                                       verbosity));
 #if HAVE_SUITESPARSE_UMFPACK
         } else if (solver_type == "umfpack") {
             bool dummy = false;
@@ -82,6 +82,10 @@ struct IluReorderSpheres {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct IluReverseCuthillMckee {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct UseGmres {
     using type = UndefinedProperty;
 };
@@ -114,6 +118,14 @@ struct CprReuseSetup {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct CprReuseIterationRatio {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct CprWeightsReuseTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct Linsolver {
     using type = UndefinedProperty;
 };
@@ -134,9 +146,57 @@ struct OpenclIluReorder {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct OpenclPreconditioner {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OpenclIluFillinLevel {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OpenclIluRelaxation {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OpenclKernelCacheDir {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct FpgaBitstream {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct AcceleratorAdaptiveTrialSolves {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AcceleratorAdaptiveIterationRatio {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverDumpSystem {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverDumpOnFailure {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct CondenseNumericalAquifers {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverFallback {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAutotune {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAutotuneOutput {
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct LinearSolverReduction<TypeTag, TTag::FlowIstlSolverParams> {
@@ -177,6 +237,10 @@ struct IluReorderSpheres<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr bool value = false;
 };
 template<class TypeTag>
+struct IluReverseCuthillMckee<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
 struct UseGmres<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr bool value = false;
 };
@@ -213,6 +277,16 @@ struct CprReuseSetup<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr int value = 3;
 };
 template<class TypeTag>
+struct CprReuseIterationRatio<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 2.0;
+};
+template<class TypeTag>
+struct CprWeightsReuseTolerance<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
 struct Linsolver<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "ilu0";
 };
@@ -233,9 +307,59 @@ struct OpenclIluReorder<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = ""; // note: default value is chosen depending on the solver used
 };
 template<class TypeTag>
+struct OpenclPreconditioner<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "bilu0";
+};
+template<class TypeTag>
+struct OpenclIluFillinLevel<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct OpenclIluRelaxation<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct OpenclKernelCacheDir<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
 struct FpgaBitstream<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "";
 };
+template<class TypeTag>
+struct AcceleratorAdaptiveTrialSolves<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct AcceleratorAdaptiveIterationRatio<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 3.0;
+};
+template<class TypeTag>
+struct LinearSolverDumpSystem<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct LinearSolverDumpOnFailure<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct CondenseNumericalAquifers<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct LinearSolverFallback<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct LinearSolverAutotune<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct LinearSolverAutotuneOutput<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "linear_solver_autotuned.json";
+};
 
 } // namespace Opm::Properties
 
@@ -255,6 +379,7 @@ namespace Opm
         MILU_VARIANT   ilu_milu_;
         bool   ilu_redblack_;
         bool   ilu_reorder_sphere_;
+        bool   ilu_reverse_cuthill_mckee_;
         bool   newton_use_gmres_;
         bool   require_full_sparsity_pattern_;
         bool   ignoreConvergenceFailure_;
@@ -265,8 +390,23 @@ namespace Opm
         int opencl_platform_id_;
         int cpr_max_ell_iter_ = 20;
         int cpr_reuse_setup_ = 0;
+        double cpr_reuse_iteration_ratio_ = 2.0;
+        double cpr_weights_reuse_tolerance_ = 0.0;
         std::string opencl_ilu_reorder_;
+        std::string opencl_preconditioner_;
+        int opencl_ilu_fillin_level_;
+        double opencl_ilu_relaxation_;
+        std::string opencl_kernel_cache_dir_;
         std::string fpga_bitstream_;
+        int accelerator_adaptive_trial_solves_;
+        double accelerator_adaptive_iteration_ratio_;
+        int dump_system_;
+        bool dump_on_failure_;
+        bool condense_numerical_aquifers_;
+        bool preconditioner_add_well_contributions_;
+        std::string linear_solver_fallback_;
+        int autotune_solves_;
+        std::string autotune_output_;
 
         template <class TypeTag>
         void init()
@@ -281,18 +421,34 @@ namespace Opm
             ilu_milu_ = convertString2Milu(EWOMS_GET_PARAM(TypeTag, std::string, MiluVariant));
             ilu_redblack_ = EWOMS_GET_PARAM(TypeTag, bool, IluRedblack);
             ilu_reorder_sphere_ = EWOMS_GET_PARAM(TypeTag, bool, IluReorderSpheres);
+            ilu_reverse_cuthill_mckee_ = EWOMS_GET_PARAM(TypeTag, bool, IluReverseCuthillMckee);
             newton_use_gmres_ = EWOMS_GET_PARAM(TypeTag, bool, UseGmres);
             require_full_sparsity_pattern_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern);
             ignoreConvergenceFailure_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure);
             scale_linear_system_ = EWOMS_GET_PARAM(TypeTag, bool, ScaleLinearSystem);
             cpr_max_ell_iter_  =  EWOMS_GET_PARAM(TypeTag, int, CprMaxEllIter);
             cpr_reuse_setup_  =  EWOMS_GET_PARAM(TypeTag, int, CprReuseSetup);
+            cpr_reuse_iteration_ratio_ = EWOMS_GET_PARAM(TypeTag, double, CprReuseIterationRatio);
+            cpr_weights_reuse_tolerance_ = EWOMS_GET_PARAM(TypeTag, double, CprWeightsReuseTolerance);
             linsolver_ = EWOMS_GET_PARAM(TypeTag, std::string, Linsolver);
             accelerator_mode_ = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
             bda_device_id_ = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
             opencl_platform_id_ = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
             opencl_ilu_reorder_ = EWOMS_GET_PARAM(TypeTag, std::string, OpenclIluReorder);
+            opencl_preconditioner_ = EWOMS_GET_PARAM(TypeTag, std::string, OpenclPreconditioner);
+            opencl_ilu_fillin_level_ = EWOMS_GET_PARAM(TypeTag, int, OpenclIluFillinLevel);
+            opencl_ilu_relaxation_ = EWOMS_GET_PARAM(TypeTag, double, OpenclIluRelaxation);
+            opencl_kernel_cache_dir_ = EWOMS_GET_PARAM(TypeTag, std::string, OpenclKernelCacheDir);
             fpga_bitstream_ = EWOMS_GET_PARAM(TypeTag, std::string, FpgaBitstream);
+            accelerator_adaptive_trial_solves_ = EWOMS_GET_PARAM(TypeTag, int, AcceleratorAdaptiveTrialSolves);
+            accelerator_adaptive_iteration_ratio_ = EWOMS_GET_PARAM(TypeTag, double, AcceleratorAdaptiveIterationRatio);
+            dump_system_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverDumpSystem);
+            dump_on_failure_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverDumpOnFailure);
+            condense_numerical_aquifers_ = EWOMS_GET_PARAM(TypeTag, bool, CondenseNumericalAquifers);
+            preconditioner_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, PreconditionerAddWellContributions);
+            linear_solver_fallback_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverFallback);
+            autotune_solves_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverAutotune);
+            autotune_output_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverAutotuneOutput);
         }
 
         template <class TypeTag>
@@ -307,18 +463,34 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, std::string, MiluVariant, "Specify which variant of the modified-ILU preconditioner ought to be used. Possible variants are: ILU (default, plain ILU), MILU_1 (lump diagonal with dropped row entries), MILU_2 (lump diagonal with the sum of the absolute values of the dropped row  entries), MILU_3 (if diagonal is positive add sum of dropped row entrires. Otherwise substract them), MILU_4 (if diagonal is positive add sum of dropped row entrires. Otherwise do nothing");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluRedblack, "Use red-black partioning for the ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluReorderSpheres, "Whether to reorder the entries of the matrix in the red-black ILU preconditioner in spheres starting at an edge. If false the original ordering is preserved in each color. Otherwise why try to ensure D4 ordering (in a 2D structured grid, the diagonal elements are consecutive).");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluReverseCuthillMckee, "Factorize the matrix in a reverse Cuthill-McKee ordering in the ILU preconditioner of the Dune solvers (including the fine smoother of CPR). The ordering reduces the bandwidth of the matrix, which improves the memory locality of the ILU factorization and application");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseGmres, "Use GMRES as the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern, "Produce the full sparsity pattern for the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure, "Continue with the simulation like nothing happened after the linear solver did not converge");
-            EWOMS_REGISTER_PARAM(TypeTag, bool, ScaleLinearSystem, "Scale linear system according to equation scale and primary variable types");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ScaleLinearSystem, "Scale the equations of the linear system by the largest entries of their diagonal blocks (requires --matrix-add-well-contributions=true)");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprMaxEllIter, "MaxIterations of the elliptic pressure part of the cpr solver");
-            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup. Valid options are 0: recreate the preconditioner for every linear solve, 1: recreate once every timestep, 2: recreate if last linear solve took more than 10 iterations, 3: never recreate");
-            EWOMS_REGISTER_PARAM(TypeTag, std::string, Linsolver, "Configuration of solver. Valid options are: ilu0 (default), cpr (an alias for cpr_trueimpes), cpr_quasiimpes, cpr_trueimpes or amg. Alternatively, you can request a configuration to be read from a JSON file by giving the filename here, ending with '.json.'");
-            EWOMS_REGISTER_PARAM(TypeTag, std::string, AcceleratorMode, "Use GPU (cusparseSolver or openclSolver) or FPGA (fpgaSolver) as the linear solver, usage: '--accelerator-mode=[none|cusparse|opencl|fpga]'");
-            EWOMS_REGISTER_PARAM(TypeTag, int, BdaDeviceId, "Choose device ID for cusparseSolver or openclSolver, use 'nvidia-smi' or 'clinfo' to determine valid IDs");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup. Valid options are 0: recreate the preconditioner for every linear solve, 1: recreate once every timestep, 2: recreate if last linear solve took more than 10 iterations, 3: never recreate, 4: recreate if last linear solve took more than CprReuseIterationRatio times the iterations of the first solve after the previous recreation");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprReuseIterationRatio, "Tolerated growth of the linear iteration count, relative to the first solve after a full preconditioner setup, before the setup is considered stale (only used with --cpr-reuse-setup=4)");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprWeightsReuseTolerance, "If larger than 0, keep the quasi-IMPES weights of the CPR preconditioner of the cells whose diagonal block changed by less than this fraction since the weights were computed");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, Linsolver, "Configuration of solver. Valid options are: ilu0 (default), cpr (an alias for cpr_trueimpes), cpr_quasiimpes, cpr_trueimpes, cprw (cpr with the well equations in the pressure system, sequential runs only), amg or umfpack (direct solver, small sequential systems only). Alternatively, you can request a configuration to be read from a JSON file by giving the filename here, ending with '.json.'");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, AcceleratorMode, "Use GPU (cusparseSolver, openclSolver or rocsparseSolver) or FPGA (fpgaSolver) as the linear solver, usage: '--accelerator-mode=[none|cusparse|opencl|fpga|rocsparse]'");
+            EWOMS_REGISTER_PARAM(TypeTag, int, BdaDeviceId, "Choose device ID for cusparseSolver or openclSolver, use 'nvidia-smi' or 'clinfo' to determine valid IDs. In a parallel run with openclSolver, process i on a node uses device BdaDeviceId+i");
             EWOMS_REGISTER_PARAM(TypeTag, int, OpenclPlatformId, "Choose platform ID for openclSolver, use 'clinfo' to determine valid platform IDs");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, OpenclIluReorder, "Choose the reordering strategy for ILU for openclSolver and fpgaSolver, usage: '--opencl-ilu-reorder=[level_scheduling|graph_coloring], level_scheduling behaves like Dune and cusparse, graph_coloring is more aggressive and likely to be faster, but is random-based and generally increases the number of linear solves and linear iterations significantly.");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, OpenclPreconditioner, "Choose the preconditioner for openclSolver, usage: '--opencl-preconditioner=[bilu0|cpr]', cpr applies an AMG V-cycle to the quasi-IMPES pressure system before BILU0");
+            EWOMS_REGISTER_PARAM(TypeTag, int, OpenclIluFillinLevel, "The fill-in level of the ILU preconditioner of openclSolver, the ILU(k) pattern is found on the CPU once per sparsity pattern, the decomposition is done on the GPU");
+            EWOMS_REGISTER_PARAM(TypeTag, double, OpenclIluRelaxation, "The fraction of the dropped fill-in that is added to the diagonal by the ILU preconditioner of openclSolver, 0 gives the regular ILU, 1 gives the modified ILU");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, OpenclKernelCacheDir, "If not empty, store the compiled kernels of openclSolver in this directory and reuse them in later runs on the same device and driver, instead of compiling them at every start");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, FpgaBitstream, "Specify the bitstream file for fpgaSolver (including path), usage: '--fpga-bitstream=<filename>'");
+            EWOMS_REGISTER_PARAM(TypeTag, int, AcceleratorAdaptiveTrialSolves, "If larger than 0, time the accelerator and the Dune solver on this many linear solves each at the start of every report step, and use the faster one for the rest of the report step (only used with --accelerator-mode other than none)");
+            EWOMS_REGISTER_PARAM(TypeTag, double, AcceleratorAdaptiveIterationRatio, "Switch from the accelerator back to Dune for the rest of the report step if a linear solve takes more than this many times the iterations seen during the trial (only used with --accelerator-adaptive-trial-solves > 0)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverDumpSystem, "If larger than 0, write the linear system of this linear solve (counting from 1) to a binary file in the reports directory, including the blocks of the wells if they are not part of the matrix");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverDumpOnFailure, "Write the linear system to a binary file in the reports directory whenever the linear solver does not converge");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, CondenseNumericalAquifers, "Eliminate the chains of numerical aquifer cells from the linear system and apply them like the wells, which keeps them out of the preconditioner (only used in sequential runs of the Dune solvers)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, PreconditionerAddWellContributions, "Add the well contributions to a copy of the matrix used only for the preconditioner, keeping its sparsity pattern by lumping the couplings between cells which are not neighbours into the diagonal blocks, while the wells are applied exactly in the linear operator (only used in sequential runs with --matrix-add-well-contributions=false)");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverFallback, "Comma-separated list of linear solver configurations (like --linear-solver-configuration, e.g. 'cpr_quasiimpes,ilu0,umfpack', or JSON files) tried in turn when the Dune linear solver does not converge, before the time step is chopped. umfpack is only tried in sequential runs with --matrix-add-well-contributions=true");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverAutotune, "If larger than 0, time this many linear solves (setup and solve) each with the configured Dune linear solver and a few variations of it at the start of the simulation, use the fastest afterwards and write its configuration to --linear-solver-autotune-output");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverAutotuneOutput, "JSON file, relative to the output directory, for the configuration chosen by --linear-solver-autotune. It can be passed to --linear-solver-configuration in later runs");
         }
 
         FlowLinearSolverParameters() { reset(); }
@@ -338,11 +510,27 @@ namespace Opm
             ilu_milu_                 = MILU_VARIANT::ILU;
             ilu_redblack_             = false;
             ilu_reorder_sphere_       = true;
+            ilu_reverse_cuthill_mckee_ = false;
             accelerator_mode_         = "none";
             bda_device_id_            = 0;
             opencl_platform_id_       = 0;
             opencl_ilu_reorder_       = "";  // note: the default value is chosen depending on the solver used
+            opencl_preconditioner_    = "bilu0";
+            opencl_ilu_fillin_level_  = 0;
+            opencl_ilu_relaxation_    = 0.0;
+            opencl_kernel_cache_dir_  = "";
             fpga_bitstream_           = "";
+            accelerator_adaptive_trial_solves_ = 0;
+            accelerator_adaptive_iteration_ratio_ = 3.0;
+            dump_system_ = 0;
+            dump_on_failure_ = false;
+            condense_numerical_aquifers_ = false;
+            preconditioner_add_well_contributions_ = false;
+            linear_solver_fallback_ = "";
+            autotune_solves_ = 0;
+            autotune_output_ = "linear_solver_autotuned.json";
+            cpr_reuse_iteration_ratio_ = 2.0;
+            cpr_weights_reuse_tolerance_ = 0.0;
         }
     };
 
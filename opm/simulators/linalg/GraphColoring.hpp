@@ -241,5 +241,84 @@ reorderVerticesSpheres(const std::vector<int>& colors, int noColors,
     }
     return indices;
 }
+
+/// \brief Reverse Cuthill-McKee ordering of the vertices of a graph.
+///
+/// Gives a numbering with a small bandwidth, i.e. neighbouring vertices get
+/// close indices. Every connected component is numbered by a breadth first
+/// search from a vertex of minimal degree, visiting the neighbours of each
+/// vertex in the order of increasing degree, and the numbering is reversed
+/// at the end.
+/// \param graph The graph to reorder. Must adhere to the graph interface of dune-istl.
+/// \param noVertices Only the vertices 0, ..., noVertices-1 are reordered, the
+///                   others keep their index (e.g. the ghost rows of a matrix).
+/// \return The new index of every vertex.
+template<class Graph>
+std::vector<std::size_t>
+reorderVerticesReverseCuthillMcKee(const Graph& graph, std::size_t noVertices)
+{
+    using Vertex = typename Graph::VertexDescriptor;
+    std::vector<std::size_t> indices(graph.maxVertex() + 1);
+    std::iota(indices.begin(), indices.end(), 0);
+    noVertices = std::min(noVertices, indices.size());
+
+    std::vector<std::size_t> degrees(noVertices, 0);
+    for (std::size_t vertex = 0; vertex < noVertices; ++vertex)
+    {
+        for (auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+             edge != endEdge; ++edge)
+        {
+            const std::size_t target = edge.target();
+            if (target != vertex && target < noVertices)
+                ++degrees[vertex];
+        }
+    }
+    auto lowerDegree = [&degrees](std::size_t v1, std::size_t v2)
+    {
+        return degrees[v1] < degrees[v2];
+    };
+
+    // Candidates for the start of the search in each connected component.
+    std::vector<std::size_t> startVertices(noVertices);
+    std::iota(startVertices.begin(), startVertices.end(), 0);
+    std::stable_sort(startVertices.begin(), startVertices.end(), lowerDegree);
+
+    std::vector<char> visited(noVertices, false);
+    std::vector<std::size_t> order;
+    order.reserve(noVertices);
+    auto nextStart = startVertices.begin();
+
+    while (order.size() < noVertices)
+    {
+        while (visited[*nextStart])
+            ++nextStart;
+        visited[*nextStart] = true;
+        order.push_back(*nextStart);
+
+        // The order of the visited vertices is the queue of the search.
+        for (std::size_t current = order.size() - 1; current < order.size(); ++current)
+        {
+            const auto firstNeighbour = order.size();
+            const Vertex vertex = order[current];
+            for (auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+                 edge != endEdge; ++edge)
+            {
+                const std::size_t target = edge.target();
+                if (target < noVertices && !visited[target])
+                {
+                    visited[target] = true;
+                    order.push_back(target);
+                }
+            }
+            std::stable_sort(order.begin() + firstNeighbour, order.end(), lowerDegree);
+        }
+    }
+
+    for (std::size_t i = 0; i < noVertices; ++i)
+    {
+        indices[order[i]] = noVertices - 1 - i;
+    }
+    return indices;
+}
 } // end namespace Opm
 #endif
@@ -24,8 +24,13 @@
 
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/propertysystem.hh>
+#include <opm/simulators/linalg/AdaptiveSolverSelector.hpp>
+#include <opm/simulators/linalg/ChainCondensation.hpp>
 #include <opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp>
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/LinearSolverAutotuner.hpp>
+#include <opm/simulators/linalg/LinearSystemScaling.hpp>
+#include <opm/simulators/linalg/LinearSystemView.hpp>
 #include <opm/simulators/linalg/MatrixBlock.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 #include <opm/simulators/linalg/WellOperators.hpp>
@@ -33,9 +38,25 @@
 #include <opm/simulators/linalg/findOverlapRowsAndColumns.hpp>
 #include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
 #include <opm/simulators/linalg/setupPropertyTree.hpp>
+#include <opm/simulators/utils/MemoryAccounting.hpp>
 
 
-#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <dune/common/timer.hh>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
 #include <opm/simulators/linalg/bda/BdaBridge.hpp>
 #endif
 
@@ -92,10 +113,15 @@ namespace Opm
         using WellModelOperator = WellModelAsLinearOperator<WellModel, Vector, Vector>;
         using ElementMapper = GetPropType<TypeTag, Properties::ElementMapper>;
 
-#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
         static const unsigned int block_size = Matrix::block_type::rows;
         std::unique_ptr<BdaBridge<Matrix, Vector, block_size>> bdaBridge;
+        // reused between linear solves, so that the memory for the StandardWells is only allocated once
+        std::unique_ptr<WellContributions> wellContribs_;
 #endif
+        // only set with --accelerator-adaptive-trial-solves > 0
+        std::unique_ptr<AdaptiveSolverSelector> solverSelector_;
+        int selectorEpisode_ = -1;
 
 #if HAVE_MPI
         using CommunicationType = Dune::OwnerOverlapCopyCommunication<int,int>;
@@ -117,6 +143,8 @@ namespace Opm
         explicit ISTLSolverEbos(const Simulator& simulator)
             : simulator_(simulator),
               iterations_( 0 ),
+              iterationsAfterSetup_( -1 ),
+              lastSolveOnAccelerator_( false ),
               converged_(false),
               matrix_()
         {
@@ -126,23 +154,43 @@ namespace Opm
 #endif
             parameters_.template init<TypeTag>();
             prm_ = setupPropertyTree<TypeTag>(parameters_);
-#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
             {
                 std::string accelerator_mode = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
-                if ((simulator_.vanguard().grid().comm().size() > 1) && (accelerator_mode != "none")) {
+                const bool parallel_run = simulator_.vanguard().grid().comm().size() > 1;
+                if (parallel_run && (accelerator_mode != "none") && (accelerator_mode != "opencl")) {
                     if (on_io_rank) {
-                        OpmLog::warning("Cannot use GPU or FPGA with MPI, GPU/FPGA are disabled");
+                        OpmLog::warning("Cannot use cusparseSolver, rocsparseSolver or FPGA with MPI, use '--accelerator-mode=opencl', GPU/FPGA are disabled");
                     }
                     accelerator_mode = "none";
                 }
                 const int platformID = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
-                const int deviceID = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
+                int deviceID = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
+#if HAVE_MPI
+                if (parallel_run && accelerator_mode == "opencl") {
+                    // one device per process, counting from BdaDeviceId on every node
+                    MPI_Comm node_comm;
+                    int node_rank = 0;
+                    MPI_Comm_split_type(simulator_.vanguard().grid().comm(), MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+                    MPI_Comm_rank(node_comm, &node_rank);
+                    MPI_Comm_free(&node_comm);
+                    deviceID += node_rank;
+                }
+#endif
                 const int maxit = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIter);
                 const double tolerance = EWOMS_GET_PARAM(TypeTag, double, LinearSolverReduction);
                 const std::string opencl_ilu_reorder = EWOMS_GET_PARAM(TypeTag, std::string, OpenclIluReorder);
+                const std::string opencl_preconditioner = EWOMS_GET_PARAM(TypeTag, std::string, OpenclPreconditioner);
+                const int opencl_ilu_fillin_level = EWOMS_GET_PARAM(TypeTag, int, OpenclIluFillinLevel);
+                const double opencl_ilu_relaxation = EWOMS_GET_PARAM(TypeTag, double, OpenclIluRelaxation);
+                const std::string opencl_kernel_cache_dir = EWOMS_GET_PARAM(TypeTag, std::string, OpenclKernelCacheDir);
                 const int linear_solver_verbosity = parameters_.linear_solver_verbosity_;
                 std::string fpga_bitstream = EWOMS_GET_PARAM(TypeTag, std::string, FpgaBitstream);
-                bdaBridge.reset(new BdaBridge<Matrix, Vector, block_size>(accelerator_mode, fpga_bitstream, linear_solver_verbosity, maxit, tolerance, platformID, deviceID, opencl_ilu_reorder));
+                bdaBridge.reset(new BdaBridge<Matrix, Vector, block_size>(accelerator_mode, fpga_bitstream, linear_solver_verbosity, maxit, tolerance, platformID, deviceID, opencl_ilu_reorder, opencl_preconditioner, opencl_ilu_fillin_level, opencl_ilu_relaxation, opencl_kernel_cache_dir));
+                if (accelerator_mode != "none" && parameters_.accelerator_adaptive_trial_solves_ > 0) {
+                    solverSelector_ = std::make_unique<AdaptiveSolverSelector>(parameters_.accelerator_adaptive_trial_solves_,
+                                                                               parameters_.accelerator_adaptive_iteration_ratio_);
+                }
             }
 #else
             if (EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode) != "none") {
@@ -175,6 +223,31 @@ namespace Opm
 
             interiorCellNum_ = detail::numMatrixRowsToUseInSolver(simulator_.vanguard().grid(), true);
 
+            // The configurations tried when the linear solver does not converge.
+            std::istringstream fallbacks(parameters_.linear_solver_fallback_);
+            std::string fallback;
+            while (std::getline(fallbacks, fallback, ',')) {
+                if (!fallback.empty()) {
+                    FlowLinearSolverParameters p = parameters_;
+                    p.linsolver_ = fallback;
+                    fallbackPrms_.push_back(setupPropertyTree<TypeTag>(p));
+                }
+            }
+
+            if (parameters_.autotune_solves_ > 0 && parameters_.accelerator_mode_ == "none") {
+                autotuner_ = std::make_unique<LinearSolverAutotuner>(prm_, parameters_.autotune_solves_);
+            }
+
+            if (parameters_.scale_linear_system_) {
+                // The wells and the accelerators apply unscaled equations.
+                if (useWellConn_ && parameters_.accelerator_mode_ == "none") {
+                    scaling_ = std::make_unique<LinearSystemScaling<Matrix, Vector>>();
+                } else if (on_io_rank) {
+                    OpmLog::warning("--scale-linear-system=true is ignored without --matrix-add-well-contributions=true"
+                                    " or with an accelerator.");
+                }
+            }
+
             // Print parameters to PRT/DBG logs.
             if (on_io_rank) {
                 std::ostringstream os;
@@ -198,6 +271,9 @@ namespace Opm
                 assert(parinfo);
                 const size_t size = M.istlMatrix().N();
                 parinfo->copyValuesTo(comm_->indexSet(), comm_->remoteIndices(), size, 1);
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
+                bdaBridge->setCommunication(*comm_);
+#endif
             }
 #endif
 
@@ -216,10 +292,51 @@ namespace Opm
             }
             rhs_ = &b;
 
+            if (firstcall && parameters_.condense_numerical_aquifers_ && !isParallel()
+                && parameters_.accelerator_mode_ == "none") {
+                const auto chains = simulator_.problem().aquiferModel().numericalAquiferChains();
+                if (!chains.empty()) {
+                    chainCondensation_ = std::make_unique<ChainCondensation<Matrix, Vector>>(chains);
+                    // The condensed system is not scaled.
+                    if (scaling_ && simulator_.gridView().comm().rank() == 0) {
+                        OpmLog::warning("--scale-linear-system=true is ignored with the condensed numerical aquifers"
+                                        " of --condense-numerical-aquifers=true.");
+                    }
+                }
+            }
+            if (chainCondensation_) {
+                chainCondensation_->condense(getMatrix(), *rhs_);
+            }
+            scaledWeights_.reset();
+            if (scaling_ && !chainCondensation_) {
+                // The quasi-IMPES weights of the configured CPR preconditioner
+                // are computed in the same pass.
+                std::string weightsType;
+                int pressureIndex;
+                bool transpose;
+                if (cprWeightsSettings(prm_, weightsType, pressureIndex, transpose) && weightsType == "quasiimpes") {
+                    scaling_->scale(getMatrix(), *rhs_, pressureIndex, transpose, cprWeights_);
+                    cprWeightDiagonals_.clear();
+                    scaledWeights_ = std::make_pair(pressureIndex, transpose);
+                } else {
+                    scaling_->scale(getMatrix(), *rhs_);
+                }
+            }
+
+            if (MemoryAccounting::instance().enabled()) {
+                MemoryAccounting::instance().set("jacobian", MemoryAccounting::matrixBytes(getMatrix()));
+            }
+
             if (isParallel() && prm_.get<std::string>("preconditioner.type") != "ParOverILU0") {
                 makeOverlapRowsInvalid(getMatrix());
             }
+            systemView_.update(getMatrix(), *rhs_);
+            if (usePreconditionerWellContributions()) {
+                updatePreconditionerMatrix();
+            }
+            Dune::Timer setupTimer;
             prepareFlexibleSolver();
+            setupSeconds_ = setupTimer.stop();
             firstcall = false;
         }
 
@@ -236,6 +353,27 @@ namespace Opm
             // matrix_ = &M.istlMatrix(); // Must be handled in prepare() instead.
         }
 
+        /// Use the residual reduction max(reduction, configured reduction) for
+        /// the following solves with the Dune solvers, zero restores the
+        /// configured reduction. The accelerators always use the configured one.
+        void setAdaptiveReduction(const double reduction) {
+            adaptiveReduction_ = reduction;
+        }
+
+        /// If true, the next prepare() keeps the preconditioner built for an
+        /// earlier matrix instead of updating it, unless the solver has to be
+        /// recreated anyway.
+        void setReusePreconditioner(const bool reuse) {
+            reusePreconditioner_ = reuse;
+        }
+
+        /// If true, the next solve() with the Dune solvers starts from the
+        /// vector passed to it instead of zero, unless the residual of this
+        /// initial guess is not smaller than the right hand side.
+        void setUseInitialGuess(const bool use) {
+            useInitialGuess_ = use;
+        }
+
         bool solve(Vector& x) {
             // Write linear system if asked for.
             const int verbosity = prm_.get<int>("verbosity", 0);
@@ -246,6 +384,15 @@ namespace Opm
                                     *rhs_,
                                     comm_.get());
             }
+            ++solveCount_;
+            if (solveCount_ == parameters_.dump_system_) {
+                writeBinarySystem(*rhs_);
+            }
+            // The solvers overwrite the rhs.
+            std::optional<Vector> rhsForDump;
+            if (parameters_.dump_on_failure_) {
+                rhsForDump = *rhs_;
+            }
 
             // Solve system.
             Dune::InverseOperatorResult result;
@@ -253,20 +400,42 @@ namespace Opm
 
             // Use GPU if: available, chosen by user, and successful.
             // Use FPGA if: support compiled, chosen by user, and successful.
-#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
             bool use_gpu = bdaBridge->getUseGpu();
             bool use_fpga = bdaBridge->getUseFpga();
+            const bool select_adaptively = solverSelector_ && (use_gpu || use_fpga);
+            bool accelerator_tried = false;
+            int accelerator_iterations = 0;
+            Dune::Timer solve_timer;
+            if (select_adaptively) {
+                const int episode = simulator_.episodeIndex();
+                if (episode != selectorEpisode_) {
+                    selectorEpisode_ = episode;
+                    solverSelector_->newReportStep();
+                }
+                if (!solverSelector_->useAccelerator()) {
+                    use_gpu = false;
+                    use_fpga = false;
+                }
+            }
             if (use_gpu || use_fpga) {
-                const std::string accelerator_mode = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
-                WellContributions wellContribs(accelerator_mode);
-                bdaBridge->initWellContributions(wellContribs);
+                accelerator_tried = true;
+                if (!wellContribs_) {
+                    const std::string accelerator_mode = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
+                    wellContribs_ = std::make_unique<WellContributions>(accelerator_mode);
+                    bdaBridge->initWellContributions(*wellContribs_);
+                } else {
+                    wellContribs_->reset();
+                }
+                WellContributions& wellContribs = *wellContribs_;
 
                 if (!useWellConn_) {
                     simulator_.problem().wellModel().getWellContributions(wellContribs);
                 }
 
                 // Const_cast needed since the CUDA stuff overwrites values for better matrix condition..
-                bdaBridge->solve_system(const_cast<Matrix*>(&getMatrix()), *rhs_, wellContribs, result);
+                bdaBridge->solve_system(const_cast<Matrix*>(&getMatrix()), systemView_, wellContribs, result);
+                accelerator_iterations = result.iterations;
                 if (result.converged) {
                     // get result vector x from non-Dune backend, iff solve was successful
                     bdaBridge->get_result(x);
@@ -286,11 +455,82 @@ namespace Opm
             // Otherwise, use flexible istl solver.
             if (!accelerator_was_used) {
                 assert(flexibleSolver_);
-                flexibleSolver_->apply(x, *rhs_, result);
+                const bool tuning = autotuner_ && autotuner_->tuning();
+                const double configuredReduction = prm_.get<double>("tol", 1e-2);
+                double reduction = std::max(adaptiveReduction_, configuredReduction);
+                if (useInitialGuess_) {
+                    // the initial guess is not condensed like the system
+                    if (chainCondensation_) {
+                        x = 0.0;
+                    } else {
+                        reduction = initialGuessReduction(x, reduction);
+                    }
+                }
+                // the fallbacks start from the same initial guess and right hand side
+                std::optional<Vector> x0;
+                std::optional<Vector> rhs0;
+                if (!fallbackPrms_.empty() || tuning) {
+                    x0 = x;
+                    rhs0 = *rhs_;
+                }
+                Dune::Timer dune_timer;
+                if (reduction != configuredReduction) {
+                    flexibleSolver_->apply(x, *rhs_, reduction, result);
+                } else {
+                    flexibleSolver_->apply(x, *rhs_, result);
+                }
+                const double dune_seconds = dune_timer.stop();
+                const bool dune_converged = result.converged;
+                if (iterationsAfterSetup_ < 0) {
+                    // First solve with a freshly created preconditioner,
+                    // used as reference for detecting a stale setup.
+                    iterationsAfterSetup_ = result.iterations;
+                }
+                if (!result.converged) {
+                    // a variation tried by the autotuner falls back to the configured solver first
+                    std::vector<boost::property_tree::ptree> fallbacks;
+                    if (tuning && autotuner_->currentIndex() != 0) {
+                        fallbacks.push_back(autotuner_->candidate(0));
+                    }
+                    fallbacks.insert(fallbacks.end(), fallbackPrms_.begin(), fallbackPrms_.end());
+                    if (!fallbacks.empty()) {
+                        solveWithFallbacks(fallbacks, x, *x0, *rhs0, result);
+                    }
+                }
+                if (tuning) {
+                    updateAutotuner(setupSeconds_ + dune_seconds, dune_converged);
+                }
+                if (chainCondensation_) {
+                    chainCondensation_->recover(x);
+                }
+            }
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA || HAVE_ROCSPARSE
+            if (select_adaptively) {
+                // all processes must make the same choice
+                const double seconds = simulator_.gridView().comm().max(solve_timer.stop());
+                const bool converged = accelerator_tried ? accelerator_was_used : result.converged;
+                const int its = accelerator_tried ? accelerator_iterations : result.iterations;
+                const bool decided = solverSelector_->report(accelerator_tried, seconds, its, converged);
+                if (decided && verbosity > 0 && simulator_.gridView().comm().rank() == 0) {
+                    std::ostringstream os;
+                    os << "Adaptive linear solver selection: " << bdaBridge->getAccleratorName()
+                       << " " << solverSelector_->averageSeconds(true) << " s/solve, Dune "
+                       << solverSelector_->averageSeconds(false) << " s/solve, using "
+                       << (solverSelector_->useAccelerator() ? bdaBridge->getAccleratorName() : std::string("Dune"))
+                       << " for the rest of the report step";
+                    OpmLog::info(os.str());
+                }
+            }
+#endif
+
+            if (rhsForDump && !result.converged) {
+                writeBinarySystem(*rhsForDump);
             }
 
             // Check convergence, iterations etc.
             checkConvergence(result);
+            lastSolveOnAccelerator_ = accelerator_was_used;
 
             return converged_;
         }
@@ -308,6 +548,10 @@ namespace Opm
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const std::any& parallelInformation() const { return parallelInformation_; }
 
+        /// Zero-copy CSR view of the system set up by the last call to
+        /// prepare(), for handing it to external solvers.
+        const LinearSystemView<Matrix, Vector>& linearSystemView() const { return systemView_; }
+
     protected:
         // 3x3 matrix block inversion was unstable at least 2.3 until and including
         // 2.5.0. There may still be some issue with the 4x4 matrix block inversion
@@ -349,9 +593,18 @@ namespace Opm
         void prepareFlexibleSolver()
         {
 
-            std::function<Vector()> weightsCalculator = getWeightsCalculator();
+            std::function<Vector()> weightsCalculator = getWeightsCalculator(prm_);
 
             if (shouldCreateSolver()) {
+                // The heap growth while creating the solver is mostly its
+                // preconditioner, e.g. the AMG hierarchy.
+                auto& memoryAccounting = MemoryAccounting::instance();
+                std::size_t heapBefore = 0;
+                if (memoryAccounting.enabled()) {
+                    flexibleSolver_.reset();
+                    heapBefore = MemoryAccounting::heapBytes();
+                }
+
                 if (isParallel()) {
 #if HAVE_MPI
                     if (useWellConn_) {
@@ -366,66 +619,272 @@ namespace Opm
                     }
 #endif
                 } else {
-                    if (useWellConn_) {
+                    if (useWellConn_ && !chainCondensation_) {
                         using SeqOperatorType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
                         linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix());
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm_, weightsCalculator);
                     } else {
                         using SeqOperatorType = WellModelMatrixAdapter<Matrix, Vector, Vector, false>;
-                        wellOperator_ = std::make_unique<WellModelOperator>(simulator_.problem().wellModel());
-                        linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix(), *wellOperator_);
+                        if (preconditionerMatrix_) {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix(), *preconditionerMatrix_,
+                                                                                                 sequentialExtraOperator());
+                        } else {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix(), sequentialExtraOperator());
+                        }
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm_, weightsCalculator);
                     }
                 }
+                iterationsAfterSetup_ = -1;
+
+                if (memoryAccounting.enabled()) {
+                    const std::size_t heapAfter = MemoryAccounting::heapBytes();
+                    memoryAccounting.set("linear solver", heapAfter > heapBefore ? heapAfter - heapBefore : 0);
+                }
             }
-            else
+            else if (!reusePreconditioner_)
             {
                 flexibleSolver_->preconditioner().update();
             }
         }
 
 
+        /// Check the initial guess x of a solve which has to reduce the residual
+        /// of the zero vector by the given reduction. If the residual of x is
+        /// smaller than the right hand side, the Krylov solver only needs to
+        /// reduce it by the part of the reduction that x has not achieved yet,
+        /// which is returned. Otherwise x is set to zero.
+        double initialGuessReduction(Vector& x, const double reduction) const
+        {
+            const double rhsNorm2 = interiorNorm2(*rhs_);
+            Vector residual(*rhs_);
+            linearOperatorForFlexibleSolver_->applyscaleadd(-1.0, x, residual);
+            const double residualNorm2 = interiorNorm2(residual);
+            if (!(rhsNorm2 > 0.0) || !(residualNorm2 < rhsNorm2)) {
+                x = 0.0;
+                return reduction;
+            }
+            // the solver has to do at least a little work, so the reduction
+            // measured from the start of the solve is not larger than this
+            const double maxReduction = 0.9;
+            return std::min(reduction * std::sqrt(rhsNorm2 / residualNorm2), maxReduction);
+        }
+
+        /// Squared norm of the owned rows of v over all processes. The owned
+        /// rows come first, the others are not summed.
+        double interiorNorm2(const Vector& v) const
+        {
+            double norm2 = 0.0;
+            for (std::size_t row = 0; row < interiorCellNum_; ++row) {
+                norm2 += v[row].two_norm2();
+            }
+            return simulator_.gridView().comm().sum(norm2);
+        }
+
+        /// Try the fallback configurations in turn after the configured solver
+        /// did not converge, each from the initial guess and right hand side of
+        /// the failed solve. The fallback solvers are set up for every use, as
+        /// they should be needed rarely. The iterations of all tries are counted.
+        void solveWithFallbacks(const std::vector<boost::property_tree::ptree>& fallbacks,
+                                Vector& x, const Vector& x0, const Vector& rhs,
+                                Dune::InverseOperatorResult& result)
+        {
+            int iterations = result.iterations;
+            const bool on_io_rank = simulator_.gridView().comm().rank() == 0;
+            for (std::size_t i = 0; i < fallbacks.size() && !result.converged; ++i) {
+                const auto& prm = fallbacks[i];
+                // The direct solver factorizes the matrix of this process
+                // only, without the wells and condensed chains the operator
+                // applies.
+                const bool direct = prm.get<std::string>("solver", "bicgstab") == "umfpack";
+                if (direct && !(useWellConn_ && !isParallel() && !chainCondensation_)) {
+                    if (on_io_rank) {
+                        OpmLog::info("Linear solver did not converge, fallback " + std::to_string(i + 1)
+                                     + " (umfpack) skipped, it needs a sequential run with"
+                                     " --matrix-add-well-contributions=true and no chain condensation");
+                    }
+                    continue;
+                }
+                const auto weightsCalculator = getWeightsCalculator(prm);
+                std::unique_ptr<FlexibleSolverType> solver;
+                if (isParallel()) {
+#if HAVE_MPI
+                    solver = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, *comm_, prm, weightsCalculator);
+#endif
+                } else {
+                    solver = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm, weightsCalculator);
+                }
+                x = x0;
+                Vector b = rhs;
+                solver->apply(x, b, result);
+                if (direct) {
+                    // the direct solver always reports convergence
+                    Vector residual(rhs);
+                    linearOperatorForFlexibleSolver_->applyscaleadd(-1.0, x, residual);
+                    const double rhsNorm2 = interiorNorm2(rhs);
+                    result.reduction = rhsNorm2 > 0.0 ? std::sqrt(interiorNorm2(residual) / rhsNorm2) : 0.0;
+                    result.converged = result.reduction <= prm.get<double>("tol", parameters_.linear_solver_reduction_);
+                }
+                iterations += result.iterations;
+                if (on_io_rank) {
+                    std::ostringstream os;
+                    os << "Linear solver did not converge, fallback " << i + 1 << " ("
+                       << prm.get<std::string>("solver", "bicgstab") << " with "
+                       << prm.get<std::string>("preconditioner.type", "ParOverILU0") << ") "
+                       << (result.converged ? "converged" : "did not converge") << " in "
+                       << result.iterations << " iterations";
+                    OpmLog::info(os.str());
+                }
+            }
+            result.iterations = iterations;
+        }
+
+        /// Record a solve (with the setup of its preconditioner) with the
+        /// configuration tried by the autotuner, switch to the next one, and
+        /// write the fastest one when all have been tried.
+        void updateAutotuner(const double seconds, const bool converged)
+        {
+            // all processes must make the same choice
+            const double maxSeconds = simulator_.gridView().comm().max(seconds);
+            if (autotuner_->report(maxSeconds, converged)) {
+                prm_ = autotuner_->current();
+                // recreated with the new configuration by the next prepare()
+                flexibleSolver_.reset();
+            }
+            if (autotuner_->tuning()) {
+                return;
+            }
+
+            if (simulator_.gridView().comm().rank() == 0) {
+                std::ostringstream os;
+                os << "Linear solver autotuning, average seconds per solve:";
+                for (std::size_t i = 0; i < autotuner_->numCandidates(); ++i) {
+                    os << " " << autotuner_->averageSeconds(i);
+                }
+                const auto file = filesystem::path(simulator_.problem().outputDir()) / parameters_.autotune_output_;
+                os << "\nUsing configuration " << autotuner_->best() + 1 << ", written to " << file.string();
+                OpmLog::info(os.str());
+                std::ofstream out(file.string());
+                boost::property_tree::write_json(out, prm_, true);
+            }
+            autotuner_.reset();
+        }
+
+
+        /// True if the wells are applied by the linear operator, and an
+        /// approximation of them is added to a copy of the matrix from which
+        /// the preconditioner is built.
+        bool usePreconditionerWellContributions() const
+        {
+            return parameters_.preconditioner_add_well_contributions_ && !useWellConn_ && !isParallel();
+        }
+
+        /// Copy the values of the matrix to the preconditioner matrix and add
+        /// the approximated well contributions.
+        void updatePreconditionerMatrix()
+        {
+            const Matrix& matrix = getMatrix();
+            if (!preconditionerMatrix_) {
+                preconditionerMatrix_ = std::make_unique<Matrix>(matrix);
+            } else {
+                // the sparsity pattern does not change
+                auto preconditionerRow = preconditionerMatrix_->begin();
+                for (auto row = matrix.begin(); row != matrix.end(); ++row, ++preconditionerRow) {
+                    std::copy((*row).begin(), (*row).end(), (*preconditionerRow).begin());
+                }
+            }
+            simulator_.problem().wellModel().addWellContributionsToPreconditioner(*preconditionerMatrix_);
+        }
+
+
+        /// The operator applied in addition to the matrix in sequential runs:
+        /// the wells unless they are part of the matrix, and the condensed
+        /// numerical aquifers.
+        const Dune::LinearOperator<Vector, Vector>& sequentialExtraOperator()
+        {
+            if (!useWellConn_) {
+                wellOperator_ = std::make_unique<WellModelOperator>(simulator_.problem().wellModel());
+            }
+            if (!chainCondensation_) {
+                return *wellOperator_;
+            }
+            if (useWellConn_) {
+                return *chainCondensation_;
+            }
+            operatorSum_ = std::make_unique<LinearOperatorSum<Vector, Vector>>(*wellOperator_, *chainCondensation_);
+            return *operatorSum_;
+        }
+
         /// Return true if we should (re)create the whole solver,
         /// instead of just calling update() on the preconditioner.
         bool shouldCreateSolver() const
         {
+            // the configuration may override --cpr-reuse-setup, e.g. one chosen by the autotuner
+            const int reuseSetup = prm_.get<int>("cpr_reuse_setup", this->parameters_.cpr_reuse_setup_);
             // Decide if we should recreate the solver or just do
             // a minimal preconditioner update.
             if (!flexibleSolver_) {
                 return true;
             }
-            if (this->parameters_.cpr_reuse_setup_ == 0) {
+            if (reuseSetup == 0) {
                 // Always recreate solver.
                 return true;
             }
-            if (this->parameters_.cpr_reuse_setup_ == 1) {
+            if (reuseSetup == 1) {
                 // Recreate solver on the first iteration of every timestep.
                 const int newton_iteration = this->simulator_.model().newtonMethod().numIterations();
                 return newton_iteration == 0;
             }
-            if (this->parameters_.cpr_reuse_setup_ == 2) {
+            if (reuseSetup == 2) {
                 // Recreate solver if the last solve used more than 10 iterations.
                 return this->iterations() > 10;
             }
 
+            if (reuseSetup == 4) {
+                // Recreate solver if the iteration count has drifted too far
+                // from the one observed right after the last full setup. In
+                // between only the smoothers and coarse operators are updated,
+                // keeping the AMG aggregates.
+                // The iterations of an accelerator say nothing about the
+                // setup of the Dune preconditioner, which it does not use.
+                if (iterationsAfterSetup_ < 0 || lastSolveOnAccelerator_) {
+                    return false;
+                }
+                const double limit = this->parameters_.cpr_reuse_iteration_ratio_
+                    * std::max(iterationsAfterSetup_, 1);
+                return this->iterations() > limit;
+            }
+
             // Otherwise, do not recreate solver.
-            assert(this->parameters_.cpr_reuse_setup_ == 3);
+            assert(reuseSetup == 3);
 
             return false;
         }
 
 
         /// Return an appropriate weight function if a cpr preconditioner is asked for.
-        std::function<Vector()> getWeightsCalculator() const
+        std::function<Vector()> getWeightsCalculator(const boost::property_tree::ptree& prm) const
         {
             std::function<Vector()> weightsCalculator;
 
-            auto preconditionerType = prm_.get("preconditioner.type", "cpr");
-            if (preconditionerType == "cpr" || preconditionerType == "cprt") {
-                const bool transpose = preconditionerType == "cprt";
-                const auto weightsType = prm_.get("preconditioner.weight_type", "quasiimpes");
-                const auto pressureIndex = this->prm_.get("preconditioner.pressure_var_index", 1);
-                if (weightsType == "quasiimpes") {
+            std::string weightsType;
+            int pressureIndex;
+            bool transpose;
+            if (cprWeightsSettings(prm, weightsType, pressureIndex, transpose)) {
+                const double reuseTolerance = this->parameters_.cpr_weights_reuse_tolerance_;
+                if (weightsType == "quasiimpes" && scaledWeights_ == std::make_pair(pressureIndex, transpose)) {
+                    // computed when the system was scaled in prepare()
+                    weightsCalculator = [this]() {
+                        return this->cprWeights_;
+                    };
+                } else if (weightsType == "quasiimpes" && reuseTolerance > 0.0) {
+                    // only the weights of the cells whose diagonal changed
+                    // noticeably are recomputed
+                    weightsCalculator = [this, transpose, pressureIndex, reuseTolerance]() {
+                        Amg::updateQuasiImpesWeights(this->getMatrix(), pressureIndex, transpose, reuseTolerance,
+                                                     this->cprWeightDiagonals_, this->cprWeights_);
+                        return this->cprWeights_;
+                    };
+                } else if (weightsType == "quasiimpes") {
                     // weighs will be created as default in the solver
                     weightsCalculator = [this, transpose, pressureIndex]() {
                         return Amg::getQuasiImpesWeights<Matrix, Vector>(this->getMatrix(), pressureIndex, transpose);
@@ -443,6 +902,28 @@ namespace Opm
             return weightsCalculator;
         }
 
+        /// The weights settings of the CPR preconditioner configured by prm,
+        /// directly or as the solver of the subdomains of ras.
+        /// \return false if there is no CPR preconditioner
+        static bool cprWeightsSettings(const boost::property_tree::ptree& prm, std::string& weightsType,
+                                       int& pressureIndex, bool& transpose)
+        {
+            auto preconditionerType = prm.get("preconditioner.type", "cpr");
+            std::string cprPath = "preconditioner.";
+            if (preconditionerType == "ras") {
+                // cpr as the solver of the subdomains
+                preconditionerType = prm.get("preconditioner.local_solver.type", "ILU0");
+                cprPath = "preconditioner.local_solver.";
+            }
+            if (preconditionerType != "cpr" && preconditionerType != "cprt" && preconditionerType != "cprw") {
+                return false;
+            }
+            transpose = preconditionerType == "cprt";
+            weightsType = prm.get(cprPath + "weight_type", "quasiimpes");
+            pressureIndex = prm.get(cprPath + "pressure_var_index", 1);
+            return true;
+        }
+
 
         // Weights to make approximate pressure equations.
         // Calculated from the storage terms (only) of the
@@ -481,6 +962,16 @@ namespace Opm
         }
 
 
+        /// Dump the current matrix with the given rhs, see Helper::writeBinarySystem().
+        void writeBinarySystem(const Vector& rhs) const
+        {
+            std::vector<Helper::WellSystemBlocks> wells;
+            if (!useWellConn_) {
+                wells = simulator_.problem().wellModel().wellSystemBlocks();
+            }
+            Helper::writeBinarySystem(simulator_, getMatrix(), rhs, overlapRows_, std::move(wells));
+        }
+
         Matrix& getMatrix()
         {
             return *matrix_;
@@ -493,26 +984,60 @@ namespace Opm
 
         const Simulator& simulator_;
         mutable int iterations_;
+        // Iterations of the first solve after the last full setup, -1 if not yet known.
+        int iterationsAfterSetup_;
+        // Whether the last solve was done by an accelerator instead of Dune.
+        bool lastSolveOnAccelerator_;
         mutable bool converged_;
         std::any parallelInformation_;
 
         // non-const to be able to scale the linear system
         Matrix* matrix_;
         Vector *rhs_;
+        LinearSystemView<Matrix, Vector> systemView_;
 
         std::unique_ptr<FlexibleSolverType> flexibleSolver_;
         std::unique_ptr<AbstractOperatorType> linearOperatorForFlexibleSolver_;
         std::unique_ptr<WellModelAsLinearOperator<WellModel, Vector, Vector>> wellOperator_;
+        // only set with --condense-numerical-aquifers=true
+        std::unique_ptr<ChainCondensation<Matrix, Vector>> chainCondensation_;
+        std::unique_ptr<LinearOperatorSum<Vector, Vector>> operatorSum_;
         std::vector<int> overlapRows_;
         std::vector<int> interiorRows_;
         std::vector<std::set<int>> wellConnectionsGraph_;
+        // quasi-IMPES weights and the diagonal blocks they were computed
+        // from, only used with --cpr-weights-reuse-tolerance > 0
+        mutable Vector cprWeights_;
+        mutable std::vector<typename Matrix::block_type> cprWeightDiagonals_;
+        // only set with --scale-linear-system=true
+        std::unique_ptr<LinearSystemScaling<Matrix, Vector>> scaling_;
+        // Copy of the matrix with approximated well contributions, only used
+        // by the preconditioner, see --preconditioner-add-well-contributions.
+        std::unique_ptr<Matrix> preconditionerMatrix_;
+        // Pressure index and transpose flag of the quasi-IMPES weights
+        // computed by scaling_ in the last prepare().
+        std::optional<std::pair<int, bool>> scaledWeights_;
 
         bool useWellConn_;
         size_t interiorCellNum_;
 
         FlowLinearSolverParameters parameters_;
         boost::property_tree::ptree prm_;
+        // --linear-solver-fallback
+        std::vector<boost::property_tree::ptree> fallbackPrms_;
+        // --linear-solver-autotune, reset when the tuning is done
+        std::unique_ptr<LinearSolverAutotuner> autotuner_;
+        // Time of the last preconditioner setup or update in prepare().
+        double setupSeconds_ = 0.0;
         bool scale_variables_;
+        // Residual reduction set by the nonlinear solver, zero for the configured one.
+        double adaptiveReduction_ = 0.0;
+        // Keep the preconditioner in the next prepare(), set by the nonlinear solver.
+        bool reusePreconditioner_ = false;
+        // Start the next solve() from the vector passed to it, set by the nonlinear solver.
+        bool useInitialGuess_ = false;
+        // Number of calls of solve(), for --linear-solver-dump-system.
+        int solveCount_ = 0;
 
         std::shared_ptr< CommunicationType > comm_;
     }; // end ISTLSolver
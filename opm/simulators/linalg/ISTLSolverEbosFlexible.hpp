@@ -191,14 +191,20 @@ public:
             }
             rhs_ = b;
         } else {
-            solver_->preconditioner().update();
+            if (!reusePreconditioner_) {
+                solver_->preconditioner().update();
+            }
             rhs_ = b;
         }
     }
 
     bool solve(VectorType& x)
     {
-        solver_->apply(x, rhs_, res_);
+        if (adaptiveReduction_ > prm_.get<double>("tol", 1e-2)) {
+            solver_->apply(x, rhs_, adaptiveReduction_, res_);
+        } else {
+            solver_->apply(x, rhs_, res_);
+        }
         this->writeMatrix();
         return res_.converged;
     }
@@ -227,6 +233,20 @@ public:
         // matrix_ = &M.istlMatrix(); // Must be handled in prepare() instead.
     }
 
+    /// Use the residual reduction max(reduction, configured reduction) for
+    /// the following solves, zero restores the configured reduction.
+    void setAdaptiveReduction(const double reduction)
+    {
+        adaptiveReduction_ = reduction;
+    }
+
+    /// If true, the next prepare() keeps the preconditioner built for an
+    /// earlier matrix instead of updating it, unless the solver is recreated.
+    void setReusePreconditioner(const bool reuse)
+    {
+        reusePreconditioner_ = reuse;
+    }
+
 protected:
 
     bool shouldCreateSolver() const
@@ -264,10 +284,16 @@ protected:
         std::function<VectorType()> weightsCalculator;
 
         auto preconditionerType = prm_.get("preconditioner.type", "cpr");
-        if (preconditionerType == "cpr" || preconditionerType == "cprt") {
+        std::string cprPath = "preconditioner.";
+        if (preconditionerType == "ras") {
+            // cpr as the solver of the subdomains
+            preconditionerType = prm_.get("preconditioner.local_solver.type", "ILU0");
+            cprPath = "preconditioner.local_solver.";
+        }
+        if (preconditionerType == "cpr" || preconditionerType == "cprt" || preconditionerType == "cprw") {
             const bool transpose = preconditionerType == "cprt";
-            const auto weightsType = prm_.get("preconditioner.weight_type", "quasiimpes");
-            const auto pressureIndex = this->prm_.get("preconditioner.pressure_var_index", 1);
+            const auto weightsType = prm_.get(cprPath + "weight_type", "quasiimpes");
+            const auto pressureIndex = this->prm_.get(cprPath + "pressure_var_index", 1);
             if (weightsType == "quasiimpes") {
                 // weighs will be created as default in the solver
                 weightsCalculator = [&mat, transpose, pressureIndex]() {
@@ -347,6 +373,10 @@ protected:
     std::unique_ptr<Communication> comm_;
     std::vector<int> overlapRows_;
     std::vector<int> interiorRows_;
+    // Residual reduction set by the nonlinear solver, zero for the configured one.
+    double adaptiveReduction_ = 0.0;
+    // Keep the preconditioner in the next prepare(), set by the nonlinear solver.
+    bool reusePreconditioner_ = false;
 }; // end ISTLSolverEbosFlexible
 
 } // namespace Opm
@@ -0,0 +1,199 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+#define OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+/// Chooses a FlexibleSolver configuration from the measured run times of
+/// the first linear solves of a simulation.
+///
+/// The candidates are the configured property tree and variations of it
+/// in one setting each: the Krylov solver and its restart length, the
+/// ILU fill-in, the fine smoother and the AMG aggregate sizes of CPR, and
+/// how often the CPR preconditioner is recreated ("cpr_reuse_setup", see
+/// --cpr-reuse-setup). Every candidate is used for solvesPerCandidate
+/// solves in turn, and the one with the lowest average time of setup and
+/// solve is used afterwards. A candidate that does not converge is dropped
+/// right away.
+///
+/// The caller must pass the same times on all processes of a parallel run,
+/// e.g. the maximum over all processes, so that all processes choose the
+/// same configuration.
+class LinearSolverAutotuner
+{
+public:
+    using PropertyTree = boost::property_tree::ptree;
+
+    LinearSolverAutotuner(const PropertyTree& base, int solvesPerCandidate)
+        : candidates_(candidates(base)),
+          stats_(candidates_.size()),
+          solvesPerCandidate_(std::max(solvesPerCandidate, 1))
+    {
+    }
+
+    /// The configured tree followed by its variations.
+    static std::vector<PropertyTree> candidates(const PropertyTree& base)
+    {
+        std::vector<PropertyTree> result{base};
+        const auto vary = [&result, &base](const std::string& key, const auto& value)
+        {
+            PropertyTree candidate = base;
+            candidate.put(key, value);
+            result.push_back(candidate);
+        };
+
+        const auto solver = base.get<std::string>("solver", "bicgstab");
+        if (solver == "bicgstab") {
+            PropertyTree candidate = base;
+            candidate.put("solver", "gmres");
+            candidate.put("restart", 30);
+            result.push_back(candidate);
+        } else if (solver == "gmres") {
+            vary("solver", "bicgstab");
+            vary("restart", base.get<int>("restart", 15) * 2);
+        }
+
+        const auto type = base.get<std::string>("preconditioner.type", "ParOverILU0");
+        if (type == "cpr" || type == "cprt" || type == "cprw") {
+            PropertyTree candidate = base;
+            candidate.put("preconditioner.finesmoother.type", "ILUn");
+            candidate.put("preconditioner.finesmoother.ilulevel", 1);
+            result.push_back(candidate);
+            candidate = base;
+            const int minAggSize = base.get<int>("preconditioner.coarsesolver.preconditioner.minaggsize", 4);
+            const int maxAggSize = base.get<int>("preconditioner.coarsesolver.preconditioner.maxaggsize", 6);
+            candidate.put("preconditioner.coarsesolver.preconditioner.minaggsize", minAggSize + 2);
+            candidate.put("preconditioner.coarsesolver.preconditioner.maxaggsize", maxAggSize + 3);
+            result.push_back(candidate);
+            const int reuse = base.get<int>("cpr_reuse_setup", 0);
+            for (const int other : {1, 3}) {
+                if (other != reuse) {
+                    vary("cpr_reuse_setup", other);
+                }
+            }
+        } else if (type == "amg") {
+            PropertyTree candidate = base;
+            candidate.put("preconditioner.minaggsize", base.get<int>("preconditioner.minaggsize", 4) + 2);
+            candidate.put("preconditioner.maxaggsize", base.get<int>("preconditioner.maxaggsize", 6) + 3);
+            result.push_back(candidate);
+        } else if (type == "ParOverILU0" || type == "ILUn") {
+            vary("preconditioner.ilulevel", base.get<int>("preconditioner.ilulevel", 0) == 0 ? 1 : 0);
+        }
+        return result;
+    }
+
+    /// True while the candidates are being timed.
+    bool tuning() const
+    {
+        return current_ < candidates_.size();
+    }
+
+    /// The configuration for the next solve.
+    const PropertyTree& current() const
+    {
+        return tuning() ? candidates_[current_] : candidates_[best()];
+    }
+
+    /// Index of the configuration for the next solve.
+    std::size_t currentIndex() const
+    {
+        return tuning() ? current_ : best();
+    }
+
+    /// Record a linear solve with current(), including the setup of the
+    /// preconditioner for it.
+    /// \return true if the configuration for the next solve is a different one
+    bool report(double seconds, bool converged)
+    {
+        if (!tuning()) {
+            return false;
+        }
+        Stats& s = stats_[current_];
+        s.seconds += seconds;
+        ++s.solves;
+        if (!converged) {
+            s.failed = true;
+        }
+        if (s.failed || s.solves >= solvesPerCandidate_) {
+            const std::size_t previous = current_;
+            ++current_;
+            return currentIndex() != previous;
+        }
+        return false;
+    }
+
+    /// The candidate with the lowest average time so far, the configured
+    /// one if all failed.
+    std::size_t best() const
+    {
+        std::size_t result = 0;
+        double bestSeconds = std::numeric_limits<double>::max();
+        for (std::size_t i = 0; i < stats_.size(); ++i) {
+            if (!stats_[i].failed && stats_[i].solves > 0 && averageSeconds(i) < bestSeconds) {
+                bestSeconds = averageSeconds(i);
+                result = i;
+            }
+        }
+        return result;
+    }
+
+    /// Average time per solve of a candidate, 0 if not yet used.
+    double averageSeconds(std::size_t candidate) const
+    {
+        const Stats& s = stats_[candidate];
+        return s.solves > 0 ? s.seconds / s.solves : 0.0;
+    }
+
+    std::size_t numCandidates() const
+    {
+        return candidates_.size();
+    }
+
+    const PropertyTree& candidate(std::size_t i) const
+    {
+        return candidates_[i];
+    }
+
+private:
+    struct Stats {
+        double seconds = 0.0;
+        int solves = 0;
+        bool failed = false;
+    };
+
+    std::vector<PropertyTree> candidates_;
+    std::vector<Stats> stats_;
+    int solvesPerCandidate_;
+    std::size_t current_ = 0;
+};
+
+} // namespace Opm
+
+#endif // OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
@@ -0,0 +1,106 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSYSTEMSCALING_HEADER_INCLUDED
+#define OPM_LINEARSYSTEMSCALING_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Opm
+{
+
+/// Scales the equations of a linear system A x = b in place, i.e. the
+/// rows of every cell of A and b by the inverse of the largest entry of
+/// their row in the diagonal block. The solution is not changed by this.
+///
+/// The rows are scaled in parallel with OpenMP, in the same pass as the
+/// quasi-IMPES weights of the scaled system are computed if these are
+/// requested. The scaling factors are kept between the calls, such that
+/// only their values are updated.
+template <class Matrix, class Vector>
+class LinearSystemScaling
+{
+public:
+    /// Scale A and b.
+    void scale(Matrix& A, Vector& b)
+    {
+        scaleRows(A, b, [](const auto&, const long long) {});
+    }
+
+    /// Scale A and b, and compute the quasi-IMPES weights of the scaled
+    /// system as Amg::getQuasiImpesWeights() does.
+    void scale(Matrix& A, Vector& b, const int pressureVarIndex, const bool transpose, Vector& weights)
+    {
+        weights.resize(A.N());
+        scaleRows(A, b, [&](const auto& diag_block, const long long r) {
+            Details::quasiImpesBlockWeights(diag_block, pressureVarIndex, transpose, weights[r]);
+        });
+    }
+
+    /// The factors of the last scaling, one per equation.
+    const Vector& factors() const
+    {
+        return factors_;
+    }
+
+private:
+    template <class DiagonalFunc>
+    void scaleRows(Matrix& A, Vector& b, const DiagonalFunc& diagonalFunc)
+    {
+        factors_.resize(A.N());
+        Details::forEachRow(A.N(), [&](const long long r) {
+            auto& row = A[r];
+            auto& f = factors_[r];
+            const auto diag = row.find(r);
+            for (int eq = 0; eq < numEq; ++eq) {
+                double rowMax = 0.0;
+                if (diag != row.end()) {
+                    for (int j = 0; j < numEq; ++j) {
+                        rowMax = std::max(rowMax, std::abs((*diag)[eq][j]));
+                    }
+                }
+                f[eq] = rowMax > 0.0 ? 1.0 / rowMax : 1.0;
+            }
+            for (auto block = row.begin(); block != row.end(); ++block) {
+                for (int eq = 0; eq < numEq; ++eq) {
+                    (*block)[eq] *= f[eq];
+                }
+            }
+            for (int eq = 0; eq < numEq; ++eq) {
+                b[r][eq] *= f[eq];
+            }
+            if (diag != row.end()) {
+                diagonalFunc(*diag, r);
+            } else {
+                diagonalFunc(typename Matrix::block_type(0.0), r);
+            }
+        });
+    }
+
+    static constexpr int numEq = Matrix::block_type::rows;
+
+    Vector factors_;
+};
+
+} // namespace Opm
+
+#endif // OPM_LINEARSYSTEMSCALING_HEADER_INCLUDED
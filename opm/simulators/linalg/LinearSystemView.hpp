@@ -0,0 +1,147 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSYSTEMVIEW_HEADER_INCLUDED
+#define OPM_LINEARSYSTEMVIEW_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// Non-owning view of an assembled linear system A x = b in block
+/// compressed sparse row (BSR) form, for handing it to external solvers.
+///
+/// The block values and the right hand side are not copied: values()
+/// and rhs() point directly into the storage of the Dune::BCRSMatrix and
+/// Dune::BlockVector, with each block stored row-major. Only the row
+/// pointers and column indices are extracted, and they are cached until
+/// the sparsity pattern changes. Consumer code may compare
+/// patternVersion() with the value it saw last, to know when it must
+/// redo its own symbolic setup.
+///
+/// A pattern change is detected from the matrix dimensions, the number
+/// of nonzeroes and the location of the block storage. Call
+/// invalidatePattern() if the pattern is changed in some other way.
+template <class Matrix, class Vector>
+class LinearSystemView
+{
+public:
+    using field_type = typename Matrix::field_type;
+    static constexpr int blockSize = Matrix::block_type::rows;
+
+    /// Point the view at the system A x = b.
+    /// Returns true if the sparsity pattern was (re)extracted.
+    bool update(Matrix& A, Vector& b)
+    {
+        rhs_ = b.size() > 0 ? &b[0][0] : nullptr;
+        values_ = A.nonzeroes() > 0 ? &(*A.begin()->begin())[0][0] : nullptr;
+
+        const bool changed = !valid_
+            || A.N() != numBlockRows_
+            || A.M() != numBlockCols_
+            || A.nonzeroes() != numBlockNonzeroes_
+            || values_ != patternValues_;
+        if (changed) {
+            extractPattern(A);
+        }
+        return changed;
+    }
+
+    /// Force re-extraction of the pattern on the next update().
+    void invalidatePattern()
+    {
+        valid_ = false;
+    }
+
+    std::size_t numBlockRows() const { return numBlockRows_; }
+    std::size_t numBlockCols() const { return numBlockCols_; }
+    std::size_t numBlockNonzeroes() const { return numBlockNonzeroes_; }
+
+    /// Number of scalar rows, that is numBlockRows() * blockSize.
+    std::size_t numRows() const { return numBlockRows_ * blockSize; }
+
+    /// Block row pointers, of size numBlockRows() + 1.
+    const int* rowPointers() const { return rowPointers_.data(); }
+
+    /// Block column indices, of size numBlockNonzeroes().
+    const int* columnIndices() const { return columnIndices_.data(); }
+
+    /// The block values, numBlockNonzeroes() row-major blocks in the
+    /// order given by rowPointers() and columnIndices().
+    field_type* values() const { return values_; }
+
+    /// The right hand side, numRows() values.
+    field_type* rhs() const { return rhs_; }
+
+    /// Incremented every time the sparsity pattern is extracted.
+    unsigned int patternVersion() const { return patternVersion_; }
+
+private:
+    void extractPattern(const Matrix& A)
+    {
+        numBlockRows_ = A.N();
+        numBlockCols_ = A.M();
+        numBlockNonzeroes_ = A.nonzeroes();
+        patternValues_ = values_;
+
+        rowPointers_.clear();
+        columnIndices_.clear();
+        rowPointers_.reserve(numBlockRows_ + 1);
+        columnIndices_.reserve(numBlockNonzeroes_);
+        rowPointers_.push_back(0);
+        const auto* firstBlock = numBlockNonzeroes_ > 0 ? &(*A.begin()->begin()) : nullptr;
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                // The zero-copy value access relies on the blocks being
+                // stored contiguously, in row order.
+                if (&(*col) != firstBlock + columnIndices_.size()) {
+                    OPM_THROW(std::logic_error, "Matrix blocks are not stored contiguously in LinearSystemView::update()");
+                }
+                columnIndices_.push_back(col.index());
+            }
+            rowPointers_.push_back(columnIndices_.size());
+        }
+        if (columnIndices_.size() != numBlockNonzeroes_) {
+            OPM_THROW(std::logic_error, "Error size of rows do not sum to number of nonzeroes in LinearSystemView::update()");
+        }
+        valid_ = true;
+        ++patternVersion_;
+    }
+
+    bool valid_ = false;
+    std::size_t numBlockRows_ = 0;
+    std::size_t numBlockCols_ = 0;
+    std::size_t numBlockNonzeroes_ = 0;
+    // Location of the block storage when the pattern was extracted.
+    const field_type* patternValues_ = nullptr;
+    std::vector<int> rowPointers_;
+    std::vector<int> columnIndices_;
+    field_type* values_ = nullptr;
+    field_type* rhs_ = nullptr;
+    unsigned int patternVersion_ = 0;
+};
+
+} // namespace Opm
+
+#endif // OPM_LINEARSYSTEMVIEW_HEADER_INCLUDED
@@ -28,6 +28,8 @@
 #include <dune/istl/umfpack.hh>
 #include <dune/istl/superlu.hh>
 
+#include <utility>
+
 namespace Dune
 {
 namespace FMatrixHelp {
@@ -296,6 +298,57 @@ static inline K invertMatrix(const DynamicMatrix<K>& matrix, DynamicMatrix<K>& i
 
     return det;
 }
+
+//! invert a small n x n matrix without changing the original matrix
+//! by Gauss-Jordan elimination with partial pivoting. The loop bounds are
+//! known at compile time, which lets the compiler unroll the loops for the
+//! 5 x 5 and 6 x 6 blocks of thermal and EOR models.
+template <typename K, int n>
+static inline K invertMatrixGaussJordan(const FieldMatrix<K,n,n>& matrix, FieldMatrix<K,n,n>& inverse)
+{
+    FieldMatrix<K,n,n> A(matrix);
+    inverse = 0.0;
+    for (int i = 0; i < n; ++i) {
+        inverse[i][i] = 1.0;
+    }
+
+    K det = 1.0;
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        for (int i = k + 1; i < n; ++i) {
+            if (std::abs(A[i][k]) > std::abs(A[pivot][k])) {
+                pivot = i;
+            }
+        }
+        if (std::abs(A[pivot][k]) < 1e-40) {
+            DUNE_THROW(FMatrixError, "matrix is singular");
+        }
+        if (pivot != k) {
+            std::swap(A[pivot], A[k]);
+            std::swap(inverse[pivot], inverse[k]);
+            det = -det;
+        }
+        det *= A[k][k];
+
+        const K inv_pivot = 1.0 / A[k][k];
+        for (int j = 0; j < n; ++j) {
+            A[k][j] *= inv_pivot;
+            inverse[k][j] *= inv_pivot;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (i == k) {
+                continue;
+            }
+            const K factor = A[i][k];
+            for (int j = 0; j < n; ++j) {
+                A[i][j] -= factor * A[k][j];
+                inverse[i][j] -= factor * inverse[k][j];
+            }
+        }
+    }
+
+    return det;
+}
 } // end FMatrixHelp
 
 namespace ISTLUtility {
@@ -332,6 +385,22 @@ static inline void invertMatrix(FieldMatrix<K,4,4>& matrix)
     FMatrixHelp::invertMatrix(A, matrix );
 }
 
+//! invert matrix by calling FMatrixHelp::invertMatrixGaussJordan
+template <typename K>
+static inline void invertMatrix(FieldMatrix<K,5,5>& matrix)
+{
+    FieldMatrix<K,5,5> A ( matrix );
+    FMatrixHelp::invertMatrixGaussJordan(A, matrix );
+}
+
+//! invert matrix by calling FMatrixHelp::invertMatrixGaussJordan
+template <typename K>
+static inline void invertMatrix(FieldMatrix<K,6,6>& matrix)
+{
+    FieldMatrix<K,6,6> A ( matrix );
+    FMatrixHelp::invertMatrixGaussJordan(A, matrix );
+}
+
 //! invert matrix by calling matrix.invert
 template <typename K, int n>
 static inline void invertMatrix(FieldMatrix<K,n,n>& matrix)
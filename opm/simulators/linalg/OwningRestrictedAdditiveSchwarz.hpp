@@ -0,0 +1,347 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_OWNINGRESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
+#define OPM_OWNINGRESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/superlu.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace Opm
+{
+// Circular dependency between PreconditionerFactory [which can make an OwningRestrictedAdditiveSchwarz]
+// and OwningRestrictedAdditiveSchwarz [which uses PreconditionerFactory to create the local solver]
+// must be broken, accomplished by forward-declaration here.
+template <class Operator, class Comm>
+class PreconditionerFactory;
+}
+
+namespace Dune
+{
+
+/// A sparse direct solver (e.g. UMFPack or SuperLU) of a local matrix used
+/// as preconditioner. The factorization is recomputed by update().
+template <class Solver, class MatrixType, class VectorType>
+class OwningDirectSolverPreconditioner : public PreconditionerWithUpdate<VectorType, VectorType>
+{
+public:
+    explicit OwningDirectSolverPreconditioner(const MatrixType& matrix)
+        : matrix_(matrix)
+    {
+        update();
+    }
+
+    virtual void pre(VectorType&, VectorType&) override
+    {
+    }
+
+    virtual void apply(VectorType& v, const VectorType& d) override
+    {
+        // the solver overwrites the right hand side
+        rhs_ = d;
+        InverseOperatorResult result;
+        solver_->apply(v, rhs_, result);
+    }
+
+    virtual void post(VectorType&) override
+    {
+    }
+
+    virtual SolverCategory::Category category() const override
+    {
+        return SolverCategory::sequential;
+    }
+
+    virtual void update() override
+    {
+        solver_.reset();
+        solver_ = std::make_unique<Solver>(matrix_, 0, false);
+    }
+
+private:
+    const MatrixType& matrix_;
+    std::unique_ptr<Solver> solver_;
+    VectorType rhs_;
+};
+
+/// Create the solver of a subdomain of the restricted additive Schwarz
+/// method: one of the sequential preconditioners of the factory (e.g.
+/// ILU0, ILUn or cpr) or, if available, a sparse direct solve ("umfpack"
+/// or "superlu").
+template <class SeqOperator, class VectorType>
+std::shared_ptr<PreconditionerWithUpdate<VectorType, VectorType>>
+makeLocalSchwarzSolver(const SeqOperator& op, const boost::property_tree::ptree& prm,
+                       const std::function<VectorType()>& weightsCalculator)
+{
+    using MatrixType = typename SeqOperator::matrix_type;
+    const auto type = prm.get<std::string>("type", "ILU0");
+#if HAVE_SUITESPARSE_UMFPACK
+    if (type == "umfpack") {
+        using Solver = UMFPack<MatrixType>;
+        return std::make_shared<OwningDirectSolverPreconditioner<Solver, MatrixType, VectorType>>(op.getmat());
+    }
+#endif
+#if HAVE_SUPERLU
+    if (type == "superlu") {
+        using Solver = SuperLU<MatrixType>;
+        return std::make_shared<OwningDirectSolverPreconditioner<Solver, MatrixType, VectorType>>(op.getmat());
+    }
+#endif
+    if (type == "umfpack" || type == "superlu") {
+        OPM_THROW(std::invalid_argument, "Properties: The local solver " << type << " is not available.");
+    }
+    using SeqFactory = Opm::PreconditionerFactory<SeqOperator, Amg::SequentialInformation>;
+    return SeqFactory::create(op, prm, weightsCalculator);
+}
+
+#if HAVE_MPI
+
+/// Restricted additive Schwarz preconditioner with a configurable solver
+/// of the subdomains.
+///
+/// The subdomain of a process are its owned cells and the overlap cells
+/// around them, as many layers as the grid has been distributed with. The
+/// rows of the overlap cells, which the assembly leaves to their owners,
+/// are fetched from the owning processes (restricted to the locally known
+/// columns), so the local system is the restriction of the global one. A
+/// local solve is followed by taking the owner values of the correction
+/// everywhere, see https://www.cs.colorado.edu/~cai/papers/rash.pdf.
+///
+/// The local solver is given by the "local_solver" subtree, see
+/// makeLocalSchwarzSolver().
+template <class OperatorType, class VectorType, class Communication>
+class OwningRestrictedAdditiveSchwarz : public PreconditionerWithUpdate<VectorType, VectorType>
+{
+public:
+    using pt = boost::property_tree::ptree;
+    using MatrixType = typename OperatorType::matrix_type;
+    using SeqOperatorType = MatrixAdapter<MatrixType, VectorType, VectorType>;
+
+    OwningRestrictedAdditiveSchwarz(const OperatorType& linearoperator, const pt& prm,
+                                    const std::function<VectorType()>& weightsCalculator,
+                                    const Communication& comm)
+        : linear_operator_(linearoperator)
+        , comm_(comm)
+        , local_matrix_(linearoperator.getmat())
+        , local_operator_(local_matrix_)
+    {
+        setupExchange();
+        exchangeOverlapRows();
+        auto child = prm.get_child_optional("local_solver");
+        local_solver_ = makeLocalSchwarzSolver(local_operator_, child ? *child : pt(), weightsCalculator);
+    }
+
+    virtual void pre(VectorType& x, VectorType&) override
+    {
+        comm_.copyOwnerToAll(x, x);
+    }
+
+    virtual void apply(VectorType& v, const VectorType& d) override
+    {
+        rhs_ = d;
+        comm_.copyOwnerToAll(rhs_, rhs_);
+        v = 0.0;
+        local_solver_->apply(v, rhs_);
+        // restrict the correction: every process takes the values of the owners
+        comm_.copyOwnerToAll(v, v);
+    }
+
+    virtual void post(VectorType&) override
+    {
+    }
+
+    virtual void update() override
+    {
+        copyLocalRows();
+        exchangeOverlapRows();
+        local_solver_->update();
+    }
+
+    virtual SolverCategory::Category category() const override
+    {
+        return linear_operator_.category();
+    }
+
+private:
+    using GlobalIndex = typename Communication::ParallelIndexSet::GlobalIndex;
+    using Attribute = OwnerOverlapCopyAttributeSet::AttributeSet;
+    static constexpr int blockSize = MatrixType::block_type::rows * MatrixType::block_type::cols;
+    static constexpr int indexTag = 1201;
+    static constexpr int valueTag = 1202;
+
+    // Find the rows to send to and to receive from every neighbour: the
+    // owner sends the rows of its cells that are overlap cells elsewhere.
+    void setupExchange()
+    {
+        const auto& indexSet = comm_.indexSet();
+        local_to_global_.resize(local_matrix_.N());
+        for (const auto& index : indexSet) {
+            local_to_global_[index.local().local()] = index.global();
+            global_to_local_[index.global()] = index.local().local();
+        }
+
+        const auto& remoteIndices = comm_.remoteIndices();
+        for (auto it = remoteIndices.begin(); it != remoteIndices.end(); ++it) {
+            std::vector<int> sendRows;
+            bool receive = false;
+            for (const auto& remote : *(it->second.first)) {
+                const bool localOwner = remote.localIndexPair().local().attribute() == Attribute::owner;
+                const bool remoteOwner = remote.attribute() == Attribute::owner;
+                if (localOwner && !remoteOwner) {
+                    sendRows.push_back(remote.localIndexPair().local().local());
+                } else if (!localOwner && remoteOwner) {
+                    receive = true;
+                }
+            }
+            if (!sendRows.empty()) {
+                send_rows_.emplace_back(it->first, std::move(sendRows));
+            }
+            if (receive) {
+                receive_procs_.push_back(it->first);
+            }
+        }
+    }
+
+    void copyLocalRows()
+    {
+        const auto& matrix = linear_operator_.getmat();
+        for (auto row = matrix.begin(), localRow = local_matrix_.begin(); row != matrix.end(); ++row, ++localRow) {
+            auto localCol = localRow->begin();
+            for (auto col = row->begin(); col != row->end(); ++col, ++localCol) {
+                *localCol = *col;
+            }
+        }
+    }
+
+    // Replace the rows of the overlap cells by the rows of their owners.
+    void exchangeOverlapRows()
+    {
+        MPI_Comm mpiComm = comm_.communicator();
+        std::vector<std::vector<long long>> sendIndices(send_rows_.size());
+        std::vector<std::vector<double>> sendValues(send_rows_.size());
+        std::vector<MPI_Request> requests;
+        requests.reserve(2 * send_rows_.size());
+        for (std::size_t p = 0; p < send_rows_.size(); ++p) {
+            for (const int r : send_rows_[p].second) {
+                const auto& row = local_matrix_[r];
+                sendIndices[p].push_back(local_to_global_[r]);
+                sendIndices[p].push_back(row.size());
+                for (auto col = row.begin(); col != row.end(); ++col) {
+                    sendIndices[p].push_back(local_to_global_[col.index()]);
+                    for (int i = 0; i < MatrixType::block_type::rows; ++i) {
+                        for (int j = 0; j < MatrixType::block_type::cols; ++j) {
+                            sendValues[p].push_back((*col)[i][j]);
+                        }
+                    }
+                }
+            }
+            requests.emplace_back();
+            MPI_Isend(sendIndices[p].data(), static_cast<int>(sendIndices[p].size()), MPI_LONG_LONG, send_rows_[p].first,
+                      indexTag, mpiComm, &requests.back());
+            requests.emplace_back();
+            MPI_Isend(sendValues[p].data(), static_cast<int>(sendValues[p].size()), MPI_DOUBLE, send_rows_[p].first,
+                      valueTag, mpiComm, &requests.back());
+        }
+
+        std::vector<long long> indices;
+        std::vector<double> values;
+        for (const int proc : receive_procs_) {
+            MPI_Status status;
+            int count = 0;
+            MPI_Probe(proc, indexTag, mpiComm, &status);
+            MPI_Get_count(&status, MPI_LONG_LONG, &count);
+            indices.resize(count);
+            MPI_Recv(indices.data(), count, MPI_LONG_LONG, proc, indexTag, mpiComm, MPI_STATUS_IGNORE);
+            MPI_Probe(proc, valueTag, mpiComm, &status);
+            MPI_Get_count(&status, MPI_DOUBLE, &count);
+            values.resize(count);
+            MPI_Recv(values.data(), count, MPI_DOUBLE, proc, valueTag, mpiComm, MPI_STATUS_IGNORE);
+            insertRows(indices, values);
+        }
+        MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    }
+
+    // Columns the owner has but this process does not know are dropped.
+    void insertRows(const std::vector<long long>& indices, const std::vector<double>& values)
+    {
+        std::size_t pos = 0;
+        std::size_t valuePos = 0;
+        while (pos < indices.size()) {
+            const auto localRow = global_to_local_.find(static_cast<GlobalIndex>(indices[pos++]));
+            const long long numEntries = indices[pos++];
+            auto* row = localRow != global_to_local_.end() ? &local_matrix_[localRow->second] : nullptr;
+            if (row) {
+                *row = 0.0;
+            }
+            for (long long k = 0; k < numEntries; ++k, valuePos += blockSize) {
+                const auto localCol = global_to_local_.find(static_cast<GlobalIndex>(indices[pos++]));
+                if (!row || localCol == global_to_local_.end()) {
+                    continue;
+                }
+                auto entry = row->find(localCol->second);
+                if (entry == row->end()) {
+                    continue;
+                }
+                for (int i = 0; i < MatrixType::block_type::rows; ++i) {
+                    for (int j = 0; j < MatrixType::block_type::cols; ++j) {
+                        (*entry)[i][j] = values[valuePos + i * MatrixType::block_type::cols + j];
+                    }
+                }
+            }
+        }
+    }
+
+    const OperatorType& linear_operator_;
+    const Communication& comm_;
+    MatrixType local_matrix_;
+    SeqOperatorType local_operator_;
+    std::shared_ptr<PreconditionerWithUpdate<VectorType, VectorType>> local_solver_;
+    VectorType rhs_;
+    std::vector<GlobalIndex> local_to_global_;
+    std::unordered_map<GlobalIndex, int> global_to_local_;
+    std::vector<std::pair<int, std::vector<int>>> send_rows_;
+    std::vector<int> receive_procs_;
+};
+
+#endif // HAVE_MPI
+
+} // namespace Dune
+
+#endif // OPM_OWNINGRESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
@@ -86,8 +86,10 @@ public:
     using MatrixType = typename OperatorType::matrix_type;
     using PrecFactory = Opm::PreconditionerFactory<OperatorType, Communication>;
 
+    /// If wellBlocks is given, the pressure system includes the wells, see PressureTransferPolicy.
     OwningTwoLevelPreconditioner(const OperatorType& linearoperator, const pt& prm,
-                                 const std::function<VectorType()> weightsCalculator)
+                                 const std::function<VectorType()> weightsCalculator,
+                                 const std::function<std::vector<Opm::Helper::WellSystemBlocks>()>& wellBlocks = {})
         : linear_operator_(linearoperator)
         , finesmoother_(PrecFactory::create(linearoperator,
                                             prm.get_child_optional("finesmoother")?
@@ -95,7 +97,7 @@ public:
         , comm_(nullptr)
         , weightsCalculator_(weightsCalculator)
         , weights_(weightsCalculator())
-        , levelTransferPolicy_(dummy_comm_, weights_, prm.get<int>("pressure_var_index"))
+        , levelTransferPolicy_(dummy_comm_, weights_, prm.get<int>("pressure_var_index"), wellBlocks)
         , coarseSolverPolicy_(prm.get_child_optional("coarsesolver")? prm.get_child("coarsesolver") : pt())
         , twolevel_method_(linearoperator,
                            finesmoother_,
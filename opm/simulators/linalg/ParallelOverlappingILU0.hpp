@@ -20,15 +20,25 @@
 #ifndef OPM_PARALLELOVERLAPPINGILU0_HEADER_INCLUDED
 #define OPM_PARALLELOVERLAPPINGILU0_HEADER_INCLUDED
 
+#include <opm/simulators/linalg/FirstTouchAllocator.hpp>
 #include <opm/simulators/linalg/GraphColoring.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/utils/ScopedTimers.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
+#include <dune/istl/bvector.hh>
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/paamg/smoother.hh>
 #include <dune/istl/paamg/graph.hh>
 #include <dune/istl/paamg/pinfo.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
 #include <type_traits>
 #include <numeric>
 #include <limits>
@@ -40,7 +50,8 @@ namespace Opm
 
 //template<class M, class X, class Y, class C>
 //class ParallelOverlappingILU0;
-template<class Matrix, class Domain, class Range, class ParallelInfo = Dune::Amg::SequentialInformation>
+template<class Matrix, class Domain, class Range, class ParallelInfo = Dune::Amg::SequentialInformation,
+         class FactorField = typename Domain::field_type>
 class ParallelOverlappingILU0;
 
 enum class MILU_VARIANT{
@@ -110,8 +121,8 @@ namespace Amg
 {
 
 
-template<class M, class X, class Y, class C>
-struct SmootherTraits<Opm::ParallelOverlappingILU0<M,X,Y,C> >
+template<class M, class X, class Y, class C, class F>
+struct SmootherTraits<Opm::ParallelOverlappingILU0<M,X,Y,C,F> >
 {
     using Arguments = Opm::ParallelOverlappingILU0Args<typename M::field_type>;
 };
@@ -122,10 +133,11 @@ struct SmootherTraits<Opm::ParallelOverlappingILU0<M,X,Y,C> >
 /// \tparam Range The type of the Vector representing the range.
 /// \tparam ParallelInfo The type of the parallel information object
 ///         used, e.g. Dune::OwnerOverlapCommunication
-template<class Matrix, class Domain, class Range, class ParallelInfo>
-struct ConstructionTraits<Opm::ParallelOverlappingILU0<Matrix,Domain,Range,ParallelInfo> >
+/// \tparam FactorField The scalar type used for storing the ILU factors.
+template<class Matrix, class Domain, class Range, class ParallelInfo, class FactorField>
+struct ConstructionTraits<Opm::ParallelOverlappingILU0<Matrix,Domain,Range,ParallelInfo,FactorField> >
 {
-    typedef Opm::ParallelOverlappingILU0<Matrix,Domain,Range,ParallelInfo> T;
+    typedef Opm::ParallelOverlappingILU0<Matrix,Domain,Range,ParallelInfo,FactorField> T;
     typedef DefaultParallelConstructionArgs<T,ParallelInfo> Arguments;
 
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 7)
@@ -190,6 +202,21 @@ namespace Opm
         const std::vector<std::size_t>* ordering_;
     };
 
+    //! \brief Copy a matrix block, possibly converting its field type.
+    template<class DstBlock, class SrcBlock>
+    void assignBlock(DstBlock& dst, const SrcBlock& src)
+    {
+        if constexpr (std::is_same_v<DstBlock, SrcBlock>) {
+            dst = src;
+        } else {
+            for (int i = 0; i < SrcBlock::rows; ++i) {
+                for (int j = 0; j < SrcBlock::cols; ++j) {
+                    dst[i][j] = src[i][j];
+                }
+            }
+        }
+    }
+
     struct IdentityFunctor
     {
         template<class T>
@@ -338,9 +365,14 @@ namespace Opm
                             diagonal);
     }
 
+    //! \brief Create the sparsity pattern of the level n ILU of A in ILU.
+    //!
+    //! The pattern only depends on the sparsity of A, hence it can be
+    //! reused for matrices with the same structure. The values stored
+    //! in ILU are meaningless afterwards, see milun_numeric().
     template<class M>
-    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
-                             Reorderer& ordering, Reorderer& inverseOrdering)
+    void milun_symbolic(const M& A, int n, M& ILU,
+                        Reorderer& ordering, Reorderer& inverseOrdering)
     {
         using Map = std::map<std::size_t, int>;
 
@@ -395,7 +427,36 @@ namespace Opm
                 (*col)[0][0] = generationPair->second;
             }
         }
+    }
+
+    //! \brief Hash of the sparsity pattern of A, the rows and the column
+    //! indices of their nonzeroes.
+    template<class M>
+    std::size_t sparsityPatternHash(const M& A)
+    {
+        // FNV-1a over the row sizes and column indices
+        std::size_t hash = 14695981039346656037ull;
+        const auto combine = [&hash](std::size_t value)
+        {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        };
+        for (auto row = A.begin(), rend = A.end(); row != rend; ++row)
+        {
+            combine(row->size());
+            for (auto col = row->begin(), cend = row->end(); col != cend; ++col)
+            {
+                combine(col.index());
+            }
+        }
+        return hash;
+    }
 
+    //! \brief Compute the level n (M)ILU of A, reusing the sparsity
+    //! pattern created by milun_symbolic() in ILU.
+    template<class M>
+    void milun_numeric(const M& A, MILU_VARIANT milu, M& ILU, Reorderer& ordering)
+    {
         // copy Entries from A
         for(auto iter=A.begin(), iend = A.end(); iter != iend; ++iter)
         {
@@ -435,6 +496,14 @@ namespace Opm
         }
     }
 
+    template<class M>
+    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
+                             Reorderer& ordering, Reorderer& inverseOrdering)
+    {
+        milun_symbolic(A, n, ILU, ordering, inverseOrdering);
+        milun_numeric(A, milu, ILU, ordering);
+    }
+
     //! Compute Blocked ILU0 decomposition, when we know junk ghost rows are located at the end of A
     template<class M>
     void ghost_last_bilu0_decomposition (M& A, size_t interiorSize)
@@ -569,7 +638,7 @@ namespace Opm
             const size_type jIndex = j.index();
             if( j.index() == iIndex )
             {
-              inv[ row ] = (*j);
+              assignBlock(inv[ row ], *j);
               break;
             }
             else if ( j.index() >= i.index() )
@@ -600,7 +669,10 @@ namespace Opm
 /// \tparam Range The type of the Vector representing the range.
 /// \tparam ParallelInfo The type of the parallel information object
 ///         used, e.g. Dune::OwnerOverlapCommunication
-template<class Matrix, class Domain, class Range, class ParallelInfoT>
+/// \tparam FactorField The scalar type used for storing the factors. The
+///         decomposition itself is always computed in the field type of the
+///         matrix, but using float here halves the memory traffic of apply().
+template<class Matrix, class Domain, class Range, class ParallelInfoT, class FactorField>
 class ParallelOverlappingILU0
     : public Dune::PreconditionerWithUpdate<Domain,Range>
 {
@@ -619,6 +691,10 @@ public:
 
     typedef typename matrix_type::block_type  block_type;
     typedef typename matrix_type::size_type   size_type;
+    //! \brief The block type used for storing the factors.
+    using factor_block_type = std::conditional_t<std::is_same_v<FactorField, typename block_type::field_type>,
+                                                 block_type,
+                                                 Dune::FieldMatrix<FactorField, block_type::rows, block_type::cols>>;
 
 protected:
     struct CRS
@@ -653,9 +729,11 @@ protected:
           }
       }
 
-      void push_back( const block_type& value, const size_type index )
+      template<class Block>
+      void push_back( const Block& value, const size_type index )
       {
-          values_.push_back( value );
+          values_.emplace_back();
+          detail::assignBlock( values_.back(), value );
           cols_.push_back( index );
       }
 
@@ -667,9 +745,11 @@ protected:
           nRows_= 0;
       }
 
-      std::vector< size_type  > rows_;
-      std::vector< block_type > values_;
-      std::vector< size_type  > cols_;
+      // The factors are the largest arrays of the preconditioner and are
+      // read by every apply(), see FirstTouchAllocator.
+      std::vector< size_type, FirstTouchAllocator< size_type > > rows_;
+      std::vector< factor_block_type, FirstTouchAllocator< factor_block_type > > values_;
+      std::vector< size_type, FirstTouchAllocator< size_type > > cols_;
       size_type nRows_;
     };
 
@@ -692,19 +772,23 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reverse_cuthill_mckee Whether to use a reverse Cuthill-McKee ordering of the
+                                   interior rows. Ignored with red-black ordering.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true,
+                             bool reverse_cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(nullptr), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          reverseCuthillMcKee_(reverse_cuthill_mckee)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -723,19 +807,23 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reverse_cuthill_mckee Whether to use a reverse Cuthill-McKee ordering of the
+                                   interior rows. Ignored with red-black ordering.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true,
+                             bool reverse_cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          reverseCuthillMcKee_(reverse_cuthill_mckee)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -754,12 +842,15 @@ public:
                   The vertices on each layer aound it (same distance) are
                   ordered consecutivly. If false, we preserver the order of
                   the vertices with the same color.
+      \param reverse_cuthill_mckee Whether to use a reverse Cuthill-McKee ordering of the
+                                   interior rows. Ignored with red-black ordering.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const field_type w, MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
-        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere )
+                             bool reorder_sphere=true,
+                             bool reverse_cuthill_mckee=false)
+        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere, reverse_cuthill_mckee )
     {
     }
 
@@ -775,19 +866,23 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reverse_cuthill_mckee Whether to use a reverse Cuthill-McKee ordering of the
+                                   interior rows. Ignored with red-black ordering.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true,
+                             bool reverse_cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          reverseCuthillMcKee_(reverse_cuthill_mckee)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -808,13 +903,16 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reverse_cuthill_mckee Whether to use a reverse Cuthill-McKee ordering of the
+                                   interior rows. Ignored with red-black ordering.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm,
                              const field_type w, MILU_VARIANT milu,
                              size_type interiorSize, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true,
+                             bool reverse_cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -822,7 +920,8 @@ public:
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           interiorSize_(interiorSize),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          reverseCuthillMcKee_(reverse_cuthill_mckee)
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
@@ -847,13 +946,10 @@ public:
     */
     virtual void apply (Domain& v, const Range& d) override
     {
+        KernelTimer applyTimer("ilu apply");
         Range& md = reorderD(d);
         Domain& mv = reorderV(v);
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
         const size_type iEnd = lower_.rows();
         const size_type lastRow = iEnd - 1;
         size_type upperLoppStart = iEnd - interiorSize_;
@@ -863,53 +959,140 @@ public:
             OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
         }
 
-        // lower triangular solve
-        for( size_type i=0; i<lowerLoopEnd; ++ i )
+#ifdef _OPENMP
+        if ( !lowerLevels_.empty() )
         {
-          dblock rhs( md[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
-
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
-          }
-
-          mv[ i ] = rhs;  // Lii = I
+            // level scheduled triangular solves, rows within a level are independent
+            for( size_type level = 0; level + 1 < lowerLevels_.size(); ++level )
+            {
+                const auto levelBegin = static_cast<std::ptrdiff_t>(lowerLevels_[ level ]);
+                const auto levelEnd = static_cast<std::ptrdiff_t>(lowerLevels_[ level+1 ]);
+#pragma omp parallel for
+                for( std::ptrdiff_t k = levelBegin; k < levelEnd; ++k )
+                {
+                    const size_type item = levelRowsLower_[ k ];
+                    if( lowerTiles_.empty() )
+                    {
+                        lowerSolveRow( item, md, mv );
+                        continue;
+                    }
+                    for( size_type i = lowerTiles_[ item ]; i < lowerTiles_[ item+1 ]; ++i )
+                    {
+                        lowerSolveRow( i, md, mv );
+                    }
+                }
+            }
+            for( size_type level = 0; level + 1 < upperLevels_.size(); ++level )
+            {
+                const auto levelBegin = static_cast<std::ptrdiff_t>(upperLevels_[ level ]);
+                const auto levelEnd = static_cast<std::ptrdiff_t>(upperLevels_[ level+1 ]);
+#pragma omp parallel for
+                for( std::ptrdiff_t k = levelBegin; k < levelEnd; ++k )
+                {
+                    const size_type item = levelRowsUpper_[ k ];
+                    if( upperTiles_.empty() )
+                    {
+                        upperSolveRow( item, lastRow, mv );
+                        continue;
+                    }
+                    for( size_type i = upperTiles_[ item ]; i < upperTiles_[ item+1 ]; ++i )
+                    {
+                        upperSolveRow( i, lastRow, mv );
+                    }
+                }
+            }
         }
-
-        for( size_type i=upperLoppStart; i<iEnd; ++ i )
+        else
+#endif
         {
-            vblock& vBlock = mv[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
+            // lower triangular solve
+            for( size_type i=0; i<lowerLoopEnd; ++ i )
             {
-                upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+                lowerSolveRow( i, md, mv );
             }
 
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
+            for( size_type i=upperLoppStart; i<iEnd; ++ i )
+            {
+                upperSolveRow( i, lastRow, mv );
+            }
         }
 
-        copyOwnerToAll( mv );
-
         if( relaxation_ ) {
             mv *= w_;
         }
         reorderBack(mv, v);
+
+        // The index set of the communication refers to the original numbering
+        // of the rows, so the halo exchange must follow reorderBack().
+        copyOwnerToAll( v );
     }
 
     template <class V>
     void copyOwnerToAll( V& v ) const
     {
         if( comm_ ) {
+            if constexpr ( !std::is_same_v< ParallelInfo, Dune::Amg::SequentialInformation > ) {
+                if( floatHalo_ ) {
+                    copyOwnerToAllFloat( v );
+                    return;
+                }
+            }
             comm_->copyOwnerToAll(v, v);
         }
     }
 
+    /// \brief Send the values of the ghost rows in single precision in the
+    ///        halo exchange of apply(), which halves the message sizes.
+    ///
+    /// This only perturbs the preconditioner, not the operator of the solver.
+    void setFloatHalo( const bool floatHalo )
+    {
+        floatHalo_ = floatHalo;
+    }
+
+    /// \brief Schedule the threaded triangular solves of apply() over tiles
+    ///        of consecutive rows instead of over single rows.
+    ///
+    /// A tile holds about as many factor entries as fit into the L2 cache,
+    /// and its rows are solved in order by one thread, such that the parts
+    /// of the solution they read are mostly still in the cache. Tiles only
+    /// depending on tiles of lower levels are processed concurrently. The
+    /// result is bitwise identical to the sequential sweeps.
+    void setTiledApply( const bool tiledApply )
+    {
+        tiledApply_ = tiledApply;
+        computeLevelSchedule();
+    }
+
+protected:
+    //! \brief As copyOwnerToAll(), but the values are sent in single precision.
+    template <class V>
+    void copyOwnerToAllFloat( V& v ) const
+    {
+        if( !ghostRowsComputed_ ) {
+            for( const auto& index : comm_->indexSet() ) {
+                if( !ParallelInfo::OwnerSet::contains( index.local().attribute() ) ) {
+                    ghostRows_.push_back( index.local().local() );
+                }
+            }
+            ghostRowsComputed_ = true;
+        }
+        floatHaloBuffer_.resize( v.size() );
+        for( size_type i = 0; i < v.size(); ++i ) {
+            for( int k = 0; k < FloatHaloBlock::dimension; ++k ) {
+                floatHaloBuffer_[ i ][ k ] = static_cast<float>( v[ i ][ k ] );
+            }
+        }
+        comm_->copyOwnerToAll( floatHaloBuffer_, floatHaloBuffer_ );
+        // the owned values keep their full precision
+        for( const auto row : ghostRows_ ) {
+            for( int k = 0; k < FloatHaloBlock::dimension; ++k ) {
+                v[ row ][ k ] = floatHaloBuffer_[ row ][ k ];
+            }
+        }
+    }
+
+public:
     /*!
       \brief Clean up.
 
@@ -963,6 +1146,14 @@ public:
                                                       graph);
             }
         }
+        else if ( reverseCuthillMcKee_ && ordering_.size() != A_->N() )
+        {
+            // The ordering is kept as long as the size of the matrix does not change.
+            // Only the interior rows are reordered, such that the ghost rows stay last.
+            using Graph = Dune::Amg::MatrixGraph<const Matrix>;
+            Graph graph(*A_);
+            ordering_ = reorderVerticesReverseCuthillMcKee(graph, interiorSize_);
+        }
 
         std::vector<std::size_t> inverseOrdering(ordering_.size());
         std::size_t index = 0;
@@ -1030,7 +1221,6 @@ public:
             }
             else {
                 // create ILU-n decomposition
-                ILU.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
                 std::unique_ptr<detail::Reorderer> reorderer, inverseReorderer;
                 if ( ordering_.empty() )
                 {
@@ -1043,7 +1233,22 @@ public:
                     inverseReorderer.reset(new detail::RealReorderer(inverseOrdering));
                 }
 
-                milun_decomposition( *A_, iluIteration_, milu_, *ILU, *reorderer, *inverseReorderer );
+                // The fill-in pattern only depends on the structure of A and the
+                // ordering, so the symbolic phase is only redone if these change.
+                // The same size and number of nonzeroes do not imply the same
+                // structure, the column indices are compared through their hash.
+                const std::size_t patternHash = detail::sparsityPatternHash( *A_ );
+                if ( !iluNFactors_ || iluNFactors_->N() != A_->N() ||
+                     iluNNonzeroes_ != A_->nonzeroes() || iluNPatternHash_ != patternHash ||
+                     iluNOrdering_ != ordering_ )
+                {
+                    iluNFactors_.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
+                    detail::milun_symbolic( *A_, iluIteration_, *iluNFactors_, *reorderer, *inverseReorderer );
+                    iluNNonzeroes_ = A_->nonzeroes();
+                    iluNPatternHash_ = patternHash;
+                    iluNOrdering_ = ordering_;
+                }
+                detail::milun_numeric( *A_, milu_, *iluNFactors_, *reorderer );
             }
         }
         catch (const Dune::MatrixBlockError& error)
@@ -1064,10 +1269,198 @@ public:
         }
 
         // store ILU in simple CRS format
-        detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+        detail::convertToCRS( ( iluIteration_ == 0 ) ? *ILU : *iluNFactors_, lower_, upper_, inv_ );
+
+        computeLevelSchedule();
     }
 
 protected:
+    //! \brief Forward substitution for row i of L (Lii = I).
+    void lowerSolveRow( const size_type i, const Range& md, Domain& mv ) const
+    {
+        typename Range::block_type rhs( md[ i ] );
+        const size_type rowI     = lower_.rows_[ i ];
+        const size_type rowINext = lower_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
+        }
+
+        mv[ i ] = rhs;
+    }
+
+    //! \brief Backward substitution for row i of U (stored in reverse row order).
+    void upperSolveRow( const size_type i, const size_type lastRow, Domain& mv ) const
+    {
+        auto& vBlock = mv[ lastRow - i ];
+        typename Domain::block_type rhs ( vBlock );
+        const size_type rowI     = upper_.rows_[ i ];
+        const size_type rowINext = upper_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+        }
+
+        // apply inverse and store result
+        inv_[ i ].mv( rhs, vBlock);
+    }
+
+    /// \brief Compute level sets of the triangular factors for a threaded apply().
+    ///
+    /// Rows of the same level only depend on rows of lower levels and can
+    /// be processed concurrently. The result is bitwise identical to the
+    /// sequential sweeps. Only used if more than one thread is available
+    /// and the levels are wide enough to amortize the synchronization.
+    void computeLevelSchedule()
+    {
+        lowerLevels_.clear();
+        upperLevels_.clear();
+        levelRowsLower_.clear();
+        levelRowsUpper_.clear();
+        lowerTiles_.clear();
+        upperTiles_.clear();
+#ifdef _OPENMP
+        const size_type iEnd = lower_.rows();
+        if ( omp_get_max_threads() < 2 || iEnd == 0 )
+        {
+            return;
+        }
+        const size_type lastRow = iEnd - 1;
+        const size_type lowerLoopEnd = interiorSize_;
+        const size_type upperLoopStart = iEnd - interiorSize_;
+
+        if ( tiledApply_ )
+        {
+            if ( computeTileSchedule( lower_, 0, lowerLoopEnd, false, lowerTiles_, lowerLevels_, levelRowsLower_ )
+                 && computeTileSchedule( upper_, upperLoopStart, iEnd, true, upperTiles_, upperLevels_, levelRowsUpper_ ) )
+            {
+                return;
+            }
+            // too few tiles per level, fall back to the levels of the rows
+            lowerLevels_.clear();
+            upperLevels_.clear();
+            levelRowsLower_.clear();
+            levelRowsUpper_.clear();
+            lowerTiles_.clear();
+            upperTiles_.clear();
+        }
+
+        // level of each row in the forward sweep
+        std::vector<int> level( iEnd, -1 );
+        int numLevels = 0;
+        for( size_type i = 0; i < lowerLoopEnd; ++i )
+        {
+            int l = 0;
+            for( size_type col = lower_.rows_[ i ]; col < lower_.rows_[ i+1 ]; ++col )
+            {
+                l = std::max( l, level[ lower_.cols_[ col ] ] + 1 );
+            }
+            level[ i ] = l;
+            numLevels = std::max( numLevels, l + 1 );
+        }
+        if ( lowerLoopEnd < numLevels * minRowsPerLevel )
+        {
+            return;
+        }
+        bucketLevels( level, 0, lowerLoopEnd, numLevels, lowerLevels_, levelRowsLower_ );
+
+        // level of each (reversed) row in the backward sweep, indexed by original row
+        std::fill( level.begin(), level.end(), -1 );
+        std::vector<int> reversedLevel( iEnd, -1 );
+        numLevels = 0;
+        for( size_type i = upperLoopStart; i < iEnd; ++i )
+        {
+            int l = 0;
+            for( size_type col = upper_.rows_[ i ]; col < upper_.rows_[ i+1 ]; ++col )
+            {
+                l = std::max( l, level[ upper_.cols_[ col ] ] + 1 );
+            }
+            level[ lastRow - i ] = l;
+            reversedLevel[ i ] = l;
+            numLevels = std::max( numLevels, l + 1 );
+        }
+        if ( iEnd - upperLoopStart < numLevels * minRowsPerLevel )
+        {
+            lowerLevels_.clear();
+            levelRowsLower_.clear();
+            return;
+        }
+        bucketLevels( reversedLevel, upperLoopStart, iEnd, numLevels, upperLevels_, levelRowsUpper_ );
+#endif
+    }
+
+    /// \brief Split the rows [begin, end) of a factor into tiles of consecutive
+    ///        rows and compute the levels of the tiles.
+    ///
+    /// The columns of the upper factor refer to the reversed rows if
+    /// reversed is true. Returns false if the levels are too narrow.
+    static bool computeTileSchedule( const CRS& factor, const size_type begin, const size_type end,
+                                     const bool reversed, std::vector<size_type>& tileStart,
+                                     std::vector<size_type>& levelStart, std::vector<size_type>& levelTiles )
+    {
+        const size_type lastRow = factor.rows() - 1;
+        std::vector<int> tileOf( factor.rows(), -1 );
+        tileStart.clear();
+        std::size_t bytes = 0;
+        for( size_type i = begin; i < end; ++i )
+        {
+            if ( tileStart.empty() || bytes >= tileBytes )
+            {
+                tileStart.push_back( i );
+                bytes = 0;
+            }
+            tileOf[ i ] = static_cast<int>( tileStart.size() ) - 1;
+            bytes += ( factor.rows_[ i+1 ] - factor.rows_[ i ] + 1 ) * sizeof( factor_block_type );
+        }
+        tileStart.push_back( end );
+
+        const int numTiles = static_cast<int>( tileStart.size() ) - 1;
+        std::vector<int> tileLevel( numTiles, 0 );
+        int numLevels = 0;
+        for( int t = 0; t < numTiles; ++t )
+        {
+            int l = 0;
+            for( size_type col = factor.rows_[ tileStart[ t ] ]; col < factor.rows_[ tileStart[ t+1 ] ]; ++col )
+            {
+                const size_type row = reversed ? lastRow - factor.cols_[ col ] : factor.cols_[ col ];
+                const int dep = tileOf[ row ];
+                if ( dep >= 0 && dep != t )
+                {
+                    l = std::max( l, tileLevel[ dep ] + 1 );
+                }
+            }
+            tileLevel[ t ] = l;
+            numLevels = std::max( numLevels, l + 1 );
+        }
+        if ( numTiles < numLevels * minTilesPerLevel )
+        {
+            return false;
+        }
+        bucketLevels( tileLevel, 0, numTiles, numLevels, levelStart, levelTiles );
+        return true;
+    }
+
+    //! \brief Sort rows [begin, end) into level buckets (CSR-like layout).
+    static void bucketLevels( const std::vector<int>& level, const size_type begin, const size_type end,
+                              const int numLevels, std::vector<size_type>& levelStart,
+                              std::vector<size_type>& levelRows )
+    {
+        levelStart.assign( numLevels + 1, 0 );
+        for( size_type i = begin; i < end; ++i )
+        {
+            ++levelStart[ level[ i ] + 1 ];
+        }
+        std::partial_sum( levelStart.begin(), levelStart.end(), levelStart.begin() );
+        levelRows.resize( end - begin );
+        std::vector<size_type> pos( levelStart.begin(), levelStart.end() - 1 );
+        for( size_type i = begin; i < end; ++i )
+        {
+            levelRows[ pos[ level[ i ] ]++ ] = i;
+        }
+    }
+
     /// \brief Reorder D if needed and return a reference to it.
     Range& reorderD(const Range& d)
     {
@@ -1125,7 +1518,24 @@ protected:
     //! \brief The ILU0 decomposition of the matrix.
     CRS lower_;
     CRS upper_;
-    std::vector< block_type > inv_;
+    std::vector< factor_block_type, FirstTouchAllocator< factor_block_type > > inv_;
+    //! \brief Level sets of the forward/backward sweeps (empty if not used).
+    //!
+    //! The levels hold tiles instead of rows if the tiles are not empty.
+    std::vector< size_type > lowerLevels_;
+    std::vector< size_type > levelRowsLower_;
+    std::vector< size_type > upperLevels_;
+    std::vector< size_type > levelRowsUpper_;
+    //! \brief First row of each tile of the forward/backward sweeps, see setTiledApply().
+    std::vector< size_type > lowerTiles_;
+    std::vector< size_type > upperTiles_;
+    bool tiledApply_ = false;
+    //! \brief Minimum average number of rows per level for threading to pay off.
+    static constexpr size_type minRowsPerLevel = 128;
+    //! \brief Minimum average number of tiles per level for threading to pay off.
+    static constexpr int minTilesPerLevel = 2;
+    //! \brief Size of the factor entries of a tile, a part of a typical L2 cache.
+    static constexpr std::size_t tileBytes = 256 * 1024;
     //! \brief the reordering of the unknowns
     std::vector< std::size_t > ordering_;
     //! \brief The reordered right hand side
@@ -1134,15 +1544,31 @@ protected:
     Domain reorderedV_;
 
     const ParallelInfo* comm_;
+    //! \brief Send the halo of apply() in single precision, see setFloatHalo().
+    bool floatHalo_ = false;
+    using FloatHaloBlock = Dune::FieldVector< float, Domain::block_type::dimension >;
+    mutable Dune::BlockVector< FloatHaloBlock > floatHaloBuffer_;
+    mutable std::vector< size_type > ghostRows_;
+    mutable bool ghostRowsComputed_ = false;
     //! \brief The relaxation factor to use.
     const field_type w_;
     const bool relaxation_;
     size_type interiorSize_;
     const Matrix* A_;
     int iluIteration_;
+    //! \brief The level n factors with their fill-in pattern, kept for reuse
+    //! in update() as long as the structure of A and the ordering are unchanged.
+    std::unique_ptr< Matrix > iluNFactors_;
+    //! \brief Number of nonzeroes of A when iluNFactors_ was created.
+    std::size_t iluNNonzeroes_ = 0;
+    //! \brief Hash of the sparsity pattern of A when iluNFactors_ was created.
+    std::size_t iluNPatternHash_ = 0;
+    //! \brief The ordering in use when iluNFactors_ was created.
+    std::vector< std::size_t > iluNOrdering_;
     MILU_VARIANT milu_;
     bool redBlack_;
     bool reorderSphere_;
+    bool reverseCuthillMcKee_;
 };
 
 } // end namespace Opm
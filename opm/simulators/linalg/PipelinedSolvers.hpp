@@ -0,0 +1,499 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
+#define OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
+
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace Dune
+{
+
+/// Computes several global inner products with a single reduction.
+///
+/// The local contributions are summed over the owned rows only, which
+/// gives the same result as Dune::ParallelScalarProduct. The global sum
+/// can be started without blocking, so that the caller may do useful
+/// work (operator and preconditioner application) while it completes.
+template <class VectorType>
+class FusedScalarProducts
+{
+public:
+    /// Sequential products, no communication.
+    FusedScalarProducts() = default;
+
+    /// Parallel products over the rows owned by this process.
+    template <class Comm>
+    FusedScalarProducts(const Comm& comm, const std::size_t size)
+        : mask_(size, 1.0)
+    {
+        for (const auto& index : comm.indexSet()) {
+            if (index.local().attribute() != Dune::OwnerOverlapCopyAttributeSet::owner) {
+                mask_[index.local().local()] = 0.0;
+            }
+        }
+#if HAVE_MPI
+        comm_ = comm.communicator();
+#endif
+    }
+
+    /// Local contribution to the inner product of x and y.
+    double local(const VectorType& x, const VectorType& y) const
+    {
+        double result = 0.0;
+        const std::size_t n = x.size();
+        if (mask_.empty()) {
+            for (std::size_t i = 0; i < n; ++i) {
+                result += x[i].dot(y[i]);
+            }
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                result += mask_[i] * x[i].dot(y[i]);
+            }
+        }
+        return result;
+    }
+
+    /// Start summing the n local values over all processes, in place.
+    void start(double* values, const int n)
+    {
+#if HAVE_MPI
+        if (comm_ != MPI_COMM_NULL) {
+            MPI_Iallreduce(MPI_IN_PLACE, values, n, MPI_DOUBLE, MPI_SUM, comm_, &request_);
+        }
+#else
+        static_cast<void>(values);
+        static_cast<void>(n);
+#endif
+    }
+
+    /// Wait for the sum started by start() to complete.
+    void finish()
+    {
+#if HAVE_MPI
+        if (request_ != MPI_REQUEST_NULL) {
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        }
+#endif
+    }
+
+    /// Sum the n local values over all processes, in place.
+    void sum(double* values, const int n)
+    {
+        start(values, n);
+        finish();
+    }
+
+private:
+    std::vector<double> mask_;
+#if HAVE_MPI
+    MPI_Comm comm_ = MPI_COMM_NULL;
+    MPI_Request request_ = MPI_REQUEST_NULL;
+#endif
+};
+
+
+namespace Details
+{
+    /// Holds the parts shared by the solvers below: the operator,
+    /// the preconditioner, the fused scalar products and the stopping
+    /// criteria, together with the right-preconditioned operator
+    /// application.
+    template <class X>
+    class PipelinedSolverBase : public InverseOperator<X, X>
+    {
+    public:
+        using field_type = typename X::field_type;
+        using InverseOperator<X, X>::apply;
+
+        PipelinedSolverBase(LinearOperator<X, X>& op,
+                            std::shared_ptr<FusedScalarProducts<X>> sp,
+                            Preconditioner<X, X>& prec,
+                            const double reduction,
+                            const int maxit,
+                            const int verbose)
+            : op_(op), sp_(std::move(sp)), prec_(prec),
+              reduction_(reduction), maxit_(maxit), verbose_(verbose)
+        {
+        }
+
+        virtual void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+        {
+            const double saved = reduction_;
+            reduction_ = reduction;
+            this->apply(x, b, res);
+            reduction_ = saved;
+        }
+
+        virtual SolverCategory::Category category() const override
+        {
+            return op_.category();
+        }
+
+    protected:
+        /// out = A M^{-1} in, using tmp for the preconditioned vector.
+        void applyPreconditionedOperator(const X& in, X& tmp, X& out)
+        {
+            tmp = 0.0;
+            prec_.apply(tmp, in);
+            op_.apply(tmp, out);
+        }
+
+        /// x += M^{-1} correction, the final step of right preconditioning.
+        void addPreconditionedCorrection(const X& correction, X& tmp, X& x)
+        {
+            tmp = 0.0;
+            prec_.apply(tmp, correction);
+            x += tmp;
+        }
+
+        void finalize(InverseOperatorResult& res, const int iterations,
+                      const double def0, const double def, const bool converged,
+                      const Timer& watch, const char* name) const
+        {
+            res.iterations = iterations;
+            res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+            res.converged = converged;
+            res.conv_rate = iterations > 0 ? std::pow(res.reduction, 1.0 / iterations) : 0.0;
+            res.elapsed = watch.elapsed();
+            if (verbose_ > 0) {
+                std::cout << "=== " << name << ": " << (converged ? "converged" : "not converged")
+                          << " after " << iterations << " iterations, reduction "
+                          << std::scientific << std::setprecision(4) << res.reduction
+                          << ", rate " << res.conv_rate << ", time " << res.elapsed << std::endl;
+            }
+        }
+
+        void printIteration(const int iteration, const double def, const double def0) const
+        {
+            if (verbose_ > 1) {
+                std::cout << std::setw(6) << iteration << " "
+                          << std::scientific << std::setprecision(4) << def
+                          << " " << (def0 > 0.0 ? def / def0 : 0.0) << std::endl;
+            }
+        }
+
+        LinearOperator<X, X>& op_;
+        std::shared_ptr<FusedScalarProducts<X>> sp_;
+        Preconditioner<X, X>& prec_;
+        double reduction_;
+        int maxit_;
+        int verbose_;
+    };
+} // namespace Details
+
+
+/// Pipelined BiCGSTAB (Cools and Vanroose, 2017), right preconditioned.
+///
+/// Mathematically equivalent to BiCGSTAB, but the recurrences are
+/// rearranged so that each iteration needs two global reductions, each
+/// of which is overlapped with one application of the preconditioned
+/// operator. Slightly more vector updates are needed per iteration than
+/// for the standard method.
+template <class X>
+class PipelinedBiCGSTABSolver : public Details::PipelinedSolverBase<X>
+{
+    using Base = Details::PipelinedSolverBase<X>;
+
+public:
+    using Base::Base;
+    using Base::apply;
+
+    virtual void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        auto& sp = *this->sp_;
+
+        this->prec_.pre(x, b);
+
+        X r(b);
+        this->op_.applyscaleadd(-1.0, x, r);
+        const X rhat(r);
+        X w(r), t(r), tmp(r);
+        X p(r), s(r), z(r), q(r), y(r), v(r);
+        X correction(r);
+        correction = 0.0;
+
+        // Initial reduction, overlapped with t = A M^{-1} w.
+        this->applyPreconditionedOperator(r, tmp, w);
+        std::array<double, 3> init = { sp.local(rhat, r), sp.local(rhat, w), sp.local(r, r) };
+        sp.start(init.data(), static_cast<int>(init.size()));
+        this->applyPreconditionedOperator(w, tmp, t);
+        sp.finish();
+
+        const double def0 = std::sqrt(init[2]);
+        double def = def0;
+        this->printIteration(0, def, def0);
+        if (def0 == 0.0 || init[1] == 0.0) {
+            this->prec_.post(x);
+            this->finalize(res, 0, def0, def, true, watch, "PipelinedBiCGSTAB");
+            return;
+        }
+
+        double rho = init[0];
+        double alpha = rho / init[1];
+        double beta = 0.0;
+        double omega = 0.0;
+        bool converged = false;
+        int it = 1;
+        for (; it <= this->maxit_; ++it) {
+            if (it == 1) {
+                p = r;
+                s = w;
+                z = t;
+            } else {
+                // p = r + beta (p - omega s), likewise for s and z.
+                p.axpy(-omega, s);
+                p *= beta;
+                p += r;
+                s.axpy(-omega, z);
+                s *= beta;
+                s += w;
+                z.axpy(-omega, v);
+                z *= beta;
+                z += t;
+            }
+            q = r;
+            q.axpy(-alpha, s);
+            y = w;
+            y.axpy(-alpha, z);
+
+            std::array<double, 2> first = { sp.local(q, y), sp.local(y, y) };
+            sp.start(first.data(), static_cast<int>(first.size()));
+            this->applyPreconditionedOperator(z, tmp, v);
+            sp.finish();
+
+            omega = first[1] > 0.0 ? first[0] / first[1] : 0.0;
+            correction.axpy(alpha, p);
+            correction.axpy(omega, q);
+            r = q;
+            r.axpy(-omega, y);
+            // w = y - omega (t - alpha v)
+            t.axpy(-alpha, v);
+            w = y;
+            w.axpy(-omega, t);
+
+            std::array<double, 5> second = { sp.local(rhat, r), sp.local(rhat, w),
+                                             sp.local(rhat, s), sp.local(rhat, z),
+                                             sp.local(r, r) };
+            sp.start(second.data(), static_cast<int>(second.size()));
+            this->applyPreconditionedOperator(w, tmp, t);
+            sp.finish();
+
+            def = std::sqrt(second[4]);
+            this->printIteration(it, def, def0);
+            if (def < this->reduction_ * def0) {
+                converged = true;
+                break;
+            }
+            if (omega == 0.0 || second[0] == 0.0) {
+                // Breakdown, give up with the current iterate.
+                break;
+            }
+            beta = (alpha / omega) * (second[0] / rho);
+            const double denom = second[1] + beta * second[2] - beta * omega * second[3];
+            if (denom == 0.0) {
+                break;
+            }
+            rho = second[0];
+            alpha = rho / denom;
+        }
+
+        this->addPreconditionedCorrection(correction, tmp, x);
+        this->prec_.post(x);
+        this->finalize(res, std::min(it, this->maxit_), def0, def, converged, watch, "PipelinedBiCGSTAB");
+    }
+};
+
+
+/// Restarted GMRES with low-synchronization orthogonalization, right
+/// preconditioned.
+///
+/// The new Krylov vector is orthogonalized against all previous ones by
+/// classical Gram-Schmidt with one reorthogonalization pass. All inner
+/// products of a pass are summed in a single reduction, and the norm of
+/// the new vector is folded into the second one, so that every iteration
+/// needs exactly two global reductions regardless of the restart length.
+/// The modified Gram-Schmidt used by Dune::RestartedGMResSolver needs one
+/// reduction per basis vector instead.
+template <class X>
+class LowSyncGMResSolver : public Details::PipelinedSolverBase<X>
+{
+    using Base = Details::PipelinedSolverBase<X>;
+
+public:
+    LowSyncGMResSolver(LinearOperator<X, X>& op,
+                       std::shared_ptr<FusedScalarProducts<X>> sp,
+                       Preconditioner<X, X>& prec,
+                       const double reduction,
+                       const int restart,
+                       const int maxit,
+                       const int verbose)
+        : Base(op, std::move(sp), prec, reduction, maxit, verbose)
+        , restart_(std::max(restart, 1))
+    {
+    }
+
+    using Base::apply;
+
+    virtual void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        auto& sp = *this->sp_;
+        const int m = restart_;
+
+        this->prec_.pre(x, b);
+
+        X r(b), w(b), tmp(b);
+        std::vector<X> basis(m + 1, b);
+        std::vector<std::vector<double>> H(m + 1, std::vector<double>(m, 0.0));
+        std::vector<double> g(m + 1), cs(m), sn(m), dots(m + 2);
+
+        double def0 = 0.0;
+        double def = 0.0;
+        bool converged = false;
+        int it = 0;
+        while (true) {
+            // Fresh residual at the start of each cycle.
+            r = b;
+            this->op_.applyscaleadd(-1.0, x, r);
+            double beta = sp.local(r, r);
+            sp.sum(&beta, 1);
+            beta = std::sqrt(beta);
+            if (it == 0) {
+                def0 = beta;
+                this->printIteration(0, beta, def0);
+            }
+            def = beta;
+            if (beta == 0.0 || beta < this->reduction_ * def0) {
+                converged = true;
+                break;
+            }
+            if (it >= this->maxit_) {
+                break;
+            }
+
+            basis[0] = r;
+            basis[0] *= 1.0 / beta;
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            int k = 0;
+            for (; k < m && it < this->maxit_; ++k) {
+                ++it;
+                this->applyPreconditionedOperator(basis[k], tmp, w);
+
+                // First Gram-Schmidt pass.
+                for (int i = 0; i <= k; ++i) {
+                    dots[i] = sp.local(basis[i], w);
+                }
+                sp.sum(dots.data(), k + 1);
+                for (int i = 0; i <= k; ++i) {
+                    H[i][k] = dots[i];
+                    w.axpy(-dots[i], basis[i]);
+                }
+
+                // Second pass, with the norm of w in the same reduction.
+                for (int i = 0; i <= k; ++i) {
+                    dots[i] = sp.local(basis[i], w);
+                }
+                dots[k + 1] = sp.local(w, w);
+                sp.sum(dots.data(), k + 2);
+                double correction2 = 0.0;
+                for (int i = 0; i <= k; ++i) {
+                    H[i][k] += dots[i];
+                    w.axpy(-dots[i], basis[i]);
+                    correction2 += dots[i] * dots[i];
+                }
+                const double hnext = std::sqrt(std::max(dots[k + 1] - correction2, 0.0));
+                H[k + 1][k] = hnext;
+
+                // Apply previous rotations to the new column, then a new one.
+                for (int i = 0; i < k; ++i) {
+                    const double tmpH = cs[i] * H[i][k] + sn[i] * H[i + 1][k];
+                    H[i + 1][k] = -sn[i] * H[i][k] + cs[i] * H[i + 1][k];
+                    H[i][k] = tmpH;
+                }
+                const double denom = std::hypot(H[k][k], H[k + 1][k]);
+                cs[k] = denom > 0.0 ? H[k][k] / denom : 1.0;
+                sn[k] = denom > 0.0 ? H[k + 1][k] / denom : 0.0;
+                H[k][k] = denom;
+                H[k + 1][k] = 0.0;
+                g[k + 1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
+
+                def = std::abs(g[k + 1]);
+                this->printIteration(it, def, def0);
+                if (def < this->reduction_ * def0 || hnext == 0.0) {
+                    ++k;
+                    converged = def < this->reduction_ * def0;
+                    break;
+                }
+                basis[k + 1] = w;
+                basis[k + 1] *= 1.0 / hnext;
+            }
+
+            // Solve the triangular least squares system and update x.
+            std::vector<double> coeff(k, 0.0);
+            for (int i = k - 1; i >= 0; --i) {
+                double sum = g[i];
+                for (int j = i + 1; j < k; ++j) {
+                    sum -= H[i][j] * coeff[j];
+                }
+                coeff[i] = H[i][i] != 0.0 ? sum / H[i][i] : 0.0;
+            }
+            w = 0.0;
+            for (int i = 0; i < k; ++i) {
+                w.axpy(coeff[i], basis[i]);
+            }
+            this->addPreconditionedCorrection(w, tmp, x);
+
+            if (converged || it >= this->maxit_) {
+                break;
+            }
+        }
+
+        this->prec_.post(x);
+        this->finalize(res, it, def0, def, converged, watch, "LowSyncGMRes");
+    }
+
+private:
+    int restart_;
+};
+
+} // namespace Dune
+
+#endif // OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
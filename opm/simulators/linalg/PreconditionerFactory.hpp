@@ -23,11 +23,15 @@
 #define OPM_PRECONDITIONERFACTORY_HEADER
 
 #include <opm/simulators/linalg/OwningBlockPreconditioner.hpp>
+#include <opm/simulators/linalg/OwningRestrictedAdditiveSchwarz.hpp>
 #include <opm/simulators/linalg/OwningTwoLevelPreconditioner.hpp>
 #include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/linalg/WellSystemBlocksProvider.hpp>
 #include <opm/simulators/linalg/amgcpr.hh>
 
+#include <opm/common/ErrorMacros.hpp>
+
 #include <dune/istl/paamg/amg.hh>
 #include <dune/istl/paamg/kamg.hh>
 #include <dune/istl/paamg/fastamg.hh>
@@ -37,6 +41,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 
 namespace Opm
 {
@@ -134,10 +139,10 @@ private:
         criterion.setNoPreSmoothSteps(prm.get<int>("pre_smooth", 1));
         criterion.setNoPostSmoothSteps(prm.get<int>("post_smooth", 1));
         criterion.setDebugLevel(prm.get<int>("verbosity", 0));
-        // As the default we request to accumulate data to 1 process always as our matrix
-        // graph might be unsymmetric and hence not supported by the PTScotch/ParMetis
-        // calls in DUNE. Accumulating to 1 skips PTScotch/ParMetis
-        criterion.setAccumulate(static_cast<Dune::Amg::AccumulationMode>(prm.get<int>("accumulate", 1)));
+        criterion.setAccumulate(amgAccumulationMode(prm));
+        // Coarsening stops (and the coarse levels are accumulated) when a level
+        // is not at least this much smaller than the previous one.
+        criterion.setMinCoarsenRate(prm.get<double>("min_coarsen_rate", 1.2));
         criterion.setProlongationDampingFactor(prm.get<double>("prolongationdamping", 1.6));
         criterion.setMaxDistance(prm.get<int>("maxdistance", 2));
         criterion.setMaxConnectivity(prm.get<int>("maxconnectivity", 15));
@@ -146,6 +151,36 @@ private:
         return criterion;
     }
 
+    /// How the coarse levels of a parallel AMG hierarchy are agglomerated
+    /// onto fewer processes once they have few unknowns per process, either
+    /// "none", "once" (all onto one process, which then solves the coarsest
+    /// level directly if a direct solver is available) or "successive" (onto
+    /// a decreasing subset of the processes), or the number of the mode.
+    static Dune::Amg::AccumulationMode amgAccumulationMode(const boost::property_tree::ptree& prm)
+    {
+        // As the default we request to accumulate data to 1 process always as our matrix
+        // graph might be unsymmetric and hence not supported by the PTScotch/ParMetis
+        // calls in DUNE. Accumulating to 1 skips PTScotch/ParMetis
+        const auto mode = prm.get<std::string>("accumulate", "once");
+        if (mode == "none" || mode == "0") {
+            return Dune::Amg::noAccu;
+        }
+        if (mode == "once" || mode == "1") {
+            return Dune::Amg::atOnceAccu;
+        }
+        if (mode == "successive" || mode == "2") {
+#if HAVE_PARMETIS || HAVE_PTSCOTCH
+            // Partitions the coarse graph onto a subset of the processes,
+            // only valid if the matrix graph is symmetric.
+            return Dune::Amg::successiveAccu;
+#else
+            OPM_THROW(std::invalid_argument, "Properties: accumulate = " << mode
+                      << " needs ParMETIS or PT-Scotch, use \"once\" instead.");
+#endif
+        }
+        OPM_THROW(std::invalid_argument, "Properties: No accumulation mode with name " << mode << ".");
+    }
+
     /// Helper struct to explicitly overload amgSmootherArgs() version for
     /// ParallelOverlappingILU0, since in-class specialization is not allowed.
     template <typename X> struct Id { using Type = X; };
@@ -170,10 +205,11 @@ private:
         return smootherArgs;
     }
 
+    template <class FactorField>
     static auto amgSmootherArgs(const boost::property_tree::ptree& prm,
-                                Id<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>)
+                                Id<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm, FactorField>>)
     {
-        using Smoother = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>;
+        using Smoother = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm, FactorField>;
         using SmootherArgs = typename Dune::Amg::SmootherTraits<Smoother>::Arguments;
         SmootherArgs smootherArgs;
         smootherArgs.iterations = prm.get<int>("iterations", 1);
@@ -229,21 +265,60 @@ private:
         }
     }
 
+    template <class FactorField = typename Vector::field_type>
     static PrecPtr
     createParILU(const Operator& op, const boost::property_tree::ptree& prm, const Comm& comm, const int ilulevel)
     {
+        using ILU = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm, FactorField>;
         const double w = prm.get<double>("relaxation", 1.0);
         const bool redblack = prm.get<bool>("redblack", false);
         const bool reorder_spheres = prm.get<bool>("reorder_spheres", false);
+        const bool reverse_cuthill_mckee = prm.get<bool>("reverse_cuthill_mckee", false);
         // Already a parallel preconditioner. Need to pass comm, but no need to wrap it in a BlockPreconditioner.
+        std::shared_ptr<ILU> ilu;
         if (ilulevel == 0) {
             const size_t num_interior = interiorIfGhostLast(comm);
-            return std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>(
-                op.getmat(), comm, w, Opm::MILU_VARIANT::ILU, num_interior, redblack, reorder_spheres);
+            ilu = std::make_shared<ILU>(
+                op.getmat(), comm, w, Opm::MILU_VARIANT::ILU, num_interior, redblack, reorder_spheres, reverse_cuthill_mckee);
         } else {
-            return std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>(
-                op.getmat(), comm, ilulevel, w, Opm::MILU_VARIANT::ILU, redblack, reorder_spheres);
+            ilu = std::make_shared<ILU>(
+                op.getmat(), comm, ilulevel, w, Opm::MILU_VARIANT::ILU, redblack, reorder_spheres, reverse_cuthill_mckee);
+        }
+        ilu->setFloatHalo(prm.get<bool>("float_halo", false));
+        ilu->setTiledApply(prm.get<bool>("tiled_apply", false));
+        return ilu;
+    }
+
+    /// Create a parallel ILU, storing the factors in single precision
+    /// if the parameter "float_factors" is true.
+    static PrecPtr
+    createParILUMaybeFloat(const Operator& op, const boost::property_tree::ptree& prm, const Comm& comm, const int ilulevel)
+    {
+        if (prm.get<bool>("float_factors", false)) {
+            return createParILU<float>(op, prm, comm, ilulevel);
         }
+        return createParILU(op, prm, comm, ilulevel);
+    }
+
+    /// Create a sequential ILU, storing the factors in single precision
+    /// if the parameter "float_factors" is true.
+    static PrecPtr
+    createSeqILU(const Operator& op, const boost::property_tree::ptree& prm, const int ilulevel)
+    {
+        const double w = prm.get<double>("relaxation", 1.0);
+        const bool reverse_cuthill_mckee = prm.get<bool>("reverse_cuthill_mckee", false);
+        const bool tiled_apply = prm.get<bool>("tiled_apply", false);
+        if (prm.get<bool>("float_factors", false)) {
+            auto ilu = std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector,
+                                                                     Dune::Amg::SequentialInformation, float>>(
+                op.getmat(), ilulevel, w, Opm::MILU_VARIANT::ILU, false, true, reverse_cuthill_mckee);
+            ilu->setTiledApply(tiled_apply);
+            return ilu;
+        }
+        auto ilu = std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector>>(
+            op.getmat(), ilulevel, w, Opm::MILU_VARIANT::ILU, false, true, reverse_cuthill_mckee);
+        ilu->setTiledApply(tiled_apply);
+        return ilu;
     }
 
     // Add a useful default set of preconditioners to the factory.
@@ -259,13 +334,13 @@ private:
         using P = boost::property_tree::ptree;
         using C = Comm;
         doAddCreator("ILU0", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
-            return createParILU(op, prm, comm, 0);
+            return createParILUMaybeFloat(op, prm, comm, 0);
         });
         doAddCreator("ParOverILU0", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
-            return createParILU(op, prm, comm, prm.get<int>("ilulevel", 0));
+            return createParILUMaybeFloat(op, prm, comm, prm.get<int>("ilulevel", 0));
         });
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
-            return createParILU(op, prm, comm, prm.get<int>("ilulevel", 0));
+            return createParILUMaybeFloat(op, prm, comm, prm.get<int>("ilulevel", 0));
         });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&,
                                const C& comm) {
@@ -297,8 +372,13 @@ private:
             doAddCreator("amg", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
                 const std::string smoother = prm.get<std::string>("smoother", "ParOverILU0");
                 if (smoother == "ILU0" || smoother == "ParOverILU0") {
-                    using Smoother = Opm::ParallelOverlappingILU0<M, V, V, C>;
                     auto crit = amgCriterion(prm);
+                    if (prm.get<bool>("float_factors", false)) {
+                        using Smoother = Opm::ParallelOverlappingILU0<M, V, V, C, float>;
+                        auto sargs = amgSmootherArgs<Smoother>(prm);
+                        return std::make_shared<Dune::Amg::AMGCPR<O, V, Smoother, C>>(op, crit, sargs, comm);
+                    }
+                    using Smoother = Opm::ParallelOverlappingILU0<M, V, V, C>;
                     auto sargs = amgSmootherArgs<Smoother>(prm);
                     return std::make_shared<Dune::Amg::AMGCPR<O, V, Smoother, C>>(op, crit, sargs, comm);
                 } else {
@@ -315,6 +395,14 @@ private:
             assert(weightsCalculator);
             return std::make_shared<OwningTwoLevelPreconditioner<O, V, true, Comm>>(op, prm, weightsCalculator, comm);
         });
+#if HAVE_MPI
+        doAddCreator("ras", [](const O& op, const P& prm, const std::function<Vector()>& weightsCalculator, const C& comm) {
+            return std::make_shared<OwningRestrictedAdditiveSchwarz<O, V, C>>(op, prm, weightsCalculator, comm);
+        });
+#endif
+        doAddCreator("cprw", [](const O&, const P&, const std::function<Vector()>, const C&) -> PrecPtr {
+            OPM_THROW(std::invalid_argument, "cprw is only supported in sequential runs.");
+        });
     }
 
     // Add a useful default set of preconditioners to the factory.
@@ -327,21 +415,13 @@ private:
         using V = Vector;
         using P = boost::property_tree::ptree;
         doAddCreator("ILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const double w = prm.get<double>("relaxation", 1.0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), 0, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, 0);
         });
         doAddCreator("ParOverILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const double w = prm.get<double>("relaxation", 1.0);
-            const int n = prm.get<int>("ilulevel", 0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, prm.get<int>("ilulevel", 0));
         });
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const int n = prm.get<int>("ilulevel", 0);
-            const double w = prm.get<double>("relaxation", 1.0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, prm.get<int>("ilulevel", 0));
         });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const int n = prm.get<int>("repeats", 1);
@@ -442,6 +522,16 @@ private:
         doAddCreator("cprt", [](const O& op, const P& prm, const std::function<Vector()>& weightsCalculator) {
             return std::make_shared<OwningTwoLevelPreconditioner<O, V, true>>(op, prm, weightsCalculator);
         });
+        doAddCreator("ras", [](const O& op, const P& prm, const std::function<Vector()>& weightsCalculator) {
+            // a single subdomain
+            auto child = prm.get_child_optional("local_solver");
+            return makeLocalSchwarzSolver(op, child ? *child : P(), weightsCalculator);
+        });
+        doAddCreator("cprw", [](const O& op, const P& prm, const std::function<Vector()>& weightsCalculator) {
+            // the wells are taken from the operator whenever the pressure system is updated
+            auto wellBlocks = [&op]() { return Opm::wellSystemBlocks(op); };
+            return std::make_shared<OwningTwoLevelPreconditioner<O, V, false>>(op, prm, weightsCalculator, wellBlocks);
+        });
     }
 
 
@@ -22,12 +22,31 @@
 #define OPM_PRESSURE_TRANSFER_POLICY_HEADER_INCLUDED
 
 
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
 #include <opm/simulators/linalg/twolevelmethodcpr.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 
 namespace Opm
 {
 
+/// Restriction of a system to the pressure system of CPR.
+///
+/// If a function providing the blocks of the wells which are not part of
+/// the fine matrix is given, the pressure system gets one unknown per well
+/// segment, the bottom hole or segment pressure, coupled to the perforated
+/// cells. The wells are then part of the pressure solve without the fill-in
+/// of adding their Schur complement to the matrix. Their right hand side is
+/// zero, as the fine residual already includes the wells. Only used without
+/// transpose.
 template <class FineOperator, class CoarseOperator, class Communication, bool transpose = false>
 class PressureTransferPolicy : public Dune::Amg::LevelTransferPolicyCpr<FineOperator, CoarseOperator>
 {
@@ -37,25 +56,42 @@ public:
     typedef typename FineOperator::domain_type FineVectorType;
 
 public:
-    PressureTransferPolicy(const Communication& comm, const FineVectorType& weights, int pressure_var_index)
+    using WellBlocksFunction = std::function<std::vector<Helper::WellSystemBlocks>()>;
+
+    PressureTransferPolicy(const Communication& comm, const FineVectorType& weights, int pressure_var_index,
+                           const WellBlocksFunction& wellBlocks = WellBlocksFunction())
         : communication_(&const_cast<Communication&>(comm))
         , weights_(weights)
         , pressure_var_index_(pressure_var_index)
+        , wellBlocks_(wellBlocks)
     {
     }
 
     virtual void createCoarseLevelSystem(const FineOperator& fineOperator) override
     {
-        using CoarseMatrix = typename CoarseOperator::matrix_type;
         const auto& fineLevelMatrix = fineOperator.getmat();
-        coarseLevelMatrix_.reset(new CoarseMatrix(fineLevelMatrix.N(), fineLevelMatrix.M(), CoarseMatrix::row_wise));
-        auto createIter = coarseLevelMatrix_->createbegin();
+        // The pressure matrix has the pattern of the fine matrix, extended
+        // by the wells if requested. When the preconditioner is updated for
+        // the same fine matrix, the pressure matrix without wells of the
+        // previous update is reused and only its entries are updated. The
+        // previous coarse solver is not used anymore then.
+        auto& cache = coarseMatrixCache_;
+        if (wellBlocks_) {
+            createCoarseMatrixWithWells_(fineLevelMatrix);
+        } else if (cache.fineMatrix == &fineLevelMatrix && cache.matrix && samePattern_(fineLevelMatrix, *cache.matrix)) {
+            coarseLevelMatrix_ = cache.matrix;
+        } else {
+            coarseLevelMatrix_.reset(new CoarseMatrix(fineLevelMatrix.N(), fineLevelMatrix.M(), CoarseMatrix::row_wise));
+            auto createIter = coarseLevelMatrix_->createbegin();
 
-        for (const auto& row : fineLevelMatrix) {
-            for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
-                createIter.insert(col.index());
+            for (const auto& row : fineLevelMatrix) {
+                for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
+                    createIter.insert(col.index());
+                }
+                ++createIter;
             }
-            ++createIter;
+            cache.fineMatrix = &fineLevelMatrix;
+            cache.matrix = coarseLevelMatrix_;
         }
 
         calculateCoarseEntries(fineOperator);
@@ -76,12 +112,18 @@ public:
     virtual void calculateCoarseEntries(const FineOperator& fineOperator) override
     {
         const auto& fineMatrix = fineOperator.getmat();
-        *coarseLevelMatrix_ = 0;
-        auto rowCoarse = coarseLevelMatrix_->begin();
-        for (auto row = fineMatrix.begin(), rowEnd = fineMatrix.end(); row != rowEnd; ++row, ++rowCoarse) {
-            assert(row.index() == rowCoarse.index());
-            auto entryCoarse = rowCoarse->begin();
-            for (auto entry = row->begin(), entryEnd = row->end(); entry != entryEnd; ++entry, ++entryCoarse) {
+        auto& coarseMatrix = *coarseLevelMatrix_;
+        assert(fineMatrix.N() <= coarseMatrix.N());
+        // Every coarse row only depends on the corresponding fine row.
+        const long long numRows = static_cast<long long>(fineMatrix.N());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long long r = 0; r < numRows; ++r) {
+            const auto& row = fineMatrix[r];
+            auto& rowCoarse = coarseMatrix[r];
+            auto entryCoarse = rowCoarse.begin();
+            for (auto entry = row.begin(), entryEnd = row.end(); entry != entryEnd; ++entry, ++entryCoarse) {
                 assert(entry.index() == entryCoarse.index());
                 double matrix_el = 0;
                 if (transpose) {
@@ -90,15 +132,22 @@ public:
                         matrix_el += (*entry)[pressure_var_index_][i] * bw[i];
                     }
                 } else {
-                    const auto& bw = weights_[row.index()];
+                    const auto& bw = weights_[r];
                     for (size_t i = 0; i < bw.size(); ++i) {
                         matrix_el += (*entry)[i][pressure_var_index_] * bw[i];
                     }
                 }
                 (*entryCoarse) = matrix_el;
             }
+            // couplings to the wells
+            for (; entryCoarse != rowCoarse.end(); ++entryCoarse) {
+                (*entryCoarse) = 0.0;
+            }
+        }
+
+        if (wellBlocks_) {
+            addWellEntries_(fineMatrix.N());
         }
-        assert(rowCoarse == coarseLevelMatrix_->end());
     }
 
     virtual void moveToCoarseLevel(const typename ParentType::FineRangeType& fine) override
@@ -151,11 +200,260 @@ public:
     }
 
 private:
+    using CoarseMatrix = typename CoarseOperator::matrix_type;
+    using FineMatrix = typename FineOperator::matrix_type;
+
+    struct CoarseMatrixCache
+    {
+        CoarseMatrixCache() = default;
+        // a clone starts with an empty cache, it must not update the
+        // pressure matrix of the original
+        CoarseMatrixCache(const CoarseMatrixCache&) {}
+        CoarseMatrixCache& operator=(const CoarseMatrixCache&)
+        {
+            fineMatrix = nullptr;
+            matrix.reset();
+            return *this;
+        }
+
+        const FineMatrix* fineMatrix = nullptr;
+        std::shared_ptr<CoarseMatrix> matrix;
+    };
+
+    static bool samePattern_(const FineMatrix& fineMatrix, const CoarseMatrix& coarseMatrix)
+    {
+        if (fineMatrix.N() != coarseMatrix.N() || fineMatrix.M() != coarseMatrix.M()
+            || fineMatrix.nonzeroes() != coarseMatrix.nonzeroes()) {
+            return false;
+        }
+        for (auto row = fineMatrix.begin(), rowCoarse = coarseMatrix.begin(); row != fineMatrix.end(); ++row, ++rowCoarse) {
+            if (row->size() != rowCoarse->size()) {
+                return false;
+            }
+            for (auto col = row->begin(), colCoarse = rowCoarse->begin(); col != row->end(); ++col, ++colCoarse) {
+                if (col.index() != colCoarse.index()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // The pattern of the fine matrix, extended by a row and a column per
+    // well segment, coupled to the perforated cells and to the segments
+    // of the same well. The wells are remembered by name, wells added
+    // later are left out until the next setup.
+    void createCoarseMatrixWithWells_(const FineMatrix& fineMatrix)
+    {
+        const auto wells = wellBlocks_();
+        const int numCells = fineMatrix.N();
+        int numRows = numCells;
+        wellRows_.clear();
+        for (const auto& well : wells) {
+            if (well.D.rows > 0 && wellRows_.count(well.name) == 0) {
+                wellRows_[well.name] = {numRows, static_cast<int>(well.D.rows)};
+                numRows += well.D.rows;
+            }
+        }
+
+        std::vector<std::vector<int>> extraColumns(numRows);
+        for (const auto& well : wells) {
+            const auto rows = wellRows_.find(well.name);
+            if (rows == wellRows_.end() || rows->second.second != well.D.rows) {
+                continue;
+            }
+            const int first = rows->second.first;
+            for (const auto* blocks : {&well.B, &well.C}) {
+                for (long seg = 0; seg < blocks->rows; ++seg) {
+                    for (long k = blocks->rowStart[seg]; k < blocks->rowStart[seg + 1]; ++k) {
+                        extraColumns[blocks->columns[k]].push_back(first + seg);
+                        extraColumns[first + seg].push_back(blocks->columns[k]);
+                    }
+                }
+            }
+            for (long seg = 0; seg < well.D.rows; ++seg) {
+                extraColumns[first + seg].push_back(first + seg);
+                for (long k = well.D.rowStart[seg]; k < well.D.rowStart[seg + 1]; ++k) {
+                    extraColumns[first + seg].push_back(first + well.D.columns[k]);
+                }
+            }
+        }
+
+        coarseLevelMatrix_.reset(new CoarseMatrix(numRows, numRows, CoarseMatrix::row_wise));
+        auto createIter = coarseLevelMatrix_->createbegin();
+        for (int r = 0; r < numRows; ++r, ++createIter) {
+            if (r < numCells) {
+                const auto& row = fineMatrix[r];
+                for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
+                    createIter.insert(col.index());
+                }
+            }
+            for (const int col : extraColumns[r]) {
+                createIter.insert(col);
+            }
+        }
+    }
+
+    // The quasi-IMPES restriction of the well equations: the equations of a
+    // segment are weighted by the last row of the inverse of its diagonal
+    // block, the last well unknown is the pressure of the segment.
+    void addWellEntries_(const int numCells)
+    {
+        auto& coarseMatrix = *coarseLevelMatrix_;
+        const int numRows = coarseMatrix.N();
+        for (int r = numCells; r < numRows; ++r) {
+            coarseMatrix[r] = 0.0;
+        }
+        const auto add = [&coarseMatrix](const int row, const int col, const double value)
+        {
+            auto entry = coarseMatrix[row].find(col);
+            if (entry != coarseMatrix[row].end()) {
+                (*entry) += value;
+            }
+        };
+
+        for (const auto& well : wellBlocks_()) {
+            const auto rows = wellRows_.find(well.name);
+            if (rows == wellRows_.end() || rows->second.second != well.D.rows) {
+                continue;
+            }
+            const int first = rows->second.first;
+            const int nw = well.D.blockRows;
+            const int pw = nw - 1;
+            const int nc = well.B.blockCols;
+            const auto block = [](const Helper::SparseBlockMatrix& m, const long k)
+            {
+                return m.values.begin() + k * m.blockRows * m.blockCols;
+            };
+
+            for (long seg = 0; seg < well.D.rows; ++seg) {
+                // the diagonal block of D and its inverse
+                const auto diag = std::find(well.D.columns.begin() + well.D.rowStart[seg],
+                                            well.D.columns.begin() + well.D.rowStart[seg + 1], seg);
+                if (diag == well.D.columns.begin() + well.D.rowStart[seg + 1]) {
+                    continue;
+                }
+                const auto diagIt = block(well.D, diag - well.D.columns.begin());
+                // standard wells store the inverse, recover the block itself
+                std::vector<double> diagBlock(diagIt, diagIt + nw * nw);
+                std::vector<double> inverse = diagBlock;
+                if (!invertDense_(well.inverseD ? diagBlock : inverse, nw)) {
+                    continue;
+                }
+
+                std::vector<double> ww(inverse.begin() + pw * nw, inverse.begin() + (pw + 1) * nw);
+                const double absMax = std::abs(*std::max_element(ww.begin(), ww.end(), [](double a, double b)
+                                                                  { return std::abs(a) < std::abs(b); }));
+                if (absMax == 0.0) {
+                    continue;
+                }
+                for (auto& w : ww) {
+                    w /= absMax;
+                }
+
+                // segment row: D and B
+                for (long k = well.D.rowStart[seg]; k < well.D.rowStart[seg + 1]; ++k) {
+                    // standard wells only have the (inverted) diagonal block
+                    const auto d = well.inverseD ? diagBlock.cbegin() : block(well.D, k);
+                    double value = 0.0;
+                    for (int j = 0; j < nw; ++j) {
+                        value += ww[j] * d[j * nw + pw];
+                    }
+                    add(first + seg, first + well.D.columns[k], value);
+                }
+                for (long k = well.B.rowStart[seg]; k < well.B.rowStart[seg + 1]; ++k) {
+                    const auto b = block(well.B, k);
+                    double value = 0.0;
+                    for (int j = 0; j < nw; ++j) {
+                        value += ww[j] * b[j * nc + pressure_var_index_];
+                    }
+                    add(first + seg, well.B.columns[k], value);
+                }
+                // segment column of the cell rows: C^T weighted like the cell equations
+                for (long k = well.C.rowStart[seg]; k < well.C.rowStart[seg + 1]; ++k) {
+                    const int cell = well.C.columns[k];
+                    const auto c = block(well.C, k);
+                    const auto& bw = weights_[cell];
+                    double value = 0.0;
+                    for (std::size_t i = 0; i < bw.size(); ++i) {
+                        value += bw[i] * c[pw * well.C.blockCols + i];
+                    }
+                    add(cell, first + seg, value);
+                }
+            }
+        }
+
+        // the segments of wells which have no equations now are decoupled
+        for (int r = numCells; r < numRows; ++r) {
+            auto& diag = coarseMatrix[r][r];
+            if (diag[0][0] == 0.0) {
+                diag = 1.0;
+            }
+        }
+    }
+
+    // Invert a small dense row major matrix in place by Gauss-Jordan
+    // elimination with partial pivoting, false if it is singular.
+    static bool invertDense_(std::vector<double>& a, const int n)
+    {
+        std::vector<int> perm(n);
+        for (int i = 0; i < n; ++i) {
+            perm[i] = i;
+        }
+        for (int k = 0; k < n; ++k) {
+            int pivot = k;
+            for (int i = k + 1; i < n; ++i) {
+                if (std::abs(a[i * n + k]) > std::abs(a[pivot * n + k])) {
+                    pivot = i;
+                }
+            }
+            if (a[pivot * n + k] == 0.0) {
+                return false;
+            }
+            if (pivot != k) {
+                for (int j = 0; j < n; ++j) {
+                    std::swap(a[k * n + j], a[pivot * n + j]);
+                }
+                std::swap(perm[k], perm[pivot]);
+            }
+            const double inv = 1.0 / a[k * n + k];
+            a[k * n + k] = 1.0;
+            for (int j = 0; j < n; ++j) {
+                a[k * n + j] *= inv;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (i == k) {
+                    continue;
+                }
+                const double factor = a[i * n + k];
+                a[i * n + k] = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    a[i * n + j] -= factor * a[k * n + j];
+                }
+            }
+        }
+        // undo the row interchanges on the columns of the inverse
+        std::vector<double> result(n * n);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                result[i * n + perm[j]] = a[i * n + j];
+            }
+        }
+        a = std::move(result);
+        return true;
+    }
+
     Communication* communication_;
     const FineVectorType& weights_;
     const int pressure_var_index_;
+    WellBlocksFunction wellBlocks_;
+    // the first row and the number of segments of every well in the pressure system
+    std::map<std::string, std::pair<int, int>> wellRows_;
     std::shared_ptr<Communication> coarseLevelCommunication_;
     std::shared_ptr<typename CoarseOperator::matrix_type> coarseLevelMatrix_;
+    // not shared between instances, another solver may be set up for the
+    // same fine matrix at the same time
+    CoarseMatrixCache coarseMatrixCache_;
 };
 
 } // namespace Opm
@@ -0,0 +1,306 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RECYCLEDGMRESSOLVER_HEADER_INCLUDED
+#define OPM_RECYCLEDGMRESSOLVER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/PipelinedSolvers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Dune
+{
+
+/// Restarted GMRES augmented with a subspace recycled from earlier solves
+/// (GCRO with a fixed recycle space), right preconditioned.
+///
+/// The solver keeps the total corrections computed by its last few calls
+/// to apply(). At the start of the next solve these span a subspace U,
+/// and C = A U is orthonormalized (updating U accordingly). The initial
+/// residual is projected onto the orthogonal complement of C, and the
+/// GMRES iteration then runs on (I - C C^T) A M^{-1}, so that the Krylov
+/// space does not need to rebuild the directions already found by the
+/// previous solves. For the strongly correlated systems of successive
+/// Newton iterations this removes the slowly converging components that
+/// otherwise dominate the iteration count.
+///
+/// The orthogonalization uses classical Gram-Schmidt with one
+/// reorthogonalization pass, like LowSyncGMResSolver, and orthogonalizes
+/// against C and the Krylov basis in the same reductions.
+template <class X>
+class RecycledGMResSolver : public Details::PipelinedSolverBase<X>
+{
+    using Base = Details::PipelinedSolverBase<X>;
+
+public:
+    RecycledGMResSolver(LinearOperator<X, X>& op,
+                        std::shared_ptr<FusedScalarProducts<X>> sp,
+                        Preconditioner<X, X>& prec,
+                        const double reduction,
+                        const int restart,
+                        const int maxit,
+                        const int recycle,
+                        const int verbose)
+        : Base(op, std::move(sp), prec, reduction, maxit, verbose)
+        , restart_(std::max(restart, 1))
+        , maxRecycle_(std::max(recycle, 0))
+    {
+    }
+
+    using Base::apply;
+
+    virtual void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        auto& sp = *this->sp_;
+        const int m = restart_;
+
+        this->prec_.pre(x, b);
+
+        X r(b), w(b), tmp(b), total(b);
+        total = 0.0;
+
+        // Drop the recycled vectors if the system size changed.
+        if (!recycled_.empty() && recycled_.front().size() != b.size()) {
+            recycled_.clear();
+        }
+        std::vector<X> U(recycled_);
+        std::vector<X> C;
+        setupRecycleSpace(U, C, tmp);
+        const int k = static_cast<int>(C.size());
+
+        std::vector<X> basis(m + 1, b);
+        std::vector<std::vector<double>> H(m + 1, std::vector<double>(m, 0.0));
+        std::vector<std::vector<double>> B(k, std::vector<double>(m, 0.0));
+        std::vector<double> g(m + 1), cs(m), sn(m), dots(k + m + 2);
+
+        double def0 = 0.0;
+        double def = 0.0;
+        bool converged = false;
+        int it = 0;
+        while (true) {
+            r = b;
+            this->op_.applyscaleadd(-1.0, x, r);
+            if (it == 0) {
+                double nrm = sp.local(r, r);
+                sp.sum(&nrm, 1);
+                def0 = std::sqrt(nrm);
+                this->printIteration(0, def0, def0);
+            }
+            // Remove the components in range(C): x += U C^T r, r -= C C^T r.
+            if (k > 0) {
+                for (int i = 0; i < k; ++i) {
+                    dots[i] = sp.local(C[i], r);
+                }
+                sp.sum(dots.data(), k);
+                for (int i = 0; i < k; ++i) {
+                    x.axpy(dots[i], U[i]);
+                    total.axpy(dots[i], U[i]);
+                    r.axpy(-dots[i], C[i]);
+                }
+            }
+            double beta = sp.local(r, r);
+            sp.sum(&beta, 1);
+            beta = std::sqrt(beta);
+            def = beta;
+            if (it == 0 && k > 0) {
+                this->printIteration(0, def, def0);
+            }
+            if (beta == 0.0 || beta < this->reduction_ * def0) {
+                converged = true;
+                break;
+            }
+            if (it >= this->maxit_) {
+                break;
+            }
+
+            basis[0] = r;
+            basis[0] *= 1.0 / beta;
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            int j = 0;
+            for (; j < m && it < this->maxit_; ++j) {
+                ++it;
+                this->applyPreconditionedOperator(basis[j], tmp, w);
+
+                // Two passes of classical Gram-Schmidt against C and the
+                // Krylov basis, the second one also computing |w|^2.
+                for (int i = 0; i < k; ++i) {
+                    B[i][j] = 0.0;
+                }
+                for (int i = 0; i <= j; ++i) {
+                    H[i][j] = 0.0;
+                }
+                double correction2 = 0.0;
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (int i = 0; i < k; ++i) {
+                        dots[i] = sp.local(C[i], w);
+                    }
+                    for (int i = 0; i <= j; ++i) {
+                        dots[k + i] = sp.local(basis[i], w);
+                    }
+                    int n = k + j + 1;
+                    if (pass == 1) {
+                        dots[n++] = sp.local(w, w);
+                    }
+                    sp.sum(dots.data(), n);
+                    correction2 = 0.0;
+                    for (int i = 0; i < k; ++i) {
+                        B[i][j] += dots[i];
+                        w.axpy(-dots[i], C[i]);
+                        correction2 += dots[i] * dots[i];
+                    }
+                    for (int i = 0; i <= j; ++i) {
+                        H[i][j] += dots[k + i];
+                        w.axpy(-dots[k + i], basis[i]);
+                        correction2 += dots[k + i] * dots[k + i];
+                    }
+                }
+                const double hnext = std::sqrt(std::max(dots[k + j + 1] - correction2, 0.0));
+                H[j + 1][j] = hnext;
+
+                for (int i = 0; i < j; ++i) {
+                    const double tmpH = cs[i] * H[i][j] + sn[i] * H[i + 1][j];
+                    H[i + 1][j] = -sn[i] * H[i][j] + cs[i] * H[i + 1][j];
+                    H[i][j] = tmpH;
+                }
+                const double denom = std::hypot(H[j][j], H[j + 1][j]);
+                cs[j] = denom > 0.0 ? H[j][j] / denom : 1.0;
+                sn[j] = denom > 0.0 ? H[j + 1][j] / denom : 0.0;
+                H[j][j] = denom;
+                H[j + 1][j] = 0.0;
+                g[j + 1] = -sn[j] * g[j];
+                g[j] = cs[j] * g[j];
+
+                def = std::abs(g[j + 1]);
+                this->printIteration(it, def, def0);
+                if (def < this->reduction_ * def0 || hnext == 0.0) {
+                    ++j;
+                    converged = def < this->reduction_ * def0;
+                    break;
+                }
+                basis[j + 1] = w;
+                basis[j + 1] *= 1.0 / hnext;
+            }
+
+            // Least squares solution y, then x += M^{-1} V y - U B y.
+            std::vector<double> y(j, 0.0);
+            for (int i = j - 1; i >= 0; --i) {
+                double sum = g[i];
+                for (int l = i + 1; l < j; ++l) {
+                    sum -= H[i][l] * y[l];
+                }
+                y[i] = H[i][i] != 0.0 ? sum / H[i][i] : 0.0;
+            }
+            w = 0.0;
+            for (int i = 0; i < j; ++i) {
+                w.axpy(y[i], basis[i]);
+            }
+            tmp = 0.0;
+            this->prec_.apply(tmp, w);
+            for (int i = 0; i < k; ++i) {
+                double By = 0.0;
+                for (int l = 0; l < j; ++l) {
+                    By += B[i][l] * y[l];
+                }
+                tmp.axpy(-By, U[i]);
+            }
+            x += tmp;
+            total += tmp;
+
+            if (converged || it >= this->maxit_) {
+                break;
+            }
+        }
+
+        this->prec_.post(x);
+        storeCorrection(total, sp);
+        this->finalize(res, it, def0, def, converged, watch, "RecycledGMRes");
+    }
+
+private:
+    /// Compute C = A U and orthonormalize it, applying the same
+    /// transformation to U so that A U = C still holds. Vectors that are
+    /// (numerically) linearly dependent on the previous ones are dropped.
+    void setupRecycleSpace(std::vector<X>& U, std::vector<X>& C, X& tmp)
+    {
+        auto& sp = *this->sp_;
+        std::vector<X> keptU;
+        std::vector<double> dots(U.size() + 1);
+        for (auto& u : U) {
+            tmp = 0.0;
+            this->op_.apply(u, tmp);
+            double orig = sp.local(tmp, tmp);
+            sp.sum(&orig, 1);
+            const int n = static_cast<int>(C.size());
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int i = 0; i < n; ++i) {
+                    dots[i] = sp.local(C[i], tmp);
+                }
+                sp.sum(dots.data(), n);
+                for (int i = 0; i < n; ++i) {
+                    tmp.axpy(-dots[i], C[i]);
+                    u.axpy(-dots[i], keptU[i]);
+                }
+            }
+            double nrm = sp.local(tmp, tmp);
+            sp.sum(&nrm, 1);
+            if (!(nrm > 1e-20 * orig)) {
+                continue;
+            }
+            nrm = 1.0 / std::sqrt(nrm);
+            tmp *= nrm;
+            u *= nrm;
+            C.push_back(tmp);
+            keptU.push_back(u);
+        }
+        U.swap(keptU);
+    }
+
+    /// Remember the total correction of the last solve, keeping at most
+    /// maxRecycle_ of them.
+    void storeCorrection(const X& total, FusedScalarProducts<X>& sp)
+    {
+        if (maxRecycle_ == 0) {
+            return;
+        }
+        double nrm = sp.local(total, total);
+        sp.sum(&nrm, 1);
+        if (nrm == 0.0) {
+            return;
+        }
+        if (static_cast<int>(recycled_.size()) == maxRecycle_) {
+            recycled_.erase(recycled_.begin());
+        }
+        recycled_.push_back(total);
+        recycled_.back() *= 1.0 / std::sqrt(nrm);
+    }
+
+    int restart_;
+    int maxRecycle_;
+    std::vector<X> recycled_;
+};
+
+} // namespace Dune
+
+#endif // OPM_RECYCLEDGMRESSOLVER_HEADER_INCLUDED
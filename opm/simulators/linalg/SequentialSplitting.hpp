@@ -0,0 +1,109 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
+#define OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
+
+#include <cmath>
+#include <cstddef>
+
+namespace Opm
+{
+
+/// Linear systems of the two stages of a sequential implicit Newton
+/// iteration, built from the fully implicit Jacobian J and residual r.
+///
+/// The pressure stage solves the pressure equation, i.e. the sum of the
+/// conservation equations of every cell weighted by the (quasi or true)
+/// IMPES weights w, for the pressure alone. The transport stage solves
+/// the conservation equations for the other primary variables with the
+/// pressure kept fixed. In every cell the equation with the largest
+/// weight, which the pressure stage has already taken care of, is
+/// replaced by the constraint dp = 0.
+namespace SequentialSplitting
+{
+    /// Build the scalar pressure system Ap dp = bp with
+    /// Ap(i, j) = w_i^T J(i, j) e_p and bp(i) = w_i^T r(i).
+    /// The sparsity pattern of Ap is created on the first call and has
+    /// to be the one of J on later calls.
+    template <class Matrix, class Vector, class PressureMatrix, class PressureVector>
+    void assemblePressureSystem(const Matrix& A, const Vector& b, const Vector& weights, const int pressureVarIndex,
+                                PressureMatrix& Ap, PressureVector& bp)
+    {
+        if (Ap.N() != A.N()) {
+            Ap.setSize(A.N(), A.M(), A.nonzeroes());
+            Ap.setBuildMode(PressureMatrix::row_wise);
+            auto rowA = A.begin();
+            for (auto row = Ap.createbegin(); row != Ap.createend(); ++row, ++rowA) {
+                for (auto col = rowA->begin(); col != rowA->end(); ++col) {
+                    row.insert(col.index());
+                }
+            }
+        }
+        bp.resize(A.N());
+
+        const std::size_t numEq = weights[0].size();
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            const auto i = row.index();
+            const auto& w = weights[i];
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                double value = 0.0;
+                for (std::size_t eq = 0; eq < numEq; ++eq) {
+                    value += w[eq] * (*col)[eq][pressureVarIndex];
+                }
+                Ap[i][col.index()] = value;
+            }
+            bp[i] = w * b[i];
+        }
+    }
+
+    /// Turn J x = r into the transport system in place.
+    template <class Matrix, class Vector>
+    void restrictToTransport(Matrix& A, Vector& b, const Vector& weights, const int pressureVarIndex)
+    {
+        const std::size_t numEq = weights[0].size();
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            const auto i = row.index();
+            std::size_t pressureEq = 0;
+            for (std::size_t eq = 1; eq < numEq; ++eq) {
+                if (std::fabs(weights[i][eq]) > std::fabs(weights[i][pressureEq])) {
+                    pressureEq = eq;
+                }
+            }
+
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                auto& block = *col;
+                for (std::size_t eq = 0; eq < numEq; ++eq) {
+                    block[eq][pressureVarIndex] = 0.0;
+                }
+                for (std::size_t var = 0; var < block.M(); ++var) {
+                    block[pressureEq][var] = 0.0;
+                }
+                if (col.index() == i) {
+                    block[pressureEq][pressureVarIndex] = 1.0;
+                }
+            }
+            b[i][pressureEq] = 0.0;
+        }
+    }
+} // namespace SequentialSplitting
+
+} // namespace Opm
+
+#endif // OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
@@ -24,6 +24,10 @@
 
 #include <dune/istl/operators.hh>
 
+#include <opm/simulators/linalg/blockSpMV.hpp>
+#include <opm/simulators/linalg/WellSystemBlocksProvider.hpp>
+#include <opm/simulators/utils/ScopedTimers.hpp>
+
 
 namespace Opm
 {
@@ -46,7 +50,7 @@ namespace Opm
 /// depend on the matrix and vector types involved, which typically are
 /// just one for each block size with block sizes 1-4.
 template <class WellModel, class X, class Y>
-class WellModelAsLinearOperator : public Dune::LinearOperator<X, Y>
+class WellModelAsLinearOperator : public Dune::LinearOperator<X, Y>, public WellSystemBlocksProvider
 {
 public:
     using Base = Dune::LinearOperator<X, Y>;
@@ -80,10 +84,61 @@ public:
     {
         return Dune::SolverCategory::sequential;
     }
+
+    std::vector<Helper::WellSystemBlocks> wellSystemBlocks() const override
+    {
+        return wellMod_.wellSystemBlocks();
+    }
 private:
     const WellModel& wellMod_;
 };
 
+/// Linear operator which adds the contributions of two operators, e.g.
+/// of the wells and of condensed cells, where each of them adds its
+/// contribution to y like the well model does.
+template <class X, class Y>
+class LinearOperatorSum : public Dune::LinearOperator<X, Y>, public WellSystemBlocksProvider
+{
+public:
+    using Base = Dune::LinearOperator<X, Y>;
+    using field_type = typename Base::field_type;
+
+    LinearOperatorSum(const Base& first, const Base& second)
+        : first_(first)
+        , second_(second)
+    {
+    }
+
+    void apply (const X& x, Y& y) const override
+    {
+        first_.apply(x, y);
+        second_.apply(x, y);
+    }
+
+    void applyscaleadd (field_type alpha, const X& x, Y& y) const override
+    {
+        first_.applyscaleadd(alpha, x, y);
+        second_.applyscaleadd(alpha, x, y);
+    }
+
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+
+    std::vector<Helper::WellSystemBlocks> wellSystemBlocks() const override
+    {
+        auto blocks = Opm::wellSystemBlocks(first_);
+        auto secondBlocks = Opm::wellSystemBlocks(second_);
+        blocks.insert(blocks.end(), secondBlocks.begin(), secondBlocks.end());
+        return blocks;
+    }
+
+private:
+    const Base& first_;
+    const Base& second_;
+};
+
 /*!
    \brief Adapter to combine a matrix and another linear operator into
    a combined linear operator.
@@ -94,9 +149,13 @@ private:
    and W to the input vector. In addition this is a parallel-aware
    adapter, that does not require the W operator to be parallel, but
    makes it into one by making the proper projections.
+
+   If a separate preconditioner matrix P is given, e.g. A plus an
+   approximation of W, getmat() returns P, from which the
+   preconditioners are built, while apply() still uses A and W.
  */
 template<class M, class X, class Y, bool overlapping >
-class WellModelMatrixAdapter : public Dune::AssembledLinearOperator<M,X,Y>
+class WellModelMatrixAdapter : public Dune::AssembledLinearOperator<M,X,Y>, public WellSystemBlocksProvider
 {
 public:
   typedef M matrix_type;
@@ -120,16 +179,30 @@ public:
   WellModelMatrixAdapter (const M& A,
                           const Dune::LinearOperator<X, Y>& wellOper,
                           const std::shared_ptr< communication_type >& comm = std::shared_ptr< communication_type >())
-      : A_( A ), wellOper_( wellOper ), comm_(comm)
+      : A_( A ), P_( A ), wellOper_( wellOper ), comm_(comm)
+  {}
+
+  //! constructor: store references to the matrix and the preconditioner matrix
+  WellModelMatrixAdapter (const M& A,
+                          const M& preconditionerMatrix,
+                          const Dune::LinearOperator<X, Y>& wellOper,
+                          const std::shared_ptr< communication_type >& comm = std::shared_ptr< communication_type >())
+      : A_( A ), P_( preconditionerMatrix ), wellOper_( wellOper ), comm_(comm)
   {}
 
 
   virtual void apply( const X& x, Y& y ) const override
   {
-    A_.mv( x, y );
+    {
+      KernelTimer spmvTimer("spmv");
+      blockSpMV(A_, x, y, A_.N());
+    }
 
     // add well model modification to y
-    wellOper_.apply(x, y );
+    {
+      KernelTimer wellTimer("well apply");
+      wellOper_.apply(x, y );
+    }
 
 #if HAVE_MPI
     if( comm_ )
@@ -140,10 +213,16 @@ public:
   // y += \alpha * A * x
   virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const override
   {
-    A_.usmv(alpha,x,y);
+    {
+      KernelTimer spmvTimer("spmv");
+      blockSpMVScaleAdd(alpha, A_, x, y, A_.N());
+    }
 
     // add scaled well model modification to y
-    wellOper_.applyscaleadd( alpha, x, y );
+    {
+      KernelTimer wellTimer("well apply");
+      wellOper_.applyscaleadd( alpha, x, y );
+    }
 
 #if HAVE_MPI
     if( comm_ )
@@ -151,10 +230,16 @@ public:
 #endif
   }
 
-  virtual const matrix_type& getmat() const override { return A_; }
+  virtual const matrix_type& getmat() const override { return P_; }
+
+  std::vector<Helper::WellSystemBlocks> wellSystemBlocks() const override
+  {
+    return Opm::wellSystemBlocks(wellOper_);
+  }
 
 protected:
   const matrix_type& A_ ;
+  const matrix_type& P_ ;
   const Dune::LinearOperator<X, Y>& wellOper_;
   std::shared_ptr< communication_type > comm_;
 };
@@ -199,16 +284,16 @@ public:
 
     virtual void apply( const X& x, Y& y ) const override
     {
-        for (auto row = A_.begin(); row.index() < interiorSize_; ++row)
         {
-            y[row.index()]=0;
-            auto endc = (*row).end();
-            for (auto col = (*row).begin(); col != endc; ++col)
-                (*col).umv(x[col.index()], y[row.index()]);
+            KernelTimer spmvTimer("spmv");
+            blockSpMV(A_, x, y, interiorSize_);
         }
 
         // add well model modification to y
-        wellOper_.apply(x, y );
+        {
+            KernelTimer wellTimer("well apply");
+            wellOper_.apply(x, y );
+        }
 
         ghostLastProject( y );
     }
@@ -216,14 +301,15 @@ public:
     // y += \alpha * A * x
     virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const override
     {
-        for (auto row = A_.begin(); row.index() < interiorSize_; ++row)
         {
-            auto endc = (*row).end();
-            for (auto col = (*row).begin(); col != endc; ++col)
-                (*col).usmv(alpha, x[col.index()], y[row.index()]);
+            KernelTimer spmvTimer("spmv");
+            blockSpMVScaleAdd(alpha, A_, x, y, interiorSize_);
         }
         // add scaled well model modification to y
-        wellOper_.applyscaleadd( alpha, x, y );
+        {
+            KernelTimer wellTimer("well apply");
+            wellOper_.applyscaleadd( alpha, x, y );
+        }
 
         ghostLastProject( y );
     }
@@ -0,0 +1,53 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLSYSTEMBLOCKSPROVIDER_HEADER_INCLUDED
+#define OPM_WELLSYSTEMBLOCKSPROVIDER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+
+#include <vector>
+
+namespace Opm
+{
+
+/// Interface of the linear operators which apply wells that are not part
+/// of the matrix and can provide the blocks of their equations, e.g. for
+/// the well-aware CPR preconditioner.
+class WellSystemBlocksProvider
+{
+public:
+    virtual ~WellSystemBlocksProvider() = default;
+
+    /// The blocks of the equations of the wells applied by the operator.
+    virtual std::vector<Helper::WellSystemBlocks> wellSystemBlocks() const = 0;
+};
+
+/// The blocks of the wells applied by an operator, none unless it is a
+/// WellSystemBlocksProvider.
+template <class Operator>
+std::vector<Helper::WellSystemBlocks> wellSystemBlocks(const Operator& op)
+{
+    const auto* provider = dynamic_cast<const WellSystemBlocksProvider*>(&op);
+    return provider ? provider->wellSystemBlocks() : std::vector<Helper::WellSystemBlocks>();
+}
+
+} // namespace Opm
+
+#endif // OPM_WELLSYSTEMBLOCKSPROVIDER_HEADER_INCLUDED
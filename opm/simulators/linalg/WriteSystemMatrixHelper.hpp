@@ -21,18 +21,23 @@
 #define OPM_WRITESYSTEMMATRIXHELPER_HEADER_INCLUDED
 
 #include <dune/istl/matrixmarket.hh>
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
 #include <opm/simulators/linalg/MatrixMarketSpecializations.hpp>
 
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
 
 namespace Opm
 {
 namespace Helper
 {
-    template <class SimulatorType, class MatrixType, class VectorType, class Communicator>
-    void writeSystem(const SimulatorType& simulator,
-                     const MatrixType& matrix,
-                     const VectorType& rhs,
-                     [[maybe_unused]] const Communicator* comm)
+    /// The path of the dumped systems of the current Newton iteration, in
+    /// the reports subdirectory of the output directory.
+    template <class SimulatorType>
+    std::string systemFilePrefix(const SimulatorType& simulator)
     {
         std::string dir = simulator.problem().outputDir();
         if (dir == ".") {
@@ -55,7 +60,16 @@ namespace Helper
         oss << "_nit_" << nit << "_";
         std::string output_file(oss.str());
         fs::path full_path = output_dir / output_file;
-        std::string prefix = full_path.string();
+        return full_path.string();
+    }
+
+    template <class SimulatorType, class MatrixType, class VectorType, class Communicator>
+    void writeSystem(const SimulatorType& simulator,
+                     const MatrixType& matrix,
+                     const VectorType& rhs,
+                     [[maybe_unused]] const Communicator* comm)
+    {
+        const std::string prefix = systemFilePrefix(simulator);
         {
             std::string filename = prefix + "matrix_istl";
 #if HAVE_MPI
@@ -80,6 +94,33 @@ namespace Helper
         }
     }
 
+    /// Write the system of this process, together with the overlap rows and
+    /// the matrices of the wells, to <prefix>system_<rank>.bin in the
+    /// format of writeBinarySystem().
+    template <class SimulatorType, class MatrixType, class VectorType>
+    void writeBinarySystem(const SimulatorType& simulator,
+                           const MatrixType& matrix,
+                           const VectorType& rhs,
+                           const std::vector<int>& overlapRows,
+                           std::vector<WellSystemBlocks> wells)
+    {
+        BinarySystem system;
+        system.matrix = SparseBlockMatrix::from(matrix);
+        system.rhs.reserve(rhs.dim());
+        for (const auto& block : rhs) {
+            system.rhs.insert(system.rhs.end(), block.begin(), block.end());
+        }
+        system.ghostRows.assign(matrix.N(), 0);
+        for (const int row : overlapRows) {
+            system.ghostRows[row] = 1;
+        }
+        system.wells = std::move(wells);
+
+        const int rank = simulator.gridView().comm().rank();
+        const std::string filename = systemFilePrefix(simulator) + "system_" + std::to_string(rank) + ".bin";
+        std::ofstream file(filename, std::ios::binary);
+        writeBinarySystem(file, system);
+    }
 
 } // namespace Helper
 } // namespace Opm
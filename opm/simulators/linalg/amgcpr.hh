@@ -20,7 +20,9 @@
 #include <dune/common/typetraits.hh>
 #include <dune/common/exceptions.hh>
 
+#include <cassert>
 #include <memory>
+#include <vector>
 
 namespace Dune
 {
@@ -46,6 +48,61 @@ namespace Dune
   }
 #endif
 
+  /**
+   * @brief Galerkin product for piecewise constant prolongation,
+   * parallelized over the coarse rows.
+   *
+   * Computes the same coarse matrix as BaseGalerkinProduct::calculate().
+   * The fine rows are first grouped by aggregate, such that each coarse
+   * row is only written by one thread.
+   */
+  template<class M, class V, class I>
+  void calculateGalerkinProductThreaded(const M& fine, const AggregatesMap<V>& aggregates,
+                                        M& coarse, const I& pinfo)
+  {
+    coarse = static_cast<typename M::field_type>(0);
+
+    const std::size_t noCoarse = coarse.N();
+    std::vector<std::size_t> start(noCoarse + 1, 0);
+    for (std::size_t i = 0; i < fine.N(); ++i)
+      if (aggregates[i] != AggregatesMap<V>::ISOLATED) {
+        assert(aggregates[i] != AggregatesMap<V>::UNAGGREGATED);
+        ++start[aggregates[i] + 1];
+      }
+    for (std::size_t c = 0; c < noCoarse; ++c)
+      start[c + 1] += start[c];
+    std::vector<std::size_t> fineRows(start[noCoarse]);
+    {
+      std::vector<std::size_t> next(start.begin(), start.end() - 1);
+      for (std::size_t i = 0; i < fine.N(); ++i)
+        if (aggregates[i] != AggregatesMap<V>::ISOLATED)
+          fineRows[next[aggregates[i]]++] = i;
+    }
+
+    const long long noCoarseRows = static_cast<long long>(noCoarse);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long long c = 0; c < noCoarseRows; ++c) {
+      auto& coarseRow = coarse[c];
+      for (std::size_t k = start[c]; k < start[c + 1]; ++k) {
+        const auto& row = fine[fineRows[k]];
+        for (auto col = row.begin(), endCol = row.end(); col != endCol; ++col)
+          if (aggregates[col.index()] != AggregatesMap<V>::ISOLATED)
+            coarseRow[aggregates[col.index()]] += *col;
+      }
+    }
+
+    // get the right diagonal matrix values on copy lines from owner processes
+    using BlockType = typename M::block_type;
+    std::vector<BlockType> diagonal(noCoarse, BlockType(0));
+    for (std::size_t c = 0; c < noCoarse; ++c)
+      diagonal[c] = coarse[c][c];
+    pinfo.copyOwnerToAll(diagonal, diagonal);
+    for (std::size_t c = 0; c < noCoarse; ++c)
+      coarse[c][c] = diagonal[c];
+  }
+
     /**
      * @defgroup ISTL_PAAMG Parallel Algebraic Multigrid
      * @ingroup ISTL_Prec
@@ -190,12 +247,10 @@ namespace Dune
        */
       void recalculateHierarchy()
       {
-        auto copyFlags = NegateSet<typename PI::OwnerSet>();
         const auto& matrices =  matrices_->matrices();
         const auto& aggregatesMapHierarchy = matrices_->aggregatesMaps();
         const auto& infoHierarchy = matrices_->parallelInformation();
         const auto& redistInfoHierarchy = matrices_->redistributeInformation();
-        BaseGalerkinProduct productBuilder;
         auto aggregatesMap = aggregatesMapHierarchy.begin();
         auto info = infoHierarchy.finest();
         auto redistInfo = redistInfoHierarchy.begin();
@@ -218,7 +273,7 @@ namespace Dune
           ++matrix;
           ++info;
           ++redistInfo;
-          productBuilder.calculate(fine, *(*aggregatesMap), const_cast<Matrix&>(matrix->getmat()), *info, copyFlags);
+          calculateGalerkinProductThreaded(fine, *(*aggregatesMap), const_cast<Matrix&>(matrix->getmat()), *info);
 #if HAVE_MPI
           if(matrix.isRedistributed()) {
             redistributeMatrixAmg(const_cast<Matrix&>(matrix->getmat()),
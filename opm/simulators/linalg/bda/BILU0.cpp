@@ -19,6 +19,8 @@
 
 #include <config.h>
 
+#include <algorithm>
+
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/simulators/linalg/MatrixBlock.hpp>
@@ -37,9 +39,21 @@ using Opm::OpmLog;
 using Dune::Timer;
 
 template <unsigned int block_size>
-BILU0<block_size>::BILU0(ILUReorder opencl_ilu_reorder_, int verbosity_) :
-    verbosity(verbosity_), opencl_ilu_reorder(opencl_ilu_reorder_)
-{}
+BILU0<block_size>::BILU0(ILUReorder opencl_ilu_reorder_, int verbosity_, int ilu_fill_level_, double ilu_relaxation_) :
+    verbosity(verbosity_), opencl_ilu_reorder(opencl_ilu_reorder_), ilu_fill_level(ilu_fill_level_), ilu_relaxation(ilu_relaxation_)
+{
+#if CHOW_PATEL
+    if (ilu_fill_level > 0) {
+        OPM_THROW(std::logic_error, "Error BILU0 with fill-in is not supported with CHOW_PATEL");
+    }
+#endif
+}
+
+template <unsigned int block_size>
+void BILU0<block_size>::setReorderCache(std::shared_ptr<ReorderCache> cache)
+{
+    reorder_cache = cache;
+}
 
 template <unsigned int block_size>
 BILU0<block_size>::~BILU0()
@@ -57,36 +71,100 @@ BILU0<block_size>::~BILU0()
         this->nnz = mat->nnzbs * block_size * block_size;
         this->nnzbs = mat->nnzbs;
 
-        int *CSCRowIndices = nullptr;
-        int *CSCColPointers = nullptr;
+        // with fill-in, the reordering must be valid for the ILU(k) pattern instead of the pattern of the matrix
+        std::vector<int> fillRowPointers, fillColIndices;
+        int *patternRows = mat->rowPointers;
+        int *patternCols = mat->colIndices;
+        int patternNnzbs = nnzbs;
+        if (ilu_fill_level > 0) {
+            Timer t_fill;
+            findIlukPattern(Nb, mat->rowPointers, mat->colIndices, ilu_fill_level, fillRowPointers, fillColIndices);
+            patternRows = fillRowPointers.data();
+            patternCols = fillColIndices.data();
+            patternNnzbs = fillColIndices.size();
+            if (verbosity >= 1) {
+                std::ostringstream out;
+                out << "BILU0 ILU(" << ilu_fill_level << ") pattern has " << patternNnzbs << " blocks instead of " << nnzbs << ", found in: " << t_fill.stop() << " s";
+                OpmLog::info(out.str());
+            }
+        }
+
+        std::vector<int> CSCRowIndices;
+        std::vector<int> CSCColPointers;
+        // a reordering of the same pattern, or of one where only a few rows differ, can be reused
+        const ReorderCache::Entry *cached = nullptr;
+        const ReorderCache::Entry *similar = nullptr;
 
         if (opencl_ilu_reorder == ILUReorder::NONE) {
-            LUmat = std::make_unique<BlockedMatrix<block_size> >(*mat);
+            if (ilu_fill_level > 0) {
+                LUmat = std::make_unique<BlockedMatrix<block_size> >(Nb, patternNnzbs);
+                std::copy(patternRows, patternRows + Nb + 1, LUmat->rowPointers);
+                std::copy(patternCols, patternCols + patternNnzbs, LUmat->colIndices);
+            } else {
+                LUmat = std::make_unique<BlockedMatrix<block_size> >(*mat);
+            }
         } else {
             toOrder.resize(Nb);
             fromOrder.resize(Nb);
-            CSCRowIndices = new int[nnzbs];
-            CSCColPointers = new int[Nb + 1];
             rmat = std::make_shared<BlockedMatrix<block_size> >(mat->Nb, mat->nnzbs);
-            LUmat = std::make_unique<BlockedMatrix<block_size> >(*rmat);
+            if (ilu_fill_level > 0) {
+                LUmat = std::make_unique<BlockedMatrix<block_size> >(Nb, patternNnzbs);
+            } else {
+                LUmat = std::make_unique<BlockedMatrix<block_size> >(*rmat);
+            }
 
-            Timer t_convert;
-            csrPatternToCsc(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb);
-            if(verbosity >= 3){
-                std::ostringstream out;
-                out << "BILU0 convert CSR to CSC: " << t_convert.stop() << " s";
-                OpmLog::info(out.str());
+            if (reorder_cache) {
+                cached = reorder_cache->find(Nb, mat->rowPointers, mat->colIndices);
+                if (!cached && opencl_ilu_reorder == ILUReorder::GRAPH_COLORING) {
+                    similar = reorder_cache->findSimilar(Nb, mat->rowPointers, mat->colIndices, max_changed_rows);
+                }
+            }
+
+            if (!cached) {
+                CSCRowIndices.resize(patternNnzbs);
+                CSCColPointers.resize(Nb + 1);
+                Timer t_convert;
+                csrPatternToCsc(patternCols, patternRows, CSCRowIndices.data(), CSCColPointers.data(), mat->Nb);
+                if(verbosity >= 3){
+                    std::ostringstream out;
+                    out << "BILU0 convert CSR to CSC: " << t_convert.stop() << " s";
+                    OpmLog::info(out.str());
+                }
             }
         }
 
         Timer t_analysis;
         std::ostringstream out;
-        if (opencl_ilu_reorder == ILUReorder::LEVEL_SCHEDULING) {
+        if (cached) {
+            out << "BILU0 reordering strategy: " << (opencl_ilu_reorder == ILUReorder::LEVEL_SCHEDULING ? "level_scheduling" : "graph_coloring") << ", reused for a known sparsity pattern\n";
+            toOrder = cached->toOrder;
+            fromOrder = cached->fromOrder;
+            rowsPerColor = cached->rowsPerColor;
+            numColors = cached->numColors;
+        } else if (opencl_ilu_reorder == ILUReorder::LEVEL_SCHEDULING) {
             out << "BILU0 reordering strategy: " << "level_scheduling\n";
-            findLevelScheduling(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
+            findLevelScheduling(patternCols, patternRows, CSCRowIndices.data(), CSCColPointers.data(), mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
         } else if (opencl_ilu_reorder == ILUReorder::GRAPH_COLORING) {
-            out << "BILU0 reordering strategy: " << "graph_coloring\n";
-            findGraphColoring<block_size>(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb, mat->Nb, mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
+            numColors = -1;
+            if (similar) {
+                // recover the colors of the similar pattern from its reordering
+                std::vector<int> colors(Nb);
+                for (int c = 0, row = 0; c < similar->numColors; ++c) {
+                    for (int k = 0; k < similar->rowsPerColor[c]; ++k, ++row) {
+                        colors[similar->fromOrder[row]] = c;
+                    }
+                }
+                numColors = updateGraphColoring(Nb, patternRows, patternCols, CSCColPointers.data(), CSCRowIndices.data(), colors);
+                if (numColors > 0) {
+                    out << "BILU0 reordering strategy: " << "graph_coloring, updated from a similar sparsity pattern\n";
+                    rowsPerColor.assign(numColors, 0);
+                    colorsToReordering(Nb, colors, numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
+                }
+            }
+            if (numColors < 0) {
+                out << "BILU0 reordering strategy: " << "graph_coloring\n";
+                findGraphColoring<block_size>(patternCols, patternRows, CSCRowIndices.data(), CSCColPointers.data(), mat->Nb, mat->Nb, mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
+            }
         } else if (opencl_ilu_reorder == ILUReorder::NONE) {
             out << "BILU0 reordering strategy: none\n";
             // numColors = 1;
@@ -100,16 +178,32 @@ BILU0<block_size>::~BILU0()
         }
         if(verbosity >= 1){
             out << "BILU0 analysis took: " << t_analysis.stop() << " s, " << numColors << " colors\n";
+            if (ilu_relaxation != 0.0) {
+                out << "BILU0 relaxation: " << ilu_relaxation << "\n";
+            }
         }
 #if CHOW_PATEL
         out << "BILU0 CHOW_PATEL: " << CHOW_PATEL << ", CHOW_PATEL_GPU: " << CHOW_PATEL_GPU;
 #endif
         OpmLog::info(out.str());
 
+        if (reorder_cache && opencl_ilu_reorder != ILUReorder::NONE && !cached) {
+            ReorderCache::Entry entry;
+            entry.hash = hashPattern(Nb, mat->rowPointers, mat->colIndices);
+            entry.rowPointers.assign(mat->rowPointers, mat->rowPointers + Nb + 1);
+            entry.colIndices.assign(mat->colIndices, mat->colIndices + nnzbs);
+            entry.toOrder = toOrder;
+            entry.fromOrder = fromOrder;
+            entry.rowsPerColor = rowsPerColor;
+            entry.numColors = numColors;
+            reorder_cache->insert(std::move(entry));
+        }
 
-        if (opencl_ilu_reorder != ILUReorder::NONE) {
-            delete[] CSCRowIndices;
-            delete[] CSCColPointers;
+        // the ILU(k) pattern is reordered like the matrix, the values of LUmat are set in create_preconditioner()
+        if (ilu_fill_level > 0 && opencl_ilu_reorder != ILUReorder::NONE) {
+            std::vector<double> zeros(static_cast<size_t>(patternNnzbs) * bs * bs, 0.0);
+            BlockedMatrix<block_size> fillMat(Nb, patternNnzbs, zeros.data(), patternCols, patternRows);
+            reorderBlockedMatrixByPattern<block_size>(&fillMat, toOrder.data(), fromOrder.data(), LUmat.get());
         }
 
         diagIndex.resize(mat->Nb);
@@ -120,8 +214,6 @@ BILU0<block_size>::~BILU0()
         Umat = std::make_unique<BlockedMatrix<block_size> >(mat->Nb, (mat->nnzbs - mat->Nb) / 2);
 #endif
 
-        LUmat->nnzValues = new double[mat->nnzbs * bs * bs];
-
         s.invDiagVals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * mat->Nb);
         s.rowsPerColor = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (numColors + 1));
         s.diagIndex = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * LUmat->Nb);
@@ -524,7 +616,27 @@ BILU0<block_size>::~BILU0()
         // TODO: remove this copy by replacing inplace ilu decomp by out-of-place ilu decomp
         // this copy can have mat or rmat ->nnzValues as origin, depending on the reorder strategy
         Timer t_copy;
-        memcpy(LUmat->nnzValues, m->nnzValues, sizeof(double) * bs * bs * m->nnzbs);
+        if (ilu_fill_level > 0) {
+            // the pattern of m is a subset of the ILU(k) pattern, the fill-in starts at zero
+            if (LUindex.empty()) {
+                LUindex.resize(m->nnzbs);
+                for (int row = 0; row < Nb; ++row) {
+                    int lu = LUmat->rowPointers[row];
+                    for (int k = m->rowPointers[row]; k < m->rowPointers[row + 1]; ++k) {
+                        while (LUmat->colIndices[lu] != m->colIndices[k]) {
+                            ++lu;
+                        }
+                        LUindex[k] = lu;
+                    }
+                }
+            }
+            std::fill(LUmat->nnzValues, LUmat->nnzValues + LUmat->nnzbs * bs * bs, 0.0);
+            for (int k = 0; k < m->nnzbs; ++k) {
+                memcpy(LUmat->nnzValues + LUindex[k] * bs * bs, m->nnzValues + k * bs * bs, sizeof(double) * bs * bs);
+            }
+        } else {
+            memcpy(LUmat->nnzValues, m->nnzValues, sizeof(double) * bs * bs * m->nnzbs);
+        }
 
         if (verbosity >= 3){
             std::ostringstream out;
@@ -584,7 +696,7 @@ BILU0<block_size>::~BILU0()
             if (verbosity >= 4) {
                 out << "color " << color << ": " << firstRow << " - " << lastRow << " = " << lastRow - firstRow << "\n";
             }
-            event = (*ilu_decomp_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items2), cl::NDRange(work_group_size2)), firstRow, lastRow, s.LUvals, s.LUcols, s.LUrows, s.invDiagVals, s.diagIndex, LUmat->Nb, cl::Local(lmem_per_work_group2));
+            event = (*ilu_decomp_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items2), cl::NDRange(work_group_size2)), firstRow, lastRow, s.LUvals, s.LUcols, s.LUrows, s.invDiagVals, s.diagIndex, LUmat->Nb, ilu_relaxation, cl::Local(lmem_per_work_group2));
             event.wait();
         }
 
@@ -651,7 +763,7 @@ template <unsigned int block_size>
 void BILU0<block_size>::setKernels(
     cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *ILU_apply1_,
     cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *ILU_apply2_,
-    cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, cl::LocalSpaceArg> *ilu_decomp_k_
+    cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, const double, cl::LocalSpaceArg> *ilu_decomp_k_
 ){
     this->ILU_apply1 = ILU_apply1_;
     this->ILU_apply2 = ILU_apply2_;
@@ -660,7 +772,7 @@ void BILU0<block_size>::setKernels(
 
 
 #define INSTANTIATE_BDA_FUNCTIONS(n)                                                     \
-template BILU0<n>::BILU0(ILUReorder, int);                                               \
+template BILU0<n>::BILU0(ILUReorder, int, int, double);                                  \
 template BILU0<n>::~BILU0();                                                             \
 template bool BILU0<n>::init(BlockedMatrix<n>*);                                         \
 template void BILU0<n>::chow_patel_decomposition();                                      \
@@ -669,10 +781,11 @@ template void BILU0<n>::apply(cl::Buffer& x, cl::Buffer& y);
 template void BILU0<n>::setOpenCLContext(cl::Context*);                                  \
 template void BILU0<n>::setOpenCLQueue(cl::CommandQueue*);                               \
 template void BILU0<n>::setKernelParameters(unsigned int, unsigned int, unsigned int);   \
+template void BILU0<n>::setReorderCache(std::shared_ptr<ReorderCache>);                   \
 template void BILU0<n>::setKernels(                                                      \
     cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *, \
     cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *, \
-    cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, cl::LocalSpaceArg> *                 \
+    cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, const double, cl::LocalSpaceArg> *                 \
     );
 
 INSTANTIATE_BDA_FUNCTIONS(1);
@@ -24,6 +24,7 @@
 
 #include <opm/simulators/linalg/bda/BlockedMatrix.hpp>
 #include <opm/simulators/linalg/bda/ILUReorder.hpp>
+#include <opm/simulators/linalg/bda/Reorder.hpp>
 
 #include <opm/simulators/linalg/bda/opencl.hpp>
 #include <opm/simulators/linalg/bda/openclKernels.hpp>
@@ -70,6 +71,13 @@ namespace bda
         std::once_flag pattern_uploaded;
 
         ILUReorder opencl_ilu_reorder;
+        int ilu_fill_level;             // k of ILU(k), with fill-in LUmat has a larger pattern than the matrix
+        double ilu_relaxation;          // fraction of the dropped fill-in that is added to the diagonal
+        std::vector<int> LUindex;       // with fill-in, the position in LUmat of every block of the (reordered) matrix
+        std::shared_ptr<ReorderCache> reorder_cache;   // shared with the solver, survives a new analysis
+
+        // a graph coloring is repaired instead of recomputed if at most this fraction of the rows changed
+        static constexpr double max_changed_rows = 0.1;
 
         typedef struct {
             cl::Buffer invDiagVals;
@@ -87,7 +95,7 @@ namespace bda
         ilu_apply2_kernel_type *ILU_apply2;
         cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&,
                                         cl::Buffer&, cl::Buffer&,
-                                        const int, cl::LocalSpaceArg> *ilu_decomp_k;
+                                        const int, const double, cl::LocalSpaceArg> *ilu_decomp_k;
 
         GPU_storage s;
         cl::Context *context;
@@ -104,7 +112,12 @@ namespace bda
 
     public:
 
-        BILU0(ILUReorder opencl_ilu_reorder, int verbosity);
+        /// Create a BILU0 preconditioner
+        /// \param[in] opencl_ilu_reorder   reordering strategy
+        /// \param[in] verbosity            verbosity level
+        /// \param[in] ilu_fill_level       level of fill-in, 0 gives the regular ILU0
+        /// \param[in] ilu_relaxation       fraction of the dropped fill-in that is added to the diagonal, 0 gives the regular ILU
+        BILU0(ILUReorder opencl_ilu_reorder, int verbosity, int ilu_fill_level, double ilu_relaxation);
 
         ~BILU0();
 
@@ -120,10 +133,14 @@ namespace bda
         void setOpenCLContext(cl::Context *context);
         void setOpenCLQueue(cl::CommandQueue *queue);
         void setKernelParameters(const unsigned int work_group_size, const unsigned int total_work_items, const unsigned int lmem_per_work_group);
+
+        /// Use a cache for the reorderings, so a sparsity pattern that was analysed before is not analysed again
+        void setReorderCache(std::shared_ptr<ReorderCache> cache);
+
         void setKernels(
             cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *ILU_apply1,
             cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg> *ILU_apply2,
-            cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, cl::LocalSpaceArg> *ilu_decomp_k
+            cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, const double, cl::LocalSpaceArg> *ilu_decomp_k
             );
 
         int* getToOrder()
@@ -38,6 +38,10 @@
 #include <opm/simulators/linalg/bda/FPGASolverBackend.hpp>
 #endif
 
+#if HAVE_ROCSPARSE
+#include <opm/simulators/linalg/bda/rocsparseSolverBackend.hpp>
+#endif
+
 
 #define PRINT_TIMERS_BRIDGE 0
 
@@ -58,9 +62,26 @@ BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string acceler
                                                              double tolerance,
                                                              [[maybe_unused]] unsigned int platformID,
                                                              unsigned int deviceID,
-                                                             [[maybe_unused]] std::string opencl_ilu_reorder)
+                                                             [[maybe_unused]] std::string opencl_ilu_reorder,
+                                                             std::string opencl_preconditioner,
+                                                             int opencl_ilu_fillin_level,
+                                                             double opencl_ilu_relaxation,
+                                                             [[maybe_unused]] std::string opencl_kernel_cache_dir)
 : accelerator_mode(accelerator_mode_)
 {
+    if (opencl_preconditioner != "bilu0" && opencl_preconditioner != "cpr") {
+        OPM_THROW(std::logic_error, "Error invalid argument for --opencl-preconditioner, usage: '--opencl-preconditioner=[bilu0|cpr]'");
+    }
+    if (opencl_preconditioner == "cpr" && accelerator_mode.compare("opencl") != 0 && accelerator_mode.compare("none") != 0) {
+        OPM_THROW(std::logic_error, "Error the CPR preconditioner is only available for openclSolver, use '--accelerator-mode=opencl'");
+    }
+    if (opencl_ilu_fillin_level < 0) {
+        OPM_THROW(std::logic_error, "Error invalid argument for --opencl-ilu-fillin-level, it cannot be negative");
+    }
+    if ((opencl_ilu_fillin_level > 0 || opencl_ilu_relaxation != 0.0) && accelerator_mode.compare("opencl") != 0 && accelerator_mode.compare("none") != 0) {
+        OPM_THROW(std::logic_error, "Error ILU fill-in and relaxation are only available for openclSolver, use '--accelerator-mode=opencl'");
+    }
+
     if (accelerator_mode.compare("cusparse") == 0) {
 #if HAVE_CUDA
         use_gpu = true;
@@ -83,7 +104,7 @@ BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string acceler
         } else {
             OPM_THROW(std::logic_error, "Error invalid argument for --opencl-ilu-reorder, usage: '--opencl-ilu-reorder=[level_scheduling|graph_coloring]'");
         }
-        backend.reset(new bda::openclSolverBackend<block_size>(linear_solver_verbosity, maxit, tolerance, platformID, deviceID, ilu_reorder));
+        backend.reset(new bda::openclSolverBackend<block_size>(linear_solver_verbosity, maxit, tolerance, platformID, deviceID, ilu_reorder, opencl_preconditioner == "cpr", opencl_ilu_fillin_level, opencl_ilu_relaxation, opencl_kernel_cache_dir));
 #else
         OPM_THROW(std::logic_error, "Error openclSolver was chosen, but OpenCL was not found by CMake");
 #endif
@@ -103,12 +124,19 @@ BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string acceler
         backend.reset(new bda::FpgaSolverBackend<block_size>(fpga_bitstream, linear_solver_verbosity, maxit, tolerance, ilu_reorder));
 #else
         OPM_THROW(std::logic_error, "Error fpgaSolver was chosen, but FPGA was not enabled by CMake");
+#endif
+    } else if (accelerator_mode.compare("rocsparse") == 0) {
+#if HAVE_ROCSPARSE
+        use_gpu = true;
+        backend.reset(new bda::rocsparseSolverBackend<block_size>(linear_solver_verbosity, maxit, tolerance, deviceID));
+#else
+        OPM_THROW(std::logic_error, "Error rocsparseSolver was chosen, but rocsparse was not found by CMake");
 #endif
     } else if (accelerator_mode.compare("none") == 0) {
         use_gpu = false;
         use_fpga = false;
     } else {
-        OPM_THROW(std::logic_error, "Error unknown value for parameter 'AcceleratorMode', should be passed like '--accelerator-mode=[none|cusparse|opencl|fpga]");
+        OPM_THROW(std::logic_error, "Error unknown value for parameter 'AcceleratorMode', should be passed like '--accelerator-mode=[none|cusparse|opencl|fpga|rocsparse]");
     }
 }
 
@@ -153,47 +181,17 @@ int checkZeroDiagonal(BridgeMatrix& mat) {
 }
 
 
-// iterate sparsity pattern from Matrix and put colIndices and rowPointers in arrays
-// sparsity pattern should stay the same
-// this could be removed if Dune::BCRSMatrix features an API call that returns colIndices and rowPointers
-template <class BridgeMatrix>
-void getSparsityPattern(BridgeMatrix& mat, std::vector<int> &h_rows, std::vector<int> &h_cols) {
-    int sum_nnzs = 0;
-
-    // convert colIndices and rowPointers
-    if (h_rows.size() == 0) {
-        h_rows.emplace_back(0);
-            for (typename BridgeMatrix::const_iterator r = mat.begin(); r != mat.end(); ++r) {
-                int size_row = 0;
-                for (auto c = r->begin(); c != r->end(); ++c) {
-                    h_cols.emplace_back(c.index());
-                    size_row++;
-                }
-                sum_nnzs += size_row;
-                h_rows.emplace_back(sum_nnzs);
-            }
-
-        // h_rows and h_cols could be changed to 'unsigned int', but cusparse expects 'int'
-        if (static_cast<unsigned int>(h_rows[mat.N()]) != mat.nonzeroes()) {
-            OPM_THROW(std::logic_error, "Error size of rows do not sum to number of nonzeroes in BdaBridge::getSparsityPattern()");
-        }
-    }
-} // end getSparsityPattern()
-
-
 template <class BridgeMatrix, class BridgeVector, int block_size>
-void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_UNUSED, WellContributions& wellContribs OPM_UNUSED, InverseOperatorResult &res OPM_UNUSED)
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatrix *mat OPM_UNUSED, const LinearSystemView<BridgeMatrix, BridgeVector>& systemView OPM_UNUSED, WellContributions& wellContribs OPM_UNUSED, InverseOperatorResult &res OPM_UNUSED)
 {
 
     if (use_gpu || use_fpga) {
         BdaResult result;
         result.converged = false;
-        static std::vector<int> h_rows;
-        static std::vector<int> h_cols;
         const int dim = (*mat)[0][0].N();
         const int Nb = mat->N();
         const int N = Nb * dim;
-        const int nnzb = (h_rows.empty()) ? mat->nonzeroes() : h_rows.back();
+        const int nnzb = mat->nonzeroes();
         const int nnz = nnzb * dim * dim;
 
         if (dim != 3) {
@@ -202,20 +200,6 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
             return;
         }
 
-        if (h_rows.capacity() == 0) {
-            h_rows.reserve(Nb+1);
-            h_cols.reserve(nnzb);
-#if PRINT_TIMERS_BRIDGE
-            Dune::Timer t;
-#endif
-            getSparsityPattern(*mat, h_rows, h_cols);
-#if PRINT_TIMERS_BRIDGE
-            std::ostringstream out;
-            out << "getSparsityPattern() took: " << t.stop() << " s";
-            OpmLog::info(out.str());
-#endif
-        }
-
 #if PRINT_TIMERS_BRIDGE
         Dune::Timer t_zeros;
         int numZeros = checkZeroDiagonal(*mat);
@@ -230,8 +214,12 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
         /////////////////////////
         // actually solve
 
-        // assume that underlying data (nonzeroes) from mat (Dune::BCRSMatrix) are contiguous, if this is not the case, cusparseSolver is expected to perform undefined behaviour
-        SolverStatus status = backend->solve_system(N, nnz, dim, static_cast<double*>(&(((*mat)[0][0][0][0]))), h_rows.data(), h_cols.data(), static_cast<double*>(&(b[0][0])), wellContribs, result);
+        // the view has checked that the nonzeroes of mat (Dune::BCRSMatrix) are contiguous
+        // the backends take non-const pointers, but do not modify the sparsity pattern
+        SolverStatus status = backend->solve_system(N, nnz, dim, systemView.values(),
+                                                    const_cast<int*>(systemView.rowPointers()),
+                                                    const_cast<int*>(systemView.columnIndices()),
+                                                    systemView.rhs(), wellContribs, result);
         switch(status) {
         case SolverStatus::BDA_SOLVER_SUCCESS:
             //OpmLog::info("BdaSolver converged");
@@ -264,6 +252,88 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::get_result(BridgeVector
     }
 }
 
+#if HAVE_MPI
+namespace {
+
+/// Extracts the communication pattern of copyOwnerToAll() from a Dune::OwnerOverlapCopyCommunication,
+/// and exchanges the values with MPI directly
+class DuneBdaCommunication : public bda::BdaCommunication
+{
+private:
+    MPI_Comm comm;
+    std::vector<int> neighbours;
+    std::vector<int> send_offsets, recv_offsets;   // offsets of every neighbour in send_indices and recv_indices
+    std::vector<MPI_Request> requests;
+    static constexpr int tag = 3127;
+
+public:
+    DuneBdaCommunication(const Dune::OwnerOverlapCopyCommunication<int, int>& owner_overlap_copy, int block_size)
+    : comm(owner_overlap_copy.communicator())
+    {
+        using AttributeSet = Dune::OwnerOverlapCopyAttributeSet;
+        using OwnerSet = Dune::EnumItem<AttributeSet::AttributeSet, AttributeSet::owner>;
+        using OwnerOverlapSet = Dune::Combine<OwnerSet, Dune::EnumItem<AttributeSet::AttributeSet, AttributeSet::overlap>, AttributeSet::AttributeSet>;
+        using AllSet = Dune::Combine<OwnerOverlapSet, Dune::EnumItem<AttributeSet::AttributeSet, AttributeSet::copy>, AttributeSet::AttributeSet>;
+
+        Dune::Interface interface(owner_overlap_copy.communicator());
+        interface.build(owner_overlap_copy.remoteIndices(), OwnerSet(), AllSet());
+
+        // the interface is sorted by global index on both sides, so the order of the values matches
+        send_offsets.push_back(0);
+        recv_offsets.push_back(0);
+        for (const auto& [proc, info] : interface.interfaces()) {
+            neighbours.push_back(proc);
+            for (std::size_t i = 0; i < info.first.size(); ++i) {
+                for (int j = 0; j < block_size; ++j) {
+                    send_indices.push_back(info.first[i] * block_size + j);
+                }
+            }
+            for (std::size_t i = 0; i < info.second.size(); ++i) {
+                for (int j = 0; j < block_size; ++j) {
+                    recv_indices.push_back(info.second[i] * block_size + j);
+                }
+            }
+            send_offsets.push_back(send_indices.size());
+            recv_offsets.push_back(recv_indices.size());
+        }
+        requests.resize(2 * neighbours.size());
+        interface.free();
+    }
+
+    void exchange(const double *send, double *recv) override
+    {
+        const int num_neighbours = neighbours.size();
+        for (int i = 0; i < num_neighbours; ++i) {
+            MPI_Irecv(recv + recv_offsets[i], recv_offsets[i + 1] - recv_offsets[i], MPI_DOUBLE,
+                      neighbours[i], tag, comm, &requests[i]);
+        }
+        for (int i = 0; i < num_neighbours; ++i) {
+            MPI_Isend(const_cast<double*>(send + send_offsets[i]), send_offsets[i + 1] - send_offsets[i], MPI_DOUBLE,
+                      neighbours[i], tag, comm, &requests[num_neighbours + i]);
+        }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    }
+
+    void sum(double *values, int n) override
+    {
+        MPI_Allreduce(MPI_IN_PLACE, values, n, MPI_DOUBLE, MPI_SUM, comm);
+    }
+};
+
+} // anonymous namespace
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::setCommunication(const Dune::OwnerOverlapCopyCommunication<int, int>& comm)
+{
+    if (!(use_gpu || use_fpga)) {
+        return;
+    }
+    if (!backend->setCommunication(std::make_shared<DuneBdaCommunication>(comm, block_size))) {
+        OPM_THROW(std::logic_error, "Error " + accelerator_mode + "Solver does not support MPI, use '--accelerator-mode=opencl'");
+    }
+}
+#endif
+
 template <class BridgeMatrix, class BridgeVector, int block_size>
 void BdaBridge<BridgeMatrix, BridgeVector, block_size>::initWellContributions([[maybe_unused]] WellContributions& wellContribs) {
     if(accelerator_mode.compare("opencl") == 0){
@@ -281,13 +351,14 @@ template BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocat
 Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
 n>::BdaBridge                                                                                                                       \
 (std::string accelerator_mode_, std::string fpga_bitstream, int linear_solver_verbosity, int maxit, double tolerance,               \
-unsigned int platformID, unsigned int deviceID, std::string opencl_ilu_reorder);                                                    \
+unsigned int platformID, unsigned int deviceID, std::string opencl_ilu_reorder, std::string opencl_preconditioner, int, double);                     \
                                                                                                                                     \
 template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
 Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
 n>::solve_system                                                                                                                    \
 (Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >*,                               \
-    Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >&,                               \
+    const LinearSystemView<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,     \
+    Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > > >&,                             \
     WellContributions&, InverseOperatorResult&);                                                                                    \
                                                                                                                                     \
 template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
@@ -299,13 +370,26 @@ template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::al
 Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
 n>::initWellContributions(WellContributions&)
 
+#define INSTANTIATE_BDA_MPI_FUNCTIONS(n)                                                                                            \
+template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
+Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
+n>::setCommunication(const Dune::OwnerOverlapCopyCommunication<int, int>&)
+
 
 INSTANTIATE_BDA_FUNCTIONS(1);
 INSTANTIATE_BDA_FUNCTIONS(2);
 INSTANTIATE_BDA_FUNCTIONS(3);
 INSTANTIATE_BDA_FUNCTIONS(4);
 
+#if HAVE_MPI
+INSTANTIATE_BDA_MPI_FUNCTIONS(1);
+INSTANTIATE_BDA_MPI_FUNCTIONS(2);
+INSTANTIATE_BDA_MPI_FUNCTIONS(3);
+INSTANTIATE_BDA_MPI_FUNCTIONS(4);
+#endif
+
 #undef INSTANTIATE_BDA_FUNCTIONS
+#undef INSTANTIATE_BDA_MPI_FUNCTIONS
 
 } // namespace Opm
 
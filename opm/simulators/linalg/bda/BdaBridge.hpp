@@ -24,8 +24,10 @@
 
 #include "dune/istl/bcrsmatrix.hh"
 #include <opm/simulators/linalg/matrixblock.hh>
+#include <opm/simulators/linalg/LinearSystemView.hpp>
 
 #include <opm/simulators/linalg/bda/BdaSolver.hpp>
+#include <opm/simulators/linalg/bda/BdaCommunication.hpp>
 #include <opm/simulators/linalg/bda/ILUReorder.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 
@@ -34,6 +36,10 @@
 #include <opm/simulators/linalg/bda/FPGASolverBackend.hpp>
 #endif
 
+#if HAVE_MPI
+#include <dune/istl/owneroverlapcopy.hh>
+#endif
+
 namespace Opm
 {
 
@@ -60,16 +66,20 @@ public:
     /// \param[in] platformID                 the OpenCL platform ID to be used
     /// \param[in] deviceID                   the device ID to be used by the cusparse- and openclSolvers, too high values could cause runtime errors
     /// \param[in] opencl_ilu_reorder         select either level_scheduling or graph_coloring, see ILUReorder.hpp for explanation
-    BdaBridge(std::string accelerator_mode, std::string fpga_bitstream, int linear_solver_verbosity, int maxit, double tolerance, unsigned int platformID, unsigned int deviceID, std::string opencl_ilu_reorder);
+    /// \param[in] opencl_preconditioner      select either bilu0 or cpr for the openclSolver
+    /// \param[in] opencl_ilu_fillin_level    level of fill-in of the ILU of the openclSolver
+    /// \param[in] opencl_ilu_relaxation      fraction of the dropped fill-in that the ILU of the openclSolver adds to the diagonal
+    /// \param[in] opencl_kernel_cache_dir    directory for the compiled kernels of the openclSolver, empty to always compile them
+    BdaBridge(std::string accelerator_mode, std::string fpga_bitstream, int linear_solver_verbosity, int maxit, double tolerance, unsigned int platformID, unsigned int deviceID, std::string opencl_ilu_reorder, std::string opencl_preconditioner, int opencl_ilu_fillin_level, double opencl_ilu_relaxation, std::string opencl_kernel_cache_dir);
 
 
     /// Solve linear system, A*x = b
     /// \warning Values of A might get overwritten!
     /// \param[in] mat          matrix A, should be of type Dune::BCRSMatrix
-    /// \param[in] b            vector b, should be of type Dune::BlockVector
+    /// \param[in] systemView   BSR view of A and b, up to date with mat and b; its sparsity pattern is shared with the caller
     /// \param[in] wellContribs contains all WellContributions, to apply them separately, instead of adding them to matrix A
     /// \param[inout] result    summary of solver result
-    void solve_system(BridgeMatrix *mat, BridgeVector &b, WellContributions& wellContribs, InverseOperatorResult &result);
+    void solve_system(BridgeMatrix *mat, const LinearSystemView<BridgeMatrix, BridgeVector>& systemView, WellContributions& wellContribs, InverseOperatorResult &result);
 
     /// Get the resulting x vector
     /// \param[inout] x    vector x, should be of type Dune::BlockVector
@@ -86,6 +96,14 @@ public:
     /// \param[in] wellContribs   container to hold all WellContributions
     void initWellContributions(WellContributions& wellContribs);
 
+#if HAVE_MPI
+    /// Let the BdaSolver solve a linear system that is distributed over MPI processes, with one device per process
+    /// Must be called before the first solve, after the index set and remote indices of comm are complete
+    /// Only the openclSolver supports this, the others throw
+    /// \param[in] comm         communication object of the linear system, it is not stored
+    void setCommunication(const Dune::OwnerOverlapCopyCommunication<int, int>& comm);
+#endif
+
     /// Return whether the BdaBridge will use the FPGA or not
     /// return whether the BdaBridge will use the FPGA or not
     bool getUseFpga(){
@@ -0,0 +1,65 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BDACOMMUNICATION_HEADER_INCLUDED
+#define BDACOMMUNICATION_HEADER_INCLUDED
+
+#include <vector>
+
+namespace bda
+{
+
+/// This class describes the communication a BdaSolver needs when the linear system is distributed over MPI processes
+/// Every process holds the rows it owns, and copies of some rows owned by its neighbours (ghost rows)
+/// The solver only needs to send the values of owned rows to the neighbours holding a copy,
+/// to receive the values of its ghost rows, and to sum scalars over all processes
+/// It is independent of Dune and MPI, so that the backends do not need to know about either
+class BdaCommunication
+{
+protected:
+    std::vector<int> send_indices;   // scalar indices of the values to send, concatenated over all neighbours
+    std::vector<int> recv_indices;   // scalar indices of the ghost values to receive, concatenated over all neighbours
+
+public:
+    virtual ~BdaCommunication() = default;
+
+    /// Return the scalar indices of the values of owned rows that must be sent to the neighbours
+    const std::vector<int>& sendIndices() const {
+        return send_indices;
+    }
+
+    /// Return the scalar indices of the values of ghost rows, these are received from their owners
+    const std::vector<int>& recvIndices() const {
+        return recv_indices;
+    }
+
+    /// Send the values gathered at sendIndices() to the neighbours, and receive the values of recvIndices()
+    /// \param[in] send    contains sendIndices().size() values
+    /// \param[out] recv   contains recvIndices().size() values
+    virtual void exchange(const double *send, double *recv) = 0;
+
+    /// Sum values over all processes, in place
+    /// \param[inout] values   values to be summed
+    /// \param[in] n           number of values
+    virtual void sum(double *values, int n) = 0;
+};
+
+} // namespace bda
+
+#endif
@@ -21,9 +21,12 @@
 #define OPM_BDASOLVER_BACKEND_HEADER_INCLUDED
 
 
+#include <opm/simulators/linalg/bda/BdaCommunication.hpp>
 #include <opm/simulators/linalg/bda/BdaResult.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 
+#include <memory>
+
 namespace bda
 {
 
@@ -89,6 +92,14 @@ namespace bda
 
         virtual void get_result(double *x) = 0;
 
+        /// Let the solver work on a linear system that is distributed over MPI processes
+        /// Must be called before the first solve, backends that do not support it return false
+        /// \param[in] comm      describes the ghost rows of this process, and how to communicate with the others
+        /// \return              true iff the backend supports distributed linear systems
+        virtual bool setCommunication([[maybe_unused]] std::shared_ptr<BdaCommunication> comm) {
+            return false;
+        }
+
     }; // end class BdaSolver
 
 } // end namespace bda
@@ -0,0 +1,633 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <dune/common/timer.hh>
+
+#include <opm/simulators/linalg/bda/CPR.hpp>
+
+
+namespace bda
+{
+
+using Opm::OpmLog;
+using Dune::Timer;
+
+namespace
+{
+
+// solve transpose(block) * w = e_p, with Gaussian elimination and partial pivoting
+// block is stored row-major, and has bs x bs values
+// return false iff block is singular
+bool solveTransposedBlock(const double *block, const unsigned int bs, const unsigned int p, double *w)
+{
+    std::vector<double> M(bs * bs);
+    for (unsigned int i = 0; i < bs; ++i) {
+        for (unsigned int j = 0; j < bs; ++j) {
+            M[i * bs + j] = block[j * bs + i];
+        }
+        w[i] = (i == p) ? 1.0 : 0.0;
+    }
+    for (unsigned int c = 0; c < bs; ++c) {
+        unsigned int pivot = c;
+        for (unsigned int r = c + 1; r < bs; ++r) {
+            if (std::fabs(M[r * bs + c]) > std::fabs(M[pivot * bs + c])) {
+                pivot = r;
+            }
+        }
+        if (M[pivot * bs + c] == 0.0) {
+            return false;
+        }
+        if (pivot != c) {
+            for (unsigned int j = 0; j < bs; ++j) {
+                std::swap(M[c * bs + j], M[pivot * bs + j]);
+            }
+            std::swap(w[c], w[pivot]);
+        }
+        for (unsigned int r = c + 1; r < bs; ++r) {
+            const double factor = M[r * bs + c] / M[c * bs + c];
+            for (unsigned int j = c; j < bs; ++j) {
+                M[r * bs + j] -= factor * M[c * bs + j];
+            }
+            w[r] -= factor * w[c];
+        }
+    }
+    for (int r = bs - 1; r >= 0; --r) {
+        for (unsigned int j = r + 1; j < bs; ++j) {
+            w[r] -= M[r * bs + j] * w[j];
+        }
+        w[r] /= M[r * bs + r];
+    }
+    return true;
+}
+
+// invert the dense n x n matrix A in place, with Gauss-Jordan elimination and partial pivoting
+// return false iff A is singular
+bool invertDense(std::vector<double>& A, const int n)
+{
+    std::vector<int> perm(n);
+    for (int i = 0; i < n; ++i) {
+        perm[i] = i;
+    }
+    for (int c = 0; c < n; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < n; ++r) {
+            if (std::fabs(A[r * n + c]) > std::fabs(A[pivot * n + c])) {
+                pivot = r;
+            }
+        }
+        if (A[pivot * n + c] == 0.0) {
+            return false;
+        }
+        if (pivot != c) {
+            for (int j = 0; j < n; ++j) {
+                std::swap(A[c * n + j], A[pivot * n + j]);
+            }
+            std::swap(perm[c], perm[pivot]);
+        }
+        const double inv = 1.0 / A[c * n + c];
+        A[c * n + c] = 1.0;
+        for (int j = 0; j < n; ++j) {
+            A[c * n + j] *= inv;
+        }
+        for (int r = 0; r < n; ++r) {
+            if (r == c || A[r * n + c] == 0.0) {
+                continue;
+            }
+            const double factor = A[r * n + c];
+            A[r * n + c] = 0.0;
+            for (int j = 0; j < n; ++j) {
+                A[r * n + j] -= factor * A[c * n + j];
+            }
+        }
+    }
+    // the row swaps of A are column swaps of the inverse
+    std::vector<double> row(n);
+    for (int r = 0; r < n; ++r) {
+        for (int j = 0; j < n; ++j) {
+            row[perm[j]] = A[r * n + j];
+        }
+        std::copy(row.begin(), row.end(), A.begin() + r * n);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+
+template <unsigned int block_size>
+CPR<block_size>::CPR(BILU0<block_size> *bilu0_, int verbosity_) :
+    verbosity(verbosity_), bilu0(bilu0_)
+{}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::init(BlockedMatrix<block_size> *mat)
+{
+    if (block_size <= pressure_idx) {
+        OpmLog::warning("CPR needs at least " + std::to_string(pressure_idx + 1) + " equations per cell");
+        return false;
+    }
+
+    this->Nb = mat->Nb;
+    this->N = mat->Nb * block_size;
+    this->nnzb = mat->nnzbs;
+
+    weights.resize(N);
+    d_weights = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+    d_rs = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+    d_tmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+
+    return true;
+}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::create_pressure_matrix(BlockedMatrix<block_size> *mat)
+{
+    const unsigned int bs = block_size;
+
+    if (levels.empty()) {
+        levels.emplace_back();
+        Level& fine = levels.front();
+        fine.N = Nb;
+        fine.rows.assign(mat->rowPointers, mat->rowPointers + Nb + 1);
+        fine.cols.assign(mat->colIndices, mat->colIndices + nnzb);
+        fine.vals.resize(nnzb);
+    }
+    Level& fine = levels.front();
+
+    for (int row = 0; row < Nb; ++row) {
+        const int rowStart = mat->rowPointers[row];
+        const int rowEnd = mat->rowPointers[row + 1];
+        const int *candidate = std::find(mat->colIndices + rowStart, mat->colIndices + rowEnd, row);
+        if (candidate == mat->colIndices + rowEnd) {
+            return false;
+        }
+        double *w = weights.data() + row * bs;
+        if (!solveTransposedBlock(mat->nnzValues + (candidate - mat->colIndices) * bs * bs, bs, pressure_idx, w)) {
+            return false;
+        }
+        double abs_max = 0.0;
+        for (unsigned int i = 0; i < bs; ++i) {
+            abs_max = std::max(abs_max, std::fabs(w[i]));
+        }
+        for (unsigned int i = 0; i < bs; ++i) {
+            w[i] /= abs_max;
+        }
+
+        // entries of the pressure matrix are the weighted sums of the pressure columns of the blocks
+        for (int k = rowStart; k < rowEnd; ++k) {
+            const double *block = mat->nnzValues + k * bs * bs;
+            double val = 0.0;
+            for (unsigned int i = 0; i < bs; ++i) {
+                val += w[i] * block[i * bs + pressure_idx];
+            }
+            fine.vals[k] = val;
+        }
+    }
+    return true;
+}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::coarsen(int level)
+{
+    const int n = levels[level].N;
+    const std::vector<double>& vals = levels[level].vals;
+    const std::vector<int>& cols = levels[level].cols;
+    const std::vector<int>& rows = levels[level].rows;
+
+    std::vector<double> rowMax(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int k = rows[i]; k < rows[i + 1]; ++k) {
+            if (cols[k] != i) {
+                rowMax[i] = std::max(rowMax[i], std::fabs(vals[k]));
+            }
+        }
+    }
+    auto strong = [&](int i, int k) {
+        return cols[k] != i && vals[k] != 0.0 && std::fabs(vals[k]) >= strength_threshold * rowMax[i];
+    };
+
+    // plain aggregation: first form aggregates of rows whose strong neighbours are all free,
+    // then add the remaining rows to the aggregate of their strongest neighbour
+    std::vector<int> aggregates(n, -1);
+    int numAggregates = 0;
+    for (int i = 0; i < n; ++i) {
+        if (aggregates[i] != -1) {
+            continue;
+        }
+        bool free = true;
+        for (int k = rows[i]; k < rows[i + 1] && free; ++k) {
+            free = !strong(i, k) || aggregates[cols[k]] == -1;
+        }
+        if (!free) {
+            continue;
+        }
+        for (int k = rows[i]; k < rows[i + 1]; ++k) {
+            if (strong(i, k)) {
+                aggregates[cols[k]] = numAggregates;
+            }
+        }
+        aggregates[i] = numAggregates++;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (aggregates[i] != -1) {
+            continue;
+        }
+        int best = -1;
+        for (int k = rows[i]; k < rows[i + 1]; ++k) {
+            if (strong(i, k) && aggregates[cols[k]] != -1 && (best == -1 || std::fabs(vals[k]) > std::fabs(vals[best]))) {
+                best = k;
+            }
+        }
+        aggregates[i] = (best == -1) ? numAggregates++ : aggregates[cols[best]];
+    }
+
+    if (numAggregates > 0.8 * n) {
+        return false;
+    }
+
+    // the rows of the fine level in every aggregate
+    std::vector<int> aggStart(numAggregates + 1, 0), aggRows(n);
+    for (int i = 0; i < n; ++i) {
+        ++aggStart[aggregates[i] + 1];
+    }
+    for (int a = 0; a < numAggregates; ++a) {
+        aggStart[a + 1] += aggStart[a];
+    }
+    std::vector<int> next(aggStart.begin(), aggStart.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        aggRows[next[aggregates[i]]++] = i;
+    }
+
+    // sparsity pattern of the Galerkin product, and the position of every fine nonzero in it
+    Level coarse;
+    coarse.N = numAggregates;
+    coarse.rows.reserve(numAggregates + 1);
+    coarse.rows.push_back(0);
+    std::vector<int> coarseIndex(rows[n]);
+    std::vector<int> marker(numAggregates, -1);
+    for (int a = 0; a < numAggregates; ++a) {
+        const int rowStart = coarse.cols.size();
+        for (int idx = aggStart[a]; idx < aggStart[a + 1]; ++idx) {
+            const int i = aggRows[idx];
+            for (int k = rows[i]; k < rows[i + 1]; ++k) {
+                const int col = aggregates[cols[k]];
+                if (marker[col] < rowStart) {
+                    marker[col] = coarse.cols.size();
+                    coarse.cols.push_back(col);
+                }
+                coarseIndex[k] = marker[col];
+            }
+        }
+        coarse.rows.push_back(coarse.cols.size());
+    }
+    coarse.vals.resize(coarse.cols.size());
+
+    levels[level].aggregates.swap(aggregates);
+    levels[level].coarseIndex.swap(coarseIndex);
+    levels.push_back(std::move(coarse));
+
+    // the next coarsening needs the values of the new level
+    Level& fine = levels[level];
+    std::fill(levels.back().vals.begin(), levels.back().vals.end(), 0.0);
+    for (unsigned int k = 0; k < fine.vals.size(); ++k) {
+        levels.back().vals[fine.coarseIndex[k]] += fine.vals[k];
+    }
+    return true;
+}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::update_hierarchy_values()
+{
+    const int numLevels = levels.size();
+    for (int l = 0; l + 1 < numLevels; ++l) {
+        const Level& fine = levels[l];
+        Level& coarse = levels[l + 1];
+        std::fill(coarse.vals.begin(), coarse.vals.end(), 0.0);
+        for (unsigned int k = 0; k < fine.vals.size(); ++k) {
+            coarse.vals[fine.coarseIndex[k]] += fine.vals[k];
+        }
+    }
+
+    for (int l = 0; l < numLevels; ++l) {
+        Level& level = levels[l];
+        if (l + 1 == numLevels && dense_coarse_solve) {
+            continue;
+        }
+        level.invDiag.assign(level.N, 0.0);
+        for (int i = 0; i < level.N; ++i) {
+            for (int k = level.rows[i]; k < level.rows[i + 1]; ++k) {
+                if (level.cols[k] == i && level.vals[k] != 0.0) {
+                    level.invDiag[i] = 1.0 / level.vals[k];
+                }
+            }
+        }
+    }
+
+    if (dense_coarse_solve) {
+        const Level& coarsest = levels.back();
+        const int n = coarsest.N;
+        coarseInverse.assign(n * n, 0.0);
+        for (int i = 0; i < n; ++i) {
+            for (int k = coarsest.rows[i]; k < coarsest.rows[i + 1]; ++k) {
+                coarseInverse[i * n + coarsest.cols[k]] = coarsest.vals[k];
+            }
+        }
+        if (!invertDense(coarseInverse, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::upload_hierarchy_pattern()
+{
+    const int numLevels = levels.size();
+    for (int l = 0; l < numLevels; ++l) {
+        Level& level = levels[l];
+        const int n = level.N;
+        const bool coarsest = (l + 1 == numLevels);
+
+        level.d_x = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n);
+        level.d_b = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n);
+        level.d_r = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n);
+
+        if (coarsest && dense_coarse_solve) {
+            // the dense inverse is applied as CSR matrix
+            std::vector<int> rows(n + 1), cols(n * n);
+            for (int i = 0; i <= n; ++i) {
+                rows[i] = i * n;
+            }
+            for (int k = 0; k < n * n; ++k) {
+                cols[k] = k % n;
+            }
+            level.d_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n * n);
+            level.d_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * n * n);
+            level.d_rows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (n + 1));
+            err = queue->enqueueWriteBuffer(level.d_cols, CL_TRUE, 0, sizeof(int) * n * n, cols.data());
+            err |= queue->enqueueWriteBuffer(level.d_rows, CL_TRUE, 0, sizeof(int) * (n + 1), rows.data());
+        } else {
+            const int nnz = level.rows[n];
+            level.d_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * nnz);
+            level.d_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * nnz);
+            level.d_rows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (n + 1));
+            level.d_invDiag = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n);
+            err = queue->enqueueWriteBuffer(level.d_cols, CL_TRUE, 0, sizeof(int) * nnz, level.cols.data());
+            err |= queue->enqueueWriteBuffer(level.d_rows, CL_TRUE, 0, sizeof(int) * (n + 1), level.rows.data());
+        }
+
+        if (!coarsest) {
+            // restriction, every row of the next level sums the rows of its aggregate
+            const int nc = levels[l + 1].N;
+            std::vector<int> Rrows(nc + 1, 0), Rcols(n);
+            std::vector<double> Rvals(n, 1.0);
+            for (int i = 0; i < n; ++i) {
+                ++Rrows[level.aggregates[i] + 1];
+            }
+            for (int a = 0; a < nc; ++a) {
+                Rrows[a + 1] += Rrows[a];
+            }
+            std::vector<int> next(Rrows.begin(), Rrows.end() - 1);
+            for (int i = 0; i < n; ++i) {
+                Rcols[next[level.aggregates[i]]++] = i;
+            }
+            level.d_aggregates = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * n);
+            level.d_Rvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * n);
+            level.d_Rcols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * n);
+            level.d_Rrows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (nc + 1));
+            err |= queue->enqueueWriteBuffer(level.d_aggregates, CL_TRUE, 0, sizeof(int) * n, level.aggregates.data());
+            err |= queue->enqueueWriteBuffer(level.d_Rvals, CL_TRUE, 0, sizeof(double) * n, Rvals.data());
+            err |= queue->enqueueWriteBuffer(level.d_Rcols, CL_TRUE, 0, sizeof(int) * n, Rcols.data());
+            err |= queue->enqueueWriteBuffer(level.d_Rrows, CL_TRUE, 0, sizeof(int) * (nc + 1), Rrows.data());
+        }
+
+        if (err != CL_SUCCESS) {
+            // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
+            OPM_THROW(std::logic_error, "CPR OpenCL enqueueWriteBuffer error");
+        }
+    }
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::upload_hierarchy_values()
+{
+    const int numLevels = levels.size();
+    events.resize(2 * numLevels + 1);
+    err = queue->enqueueWriteBuffer(d_weights, CL_FALSE, 0, sizeof(double) * N, weights.data(), nullptr, &events[0]);
+    int numEvents = 1;
+    for (int l = 0; l < numLevels; ++l) {
+        Level& level = levels[l];
+        if (l + 1 == numLevels && dense_coarse_solve) {
+            err |= queue->enqueueWriteBuffer(level.d_vals, CL_FALSE, 0, sizeof(double) * coarseInverse.size(), coarseInverse.data(), nullptr, &events[numEvents++]);
+        } else {
+            err |= queue->enqueueWriteBuffer(level.d_vals, CL_FALSE, 0, sizeof(double) * level.vals.size(), level.vals.data(), nullptr, &events[numEvents++]);
+            err |= queue->enqueueWriteBuffer(level.d_invDiag, CL_FALSE, 0, sizeof(double) * level.N, level.invDiag.data(), nullptr, &events[numEvents++]);
+        }
+    }
+    events.resize(numEvents);
+    cl::WaitForEvents(events);
+    events.clear();
+    if (err != CL_SUCCESS) {
+        // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
+        OPM_THROW(std::logic_error, "CPR OpenCL enqueueWriteBuffer error");
+    }
+}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::create_preconditioner(BlockedMatrix<block_size> *mat)
+{
+    Timer t;
+
+    if (!create_pressure_matrix(mat)) {
+        return false;
+    }
+
+    if (!hierarchy_built) {
+        while (static_cast<int>(levels.size()) < max_levels && levels.back().N > coarse_size) {
+            if (!coarsen(levels.size() - 1)) {
+                break;
+            }
+        }
+        dense_coarse_solve = (levels.back().N <= coarse_size);
+        upload_hierarchy_pattern();
+        hierarchy_built = true;
+
+        if (verbosity >= 2) {
+            std::ostringstream out;
+            out << "CPR hierarchy: " << levels.size() << " levels, sizes:";
+            for (const auto& level : levels) {
+                out << " " << level.N;
+            }
+            out << (dense_coarse_solve ? ", dense coarse solve" : ", smoothing on coarsest level");
+            OpmLog::info(out.str());
+        }
+    }
+
+    if (!update_hierarchy_values()) {
+        return false;
+    }
+    upload_hierarchy_values();
+
+    if (verbosity >= 3) {
+        std::ostringstream out;
+        out << "CPR create_preconditioner: " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+    return true;
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::jacobi_sweep(Level& level)
+{
+    cl::EnqueueArgs args(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size));
+    (*residual_k)(args, level.d_vals, level.d_cols, level.d_rows, level.N, level.d_x, level.d_b, level.d_r);
+    (*vmul_k)(args, jacobi_omega, level.d_invDiag, level.d_r, level.d_x, level.N);
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::amg_cycle(int l)
+{
+    cl::EnqueueArgs args(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size));
+    Level& level = levels[l];
+    const bool coarsest = (l + 1 == static_cast<int>(levels.size()));
+
+    if (coarsest && dense_coarse_solve) {
+        (*spmv_k)(args, level.d_vals, level.d_cols, level.d_rows, level.N, level.d_b, level.d_x);
+        return;
+    }
+
+    queue->enqueueFillBuffer(level.d_x, 0, 0, sizeof(double) * level.N);
+    const int sweeps = coarsest ? coarse_sweeps : 1;
+    for (int i = 0; i < sweeps; ++i) {
+        jacobi_sweep(level);
+    }
+    if (coarsest) {
+        return;
+    }
+
+    Level& coarse = levels[l + 1];
+    (*residual_k)(args, level.d_vals, level.d_cols, level.d_rows, level.N, level.d_x, level.d_b, level.d_r);
+    (*spmv_k)(args, level.d_Rvals, level.d_Rcols, level.d_Rrows, coarse.N, level.d_r, coarse.d_b);
+    amg_cycle(l + 1);
+    (*prolongate_vector_k)(args, coarse.d_x, level.d_x, level.d_aggregates, level.N);
+    jacobi_sweep(level);
+}
+
+
+// kernels are blocking on an NVIDIA GPU, so waiting for events is not needed
+template <unsigned int block_size>
+void CPR<block_size>::apply(cl::Buffer& x, cl::Buffer& y)
+{
+    Timer t_apply;
+    const unsigned int bs = block_size;
+    cl::EnqueueArgs args(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size));
+
+    // first stage: pressure correction
+    (*full_to_pressure_restriction_k)(args, x, d_weights, levels.front().d_b, bs, Nb);
+    amg_cycle(0);
+    queue->enqueueFillBuffer(y, 0, 0, sizeof(double) * N);
+    (*add_coarse_pressure_correction_k)(args, levels.front().d_x, y, pressure_idx, bs, Nb);
+
+    // second stage: y += BILU0(x - A * y)
+    (*spmv_blocked_k)(args, *d_Avals, *d_Acols, *d_Arows, Nb, y, d_tmp, bs, cl::Local(lmem_per_work_group));
+    queue->enqueueCopyBuffer(x, d_rs, 0, 0, sizeof(double) * N);
+    (*axpy_k)(args, d_tmp, -1.0, d_rs, N);
+    bilu0->apply(d_rs, d_tmp);
+    cl::Event event = (*axpy_k)(args, d_tmp, 1.0, y, N);
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream out;
+        out << "CPR apply: " << t_apply.stop() << " s";
+        OpmLog::info(out.str());
+    }
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::setOpenCLContext(cl::Context *context_) {
+    this->context = context_;
+}
+template <unsigned int block_size>
+void CPR<block_size>::setOpenCLQueue(cl::CommandQueue *queue_) {
+    this->queue = queue_;
+}
+template <unsigned int block_size>
+void CPR<block_size>::setKernelParameters(const unsigned int work_group_size_, const unsigned int total_work_items_, const unsigned int lmem_per_work_group_) {
+    this->work_group_size = work_group_size_;
+    this->total_work_items = total_work_items_;
+    this->lmem_per_work_group = lmem_per_work_group_;
+}
+template <unsigned int block_size>
+void CPR<block_size>::setKernels(
+    spmv_kernel_type *spmv_blocked_k_,
+    cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int> *axpy_k_,
+    spmv_scalar_kernel_type *spmv_k_,
+    residual_kernel_type *residual_k_,
+    vmul_kernel_type *vmul_k_,
+    full_to_pressure_restriction_kernel_type *full_to_pressure_restriction_k_,
+    add_coarse_pressure_correction_kernel_type *add_coarse_pressure_correction_k_,
+    prolongate_vector_kernel_type *prolongate_vector_k_
+){
+    this->spmv_blocked_k = spmv_blocked_k_;
+    this->axpy_k = axpy_k_;
+    this->spmv_k = spmv_k_;
+    this->residual_k = residual_k_;
+    this->vmul_k = vmul_k_;
+    this->full_to_pressure_restriction_k = full_to_pressure_restriction_k_;
+    this->add_coarse_pressure_correction_k = add_coarse_pressure_correction_k_;
+    this->prolongate_vector_k = prolongate_vector_k_;
+}
+template <unsigned int block_size>
+void CPR<block_size>::setMatrixBuffers(cl::Buffer *d_Avals_, cl::Buffer *d_Acols_, cl::Buffer *d_Arows_) {
+    this->d_Avals = d_Avals_;
+    this->d_Acols = d_Acols_;
+    this->d_Arows = d_Arows_;
+}
+
+
+#define INSTANTIATE_BDA_FUNCTIONS(n)  \
+template class CPR<n>;
+
+INSTANTIATE_BDA_FUNCTIONS(1);
+INSTANTIATE_BDA_FUNCTIONS(2);
+INSTANTIATE_BDA_FUNCTIONS(3);
+INSTANTIATE_BDA_FUNCTIONS(4);
+
+#undef INSTANTIATE_BDA_FUNCTIONS
+
+} // end namespace bda
@@ -0,0 +1,160 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CPR_HPP
+#define CPR_HPP
+
+#include <vector>
+
+#include <opm/simulators/linalg/bda/BlockedMatrix.hpp>
+#include <opm/simulators/linalg/bda/BILU0.hpp>
+
+#include <opm/simulators/linalg/bda/opencl.hpp>
+#include <opm/simulators/linalg/bda/openclKernels.hpp>
+
+namespace bda
+{
+
+    /// This class implements a Constrained Pressure Residual (CPR) preconditioner
+    /// The first stage restricts the residual to a pressure system with quasi-IMPES weights,
+    /// and applies one V-cycle of an aggregation-based AMG to it. The second stage applies
+    /// BILU0 to the residual of the full system that remains after the pressure correction.
+    /// The weights and the AMG hierarchy are computed on CPU, the aggregates are only computed
+    /// for the first matrix and are reused afterwards. The apply is done entirely on GPU.
+    template <unsigned int block_size>
+    class CPR
+    {
+
+    private:
+        // one level of the AMG hierarchy for the pressure system
+        struct Level {
+            int N = 0;                      // number of rows
+            std::vector<double> vals;       // scalar CSR matrix
+            std::vector<int> cols, rows;
+            std::vector<double> invDiag;    // for the damped Jacobi smoother
+            std::vector<int> aggregates;    // aggregate of every row, which is the row in the next coarser level
+            std::vector<int> coarseIndex;   // for every nonzero, where it is added to in the next coarser matrix
+            cl::Buffer d_vals, d_cols, d_rows; // on the coarsest level, these contain the dense inverse
+            cl::Buffer d_invDiag;
+            cl::Buffer d_aggregates;
+            cl::Buffer d_Rvals, d_Rcols, d_Rrows; // restriction, rows of the next coarser level
+            cl::Buffer d_x, d_b, d_r;
+        };
+
+        static constexpr unsigned int pressure_idx = 1;  // same as the Dune CPR, see setupPropertyTree.cpp
+        static constexpr int max_levels = 15;
+        static constexpr int coarse_size = 300;          // stop coarsening when this size is reached
+        static constexpr double strength_threshold = 0.25;
+        static constexpr double jacobi_omega = 0.67;
+        static constexpr int coarse_sweeps = 4;          // smoothing steps if the coarsest level is too large for a dense solve
+
+        int N;       // number of rows of the matrix
+        int Nb;      // number of blockrows of the matrix
+        int nnzb;    // number of blocks of the matrix
+        int verbosity;
+        bool hierarchy_built = false;
+        bool dense_coarse_solve = false;
+
+        BILU0<block_size> *bilu0;       // second stage, not owned
+        std::vector<Level> levels;
+        std::vector<double> weights;    // quasi-IMPES weights, N values
+        std::vector<double> coarseInverse;
+
+        cl::Buffer d_weights;
+        cl::Buffer d_rs, d_tmp;          // full system residual and correction
+        cl::Buffer *d_Avals = nullptr, *d_Acols = nullptr, *d_Arows = nullptr; // (reordered) matrix on GPU, not owned
+
+        spmv_kernel_type *spmv_blocked_k;
+        cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int> *axpy_k;
+        spmv_scalar_kernel_type *spmv_k;
+        residual_kernel_type *residual_k;
+        vmul_kernel_type *vmul_k;
+        full_to_pressure_restriction_kernel_type *full_to_pressure_restriction_k;
+        add_coarse_pressure_correction_kernel_type *add_coarse_pressure_correction_k;
+        prolongate_vector_kernel_type *prolongate_vector_k;
+
+        cl::Context *context;
+        cl::CommandQueue *queue;
+        std::vector<cl::Event> events;
+        cl_int err;
+        int work_group_size = 0;
+        int total_work_items = 0;
+        int lmem_per_work_group = 0;
+
+        /// Compute the quasi-IMPES weights and the pressure matrix of the finest level
+        /// \param[in] mat     (reordered) matrix
+        /// \return            false iff a diagonal block is singular
+        bool create_pressure_matrix(BlockedMatrix<block_size> *mat);
+
+        /// Compute the aggregates of level, and the pattern of the next coarser level
+        /// \param[in] level   index of the level to be coarsened
+        /// \return            false iff the coarsening is too slow to continue
+        bool coarsen(int level);
+
+        /// Recompute the values of all coarser levels with the Galerkin product, and the smoothers
+        /// \return            false iff the coarsest matrix is singular
+        bool update_hierarchy_values();
+
+        /// Allocate the GPU memory for the hierarchy, and copy the sparsity patterns
+        void upload_hierarchy_pattern();
+
+        /// Copy the values of the hierarchy and the weights to the GPU
+        void upload_hierarchy_values();
+
+        /// Apply one damped Jacobi step on GPU, x = x + omega * D^-1 * (b - A * x)
+        void jacobi_sweep(Level& level);
+
+        /// Apply a V-cycle on GPU, starting at level, the rhs is levels[level].d_b, solution in levels[level].d_x
+        void amg_cycle(int level);
+
+    public:
+
+        CPR(BILU0<block_size> *bilu0, int verbosity);
+
+        // analysis
+        bool init(BlockedMatrix<block_size> *mat);
+
+        // build the AMG hierarchy for mat, the BILU0 of the second stage must be created before
+        bool create_preconditioner(BlockedMatrix<block_size> *mat);
+
+        // apply preconditioner, y = prec(x)
+        void apply(cl::Buffer& x, cl::Buffer& y);
+
+        void setOpenCLContext(cl::Context *context);
+        void setOpenCLQueue(cl::CommandQueue *queue);
+        void setKernelParameters(const unsigned int work_group_size, const unsigned int total_work_items, const unsigned int lmem_per_work_group);
+        void setKernels(
+            spmv_kernel_type *spmv_blocked_k,
+            cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int> *axpy_k,
+            spmv_scalar_kernel_type *spmv_k,
+            residual_kernel_type *residual_k,
+            vmul_kernel_type *vmul_k,
+            full_to_pressure_restriction_kernel_type *full_to_pressure_restriction_k,
+            add_coarse_pressure_correction_kernel_type *add_coarse_pressure_correction_k,
+            prolongate_vector_kernel_type *prolongate_vector_k
+            );
+
+        /// Set the (reordered) matrix on GPU, which is used for the residual of the second stage
+        void setMatrixBuffers(cl::Buffer *d_Avals, cl::Buffer *d_Acols, cl::Buffer *d_Arows);
+
+    };
+
+} // end namespace bda
+
+#endif
@@ -242,16 +242,6 @@ bool FPGABILU0<block_size>::create_preconditioner(BlockedMatrix<block_size> *mat
         OpmLog::info(out.str());
     }
 
-    // TODO: remove this copy by replacing inplace ilu decomp by out-of-place ilu decomp
-    Timer t_memcpy;
-    memcpy(LUMat->nnzValues, rMat->nnzValues, sizeof(double) * bs * bs * rMat->nnzbs);
-
-    if (verbosity >= 3) {
-        std::ostringstream out;
-        out << "FPGABILU0 memcpy: " << t_memcpy.stop() << " s";
-        OpmLog::info(out.str());
-    }
-
     int i, j, ij, ik, jk;
     int iRowStart, iRowEnd, jRowEnd;
     double pivot[bs * bs];
@@ -261,9 +251,12 @@ bool FPGABILU0<block_size>::create_preconditioner(BlockedMatrix<block_size> *mat
     Timer t_decomposition;
 
     // go through all rows
+    // the decomposition is out-of-place: row i of rMat is copied to LUMat just before it is processed,
+    // the previous rows of LUMat are already decomposed, rMat itself is not modified
     for (i = 0; i < LUMat->Nb; i++) {
         iRowStart = LUMat->rowPointers[i];
         iRowEnd = LUMat->rowPointers[i + 1];
+        memcpy(LUMat->nnzValues + iRowStart * bs * bs, rMat->nnzValues + iRowStart * bs * bs, sizeof(double) * bs * bs * (iRowEnd - iRowStart));
 
         // go through all elements of the row
         for (ij = iRowStart; ij < iRowEnd; ij++) {
@@ -231,8 +231,8 @@ SolverStatus FpgaSolverBackend<block_size>::solve_system(int N_, int nnz_, int d
         }
     }
     perf_call.emplace_back();
-    update_system(vals, b);
-    if (!create_preconditioner()) {
+    update_system(b);
+    if (!create_preconditioner(vals)) {
         return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
     }
     solve_system(res);
@@ -362,7 +362,7 @@ bool FpgaSolverBackend<block_size>::analyse_matrix()
 
 
 template <unsigned int block_size>
-bool FpgaSolverBackend<block_size>::create_preconditioner()
+bool FpgaSolverBackend<block_size>::create_preconditioner(double *vals)
 {
     double start = 0;
 
@@ -370,7 +370,8 @@ bool FpgaSolverBackend<block_size>::create_preconditioner()
         start = second();
     }
     memset(rx, 0, sizeof(double) * N);
-    bool result = prec->create_preconditioner(mat.get());
+    BlockedMatrix<block_size> values(mat->Nb, mat->nnzbs, vals, mat->colIndices, mat->rowPointers);
+    bool result = prec->create_preconditioner(&values);
     if (!result) {
         OpmLog::warning("fpgaSolverBackend: create_preconditioner failed");
     }
@@ -589,11 +590,10 @@ void FpgaSolverBackend<block_size>::solve_system(BdaResult &res)
 
 
 template <unsigned int block_size>
-void FpgaSolverBackend<block_size>::update_system(double *vals, double *b)
+void FpgaSolverBackend<block_size>::update_system(double *b)
 {
     double start = 0;
 
-    mat->nnzValues = vals;
     // reorder inputs using previously found ordering (stored in fromOrder)
     if (perf_call_enabled) {
         start = second();
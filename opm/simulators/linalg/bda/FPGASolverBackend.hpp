@@ -207,18 +207,18 @@ private:
     /// \param[in] cols           array of columnIndices, contains nnz values
     void initialize(int N, int nnz, int dim, double *vals, int *rows, int *cols);
 
-    /// Reorder the linear system so it corresponds with the coloring
-    /// \param[in] vals           array of nonzeroes, each block is stored row-wise and contiguous, contains nnz values
+    /// Reorder the right hand side so it corresponds with the coloring
     /// \param[in] b              input vector
-    void update_system(double *vals, double *b);
+    void update_system(double *b);
 
     /// Analyse sparsity pattern to extract parallelism
     /// \return true iff analysis was successful
     bool analyse_matrix();
 
     /// Perform ilu0-decomposition
+    /// \param[in] vals           array of nonzeroes, each block is stored row-wise and contiguous, contains nnz values
     /// \return true iff decomposition was successful
-    bool create_preconditioner();
+    bool create_preconditioner(double *vals);
 
     /// Solve linear system
     /// \param[inout] res         summary of solver result
@@ -26,6 +26,9 @@
 
 #include <opm/simulators/linalg/bda/MultisegmentWellContribution.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace Opm
 {
 
@@ -63,6 +66,30 @@ MultisegmentWellContribution::~MultisegmentWellContribution()
     umfpack_di_free_numeric(&UMFPACK_Numeric);
 }
 
+bool MultisegmentWellContribution::sameDPattern(unsigned int dim_wells_, unsigned int Mb_, unsigned int DnumBlocks_,
+        UMFPackIndex *DcolPointers, UMFPackIndex *DrowIndices) const
+{
+    if (dim_wells_ != dim_wells || Mb_ != Mb || DnumBlocks_ != DnumBlocks) {
+        return false;
+    }
+    return std::equal(Dcols.begin(), Dcols.end(), DcolPointers)
+        && std::equal(Drows.begin(), Drows.end(), DrowIndices);
+}
+
+void MultisegmentWellContribution::update(std::vector<double> &Bvalues, std::vector<unsigned int> &BcolIndices,
+        std::vector<unsigned int> &BrowPointers, double *Dvalues, std::vector<double> &Cvalues)
+{
+    Cvals = std::move(Cvalues);
+    Bvals = std::move(Bvalues);
+    Bcols = std::move(BcolIndices);
+    Brows = std::move(BrowPointers);
+    std::copy(Dvalues, Dvalues + Dvals.size(), Dvals.begin());
+
+    // the pattern of D is unchanged, the symbolic factorization (the ordering) stays valid
+    umfpack_di_free_numeric(&UMFPACK_Numeric);
+    umfpack_di_numeric(Dcols.data(), Drows.data(), Dvals.data(), UMFPACK_Symbolic, &UMFPACK_Numeric, nullptr, nullptr);
+}
+
 
 // Apply the MultisegmentWellContribution, similar to MultisegmentWell::apply()
 // h_x and h_y reside on host
@@ -131,5 +158,68 @@ void MultisegmentWellContribution::setReordering(int *toOrder_, bool reorder_)
     this->reorder = reorder_;
 }
 
+bool MultisegmentWellContribution::factorizeBanded(std::vector<double>& band, std::vector<int>& pivots, unsigned int& kl, unsigned int& ku) const
+{
+    const int n = M;
+    int lower = 0, upper = 0;
+    for (int col = 0; col < n; ++col) {
+        for (int k = Dcols[col]; k < Dcols[col + 1]; ++k) {
+            lower = std::max(lower, Drows[k] - col);
+            upper = std::max(upper, col - Drows[k]);
+        }
+    }
+    kl = lower;
+    ku = upper;
+
+    // the factor U gets kl extra superdiagonals from the row interchanges
+    const int kv = lower + upper;
+    const int ldab = 2 * lower + upper + 1;
+    auto entry = [&](int i, int j) -> double& {
+        return band[j * ldab + kv + i - j];
+    };
+    band.assign(n * ldab, 0.0);
+    pivots.resize(n);
+    for (int col = 0; col < n; ++col) {
+        for (int k = Dcols[col]; k < Dcols[col + 1]; ++k) {
+            entry(Drows[k], col) = Dvals[k];
+        }
+    }
+
+    // unblocked version of dgbtrf, see dgbtf2 in LAPACK
+    int ju = 0;   // last column of U that is affected by the interchanges so far
+    for (int j = 0; j < n; ++j) {
+        const int km = std::min(lower, n - 1 - j);
+        int jp = 0;
+        for (int i = 1; i <= km; ++i) {
+            if (std::abs(entry(j + i, j)) > std::abs(entry(j + jp, j))) {
+                jp = i;
+            }
+        }
+        pivots[j] = j + jp;
+        if (entry(j + jp, j) == 0.0) {
+            return false;
+        }
+        ju = std::max(ju, std::min(j + upper + jp, n - 1));
+        if (jp != 0) {
+            for (int col = j; col <= ju; ++col) {
+                std::swap(entry(j, col), entry(j + jp, col));
+            }
+        }
+        const double pivot = entry(j, j);
+        for (int i = 1; i <= km; ++i) {
+            entry(j + i, j) /= pivot;
+        }
+        for (int col = j + 1; col <= ju; ++col) {
+            const double u = entry(j, col);
+            if (u != 0.0) {
+                for (int i = 1; i <= km; ++i) {
+                    entry(j + i, col) -= entry(j + i, j) * u;
+                }
+            }
+        }
+    }
+    return true;
+}
+
 } //namespace Opm
 
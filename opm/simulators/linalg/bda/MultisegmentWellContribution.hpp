@@ -112,6 +112,26 @@ public:
     /// Destroy a MultisegmentWellContribution, and free memory
     ~MultisegmentWellContribution();
 
+    /// Check if D has the same sparsity pattern as the D of this object
+    /// \param[in] dim_wells        size of blocks of C, B and D, equal to MultisegmentWell::numWellEq
+    /// \param[in] Mb               number of blockrows in C, B and D
+    /// \param[in] DnumBlocks       number of blocks in D
+    /// \param[in] DcolPointers     columnpointers of matrix D
+    /// \param[in] DrowIndices      rowindices of matrix D
+    /// \return                     true iff the symbolic factorization of D can be reused
+    bool sameDPattern(unsigned int dim_wells, unsigned int Mb, unsigned int DnumBlocks,
+                      UMFPackIndex *DcolPointers, UMFPackIndex *DrowIndices) const;
+
+    /// Replace the values of B, C and D, only redo the numeric factorization of D
+    /// Can only be used if sameDPattern() returns true for the new D
+    /// \param[in] Bvalues          nonzero values of matrix B
+    /// \param[in] BcolIndices      columnindices of blocks of matrix B
+    /// \param[in] BrowPointers     rowpointers of matrix B
+    /// \param[in] Dvalues          nonzero values of matrix D
+    /// \param[in] Cvalues          nonzero values of matrix C
+    void update(std::vector<double> &Bvalues, std::vector<unsigned int> &BcolIndices, std::vector<unsigned int> &BrowPointers,
+                double *Dvalues, std::vector<double> &Cvalues);
+
     /// Apply the MultisegmentWellContribution on CPU
     /// performs y -= (C^T * (D^-1 * (B*x))) for MultisegmentWell
     /// \param[in] h_x          vector x, must be on CPU
@@ -123,6 +143,44 @@ public:
     /// \param[in] toOrder    array with mappings
     /// \param[in] reorder    whether reordering is actually used or not
     void setReordering(int *toOrder, bool reorder);
+
+    /// Factorize D with a banded LU decomposition with partial pivoting, used to apply the well on GPU
+    /// The bandwidths follow from the sparsity pattern of D, the segment systems have a small bandwidth
+    /// The factors are stored like LAPACK dgbtrf: column-major with leading dimension 2*kl+ku+1,
+    /// entry (i, j) of the factors is located at band[j * (2*kl+ku+1) + kl+ku + i-j]
+    /// \param[out] band       factors L and U, contains M*(2*kl+ku+1) values
+    /// \param[out] pivots     row interchanges, row j was interchanged with row pivots[j], contains M values
+    /// \param[out] kl         number of subdiagonals of D
+    /// \param[out] ku         number of superdiagonals of D
+    /// \return                false iff D is singular
+    bool factorizeBanded(std::vector<double>& band, std::vector<int>& pivots, unsigned int& kl, unsigned int& ku) const;
+
+    /// Return the size of the blocks in x and y, and the size of the blocks of D
+    unsigned int getDim() const {
+        return dim;
+    }
+    unsigned int getDimWells() const {
+        return dim_wells;
+    }
+
+    /// Return the number of blockrows of B, C and D
+    unsigned int getNumBlockRows() const {
+        return Mb;
+    }
+
+    /// Return the matrices B and C in blocked CSR format, they share the sparsity pattern
+    const std::vector<double>& getBvals() const {
+        return Bvals;
+    }
+    const std::vector<double>& getCvals() const {
+        return Cvals;
+    }
+    const std::vector<unsigned int>& getBcols() const {
+        return Bcols;
+    }
+    const std::vector<unsigned int>& getBrows() const {
+        return Brows;
+    }
 };
 
 } //namespace Opm
@@ -17,6 +17,8 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <map>
 #include <random>
 
 #include <opm/common/ErrorMacros.hpp>
@@ -352,6 +354,187 @@ void csrPatternToCsc(int *CSRColIndices, int *CSRRowPointers, int *CSCRowIndices
 }
 
 
+// based on the symbolic ILU(k) factorization in section 10.3.3 of
+// "Iterative methods for Sparse Linear Systems" by Yousef Saad
+void findIlukPattern(int Nb, const int *CSRRowPointers, const int *CSRColIndices, int fillLevel, std::vector<int>& LURowPointers, std::vector<int>& LUColIndices) {
+    // the upper part (without diagonal) of every row that is done, with the levels of fill
+    std::vector<int> UPointers(Nb + 1, 0);
+    std::vector<int> UCols, ULevels;
+    std::map<int, int> row;   // column -> level, for the row that is being processed
+
+    LURowPointers.resize(Nb + 1);
+    LURowPointers[0] = 0;
+    LUColIndices.clear();
+    LUColIndices.reserve(CSRRowPointers[Nb]);
+
+    for (int i = 0; i < Nb; ++i) {
+        row.clear();
+        for (int k = CSRRowPointers[i]; k < CSRRowPointers[i + 1]; ++k) {
+            row[CSRColIndices[k]] = 0;
+        }
+
+        // eliminate with all rows j < i in increasing order, the map can grow while iterating
+        for (auto ij = row.begin(); ij != row.end() && ij->first < i; ++ij) {
+            const int j = ij->first;
+            const int levelIJ = ij->second;
+            for (int jk = UPointers[j]; jk < UPointers[j + 1]; ++jk) {
+                const int level = levelIJ + ULevels[jk] + 1;
+                if (level <= fillLevel) {
+                    auto ik = row.find(UCols[jk]);
+                    if (ik == row.end()) {
+                        row.emplace(UCols[jk], level);
+                    } else if (level < ik->second) {
+                        ik->second = level;
+                    }
+                }
+            }
+        }
+
+        for (const auto& entry : row) {
+            LUColIndices.emplace_back(entry.first);
+            if (entry.first > i) {
+                UCols.emplace_back(entry.first);
+                ULevels.emplace_back(entry.second);
+            }
+        }
+        LURowPointers[i + 1] = LUColIndices.size();
+        UPointers[i + 1] = UCols.size();
+    }
+}
+
+// FNV-1a hash over the row pointers and column indices
+unsigned long long hashPattern(int Nb, const int *CSRRowPointers, const int *CSRColIndices) {
+    const unsigned long long prime = 1099511628211ULL;
+    unsigned long long hash = 14695981039346656037ULL;
+    auto add = [&hash, prime](int value) {
+        hash = (hash ^ static_cast<unsigned int>(value)) * prime;
+    };
+
+    add(Nb);
+    for (int i = 0; i <= Nb; ++i) {
+        add(CSRRowPointers[i]);
+    }
+    for (int k = 0; k < CSRRowPointers[Nb]; ++k) {
+        add(CSRColIndices[k]);
+    }
+    return hash;
+}
+
+int updateGraphColoring(int Nb, const int *CSRRowPointers, const int *CSRColIndices, const int *CSCColPointers, const int *CSCRowIndices, std::vector<int>& colors) {
+    // a row conflicts if it shares its color with a neighbour that comes before it,
+    // so that only one row of every conflicting pair is recolored
+    auto conflicts = [&](int i) {
+        for (int k = CSRRowPointers[i]; k < CSRRowPointers[i + 1]; ++k) {
+            int j = CSRColIndices[k];
+            if (j < i && colors[j] == colors[i]) {
+                return true;
+            }
+        }
+        for (int k = CSCColPointers[i]; k < CSCColPointers[i + 1]; ++k) {
+            int j = CSCRowIndices[k];
+            if (j < i && colors[j] == colors[i]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<int> conflicted;
+    for (int i = 0; i < Nb; ++i) {
+        if (conflicts(i)) {
+            conflicted.emplace_back(i);
+        }
+    }
+
+    // give every conflicted row the lowest color that none of its neighbours has
+    std::vector<bool> used(MAX_COLORS);
+    for (int i : conflicted) {
+        std::fill(used.begin(), used.end(), false);
+        for (int k = CSRRowPointers[i]; k < CSRRowPointers[i + 1]; ++k) {
+            int j = CSRColIndices[k];
+            if (j != i) {
+                used[colors[j]] = true;
+            }
+        }
+        for (int k = CSCColPointers[i]; k < CSCColPointers[i + 1]; ++k) {
+            int j = CSCRowIndices[k];
+            if (j != i) {
+                used[colors[j]] = true;
+            }
+        }
+        int c = 0;
+        while (c < MAX_COLORS && used[c]) {
+            ++c;
+        }
+        if (c == MAX_COLORS) {
+            return -1;
+        }
+        colors[i] = c;
+    }
+
+    // remove colors that are not used anymore
+    std::vector<int> newColor(MAX_COLORS, -1);
+    int numColors = 0;
+    for (int i = 0; i < Nb; ++i) {
+        if (newColor[colors[i]] == -1) {
+            newColor[colors[i]] = 0;
+        }
+    }
+    for (int c = 0; c < MAX_COLORS; ++c) {
+        if (newColor[c] != -1) {
+            newColor[c] = numColors++;
+        }
+    }
+    for (int i = 0; i < Nb; ++i) {
+        colors[i] = newColor[colors[i]];
+    }
+
+    return numColors;
+}
+
+const ReorderCache::Entry* ReorderCache::find(int Nb, const int *CSRRowPointers, const int *CSRColIndices) const {
+    const unsigned long long hash = hashPattern(Nb, CSRRowPointers, CSRColIndices);
+    for (const Entry& entry : entries) {
+        if (entry.hash == hash
+            && static_cast<int>(entry.rowPointers.size()) == Nb + 1
+            && std::equal(entry.rowPointers.begin(), entry.rowPointers.end(), CSRRowPointers)
+            && std::equal(entry.colIndices.begin(), entry.colIndices.end(), CSRColIndices)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const ReorderCache::Entry* ReorderCache::findSimilar(int Nb, const int *CSRRowPointers, const int *CSRColIndices, double maxChangedRows) const {
+    const int maxChanged = static_cast<int>(maxChangedRows * Nb);
+    for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+        if (static_cast<int>(entry->rowPointers.size()) != Nb + 1) {
+            continue;
+        }
+        int changed = 0;
+        for (int i = 0; i < Nb && changed <= maxChanged; ++i) {
+            const int size = CSRRowPointers[i + 1] - CSRRowPointers[i];
+            const int *oldRow = entry->colIndices.data() + entry->rowPointers[i];
+            if (size != entry->rowPointers[i + 1] - entry->rowPointers[i]
+                || !std::equal(oldRow, oldRow + size, CSRColIndices + CSRRowPointers[i])) {
+                ++changed;
+            }
+        }
+        if (changed <= maxChanged) {
+            return &(*entry);
+        }
+    }
+    return nullptr;
+}
+
+void ReorderCache::insert(Entry entry) {
+    if (entries.size() == max_entries) {
+        entries.erase(entries.begin());
+    }
+    entries.emplace_back(std::move(entry));
+}
+
+
 #define INSTANTIATE_BDA_FUNCTIONS(n)                                                                                                            \
 template int colorBlockedNodes<n>(int, const int *, const int *, const int *, const int *, std::vector<int>&, int, int);                        \
 template void reorderBlockedMatrixByPattern<n>(BlockedMatrix<n> *, int *, int *, BlockedMatrix<n> *);                                           \
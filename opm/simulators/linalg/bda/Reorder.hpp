@@ -121,6 +121,74 @@ void findGraphColoring(const int *CSRColIndices, const int *CSRRowPointers, cons
 /// \param[in] Nb                number of blockrows in the matrix
 void csrPatternToCsc(int *CSRColIndices, int *CSRRowPointers, int *CSCRowIndices, int *CSCColPointers, int Nb);
 
+/// Find the sparsity pattern of an ILU(k) decomposition, using the level of fill of every entry
+/// The level of an entry of the input pattern is 0, a fill-in entry created by eliminating with entries
+/// of levels l1 and l2 has level l1 + l2 + 1, and only entries with a level up to fillLevel are kept
+/// The diagonal must be present in every row, the column indices of the output are sorted
+/// \param[in] Nb                number of blockrows in the matrix
+/// \param[in] CSRRowPointers    row pointers of the input sparsity pattern
+/// \param[in] CSRColIndices     column indices of the input sparsity pattern, sorted per row
+/// \param[in] fillLevel         maximum level of fill
+/// \param[out] LURowPointers    row pointers of the ILU(k) pattern, contains Nb+1 values
+/// \param[out] LUColIndices     column indices of the ILU(k) pattern
+void findIlukPattern(int Nb, const int *CSRRowPointers, const int *CSRColIndices, int fillLevel, std::vector<int>& LURowPointers, std::vector<int>& LUColIndices);
+
+/// Compute a hash of a sparsity pattern stored in the CSR format, used to recognize patterns that were analysed before
+/// \param[in] Nb                number of blockrows in the matrix
+/// \param[in] CSRRowPointers    row pointers of the sparsity pattern
+/// \param[in] CSRColIndices     column indices of the sparsity pattern
+/// \return                      hash of the pattern
+unsigned long long hashPattern(int Nb, const int *CSRRowPointers, const int *CSRColIndices);
+
+/// Repair a graph coloring that was found for a slightly different sparsity pattern with the same number of rows
+/// Only rows that share a color with one of their neighbours in the new pattern are recolored
+/// The colors are renumbered afterwards, so that no color is empty
+/// \param[in] Nb               number of blockrows in the matrix
+/// \param[in] CSRRowPointers   row pointers of the new sparsity pattern stored in the CSR format
+/// \param[in] CSRColIndices    column indices of the new sparsity pattern stored in the CSR format
+/// \param[in] CSCColPointers   column pointers of the new sparsity pattern stored in the CSC format
+/// \param[in] CSCRowIndices    row indices of the new sparsity pattern stored in the CSC format
+/// \param[inout] colors        the color of every row, valid for the old pattern on input and for the new pattern on output
+/// \return                     the number of colors, or -1 if more than MAX_COLORS colors would be needed
+int updateGraphColoring(int Nb, const int *CSRRowPointers, const int *CSRColIndices, const int *CSCColPointers, const int *CSCRowIndices, std::vector<int>& colors);
+
+/// This class stores the reorderings of sparsity patterns that were analysed before
+/// The sparsity pattern changes when wells open or close with their contributions in the matrix,
+/// in that case the pattern often returns to one that was seen before, or only a few rows change
+class ReorderCache
+{
+public:
+    struct Entry {
+        unsigned long long hash;
+        std::vector<int> rowPointers, colIndices;  // the pattern itself, to detect hash collisions and changed rows
+        std::vector<int> toOrder, fromOrder, rowsPerColor;
+        int numColors;
+    };
+
+    /// Find the reordering of a pattern that was stored before
+    /// \param[in] Nb                number of blockrows in the matrix
+    /// \param[in] CSRRowPointers    row pointers of the sparsity pattern
+    /// \param[in] CSRColIndices     column indices of the sparsity pattern
+    /// \return                      the entry of this pattern, or nullptr if it is not stored
+    const Entry* find(int Nb, const int *CSRRowPointers, const int *CSRColIndices) const;
+
+    /// Find a stored pattern with the same number of rows, of which at most a fraction of the rows differ
+    /// \param[in] Nb                number of blockrows in the matrix
+    /// \param[in] CSRRowPointers    row pointers of the sparsity pattern
+    /// \param[in] CSRColIndices     column indices of the sparsity pattern
+    /// \param[in] maxChangedRows    maximum fraction of rows that may differ
+    /// \return                      the most recently stored entry that is similar enough, or nullptr
+    const Entry* findSimilar(int Nb, const int *CSRRowPointers, const int *CSRColIndices, double maxChangedRows) const;
+
+    /// Store the reordering of a pattern, the oldest entry is removed if the cache is full
+    /// \param[in] entry             the pattern and its reordering
+    void insert(Entry entry);
+
+private:
+    static constexpr unsigned int max_entries = 4;
+    std::vector<Entry> entries;      // oldest entry first
+};
+
 }
 
 #endif
\ No newline at end of file
@@ -18,8 +18,10 @@
 */
 
 #include <config.h> // CMake
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <type_traits>
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
@@ -35,6 +37,9 @@ WellContributions::WellContributions(std::string accelerator_mode){
     else if(accelerator_mode.compare("opencl") == 0){
         opencl_gpu = true;
     }
+    else if(accelerator_mode.compare("rocsparse") == 0){
+        rocsparse_gpu = true;
+    }
     else if(accelerator_mode.compare("fpga") == 0){
         // unused for FPGA, but must be defined to avoid error
     }
@@ -50,6 +55,10 @@ WellContributions::~WellContributions()
         delete ms;
     }
     multisegments.clear();
+    for (auto ms: previous_multisegments) {
+        delete ms;
+    }
+    previous_multisegments.clear();
 
 #if HAVE_CUDA
     if(cuda_gpu){
@@ -57,18 +66,59 @@ WellContributions::~WellContributions()
     }
 #endif
 
-    if(num_std_wells > 0){
-        delete[] val_pointers;
+#if HAVE_ROCSPARSE
+    if(rocsparse_gpu){
+        freeRocsparseMemory();
     }
+#endif
 
 #if HAVE_OPENCL
     if(opencl_gpu){
-        if(num_ms_wells > 0){
-            delete[] h_x;
-            delete[] h_y;
+        if (h_std_values != nullptr) {
+            queue->enqueueUnmapMemObject(h_std_values_pinned, h_std_values);
+            queue->finish();
         }
+        delete[] h_x;
+        delete[] h_y;
+    }
+#endif
+}
+
+void WellContributions::reset()
+{
+    // keep the MultisegmentWellContributions of the last solve around,
+    // their symbolic factorizations can be reused if the wells are added again
+    for (auto ms: previous_multisegments) {
+        delete ms;
     }
+    previous_multisegments = std::move(multisegments);
+    multisegments.clear();
+    num_ms_wells = 0;
+#if HAVE_OPENCL
+    mswells_prepared = false;
+    mswells_on_gpu = false;
 #endif
+#if HAVE_ROCSPARSE
+    stdwells_prepared_hip = false;
+#endif
+
+    num_blocks = 0;
+    num_std_wells = 0;
+    num_blocks_so_far = 0;
+    num_std_wells_so_far = 0;
+    allocated = false;
+}
+
+unsigned int WellContributions::numStandardWellValues() const
+{
+    return 2 * allocated_num_blocks * dim * dim_wells + allocated_num_std_wells * dim_wells * dim_wells;
+}
+
+void WellContributions::setStandardWellPointers()
+{
+    h_Cnnzs = h_std_values;
+    h_Dnnzs = h_Cnnzs + allocated_num_blocks * dim * dim_wells;
+    h_Bnnzs = h_Dnnzs + allocated_num_std_wells * dim_wells * dim_wells;
 }
 
 #if HAVE_OPENCL
@@ -78,9 +128,13 @@ void WellContributions::setOpenCLEnv(cl::Context *context_, cl::CommandQueue *qu
 }
 
 void WellContributions::setKernel(bda::stdwell_apply_kernel_type *kernel_,
-                                  bda::stdwell_apply_no_reorder_kernel_type *kernel_no_reorder_){
+                                  bda::stdwell_apply_no_reorder_kernel_type *kernel_no_reorder_,
+                                  bda::mswell_apply_kernel_type *mswell_kernel_,
+                                  bda::mswell_apply_no_reorder_kernel_type *mswell_kernel_no_reorder_){
     this->kernel = kernel_;
     this->kernel_no_reorder = kernel_no_reorder_;
+    this->mswell_kernel = mswell_kernel_;
+    this->mswell_kernel_no_reorder = mswell_kernel_no_reorder_;
 }
 
 void WellContributions::setReordering(int *h_toOrder_, bool reorder_)
@@ -108,7 +162,91 @@ void WellContributions::apply_stdwells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffe
     event.wait();
 }
 
-void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y){
+void WellContributions::prepare_mswells(){
+    mswells_prepared = true;
+
+    std::vector<double> Bvals, Cvals, band;
+    std::vector<unsigned int> Bcols, Brows(1, 0), row_offsets(1, 0), band_offsets, bandwidths;
+    std::vector<int> pivots;
+    std::vector<double> well_band;
+    std::vector<int> well_pivots;
+    for (MultisegmentWellContribution *well : multisegments) {
+        unsigned int kl, ku;
+        if (!well->factorizeBanded(well_band, well_pivots, kl, ku)) {
+            OpmLog::warning("WellContributions: could not factorize D of a MultisegmentWell, applying MultisegmentWells on CPU");
+            return;
+        }
+        band_offsets.push_back(band.size());
+        bandwidths.push_back(kl);
+        bandwidths.push_back(ku);
+        band.insert(band.end(), well_band.begin(), well_band.end());
+        pivots.insert(pivots.end(), well_pivots.begin(), well_pivots.end());
+
+        // the rowpointers of a well start at 0, shift them to its position in the concatenation
+        const unsigned int block_offset = Bcols.size();
+        const auto& rows = well->getBrows();
+        for (unsigned int row = 1; row < rows.size(); ++row) {
+            Brows.push_back(rows[row] + block_offset);
+        }
+        Bcols.insert(Bcols.end(), well->getBcols().begin(), well->getBcols().end());
+        Bvals.insert(Bvals.end(), well->getBvals().begin(), well->getBvals().end());
+        Cvals.insert(Cvals.end(), well->getCvals().begin(), well->getCvals().end());
+        row_offsets.push_back(row_offsets.back() + well->getNumBlockRows());
+    }
+
+    auto upload = [this](std::unique_ptr<cl::Buffer>& buffer, const auto& values) {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        // OpenCL does not allow buffers of size 0, wells without perforations have no B and C
+        buffer = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_ONLY, sizeof(T) * std::max(values.size(), std::size_t{1}));
+        if (!values.empty()) {
+            events.emplace_back();
+            queue->enqueueWriteBuffer(*buffer, CL_FALSE, 0, sizeof(T) * values.size(), values.data(), nullptr, &events.back());
+        }
+    };
+    upload(d_ms_Bvals, Bvals);
+    upload(d_ms_Cvals, Cvals);
+    upload(d_ms_Bcols, Bcols);
+    upload(d_ms_Brows, Brows);
+    upload(d_ms_row_offsets, row_offsets);
+    upload(d_ms_band, band);
+    upload(d_ms_band_offsets, band_offsets);
+    upload(d_ms_bandwidths, bandwidths);
+    upload(d_ms_pivots, pivots);
+    const unsigned int dim_wells_ms = multisegments.front()->getDimWells();
+    d_ms_z = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * std::max(row_offsets.back() * dim_wells_ms, 1u));
+    cl::WaitForEvents(events);
+    events.clear();
+
+    mswells_on_gpu = true;
+}
+
+void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder){
+    if (!mswells_prepared) {
+        prepare_mswells();
+    }
+
+    if (mswells_on_gpu) {
+        const unsigned int work_group_size = 32;
+        const unsigned int total_work_items = num_ms_wells * work_group_size;
+        const unsigned int dim_ms = multisegments.front()->getDim();
+        const unsigned int dim_wells_ms = multisegments.front()->getDimWells();
+
+        cl::Event event;
+        if (reorder) {
+            event = (*mswell_kernel)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)),
+                                     *d_ms_Bvals, *d_ms_Cvals, *d_ms_Bcols, *d_ms_Brows, *d_ms_row_offsets,
+                                     *d_ms_band, *d_ms_band_offsets, *d_ms_bandwidths, *d_ms_pivots, *d_ms_z,
+                                     d_x, d_y, d_toOrder, dim_ms, dim_wells_ms);
+        } else {
+            event = (*mswell_kernel_no_reorder)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)),
+                                     *d_ms_Bvals, *d_ms_Cvals, *d_ms_Bcols, *d_ms_Brows, *d_ms_row_offsets,
+                                     *d_ms_band, *d_ms_band_offsets, *d_ms_bandwidths, *d_ms_pivots, *d_ms_z,
+                                     d_x, d_y, dim_ms, dim_wells_ms);
+        }
+        event.wait();
+        return;
+    }
+
     if(h_x == nullptr){
         h_x = new double[N];
         h_y = new double[N];
@@ -139,7 +277,7 @@ void WellContributions::apply(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrd
     }
 
     if(num_ms_wells > 0){
-        apply_mswells(d_x, d_y);
+        apply_mswells(d_x, d_y, d_toOrder);
     }
 }
 #endif
@@ -150,61 +288,93 @@ void WellContributions::addMatrix([[maybe_unused]] MatrixType type, [[maybe_unus
         OPM_THROW(std::logic_error, "Error cannot add wellcontribution before allocating memory in WellContributions");
     }
 
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
+    // copy to the staging area, the columnindices are only copied to the GPU if they changed
+    auto stageCols = [this](std::vector<int>& cols, int *colIndices_, unsigned int val_size_) {
+        int *dst = cols.data() + num_blocks_so_far;
+        if (!std::equal(colIndices_, colIndices_ + val_size_, dst)) {
+            std::copy(colIndices_, colIndices_ + val_size_, dst);
+            std_structure_changed = true;
+        }
+    };
+
+    switch (type) {
+    case MatrixType::C:
+        memcpy(h_Cnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells);
+        stageCols(h_Ccols, colIndices, val_size);
+        break;
+
+    case MatrixType::D:
+        memcpy(h_Dnnzs + num_std_wells_so_far * dim_wells * dim_wells, values, sizeof(double) * dim_wells * dim_wells);
+        break;
+
+    case MatrixType::B:
+        memcpy(h_Bnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells);
+        stageCols(h_Bcols, colIndices, val_size);
+        if (val_pointers[num_std_wells_so_far] != num_blocks_so_far) {
+            val_pointers[num_std_wells_so_far] = num_blocks_so_far;
+            std_structure_changed = true;
+        }
+        break;
+
+    default:
+        OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
+    }
+
+    if(MatrixType::B == type) {
+        num_blocks_so_far += val_size;
+        num_std_wells_so_far++;
+        if (num_std_wells_so_far == num_std_wells) {
+            copyStandardWellsToDevice();
+        }
+    }
+#else
+    OPM_THROW(std::logic_error, "Error cannot add StandardWell matrix on GPU because neither CUDA, OpenCL nor rocsparse were found by cmake");
+#endif
+}
+
+void WellContributions::copyStandardWellsToDevice()
+{
+    val_pointers[num_std_wells] = num_blocks;
+
 #if HAVE_CUDA
     if(cuda_gpu){
-        addMatrixGpu(type, colIndices, values, val_size);
+        copyStandardWellsToDeviceGpu();
+    }
+#endif
+
+#if HAVE_ROCSPARSE
+    if(rocsparse_gpu){
+        // copied in the next apply_rocsparse(), when the number of cells is known
+        stdwells_prepared_hip = false;
+        hip_structure_changed = hip_structure_changed || std_structure_changed;
     }
 #endif
 
 #if HAVE_OPENCL
     if(opencl_gpu){
-        switch (type) {
-        case MatrixType::C:
-            events.resize(2);
-            queue->enqueueWriteBuffer(*d_Cnnzs_ocl, CL_FALSE, sizeof(double) * num_blocks_so_far * dim * dim_wells, sizeof(double) * val_size * dim * dim_wells, values, nullptr, &events[0]);
-            queue->enqueueWriteBuffer(*d_Ccols_ocl, CL_FALSE, sizeof(int) * num_blocks_so_far, sizeof(int) * val_size, colIndices, nullptr, &events[1]);
-            cl::WaitForEvents(events);
-            events.clear();
-            break;
-
-        case MatrixType::D:
-            events.resize(1);
-            queue->enqueueWriteBuffer(*d_Dnnzs_ocl, CL_FALSE, sizeof(double) * num_std_wells_so_far * dim_wells * dim_wells, sizeof(double) * dim_wells * dim_wells, values, nullptr, &events[0]);
-            events[0].wait();
-            events.clear();
-            break;
-
-        case MatrixType::B:
-            events.resize(2);
-            queue->enqueueWriteBuffer(*d_Bnnzs_ocl, CL_FALSE, sizeof(double) * num_blocks_so_far * dim * dim_wells, sizeof(double) * val_size * dim * dim_wells, values, nullptr, &events[0]);
-            queue->enqueueWriteBuffer(*d_Bcols_ocl, CL_FALSE, sizeof(int) * num_blocks_so_far, sizeof(int) * val_size, colIndices, nullptr, &events[1]);
-            cl::WaitForEvents(events);
-            events.clear();
-
-            val_pointers[num_std_wells_so_far] = num_blocks_so_far;
-            if (num_std_wells_so_far == num_std_wells - 1) {
-                val_pointers[num_std_wells] = num_blocks;
-                events.resize(1);
-                queue->enqueueWriteBuffer(*d_val_pointers_ocl, CL_FALSE, 0, sizeof(unsigned int) * (num_std_wells + 1), val_pointers, nullptr, &events[0]);
-                events[0].wait();
-                events.clear();
-            }
-            break;
-
-        default:
-            OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
+        const unsigned int num_vals = num_blocks * dim * dim_wells;
+        events.resize(3);
+        queue->enqueueWriteBuffer(*d_Cnnzs_ocl, CL_FALSE, 0, sizeof(double) * num_vals, h_Cnnzs, nullptr, &events[0]);
+        queue->enqueueWriteBuffer(*d_Dnnzs_ocl, CL_FALSE, 0, sizeof(double) * num_std_wells * dim_wells * dim_wells, h_Dnnzs, nullptr, &events[1]);
+        queue->enqueueWriteBuffer(*d_Bnnzs_ocl, CL_FALSE, 0, sizeof(double) * num_vals, h_Bnnzs, nullptr, &events[2]);
+        if (std_structure_changed) {
+            events.resize(6);
+            queue->enqueueWriteBuffer(*d_Ccols_ocl, CL_FALSE, 0, sizeof(int) * num_blocks, h_Ccols.data(), nullptr, &events[3]);
+            queue->enqueueWriteBuffer(*d_Bcols_ocl, CL_FALSE, 0, sizeof(int) * num_blocks, h_Bcols.data(), nullptr, &events[4]);
+            queue->enqueueWriteBuffer(*d_val_pointers_ocl, CL_FALSE, 0, sizeof(unsigned int) * (num_std_wells + 1), val_pointers.data(), nullptr, &events[5]);
         }
+        cl::WaitForEvents(events);
+        events.clear();
     }
 #endif
 
-    if(MatrixType::B == type) {
-        num_blocks_so_far += val_size;
-        num_std_wells_so_far++;
-    }
+    std_structure_changed = false;
+}
 
-#if !HAVE_CUDA && !HAVE_OPENCL
-    OPM_THROW(std::logic_error, "Error cannot add StandardWell matrix on GPU because neither CUDA nor OpenCL were found by cmake");
-#endif
+void WellContributions::setVectorSize(unsigned int N_)
+{
+    N = N_;
 }
 
 void WellContributions::setBlockSize(unsigned int dim_, unsigned int dim_wells_)
@@ -231,24 +401,52 @@ void WellContributions::addNumBlocks(unsigned int numBlocks)
 void WellContributions::alloc()
 {
     if (num_std_wells > 0) {
-        val_pointers = new unsigned int[num_std_wells + 1];
+        if (num_std_wells != allocated_num_std_wells || num_blocks != allocated_num_blocks) {
+#if HAVE_CUDA
+            if(cuda_gpu){
+                freeStandardWells();
+            }
+#endif
+            allocated_num_std_wells = num_std_wells;
+            allocated_num_blocks = num_blocks;
+            val_pointers.assign(num_std_wells + 1, 0);
+            h_Ccols.assign(num_blocks, -1);
+            h_Bcols.assign(num_blocks, -1);
+            std_structure_changed = true;
 
 #if HAVE_CUDA
-        if(cuda_gpu){
-            allocStandardWells();
-        }
+            if(cuda_gpu){
+                allocStandardWells();
+            }
+#endif
+
+#if HAVE_ROCSPARSE
+            if(rocsparse_gpu){
+                if (h_std_values != nullptr) {
+                    hipHostFree(h_std_values);
+                }
+                hipHostMalloc((void**)&h_std_values, sizeof(double) * numStandardWellValues());
+            }
 #endif
 
 #if HAVE_OPENCL
-        if(opencl_gpu){
-            d_Cnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_blocks * dim * dim_wells);
-            d_Dnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_std_wells * dim_wells * dim_wells);
-            d_Bnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_blocks * dim * dim_wells);
-            d_Ccols_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(int) * num_blocks);
-            d_Bcols_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(int) * num_blocks);
-            d_val_pointers_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(unsigned int) * (num_std_wells + 1));
-        }
+            if(opencl_gpu){
+                if (h_std_values != nullptr) {
+                    queue->enqueueUnmapMemObject(h_std_values_pinned, h_std_values);
+                }
+                // the staging buffer stays mapped, so it can be written by the CPU at any time
+                h_std_values_pinned = cl::Buffer(*context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, sizeof(double) * numStandardWellValues());
+                h_std_values = static_cast<double*>(queue->enqueueMapBuffer(h_std_values_pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, sizeof(double) * numStandardWellValues()));
+                d_Cnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_blocks * dim * dim_wells);
+                d_Dnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_std_wells * dim_wells * dim_wells);
+                d_Bnnzs_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * num_blocks * dim * dim_wells);
+                d_Ccols_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(int) * num_blocks);
+                d_Bcols_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(int) * num_blocks);
+                d_val_pointers_ocl = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(unsigned int) * (num_std_wells + 1));
+            }
 #endif
+            setStandardWellPointers();
+        }
         allocated = true;
     }
 }
@@ -260,7 +458,20 @@ void WellContributions::addMultisegmentWellContribution(unsigned int dim_, unsig
         std::vector<double> &Cvalues)
 {
     assert(dim==dim_);
-    MultisegmentWellContribution *well = new MultisegmentWellContribution(dim_, dim_wells_, Mb, Bvalues, BcolIndices, BrowPointers, DnumBlocks, Dvalues, DcolPointers, DrowIndices, Cvalues);
+    // the wells are added in the same order every linear solve, reuse the object
+    // of the previous solve if D has the same sparsity pattern
+    MultisegmentWellContribution *well = nullptr;
+    if (num_ms_wells < previous_multisegments.size()) {
+        MultisegmentWellContribution *&previous = previous_multisegments[num_ms_wells];
+        if (previous != nullptr && previous->sameDPattern(dim_wells_, Mb, DnumBlocks, DcolPointers, DrowIndices)) {
+            well = previous;
+            previous = nullptr;
+            well->update(Bvalues, BcolIndices, BrowPointers, Dvalues, Cvalues);
+        }
+    }
+    if (well == nullptr) {
+        well = new MultisegmentWellContribution(dim_, dim_wells_, Mb, Bvalues, BcolIndices, BrowPointers, DnumBlocks, Dvalues, DcolPointers, DrowIndices, Cvalues);
+    }
     multisegments.emplace_back(well);
     ++num_ms_wells;
 }
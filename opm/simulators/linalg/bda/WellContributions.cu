@@ -127,6 +127,7 @@ __global__ void apply_well_contributions(
 
 void WellContributions::allocStandardWells()
 {
+    cudaMallocHost((void**)&h_std_values, sizeof(double) * numStandardWellValues());
     cudaMalloc((void**)&d_Cnnzs, sizeof(double) * num_blocks * dim * dim_wells);
     cudaMalloc((void**)&d_Dnnzs, sizeof(double) * num_std_wells * dim_wells * dim_wells);
     cudaMalloc((void**)&d_Bnnzs, sizeof(double) * num_blocks * dim * dim_wells);
@@ -136,18 +137,25 @@ void WellContributions::allocStandardWells()
     cudaCheckLastError("apply_gpu malloc failed");
 }
 
-void WellContributions::freeCudaMemory() {
-    // delete data for StandardWell
-    if (num_std_wells > 0) {
+void WellContributions::freeStandardWells()
+{
+    if (h_std_values != nullptr) {
+        cudaFreeHost(h_std_values);
         cudaFree(d_Cnnzs);
         cudaFree(d_Dnnzs);
         cudaFree(d_Bnnzs);
         cudaFree(d_Ccols);
         cudaFree(d_Bcols);
         cudaFree(d_val_pointers);
+        h_std_values = nullptr;
     }
+}
 
-    if (num_ms_wells > 0 && h_x) {
+void WellContributions::freeCudaMemory() {
+    // delete data for StandardWell
+    freeStandardWells();
+
+    if (h_x) {
         cudaFreeHost(h_x);
         cudaFreeHost(h_y);
         h_x = h_y = nullptr; // Mark as free for constructor
@@ -160,10 +168,7 @@ void WellContributions::freeCudaMemory() {
 void WellContributions::apply(double *d_x, double *d_y)
 {
     // apply MultisegmentWells
-
-    // make sure the stream is empty if timing measurements are done
-    cudaStreamSynchronize(stream);
-
+    // StandardWells do not synchronize the stream, so they can be captured in a CUDA graph
     if (num_ms_wells > 0) {
         // allocate pinned memory on host if not yet done
         if (h_x == nullptr) {
@@ -194,29 +199,18 @@ void WellContributions::apply(double *d_x, double *d_y)
 }
 
 
-void WellContributions::addMatrixGpu(MatrixType type, int *colIndices, double *values, unsigned int val_size)
+void WellContributions::copyStandardWellsToDeviceGpu()
 {
-    switch (type) {
-    case MatrixType::C:
-        cudaMemcpy(d_Cnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
-        cudaMemcpy(d_Ccols + num_blocks_so_far, colIndices, sizeof(int) * val_size, cudaMemcpyHostToDevice);
-        break;
-    case MatrixType::D:
-        cudaMemcpy(d_Dnnzs + num_std_wells_so_far * dim_wells * dim_wells, values, sizeof(double) * dim_wells * dim_wells, cudaMemcpyHostToDevice);
-        break;
-    case MatrixType::B:
-        cudaMemcpy(d_Bnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
-        cudaMemcpy(d_Bcols + num_blocks_so_far, colIndices, sizeof(int) * val_size, cudaMemcpyHostToDevice);
-        val_pointers[num_std_wells_so_far] = num_blocks_so_far;
-        if (num_std_wells_so_far == num_std_wells - 1) {
-            val_pointers[num_std_wells] = num_blocks;
-            cudaMemcpy(d_val_pointers, val_pointers, sizeof(unsigned int) * (num_std_wells + 1), cudaMemcpyHostToDevice);
-        }
-        break;
-    default:
-        OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
+    // the host data is pinned, so these are direct DMA transfers
+    cudaMemcpy(d_Cnnzs, h_Cnnzs, sizeof(double) * num_blocks * dim * dim_wells, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Dnnzs, h_Dnnzs, sizeof(double) * num_std_wells * dim_wells * dim_wells, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Bnnzs, h_Bnnzs, sizeof(double) * num_blocks * dim * dim_wells, cudaMemcpyHostToDevice);
+    if (std_structure_changed) {
+        cudaMemcpy(d_Ccols, h_Ccols.data(), sizeof(int) * num_blocks, cudaMemcpyHostToDevice);
+        cudaMemcpy(d_Bcols, h_Bcols.data(), sizeof(int) * num_blocks, cudaMemcpyHostToDevice);
+        cudaMemcpy(d_val_pointers, val_pointers.data(), sizeof(unsigned int) * (num_std_wells + 1), cudaMemcpyHostToDevice);
     }
-    cudaCheckLastError("WellContributions::addMatrix() failed");
+    cudaCheckLastError("WellContributions::copyStandardWellsToDeviceGpu() failed");
 }
 
 void WellContributions::setCudaStream(cudaStream_t stream_)
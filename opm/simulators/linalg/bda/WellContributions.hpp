@@ -24,6 +24,11 @@
 #include <cuda_runtime.h>
 #endif
 
+#if HAVE_ROCSPARSE
+#include <hip/hip_runtime_api.h>
+#include <rocsparse.h>
+#endif
+
 #if HAVE_OPENCL
 #include <opm/simulators/linalg/bda/opencl.hpp>
 #include <opm/simulators/linalg/bda/openclKernels.hpp>
@@ -43,7 +48,9 @@ namespace Opm
 /// This class serves to eliminate the need to include the WellContributions into the matrix (with --matrix-add-well-contributions=true) for the cusparseSolver
 /// If the --matrix-add-well-contributions commandline parameter is true, this class should not be used
 /// So far, StandardWell and MultisegmentWell are supported
-/// StandardWells are only supported for cusparseSolver (CUDA), MultisegmentWells are supported for both cusparseSolver and openclSolver
+/// StandardWells are supported for cusparseSolver (CUDA), openclSolver and rocsparseSolver (HIP), MultisegmentWells for all three
+/// The openclSolver applies all MultisegmentWells on GPU, the cusparseSolver and the rocsparseSolver apply them on CPU
+/// The rocsparseSolver applies the StandardWells with three general BSR products of rocSPARSE, see apply_rocsparse()
 /// A single instance (or pointer) of this class is passed to the BdaSolver.
 /// For StandardWell, this class contains all the data and handles the computation. For MultisegmentWell, the vector 'multisegments' contains all the data. For more information, check the MultisegmentWellContribution class.
 
@@ -57,6 +64,10 @@ namespace Opm
 /// - get total size of all wellcontributions that must be stored here
 /// - allocate memory
 /// - copy data of wellcontributions
+/// An object can be reused for the next linear system after calling reset(). The StandardWell data is staged in
+/// pinned host memory at fixed offsets per well, and is copied to the GPU with one transfer per array when the last
+/// well is added. As long as the number of StandardWells and their numbers of blocks do not change, the host and
+/// GPU memory is kept, and the columnindices are only copied again when they changed.
 class WellContributions
 {
 public:
@@ -75,6 +86,7 @@ public:
 private:
     bool opencl_gpu = false;
     bool cuda_gpu = false;
+    bool rocsparse_gpu = false;
     bool allocated = false;
 
     unsigned int N;                          // number of rows (not blockrows) in vectors x and y
@@ -85,11 +97,32 @@ private:
     unsigned int num_ms_wells = 0;           // number of MultisegmentWells in this object, must equal multisegments.size()
     unsigned int num_blocks_so_far = 0;      // keep track of where next data is written
     unsigned int num_std_wells_so_far = 0;   // keep track of where next data is written
-    unsigned int *val_pointers = nullptr;    // val_pointers[wellID] == index of first block for this well in Ccols and Bcols
+    unsigned int allocated_num_blocks = 0;   // sizes the StandardWell memory is currently allocated for
+    unsigned int allocated_num_std_wells = 0;
+    bool std_structure_changed = true;       // columnindices or val_pointers must be copied to the GPU
+    std::vector<unsigned int> val_pointers;  // val_pointers[wellID] == index of first block for this well in Ccols and Bcols
+    std::vector<int> h_Ccols, h_Bcols;       // columnindices of the StandardWells, as last copied to the GPU
+
+    // pinned host memory for the values of the StandardWells, contains C, D and B after each other
+    double *h_std_values = nullptr;
+    double *h_Cnnzs = nullptr;               // point into h_std_values
+    double *h_Dnnzs = nullptr;
+    double *h_Bnnzs = nullptr;
+
+    /// Number of doubles in h_std_values
+    unsigned int numStandardWellValues() const;
+
+    /// Point h_Cnnzs, h_Dnnzs and h_Bnnzs into h_std_values
+    void setStandardWellPointers();
+
+    /// Copy the staged StandardWell data to the GPU, called when the last StandardWell is added
+    void copyStandardWellsToDevice();
 
     double *h_x = nullptr;
     double *h_y = nullptr;
     std::vector<MultisegmentWellContribution*> multisegments;
+    // MultisegmentWellContributions of the previous solve, reused when the sparsity pattern of D is unchanged
+    std::vector<MultisegmentWellContribution*> previous_multisegments;
 
 #if HAVE_OPENCL
     cl::Context *context;
@@ -101,9 +134,24 @@ private:
     std::unique_ptr<cl::Buffer> d_Cnnzs_ocl, d_Dnnzs_ocl, d_Bnnzs_ocl;
     std::unique_ptr<cl::Buffer> d_Ccols_ocl, d_Bcols_ocl;
     std::unique_ptr<cl::Buffer> d_val_pointers_ocl;
+    cl::Buffer h_std_values_pinned;          // h_std_values is the mapped pointer of this buffer
+
+    // data for MultisegmentWells, all wells are concatenated so they can be applied in one kernel launch
+    bda::mswell_apply_kernel_type *mswell_kernel = nullptr;
+    bda::mswell_apply_no_reorder_kernel_type *mswell_kernel_no_reorder = nullptr;
+    bool mswells_on_gpu = false;             // false until uploaded, or if a D could not be factorized
+    bool mswells_prepared = false;
+    std::unique_ptr<cl::Buffer> d_ms_Bvals, d_ms_Cvals, d_ms_Bcols, d_ms_Brows;
+    std::unique_ptr<cl::Buffer> d_ms_row_offsets;   // first blockrow of every well in Brows, num_ms_wells+1 values
+    std::unique_ptr<cl::Buffer> d_ms_band, d_ms_band_offsets, d_ms_bandwidths, d_ms_pivots;
+    std::unique_ptr<cl::Buffer> d_ms_z;             // B*x and D^-1*B*x for all wells
 
     bool reorder = false;
     int *h_toOrder = nullptr;
+
+    /// Factorize the D matrices of all MultisegmentWells and copy the wells to the GPU
+    /// If one of the factorizations fails, the MultisegmentWells are applied on CPU instead
+    void prepare_mswells();
 #endif
 
 #if HAVE_CUDA
@@ -119,18 +167,46 @@ private:
     double *d_z2 = nullptr;
     unsigned int *d_val_pointers = nullptr;
 
-    /// Allocate GPU memory for StandardWells
+    /// Allocate GPU memory and pinned host memory for StandardWells
     void allocStandardWells();
 
+    /// Free GPU memory and pinned host memory of the StandardWells
+    void freeStandardWells();
+
     /// Free GPU memory allocated with cuda.
     void freeCudaMemory();
 
-    /// Store a matrix in this object, in blocked csr format, can only be called after alloc() is called
-    /// \param[in] type        indicate if C, D or B is sent
-    /// \param[in] colIndices  columnindices of blocks in C or B, ignored for D
-    /// \param[in] values      array of nonzeroes
-    /// \param[in] val_size    number of blocks in C or B, ignored for D
-    void addMatrixGpu(MatrixType type, int *colIndices, double *values, unsigned int val_size);
+    /// Copy the staged StandardWell data to the GPU
+    void copyStandardWellsToDeviceGpu();
+#endif
+
+#if HAVE_ROCSPARSE
+    rocsparse_handle rocsparse_handle_ = nullptr;
+    hipStream_t hip_stream = nullptr;
+    rocsparse_mat_descr descr_wells = nullptr;
+
+    // the StandardWells as general BSR matrices: B with a blockrow per well, D^-1 block diagonal,
+    // and C^T with a blockrow per cell, which is transposed on the CPU
+    double *d_B_hip = nullptr, *d_Dinv_hip = nullptr, *d_CT_hip = nullptr;
+    int *d_Brows_hip = nullptr, *d_Bcols_hip = nullptr;
+    int *d_Drows_hip = nullptr, *d_Dcols_hip = nullptr;
+    int *d_CTrows_hip = nullptr, *d_CTcols_hip = nullptr;
+    double *d_z1_hip = nullptr, *d_z2_hip = nullptr;  // B*x and D^-1*B*x
+    unsigned int hip_num_blocks = 0;                  // sizes the GPU memory is currently allocated for
+    unsigned int hip_num_std_wells = 0;
+    unsigned int hip_Nb = 0;
+    std::vector<int> h_CTrows, h_CTcols;
+    std::vector<unsigned int> CT_blocks;              // block of C for every block of C^T
+    std::vector<double> h_CTvals;
+    bool stdwells_prepared_hip = false;
+    bool hip_structure_changed = true;
+
+    /// Transpose C and copy the StandardWells to the GPU, called in the first apply after the wells are added,
+    /// since the number of cells is needed for C^T
+    void prepare_stdwells_rocsparse();
+
+    /// Free GPU memory and pinned host memory allocated with HIP
+    void freeRocsparseMemory();
 #endif
 
 public:
@@ -146,9 +222,22 @@ public:
     void apply(double *d_x, double *d_y);
 #endif
 
+#if HAVE_ROCSPARSE
+    /// Set the rocsparse handle and the hipStream it uses
+    void setRocsparseHandle(rocsparse_handle handle, hipStream_t stream);
+
+    /// Apply all Wells in this object
+    /// performs y -= (C^T * (D^-1 * (B*x))) for all Wells
+    /// \param[in] d_x        vector x, must be on GPU
+    /// \param[inout] d_y     vector y, must be on GPU
+    void apply_rocsparse(double *d_x, double *d_y);
+#endif
+
 #if HAVE_OPENCL
     void setKernel(bda::stdwell_apply_kernel_type *kernel_,
-                   bda::stdwell_apply_no_reorder_kernel_type *kernel_no_reorder_);
+                   bda::stdwell_apply_no_reorder_kernel_type *kernel_no_reorder_,
+                   bda::mswell_apply_kernel_type *mswell_kernel_,
+                   bda::mswell_apply_no_reorder_kernel_type *mswell_kernel_no_reorder_);
     void setOpenCLEnv(cl::Context *context_, cl::CommandQueue *queue_);
 
     /// Since the rows of the matrix are reordered, the columnindices of the matrixdata is incorrect
@@ -157,21 +246,35 @@ public:
     /// \param[in] reorder    whether reordering is actually used or not
     void setReordering(int *toOrder, bool reorder);
     void apply_stdwells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
-    void apply_mswells(cl::Buffer d_x, cl::Buffer d_y);
+
+    /// Apply all MultisegmentWells with a single kernel launch, D is applied with a banded LU decomposition
+    void apply_mswells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
     void apply(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
 #endif
 
+    /// Set the number of rows (not blockrows) of the vectors x and y
+    /// \param[in] N          number of rows
+    void setVectorSize(unsigned int N);
+
     unsigned int getNumWells(){
         return num_std_wells + num_ms_wells;
     }
 
+    unsigned int getNumMultisegmentWells(){
+        return num_ms_wells;
+    }
+
     /// Indicate how large the next StandardWell is, this function cannot be called after alloc() is called
     /// \param[in] numBlocks   number of blocks in C and B of next StandardWell
     void addNumBlocks(unsigned int numBlocks);
 
-    /// Allocate memory for the StandardWells
+    /// Allocate memory for the StandardWells, existing memory is reused if the sizes did not change since the last alloc()
     void alloc();
 
+    /// Remove all wells, so that the contributions of the next linear system can be added
+    /// The memory of the StandardWells is kept for reuse
+    void reset();
+
     /// Create a new WellContributions
     WellContributions(std::string accelerator_mode);
 
@@ -184,6 +287,7 @@ public:
     void setBlockSize(unsigned int dim, unsigned int dim_wells);
 
     /// Store a matrix in this object, in blocked csr format, can only be called after alloc() is called
+    /// The matrices of one well must be added in the order C, D, B
     /// \param[in] type        indicate if C, D or B is sent
     /// \param[in] colIndices  columnindices of blocks in C or B, ignored for D
     /// \param[in] values      array of nonzeroes
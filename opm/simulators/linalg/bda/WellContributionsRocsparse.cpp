@@ -0,0 +1,206 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h> // CMake
+#include <numeric>
+#include <vector>
+
+#include <opm/simulators/linalg/bda/rocsparse_header.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+namespace Opm
+{
+
+void WellContributions::setRocsparseHandle(rocsparse_handle handle, hipStream_t stream_)
+{
+    rocsparse_handle_ = handle;
+    hip_stream = stream_;
+    if (descr_wells == nullptr) {
+        ROCSPARSE_CHECK(rocsparse_create_mat_descr(&descr_wells));
+    }
+}
+
+void WellContributions::freeRocsparseMemory()
+{
+    hipFree(d_B_hip);
+    hipFree(d_Dinv_hip);
+    hipFree(d_CT_hip);
+    hipFree(d_Brows_hip);
+    hipFree(d_Bcols_hip);
+    hipFree(d_Drows_hip);
+    hipFree(d_Dcols_hip);
+    hipFree(d_CTrows_hip);
+    hipFree(d_CTcols_hip);
+    hipFree(d_z1_hip);
+    hipFree(d_z2_hip);
+    d_B_hip = d_Dinv_hip = d_CT_hip = d_z1_hip = d_z2_hip = nullptr;
+    d_Brows_hip = d_Bcols_hip = d_Drows_hip = d_Dcols_hip = d_CTrows_hip = d_CTcols_hip = nullptr;
+    hip_num_blocks = hip_num_std_wells = hip_Nb = 0;
+
+    if (h_std_values != nullptr) {
+        hipHostFree(h_std_values);
+        h_std_values = nullptr;
+    }
+    if (h_x) {
+        hipHostFree(h_x);
+        hipHostFree(h_y);
+        h_x = h_y = nullptr;
+    }
+    if (descr_wells != nullptr) {
+        rocsparse_destroy_mat_descr(descr_wells);
+        descr_wells = nullptr;
+    }
+}
+
+void WellContributions::prepare_stdwells_rocsparse()
+{
+    const unsigned int Nb = N / dim;
+    const unsigned int block_vals = dim * dim_wells;
+
+    if (hip_structure_changed || Nb != hip_Nb) {
+        // C^T has a blockrow for every cell, with a block for every StandardWell perforating it
+        h_CTrows.assign(Nb + 1, 0);
+        for (unsigned int b = 0; b < num_blocks; ++b) {
+            ++h_CTrows[h_Ccols[b] + 1];
+        }
+        std::partial_sum(h_CTrows.begin(), h_CTrows.end(), h_CTrows.begin());
+        h_CTcols.resize(num_blocks);
+        CT_blocks.resize(num_blocks);
+        std::vector<int> next(h_CTrows.begin(), h_CTrows.end() - 1);
+        for (unsigned int well = 0; well < num_std_wells; ++well) {
+            for (unsigned int b = val_pointers[well]; b < val_pointers[well + 1]; ++b) {
+                const int k = next[h_Ccols[b]]++;
+                h_CTcols[k] = well;
+                CT_blocks[k] = b;
+            }
+        }
+
+        if (num_blocks != hip_num_blocks || num_std_wells != hip_num_std_wells || Nb != hip_Nb) {
+            hipFree(d_B_hip);
+            hipFree(d_Dinv_hip);
+            hipFree(d_CT_hip);
+            hipFree(d_Brows_hip);
+            hipFree(d_Bcols_hip);
+            hipFree(d_Drows_hip);
+            hipFree(d_Dcols_hip);
+            hipFree(d_CTrows_hip);
+            hipFree(d_CTcols_hip);
+            hipFree(d_z1_hip);
+            hipFree(d_z2_hip);
+            HIP_CHECK(hipMalloc((void**)&d_B_hip, sizeof(double) * num_blocks * block_vals));
+            HIP_CHECK(hipMalloc((void**)&d_Dinv_hip, sizeof(double) * num_std_wells * dim_wells * dim_wells));
+            HIP_CHECK(hipMalloc((void**)&d_CT_hip, sizeof(double) * num_blocks * block_vals));
+            HIP_CHECK(hipMalloc((void**)&d_Brows_hip, sizeof(int) * (num_std_wells + 1)));
+            HIP_CHECK(hipMalloc((void**)&d_Bcols_hip, sizeof(int) * num_blocks));
+            HIP_CHECK(hipMalloc((void**)&d_Drows_hip, sizeof(int) * (num_std_wells + 1)));
+            HIP_CHECK(hipMalloc((void**)&d_Dcols_hip, sizeof(int) * num_std_wells));
+            HIP_CHECK(hipMalloc((void**)&d_CTrows_hip, sizeof(int) * (Nb + 1)));
+            HIP_CHECK(hipMalloc((void**)&d_CTcols_hip, sizeof(int) * num_blocks));
+            HIP_CHECK(hipMalloc((void**)&d_z1_hip, sizeof(double) * num_std_wells * dim_wells));
+            HIP_CHECK(hipMalloc((void**)&d_z2_hip, sizeof(double) * num_std_wells * dim_wells));
+            hip_num_blocks = num_blocks;
+            hip_num_std_wells = num_std_wells;
+            hip_Nb = Nb;
+        }
+
+        // D^-1 has one block per well, on the diagonal
+        std::vector<int> Brows(val_pointers.begin(), val_pointers.end());
+        std::vector<int> Drows(num_std_wells + 1);
+        std::iota(Drows.begin(), Drows.end(), 0);
+        HIP_CHECK(hipMemcpy(d_Brows_hip, Brows.data(), sizeof(int) * (num_std_wells + 1), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_Bcols_hip, h_Bcols.data(), sizeof(int) * num_blocks, hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_Drows_hip, Drows.data(), sizeof(int) * (num_std_wells + 1), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_Dcols_hip, Drows.data(), sizeof(int) * num_std_wells, hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_CTrows_hip, h_CTrows.data(), sizeof(int) * (Nb + 1), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_CTcols_hip, h_CTcols.data(), sizeof(int) * num_blocks, hipMemcpyHostToDevice));
+        hip_structure_changed = false;
+    }
+
+    // a block of C has dim_wells rows and dim columns, a block of C^T dim rows and dim_wells columns
+    h_CTvals.resize(num_blocks * block_vals);
+    for (unsigned int k = 0; k < num_blocks; ++k) {
+        const double *C_block = h_Cnnzs + CT_blocks[k] * block_vals;
+        double *CT_block = h_CTvals.data() + k * block_vals;
+        for (unsigned int r = 0; r < dim_wells; ++r) {
+            for (unsigned int c = 0; c < dim; ++c) {
+                CT_block[c * dim_wells + r] = C_block[r * dim + c];
+            }
+        }
+    }
+
+    HIP_CHECK(hipMemcpyAsync(d_B_hip, h_Bnnzs, sizeof(double) * num_blocks * block_vals, hipMemcpyHostToDevice, hip_stream));
+    HIP_CHECK(hipMemcpyAsync(d_Dinv_hip, h_Dnnzs, sizeof(double) * num_std_wells * dim_wells * dim_wells, hipMemcpyHostToDevice, hip_stream));
+    HIP_CHECK(hipMemcpyAsync(d_CT_hip, h_CTvals.data(), sizeof(double) * num_blocks * block_vals, hipMemcpyHostToDevice, hip_stream));
+    // h_CTvals is pageable memory, it must not change before the copy is done
+    HIP_CHECK(hipStreamSynchronize(hip_stream));
+
+    stdwells_prepared_hip = true;
+}
+
+// Apply the WellContributions, similar to StandardWell::apply()
+// y -= (C^T *(D^-1*(   B*x)))
+void WellContributions::apply_rocsparse(double *d_x, double *d_y)
+{
+    // apply StandardWells, with three products on the GPU
+    if (num_std_wells > 0) {
+        if (!stdwells_prepared_hip) {
+            prepare_stdwells_rocsparse();
+        }
+        const rocsparse_direction dir = rocsparse_direction_row;
+        const rocsparse_operation operation = rocsparse_operation_none;
+        const unsigned int Nb = N / dim;
+        double zero = 0.0;
+        double one  = 1.0;
+        double mone = -1.0;
+        ROCSPARSE_CHECK(rocsparse_dgebsrmv(rocsparse_handle_, dir, operation, num_std_wells, Nb, num_blocks,
+                                           &one, descr_wells, d_B_hip, d_Brows_hip, d_Bcols_hip,
+                                           dim_wells, dim, d_x, &zero, d_z1_hip));
+        ROCSPARSE_CHECK(rocsparse_dgebsrmv(rocsparse_handle_, dir, operation, num_std_wells, num_std_wells, num_std_wells,
+                                           &one, descr_wells, d_Dinv_hip, d_Drows_hip, d_Dcols_hip,
+                                           dim_wells, dim_wells, d_z1_hip, &zero, d_z2_hip));
+        ROCSPARSE_CHECK(rocsparse_dgebsrmv(rocsparse_handle_, dir, operation, Nb, num_std_wells, num_blocks,
+                                           &mone, descr_wells, d_CT_hip, d_CTrows_hip, d_CTcols_hip,
+                                           dim, dim_wells, d_z2_hip, &one, d_y));
+    }
+
+    // apply MultisegmentWells on CPU
+    if (num_ms_wells > 0) {
+        // allocate pinned memory on host if not yet done
+        if (h_x == nullptr) {
+            HIP_CHECK(hipHostMalloc((void**)&h_x, sizeof(double) * N));
+            HIP_CHECK(hipHostMalloc((void**)&h_y, sizeof(double) * N));
+        }
+
+        // copy vectors x and y from GPU to CPU
+        HIP_CHECK(hipMemcpyAsync(h_x, d_x, sizeof(double) * N, hipMemcpyDeviceToHost, hip_stream));
+        HIP_CHECK(hipMemcpyAsync(h_y, d_y, sizeof(double) * N, hipMemcpyDeviceToHost, hip_stream));
+        HIP_CHECK(hipStreamSynchronize(hip_stream));
+
+        // actually apply MultisegmentWells
+        for (MultisegmentWellContribution *well : multisegments) {
+            well->apply(h_x, h_y);
+        }
+
+        // copy vector y from CPU to GPU
+        HIP_CHECK(hipMemcpyAsync(d_y, h_y, sizeof(double) * N, hipMemcpyHostToDevice, hip_stream));
+        HIP_CHECK(hipStreamSynchronize(hip_stream));
+    }
+}
+
+} //namespace Opm
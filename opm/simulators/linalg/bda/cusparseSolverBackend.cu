@@ -37,6 +37,14 @@
 // otherwise, the nonzeroes of the matrix are assumed to be in a contiguous array, and a single GPU memcpy is enough
 #define COPY_ROW_BY_ROW 0
 
+// iff true, one bicgstab iteration is captured in a CUDA graph, and launched as a whole
+// cudaGraphInstantiateWithFlags() is available since CUDA 11.4
+#if CUDART_VERSION >= 11040
+#define CUSPARSE_SOLVER_USE_CUDA_GRAPH 1
+#else
+#define CUSPARSE_SOLVER_USE_CUDA_GRAPH 0
+#endif
+
 namespace bda
 {
 
@@ -56,13 +64,131 @@ cusparseSolverBackend<block_size>::~cusparseSolverBackend() {
     finalize();
 }
 
+namespace
+{
+
+// the scalars of bicgstab are kept on the GPU, so the iterations can be enqueued without waiting for the results
+// NORM, CONVERGED and HALF_ITS must be contiguous, they are copied to the host after every iteration
+enum ScalarIndex { RHO, RHO_NEW, ALPHA, NALPHA, OMEGA, NOMEGA, BETA, TMP1, TMP2, NORM_NEW, NORM_0, NORM, CONVERGED, HALF_ITS, NUM_SCALARS };
+
+__global__ void init_scalars(double *s, const double norm_0)
+{
+    s[RHO] = s[ALPHA] = s[OMEGA] = 1.0;
+    s[NOMEGA] = -1.0;
+    s[NORM_0] = s[NORM] = norm_0;
+    s[CONVERGED] = 0.0;
+    s[HALF_ITS] = 0.0;
+}
+
+// beta = (rho_new / rho) * (alpha / omega), rho = rho_new
+__global__ void compute_beta(double *s)
+{
+    s[BETA] = (s[RHO] == 0.0 || s[OMEGA] == 0.0) ? 0.0 : (s[RHO_NEW] / s[RHO]) * (s[ALPHA] / s[OMEGA]);
+    s[RHO] = s[RHO_NEW];
+}
+
+// alpha = rho / tmp1, when converged, set alpha to zero so that x and r do not change anymore
+__global__ void compute_alpha(double *s)
+{
+    s[ALPHA] = (s[CONVERGED] != 0.0 || s[TMP1] == 0.0) ? 0.0 : s[RHO] / s[TMP1];
+    s[NALPHA] = -s[ALPHA];
+}
+
+// omega = tmp1 / tmp2, when converged, set omega to zero so that x and r do not change anymore
+__global__ void compute_omega(double *s)
+{
+    s[OMEGA] = (s[CONVERGED] != 0.0 || s[TMP2] == 0.0) ? 0.0 : s[TMP1] / s[TMP2];
+    s[NOMEGA] = -s[OMEGA];
+}
+
+// count the half iterations until convergence, and remember the norm of the last one
+__global__ void check_convergence(double *s, const double tolerance)
+{
+    if (s[CONVERGED] == 0.0) {
+        s[HALF_ITS] += 1.0;
+        s[NORM] = s[NORM_NEW];
+        if (s[NORM] < tolerance * s[NORM_0]) {
+            s[CONVERGED] = 1.0;
+        }
+    }
+}
+
+} // anonymous namespace
+
+
+template <unsigned int block_size>
+void cusparseSolverBackend<block_size>::pbicgstab_iteration(WellContributions& wellContribs) {
+    int n = N;
+    double zero = 0.0;
+    double one  = 1.0;
+
+    // cublas uses CUBLAS_POINTER_MODE_DEVICE here, cusparse still gets its scalars from the host
+    cublasDdot(cublasHandle, n, d_rw, 1, d_r, 1, d_scalars + RHO_NEW);
+    compute_beta<<<1, 1, 0, stream>>>(d_scalars);
+    cublasDaxpy(cublasHandle, n, d_scalars + NOMEGA, d_v, 1, d_p, 1);
+    cublasDscal(cublasHandle, n, d_scalars + BETA, d_p, 1);
+    cublasDaxpy(cublasHandle, n, d_one, d_r, 1, d_p, 1);
+
+    // apply ilu0
+    cusparseDbsrsv2_solve(cusparseHandle, order, \
+                          operation, Nb, nnzb, &one, \
+                          descr_L, d_mVals, d_mRows, d_mCols, block_size, info_L, d_p, d_t, policy, d_buffer);
+    cusparseDbsrsv2_solve(cusparseHandle, order, \
+                          operation, Nb, nnzb, &one, \
+                          descr_U, d_mVals, d_mRows, d_mCols, block_size, info_U, d_t, d_pw, policy, d_buffer);
+
+    // spmv
+    cusparseDbsrmv(cusparseHandle, order, \
+                   operation, Nb, Nb, nnzb, \
+                   &one, descr_M, d_bVals, d_bRows, d_bCols, block_size, d_pw, &zero, d_v);
+
+    // apply wellContributions
+    if (wellContribs.getNumWells() > 0) {
+        wellContribs.apply(d_pw, d_v);
+    }
+
+    cublasDdot(cublasHandle, n, d_rw, 1, d_v, 1, d_scalars + TMP1);
+    compute_alpha<<<1, 1, 0, stream>>>(d_scalars);
+    cublasDaxpy(cublasHandle, n, d_scalars + NALPHA, d_v, 1, d_r, 1);
+    cublasDaxpy(cublasHandle, n, d_scalars + ALPHA, d_pw, 1, d_x, 1);
+    cublasDnrm2(cublasHandle, n, d_r, 1, d_scalars + NORM_NEW);
+    check_convergence<<<1, 1, 0, stream>>>(d_scalars, tolerance);
+
+    // apply ilu0
+    cusparseDbsrsv2_solve(cusparseHandle, order, \
+                          operation, Nb, nnzb, &one, \
+                          descr_L, d_mVals, d_mRows, d_mCols, block_size, info_L, d_r, d_t, policy, d_buffer);
+    cusparseDbsrsv2_solve(cusparseHandle, order, \
+                          operation, Nb, nnzb, &one, \
+                          descr_U, d_mVals, d_mRows, d_mCols, block_size, info_U, d_t, d_s, policy, d_buffer);
+
+    // spmv
+    cusparseDbsrmv(cusparseHandle, order, \
+                   operation, Nb, Nb, nnzb, &one, descr_M, \
+                   d_bVals, d_bRows, d_bCols, block_size, d_s, &zero, d_t);
+
+    // apply wellContributions
+    if (wellContribs.getNumWells() > 0) {
+        wellContribs.apply(d_s, d_t);
+    }
+
+    cublasDdot(cublasHandle, n, d_t, 1, d_r, 1, d_scalars + TMP1);
+    cublasDdot(cublasHandle, n, d_t, 1, d_t, 1, d_scalars + TMP2);
+    compute_omega<<<1, 1, 0, stream>>>(d_scalars);
+    cublasDaxpy(cublasHandle, n, d_scalars + OMEGA, d_s, 1, d_x, 1);
+    cublasDaxpy(cublasHandle, n, d_scalars + NOMEGA, d_t, 1, d_r, 1);
+    cublasDnrm2(cublasHandle, n, d_r, 1, d_scalars + NORM_NEW);
+    check_convergence<<<1, 1, 0, stream>>>(d_scalars, tolerance);
+
+    // the host only waits for this copy every convergence_check_interval iterations
+    cudaMemcpyAsync(h_status, d_scalars + NORM, 3 * sizeof(double), cudaMemcpyDeviceToHost, stream);
+}
+
+
 template <unsigned int block_size>
 void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
-    Timer t_total, t_prec(false), t_spmv(false), t_well(false), t_rest(false);
+    Timer t_total;
     int n = N;
-    double rho = 1.0, rhop;
-    double alpha, nalpha, beta;
-    double omega, nomega, tmp1, tmp2;
     double norm, norm_0;
     double zero = 0.0;
     double one  = 1.0;
@@ -71,6 +197,7 @@ void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellCon
 
     if (wellContribs.getNumWells() > 0) {
         wellContribs.setCudaStream(stream);
+        wellContribs.setVectorSize(N);
     }
 
     cusparseDbsrmv(cusparseHandle, order, operation, Nb, Nb, nnzb, &one, descr_M, d_bVals, d_bRows, d_bCols, block_size, d_x, &zero, d_r);
@@ -78,102 +205,88 @@ void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellCon
     cublasDscal(cublasHandle, n, &mone, d_r, 1);
     cublasDaxpy(cublasHandle, n, &one, d_b, 1, d_r, 1);
     cublasDcopy(cublasHandle, n, d_r, 1, d_rw, 1);
-    cublasDcopy(cublasHandle, n, d_r, 1, d_p, 1);
     cublasDnrm2(cublasHandle, n, d_r, 1, &norm_0);
 
+    // with p = v = 0 and rho = alpha = omega = 1, the first iteration sets p = r, like the others
+    cudaMemsetAsync(d_p, 0, sizeof(double) * N, stream);
+    cudaMemsetAsync(d_v, 0, sizeof(double) * N, stream);
+    init_scalars<<<1, 1, 0, stream>>>(d_scalars, norm_0);
+
     if (verbosity > 1) {
         std::ostringstream out;
         out << std::scientific << "cusparseSolver initial norm: " << norm_0;
         OpmLog::info(out.str());
     }
 
-    for (it = 0.5; it < maxit; it += 0.5) {
-        rhop = rho;
-        cublasDdot(cublasHandle, n, d_rw, 1, d_r, 1, &rho);
-
-        if (it > 1) {
-            beta = (rho / rhop) * (alpha / omega);
-            nomega = -omega;
-            cublasDaxpy(cublasHandle, n, &nomega, d_v, 1, d_p, 1);
-            cublasDscal(cublasHandle, n, &beta, d_p, 1);
-            cublasDaxpy(cublasHandle, n, &one, d_r, 1, d_p, 1);
+    cublasSetPointerMode(cublasHandle, CUBLAS_POINTER_MODE_DEVICE);
+
+    // record one iteration in a CUDA graph, to launch it with a single call
+    // MultisegmentWells are applied on the CPU, which cannot be captured
+#if CUSPARSE_SOLVER_USE_CUDA_GRAPH
+    bool use_graph = false;
+    cudaGraphExec_t graph_exec;
+    if (wellContribs.getNumMultisegmentWells() == 0) {
+        cudaGraph_t graph;
+        if (cudaStreamBeginCapture(stream, cudaStreamCaptureModeThreadLocal) == cudaSuccess) {
+            pbicgstab_iteration(wellContribs);
+            if (cudaStreamEndCapture(stream, &graph) == cudaSuccess) {
+                use_graph = (cudaGraphInstantiateWithFlags(&graph_exec, graph, 0) == cudaSuccess);
+                cudaGraphDestroy(graph);
+            }
         }
-
-        // apply ilu0
-        cusparseDbsrsv2_solve(cusparseHandle, order, \
-                              operation, Nb, nnzb, &one, \
-                              descr_L, d_mVals, d_mRows, d_mCols, block_size, info_L, d_p, d_t, policy, d_buffer);
-        cusparseDbsrsv2_solve(cusparseHandle, order, \
-                              operation, Nb, nnzb, &one, \
-                              descr_U, d_mVals, d_mRows, d_mCols, block_size, info_U, d_t, d_pw, policy, d_buffer);
-
-        // spmv
-        cusparseDbsrmv(cusparseHandle, order, \
-                       operation, Nb, Nb, nnzb, \
-                       &one, descr_M, d_bVals, d_bRows, d_bCols, block_size, d_pw, &zero, d_v);
-
-        // apply wellContributions
-        if (wellContribs.getNumWells() > 0) {
-            wellContribs.apply(d_pw, d_v);
+        // if capturing failed, launch the iterations directly
+        cudaGetLastError();
+        if (!use_graph && verbosity > 1) {
+            OpmLog::info("cusparseSolver could not capture the iteration in a CUDA graph, launching kernels directly");
         }
+    }
+#endif
 
-        cublasDdot(cublasHandle, n, d_rw, 1, d_v, 1, &tmp1);
-        alpha = rho / tmp1;
-        nalpha = -alpha;
-        cublasDaxpy(cublasHandle, n, &nalpha, d_v, 1, d_r, 1);
-        cublasDaxpy(cublasHandle, n, &alpha, d_pw, 1, d_x, 1);
-        cublasDnrm2(cublasHandle, n, d_r, 1, &norm);
-
-        if (norm < tolerance * norm_0) {
-            break;
+    // the host only synchronizes to check for convergence, after convergence_check_interval iterations
+    // iterations that are enqueued after convergence do not change x anymore
+    const int check_interval = (verbosity > 1) ? 1 : convergence_check_interval;
+    bool converged = false;
+    for (int it_full = 1; it_full <= maxit; ++it_full) {
+#if CUSPARSE_SOLVER_USE_CUDA_GRAPH
+        if (use_graph) {
+            cudaGraphLaunch(graph_exec, stream);
+        } else {
+            pbicgstab_iteration(wellContribs);
         }
+#else
+        pbicgstab_iteration(wellContribs);
+#endif
 
-        it += 0.5;
-
-        // apply ilu0
-        cusparseDbsrsv2_solve(cusparseHandle, order, \
-                              operation, Nb, nnzb, &one, \
-                              descr_L, d_mVals, d_mRows, d_mCols, block_size, info_L, d_r, d_t, policy, d_buffer);
-        cusparseDbsrsv2_solve(cusparseHandle, order, \
-                              operation, Nb, nnzb, &one, \
-                              descr_U, d_mVals, d_mRows, d_mCols, block_size, info_U, d_t, d_s, policy, d_buffer);
-
-        // spmv
-        cusparseDbsrmv(cusparseHandle, order, \
-                       operation, Nb, Nb, nnzb, &one, descr_M, \
-                       d_bVals, d_bRows, d_bCols, block_size, d_s, &zero, d_t);
-
-        // apply wellContributions
-        if (wellContribs.getNumWells() > 0) {
-            wellContribs.apply(d_s, d_t);
+        if (it_full % check_interval == 0 || it_full == maxit) {
+            cudaStreamSynchronize(stream);
+            converged = (h_status[1] != 0.0);
+            if (verbosity > 1) {
+                std::ostringstream out;
+                out << "it: " << 0.5 * h_status[2] << std::scientific << ", norm: " << h_status[0];
+                OpmLog::info(out.str());
+            }
+            if (converged) {
+                break;
+            }
         }
+    }
 
-        cublasDdot(cublasHandle, n, d_t, 1, d_r, 1, &tmp1);
-        cublasDdot(cublasHandle, n, d_t, 1, d_t, 1, &tmp2);
-        omega = tmp1 / tmp2;
-        nomega = -omega;
-        cublasDaxpy(cublasHandle, n, &omega, d_s, 1, d_x, 1);
-        cublasDaxpy(cublasHandle, n, &nomega, d_t, 1, d_r, 1);
-
-        cublasDnrm2(cublasHandle, n, d_r, 1, &norm);
-
+#if CUSPARSE_SOLVER_USE_CUDA_GRAPH
+    if (use_graph) {
+        cudaGraphExecDestroy(graph_exec);
+    }
+#endif
 
-        if (norm < tolerance * norm_0) {
-            break;
-        }
+    cublasSetPointerMode(cublasHandle, CUBLAS_POINTER_MODE_HOST);
 
-        if (verbosity > 1) {
-            std::ostringstream out;
-            out << "it: " << it << std::scientific << ", norm: " << norm;
-            OpmLog::info(out.str());
-        }
-    }
+    norm = h_status[0];
+    it = converged ? static_cast<float>(0.5 * h_status[2]) : static_cast<float>(maxit);
 
     res.iterations = std::min(it, (float)maxit);
     res.reduction = norm / norm_0;
     res.conv_rate  = static_cast<double>(pow(res.reduction, 1.0 / it));
     res.elapsed = t_total.stop();
-    res.converged = (it != (maxit + 0.5));
+    res.converged = converged;
 
     if (verbosity > 0) {
         std::ostringstream out;
@@ -230,7 +343,14 @@ void cusparseSolverBackend<block_size>::initialize(int N, int nnz, int dim) {
     cudaMalloc((void**)&d_bCols, sizeof(double) * nnz);
     cudaMalloc((void**)&d_bRows, sizeof(double) * (Nb + 1));
     cudaMalloc((void**)&d_mVals, sizeof(double) * nnz);
+    cudaMalloc((void**)&d_scalars, sizeof(double) * (NUM_SCALARS + 1));
     cudaCheckLastError("Could not allocate enough memory on GPU");
+    d_one = d_scalars + NUM_SCALARS;
+    const double one = 1.0;
+    cudaMemcpy(d_one, &one, sizeof(double), cudaMemcpyHostToDevice);
+
+    cudaMallocHost((void**)&h_status, sizeof(double) * 3);
+    cudaCheckLastError("Could not allocate pinned memory");
 
     cublasSetStream(cublasHandle, stream);
     cudaCheckLastError("Could not set stream to cublas");
@@ -262,6 +382,8 @@ void cusparseSolverBackend<block_size>::finalize() {
         cudaFree(d_bCols);
         cudaFree(d_bRows);
         cudaFree(d_buffer);
+        cudaFree(d_scalars);
+        cudaFreeHost(h_status);
         cusparseDestroyBsrilu02Info(info_M);
         cusparseDestroyBsrsv2Info(info_L);
         cusparseDestroyBsrsv2Info(info_U);
@@ -274,15 +396,43 @@ void cusparseSolverBackend<block_size>::finalize() {
 #if COPY_ROW_BY_ROW
         cudaFreeHost(vals_contiguous);
 #endif
+        if (registered_vals) {
+            cudaHostUnregister(registered_vals);
+        }
         cudaStreamDestroy(stream);
     }
 } // end finalize()
 
 
+template <unsigned int block_size>
+void cusparseSolverBackend<block_size>::register_host_matrix(double *vals) {
+#if !COPY_ROW_BY_ROW
+    if (vals == registered_vals) {
+        return;
+    }
+    if (registered_vals) {
+        cudaHostUnregister(registered_vals);
+        registered_vals = nullptr;
+    }
+    if (cudaHostRegister(vals, sizeof(double) * nnz, cudaHostRegisterDefault) == cudaSuccess) {
+        registered_vals = vals;
+    } else {
+        // not fatal, the values are then staged by the driver as before
+        cudaGetLastError();
+        OpmLog::warning("cusparseSolver could not pin the host matrix, uploads will be slower");
+    }
+#else
+    (void)vals;
+#endif
+} // end register_host_matrix()
+
+
 template <unsigned int block_size>
 void cusparseSolverBackend<block_size>::copy_system_to_gpu(double *vals, int *rows, int *cols, double *b) {
     Timer t;
 
+    register_host_matrix(vals);
+
 #if COPY_ROW_BY_ROW
     int sum = 0;
     for (int i = 0; i < Nb; ++i) {
@@ -314,6 +464,8 @@ template <unsigned int block_size>
 void cusparseSolverBackend<block_size>::update_system_on_gpu(double *vals, int *rows, double *b) {
     Timer t;
 
+    register_host_matrix(vals);
+
 #if COPY_ROW_BY_ROW
     int sum = 0;
     for (int i = 0; i < Nb; ++i) {
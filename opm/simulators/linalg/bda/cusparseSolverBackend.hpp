@@ -63,6 +63,13 @@ private:
     double *d_pw, *d_s, *d_t, *d_v;
     void *d_buffer;
     double *vals_contiguous;                  // only used if COPY_ROW_BY_ROW is true in cusparseSolverBackend.cpp
+    double *registered_vals = nullptr;        // host matrix pinned with cudaHostRegister, only if COPY_ROW_BY_ROW is false
+    double *d_scalars;                        // scalars of bicgstab, kept on GPU so the iterations can be enqueued asynchronously
+    double *d_one;                            // points to 1.0 in d_scalars, for cublas in CUBLAS_POINTER_MODE_DEVICE
+    double *h_status;                         // pinned, norm, converged flag and number of half iterations, copied after every iteration
+
+    // number of iterations that are enqueued before the host waits for the GPU to check for convergence
+    static constexpr int convergence_check_interval = 4;
 
     bool analysis_done = false;
 
@@ -72,6 +79,11 @@ private:
     /// \param[inout] res         summary of solver result
     void gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res);
 
+    /// Enqueue one full iteration of ilu0-bicgstab on the stream, without synchronizing
+    /// All scalars are computed and used on the GPU, so this can be captured in a CUDA graph
+    /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
+    void pbicgstab_iteration(WellContributions& wellContribs);
+
     /// Initialize GPU and allocate memory
     /// \param[in] N                number of nonzeroes, divide by dim*dim to get number of blocks
     /// \param[in] nnz              number of nonzeroes, divide by dim*dim to get number of blocks
@@ -81,6 +93,13 @@ private:
     /// Clean memory
     void finalize();
 
+    /// Pin the values of the host matrix, such that they are uploaded with DMA
+    /// and asynchronously, instead of being staged in a pageable buffer by the driver.
+    /// The matrix of the simulator is the same in every Newton iteration, so this is
+    /// only done again if the pointer changes.
+    /// \param[in] vals        array of nonzeroes, contains nnz values
+    void register_host_matrix(double *vals);
+
     /// Copy linear system to GPU
     /// \param[in] vals        array of nonzeroes, each block is stored row-wise, contains nnz values
     /// \param[in] rows        array of rowPointers, contains N/dim+1 values
@@ -84,6 +84,48 @@ namespace bda
     }
 
 
+    // returns partial sums, instead of the final dot product
+    // only the entries with a nonzero mask are included
+    std::string get_dot_masked_string() {
+        return R"(
+        __kernel void dot_masked(
+            __global double *in1,
+            __global double *in2,
+            __global const double *mask,
+            __global double *out,
+            const unsigned int N,
+            __local double *tmp)
+        {
+            unsigned int tid = get_local_id(0);
+            unsigned int i = get_global_id(0);
+            unsigned int NUM_THREADS = get_global_size(0);
+
+            double sum = 0.0;
+            while(i < N){
+                sum += in1[i] * in2[i] * mask[i];
+                i += NUM_THREADS;
+            }
+            tmp[tid] = sum;
+
+            barrier(CLK_LOCAL_MEM_FENCE);
+
+            // do reduction in shared mem
+            for(unsigned int s = get_local_size(0) / 2; s > 0; s >>= 1)
+            {
+                if (tid < s)
+                {
+                    tmp[tid] += tmp[tid + s];
+                }
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
+
+            // write result for this block to global mem
+            if (tid == 0) out[get_group_id(0)] = tmp[0];
+        }
+        )";
+    }
+
+
     // returns partial sums, instead of the final norm
     // the square root must be computed on CPU
     std::string get_norm_string() {
@@ -477,6 +519,104 @@ namespace bda
     }
 
 
+    std::string get_mswell_apply_string(bool reorder) {
+        std::string kernel_name = reorder ? "mswell_apply" : "mswell_apply_no_reorder";
+        std::string col_idx = reorder ? "toOrder[Bcols[blk]]" : "Bcols[blk]";
+        std::string s = "__kernel void " + kernel_name + R"((
+                        __global const double *Bvals,
+                        __global const double *Cvals,
+                        __global const unsigned int *Bcols,
+                        __global const unsigned int *Brows,
+                        __global const unsigned int *row_offsets,
+                        __global const double *band,
+                        __global const unsigned int *band_offsets,
+                        __global const unsigned int *bandwidths,
+                        __global const int *pivots,
+                        __global double *z,
+                        __global const double *x,
+                        __global double *y,
+                        )";
+        if (reorder) {
+            s +=     R"(__global const int *toOrder,
+                        )";
+        }
+        s +=         R"(const unsigned int dim,
+                        const unsigned int dim_wells){
+                // one workgroup per well
+                const int w = get_group_id(0);
+                const int lid = get_local_id(0);
+                const int lsize = get_local_size(0);
+                const int first_row = row_offsets[w];
+                const int Mb = row_offsets[w + 1] - first_row;
+                const int M = Mb * dim_wells;
+                __global double *zw = z + first_row * dim_wells;
+
+                // z = B * x
+                for (int i = lid; i < M; i += lsize) {
+                    const int row = first_row + i / dim_wells;
+                    const int j = i % dim_wells;
+                    double temp = 0.0;
+                    for (unsigned int blk = Brows[row]; blk < Brows[row + 1]; ++blk) {
+                        const int colIdx = )" + col_idx + R"(;
+                        for (unsigned int k = 0; k < dim; ++k) {
+                            temp += Bvals[blk * dim * dim_wells + j * dim + k] * x[colIdx * dim + k];
+                        }
+                    }
+                    zw[i] = temp;
+                }
+
+                barrier(CLK_GLOBAL_MEM_FENCE);
+
+                // z = D^-1 * z, with the banded LU factors of D
+                // the substitutions are sequential, but the wells are solved in parallel
+                if (lid == 0) {
+                    const int kl = bandwidths[2 * w];
+                    const int kv = kl + bandwidths[2 * w + 1];
+                    const int ldab = kl + kv + 1;
+                    __global const double *ab = band + band_offsets[w];
+                    __global const int *piv = pivots + first_row * dim_wells;
+                    for (int j = 0; j < M; ++j) {
+                        const int p = piv[j];
+                        const double t = zw[p];
+                        if (p != j) {
+                            zw[p] = zw[j];
+                            zw[j] = t;
+                        }
+                        const int km = min(kl, M - 1 - j);
+                        for (int i = 1; i <= km; ++i) {
+                            zw[j + i] -= ab[j * ldab + kv + i] * t;
+                        }
+                    }
+                    for (int j = M - 1; j >= 0; --j) {
+                        zw[j] /= ab[j * ldab + kv];
+                        const double t = zw[j];
+                        for (int i = max(0, j - kv); i < j; ++i) {
+                            zw[i] -= ab[j * ldab + kv + i - j] * t;
+                        }
+                    }
+                }
+
+                barrier(CLK_GLOBAL_MEM_FENCE);
+
+                // y -= C^T * z
+                for (int i = lid; i < Mb * dim; i += lsize) {
+                    const int row = first_row + i / dim;
+                    const int c = i % dim;
+                    for (unsigned int blk = Brows[row]; blk < Brows[row + 1]; ++blk) {
+                        const int colIdx = )" + col_idx + R"(;
+                        double temp = 0.0;
+                        for (unsigned int k = 0; k < dim_wells; ++k) {
+                            temp += Cvals[blk * dim * dim_wells + k * dim + c] * zw[(row - first_row) * dim_wells + k];
+                        }
+                        y[colIdx * dim + c] -= temp;
+                    }
+                }
+            }
+            )";
+        return s;
+    }
+
+
     std::string get_ilu_decomp_string() {
         return R"(
 
@@ -498,6 +638,24 @@ namespace bda
             }
         }
 
+        // a = a - relaxation * (b * c)
+        __kernel void block_mult_sub_relaxed(__global double *a, __local double *b, __global double *c, const double relaxation)
+        {
+            const unsigned int block_size = 3;
+            const unsigned int hwarp_size = 16;
+            const unsigned int idx_t = get_local_id(0);                   // thread id in work group
+            const unsigned int thread_id_in_hwarp = idx_t % hwarp_size;   // thread id in warp (16 threads)
+            if(thread_id_in_hwarp < block_size * block_size){
+                const unsigned int row = thread_id_in_hwarp / block_size;
+                const unsigned int col = thread_id_in_hwarp % block_size;
+                double temp = 0.0;
+                for (unsigned int k = 0; k < block_size; k++) {
+                    temp += b[block_size * row + k] * c[block_size * k + col];
+                }
+                a[block_size * row + col] -= relaxation * temp;
+            }
+        }
+
         // c = a * b
         __kernel void block_mult(__global double *a, __global double *b, __local double *c) {
             const unsigned int block_size = 3;
@@ -552,6 +710,7 @@ namespace bda
                                  __global double *invDiagVals,
                                  __global int *diagIndex,
                                  const unsigned int Nb,
+                                 const double relaxation,
                                  __local double *pivot){
 
             const unsigned int bs = 3;
@@ -589,6 +748,7 @@ namespace bda
                         int jk = diagIndex[j] + 1;
                         int ik = ij + 1;
                         // substract that row scaled by the pivot from this row.
+                        // for a relaxed ILU, the updates that fall outside the pattern are (partially) added to the diagonal
                         while (ik < iRowEnd && jk < jRowEnd) {
                             if (LUcols[ik] == LUcols[jk]) {
                                 block_mult_sub(LUvals + ik * bs * bs, pivot + lmem_offset, LUvals + jk * bs * bs);
@@ -598,7 +758,17 @@ namespace bda
                                 if (LUcols[ik] < LUcols[jk])
                                 { ik++; }
                                 else
-                                { jk++; }
+                                {
+                                    if (relaxation != 0.0) {
+                                        block_mult_sub_relaxed(LUvals + diagIndex[i] * bs * bs, pivot + lmem_offset, LUvals + jk * bs * bs, relaxation);
+                                    }
+                                    jk++;
+                                }
+                            }
+                        }
+                        if (relaxation != 0.0) {
+                            for (; jk < jRowEnd; jk++) {
+                                block_mult_sub_relaxed(LUvals + diagIndex[i] * bs * bs, pivot + lmem_offset, LUvals + jk * bs * bs, relaxation);
                             }
                         }
                     }
@@ -617,5 +787,183 @@ namespace bda
         )";
     }
 
-} // end namespace bda
+    std::string get_spmv_string() {
+        return R"(
+        __kernel void spmv(
+            __global const double *vals,
+            __global const int *cols,
+            __global const int *rows,
+            const int N,
+            __global const double *x,
+            __global double *out)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int row = get_global_id(0);
+
+            while(row < N){
+                double sum = 0.0;
+                for(int k = rows[row]; k < rows[row + 1]; ++k){
+                    sum += vals[k] * x[cols[k]];
+                }
+                out[row] = sum;
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
 
+
+    std::string get_residual_string() {
+        return R"(
+        __kernel void residual(
+            __global const double *vals,
+            __global const int *cols,
+            __global const int *rows,
+            const int N,
+            __global const double *x,
+            __global const double *rhs,
+            __global double *out)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int row = get_global_id(0);
+
+            while(row < N){
+                double sum = rhs[row];
+                for(int k = rows[row]; k < rows[row + 1]; ++k){
+                    sum -= vals[k] * x[cols[k]];
+                }
+                out[row] = sum;
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    std::string get_vmul_string() {
+        return R"(
+        __kernel void vmul(
+            const double alpha,
+            __global const double *in1,
+            __global const double *in2,
+            __global double *out,
+            const int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int idx = get_global_id(0);
+
+            while(idx < N){
+                out[idx] += alpha * in1[idx] * in2[idx];
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    std::string get_full_to_pressure_restriction_string() {
+        return R"(
+        __kernel void full_to_pressure_restriction(
+            __global const double *fine_y,
+            __global const double *weights,
+            __global double *coarse_y,
+            const unsigned int block_size,
+            const int Nb)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int target_block_row = get_global_id(0);
+            const unsigned int bs = block_size;
+
+            while(target_block_row < Nb){
+                double sum = 0.0;
+                for(unsigned int i = 0; i < bs; ++i){
+                    sum += fine_y[target_block_row * bs + i] * weights[target_block_row * bs + i];
+                }
+                coarse_y[target_block_row] = sum;
+                target_block_row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    std::string get_add_coarse_pressure_correction_string() {
+        return R"(
+        __kernel void add_coarse_pressure_correction(
+            __global const double *coarse_x,
+            __global double *fine_x,
+            const unsigned int pressure_idx,
+            const unsigned int block_size,
+            const int Nb)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int target_block_row = get_global_id(0);
+
+            while(target_block_row < Nb){
+                fine_x[target_block_row * block_size + pressure_idx] += coarse_x[target_block_row];
+                target_block_row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    std::string get_prolongate_vector_string() {
+        return R"(
+        __kernel void prolongate_vector(
+            __global const double *coarse_x,
+            __global double *fine_x,
+            __global const int *aggregates,
+            const int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int row = get_global_id(0);
+
+            while(row < N){
+                fine_x[row] += coarse_x[aggregates[row]];
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+    std::string get_gather_vector_string() {
+        return R"(
+        __kernel void gather_vector(
+            __global const double *in,
+            __global const int *indices,
+            __global double *out,
+            const int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int idx = get_global_id(0);
+
+            while(idx < N){
+                out[idx] = in[indices[idx]];
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    std::string get_scatter_vector_string() {
+        return R"(
+        __kernel void scatter_vector(
+            __global const double *in,
+            __global const int *indices,
+            __global double *out,
+            const int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            int idx = get_global_id(0);
+
+            while(idx < N){
+                out[indices[idx]] = in[idx];
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+} // end namespace bda
@@ -41,8 +41,30 @@ using stdwell_apply_no_reorder_kernel_type = cl::make_kernel<cl::Buffer&, cl::Bu
                                                              cl::Buffer&, cl::Buffer&, cl::Buffer&,
                                                              const unsigned int, const unsigned int, cl::Buffer&,
                                                              cl::LocalSpaceArg, cl::LocalSpaceArg, cl::LocalSpaceArg>;
+using mswell_apply_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 const unsigned int, const unsigned int>;
+using mswell_apply_no_reorder_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                            cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                            cl::Buffer&, cl::Buffer&,
+                                                            const unsigned int, const unsigned int>;
 using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&,
-                                               cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, cl::LocalSpaceArg>;
+                                               cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, const double, cl::LocalSpaceArg>;
+using spmv_scalar_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                                cl::Buffer&, cl::Buffer&>;
+using residual_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                             cl::Buffer&, cl::Buffer&, cl::Buffer&>;
+using vmul_kernel_type = cl::make_kernel<const double, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>;
+using full_to_pressure_restriction_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                                 const unsigned int, const unsigned int>;
+using add_coarse_pressure_correction_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int,
+                                                                   const unsigned int, const unsigned int>;
+using prolongate_vector_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>;
+using dot_masked_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                               const unsigned int, cl::LocalSpaceArg>;
+using gather_vector_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>;
+using scatter_vector_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>;
 
     /// Generate string with axpy kernel
     /// a = a + alpha * b
@@ -56,6 +78,10 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// the square root must be computed on CPU
     std::string get_norm_string();
 
+    /// returns partial sums, instead of the final dot product
+    /// entries i with mask[i] == 0 are excluded, used to skip ghost rows
+    std::string get_dot_masked_string();
+
     /// Generate string with custom kernel
     /// This kernel combines some ilubicgstab vector operations into 1
     /// p = (p - omega * v) * beta + r
@@ -87,10 +113,49 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// \param[in] reorder   whether the matrix is reordered or not
     std::string get_stdwell_apply_string(bool reorder);
 
+    /// Generate string with the mswell_apply kernels, which apply all MultisegmentWells in one launch
+    /// y -= C^T * (D^-1 * (B * x)), with one workgroup per well, D^-1 is applied with banded LU factors
+    /// If reorder is true, the Bcols do not correspond with the x/y vector
+    /// the x/y vector is reordered, use toOrder to address that
+    /// \param[in] reorder   whether the matrix is reordered or not
+    std::string get_mswell_apply_string(bool reorder);
+
     /// Generate string with the exact ilu decomposition kernel
     /// The kernel takes a full BSR matrix and performs inplace ILU decomposition
     std::string get_ilu_decomp_string();
 
+    /// Generate string with scalar CSR spmv kernel, one thread per row
+    /// out = mat * x
+    std::string get_spmv_string();
+
+    /// Generate string with scalar CSR residual kernel, one thread per row
+    /// out = rhs - mat * x
+    std::string get_residual_string();
+
+    /// Generate string with elementwise multiplication kernel
+    /// out = out + alpha * in1 * in2
+    std::string get_vmul_string();
+
+    /// Generate string with the CPR restriction kernel
+    /// coarse_y[i] is the weighted sum of the values of blockrow i of fine_y
+    std::string get_full_to_pressure_restriction_string();
+
+    /// Generate string with the CPR prolongation kernel
+    /// adds coarse_x[i] to the pressure component of blockrow i of fine_x
+    std::string get_add_coarse_pressure_correction_string();
+
+    /// Generate string with the aggregation-based AMG prolongation kernel
+    /// fine_x[i] = fine_x[i] + coarse_x[aggregates[i]]
+    std::string get_prolongate_vector_string();
+
+    /// Generate string with gather kernel, used to collect the values to send to other processes
+    /// out[i] = in[indices[i]]
+    std::string get_gather_vector_string();
+
+    /// Generate string with scatter kernel, used to insert the values received from other processes
+    /// out[indices[i]] = in[i]
+    std::string get_scatter_vector_string();
+
 } // end namespace bda
 
 #endif
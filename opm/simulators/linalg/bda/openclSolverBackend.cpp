@@ -18,11 +18,22 @@
 */
 
 #include <config.h>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/common/utility/FileSystem.hpp>
 #include <dune/common/timer.hh>
 
 #include <opm/simulators/linalg/bda/openclSolverBackend.hpp>
@@ -30,11 +41,6 @@
 #include <opm/simulators/linalg/bda/BdaResult.hpp>
 #include <opm/simulators/linalg/bda/Reorder.hpp>
 
-
-// iff true, the nonzeroes of the matrix are copied row-by-row into a contiguous, pinned memory array, then a single GPU memcpy is done
-// otherwise, the nonzeroes of the matrix are assumed to be in a contiguous array, and a single GPU memcpy is enough
-#define COPY_ROW_BY_ROW 0
-
 namespace bda
 {
 
@@ -42,8 +48,13 @@ using Opm::OpmLog;
 using Dune::Timer;
 
 template <unsigned int block_size>
-openclSolverBackend<block_size>::openclSolverBackend(int verbosity_, int maxit_, double tolerance_, unsigned int platformID_, unsigned int deviceID_, ILUReorder opencl_ilu_reorder_) : BdaSolver<block_size>(verbosity_, maxit_, tolerance_, platformID_, deviceID_), opencl_ilu_reorder(opencl_ilu_reorder_) {
-    prec = new Preconditioner(opencl_ilu_reorder, verbosity_);
+openclSolverBackend<block_size>::openclSolverBackend(int verbosity_, int maxit_, double tolerance_, unsigned int platformID_, unsigned int deviceID_, ILUReorder opencl_ilu_reorder_, bool use_cpr_, int ilu_fill_level_, double ilu_relaxation_, std::string kernel_cache_dir_) : BdaSolver<block_size>(verbosity_, maxit_, tolerance_, platformID_, deviceID_), use_cpr(use_cpr_), opencl_ilu_reorder(opencl_ilu_reorder_), ilu_fill_level(ilu_fill_level_), ilu_relaxation(ilu_relaxation_), kernel_cache_dir(std::move(kernel_cache_dir_)) {
+    reorder_cache = std::make_shared<ReorderCache>();
+    prec = new Preconditioner(opencl_ilu_reorder, verbosity_, ilu_fill_level, ilu_relaxation);
+    prec->setReorderCache(reorder_cache);
+    if (use_cpr) {
+        cpr = std::make_unique<CPR<block_size> >(prec, verbosity_);
+    }
 
     std::ostringstream out;
     try {
@@ -210,7 +221,12 @@ double openclSolverBackend<block_size>::dot_w(cl::Buffer in1, cl::Buffer in2, cl
     const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
     Timer t_dot;
 
-    cl::Event event = (*dot_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in1, in2, out, N, cl::Local(lmem_per_work_group));
+    cl::Event event;
+    if (comm) {
+        event = (*dot_masked_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in1, in2, d_mask, out, N, cl::Local(lmem_per_work_group));
+    } else {
+        event = (*dot_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in1, in2, out, N, cl::Local(lmem_per_work_group));
+    }
 
     queue->enqueueReadBuffer(out, CL_TRUE, 0, sizeof(double) * num_work_groups, tmp);
 
@@ -218,6 +234,9 @@ double openclSolverBackend<block_size>::dot_w(cl::Buffer in1, cl::Buffer in2, cl
     for (unsigned int i = 0; i < num_work_groups; ++i) {
         gpu_sum += tmp[i];
     }
+    if (comm) {
+        comm->sum(&gpu_sum, 1);
+    }
 
     if (verbosity >= 4) {
         event.wait();
@@ -238,7 +257,12 @@ double openclSolverBackend<block_size>::norm_w(cl::Buffer in, cl::Buffer out)
     const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
     Timer t_norm;
 
-    cl::Event event = (*norm_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in, out, N, cl::Local(lmem_per_work_group));
+    cl::Event event;
+    if (comm) {
+        event = (*dot_masked_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in, in, d_mask, out, N, cl::Local(lmem_per_work_group));
+    } else {
+        event = (*norm_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in, out, N, cl::Local(lmem_per_work_group));
+    }
 
     queue->enqueueReadBuffer(out, CL_TRUE, 0, sizeof(double) * num_work_groups, tmp);
 
@@ -246,6 +270,9 @@ double openclSolverBackend<block_size>::norm_w(cl::Buffer in, cl::Buffer out)
     for (unsigned int i = 0; i < num_work_groups; ++i) {
         gpu_norm += tmp[i];
     }
+    if (comm) {
+        comm->sum(&gpu_norm, 1);
+    }
     gpu_norm = sqrt(gpu_norm);
 
     if (verbosity >= 4) {
@@ -313,6 +340,119 @@ void openclSolverBackend<block_size>::spmv_blocked_w(cl::Buffer vals, cl::Buffer
     }
 }
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::copy_owner_to_all(cl::Buffer& v)
+{
+    if (!comm) {
+        return;
+    }
+    const unsigned int work_group_size = 32;
+    const unsigned int num_send = h_send.size();
+    const unsigned int num_recv = h_recv.size();
+    Timer t_comm;
+
+    // the OpenCL buffers cannot be passed to MPI, so the values are staged on the host
+    if (num_send > 0) {
+        const unsigned int total_work_items = ceilDivision(num_send, work_group_size) * work_group_size;
+        (*gather_vector_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), v, d_send_indices, d_send, num_send);
+        queue->enqueueReadBuffer(d_send, CL_TRUE, 0, sizeof(double) * num_send, h_send.data());
+    }
+    comm->exchange(h_send.data(), h_recv.data());
+    if (num_recv > 0) {
+        const unsigned int total_work_items = ceilDivision(num_recv, work_group_size) * work_group_size;
+        queue->enqueueWriteBuffer(d_recv, CL_FALSE, 0, sizeof(double) * num_recv, h_recv.data());
+        (*scatter_vector_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), d_recv, d_recv_indices, v, num_recv);
+    }
+
+    if (verbosity >= 4) {
+        queue->finish();
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver copy_owner_to_all time: " << t_comm.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+}
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::project(cl::Buffer& v)
+{
+    const unsigned int num_recv = h_recv.size();
+    if (!comm || num_recv == 0) {
+        return;
+    }
+    const unsigned int work_group_size = 32;
+    const unsigned int total_work_items = ceilDivision(num_recv, work_group_size) * work_group_size;
+    (*scatter_vector_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), d_recv_zero, d_recv_indices, v, num_recv);
+}
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::setup_communication()
+{
+    // the indices refer to the original ordering, the vectors on GPU are reordered
+    auto reordered = [this](const std::vector<int>& indices) {
+        std::vector<int> result(indices);
+        if (opencl_ilu_reorder != ILUReorder::NONE) {
+            for (auto& idx : result) {
+                idx = toOrder[idx / block_size] * block_size + idx % block_size;
+            }
+        }
+        return result;
+    };
+    const std::vector<int> send_indices = reordered(comm->sendIndices());
+    const std::vector<int> recv_indices = reordered(comm->recvIndices());
+    h_send.resize(send_indices.size());
+    h_recv.resize(recv_indices.size());
+
+    std::vector<double> mask(N, 1.0);
+    for (int idx : recv_indices) {
+        mask[idx] = 0.0;
+    }
+    d_mask = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+    queue->enqueueWriteBuffer(d_mask, CL_TRUE, 0, sizeof(double) * N, mask.data());
+
+    // OpenCL does not allow buffers of size 0
+    const size_t num_send = std::max(send_indices.size(), size_t{1});
+    const size_t num_recv = std::max(recv_indices.size(), size_t{1});
+    d_send_indices = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * num_send);
+    d_recv_indices = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * num_recv);
+    d_send = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * num_send);
+    d_recv = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * num_recv);
+    d_recv_zero = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * num_recv);
+    if (!send_indices.empty()) {
+        queue->enqueueWriteBuffer(d_send_indices, CL_TRUE, 0, sizeof(int) * send_indices.size(), send_indices.data());
+    }
+    if (!recv_indices.empty()) {
+        queue->enqueueWriteBuffer(d_recv_indices, CL_TRUE, 0, sizeof(int) * recv_indices.size(), recv_indices.data());
+    }
+    queue->enqueueFillBuffer(d_recv_zero, 0, 0, sizeof(double) * num_recv);
+    queue->finish();
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "openclSolver::setup_communication(): sending " << send_indices.size() << " and receiving " << recv_indices.size() << " values";
+        OpmLog::info(out.str());
+    }
+}
+
+template <unsigned int block_size>
+bool openclSolverBackend<block_size>::setCommunication(std::shared_ptr<BdaCommunication> comm_)
+{
+    if (initialized) {
+        OPM_THROW(std::logic_error, "Error openclSolver::setCommunication() must be called before the first solve");
+    }
+    comm = comm_;
+    return true;
+}
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::apply_preconditioner(cl::Buffer& x, cl::Buffer& y)
+{
+    if (use_cpr) {
+        cpr->apply(x, y);
+    } else {
+        prec->apply(x, y);
+    }
+}
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
     float it;
@@ -320,7 +460,8 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
     double norm, norm_0;
 
     if(wellContribs.getNumWells() > 0){
-        wellContribs.setKernel(stdwell_apply_k.get(), stdwell_apply_no_reorder_k.get());
+        wellContribs.setKernel(stdwell_apply_k.get(), stdwell_apply_no_reorder_k.get(),
+                               mswell_apply_k.get(), mswell_apply_no_reorder_k.get());
     }
 
     Timer t_total, t_prec(false), t_spmv(false), t_well(false), t_rest(false);
@@ -370,7 +511,8 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
 
         // pw = prec(p)
         t_prec.start();
-        prec->apply(d_p, d_pw);
+        apply_preconditioner(d_p, d_pw);
+        copy_owner_to_all(d_pw);
         t_prec.stop();
 
         // v = A * pw
@@ -384,6 +526,7 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
             wellContribs.apply(d_pw, d_v, d_toOrder);
         }
         t_well.stop();
+        project(d_v);
 
         t_rest.start();
         tmp1 = dot_w(d_rw, d_v, d_tmp);
@@ -401,7 +544,8 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
 
         // s = prec(r)
         t_prec.start();
-        prec->apply(d_r, d_s);
+        apply_preconditioner(d_r, d_s);
+        copy_owner_to_all(d_s);
         t_prec.stop();
 
         // t = A * s
@@ -415,6 +559,7 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
             wellContribs.apply(d_s, d_t, d_toOrder);
         }
         t_well.stop();
+        project(d_t);
 
         t_rest.start();
         tmp1 = dot_w(d_t, d_r, d_tmp);
@@ -478,38 +623,62 @@ void openclSolverBackend<block_size>::initialize(int N_, int nnz_, int dim, doub
     try {
         prec->setOpenCLContext(context.get());
         prec->setOpenCLQueue(queue.get());
+        if (use_cpr) {
+            cpr->setOpenCLContext(context.get());
+            cpr->setOpenCLQueue(queue.get());
+        }
 
         tmp = new double[N];
-#if COPY_ROW_BY_ROW
-        vals_contiguous = new double[N];
-#endif
         mat.reset(new BlockedMatrix<block_size>(Nb, nnzb, vals, cols, rows));
 
-        d_x = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_b = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_rb = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_r = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_rw = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_p = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_pw = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_s = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_t = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_v = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_tmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-
-        d_Avals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * nnz);
-        d_Acols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * nnzb);
-        d_Arows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Nb + 1));
-
+        // the GPU buffers are kept when the sparsity pattern changes, they are only
+        // allocated again, with some headroom, when the matrix has outgrown them
+        if (N > buffer_N) {
+            buffer_N = static_cast<int>(N * buffer_headroom);
+            d_x = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_b = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_rb = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_r = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_rw = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_p = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_pw = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_s = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_t = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_v = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+            d_tmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_N);
+        }
+        if (nnz > buffer_nnz) {
+            buffer_nnz = static_cast<int>(nnz * buffer_headroom);
+            d_Avals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * buffer_nnz);
+            d_Acols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (buffer_nnz / block_size / block_size));
+        }
         bool reorder = (opencl_ilu_reorder != ILUReorder::NONE);
-        if (reorder) {
-            rb = new double[N];
-            d_toOrder = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Nb);
+        if (Nb > buffer_Nb) {
+            buffer_Nb = static_cast<int>(Nb * buffer_headroom);
+            d_Arows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (buffer_Nb + 1));
+            if (reorder) {
+                d_toOrder = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * buffer_Nb);
+            }
         }
 
-        get_opencl_kernels();
+        // the staging buffers stay mapped, so they can be written by the CPU at any time
+        h_Avals_pinned = cl::Buffer(*context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, sizeof(double) * nnz);
+        h_b_pinned = cl::Buffer(*context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, sizeof(double) * N);
+        h_Avals = static_cast<double*>(queue->enqueueMapBuffer(h_Avals_pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, sizeof(double) * nnz));
+        h_b = static_cast<double*>(queue->enqueueMapBuffer(h_b_pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, sizeof(double) * N));
+        rb = h_b;
+
+        // the kernels do not depend on the sparsity pattern, they are only compiled once
+        if (!dot_k) {
+            get_opencl_kernels();
+        }
 
         prec->setKernels(ILU_apply1_k.get(), ILU_apply2_k.get(), ilu_decomp_k.get());
+        if (use_cpr) {
+            cpr->setKernels(spmv_blocked_k.get(), axpy_k.get(), spmv_k.get(), residual_k.get(), vmul_k.get(),
+                            full_to_pressure_restriction_k.get(), add_coarse_pressure_correction_k.get(), prolongate_vector_k.get());
+            cpr->setMatrixBuffers(&d_Avals, &d_Acols, &d_Arows);
+        }
 
     } catch (const cl::Error& error) {
         std::ostringstream oss;
@@ -556,11 +725,32 @@ void openclSolverBackend<block_size>::get_opencl_kernels() {
         add_kernel_string(sources, stdwell_apply_s);
         std::string stdwell_apply_no_reorder_s = get_stdwell_apply_string(false);
         add_kernel_string(sources, stdwell_apply_no_reorder_s);
+        std::string mswell_apply_s = get_mswell_apply_string(true);
+        add_kernel_string(sources, mswell_apply_s);
+        std::string mswell_apply_no_reorder_s = get_mswell_apply_string(false);
+        add_kernel_string(sources, mswell_apply_no_reorder_s);
         std::string ilu_decomp_s = get_ilu_decomp_string();
         add_kernel_string(sources, ilu_decomp_s);
-
-        cl::Program program = cl::Program(*context, sources);
-        program.build(devices);
+        std::string spmv_s = get_spmv_string();
+        add_kernel_string(sources, spmv_s);
+        std::string residual_s = get_residual_string();
+        add_kernel_string(sources, residual_s);
+        std::string vmul_s = get_vmul_string();
+        add_kernel_string(sources, vmul_s);
+        std::string full_to_pressure_restriction_s = get_full_to_pressure_restriction_string();
+        add_kernel_string(sources, full_to_pressure_restriction_s);
+        std::string add_coarse_pressure_correction_s = get_add_coarse_pressure_correction_string();
+        add_kernel_string(sources, add_coarse_pressure_correction_s);
+        std::string prolongate_vector_s = get_prolongate_vector_string();
+        add_kernel_string(sources, prolongate_vector_s);
+        std::string dot_masked_s = get_dot_masked_string();
+        add_kernel_string(sources, dot_masked_s);
+        std::string gather_vector_s = get_gather_vector_string();
+        add_kernel_string(sources, gather_vector_s);
+        std::string scatter_vector_s = get_scatter_vector_string();
+        add_kernel_string(sources, scatter_vector_s);
+
+        cl::Program program = build_program(sources);
 
         // queue.enqueueNDRangeKernel() is a blocking/synchronous call, at least for NVIDIA
         // cl::make_kernel<> myKernel(); myKernel(args, arg1, arg2); is also blocking
@@ -575,38 +765,128 @@ void openclSolverBackend<block_size>::get_opencl_kernels() {
         ILU_apply2_k.reset(new ilu_apply2_kernel_type(cl::Kernel(program, "ILU_apply2")));
         stdwell_apply_k.reset(new stdwell_apply_kernel_type(cl::Kernel(program, "stdwell_apply")));
         stdwell_apply_no_reorder_k.reset(new stdwell_apply_no_reorder_kernel_type(cl::Kernel(program, "stdwell_apply_no_reorder")));
+        mswell_apply_k.reset(new mswell_apply_kernel_type(cl::Kernel(program, "mswell_apply")));
+        mswell_apply_no_reorder_k.reset(new mswell_apply_no_reorder_kernel_type(cl::Kernel(program, "mswell_apply_no_reorder")));
         ilu_decomp_k.reset(new ilu_decomp_kernel_type(cl::Kernel(program, "ilu_decomp")));
+        spmv_k.reset(new spmv_scalar_kernel_type(cl::Kernel(program, "spmv")));
+        residual_k.reset(new residual_kernel_type(cl::Kernel(program, "residual")));
+        vmul_k.reset(new vmul_kernel_type(cl::Kernel(program, "vmul")));
+        full_to_pressure_restriction_k.reset(new full_to_pressure_restriction_kernel_type(cl::Kernel(program, "full_to_pressure_restriction")));
+        add_coarse_pressure_correction_k.reset(new add_coarse_pressure_correction_kernel_type(cl::Kernel(program, "add_coarse_pressure_correction")));
+        prolongate_vector_k.reset(new prolongate_vector_kernel_type(cl::Kernel(program, "prolongate_vector")));
+        dot_masked_k.reset(new dot_masked_kernel_type(cl::Kernel(program, "dot_masked")));
+        gather_vector_k.reset(new gather_vector_kernel_type(cl::Kernel(program, "gather_vector")));
+        scatter_vector_k.reset(new scatter_vector_kernel_type(cl::Kernel(program, "scatter_vector")));
 } // end get_opencl_kernels()
 
+template <unsigned int block_size>
+cl::Program openclSolverBackend<block_size>::build_program(const cl::Program::Sources &sources) {
+    if (kernel_cache_dir.empty()) {
+        cl::Program program(*context, sources);
+        program.build(devices);
+        return program;
+    }
+
+    // the binaries are only valid for the device and driver that compiled them
+    std::string key = devices[0].getInfo<CL_DEVICE_NAME>() + devices[0].getInfo<CL_DRIVER_VERSION>();
+    for (const auto& source : sources) {
+        key.append(source.first, source.second);
+    }
+    std::ostringstream name;
+    name << "opm_opencl_kernels_" << std::hex << std::hash<std::string>{}(key) << ".bin";
+    const std::string cache_file = (Opm::filesystem::path(kernel_cache_dir) / name.str()).string();
+
+    std::ifstream is(cache_file, std::ios::binary);
+    if (is) {
+        const std::vector<char> binary((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        try {
+            const cl::Program::Binaries binaries(1, std::make_pair(static_cast<const void*>(binary.data()), binary.size()));
+            cl::Program program(*context, devices, binaries);
+            program.build(devices);
+            if (verbosity > 0) {
+                OpmLog::info("openclSolver: using the compiled kernels of " + cache_file);
+            }
+            return program;
+        } catch (const cl::Error& error) {
+            OpmLog::warning("openclSolver: the compiled kernels of " + cache_file + " cannot be used (" + getErrorString(error.err()) + "), compiling them again");
+        }
+    }
+
+    cl::Program program(*context, sources);
+    program.build(devices);
+
+    std::size_t size = 0;
+    clGetProgramInfo(program(), CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, nullptr);
+    std::vector<char> binary(size);
+    char *binary_ptr = binary.data();
+    if (size == 0 || clGetProgramInfo(program(), CL_PROGRAM_BINARIES, sizeof(binary_ptr), &binary_ptr, nullptr) != CL_SUCCESS) {
+        return program;
+    }
+
+    // other processes may read the cache at the same time, they only see complete files
+    const std::string tmp_file = cache_file + ".tmp" + std::to_string(::getpid());
+    std::error_code ec;
+    Opm::filesystem::create_directories(kernel_cache_dir, ec);
+    {
+        std::ofstream os(tmp_file, std::ios::binary);
+        os.write(binary.data(), binary.size());
+        if (!os) {
+            ec = std::make_error_code(std::errc::io_error);
+        }
+    }
+    if (!ec) {
+        Opm::filesystem::rename(tmp_file, cache_file, ec);
+    }
+    if (ec) {
+        std::error_code ignored;
+        Opm::filesystem::remove(tmp_file, ignored);
+        OpmLog::warning("openclSolver: writing the compiled kernels to " + cache_file + " failed: " + ec.message());
+    }
+    return program;
+} // end build_program()
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::finalize() {
-    if (opencl_ilu_reorder != ILUReorder::NONE) {
-        delete[] rb;
+    if (initialized) {
+        queue->enqueueUnmapMemObject(h_Avals_pinned, h_Avals);
+        queue->enqueueUnmapMemObject(h_b_pinned, h_b);
+        queue->finish();
     }
     delete[] tmp;
-#if COPY_ROW_BY_ROW
-    delete[] vals_contiguous;
-#endif
     delete prec;
 } // end finalize()
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::reset_pattern() {
+    if (initialized) {
+        queue->enqueueUnmapMemObject(h_Avals_pinned, h_Avals);
+        queue->enqueueUnmapMemObject(h_b_pinned, h_b);
+        queue->finish();
+    }
+    delete[] tmp;
+    tmp = nullptr;
+
+    // the preconditioners keep memory that depends on the pattern, so they are created again
+    cpr.reset();
+    delete prec;
+    prec = new Preconditioner(opencl_ilu_reorder, verbosity, ilu_fill_level, ilu_relaxation);
+    prec->setReorderCache(reorder_cache);
+    if (use_cpr) {
+        cpr = std::make_unique<CPR<block_size> >(prec, verbosity);
+    }
+
+    initialized = false;
+    analysis_done = false;
+} // end reset_pattern()
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::copy_system_to_gpu() {
     Timer t;
     events.resize(5);
 
-#if COPY_ROW_BY_ROW
-    int sum = 0;
-    for (int i = 0; i < Nb; ++i) {
-        int size_row = rmat->rowPointers[i + 1] - rmat->rowPointers[i];
-        memcpy(vals_contiguous + sum, reinterpret_cast<double*>(rmat->nnzValues) + sum, size_row * sizeof(double) * block_size * block_size);
-        sum += size_row * block_size * block_size;
-    }
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, vals_contiguous, nullptr, &events[0]);
-#else
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, rmat->nnzValues, nullptr, &events[0]);
-#endif
-
+    // the staging buffer keeps a copy of the nonzeroes on the GPU, to detect changes in later updates
+    memcpy(h_Avals, rmat->nnzValues, sizeof(double) * nnz);
+    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, h_Avals, nullptr, &events[0]);
     err |= queue->enqueueWriteBuffer(d_Acols, CL_TRUE, 0, sizeof(int) * nnzb, rmat->colIndices, nullptr, &events[1]);
     err |= queue->enqueueWriteBuffer(d_Arows, CL_TRUE, 0, sizeof(int) * (Nb + 1), rmat->rowPointers, nullptr, &events[2]);
     err |= queue->enqueueWriteBuffer(d_b, CL_TRUE, 0, sizeof(double) * N, rb, nullptr, &events[3]);
@@ -631,26 +911,42 @@ void openclSolverBackend<block_size>::copy_system_to_gpu() {
 
 // don't copy rowpointers and colindices, they stay the same
 template <unsigned int block_size>
-void openclSolverBackend<block_size>::update_system_on_gpu() {
+void openclSolverBackend<block_size>::start_update_system_on_gpu() {
     Timer t;
-    events.resize(3);
-
-#if COPY_ROW_BY_ROW
-    int sum = 0;
-    for (int i = 0; i < Nb; ++i) {
-        int size_row = rmat->rowPointers[i + 1] - rmat->rowPointers[i];
-        memcpy(vals_contiguous + sum, reinterpret_cast<double*>(rmat->nnzValues) + sum, size_row * sizeof(double) * block_size * block_size);
-        sum += size_row * block_size * block_size;
+    const unsigned int bs = block_size;
+    const double *vals = rmat->nnzValues;
+
+    // find the blockrows that changed since the last transfer, and copy them to the staging buffer
+    // nearby changed blockrows are merged into a single range [first, last)
+    std::vector<std::pair<int, int> > ranges;
+    int num_changed = 0;
+    for (int row = 0; row < Nb; ++row) {
+        const int start = rmat->rowPointers[row] * bs * bs;
+        const int size = (rmat->rowPointers[row + 1] - rmat->rowPointers[row]) * bs * bs;
+        if (memcmp(h_Avals + start, vals + start, sizeof(double) * size) != 0) {
+            memcpy(h_Avals + start, vals + start, sizeof(double) * size);
+            ++num_changed;
+            if (!ranges.empty() && row - ranges.back().second <= upload_merge_gap) {
+                ranges.back().second = row + 1;
+            } else {
+                ranges.emplace_back(row, row + 1);
+            }
+        }
+    }
+    if (num_changed > full_upload_fraction * Nb) {
+        ranges.assign(1, std::make_pair(0, static_cast<int>(Nb)));
     }
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, vals_contiguous, nullptr, &events[0]);
-#else
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, rmat->nnzValues, nullptr, &events[0]);
-#endif
 
-    err |= queue->enqueueWriteBuffer(d_b, CL_TRUE, 0, sizeof(double) * N, rb, nullptr, &events[1]);
-    err |= queue->enqueueFillBuffer(d_x, 0, 0, sizeof(double) * N, nullptr, &events[2]);
-    cl::WaitForEvents(events);
-    events.clear();
+    const int num_ranges = ranges.size();
+    upload_events.resize(num_ranges + 2);
+    err = CL_SUCCESS;
+    for (int i = 0; i < num_ranges; ++i) {
+        const size_t offset = sizeof(double) * rmat->rowPointers[ranges[i].first] * bs * bs;
+        const size_t size = sizeof(double) * (rmat->rowPointers[ranges[i].second] - rmat->rowPointers[ranges[i].first]) * bs * bs;
+        err |= queue->enqueueWriteBuffer(d_Avals, CL_FALSE, offset, size, h_Avals + offset / sizeof(double), nullptr, &upload_events[i]);
+    }
+    err |= queue->enqueueWriteBuffer(d_b, CL_FALSE, 0, sizeof(double) * N, rb, nullptr, &upload_events[num_ranges]);
+    err |= queue->enqueueFillBuffer(d_x, 0, 0, sizeof(double) * N, nullptr, &upload_events[num_ranges + 1]);
     if (err != CL_SUCCESS) {
         // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
         OPM_THROW(std::logic_error, "openclSolverBackend OpenCL enqueueWriteBuffer error");
@@ -658,10 +954,25 @@ void openclSolverBackend<block_size>::update_system_on_gpu() {
 
     if (verbosity > 2) {
         std::ostringstream out;
-        out << "openclSolver::update_system_on_gpu(): " << t.stop() << " s";
+        out << "openclSolver::start_update_system_on_gpu(): " << t.stop() << " s, ";
+        out << num_changed << " of " << Nb << " blockrows changed, " << num_ranges << " transfers";
         OpmLog::info(out.str());
     }
-} // end update_system_on_gpu()
+} // end start_update_system_on_gpu()
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::finish_update_system_on_gpu() {
+    Timer t;
+
+    cl::WaitForEvents(upload_events);
+    upload_events.clear();
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "openclSolver::finish_update_system_on_gpu(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+} // end finish_update_system_on_gpu()
 
 
 template <unsigned int block_size>
@@ -674,6 +985,10 @@ bool openclSolverBackend<block_size>::analyse_matrix() {
     int total_work_items = num_work_groups * work_group_size;
     int lmem_per_work_group = work_group_size * sizeof(double);
     prec->setKernelParameters(work_group_size, total_work_items, lmem_per_work_group);
+    if (use_cpr) {
+        cpr->setKernelParameters(work_group_size, total_work_items, lmem_per_work_group);
+        success = success && cpr->init(mat.get());
+    }
 
     if (opencl_ilu_reorder == ILUReorder::NONE) {
         rmat = mat.get();
@@ -683,6 +998,10 @@ bool openclSolverBackend<block_size>::analyse_matrix() {
         rmat = prec->getRMat();
     }
 
+    if (comm) {
+        setup_communication();
+    }
+
     if (verbosity > 2) {
         std::ostringstream out;
         out << "openclSolver::analyse_matrix(): " << t.stop() << " s";
@@ -700,11 +1019,12 @@ void openclSolverBackend<block_size>::update_system(double *vals, double *b, Wel
     Timer t;
 
     mat->nnzValues = vals;
+    wellContribs.setVectorSize(N);
     if (opencl_ilu_reorder != ILUReorder::NONE) {
         reorderBlockedVectorByPattern<block_size>(mat->Nb, b, fromOrder, rb);
         wellContribs.setReordering(toOrder, true);
     } else {
-        rb = b;
+        memcpy(rb, b, sizeof(double) * N);
         wellContribs.setReordering(nullptr, false);
     }
 
@@ -721,6 +1041,10 @@ bool openclSolverBackend<block_size>::create_preconditioner() {
     Timer t;
 
     bool result = prec->create_preconditioner(mat.get());
+    if (result && use_cpr) {
+        // rmat contains the (reordered) values after BILU0 is created
+        result = cpr->create_preconditioner(rmat);
+    }
 
     if (verbosity > 2) {
         std::ostringstream out;
@@ -781,6 +1105,16 @@ void openclSolverBackend<block_size>::get_result(double *x) {
 
 template <unsigned int block_size>
 SolverStatus openclSolverBackend<block_size>::solve_system(int N_, int nnz_, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res) {
+    // a different sparsity pattern requires a new analysis, for example when a well with its contributions in the matrix opens
+    const unsigned long long hash = hashPattern((N_ + dim - 1) / dim, rows, cols);
+    if (initialized && (N_ != N || nnz_ != nnz || hash != pattern_hash)) {
+        if (verbosity > 0) {
+            OpmLog::info("openclSolver: sparsity pattern changed, analysing the matrix again");
+        }
+        reset_pattern();
+    }
+    pattern_hash = hash;
+
     if (initialized == false) {
         initialize(N_, nnz_,  dim, vals, rows, cols);
         if (analysis_done == false) {
@@ -795,10 +1129,21 @@ SolverStatus openclSolverBackend<block_size>::solve_system(int N_, int nnz_, int
         copy_system_to_gpu();
     } else {
         update_system(vals, b, wellContribs);
-        if (!create_preconditioner()) {
+        // without reordering, rmat is the original matrix, so the transfer can
+        // overlap with the construction of the preconditioner
+        // with reordering, rmat is only filled by create_preconditioner()
+        const bool reorder = (opencl_ilu_reorder != ILUReorder::NONE);
+        if (!reorder) {
+            start_update_system_on_gpu();
+        }
+        const bool prec_created = create_preconditioner();
+        if (reorder && prec_created) {
+            start_update_system_on_gpu();
+        }
+        finish_update_system_on_gpu();
+        if (!prec_created) {
             return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
         }
-        update_system_on_gpu();
     }
     solve_system(wellContribs, res);
     return SolverStatus::BDA_SOLVER_SUCCESS;
@@ -806,7 +1151,7 @@ SolverStatus openclSolverBackend<block_size>::solve_system(int N_, int nnz_, int
 
 
 #define INSTANTIATE_BDA_FUNCTIONS(n)                                                                              \
-template openclSolverBackend<n>::openclSolverBackend(int, int, double, unsigned int, unsigned int, ILUReorder);   \
+template openclSolverBackend<n>::openclSolverBackend(int, int, double, unsigned int, unsigned int, ILUReorder, bool, int, double);   \
 
 INSTANTIATE_BDA_FUNCTIONS(1);
 INSTANTIATE_BDA_FUNCTIONS(2);
@@ -22,11 +22,13 @@
 
 #include <opm/simulators/linalg/bda/opencl.hpp>
 #include <opm/simulators/linalg/bda/openclKernels.hpp>
+#include <opm/simulators/linalg/bda/BdaCommunication.hpp>
 #include <opm/simulators/linalg/bda/BdaResult.hpp>
 #include <opm/simulators/linalg/bda/BdaSolver.hpp>
 #include <opm/simulators/linalg/bda/ILUReorder.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 #include <opm/simulators/linalg/bda/BILU0.hpp>
+#include <opm/simulators/linalg/bda/CPR.hpp>
 
 #include <tuple>
 
@@ -52,8 +54,14 @@ class openclSolverBackend : public BdaSolver<block_size>
     using Base::initialized;
 
 private:
-    double *rb = nullptr;                 // reordered b vector, if the matrix is reordered, rb is newly allocated, otherwise it just points to b
-    double *vals_contiguous = nullptr;    // only used if COPY_ROW_BY_ROW is true in openclSolverBackend.cpp
+    double *rb = nullptr;                 // (reordered) b vector, points to the pinned staging buffer h_b
+
+    // if more than this fraction of the blockrows changed, all nonzeroes are transferred at once
+    static constexpr double full_upload_fraction = 0.5;
+    // changed blockrows separated by at most this many unchanged blockrows are transferred together
+    static constexpr int upload_merge_gap = 64;
+    // the GPU buffers are allocated this much larger than needed, so they can be reused when the matrix grows a little
+    static constexpr double buffer_headroom = 1.1;
 
     // OpenCL variables must be reusable, they are initialized in initialize()
     cl::Buffer d_Avals, d_Acols, d_Arows;        // (reordered) matrix in BSR format on GPU
@@ -61,8 +69,20 @@ private:
     cl::Buffer d_pw, d_s, d_t, d_v;              // vectors, used during linear solve
     cl::Buffer d_tmp;                            // used as tmp GPU buffer for dot() and norm()
     cl::Buffer d_toOrder;                        // only used when reordering is used
+    cl::Buffer h_Avals_pinned, h_b_pinned;       // pinned host memory, staging area for asynchronous transfers
+    double *h_Avals = nullptr;                   // mapped h_Avals_pinned, holds a copy of the nonzeroes on the GPU
+    double *h_b = nullptr;                       // mapped h_b_pinned
+    std::vector<cl::Event> upload_events;        // transfers started by start_update_system_on_gpu()
+    int buffer_N = 0, buffer_nnz = 0, buffer_Nb = 0; // capacities of the GPU buffers, they are kept when the pattern changes
     double *tmp = nullptr;                       // used as tmp CPU buffer for dot() and norm()
 
+    // only used when the linear system is distributed over MPI processes
+    std::shared_ptr<BdaCommunication> comm;      // nullptr for a sequential run
+    cl::Buffer d_mask;                           // 1.0 for owned entries, 0.0 for ghost entries, used in dot() and norm()
+    cl::Buffer d_send_indices, d_recv_indices;   // (reordered) scalar indices, see BdaCommunication
+    cl::Buffer d_send, d_recv, d_recv_zero;      // gathered values
+    std::vector<double> h_send, h_recv;
+
     // shared pointers are also passed to other objects
     std::vector<cl::Device> devices;
     std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg> > dot_k;
@@ -74,14 +94,32 @@ private:
     std::shared_ptr<ilu_apply2_kernel_type> ILU_apply2_k;
     std::shared_ptr<stdwell_apply_kernel_type> stdwell_apply_k;
     std::shared_ptr<stdwell_apply_no_reorder_kernel_type> stdwell_apply_no_reorder_k;
+    std::shared_ptr<mswell_apply_kernel_type> mswell_apply_k;
+    std::shared_ptr<mswell_apply_no_reorder_kernel_type> mswell_apply_no_reorder_k;
     std::shared_ptr<ilu_decomp_kernel_type> ilu_decomp_k;
-
-    Preconditioner *prec = nullptr;                               // only supported preconditioner is BILU0
+    std::unique_ptr<spmv_scalar_kernel_type> spmv_k;
+    std::unique_ptr<residual_kernel_type> residual_k;
+    std::unique_ptr<vmul_kernel_type> vmul_k;
+    std::unique_ptr<full_to_pressure_restriction_kernel_type> full_to_pressure_restriction_k;
+    std::unique_ptr<add_coarse_pressure_correction_kernel_type> add_coarse_pressure_correction_k;
+    std::unique_ptr<prolongate_vector_kernel_type> prolongate_vector_k;
+    std::unique_ptr<dot_masked_kernel_type> dot_masked_k;
+    std::unique_ptr<gather_vector_kernel_type> gather_vector_k;
+    std::unique_ptr<scatter_vector_kernel_type> scatter_vector_k;
+
+    Preconditioner *prec = nullptr;                               // BILU0, or the second stage of CPR
+    bool use_cpr;                                                 // use CPR instead of BILU0
+    std::unique_ptr<CPR<block_size> > cpr = nullptr;
     int *toOrder = nullptr, *fromOrder = nullptr;                 // BILU0 reorders rows of the matrix via these mappings
     bool analysis_done = false;
+    unsigned long long pattern_hash = 0;                          // hash of the sparsity pattern that was analysed
+    std::shared_ptr<ReorderCache> reorder_cache;                  // reorderings of sparsity patterns that were analysed before
     std::unique_ptr<BlockedMatrix<block_size> > mat = nullptr;    // original matrix 
     BlockedMatrix<block_size> *rmat = nullptr;                    // reordered matrix (or original if no reordering), used for spmv
     ILUReorder opencl_ilu_reorder;                                // reordering strategy
+    int ilu_fill_level;                                           // level of fill-in of BILU0
+    double ilu_relaxation;                                        // relaxation of BILU0
+    std::string kernel_cache_dir;                                 // directory for the compiled kernels, empty if not used
     std::vector<cl::Event> events;
     cl_int err;
 
@@ -92,6 +130,7 @@ private:
     unsigned int ceilDivision(const unsigned int A, const unsigned int B);
 
     /// Calculate dot product between in1 and in2, partial sums are stored in out, which are summed on CPU
+    /// In a parallel run, the ghost entries are skipped and the result is summed over all processes
     /// \param[in] in1           input vector 1
     /// \param[in] in2           input vector 2
     /// \param[out] out          output vector containing partial sums
@@ -100,6 +139,7 @@ private:
 
     /// Calculate the norm of in, partial sums are stored in out, which are summed on the CPU
     /// Equal to Dune::DenseVector::two_norm()
+    /// In a parallel run, the ghost entries are skipped and the result is summed over all processes
     /// \param[in] in          input vector
     /// \param[out] out        output vector containing partial sums
     /// \return                norm
@@ -130,6 +170,25 @@ private:
     /// \param[out] b       output vector
     void spmv_blocked_w(cl::Buffer vals, cl::Buffer cols, cl::Buffer rows, cl::Buffer x, cl::Buffer b);
 
+    /// Send the values of the owned entries of v to the processes that have them as ghost entries,
+    /// and overwrite the ghost entries of v with the values of their owners
+    /// Equal to Dune::OwnerOverlapCopyCommunication::copyOwnerToAll(), does nothing in a sequential run
+    /// \param[inout] v      vector to make consistent
+    void copy_owner_to_all(cl::Buffer& v);
+
+    /// Set the ghost entries of v to zero
+    /// Equal to Dune::OwnerOverlapCopyCommunication::project(), does nothing in a sequential run
+    /// \param[inout] v      vector to project
+    void project(cl::Buffer& v);
+
+    /// Allocate the GPU buffers for communication, must be called after analyse_matrix() determined the reordering
+    void setup_communication();
+
+    /// Apply the selected preconditioner, y = prec(x)
+    /// \param[in] x       input vector
+    /// \param[out] y      output vector
+    void apply_preconditioner(cl::Buffer& x, cl::Buffer& y);
+
     /// Solve linear system using ilu0-bicgstab
     /// \param[in] wellContribs   WellContributions, to apply them separately, instead of adding them to matrix A
     /// \param[inout] res         summary of solver result
@@ -147,9 +206,19 @@ private:
     /// Generate and compile opencl kernels
     void get_opencl_kernels();
 
+    /// Build the program of the kernels, the compiled program is read from and written to kernel_cache_dir
+    /// The cached binaries are identified by the device, the driver version and the kernel sources
+    /// \param[in] sources       sources of the kernels
+    /// \return                  the built program
+    cl::Program build_program(const cl::Program::Sources &sources);
+
     /// Clean memory
     void finalize();
 
+    /// Drop the analysis and the memory that depends on the sparsity pattern, when the pattern has changed
+    /// The next solve initializes and analyses again, reorderings of known patterns are taken from reorder_cache
+    void reset_pattern();
+
     /// Copy linear system to GPU
     void copy_system_to_gpu();
 
@@ -159,8 +228,13 @@ private:
     /// \param[out] wellContribs  WellContributions, to set reordering
     void update_system(double *vals, double *b, WellContributions &wellContribs);
 
-    /// Update linear system on GPU, don't copy rowpointers and colindices, they stay the same
-    void update_system_on_gpu();
+    /// Start updating the linear system on GPU, don't copy rowpointers and colindices, they stay the same
+    /// Only the blockrows of the matrix that changed since the last transfer are copied to the pinned
+    /// staging buffer, and asynchronously transferred to the GPU
+    void start_update_system_on_gpu();
+
+    /// Wait until the transfers started by start_update_system_on_gpu() are done
+    void finish_update_system_on_gpu();
 
     /// Analyse sparsity pattern to extract parallelism
     /// \return true iff analysis was successful
@@ -186,7 +260,11 @@ public:
     /// \param[in] platformID                 the OpenCL platform to be used
     /// \param[in] deviceID                   the device to be used
     /// \param[in] opencl_ilu_reorder         select either level_scheduling or graph_coloring, see BILU0.hpp for explanation
-    openclSolverBackend(int linear_solver_verbosity, int maxit, double tolerance, unsigned int platformID, unsigned int deviceID, ILUReorder opencl_ilu_reorder);
+    /// \param[in] use_cpr                    use the CPR preconditioner instead of BILU0, see CPR.hpp
+    /// \param[in] ilu_fill_level             level of fill-in of BILU0, 0 gives ILU0
+    /// \param[in] ilu_relaxation             fraction of the dropped fill-in that BILU0 adds to the diagonal
+    /// \param[in] kernel_cache_dir           directory for the compiled kernels, empty to always compile them
+    openclSolverBackend(int linear_solver_verbosity, int maxit, double tolerance, unsigned int platformID, unsigned int deviceID, ILUReorder opencl_ilu_reorder, bool use_cpr, int ilu_fill_level, double ilu_relaxation, std::string kernel_cache_dir);
 
     /// Destroy a openclSolver, and free memory
     ~openclSolverBackend();
@@ -212,6 +290,12 @@ public:
     /// \param[inout] x          resulting x vector, caller must guarantee that x points to a valid array
     void get_result(double *x) override;
 
+    /// Solve a linear system that is distributed over MPI processes, only the owned rows are used
+    /// in the reductions, and the ghost rows are updated after every matrix and preconditioner application
+    /// \param[in] comm     describes the ghost rows of this process, and how to communicate with the others
+    /// \return             true
+    bool setCommunication(std::shared_ptr<BdaCommunication> comm) override;
+
 }; // end class openclSolverBackend
 
 } // namespace bda
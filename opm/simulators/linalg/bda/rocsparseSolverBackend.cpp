@@ -0,0 +1,439 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <dune/common/timer.hh>
+
+#include <opm/simulators/linalg/bda/rocsparseSolverBackend.hpp>
+#include <opm/simulators/linalg/bda/rocsparse_header.hpp>
+#include <opm/simulators/linalg/bda/BdaResult.hpp>
+
+// For more information about rocsparse, check https://rocsparse.readthedocs.io
+
+namespace bda
+{
+
+using Opm::OpmLog;
+using Dune::Timer;
+
+const rocsparse_operation operation = rocsparse_operation_none;
+const rocsparse_direction dir = rocsparse_direction_row;
+
+
+template <unsigned int block_size>
+rocsparseSolverBackend<block_size>::rocsparseSolverBackend(int verbosity_, int maxit_, double tolerance_, unsigned int deviceID_) : BdaSolver<block_size>(verbosity_, maxit_, tolerance_, deviceID_) {}
+
+template <unsigned int block_size>
+rocsparseSolverBackend<block_size>::~rocsparseSolverBackend() {
+    finalize();
+}
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::apply_ilu0(const double *x, double *y) {
+    double one = 1.0;
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_solve(handle, dir, operation, Nb, nnzb, &one, descr_L,
+                                           d_Mvals, d_Arows, d_Acols, block_size, ilu_info,
+                                           x, d_t, rocsparse_solve_policy_auto, d_buffer));
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_solve(handle, dir, operation, Nb, nnzb, &one, descr_U,
+                                           d_Mvals, d_Arows, d_Acols, block_size, ilu_info,
+                                           d_t, y, rocsparse_solve_policy_auto, d_buffer));
+}
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::spmv(WellContributions& wellContribs, double *x, double *y) {
+    double zero = 0.0;
+    double one  = 1.0;
+    ROCSPARSE_CHECK(rocsparse_dbsrmv(handle, dir, operation, Nb, Nb, nnzb, &one, descr_A,
+                                     d_Avals, d_Arows, d_Acols, block_size, x, &zero, y));
+
+    // apply wellContributions
+    if (wellContribs.getNumWells() > 0) {
+        wellContribs.apply_rocsparse(x, y);
+    }
+}
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
+    Timer t_total;
+    int n = N;
+    float it;
+    double rho = 1.0, rhop, beta, alpha = 1.0, nalpha, omega = 1.0, nomega, tmp1, tmp2;
+    double norm, norm_0;
+    double one  = 1.0;
+
+    if (wellContribs.getNumWells() > 0) {
+        wellContribs.setRocsparseHandle(handle, stream);
+        wellContribs.setVectorSize(N);
+    }
+
+    // x is 0, so r = b
+    HIP_CHECK(hipMemcpyAsync(d_r, d_b, sizeof(double) * N, hipMemcpyDeviceToDevice, stream));
+    ROCBLAS_CHECK(rocblas_dcopy(blasHandle, n, d_r, 1, d_rw, 1));
+    ROCBLAS_CHECK(rocblas_dcopy(blasHandle, n, d_r, 1, d_p, 1));
+    HIP_CHECK(hipMemsetAsync(d_v, 0, sizeof(double) * N, stream));
+    ROCBLAS_CHECK(rocblas_dnrm2(blasHandle, n, d_r, 1, &norm_0));
+    norm = norm_0;
+
+    if (verbosity > 1) {
+        std::ostringstream out;
+        out << std::scientific << "rocsparseSolver initial norm: " << norm_0;
+        OpmLog::info(out.str());
+    }
+
+    // rocblas uses rocblas_pointer_mode_host, so the reductions wait for the GPU
+    for (it = 0.5; it < maxit; it += 0.5) {
+        rhop = rho;
+        ROCBLAS_CHECK(rocblas_ddot(blasHandle, n, d_rw, 1, d_r, 1, &rho));
+
+        if (it > 1) {
+            // p = r + beta * (p - omega * v)
+            beta = (rho / rhop) * (alpha / omega);
+            nomega = -omega;
+            ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &nomega, d_v, 1, d_p, 1));
+            ROCBLAS_CHECK(rocblas_dscal(blasHandle, n, &beta, d_p, 1));
+            ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &one, d_r, 1, d_p, 1));
+        }
+
+        // pw = prec(p), v = A * pw
+        apply_ilu0(d_p, d_pw);
+        spmv(wellContribs, d_pw, d_v);
+
+        ROCBLAS_CHECK(rocblas_ddot(blasHandle, n, d_rw, 1, d_v, 1, &tmp1));
+        alpha = rho / tmp1;
+        nalpha = -alpha;
+        ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &nalpha, d_v, 1, d_r, 1));   // r = r - alpha * v
+        ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &alpha, d_pw, 1, d_x, 1));   // x = x + alpha * pw
+        ROCBLAS_CHECK(rocblas_dnrm2(blasHandle, n, d_r, 1, &norm));
+
+        if (norm < tolerance * norm_0) {
+            break;
+        }
+
+        it += 0.5;
+
+        // s = prec(r), t = A * s
+        apply_ilu0(d_r, d_s);
+        spmv(wellContribs, d_s, d_t);
+
+        ROCBLAS_CHECK(rocblas_ddot(blasHandle, n, d_t, 1, d_r, 1, &tmp1));
+        ROCBLAS_CHECK(rocblas_ddot(blasHandle, n, d_t, 1, d_t, 1, &tmp2));
+        omega = tmp1 / tmp2;
+        nomega = -omega;
+        ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &omega, d_s, 1, d_x, 1));    // x = x + omega * s
+        ROCBLAS_CHECK(rocblas_daxpy(blasHandle, n, &nomega, d_t, 1, d_r, 1));   // r = r - omega * t
+        ROCBLAS_CHECK(rocblas_dnrm2(blasHandle, n, d_r, 1, &norm));
+
+        if (norm < tolerance * norm_0) {
+            break;
+        }
+
+        if (verbosity > 1) {
+            std::ostringstream out;
+            out << "it: " << it << std::scientific << ", norm: " << norm;
+            OpmLog::info(out.str());
+        }
+    }
+
+    res.iterations = std::min(it, (float)maxit);
+    res.reduction = norm / norm_0;
+    res.conv_rate  = static_cast<double>(pow(res.reduction, 1.0 / it));
+    res.elapsed = t_total.stop();
+    res.converged = (it != (maxit + 0.5));
+
+    if (verbosity > 0) {
+        std::ostringstream out;
+        out << "=== converged: " << res.converged << ", conv_rate: " << res.conv_rate << ", time: " << res.elapsed << \
+            ", time per iteration: " << res.elapsed / it << ", iterations: " << it;
+        OpmLog::info(out.str());
+    }
+}
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::initialize(int N, int nnz, int dim) {
+    this->N = N;
+    this->nnz = nnz;
+    this->nnzb = nnz / block_size / block_size;
+    Nb = (N + dim - 1) / dim;
+    std::ostringstream out;
+    out << "Initializing GPU, matrix size: " << N << " blocks, nnz: " << nnzb << " blocks";
+    OpmLog::info(out.str());
+    out.str("");
+    out.clear();
+    out << "Maxit: " << maxit << std::scientific << ", tolerance: " << tolerance;
+    OpmLog::info(out.str());
+
+    HIP_CHECK(hipSetDevice(deviceID));
+    hipDeviceProp_t props;
+    HIP_CHECK(hipGetDeviceProperties(&props, deviceID));
+    out.str("");
+    out.clear();
+    out << "Name GPU: " << props.name << ", architecture: " << props.gcnArchName;
+    OpmLog::info(out.str());
+
+    HIP_CHECK(hipStreamCreate(&stream));
+    ROCBLAS_CHECK(rocblas_create_handle(&blasHandle));
+    ROCSPARSE_CHECK(rocsparse_create_handle(&handle));
+    ROCBLAS_CHECK(rocblas_set_stream(blasHandle, stream));
+    ROCSPARSE_CHECK(rocsparse_set_stream(handle, stream));
+
+    HIP_CHECK(hipMalloc((void**)&d_x, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_b, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_r, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_rw, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_p, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_pw, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_s, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_t, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_v, sizeof(double) * N));
+    HIP_CHECK(hipMalloc((void**)&d_Avals, sizeof(double) * nnz));
+    HIP_CHECK(hipMalloc((void**)&d_Acols, sizeof(int) * nnzb));
+    HIP_CHECK(hipMalloc((void**)&d_Arows, sizeof(int) * (Nb + 1)));
+    HIP_CHECK(hipMalloc((void**)&d_Mvals, sizeof(double) * nnz));
+    d_buffer = nullptr;
+
+    initialized = true;
+} // end initialize()
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::finalize() {
+    if (initialized) {
+        hipFree(d_x);
+        hipFree(d_b);
+        hipFree(d_r);
+        hipFree(d_rw);
+        hipFree(d_p);
+        hipFree(d_pw);
+        hipFree(d_s);
+        hipFree(d_t);
+        hipFree(d_v);
+        hipFree(d_Mvals);
+        hipFree(d_Avals);
+        hipFree(d_Acols);
+        hipFree(d_Arows);
+        hipFree(d_buffer);
+        if (analysis_done) {
+            rocsparse_destroy_mat_info(ilu_info);
+            rocsparse_destroy_mat_descr(descr_A);
+            rocsparse_destroy_mat_descr(descr_M);
+            rocsparse_destroy_mat_descr(descr_L);
+            rocsparse_destroy_mat_descr(descr_U);
+        }
+        rocsparse_destroy_handle(handle);
+        rocblas_destroy_handle(blasHandle);
+        hipStreamDestroy(stream);
+    }
+} // end finalize()
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::copy_system_to_gpu(double *vals, int *rows, int *cols, double *b) {
+    Timer t;
+
+    HIP_CHECK(hipMemcpyAsync(d_Avals, vals, nnz * sizeof(double), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemcpyAsync(d_Acols, cols, nnzb * sizeof(int), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemcpyAsync(d_Arows, rows, (Nb + 1) * sizeof(int), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemcpyAsync(d_b, b, N * sizeof(double), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemsetAsync(d_x, 0, sizeof(double) * N, stream));
+
+    if (verbosity > 2) {
+        HIP_CHECK(hipStreamSynchronize(stream));
+        std::ostringstream out;
+        out << "rocsparseSolver::copy_system_to_gpu(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+} // end copy_system_to_gpu()
+
+
+// don't copy rowpointers and colindices, they stay the same
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::update_system_on_gpu(double *vals, double *b) {
+    Timer t;
+
+    HIP_CHECK(hipMemcpyAsync(d_Avals, vals, nnz * sizeof(double), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemcpyAsync(d_b, b, N * sizeof(double), hipMemcpyHostToDevice, stream));
+    HIP_CHECK(hipMemsetAsync(d_x, 0, sizeof(double) * N, stream));
+
+    if (verbosity > 2) {
+        HIP_CHECK(hipStreamSynchronize(stream));
+        std::ostringstream out;
+        out << "rocsparseSolver::update_system_on_gpu(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+} // end update_system_on_gpu()
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::reset_prec_on_gpu() {
+    HIP_CHECK(hipMemcpyAsync(d_Mvals, d_Avals, nnz * sizeof(double), hipMemcpyDeviceToDevice, stream));
+}
+
+
+template <unsigned int block_size>
+bool rocsparseSolverBackend<block_size>::analyse_matrix() {
+    std::size_t d_bufferSize_M, d_bufferSize_L, d_bufferSize_U, d_bufferSize;
+    Timer t;
+
+    ROCSPARSE_CHECK(rocsparse_create_mat_descr(&descr_A));
+    ROCSPARSE_CHECK(rocsparse_create_mat_descr(&descr_M));
+
+    ROCSPARSE_CHECK(rocsparse_create_mat_descr(&descr_L));
+    ROCSPARSE_CHECK(rocsparse_set_mat_fill_mode(descr_L, rocsparse_fill_mode_lower));
+    ROCSPARSE_CHECK(rocsparse_set_mat_diag_type(descr_L, rocsparse_diag_type_unit));
+
+    ROCSPARSE_CHECK(rocsparse_create_mat_descr(&descr_U));
+    ROCSPARSE_CHECK(rocsparse_set_mat_fill_mode(descr_U, rocsparse_fill_mode_upper));
+    ROCSPARSE_CHECK(rocsparse_set_mat_diag_type(descr_U, rocsparse_diag_type_non_unit));
+
+    ROCSPARSE_CHECK(rocsparse_create_mat_info(&ilu_info));
+
+    ROCSPARSE_CHECK(rocsparse_dbsrilu0_buffer_size(handle, dir, Nb, nnzb, descr_M,
+                                                   d_Avals, d_Arows, d_Acols, block_size, ilu_info, &d_bufferSize_M));
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_buffer_size(handle, dir, operation, Nb, nnzb, descr_L,
+                                                 d_Avals, d_Arows, d_Acols, block_size, ilu_info, &d_bufferSize_L));
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_buffer_size(handle, dir, operation, Nb, nnzb, descr_U,
+                                                 d_Avals, d_Arows, d_Acols, block_size, ilu_info, &d_bufferSize_U));
+    d_bufferSize = std::max(d_bufferSize_M, std::max(d_bufferSize_L, d_bufferSize_U));
+
+    HIP_CHECK(hipMalloc(&d_buffer, d_bufferSize));
+
+    // analysis of ilu LU decomposition
+    ROCSPARSE_CHECK(rocsparse_dbsrilu0_analysis(handle, dir, Nb, nnzb, descr_M,
+                                                d_Avals, d_Arows, d_Acols, block_size, ilu_info,
+                                                rocsparse_analysis_policy_reuse, rocsparse_solve_policy_auto, d_buffer));
+
+    rocsparse_int zero_position = 0;
+    rocsparse_status status = rocsparse_bsrilu0_zero_pivot(handle, ilu_info, &zero_position);
+    if (rocsparse_status_zero_pivot == status) {
+        return false;
+    }
+
+    // analysis of ilu apply
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_analysis(handle, dir, operation, Nb, nnzb, descr_L,
+                                              d_Avals, d_Arows, d_Acols, block_size, ilu_info,
+                                              rocsparse_analysis_policy_reuse, rocsparse_solve_policy_auto, d_buffer));
+    ROCSPARSE_CHECK(rocsparse_dbsrsv_analysis(handle, dir, operation, Nb, nnzb, descr_U,
+                                              d_Avals, d_Arows, d_Acols, block_size, ilu_info,
+                                              rocsparse_analysis_policy_reuse, rocsparse_solve_policy_auto, d_buffer));
+
+    if (verbosity > 2) {
+        HIP_CHECK(hipStreamSynchronize(stream));
+        std::ostringstream out;
+        out << "rocsparseSolver::analyse_matrix(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+
+    analysis_done = true;
+
+    return true;
+} // end analyse_matrix()
+
+template <unsigned int block_size>
+bool rocsparseSolverBackend<block_size>::create_preconditioner() {
+    Timer t;
+
+    ROCSPARSE_CHECK(rocsparse_dbsrilu0(handle, dir, Nb, nnzb, descr_M,
+                                       d_Mvals, d_Arows, d_Acols, block_size, ilu_info,
+                                       rocsparse_solve_policy_auto, d_buffer));
+
+    // rocsparse_bsrilu0_zero_pivot() synchronizes with the GPU
+    rocsparse_int zero_position = 0;
+    rocsparse_status status = rocsparse_bsrilu0_zero_pivot(handle, ilu_info, &zero_position);
+    if (rocsparse_status_zero_pivot == status) {
+        return false;
+    }
+
+    if (verbosity > 2) {
+        HIP_CHECK(hipStreamSynchronize(stream));
+        std::ostringstream out;
+        out << "rocsparseSolver::create_preconditioner(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+    return true;
+} // end create_preconditioner()
+
+
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::solve_system(WellContributions& wellContribs, BdaResult &res) {
+    // actually solve
+    gpu_pbicgstab(wellContribs, res);
+    HIP_CHECK(hipStreamSynchronize(stream));
+} // end solve_system()
+
+
+// copy result to host memory
+// caller must be sure that x is a valid array
+template <unsigned int block_size>
+void rocsparseSolverBackend<block_size>::get_result(double *x) {
+    Timer t;
+
+    HIP_CHECK(hipMemcpyAsync(x, d_x, N * sizeof(double), hipMemcpyDeviceToHost, stream));
+    HIP_CHECK(hipStreamSynchronize(stream));
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "rocsparseSolver::get_result(): " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+} // end get_result()
+
+
+template <unsigned int block_size>
+SolverStatus rocsparseSolverBackend<block_size>::solve_system(int N, int nnz, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res) {
+    if (initialized == false) {
+        initialize(N, nnz, dim);
+        copy_system_to_gpu(vals, rows, cols, b);
+    } else {
+        update_system_on_gpu(vals, b);
+    }
+    if (analysis_done == false) {
+        if (!analyse_matrix()) {
+            return SolverStatus::BDA_SOLVER_ANALYSIS_FAILED;
+        }
+    }
+    reset_prec_on_gpu();
+    if (create_preconditioner()) {
+        solve_system(wellContribs, res);
+    } else {
+        return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+    }
+    return SolverStatus::BDA_SOLVER_SUCCESS;
+}
+
+
+#define INSTANTIATE_BDA_FUNCTIONS(n)                                                         \
+template rocsparseSolverBackend<n>::rocsparseSolverBackend(int, int, double, unsigned int);  \
+
+INSTANTIATE_BDA_FUNCTIONS(1);
+INSTANTIATE_BDA_FUNCTIONS(2);
+INSTANTIATE_BDA_FUNCTIONS(3);
+INSTANTIATE_BDA_FUNCTIONS(4);
+
+#undef INSTANTIATE_BDA_FUNCTIONS
+
+} // namespace bda
@@ -0,0 +1,67 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROCSPARSE_HEADER_HEADER_INCLUDED
+#define ROCSPARSE_HEADER_HEADER_INCLUDED
+
+#include <hip/hip_runtime_api.h>
+#include <rocblas.h>
+#include <rocsparse.h>
+#include <sstream>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+/// Runtime error checking of HIP, rocSPARSE and rocBLAS functions
+/// Usage:
+/// HIP_CHECK(hipMalloc(...));
+/// ROCSPARSE_CHECK(rocsparse_dbsrmv(...));
+///
+#define HIP_CHECK(call)          __hipCheckError((call), __FILE__, __LINE__, #call)
+#define ROCSPARSE_CHECK(call)    __rocsparseCheckError((call), __FILE__, __LINE__, #call)
+#define ROCBLAS_CHECK(call)      __rocblasCheckError((call), __FILE__, __LINE__, #call)
+
+inline void __hipCheckError(hipError_t err, const char *file, const int line, const char *call){
+    if (hipSuccess != err){
+        std::ostringstream out;
+        out << hipGetErrorString(err) << "\n";
+        out << "BDA error in " << file << ":" << line << ": " << call << "\n";
+        OPM_THROW(std::logic_error, out.str());
+    }
+}
+
+inline void __rocsparseCheckError(rocsparse_status status, const char *file, const int line, const char *call){
+    if (rocsparse_status_success != status){
+        std::ostringstream out;
+        out << "rocsparse status " << status << "\n";
+        out << "BDA error in " << file << ":" << line << ": " << call << "\n";
+        OPM_THROW(std::logic_error, out.str());
+    }
+}
+
+inline void __rocblasCheckError(rocblas_status status, const char *file, const int line, const char *call){
+    if (rocblas_status_success != status){
+        std::ostringstream out;
+        out << rocblas_status_to_string(status) << "\n";
+        out << "BDA error in " << file << ":" << line << ": " << call << "\n";
+        OPM_THROW(std::logic_error, out.str());
+    }
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BLOCK_SPMV_HEADER_INCLUDED
+#define OPM_BLOCK_SPMV_HEADER_INCLUDED
+
+#include <cstddef>
+
+namespace Opm
+{
+
+namespace Details
+{
+    /// Compute the product of one block row of a BCRS matrix with x.
+    ///
+    /// The block size N is a compile time constant, so the loops over
+    /// the block entries are fully unrolled and the accumulator stays in
+    /// registers. The column index and the block are read directly from
+    /// the row storage, once per block.
+    template <int N, class Field, class Row, class X>
+    inline void blockRowProduct(const Row& row, const X& x, Field (&acc)[N])
+    {
+        for (int r = 0; r < N; ++r) {
+            acc[r] = 0.0;
+        }
+        const auto* blocks = row.getptr();
+        const auto* cols = row.getindexptr();
+        const auto nnz = row.getsize();
+        for (std::size_t k = 0; k < nnz; ++k) {
+            const auto& b = blocks[k];
+            const auto& xj = x[cols[k]];
+            for (int r = 0; r < N; ++r) {
+                for (int c = 0; c < N; ++c) {
+                    acc[r] += b[r][c] * xj[c];
+                }
+            }
+        }
+    }
+
+    /// Rows are only distributed over threads above this size.
+    constexpr std::size_t blockSpMVMinRowsPerThread = 4096;
+} // namespace Details
+
+/// Compute y = A x for the first numRows rows of A.
+///
+/// Specialised on the (compile time) block size of the matrix, which
+/// avoids the generic dense loops of BCRSMatrix::mv(). Rows beyond
+/// numRows are left untouched.
+template <class Matrix, class X, class Y>
+void blockSpMV(const Matrix& A, const X& x, Y& y, const std::size_t numRows)
+{
+    using Field = typename Matrix::field_type;
+    constexpr int N = Matrix::block_type::rows;
+    static_assert(N == static_cast<int>(Matrix::block_type::cols),
+                  "blockSpMV() requires square blocks");
+    const long long nrows = static_cast<long long>(numRows);
+#ifdef _OPENMP
+#pragma omp parallel for if(numRows > Details::blockSpMVMinRowsPerThread)
+#endif
+    for (long long i = 0; i < nrows; ++i) {
+        Field acc[N];
+        Details::blockRowProduct<N>(A[i], x, acc);
+        auto& yi = y[i];
+        for (int r = 0; r < N; ++r) {
+            yi[r] = acc[r];
+        }
+    }
+}
+
+/// Compute y += alpha A x for the first numRows rows of A.
+template <class Matrix, class X, class Y>
+void blockSpMVScaleAdd(const typename Matrix::field_type alpha,
+                       const Matrix& A, const X& x, Y& y, const std::size_t numRows)
+{
+    using Field = typename Matrix::field_type;
+    constexpr int N = Matrix::block_type::rows;
+    static_assert(N == static_cast<int>(Matrix::block_type::cols),
+                  "blockSpMVScaleAdd() requires square blocks");
+    const long long nrows = static_cast<long long>(numRows);
+#ifdef _OPENMP
+#pragma omp parallel for if(numRows > Details::blockSpMVMinRowsPerThread)
+#endif
+    for (long long i = 0; i < nrows; ++i) {
+        Field acc[N];
+        Details::blockRowProduct<N>(A[i], x, acc);
+        auto& yi = y[i];
+        for (int r = 0; r < N; ++r) {
+            yi[r] += alpha * acc[r];
+        }
+    }
+}
+
+} // namespace Opm
+
+#endif // OPM_BLOCK_SPMV_HEADER_INCLUDED
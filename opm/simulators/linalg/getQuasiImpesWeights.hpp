@@ -24,6 +24,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <exception>
+#include <vector>
 
 namespace Opm
 {
@@ -40,6 +42,57 @@ namespace Details
 
         return tmp;
     }
+
+    // The quasi-IMPES weights of a row: the solution of D^T w = e_p, or of
+    // D w = e_p for the transposed CPR, scaled to a maximum norm of one.
+    template <class MatrixBlock, class VectorBlock>
+    void quasiImpesBlockWeights(const MatrixBlock& diag_block, const int pressureVarIndex, const bool transpose,
+                                VectorBlock& bweights)
+    {
+        VectorBlock rhs(0.0);
+        rhs[pressureVarIndex] = 1.0;
+        if (transpose) {
+            diag_block.solve(bweights, rhs);
+        } else {
+            transposeDenseMatrix(diag_block).solve(bweights, rhs);
+        }
+        double abs_max = *std::max_element(
+            bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
+        bweights /= std::fabs(abs_max);
+    }
+
+    template <class Row>
+    typename Row::block_type diagonalBlock(const Row& row, const typename Row::size_type rowIdx)
+    {
+        const auto diag = row.find(rowIdx);
+        return diag != row.end() ? *diag : typename Row::block_type(0.0);
+    }
+
+    // Call func(rowIdx) for all rows, in parallel since the rows are
+    // independent. The first exception is rethrown afterwards.
+    template <class Func>
+    void forEachRow(const long long numRows, const Func& func)
+    {
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long long r = 0; r < numRows; ++r) {
+            try {
+                func(r);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc) {
+                    exc = std::current_exception();
+                }
+            }
+        }
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+    }
 } // namespace Details
 
 namespace Amg
@@ -47,34 +100,39 @@ namespace Amg
     template <class Matrix, class Vector>
     void getQuasiImpesWeights(const Matrix& matrix, const int pressureVarIndex, const bool transpose, Vector& weights)
     {
-        using VectorBlockType = typename Vector::block_type;
-        using MatrixBlockType = typename Matrix::block_type;
-        const Matrix& A = matrix;
-        VectorBlockType rhs(0.0);
-        rhs[pressureVarIndex] = 1.0;
-        const auto endi = A.end();
-        for (auto i = A.begin(); i != endi; ++i) {
-            const auto endj = (*i).end();
-            MatrixBlockType diag_block(0.0);
-            for (auto j = (*i).begin(); j != endj; ++j) {
-                if (i.index() == j.index()) {
-                    diag_block = (*j);
-                    break;
+        Details::forEachRow(matrix.N(), [&](const long long r) {
+            Details::quasiImpesBlockWeights(Details::diagonalBlock(matrix[r], r), pressureVarIndex, transpose,
+                                            weights[r]);
+        });
+    }
+
+    /// \brief Update the quasi-IMPES weights of the rows whose diagonal block
+    ///        changed by more than a relative tolerance.
+    ///
+    /// diagonals holds the diagonal blocks the weights were computed from.
+    /// All weights are computed if it does not match the matrix.
+    template <class Matrix, class Vector>
+    void updateQuasiImpesWeights(const Matrix& matrix, const int pressureVarIndex, const bool transpose,
+                                 const double tolerance, std::vector<typename Matrix::block_type>& diagonals,
+                                 Vector& weights)
+    {
+        const bool computeAll = diagonals.size() != matrix.N() || weights.size() != matrix.N();
+        if (computeAll) {
+            diagonals.resize(matrix.N());
+            weights.resize(matrix.N());
+        }
+        Details::forEachRow(matrix.N(), [&](const long long r) {
+            const auto diag_block = Details::diagonalBlock(matrix[r], r);
+            if (!computeAll) {
+                auto change = diag_block;
+                change -= diagonals[r];
+                if (change.infinity_norm() <= tolerance * diagonals[r].infinity_norm()) {
+                    return;
                 }
             }
-            VectorBlockType bweights;
-            if (transpose) {
-                diag_block.solve(bweights, rhs);
-            } else {
-                auto diag_block_transpose = Details::transposeDenseMatrix(diag_block);
-                diag_block_transpose.solve(bweights, rhs);
-            }
-            double abs_max = *std::max_element(
-                bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
-            bweights /= std::fabs(abs_max);
-            weights[i.index()] = bweights;
-        }
-        // return weights;
+            diagonals[r] = diag_block;
+            Details::quasiImpesBlockWeights(diag_block, pressureVarIndex, transpose, weights[r]);
+        });
     }
 
     template <class Matrix, class Vector>
@@ -35,14 +35,21 @@ setupCPR(const std::string& conf, const FlowLinearSolverParameters& p)
     prm.put("tol", p.linear_solver_reduction_);
     prm.put("verbosity", p.linear_solver_verbosity_);
     prm.put("solver", "bicgstab");
-    prm.put("preconditioner.type", "cpr");
-    if (conf == "cpr_quasiimpes") {
+    if (conf == "cprw") {
+        // The wells are part of the pressure system. Their equations are
+        // weighted quasi-IMPES, and so are the cells.
+        prm.put("preconditioner.type", "cprw");
+        prm.put("preconditioner.weight_type", "quasiimpes");
+    } else if (conf == "cpr_quasiimpes") {
+        prm.put("preconditioner.type", "cpr");
         prm.put("preconditioner.weight_type", "quasiimpes");
     } else {
+        prm.put("preconditioner.type", "cpr");
         prm.put("preconditioner.weight_type", "trueimpes");
     }
     prm.put("preconditioner.finesmoother.type", "ParOverILU0");
     prm.put("preconditioner.finesmoother.relaxation", 1.0);
+    prm.put("preconditioner.finesmoother.reverse_cuthill_mckee", p.ilu_reverse_cuthill_mckee_);
     prm.put("preconditioner.pressure_var_index", 1);
     prm.put("preconditioner.verbosity", 0);
     prm.put("preconditioner.coarsesolver.maxiter", 1);
@@ -118,6 +125,21 @@ setupILU([[maybe_unused]] const std::string& conf, const FlowLinearSolverParamet
     prm.put("preconditioner.type", "ParOverILU0");
     prm.put("preconditioner.relaxation", p.ilu_relaxation_);
     prm.put("preconditioner.ilulevel", p.ilu_fillin_level_);
+    prm.put("preconditioner.reverse_cuthill_mckee", p.ilu_reverse_cuthill_mckee_);
+    return prm;
+}
+
+
+boost::property_tree::ptree
+setupUMFPack([[maybe_unused]] const std::string& conf, const FlowLinearSolverParameters& p)
+{
+    boost::property_tree::ptree prm;
+    prm.put("tol", p.linear_solver_reduction_);
+    prm.put("maxiter", p.linear_solver_maxiter_);
+    prm.put("verbosity", p.linear_solver_verbosity_);
+    prm.put("solver", "umfpack");
+    // not used by the direct solver, but always created
+    prm.put("preconditioner.type", "Jac");
     return prm;
 }
 
@@ -33,6 +33,7 @@ boost::property_tree::ptree setupPropertyTree(FlowLinearSolverParameters p);
 boost::property_tree::ptree setupCPR(const std::string& conf, const FlowLinearSolverParameters& p);
 boost::property_tree::ptree setupAMG(const std::string& conf, const FlowLinearSolverParameters& p);
 boost::property_tree::ptree setupILU(const std::string& conf, const FlowLinearSolverParameters& p);
+boost::property_tree::ptree setupUMFPack(const std::string& conf, const FlowLinearSolverParameters& p);
 
 } // namespace Opm
 
@@ -60,7 +60,7 @@ setupPropertyTree(FlowLinearSolverParameters p) // Note: copying the parameters
     }
 
     // Use CPR configuration.
-    if ((conf == "cpr") || (conf == "cpr_trueimpes") || (conf == "cpr_quasiimpes")) {
+    if ((conf == "cpr") || (conf == "cpr_trueimpes") || (conf == "cpr_quasiimpes") || (conf == "cprw")) {
         if (conf == "cpr") {
             // Treat "cpr" as short cut for the true IMPES variant.
             conf = "cpr_trueimpes";
@@ -80,6 +80,11 @@ setupPropertyTree(FlowLinearSolverParameters p) // Note: copying the parameters
         return setupAMG(conf, p);
     }
 
+    // Direct solver, e.g. as the last fallback for small systems.
+    if (conf == "umfpack") {
+        return setupUMFPack(conf, p);
+    }
+
     // Use ILU0 configuration.
     if (conf == "ilu0") {
         return setupILU(conf, p);
@@ -88,7 +93,7 @@ setupPropertyTree(FlowLinearSolverParameters p) // Note: copying the parameters
     // No valid configuration option found.
     OPM_THROW(std::invalid_argument,
               conf << " is not a valid setting for --linear-solver-configuration."
-              << " Please use ilu0, cpr, cpr_trueimpes, or cpr_quasiimpes");
+              << " Please use ilu0, cpr, cpr_trueimpes, cpr_quasiimpes, cprw, amg, or umfpack");
 }
 
 
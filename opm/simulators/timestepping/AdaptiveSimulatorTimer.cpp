@@ -18,6 +18,7 @@
 */
 
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -32,12 +33,14 @@ namespace Opm
     AdaptiveSimulatorTimer::
     AdaptiveSimulatorTimer( const SimulatorTimerInterface& timer,
                             const double lastStepTaken,
-                            const double maxTimeStep )
+                            const double maxTimeStep,
+                            const bool evenSubsteps )
         : start_date_time_( timer.startDateTime() )
         , start_time_( timer.simulationTimeElapsed() )
         , total_time_( start_time_ + timer.currentStepLength() )
         , report_step_( timer.reportStepNum() )
         , max_time_step_( maxTimeStep )
+        , even_substeps_( evenSubsteps )
         , current_time_( start_time_ )
         , dt_( 0.0 )
         , current_step_( 0 )
@@ -75,6 +78,15 @@ AdaptiveSimulatorTimer& AdaptiveSimulatorTimer::operator++ ()
         assert(dt_ > 0);
         if( remaining > 0 ) {
 
+            if( even_substeps_ ) {
+                // the fewest equal substeps which are at most slightly larger than
+                // the estimate, instead of a short substep at the end
+                const double maxSubstep = std::min( 1.05 * dt_, max_time_step_ );
+                dt_ = remaining / std::ceil( remaining / maxSubstep );
+                assert(dt_ > 0);
+                return;
+            }
+
             // set new time step (depending on remaining time)
             if( 1.05 * dt_ > remaining ) {
                 dt_ = remaining;
@@ -43,9 +43,11 @@ namespace Opm
         ///  \param timer          in case of sub stepping this is the outer timer
         ///  \param lastStepTaken  last suggested time step
         ///  \param maxTimeStep    maximum time step allowed
+        ///  \param evenSubsteps   split the remaining time into substeps of equal size
         AdaptiveSimulatorTimer( const SimulatorTimerInterface& timer,
                                 const double lastStepTaken,
-                                const double maxTimeStep = std::numeric_limits<double>::max() );
+                                const double maxTimeStep = std::numeric_limits<double>::max(),
+                                const bool evenSubsteps = false );
 
         /// \brief advance time by currentStepLength
         AdaptiveSimulatorTimer& operator++ ();
@@ -111,6 +113,7 @@ namespace Opm
         const double total_time_;
         const int report_step_;
         const double max_time_step_;
+        const bool even_substeps_;
 
         double current_time_;
         double dt_;
@@ -15,6 +15,8 @@
 #include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
 #include <opm/simulators/timestepping/TimeStepControlInterface.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/timestepping/TimeStepTuningCache.hpp>
+#include <opm/simulators/utils/ScopedTimers.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/common/Exceptions.hpp>
 
@@ -114,6 +116,14 @@ template<class TypeTag, class MyTypeTag>
 struct MinTimeStepBasedOnNewtonIterations {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct TimeStepTuningCacheFileName {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct TimeStepEvenSubsteps {
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct SolverRestartFactor<TypeTag, TTag::FlowTimeSteppingParameters> {
@@ -218,6 +228,14 @@ struct MinTimeStepBasedOnNewtonIterations<TypeTag, TTag::FlowTimeSteppingParamet
     using type = GetPropType<TypeTag, Scalar>;
     static constexpr type value = 0.0;
 };
+template<class TypeTag>
+struct TimeStepTuningCacheFileName<TypeTag, TTag::FlowTimeSteppingParameters> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct TimeStepEvenSubsteps<TypeTag, TTag::FlowTimeSteppingParameters> {
+    static constexpr bool value = true;
+};
 
 } // namespace Opm::Properties
 
@@ -328,7 +346,7 @@ namespace Opm {
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepAfterEventInDays,
                                  "Time step size of the first time step after an event occurs during the simulation in days");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControl,
-                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount', 'newtoniterationcount' and 'hardcoded'");
+                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount', 'newtoniterationcount', 'costmodel' and 'hardcoded'");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlTolerance,
                                  "The tolerance used by the time step size control algorithm");
             EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlTargetIterations,
@@ -338,7 +356,7 @@ namespace Opm {
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlDecayRate,
                                  "The decay rate of the time step size of the number of target iterations is exceeded");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlGrowthRate,
-                                 "The growth rate of the time step size of the number of target iterations is undercut");
+                                 "The growth rate of the time step size of the number of target iterations is undercut. For 'costmodel' the growth rate per converged step of the time step size at which steps are expected to fail");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlDecayDampingFactor,
                                  "The decay rate of the time step decrease when the target iterations is exceeded");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlGrowthDampingFactor,
@@ -349,6 +367,10 @@ namespace Opm {
                                  "The minimum time step size in days for which problematic wells are not shut");
             EWOMS_REGISTER_PARAM(TypeTag, double, MinTimeStepBasedOnNewtonIterations,
                                  "The minimum time step size (in days for field and metric unit and hours for lab unit) can be reduced to based on newton iteration counts");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepTuningCacheFileName,
+                                 "The file with the time steps of an earlier run of the same deck. The first substep of a report step which needed chopping in that run is started with the step size which converged, and the file is updated after every report step. Empty disables it");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, TimeStepEvenSubsteps,
+                                 "Split the rest of a report step into substeps of equal size instead of ending it with a short substep");
         }
 
         /** \brief  step method that acts like the solver::step method
@@ -377,11 +399,22 @@ namespace Opm {
                 suggestedNextTimestep_ = timestepAfterEvent_;
             }
 
+            // start with the reduction the first substeps after earlier events needed
+            if (isEvent) {
+                suggestedNextTimestep_ *= eventStepFactor_;
+            }
+
+            const int reportStep = simulatorTimer.currentStepNum();
+            if (tuningCache_) {
+                suggestedNextTimestep_ = tuningCache_->suggestedFirstStep(reportStep, suggestedNextTimestep_);
+            }
+
             auto& ebosSimulator = solver.model().ebosSimulator();
             auto& ebosProblem = ebosSimulator.problem();
 
             // create adaptive step timer with previously used sub step size
-            AdaptiveSimulatorTimer substepTimer(simulatorTimer, suggestedNextTimestep_, maxTimeStep_);
+            AdaptiveSimulatorTimer substepTimer(simulatorTimer, suggestedNextTimestep_, maxTimeStep_, evenSubsteps_);
+            const double firstSubstepAttempted = substepTimer.currentStepLength();
 
             // counter for solver restarts
             int restarts = 0;
@@ -405,6 +438,7 @@ namespace Opm {
                 SimulatorReportSingle substepReport;
                 std::string causeOfFailure = "";
                 try {
+                    ScopedTimer timeStepTimer("time step");
                     substepReport = solver.step(substepTimer);
                     if (solverVerbose_) {
                         // report number of linear iterations
@@ -452,8 +486,16 @@ namespace Opm {
                 }
 
                 report += substepReport;
+                timeStepControl_->recordStep(dt, substepReport);
+                if (tuningCache_) {
+                    tuningCache_->recordSubstep(reportStep, dt, substepReport.converged);
+                }
 
                 if (substepReport.converged) {
+                    if (isEvent && substepTimer.currentStepNum() == 0) {
+                        updateEventStepFactor_(firstSubstepAttempted, dt);
+                    }
+
                     // advance by current dt
                     ++substepTimer;
 
@@ -501,6 +543,7 @@ namespace Opm {
                         time::StopWatch perfTimer;
                         perfTimer.start();
 
+                        ScopedTimer outputTimer("output");
                         ebosProblem.writeOutput();
 
                         report.success.output_write_time += perfTimer.secsSinceStart();
@@ -609,6 +652,16 @@ namespace Opm {
             if (! std::isfinite(suggestedNextTimestep_)) { // check for NaN
                 suggestedNextTimestep_ = timestep;
             }
+
+            // all processes record the same substeps, one of them writes the
+            // file. A file which cannot be written does not stop the run.
+            if (tuningCache_ && !tuningCacheFileName_.empty() && ebosSimulator.gridView().comm().rank() == 0) {
+                if (!tuningCache_->save(tuningCacheFileName_)) {
+                    OpmLog::warning("Cannot write the time step tuning cache " + tuningCacheFileName_
+                                    + ", it is not updated in this run");
+                    tuningCacheFileName_.clear();
+                }
+            }
             return report;
         }
 
@@ -633,6 +686,18 @@ namespace Opm {
 
 
     protected:
+        /// Learn from the first substep after an event: if it had to be
+        /// chopped, the next event starts with the same reduction, otherwise
+        /// the reduction is relaxed by the growth factor.
+        void updateEventStepFactor_(const double attempted, const double converged)
+        {
+            if (converged < attempted) {
+                eventStepFactor_ *= converged / attempted;
+            } else {
+                eventStepFactor_ = std::min(1.0, eventStepFactor_ * growthFactor_);
+            }
+        }
+
         void init_(const UnitSystem& unitSystem)
         {
             // valid are "pid" and "pid+iteration"
@@ -672,6 +737,11 @@ namespace Opm {
                 timeStepControl_ = TimeStepControlType(new SimpleIterationCountTimeStepControl(iterations, decayrate, growthrate));
                 useNewtonIteration_ = true;
             }
+            else if (control == "costmodel") {
+                const double recoveryRate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlGrowthRate); // 1.25
+                timeStepControl_ = TimeStepControlType(new CostModelTimeStepControl(recoveryRate));
+                useNewtonIteration_ = true;
+            }
             else if (control == "hardcoded") {
                 const std::string filename = EWOMS_GET_PARAM(TypeTag, std::string, TimeStepControlFileName); // "timesteps"
                 timeStepControl_ = TimeStepControlType(new HardcodedTimeStepControl(filename));
@@ -680,6 +750,13 @@ namespace Opm {
             else
                 OPM_THROW(std::runtime_error,"Unsupported time step control selected "<< control);
 
+            evenSubsteps_ = EWOMS_GET_PARAM(TypeTag, bool, TimeStepEvenSubsteps); // true
+
+            tuningCacheFileName_ = EWOMS_GET_PARAM(TypeTag, std::string, TimeStepTuningCacheFileName); // ""
+            if (!tuningCacheFileName_.empty()) {
+                tuningCache_ = std::make_unique<TimeStepTuningCache>(tuningCacheFileName_);
+            }
+
             // make sure growth factor is something reasonable
             assert(growthFactor_ >= 1.0);
         }
@@ -753,6 +830,10 @@ namespace Opm {
         double timestepAfterEvent_;         //!< suggested size of timestep after an event
         bool useNewtonIteration_;           //!< use newton iteration count for adaptive time step control
         double minTimeStepBeforeShuttingProblematicWells_; //! < shut problematic wells when time step size in days are less than this
+        bool evenSubsteps_ = true;          //!< split the rest of a report step into equal substeps
+        double eventStepFactor_ = 1.0;      //!< reduction of the first substep after an event, learned from earlier events
+        std::string tuningCacheFileName_; //!< file of the time step tuning cache
+        std::unique_ptr<TimeStepTuningCache> tuningCache_; //!< time steps of an earlier run, if enabled
     };
 }
 
@@ -136,6 +136,13 @@ namespace Opm
             }
             os << std::endl;
 
+            if (pressure_time > 0.0 || transport_time > 0.0) {
+                t = pressure_time + (failureReport ? failureReport->pressure_time : 0.0);
+                os << fmt::format("   Pressure stage (seconds):  {:7.2f}\n", t);
+                t = transport_time + (failureReport ? failureReport->transport_time : 0.0);
+                os << fmt::format("   Transport stage (seconds): {:7.2f}\n", t);
+            }
+
             t = update_time + (failureReport ? failureReport->update_time : 0.0);
             os << fmt::format(" Update time (seconds):       {:7.2f}", t);
             if (failureReport) {
@@ -19,6 +19,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -26,9 +27,11 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
+#include <opm/simulators/timestepping/SimulatorReport.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
 
 namespace Opm
@@ -206,4 +209,154 @@ namespace Opm
         return std::min(dtEstimatePID, dtEstimateIter);
     }
 
+
+    ////////////////////////////////////////////////////////////
+    //
+    //  CostModelTimeStepControl  Implementation
+    //
+    ////////////////////////////////////////////////////////////
+
+    CostModelTimeStepControl::
+    CostModelTimeStepControl( const double recoveryRate )
+        : recoveryRate_( recoveryRate )
+        , newtonIterationCost_( 1.0 )
+        , stepCost_( 0.0 )
+        , failedStepCost_( 0.0 )
+        , weight_( 0.0 )
+        , sumLogDt_( 0.0 )
+        , sumIterations_( 0.0 )
+        , sumLogDt2_( 0.0 )
+        , sumLogDtIterations_( 0.0 )
+        , failureStepSize_( std::numeric_limits<double>::infinity() )
+    {
+        if( recoveryRate_ <= 1.0 ) {
+            OPM_THROW(std::runtime_error,"CostModelTimeStepControl: recovery rate should be > 1 " << recoveryRate_ );
+        }
+    }
+
+    void CostModelTimeStepControl::
+    recordStep( const double dt, const SimulatorReportSingle& report )
+    {
+        // weight of the newest step in the running averages of the costs
+        const double alpha = 0.3;
+        const double iterationTime = report.assemble_time + report.linear_solve_time + report.update_time;
+
+        if( !report.converged ) {
+            const double cost = iterationTime + report.pre_post_time;
+            if( std::isinf( failureStepSize_ ) ) {
+                failedStepCost_ = cost;
+                failureStepSize_ = dt;
+            }
+            else {
+                failedStepCost_ = (1.0 - alpha) * failedStepCost_ + alpha * cost;
+                updateFailureStepSize_( dt, 1.0 );
+            }
+            return;
+        }
+
+        const double iterations = std::max( report.total_newton_iterations, 1u );
+        // without timings the cost is measured in Newton iterations
+        if( iterationTime > 0.0 ) {
+            if( weight_ == 0.0 ) {
+                newtonIterationCost_ = iterationTime / iterations;
+                stepCost_ = report.pre_post_time;
+            }
+            else {
+                newtonIterationCost_ = (1.0 - alpha) * newtonIterationCost_ + alpha * iterationTime / iterations;
+                stepCost_ = (1.0 - alpha) * stepCost_ + alpha * report.pre_post_time;
+            }
+        }
+
+        // the older steps are forgotten gradually
+        const double forgetting = 0.8;
+        const double logDt = std::log( dt );
+        weight_ = forgetting * weight_ + 1.0;
+        sumLogDt_ = forgetting * sumLogDt_ + logDt;
+        sumIterations_ = forgetting * sumIterations_ + iterations;
+        sumLogDt2_ = forgetting * sumLogDt2_ + logDt * logDt;
+        sumLogDtIterations_ = forgetting * sumLogDtIterations_ + logDt * iterations;
+
+        if( !std::isinf( failureStepSize_ ) ) {
+            updateFailureStepSize_( dt, 0.0 );
+        }
+    }
+
+    void CostModelTimeStepControl::
+    updateFailureStepSize_( const double dt, const double failed )
+    {
+        // Gradient step for the log likelihood of the outcome with respect to
+        // log(failureStepSize_), scaled such that a converged step of the size
+        // failureStepSize_ increases it by the recovery rate. Converged steps far
+        // below failureStepSize_ hardly change it, failed steps far below it
+        // reduce it a lot.
+        const double p = failureProbability( dt );
+        failureStepSize_ *= std::pow( recoveryRate_, 2.0 * (p - failed) );
+    }
+
+    double CostModelTimeStepControl::
+    expectedNewtonIterations( const double dt ) const
+    {
+        if( weight_ == 0.0 ) {
+            return 1.0;
+        }
+
+        // The slope is pulled towards two more iterations per doubling of the step size,
+        // which also gives a slope when all the recent steps had the same size.
+        const double priorSlope = 2.0 / std::log( 2.0 );
+        const double priorWeight = 1.0;
+
+        const double meanLogDt = sumLogDt_ / weight_;
+        const double meanIterations = sumIterations_ / weight_;
+        const double sxx = sumLogDt2_ - weight_ * meanLogDt * meanLogDt;
+        const double sxy = sumLogDtIterations_ - weight_ * meanLogDt * meanIterations;
+        const double slope = std::max( (sxy + priorWeight * priorSlope) / (std::max( sxx, 0.0 ) + priorWeight), 0.0 );
+
+        return std::max( meanIterations + slope * (std::log( dt ) - meanLogDt), 1.0 );
+    }
+
+    double CostModelTimeStepControl::
+    failureProbability( const double dt ) const
+    {
+        if( std::isinf( failureStepSize_ ) ) {
+            return 0.0;
+        }
+
+        // steepness of the transition around the failure step size
+        const double exponent = 4.0;
+        const double r = std::pow( dt / failureStepSize_, exponent );
+        return r / (1.0 + r);
+    }
+
+    double CostModelTimeStepControl::
+    efficiency( const double dt ) const
+    {
+        const double cost = stepCost_ + newtonIterationCost_ * expectedNewtonIterations( dt );
+        // A failed attempt costs at least as much as a converged step, and the expected number
+        // of failed attempts before a step converges is p / (1 - p).
+        const double p = std::min( failureProbability( dt ), 0.99 );
+        const double failedCost = std::max( failedStepCost_, cost );
+        return dt / (cost + p / (1.0 - p) * failedCost);
+    }
+
+    double CostModelTimeStepControl::
+    computeTimeStepSize( const double dt, const int /* iterations */, const RelativeChangeInterface& /* relativeChange */, const double /*simulationTimeElapsed */) const
+    {
+        if( weight_ == 0.0 ) {
+            return dt;
+        }
+
+        // try the step sizes between dt/4 and 4*dt
+        double bestDt = dt;
+        double bestEfficiency = efficiency( dt );
+        for( int i = -8; i <= 8; ++i ) {
+            const double candidate = dt * std::pow( 2.0, 0.25 * i );
+            const double candidateEfficiency = efficiency( candidate );
+            if( candidateEfficiency > bestEfficiency ) {
+                bestDt = candidate;
+                bestEfficiency = candidateEfficiency;
+            }
+        }
+        return bestDt;
+    }
+
 } // end namespace Opm
@@ -122,6 +122,66 @@ namespace Opm
         const double  minTimeStepBasedOnIterations_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Time step control which maximises the simulated time per second of wall clock time.
+    ///
+    ///  The controller keeps a running model of
+    ///   - the cost of a Newton iteration and the cost of a step independent of the iterations,
+    ///   - the number of Newton iterations as a function of log(dt), fitted to the recent converged steps,
+    ///   - the probability that a step fails as a function of dt, a logistic function of log(dt) which is
+    ///     1/2 at the failure step size. The failure step size is initialised with the first failed step,
+    ///     and is updated after every step to make the observed outcome more likely.
+    ///  The next step size is the one with the largest dt / expected cost, where the expected cost
+    ///  includes the cost of the failed attempts.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class CostModelTimeStepControl : public TimeStepControlInterface
+    {
+    public:
+        /// \brief constructor
+        /// \param recoveryRate  growth of the failure step size by a converged step of that size
+        ///                      (should be > 1)
+        explicit CostModelTimeStepControl( const double recoveryRate = 1.25 );
+
+        /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
+        double computeTimeStepSize( const double dt, const int /* iterations */, const RelativeChangeInterface& /* relativeChange */, const double /*simulationTimeElapsed */ ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::recordStep
+        void recordStep( const double dt, const SimulatorReportSingle& report );
+
+        /// expected number of Newton iterations of a converged step of size dt
+        double expectedNewtonIterations( const double dt ) const;
+
+        /// probability that a step of size dt fails
+        double failureProbability( const double dt ) const;
+
+        /// expected simulated time per second of wall clock time for steps of size dt
+        double efficiency( const double dt ) const;
+
+    protected:
+        // update the failure step size with the outcome of a step, failed is 1 for a failed step
+        void updateFailureStepSize_( const double dt, const double failed );
+
+        const double recoveryRate_;
+
+        // running averages of the cost of a Newton iteration, of the cost independent of
+        // the iterations and of the cost of a failed step, in seconds
+        double newtonIterationCost_;
+        double stepCost_;
+        double failedStepCost_;
+
+        // exponentially weighted sums for the fit of the Newton iterations against log(dt)
+        double weight_;
+        double sumLogDt_;
+        double sumIterations_;
+        double sumLogDt2_;
+        double sumLogDtIterations_;
+
+        // failure step size, i.e. step size with failure probability 1/2, infinite before the first failure
+        double failureStepSize_;
+    };
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///  HardcodedTimeStepControl
@@ -23,6 +23,8 @@
 namespace Opm
 {
 
+    struct SimulatorReportSingle;
+
     ///////////////////////////////////////////////////////////////////
     ///
     ///  RelativeChangeInterface
@@ -58,6 +60,12 @@ namespace Opm
         /// \return suggested time step size for the next step
         virtual double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange , const double simulationTimeElapsed) const = 0;
 
+        /// inform the controller about the outcome of a step, called for converged
+        /// and failed steps before the next call to computeTimeStepSize
+        /// \param dt      time step size used in the step
+        /// \param report  report of the step, report.converged tells if the step failed
+        virtual void recordStep( const double /* dt */, const SimulatorReportSingle& /* report */ ) {}
+
         /// virtual destructor (empty)
         virtual ~TimeStepControlInterface () {}
     };
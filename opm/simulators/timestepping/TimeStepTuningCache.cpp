@@ -0,0 +1,113 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/simulators/timestepping/TimeStepTuningCache.hpp>
+
+namespace Opm
+{
+    TimeStepTuningCache::TimeStepTuningCache(const std::string& filename)
+    {
+        std::ifstream infile(filename);
+        if (!infile.is_open()) {
+            return;
+        }
+        std::string line;
+        while (std::getline(infile, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream values(line);
+            int reportStep = 0;
+            Entry entry;
+            if (!(values >> reportStep >> entry.firstAcceptedStep >> entry.chops >> entry.substeps)) {
+                OPM_THROW(std::runtime_error, "Invalid line in the time step tuning cache " << filename << ": " << line);
+            }
+            cached_[reportStep] = entry;
+        }
+    }
+
+    void TimeStepTuningCache::recordSubstep(const int reportStep, const double dt, const bool converged)
+    {
+        auto& entry = current_[reportStep];
+        ++entry.substeps;
+        if (!converged) {
+            ++entry.chops;
+        } else if (entry.firstAcceptedStep == 0.0) {
+            entry.firstAcceptedStep = dt;
+        }
+    }
+
+    double TimeStepTuningCache::suggestedFirstStep(const int reportStep, const double dt) const
+    {
+        const auto* entry = this->cached(reportStep);
+        if (entry == nullptr || entry->chops == 0 || !(entry->firstAcceptedStep > 0.0)) {
+            return dt;
+        }
+        return std::min(dt, entry->firstAcceptedStep);
+    }
+
+    const TimeStepTuningCache::Entry* TimeStepTuningCache::cached(const int reportStep) const
+    {
+        const auto it = cached_.find(reportStep);
+        return it == cached_.end() ? nullptr : &it->second;
+    }
+
+    bool TimeStepTuningCache::save(const std::string& filename) const
+    {
+        // A report step which this run started with the learned first step
+        // typically converges without chops. Keep what the earlier run
+        // learned then, otherwise the run after next would chop again.
+        auto entries = cached_;
+        for (const auto& [reportStep, entry] : current_) {
+            auto it = entries.find(reportStep);
+            if (it == entries.end()) {
+                entries[reportStep] = entry;
+                continue;
+            }
+            auto& merged = it->second;
+            merged.chops = std::max(merged.chops, entry.chops);
+            if (!(merged.firstAcceptedStep > 0.0)
+                || (entry.firstAcceptedStep > 0.0 && entry.firstAcceptedStep < merged.firstAcceptedStep)) {
+                merged.firstAcceptedStep = entry.firstAcceptedStep;
+            }
+            merged.substeps = entry.substeps;
+        }
+
+        std::ofstream outfile(filename);
+        if (!outfile.is_open()) {
+            return false;
+        }
+        outfile << "# report step, first converged substep [s], chopped substeps, substeps\n";
+        outfile << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (const auto& [reportStep, entry] : entries) {
+            outfile << reportStep << ' ' << entry.firstAcceptedStep << ' '
+                    << entry.chops << ' ' << entry.substeps << '\n';
+        }
+        return static_cast<bool>(outfile);
+    }
+
+} // namespace Opm
@@ -0,0 +1,78 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_TIMESTEPTUNINGCACHE_HEADER_INCLUDED
+#define OPM_TIMESTEPTUNINGCACHE_HEADER_INCLUDED
+
+#include <map>
+#include <string>
+
+namespace Opm
+{
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  The time steps of the report steps of an earlier run of the same deck, stored in a file. The first
+    ///  substep of a report step in which the earlier run had to chop is started with the step size that
+    ///  converged there, instead of repeating the failed attempts.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class TimeStepTuningCache
+    {
+    public:
+        struct Entry
+        {
+            /// size of the first converged substep
+            double firstAcceptedStep = 0.0;
+            /// number of substeps that did not converge
+            int chops = 0;
+            /// number of substeps, converged or not
+            int substeps = 0;
+        };
+
+        TimeStepTuningCache() = default;
+
+        /// \brief constructor
+        /// \param filename  file written by save() in an earlier run, nothing is read if it does not exist
+        explicit TimeStepTuningCache(const std::string& filename);
+
+        /// \brief record a substep of a report step of this run
+        void recordSubstep(const int reportStep, const double dt, const bool converged);
+
+        /// \brief size of the first substep of a report step
+        /// \param dt  size the time step control would use
+        double suggestedFirstStep(const int reportStep, const double dt) const;
+
+        /// \brief the earlier run, or nullptr if it did not reach the report step
+        const Entry* cached(const int reportStep) const;
+
+        /// \brief write the report steps of this run, and of the earlier run for those this run has not reached
+        ///
+        /// For the report steps of both runs the larger number of chops and the smaller first converged
+        /// substep are kept, so a report step the earlier run taught to start small keeps its first step.
+        /// The first step of a report step can thus only shrink from run to run, remove the file to
+        /// learn it anew, e.g. after changing the deck.
+        /// \return whether the file could be written
+        bool save(const std::string& filename) const;
+
+    private:
+        std::map<int, Entry> cached_;
+        std::map<int, Entry> current_;
+    };
+
+} // namespace Opm
+#endif // OPM_TIMESTEPTUNINGCACHE_HEADER_INCLUDED
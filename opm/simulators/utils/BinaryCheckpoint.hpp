@@ -0,0 +1,181 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BINARYCHECKPOINT_HEADER_INCLUDED
+#define OPM_BINARYCHECKPOINT_HEADER_INCLUDED
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// Writing and reading the state of the simulator objects in the binary
+/// checkpoints of a process, i.e. into the stream of a Restarter section.
+///
+/// The values are stored in their memory representation, such that a run
+/// continued from a checkpoint gives the same results as the uninterrupted
+/// run. The checkpoints are therefore only meant to be read by the same
+/// build on the same kind of machine. Supported are the trivially copyable
+/// types, strings, and vectors, maps and pairs of these.
+namespace BinaryCheckpoint
+{
+
+    template <class T>
+    void write(std::ostream& os, const T& value);
+
+    template <class T>
+    void read(std::istream& is, T& value);
+
+    namespace Details
+    {
+        inline void writeSize(std::ostream& os, const std::size_t size)
+        {
+            const auto stored = static_cast<std::uint64_t>(size);
+            os.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+        }
+
+        inline std::size_t readSize(std::istream& is)
+        {
+            std::uint64_t stored = 0;
+            if (!is.read(reinterpret_cast<char*>(&stored), sizeof(stored))) {
+                throw std::runtime_error("Unexpected end of checkpoint");
+            }
+            return stored;
+        }
+
+        template <class T>
+        struct IsVector : std::false_type {};
+        template <class T, class A>
+        struct IsVector<std::vector<T, A>> : std::true_type {};
+
+        template <class T>
+        struct IsMap : std::false_type {};
+        template <class K, class V, class C, class A>
+        struct IsMap<std::map<K, V, C, A>> : std::true_type {};
+
+        template <class T>
+        struct IsPair : std::false_type {};
+        template <class T1, class T2>
+        struct IsPair<std::pair<T1, T2>> : std::true_type {};
+    } // namespace Details
+
+    template <class T>
+    void write(std::ostream& os, const T& value)
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            Details::writeSize(os, value.size());
+            os.write(value.data(), value.size());
+        } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+            Details::writeSize(os, value.size());
+            for (const bool b : value) {
+                write(os, static_cast<char>(b));
+            }
+        } else if constexpr (Details::IsVector<T>::value) {
+            Details::writeSize(os, value.size());
+            if constexpr (std::is_trivially_copyable_v<typename T::value_type>) {
+                os.write(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(typename T::value_type));
+            } else {
+                for (const auto& v : value) {
+                    write(os, v);
+                }
+            }
+        } else if constexpr (Details::IsMap<T>::value) {
+            Details::writeSize(os, value.size());
+            for (const auto& [key, v] : value) {
+                write(os, key);
+                write(os, v);
+            }
+        } else if constexpr (Details::IsPair<T>::value) {
+            write(os, value.first);
+            write(os, value.second);
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>, "Type not supported in checkpoints");
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    template <class T>
+    void read(std::istream& is, T& value)
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            value.resize(Details::readSize(is));
+            is.read(value.data(), value.size());
+        } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+            value.resize(Details::readSize(is));
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                char b = 0;
+                read(is, b);
+                value[i] = b != 0;
+            }
+        } else if constexpr (Details::IsVector<T>::value) {
+            value.resize(Details::readSize(is));
+            if constexpr (std::is_trivially_copyable_v<typename T::value_type>) {
+                is.read(reinterpret_cast<char*>(value.data()), value.size() * sizeof(typename T::value_type));
+            } else {
+                for (auto& v : value) {
+                    read(is, v);
+                }
+            }
+        } else if constexpr (Details::IsMap<T>::value) {
+            value.clear();
+            const auto size = Details::readSize(is);
+            for (std::size_t i = 0; i < size; ++i) {
+                typename T::key_type key;
+                typename T::mapped_type v;
+                read(is, key);
+                read(is, v);
+                value.emplace(std::move(key), std::move(v));
+            }
+        } else if constexpr (Details::IsPair<T>::value) {
+            read(is, value.first);
+            read(is, value.second);
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>, "Type not supported in checkpoints");
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        }
+        if (!is) {
+            throw std::runtime_error("Unexpected end of checkpoint");
+        }
+    }
+
+    /// Read a value that must equal the one of the current object, e.g. the
+    /// number of wells, since the checkpoint only holds the dynamic state.
+    template <class T>
+    void readExpected(std::istream& is, const T& expected, const std::string& what)
+    {
+        T value;
+        read(is, value);
+        if (value != expected) {
+            throw std::runtime_error("The checkpoint does not match the " + what + " of the simulation");
+        }
+    }
+
+} // namespace BinaryCheckpoint
+
+} // namespace Opm
+
+#endif // OPM_BINARYCHECKPOINT_HEADER_INCLUDED
@@ -0,0 +1,128 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/CostAccounting.hpp>
+#include <opm/simulators/utils/allGatherNames.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+
+namespace Opm
+{
+
+    CostAccounting& CostAccounting::instance()
+    {
+        static CostAccounting accounting;
+        return accounting;
+    }
+
+    void CostAccounting::enable(const std::size_t numCells)
+    {
+        enabled_ = true;
+        cellCosts_.assign(numCells, 0.0);
+    }
+
+    void CostAccounting::addWellAssembly(const std::string& well, const double seconds)
+    {
+        auto& cost = wellCosts_[well];
+        ++cost.assemblies;
+        cost.assemblySeconds += seconds;
+    }
+
+    void CostAccounting::addWellSolve(const std::string& well, const double seconds)
+    {
+        wellCosts_[well].solveSeconds += seconds;
+    }
+
+    std::vector<CostAccounting::WellCost>
+    CostAccounting::wellCosts(const Communication& comm) const
+    {
+        // The wells of all processes, in the same order everywhere.
+        std::vector<std::string> localNames;
+        for (const auto& cost : wellCosts_) {
+            localNames.push_back(cost.first);
+        }
+        const auto allNames = allGatherNames(comm, localNames);
+        const std::set<std::string> names(allNames.begin(), allNames.end());
+
+        // Distributed wells are assembled on all their processes, the
+        // number of assemblies is the same on each of them.
+        std::vector<double> seconds;
+        std::vector<double> assemblies;
+        for (const auto& name : names) {
+            WellCost cost;
+            const auto it = wellCosts_.find(name);
+            if (it != wellCosts_.end()) {
+                cost = it->second;
+            }
+            seconds.push_back(cost.assemblySeconds);
+            seconds.push_back(cost.solveSeconds);
+            assemblies.push_back(cost.assemblies);
+        }
+        comm.sum(seconds.data(), seconds.size());
+        comm.max(assemblies.data(), assemblies.size());
+
+        std::vector<WellCost> result;
+        std::size_t i = 0;
+        for (const auto& name : names) {
+            WellCost cost;
+            cost.name = name;
+            cost.assemblies = assemblies[i];
+            cost.assemblySeconds = seconds[2*i];
+            cost.solveSeconds = seconds[2*i + 1];
+            result.push_back(cost);
+            ++i;
+        }
+        std::stable_sort(result.begin(), result.end(),
+                         [](const WellCost& a, const WellCost& b)
+                         {
+                             return a.assemblySeconds + a.solveSeconds > b.assemblySeconds + b.solveSeconds;
+                         });
+        return result;
+    }
+
+    void CostAccounting::print(std::ostream& os, const std::vector<WellCost>& wellCosts)
+    {
+        std::size_t width = 4;
+        for (const auto& cost : wellCosts) {
+            width = std::max(width, cost.name.size());
+        }
+
+        os << std::left << std::setw(width) << "Well" << std::right
+           << std::setw(12) << "Assemblies" << std::setw(14) << "Assembly [s]"
+           << std::setw(12) << "Solve [s]" << '\n';
+        os << std::fixed << std::setprecision(3);
+        for (const auto& cost : wellCosts) {
+            os << std::left << std::setw(width) << cost.name << std::right
+               << std::setw(12) << cost.assemblies << std::setw(14) << cost.assemblySeconds
+               << std::setw(12) << cost.solveSeconds << '\n';
+        }
+    }
+
+    void CostAccounting::clear()
+    {
+        enabled_ = false;
+        cellCosts_.clear();
+        wellCosts_.clear();
+    }
+
+} // namespace Opm
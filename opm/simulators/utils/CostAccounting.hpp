@@ -0,0 +1,100 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COSTACCOUNTING_HEADER_INCLUDED
+#define OPM_COSTACCOUNTING_HEADER_INCLUDED
+
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Cumulative cost of the cells and wells of this process, for
+    /// finding the cells and wells which make the simulation expensive or
+    /// the processes imbalanced.
+    ///
+    /// The cost of a cell is the number of Newton iterations in which it
+    /// did not satisfy the CNV tolerance, including the iterations of
+    /// failed time steps. The cost of a well is the time spent assembling
+    /// and solving its equations. Nothing is recorded unless enabled.
+    class CostAccounting
+    {
+    public:
+        struct WellCost
+        {
+            std::string name;
+            long assemblies = 0;
+            double assemblySeconds = 0.0;
+            double solveSeconds = 0.0;
+        };
+
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        static CostAccounting& instance();
+
+        /// Start recording, for a grid with numCells cells on this process.
+        void enable(const std::size_t numCells);
+
+        bool enabled() const
+        { return enabled_; }
+
+        void addCellIteration(const std::size_t cellIdx)
+        { cellCosts_[cellIdx] += 1.0; }
+
+        /// Costs indexed by the cells of this process, zero for cells
+        /// owned by other processes.
+        const std::vector<double>& cellCosts() const
+        { return cellCosts_; }
+
+        void addWellAssembly(const std::string& well, const double seconds);
+        void addWellSolve(const std::string& well, const double seconds);
+
+        /// The costs of all wells, summed over the processes of comm and
+        /// ordered by decreasing total time. This is a collective
+        /// operation.
+        std::vector<WellCost> wellCosts(const Communication& comm) const;
+
+        /// Print a table of well costs.
+        static void print(std::ostream& os, const std::vector<WellCost>& wellCosts);
+
+        void clear();
+
+    private:
+        CostAccounting() = default;
+
+        bool enabled_ = false;
+        std::vector<double> cellCosts_;
+        std::map<std::string, WellCost> wellCosts_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_COSTACCOUNTING_HEADER_INCLUDED
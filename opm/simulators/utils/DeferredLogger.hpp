@@ -86,6 +86,10 @@ enum ExcEnum {
         /// Clear the message container without logging them.
         void clearMessages();
 
+        /// Append the messages of another logger, e.g. one
+        /// that was used by a single thread, to this one.
+        void append(const DeferredLogger& other);
+
     private:
         std::vector<Message> messages_;
         friend DeferredLogger gatherDeferredLogger(const DeferredLogger& local_deferredlogger);
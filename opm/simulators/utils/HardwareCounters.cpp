@@ -0,0 +1,139 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/HardwareCounters.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#endif
+
+namespace
+{
+
+#ifdef __linux__
+    // A counter of the calling thread in the group of leader, or the
+    // leader of a new group if leader is -1.
+    int openCounter(const std::uint64_t config, const int leader)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, leader, /*flags=*/0));
+    }
+
+    void closeCounter(int& fd)
+    {
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd = -1;
+    }
+#endif
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+    HardwareCounters::Values& HardwareCounters::Values::operator+=(const Values& other)
+    {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cacheMisses += other.cacheMisses;
+        return *this;
+    }
+
+    HardwareCounters::Values& HardwareCounters::Values::operator-=(const Values& other)
+    {
+        cycles -= other.cycles;
+        instructions -= other.instructions;
+        cacheMisses -= other.cacheMisses;
+        return *this;
+    }
+
+    HardwareCounters::~HardwareCounters()
+    {
+#ifdef __linux__
+        closeCounter(cacheMisses_);
+        closeCounter(instructions_);
+        closeCounter(leader_);
+#endif
+    }
+
+    bool HardwareCounters::open()
+    {
+#ifdef __linux__
+        if (isOpen()) {
+            return true;
+        }
+        leader_ = openCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (leader_ < 0) {
+            return false;
+        }
+        instructions_ = openCounter(PERF_COUNT_HW_INSTRUCTIONS, leader_);
+        cacheMisses_ = openCounter(PERF_COUNT_HW_CACHE_MISSES, leader_);
+        if (instructions_ < 0 || cacheMisses_ < 0) {
+            closeCounter(cacheMisses_);
+            closeCounter(instructions_);
+            closeCounter(leader_);
+            return false;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    HardwareCounters::Values HardwareCounters::read() const
+    {
+        Values values;
+#ifdef __linux__
+        if (!isOpen()) {
+            return values;
+        }
+        // The number of counters followed by their values, in the order
+        // they were opened.
+        std::uint64_t buffer[4] = {0, 0, 0, 0};
+        if (::read(leader_, buffer, sizeof(buffer)) < static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != 3) {
+            return values;
+        }
+        values.cycles = static_cast<double>(buffer[1]);
+        values.instructions = static_cast<double>(buffer[2]);
+        values.cacheMisses = static_cast<double>(buffer[3]);
+#endif
+        return values;
+    }
+
+} // namespace Opm
@@ -0,0 +1,74 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_HARDWARECOUNTERS_HEADER_INCLUDED
+#define OPM_HARDWARECOUNTERS_HEADER_INCLUDED
+
+namespace Opm
+{
+
+    /// Hardware performance counters of the calling thread, read through
+    /// the Linux perf_event interface.
+    ///
+    /// The counters are the cycles, the retired instructions and the last
+    /// level cache misses, in user space only. Threads started by OpenMP
+    /// are not counted. The counters are unavailable on other systems than
+    /// Linux, when the kernel does not allow user space measurements (see
+    /// /proc/sys/kernel/perf_event_paranoid) and on most virtual machines.
+    class HardwareCounters
+    {
+    public:
+        struct Values
+        {
+            double cycles = 0.0;
+            double instructions = 0.0;
+            double cacheMisses = 0.0;
+
+            Values& operator+=(const Values& other);
+            Values& operator-=(const Values& other);
+        };
+
+        /// Bytes transferred from memory per last level cache miss.
+        static constexpr double cacheLineSize = 64.0;
+
+        HardwareCounters() = default;
+        ~HardwareCounters();
+
+        HardwareCounters(const HardwareCounters&) = delete;
+        HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+        /// Open and start the counters. Returns false if they are
+        /// unavailable, the counters then read zero.
+        bool open();
+
+        bool isOpen() const
+        { return leader_ >= 0; }
+
+        /// Counts since open().
+        Values read() const;
+
+    private:
+        int leader_ = -1;
+        int instructions_ = -1;
+        int cacheMisses_ = -1;
+    };
+
+} // namespace Opm
+
+#endif // OPM_HARDWARECOUNTERS_HEADER_INCLUDED
@@ -0,0 +1,136 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/MemoryAccounting.hpp>
+#include <opm/simulators/utils/allGatherNames.hpp>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+
+namespace Opm
+{
+
+    MemoryAccounting& MemoryAccounting::instance()
+    {
+        static MemoryAccounting accounting;
+        return accounting;
+    }
+
+    std::vector<MemoryAccounting::Statistics>
+    MemoryAccounting::statistics(const Communication& comm) const
+    {
+        // The subsystems of all processes, in the same order everywhere.
+        std::vector<std::string> localNames;
+        for (const auto& subsystem : bytes_) {
+            localNames.push_back(subsystem.first);
+        }
+        const auto allNames = allGatherNames(comm, localNames);
+        const std::set<std::string> names(allNames.begin(), allNames.end());
+
+        std::vector<double> localBytes;
+        for (const auto& name : names) {
+            const auto it = bytes_.find(name);
+            localBytes.push_back(it != bytes_.end() ? it->second : 0.0);
+        }
+        localBytes.push_back(residentBytes());
+
+        const std::size_t numValues = localBytes.size();
+        std::vector<double> allBytes(numValues * comm.size());
+        comm.allgather(localBytes.data(), numValues, allBytes.data());
+
+        std::vector<std::string> statisticsNames(names.begin(), names.end());
+        statisticsNames.push_back("resident");
+
+        std::vector<Statistics> result;
+        for (std::size_t i = 0; i < numValues; ++i) {
+            Statistics stats;
+            stats.name = statisticsNames[i];
+            stats.min = allBytes[i];
+            for (int rank = 0; rank < comm.size(); ++rank) {
+                const double bytes = allBytes[rank * numValues + i];
+                stats.min = std::min(stats.min, bytes);
+                stats.average += bytes / comm.size();
+                if (bytes > stats.max) {
+                    stats.max = bytes;
+                    stats.maxRank = rank;
+                }
+            }
+            result.push_back(stats);
+        }
+        return result;
+    }
+
+    void MemoryAccounting::print(std::ostream& os, const std::vector<Statistics>& statistics)
+    {
+        std::size_t width = 9;
+        for (const auto& stats : statistics) {
+            width = std::max(width, stats.name.size());
+        }
+
+        constexpr double megabyte = 1024.0 * 1024.0;
+        os << std::left << std::setw(width) << "Subsystem" << std::right
+           << std::setw(12) << "Min [MB]" << std::setw(14) << "Average [MB]"
+           << std::setw(12) << "Max [MB]" << std::setw(10) << "Max rank" << '\n';
+        os << std::fixed << std::setprecision(1);
+        for (const auto& stats : statistics) {
+            os << std::left << std::setw(width) << stats.name << std::right
+               << std::setw(12) << stats.min / megabyte << std::setw(14) << stats.average / megabyte
+               << std::setw(12) << stats.max / megabyte << std::setw(10) << stats.maxRank << '\n';
+        }
+    }
+
+    void MemoryAccounting::clear()
+    {
+        enabled_ = false;
+        bytes_.clear();
+    }
+
+    std::size_t MemoryAccounting::heapBytes()
+    {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        const auto info = mallinfo2();
+        // small allocations and those mapped on their own
+        return info.uordblks + info.hblkhd;
+#else
+        return residentBytes();
+#endif
+    }
+
+    std::size_t MemoryAccounting::residentBytes()
+    {
+        // total and resident pages
+        std::ifstream statm("/proc/self/statm");
+        std::size_t pages = 0;
+        std::size_t residentPages = 0;
+        if (!(statm >> pages >> residentPages)) {
+            return 0;
+        }
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+} // namespace Opm
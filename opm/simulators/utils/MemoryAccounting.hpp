@@ -0,0 +1,116 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MEMORYACCOUNTING_HEADER_INCLUDED
+#define OPM_MEMORYACCOUNTING_HEADER_INCLUDED
+
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The memory held by the major data structures of this process, for
+    /// finding out which part of the simulator makes a model run out of
+    /// memory.
+    ///
+    /// The subsystems report their own sizes, which are the bytes of their
+    /// large containers rather than every allocation. Nothing is recorded
+    /// unless enabled.
+    class MemoryAccounting
+    {
+    public:
+        /// Minimum, average and maximum over the processes, in bytes.
+        struct Statistics
+        {
+            std::string name;
+            double min = 0.0;
+            double average = 0.0;
+            double max = 0.0;
+            int maxRank = 0;
+        };
+
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        static MemoryAccounting& instance();
+
+        void enable()
+        { enabled_ = true; }
+
+        bool enabled() const
+        { return enabled_; }
+
+        /// Set the bytes currently held by a subsystem of this process.
+        void set(const std::string& subsystem, const std::size_t bytes)
+        { bytes_[subsystem] = bytes; }
+
+        const std::map<std::string, std::size_t>& subsystems() const
+        { return bytes_; }
+
+        /// The statistics of every subsystem over the processes of comm,
+        /// followed by the resident memory of the processes. This is a
+        /// collective operation.
+        std::vector<Statistics> statistics(const Communication& comm) const;
+
+        /// Print a table of statistics, in megabytes.
+        static void print(std::ostream& os, const std::vector<Statistics>& statistics);
+
+        void clear();
+
+        /// Bytes of the heap in use by this process, from the allocator
+        /// where it reports them and the resident memory otherwise.
+        static std::size_t heapBytes();
+
+        /// Resident memory of this process in bytes, zero if unknown.
+        static std::size_t residentBytes();
+
+        template<class T, class A>
+        static std::size_t vectorBytes(const std::vector<T, A>& v)
+        { return v.capacity() * sizeof(T); }
+
+        /// Bytes of the blocks and the sparsity pattern of a
+        /// Dune::BCRSMatrix.
+        template<class Matrix>
+        static std::size_t matrixBytes(const Matrix& m)
+        {
+            return m.nonzeroes() * (sizeof(typename Matrix::block_type) + sizeof(typename Matrix::size_type))
+                + m.N() * sizeof(typename Matrix::row_type);
+        }
+
+    private:
+        MemoryAccounting() = default;
+
+        bool enabled_ = false;
+        std::map<std::string, std::size_t> bytes_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_MEMORYACCOUNTING_HEADER_INCLUDED
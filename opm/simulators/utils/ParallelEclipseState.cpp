@@ -95,6 +95,10 @@ const std::vector<int>& ParallelFieldPropsManager::get_int(const std::string& ke
 
 std::vector<int> ParallelFieldPropsManager::get_global_int(const std::string& keyword) const
 {
+    auto cached = m_globalIntCache.find(keyword);
+    if (cached != m_globalIntCache.end())
+        return cached->second;
+
     std::vector<int> result;
     int exceptionThrown{};
 
@@ -121,6 +125,7 @@ std::vector<int> ParallelFieldPropsManager::get_global_int(const std::string& ke
     result.resize(size);
     m_comm.broadcast(result.data(), size, 0);
 
+    m_globalIntCache.emplace(keyword, result);
     return result;
 }
 
@@ -149,6 +154,10 @@ const std::vector<double>& ParallelFieldPropsManager::get_double(const std::stri
 
 std::vector<double> ParallelFieldPropsManager::get_global_double(const std::string& keyword) const
 {
+    auto cached = m_globalDoubleCache.find(keyword);
+    if (cached != m_globalDoubleCache.end())
+        return cached->second;
+
     std::vector<double> result;
     int exceptionThrown{};
 
@@ -175,9 +184,16 @@ std::vector<double> ParallelFieldPropsManager::get_global_double(const std::stri
     result.resize(size);
     m_comm.broadcast(result.data(), size, 0);
 
+    m_globalDoubleCache.emplace(keyword, result);
     return result;
 }
 
+void ParallelFieldPropsManager::releaseGlobalCache()
+{
+    std::map<std::string, std::vector<int>>().swap(m_globalIntCache);
+    std::map<std::string, std::vector<double>>().swap(m_globalDoubleCache);
+}
+
 bool ParallelFieldPropsManager::tran_active(const std::string& keyword) const
 {
     auto calculator = m_tran.find(keyword);
@@ -216,6 +232,7 @@ ParallelEclipseState::ParallelEclipseState()
 
 ParallelEclipseState::ParallelEclipseState(const Deck& deck)
     : EclipseState(deck)
+    , m_globalProps(true)
     , m_fieldProps(field_props)
 {
 }
@@ -223,7 +240,7 @@ ParallelEclipseState::ParallelEclipseState(const Deck& deck)
 
 const FieldPropsManager& ParallelEclipseState::fieldProps() const
 {
-    if (!m_parProps && Dune::MPIHelper::getCollectiveCommunication().rank() != 0)
+    if (!m_parProps && !m_globalProps)
         OPM_THROW(std::runtime_error, "Attempt to access field properties on no-root process before switch to parallel properties");
 
     if (!m_parProps || Dune::MPIHelper::getCollectiveCommunication().size() == 1)
@@ -235,7 +252,7 @@ const FieldPropsManager& ParallelEclipseState::fieldProps() const
 
 const FieldPropsManager& ParallelEclipseState::globalFieldProps() const
 {
-    if (Dune::MPIHelper::getCollectiveCommunication().rank() != 0)
+    if (!m_globalProps)
         OPM_THROW(std::runtime_error, "Attempt to access global field properties on non-root process");
     return this->EclipseState::globalFieldProps();
 }
@@ -243,7 +260,7 @@ const FieldPropsManager& ParallelEclipseState::globalFieldProps() const
 
 const EclipseGrid& ParallelEclipseState::getInputGrid() const
 {
-    if (Dune::MPIHelper::getCollectiveCommunication().rank() != 0)
+    if (!m_globalProps)
         OPM_THROW(std::runtime_error, "Attempt to access eclipse grid on non-root process");
     return this->EclipseState::getInputGrid();
 }
@@ -255,6 +272,12 @@ void ParallelEclipseState::switchToGlobalProps()
 }
 
 
+void ParallelEclipseState::releaseGlobalPropsCache()
+{
+    m_fieldProps.releaseGlobalCache();
+}
+
+
 void ParallelEclipseState::switchToDistributedProps()
 {
     const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
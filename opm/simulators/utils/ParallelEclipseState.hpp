@@ -68,12 +68,14 @@ public:
 
     //! \brief Returns an int property using global cartesian indices.
     //! \param keyword Name of property
-    //! \details The vector is broadcast from root process
+    //! \details The vector is broadcast from root process once and
+    //!          cached until releaseGlobalCache() is called.
     std::vector<int> get_global_int(const std::string& keyword) const override;
 
     //! \brief Returns a double property using global cartesian indices.
     //! \param keyword Name of property
-    //! \details The vector is broadcast from root process
+    //! \details The vector is broadcast from root process once and
+    //!          cached until releaseGlobalCache() is called.
     std::vector<double> get_global_double(const std::string& keyword) const override;
 
     //! \brief Check if an integer property is available.
@@ -97,6 +99,10 @@ public:
                                    std::placeholders::_1);
     }
 
+    //! \brief Frees the cached global properties.
+    //! \details Has to be called collectively on all processes.
+    void releaseGlobalCache();
+
     bool tran_active(const std::string& keyword) const override;
 
     void apply_tran(const std::string& keyword, std::vector<double>& trans) const override;
@@ -110,6 +116,8 @@ protected:
     std::function<int(void)> m_activeSize; //!< active size function of the grid
     std::function<int(const int)> m_local2Global; //!< mapping from local to global cartesian indices
     std::unordered_map<std::string, Fieldprops::TranCalculator> m_tran; //!< calculators map
+    mutable std::map<std::string, std::vector<int>> m_globalIntCache; //!< Broadcast integer properties in global cartesian indices.
+    mutable std::map<std::string, std::vector<double>> m_globalDoubleCache; //!< Broadcast double properties in global cartesian indices.
 };
 
 
@@ -134,7 +142,8 @@ public:
 
     //! \brief Construct from a deck instance.
     //! \param deck The deck to construct from
-    //! \details Only called on root process
+    //! \details Only called on the processes parsing the deck, i.e. on the
+    //!          root process unless every process parses the deck.
     ParallelEclipseState(const Deck& deck);
 
     //! \brief Switch to global field properties.
@@ -146,15 +155,20 @@ public:
     //!          setupLocalProps must be called prior to this.
     void switchToDistributedProps();
 
+    //! \brief Frees the global properties cached by the parallel field properties.
+    //! \details Called on all processes once the initialization is finished,
+    //!          i.e. after the INIT file has been written.
+    void releaseGlobalPropsCache();
+
     //! \brief Returns a const ref to current field properties.
     const FieldPropsManager& fieldProps() const override;
 
     //! \brief Returns a const ref to global field properties.
-    //! \details Can only be called on root process.
+    //! \details Can only be called on processes which parsed the deck.
     const FieldPropsManager& globalFieldProps() const override;
 
     //! \brief Returns a const ref to the eclipse grid.
-    //! \details Can only be called on root process.
+    //! \details Can only be called on processes which parsed the deck.
     const EclipseGrid& getInputGrid() const override;
 
     //! \brief Resets the underlying cartesian mapper
@@ -169,6 +183,7 @@ public:
     }
 private:
     bool m_parProps = false; //! True to use distributed properties on root process
+    bool m_globalProps = false; //!< True if constructed from the deck, i.e. the global properties are available
     ParallelFieldPropsManager m_fieldProps; //!< The parallel field properties
 };
 
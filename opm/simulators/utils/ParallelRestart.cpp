@@ -26,6 +26,8 @@
 #include <cstring>
 #include <ctime>
 #include <memory>
+#include <numeric>
+#include <utility>
 #include <dune/common/parallel/mpitraits.hh>
 #include <opm/output/data/Aquifer.hpp>
 #include <opm/output/data/Cells.hpp>
@@ -65,19 +67,10 @@ std::size_t packSize(const T*, std::size_t, Dune::MPIHelper::MPICommunicator,
 }
 
 template<class T>
-std::size_t packSize(const T*, std::size_t l, Dune::MPIHelper::MPICommunicator comm,
+std::size_t packSize(const T*, std::size_t l, Dune::MPIHelper::MPICommunicator,
                      std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    int size;
-    MPI_Pack_size(1, Dune::MPITraits<std::size_t>::getType(), comm, &size);
-    std::size_t totalSize = size;
-    MPI_Pack_size(l, Dune::MPITraits<T>::getType(), comm, &size);
-    return totalSize + size;
-#else
-    (void) comm;
-    return l-l;
-#endif
+    return sizeof(std::size_t) + l*sizeof(T);
 }
 
 template<class T>
@@ -169,19 +162,9 @@ std::size_t packSize(const std::set<K,C,A>& data,
     return totalSize;
 }
 
-std::size_t packSize(const char* str, Dune::MPIHelper::MPICommunicator comm)
+std::size_t packSize(const char* str, Dune::MPIHelper::MPICommunicator)
 {
-#if HAVE_MPI
-    int size;
-    MPI_Pack_size(1, Dune::MPITraits<std::size_t>::getType(), comm, &size);
-    int totalSize = size;
-    MPI_Pack_size(strlen(str)+1, MPI_CHAR, comm, &size);
-    return totalSize + size;
-#else
-    (void) str;
-    (void) comm;
-    return 0;
-#endif
+    return sizeof(std::size_t) + strlen(str) + 1;
 }
 
 std::size_t packSize(const std::string& str, Dune::MPIHelper::MPICommunicator comm)
@@ -338,21 +321,11 @@ void pack(const T*, std::size_t, std::vector<char>&, int&,
 
 template<class T>
 void pack(const T* data, std::size_t l, std::vector<char>& buffer, int& position,
-          Dune::MPIHelper::MPICommunicator comm,
+          Dune::MPIHelper::MPICommunicator,
           std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    MPI_Pack(&l, 1, Dune::MPITraits<std::size_t>::getType(), buffer.data(),
-             buffer.size(), &position, comm);
-    MPI_Pack(data, l, Dune::MPITraits<T>::getType(), buffer.data(),
-             buffer.size(), &position, comm);
-#else
-    (void) data;
-    (void) comm;
-    (void) l;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::packBytes(&l, sizeof(std::size_t), buffer, position);
+    detail::packBytes(data, l*sizeof(T), buffer, position);
 }
 
 template<class T>
@@ -467,20 +440,11 @@ void pack(const std::tuple<Ts...>& data, std::vector<char>& buffer,
 }
 
 void pack(const char* str, std::vector<char>& buffer, int& position,
-          Dune::MPIHelper::MPICommunicator comm)
+          Dune::MPIHelper::MPICommunicator)
 {
-#if HAVE_MPI
     std::size_t length = strlen(str)+1;
-    MPI_Pack(&length, 1, Dune::MPITraits<std::size_t>::getType(), buffer.data(),
-        buffer.size(), &position, comm);
-    MPI_Pack(str, strlen(str)+1, MPI_CHAR, buffer.data(), buffer.size(),
-         &position, comm);
-#else
-    (void) str;
-    (void) comm;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::packBytes(&length, sizeof(std::size_t), buffer, position);
+    detail::packBytes(str, length, buffer, position);
 }
 
 void pack(const std::string& str, std::vector<char>& buffer, int& position,
@@ -655,19 +619,10 @@ void unpack(T*, const std::size_t&, std::vector<char>&, int&,
 
 template<class T>
 void unpack(T* data, const std::size_t& l, std::vector<char>& buffer, int& position,
-            Dune::MPIHelper::MPICommunicator comm,
+            Dune::MPIHelper::MPICommunicator,
             std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    MPI_Unpack(buffer.data(), buffer.size(), &position, data, l,
-               Dune::MPITraits<T>::getType(), comm);
-#else
-    (void) data;
-    (void) comm;
-    (void) l;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::unpackBytes(data, l*sizeof(T), buffer, position);
 }
 
 template<class T>
@@ -797,17 +752,9 @@ void unpack(std::array<T,N>& data, std::vector<char>& buffer, int& position,
 }
 
 void unpack(char* str, std::size_t length, std::vector<char>& buffer, int& position,
-            Dune::MPIHelper::MPICommunicator comm)
+            Dune::MPIHelper::MPICommunicator)
 {
-#if HAVE_MPI
-    MPI_Unpack(buffer.data(), buffer.size(), &position, const_cast<char*>(str), length, MPI_CHAR, comm);
-#else
-    (void) str;
-    (void) comm;
-    (void) length;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::unpackBytes(str, length, buffer, position);
 }
 
 void unpack(std::string& str, std::vector<char>& buffer, int& position,
@@ -974,14 +921,12 @@ void unpack(RestartValue& data, std::vector<char>& buffer, int& position,
     unpack(data.extra, buffer, position, comm);
 }
 
-void unpack([[maybe_unused]] Opm::time_point& data, std::vector<char>& buffer, int& position,
+void unpack(Opm::time_point& data, std::vector<char>& buffer, int& position,
             Dune::MPIHelper::MPICommunicator comm)
 {
     std::time_t tp;
     unpack(tp, buffer, position, comm);
-#if HAVE_MPI
     data = Opm::TimeService::from_time_t(tp);
-#endif
 }
 
 
@@ -1052,18 +997,75 @@ INSTANTIATE_PACK(std::set<std::string>)
 
 } // end namespace Mpi
 
+#if HAVE_MPI
+namespace {
+
+// The solution values of the given cells, in the order of the cells.
+data::Solution cellSolution(const data::Solution& sol, const int* cells, int numCells)
+{
+    data::Solution result;
+    for (const auto& [name, cellData] : sol) {
+        std::vector<double> values(numCells);
+        for (int i = 0; i < numCells; ++i)
+            values[i] = cellData.data[cells[i]];
+        result.insert(name, cellData.dim, std::move(values), cellData.target);
+    }
+    return result;
+}
+
+}
+#endif
+
 RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionState, SummaryState& summaryState,
                                  const std::vector<Opm::RestartKey>& solutionKeys,
                                  const std::vector<Opm::RestartKey>& extraKeys,
+                                 const std::vector<int>& globalCells,
                                  Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm)
 {
 #if HAVE_MPI
     RestartValue restartValues{};
 
+    // The I/O rank needs the global indices of the cells of every process.
+    int numLocalCells = globalCells.size();
+    std::vector<int> numCells;
+    std::vector<int> cellOffset;
+    std::vector<int> allCells;
+    if (eclIO) {
+        assert(comm.rank() == 0);
+        numCells.resize(comm.size());
+    }
+    comm.gather(&numLocalCells, numCells.data(), 1, 0);
+    if (eclIO) {
+        cellOffset.resize(comm.size() + 1, 0);
+        std::partial_sum(numCells.begin(), numCells.end(), cellOffset.begin() + 1);
+        allCells.resize(cellOffset.back());
+    }
+    comm.gatherv(globalCells.data(), numLocalCells, allCells.data(),
+                 numCells.data(), cellOffset.data(), 0);
+
+    // Every process only receives the solution of its own cells, everything
+    // else is broadcast.
+    std::vector<char> solutionBuffer;
+    std::vector<int> solutionSize;
+    std::vector<int> solutionOffset;
     if (eclIO)
     {
-        assert(comm.rank() == 0);
         restartValues = eclIO->loadRestart(actionState, summaryState, solutionKeys, extraKeys);
+
+        solutionSize.resize(comm.size());
+        solutionOffset.resize(comm.size() + 1, 0);
+        for (int rank = 0; rank < comm.size(); ++rank) {
+            const auto rankSolution = cellSolution(restartValues.solution,
+                                                   allCells.data() + cellOffset[rank],
+                                                   numCells[rank]);
+            solutionBuffer.resize(solutionOffset[rank] + Mpi::packSize(rankSolution, comm));
+            int position = solutionOffset[rank];
+            Mpi::pack(rankSolution, solutionBuffer, position, comm);
+            solutionSize[rank] = position - solutionOffset[rank];
+            solutionOffset[rank + 1] = position;
+        }
+        restartValues.solution.clear();
+
         int packedSize = Mpi::packSize(restartValues, comm);
         std::vector<char> buffer(packedSize);
         int position=0;
@@ -1088,9 +1090,19 @@ RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionSt
         comm.broadcast(buffer.data(), bufferSize, 0);
         summaryState.deserialize(buffer);
     }
+
+    int localSolutionSize{};
+    comm.scatter(solutionSize.data(), &localSolutionSize, 1, 0);
+    std::vector<char> localSolutionBuffer(localSolutionSize);
+    comm.scatterv(solutionBuffer.data(), solutionSize.data(), solutionOffset.data(),
+                  localSolutionBuffer.data(), localSolutionSize, 0);
+    int position{};
+    Mpi::unpack(restartValues.solution, localSolutionBuffer, position, comm);
+
     return restartValues;
 #else
     (void) comm;
+    (void) globalCells;
     return eclIO->loadRestart(actionState, summaryState, solutionKeys, extraKeys);
 #endif
 }
@@ -29,6 +29,7 @@
 #include <dune/common/parallel/mpihelper.hh>
 
 #include <chrono>
+#include <cstring>
 #include <optional>
 #include <map>
 #include <set>
@@ -75,6 +76,38 @@ class State;
 
 namespace Mpi
 {
+/*
+  The buffers are only exchanged between the processes of one run, which all
+  use the same binary on the same architecture. The pod values are therefore
+  copied to and from the buffers as they are in memory, without going through
+  MPI_Pack and MPI_Unpack for every single value, and their packed size is
+  their size in memory.
+*/
+namespace detail
+{
+/// Copy size bytes to the buffer at position and move position past them.
+inline void packBytes(const void* data, std::size_t size,
+                      std::vector<char>& buffer, int& position)
+{
+    if (position + size > buffer.size())
+        OPM_THROW(std::logic_error, "Packing beyond the end of the buffer");
+    if (size > 0)
+        std::memcpy(buffer.data() + position, data, size);
+    position += size;
+}
+
+/// Copy size bytes from the buffer at position and move position past them.
+inline void unpackBytes(void* data, std::size_t size,
+                        const std::vector<char>& buffer, int& position)
+{
+    if (position + size > buffer.size())
+        OPM_THROW(std::logic_error, "Unpacking beyond the end of the buffer");
+    if (size > 0)
+        std::memcpy(data, buffer.data() + position, size);
+    position += size;
+}
+}
+
 template<class T>
 std::size_t packSize(const T*, std::size_t, Dune::MPIHelper::MPICommunicator,
                      std::integral_constant<bool, false>);
@@ -95,17 +128,10 @@ std::size_t packSize(const T&, Dune::MPIHelper::MPICommunicator,
 }
 
 template<class T>
-std::size_t packSize(const T&, Dune::MPIHelper::MPICommunicator comm,
+std::size_t packSize(const T&, Dune::MPIHelper::MPICommunicator,
                      std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    int size{};
-    MPI_Pack_size(1, Dune::MPITraits<T>::getType(), comm, &size);
-    return size;
-#else
-    (void) comm;
-    return 0;
-#endif
+    return sizeof(T);
 }
 
 template<class T>
@@ -171,17 +197,9 @@ void pack(const T&, std::vector<char>&, int&,
 
 template<class T>
 void pack(const T& data, std::vector<char>& buffer, int& position,
-          Dune::MPIHelper::MPICommunicator comm, std::integral_constant<bool, true>)
+          Dune::MPIHelper::MPICommunicator, std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    MPI_Pack(&data, 1, Dune::MPITraits<T>::getType(), buffer.data(),
-             buffer.size(), &position, comm);
-#else
-    (void) data;
-    (void) comm;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::packBytes(&data, sizeof(T), buffer, position);
 }
 
 template<class T>
@@ -260,17 +278,9 @@ void unpack(T&, std::vector<char>&, int&,
 
 template<class T>
 void unpack(T& data, std::vector<char>& buffer, int& position,
-            Dune::MPIHelper::MPICommunicator comm, std::integral_constant<bool, true>)
+            Dune::MPIHelper::MPICommunicator, std::integral_constant<bool, true>)
 {
-#if HAVE_MPI
-    MPI_Unpack(buffer.data(), buffer.size(), &position, &data, 1,
-               Dune::MPITraits<T>::getType(), comm);
-#else
-    (void) data;
-    (void) comm;
-    (void) buffer;
-    (void) position;
-#endif
+    detail::unpackBytes(&data, sizeof(T), buffer, position);
 }
 
 template<class T>
@@ -358,9 +368,14 @@ ADD_PACK_PROTOTYPES(time_point)
 
 } // end namespace Mpi
 
+/// Load the restart values on the I/O rank and distribute them. The solution
+/// of the returned values only holds the given global cells, in the same order,
+/// i.e. it is indexed by the local cell index if globalCells maps local cells
+/// to global ones.
 RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionState, SummaryState& summaryState,
                                  const std::vector<RestartKey>& solutionKeys,
                                  const std::vector<RestartKey>& extraKeys,
+                                 const std::vector<int>& globalCells,
                                  Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm);
 
 } // end namespace Opm
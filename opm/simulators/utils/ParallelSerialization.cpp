@@ -21,6 +21,7 @@
 
 #include <opm/simulators/utils/ParallelSerialization.hpp>
 
+#include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Action/ASTNode.hpp>
@@ -37,8 +38,48 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
 namespace Opm {
 
+namespace {
+
+// Writes and reads the serialized objects one after the other, each
+// preceded by its size.
+class FileSerializer : public EclMpiSerializer
+{
+public:
+    FileSerializer()
+        : EclMpiSerializer(Dune::MPIHelper::getCollectiveCommunication())
+    {}
+
+    template<class T>
+    void write(std::ostream& os, const T& data)
+    {
+        pack(const_cast<T&>(data));
+        const std::size_t size = m_position;
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os.write(m_buffer.data(), size);
+    }
+
+    template<class T>
+    bool read(std::istream& is, T& data)
+    {
+        std::size_t size = 0;
+        if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)))
+            return false;
+        m_buffer.resize(size);
+        if (!is.read(m_buffer.data(), size))
+            return false;
+        unpack(data);
+        return static_cast<std::size_t>(m_position) == size;
+    }
+};
+
+}
+
 void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
                        SummaryConfig& summaryConfig)
 {
@@ -53,4 +94,41 @@ void eclScheduleBroadcast(Schedule& schedule)
     Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
     ser.broadcast(schedule);
 }
+
+void parsedInputWrite(const std::string& fileName, const Deck& deck,
+                      const Schedule& schedule, const SummaryConfig& summaryConfig)
+{
+    std::ofstream os(fileName, std::ios::binary);
+    FileSerializer ser;
+    ser.write(os, deck);
+    ser.write(os, schedule);
+    ser.write(os, summaryConfig);
+    if (!os)
+        throw std::runtime_error("Writing " + fileName + " failed");
+}
+
+bool parsedInputRead(const std::string& fileName, Deck& deck,
+                     Schedule& schedule, SummaryConfig& summaryConfig)
+{
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is)
+        return false;
+
+    FileSerializer ser;
+    return ser.read(is, deck)
+        && ser.read(is, schedule)
+        && ser.read(is, summaryConfig);
+}
+
+std::size_t serializedSize(const EclipseState& eclState)
+{
+    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+    return ser.packSize(const_cast<EclipseState&>(eclState));
+}
+
+std::size_t serializedSize(const Schedule& schedule)
+{
+    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+    return ser.packSize(const_cast<Schedule&>(schedule));
+}
 }
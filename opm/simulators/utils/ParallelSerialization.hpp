@@ -19,8 +19,12 @@
 #ifndef PARALLEL_SERIALIZATION_HPP
 #define PARALLEL_SERIALIZATION_HPP
 
+#include <cstddef>
+#include <string>
+
 namespace Opm {
 
+class Deck;
 class EclipseState;
 class Schedule;
 class SummaryConfig;
@@ -36,6 +40,24 @@ void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
 /// \brief Broadcasts an schedule from root node in parallel runs.
 void eclScheduleBroadcast(Schedule& schedule);
 
+/// \brief Writes the parsed deck, the schedule and the summary config to a file,
+/// e.g. to reuse them in a later run.
+/// \details The eclipse state is not written, since its serialization does not
+///          include the grid and the field properties.
+void parsedInputWrite(const std::string& fileName, const Deck& deck,
+                      const Schedule& schedule, const SummaryConfig& summaryConfig);
+
+/// \brief Reads the objects written by parsedInputWrite().
+/// \return False if the file does not exist or is not complete.
+bool parsedInputRead(const std::string& fileName, Deck& deck,
+                     Schedule& schedule, SummaryConfig& summaryConfig);
+
+/// \brief Size of the serialized eclipse state in bytes, an estimate of its memory usage.
+std::size_t serializedSize(const EclipseState& eclState);
+
+/// \brief Size of the serialized schedule in bytes, an estimate of its memory usage.
+std::size_t serializedSize(const Schedule& schedule);
+
 } // end namespace Opm
 
 #endif // PARALLEL_SERIALIZATION_HPP
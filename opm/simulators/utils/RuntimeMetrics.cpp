@@ -0,0 +1,85 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/RuntimeMetrics.hpp>
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace Opm
+{
+
+    double RuntimeMetrics::simDaysPerHour() const
+    {
+        return wallSeconds > 0.0 ? simulatedDays / (wallSeconds / 3600.0) : 0.0;
+    }
+
+    void RuntimeMetrics::writeJson(std::ostream& os) const
+    {
+        os << std::fixed << std::setprecision(3)
+           << "{\n"
+           << "  \"report_step\": " << reportStep << ",\n"
+           << "  \"simulated_days\": " << simulatedDays << ",\n"
+           << "  \"total_days\": " << totalDays << ",\n"
+           << "  \"wall_seconds\": " << wallSeconds << ",\n"
+           << "  \"sim_days_per_hour\": " << simDaysPerHour() << ",\n"
+           << "  \"steps\": " << steps << ",\n"
+           << "  \"chops\": " << chops << ",\n"
+           << "  \"newton_iterations\": " << newtonIterations << ",\n"
+           << "  \"linear_iterations\": " << linearIterations << ",\n"
+           << "  \"pending_output_writes\": " << pendingWrites << ",\n"
+           << "  \"peak_memory_mb\": [";
+        for (std::size_t rank = 0; rank < peakMemory.size(); ++rank) {
+            os << (rank > 0 ? ", " : "") << peakMemory[rank];
+        }
+        os << "]\n"
+           << "}\n";
+    }
+
+    void RuntimeMetrics::writeJsonFile(const std::string& fileName) const
+    {
+        const std::string tmpFileName = fileName + ".tmp";
+        {
+            std::ofstream os(tmpFileName);
+            writeJson(os);
+        }
+        std::rename(tmpFileName.c_str(), fileName.c_str());
+    }
+
+    double RuntimeMetrics::processPeakMemory()
+    {
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0.0;
+        }
+#ifdef __APPLE__
+        // bytes
+        return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        // kilobytes
+        return usage.ru_maxrss / 1024.0;
+#endif
+    }
+
+} // namespace Opm
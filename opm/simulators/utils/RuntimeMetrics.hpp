@@ -0,0 +1,65 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RUNTIMEMETRICS_HEADER_INCLUDED
+#define OPM_RUNTIMEMETRICS_HEADER_INCLUDED
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Progress and health of a running simulation, for monitoring long
+    /// runs without parsing the PRT file.
+    struct RuntimeMetrics
+    {
+        int reportStep = 0;
+        double simulatedDays = 0.0;
+        double totalDays = 0.0;
+        double wallSeconds = 0.0;
+        // converged and failed (chopped) time steps
+        int steps = 0;
+        int chops = 0;
+        long newtonIterations = 0;
+        long linearIterations = 0;
+        // output writes which have been dispatched but not completed
+        int pendingWrites = 0;
+        // memory high-water mark of every process, in megabytes
+        std::vector<double> peakMemory;
+
+        /// Simulated days per hour of wall time.
+        double simDaysPerHour() const;
+
+        /// Write the metrics as a JSON object.
+        void writeJson(std::ostream& os) const;
+
+        /// Replace the file by the metrics in JSON. The metrics are
+        /// written to a temporary file which is renamed, so that readers
+        /// never see a partially written file.
+        void writeJsonFile(const std::string& fileName) const;
+
+        /// The memory high-water mark of this process, in megabytes.
+        static double processPeakMemory();
+    };
+
+} // namespace Opm
+
+#endif // OPM_RUNTIMEMETRICS_HEADER_INCLUDED
@@ -0,0 +1,274 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/ScopedTimers.hpp>
+#include <opm/simulators/utils/allGatherNames.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+
+    bool inParallelRegion()
+    {
+#ifdef _OPENMP
+        return omp_in_parallel();
+#else
+        return false;
+#endif
+    }
+
+    std::vector<std::string> components(const std::string& name)
+    {
+        std::vector<std::string> result;
+        std::string::size_type begin = 0;
+        while (true) {
+            const auto end = name.find('/', begin);
+            result.push_back(name.substr(begin, end - begin));
+            if (end == std::string::npos) {
+                return result;
+            }
+            begin = end + 1;
+        }
+    }
+
+    // Children directly after their parent, siblings in alphabetical order.
+    struct HierarchicalOrder
+    {
+        bool operator()(const std::string& a, const std::string& b) const
+        {
+            return components(a) < components(b);
+        }
+    };
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+    TimerRegistry& TimerRegistry::instance()
+    {
+        static TimerRegistry registry;
+        return registry;
+    }
+
+    void TimerRegistry::start(const std::string& name)
+    {
+        if (inParallelRegion()) {
+            return;
+        }
+        const std::string fullName = running_.empty() ? name : running_.back().name + '/' + name;
+        running_.push_back({fullName, Clock::now(), counters_.read()});
+    }
+
+    void TimerRegistry::stop()
+    {
+        if (inParallelRegion()) {
+            return;
+        }
+        if (running_.empty()) {
+            throw std::logic_error("TimerRegistry::stop() called without a running timer");
+        }
+        const auto& [name, startTime, startCounters] = running_.back();
+        const auto stopTime = Clock::now();
+        auto& entry = entries_[name];
+        entry.seconds += std::chrono::duration<double>(stopTime - startTime).count();
+        ++entry.calls;
+        if (counters_.isOpen()) {
+            entry.counters += counters_.read();
+            entry.counters -= startCounters;
+        }
+        if (tracing_) {
+            using Microseconds = std::chrono::duration<double, std::micro>;
+            const double duration = Microseconds(stopTime - startTime).count();
+            if (duration < traceMinMicroseconds_) {
+                // too short to show in a timeline
+            } else if (trace_.size() >= traceMaxEvents_) {
+                ++droppedTraceEvents_;
+            } else {
+                trace_.push_back({name.substr(name.rfind('/') + 1),
+                                  Microseconds(startTime - traceStart_).count(),
+                                  duration});
+            }
+        }
+        running_.pop_back();
+    }
+
+    std::vector<TimerRegistry::Statistics>
+    TimerRegistry::statistics(const Communication& comm, const Entries& baseline) const
+    {
+        // The timers of all processes, in the same order everywhere.
+        std::vector<std::string> localNames;
+        for (const auto& entry : entries_) {
+            localNames.push_back(entry.first);
+        }
+        const auto allNames = allGatherNames(comm, localNames);
+        const std::set<std::string, HierarchicalOrder> names(allNames.begin(), allNames.end());
+
+        std::vector<double> seconds;
+        std::vector<double> calls;
+        std::vector<double> counters;
+        for (const auto& name : names) {
+            Entry value;
+            const auto entry = entries_.find(name);
+            if (entry != entries_.end()) {
+                value = entry->second;
+            }
+            const auto base = baseline.find(name);
+            if (base != baseline.end()) {
+                value.seconds -= base->second.seconds;
+                value.calls -= base->second.calls;
+                value.counters -= base->second.counters;
+            }
+            seconds.push_back(value.seconds);
+            calls.push_back(value.calls);
+            counters.push_back(value.counters.cycles);
+            counters.push_back(value.counters.instructions);
+            counters.push_back(value.counters.cacheMisses);
+        }
+
+        auto minSeconds = seconds;
+        auto maxSeconds = seconds;
+        auto sumSeconds = seconds;
+        comm.min(minSeconds.data(), minSeconds.size());
+        comm.max(maxSeconds.data(), maxSeconds.size());
+        comm.sum(sumSeconds.data(), sumSeconds.size());
+        comm.max(calls.data(), calls.size());
+        comm.sum(counters.data(), counters.size());
+
+        std::vector<Statistics> result;
+        std::size_t i = 0;
+        for (const auto& name : names) {
+            Statistics stat;
+            stat.name = name;
+            stat.depth = std::count(name.begin(), name.end(), '/');
+            stat.min = minSeconds[i];
+            stat.max = maxSeconds[i];
+            stat.average = sumSeconds[i] / comm.size();
+            stat.calls = calls[i];
+            stat.counters.cycles = counters[3*i];
+            stat.counters.instructions = counters[3*i + 1];
+            stat.counters.cacheMisses = counters[3*i + 2];
+            result.push_back(stat);
+            ++i;
+        }
+        return result;
+    }
+
+    void TimerRegistry::print(std::ostream& os, const std::vector<Statistics>& statistics)
+    {
+        std::size_t width = 5;
+        for (const auto& stat : statistics) {
+            width = std::max(width, 2*stat.depth + components(stat.name).back().size());
+        }
+
+        const bool counted = std::any_of(statistics.begin(), statistics.end(),
+                                         [](const auto& stat) { return stat.counters.cycles > 0.0; });
+
+        os << std::left << std::setw(width) << "Timer" << std::right
+           << std::setw(10) << "Calls" << std::setw(12) << "Min [s]"
+           << std::setw(12) << "Average [s]" << std::setw(12) << "Max [s]";
+        if (counted) {
+            os << std::setw(8) << "IPC" << std::setw(10) << "LLC MPKI" << std::setw(10) << "GB/s";
+        }
+        os << '\n';
+        os << std::fixed << std::setprecision(2);
+        for (const auto& stat : statistics) {
+            const std::string label = std::string(2*stat.depth, ' ') + components(stat.name).back();
+            os << std::left << std::setw(width) << label << std::right
+               << std::setw(10) << stat.calls << std::setw(12) << stat.min
+               << std::setw(12) << stat.average << std::setw(12) << stat.max;
+            if (counted) {
+                const auto& c = stat.counters;
+                // The bandwidth of all processes together, which run for
+                // about the average time.
+                const double bytes = c.cacheMisses * HardwareCounters::cacheLineSize;
+                os << std::setw(8) << (c.cycles > 0.0 ? c.instructions / c.cycles : 0.0)
+                   << std::setw(10) << (c.instructions > 0.0 ? 1000.0 * c.cacheMisses / c.instructions : 0.0)
+                   << std::setw(10) << (stat.average > 0.0 ? bytes / stat.average * 1e-9 : 0.0);
+            }
+            os << '\n';
+        }
+    }
+
+    void TimerRegistry::writeCsv(std::ostream& os, const std::string& label,
+                                 const std::vector<Statistics>& statistics)
+    {
+        for (const auto& stat : statistics) {
+            os << label << ',' << stat.name << ',' << stat.calls << ','
+               << stat.min << ',' << stat.average << ',' << stat.max << '\n';
+        }
+    }
+
+    void TimerRegistry::startTrace(const double minMicroseconds, const std::size_t maxEvents)
+    {
+        tracing_ = true;
+        traceStart_ = Clock::now();
+        traceMinMicroseconds_ = minMicroseconds;
+        traceMaxEvents_ = maxEvents;
+        droppedTraceEvents_ = 0;
+        trace_.clear();
+    }
+
+    void TimerRegistry::writeChromeTrace(std::ostream& os, const int pid) const
+    {
+        os << "{\"traceEvents\":[";
+        os << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (const auto& event : trace_) {
+            os << (first ? "\n" : ",\n");
+            first = false;
+            os << "{\"name\":\"";
+            for (const char c : event.name) {
+                if (c == '"' || c == '\\') {
+                    os << '\\';
+                }
+                os << c;
+            }
+            os << "\",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << event.duration
+               << ",\"pid\":" << pid << ",\"tid\":0}";
+        }
+        os << "\n]}\n";
+    }
+
+    bool TimerRegistry::enableHardwareCounters()
+    {
+        return counters_.open();
+    }
+
+    void TimerRegistry::clear()
+    {
+        running_.clear();
+        entries_.clear();
+        tracing_ = false;
+        droppedTraceEvents_ = 0;
+        trace_.clear();
+        kernelTimers_ = false;
+    }
+
+} // namespace Opm
@@ -0,0 +1,216 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SCOPEDTIMERS_HEADER_INCLUDED
+#define OPM_SCOPEDTIMERS_HEADER_INCLUDED
+
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <opm/simulators/utils/HardwareCounters.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Accumulated time of hierarchical timers of this process.
+    ///
+    /// A timer started while another one is running is its child, and is
+    /// named "parent/child". The timers are meant for the main thread,
+    /// starting and stopping them inside an OpenMP parallel region does
+    /// nothing. While tracing is enabled, every stopped timer that ran long
+    /// enough is also recorded as an event of a timeline. With hardware
+    /// counters enabled, the timers also accumulate the counts of the main
+    /// thread. The timers of the inner kernels, see KernelTimer, only run
+    /// when they are enabled explicitly.
+    class TimerRegistry
+    {
+    public:
+        struct Entry
+        {
+            double seconds = 0.0;
+            long calls = 0;
+            HardwareCounters::Values counters;
+        };
+        using Entries = std::map<std::string, Entry>;
+
+        /// Timer values of a timer over all processes.
+        struct Statistics
+        {
+            std::string name;
+            int depth = 0;
+            double min = 0.0;
+            double max = 0.0;
+            double average = 0.0;
+            long calls = 0;
+            // sum over all processes
+            HardwareCounters::Values counters;
+        };
+
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        static TimerRegistry& instance();
+
+        void start(const std::string& name);
+        void stop();
+
+        /// Accumulated values of the timers that have been stopped.
+        const Entries& entries() const
+        { return entries_; }
+
+        /// The time of every timer since baseline, over all the processes
+        /// of comm. A process which never started a timer contributes zero
+        /// seconds. This is a collective operation, the children of a timer
+        /// follow their parent.
+        std::vector<Statistics> statistics(const Communication& comm,
+                                           const Entries& baseline = {}) const;
+
+        /// Print a table of statistics. If there are hardware counts, the
+        /// table also shows the instructions per cycle, the last level
+        /// cache misses per thousand instructions and the memory bandwidth
+        /// estimated from the cache misses, over all processes.
+        static void print(std::ostream& os, const std::vector<Statistics>& statistics);
+
+        /// Write statistics as CSV lines "label,timer,calls,min,average,max".
+        static void writeCsv(std::ostream& os, const std::string& label,
+                             const std::vector<Statistics>& statistics);
+
+        /// Record the timers as events from now on. The time of the events
+        /// is relative to this call, after a barrier of all processes the
+        /// timelines of the processes line up. Timers shorter than
+        /// minMicroseconds are not recorded, and once maxEvents events have
+        /// been recorded the later ones are dropped.
+        void startTrace(const double minMicroseconds = 0.0,
+                        const std::size_t maxEvents = defaultMaxTraceEvents);
+
+        /// Number of events that were not recorded since startTrace()
+        /// because the trace was full.
+        std::size_t droppedTraceEvents() const
+        { return droppedTraceEvents_; }
+
+        /// Write the events in the Chrome trace event format, which e.g.
+        /// chrome://tracing and Perfetto can show. pid identifies the
+        /// process in a view of the files of several processes.
+        void writeChromeTrace(std::ostream& os, const int pid) const;
+
+        /// Count hardware events in the timers started from now on.
+        /// Returns false if the counters are unavailable on this process.
+        bool enableHardwareCounters();
+
+        /// Run the timers of the inner kernels from now on.
+        void enableKernelTimers()
+        { kernelTimers_ = true; }
+
+        bool kernelTimersEnabled() const
+        { return kernelTimers_; }
+
+        void clear();
+
+        static constexpr std::size_t defaultMaxTraceEvents = 1000000;
+
+    private:
+        TimerRegistry() = default;
+
+        using Clock = std::chrono::steady_clock;
+
+        struct TraceEvent
+        {
+            std::string name;
+            // microseconds since traceStart_
+            double begin;
+            double duration;
+        };
+
+        struct RunningTimer
+        {
+            std::string name;
+            Clock::time_point start;
+            HardwareCounters::Values counters;
+        };
+
+        std::vector<RunningTimer> running_;
+        Entries entries_;
+        bool tracing_ = false;
+        Clock::time_point traceStart_;
+        double traceMinMicroseconds_ = 0.0;
+        std::size_t traceMaxEvents_ = defaultMaxTraceEvents;
+        std::size_t droppedTraceEvents_ = 0;
+        std::vector<TraceEvent> trace_;
+        HardwareCounters counters_;
+        bool kernelTimers_ = false;
+    };
+
+    /// Time the enclosing scope with a timer of the TimerRegistry.
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const std::string& name)
+        { TimerRegistry::instance().start(name); }
+
+        ~ScopedTimer()
+        { TimerRegistry::instance().stop(); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+    /// A ScopedTimer for the inner kernels, e.g. a single matrix-vector
+    /// product, which are called too often for an unconditional timer. It
+    /// only times the scope if the kernel timers of the TimerRegistry are
+    /// enabled, otherwise it costs a branch.
+    class KernelTimer
+    {
+    public:
+        explicit KernelTimer(const char* name)
+            : running_(TimerRegistry::instance().kernelTimersEnabled())
+        {
+            if (running_) {
+                TimerRegistry::instance().start(name);
+            }
+        }
+
+        ~KernelTimer()
+        {
+            if (running_) {
+                TimerRegistry::instance().stop();
+            }
+        }
+
+        KernelTimer(const KernelTimer&) = delete;
+        KernelTimer& operator=(const KernelTimer&) = delete;
+
+    private:
+        bool running_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SCOPEDTIMERS_HEADER_INCLUDED
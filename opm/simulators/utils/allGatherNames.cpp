@@ -0,0 +1,56 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/allGatherNames.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Opm
+{
+
+    std::vector<std::string>
+    allGatherNames(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                   const std::vector<std::string>& names)
+    {
+        std::vector<char> localNames;
+        for (const auto& name : names) {
+            localNames.insert(localNames.end(), name.begin(), name.end());
+            localNames.push_back('\0');
+        }
+        int localSize = localNames.size();
+        std::vector<int> sizes(comm.size());
+        comm.allgather(&localSize, 1, sizes.data());
+        std::vector<int> displacements(comm.size() + 1, 0);
+        std::partial_sum(sizes.begin(), sizes.end(), displacements.begin() + 1);
+        std::vector<char> allNames(displacements.back());
+        comm.allgatherv(localNames.data(), localSize, allNames.data(), sizes.data(), displacements.data());
+
+        std::vector<std::string> result;
+        for (auto begin = allNames.begin(); begin != allNames.end(); ) {
+            const auto end = std::find(begin, allNames.end(), '\0');
+            result.emplace_back(begin, end);
+            begin = end + (end != allNames.end());
+        }
+        return result;
+    }
+
+} // namespace Opm
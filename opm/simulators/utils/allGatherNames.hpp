@@ -0,0 +1,46 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ALLGATHERNAMES_HEADER_INCLUDED
+#define OPM_ALLGATHERNAMES_HEADER_INCLUDED
+
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The names of all processes of comm, ordered by rank and in the given
+    /// order for each process. The result is the same on all processes, a
+    /// name known to several processes appears once for each of them.
+    std::vector<std::string>
+    allGatherNames(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                   const std::vector<std::string>& names);
+
+} // namespace Opm
+
+#endif // OPM_ALLGATHERNAMES_HEADER_INCLUDED
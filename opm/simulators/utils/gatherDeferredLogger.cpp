@@ -138,23 +138,30 @@ namespace Opm
         assert(offset == message_size);
 
         // Get message sizes and create offset/displacement array for gathering.
+        // The messages are only logged by the root process, so they are only
+        // gathered there.
         int num_processes = -1;
         MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
-        std::vector<int> message_sizes(num_processes);
-        MPI_Allgather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
-        std::vector<int> displ(num_processes + 1, 0);
+        int rank = -1;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        const bool is_root = rank == 0;
+        std::vector<int> message_sizes(is_root ? num_processes : 0);
+        MPI_Gather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        std::vector<int> displ(message_sizes.size() + 1, 0);
         std::partial_sum(message_sizes.begin(), message_sizes.end(), displ.begin() + 1);
 
         // Gather.
         std::vector<char> recv_buffer(displ.back());
-        MPI_Allgatherv(buffer.data(), buffer.size(), MPI_PACKED,
-                       const_cast<char*>(recv_buffer.data()), message_sizes.data(),
-                       displ.data(), MPI_PACKED,
-                       MPI_COMM_WORLD);
+        MPI_Gatherv(buffer.data(), buffer.size(), MPI_PACKED,
+                    recv_buffer.data(), message_sizes.data(),
+                    displ.data(), MPI_PACKED,
+                    0, MPI_COMM_WORLD);
 
         // Unpack.
         Opm::DeferredLogger global_deferredlogger;
-        global_deferredlogger.messages_ = unpackMessages(recv_buffer, displ);
+        if (is_root) {
+            global_deferredlogger.messages_ = unpackMessages(recv_buffer, displ);
+        }
         return global_deferredlogger;
     }
 
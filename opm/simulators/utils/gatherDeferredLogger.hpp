@@ -26,7 +26,8 @@
 namespace Opm
 {
 
-    /// Create a global log combining local logs
+    /// Create a global log combining local logs. Only the log of the root
+    /// process holds the messages, the other processes get an empty log.
     Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger);
 
 } // namespace Opm
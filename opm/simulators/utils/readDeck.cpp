@@ -47,6 +47,7 @@
 
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/ErrorGuard.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
 
 #include "UnsupportedFlowKeywords.hpp"
 #include "PartiallySupportedFlowKeywords.hpp"
@@ -57,7 +58,15 @@
 
 #include <fmt/format.h>
 
+#include <cstdint>
 #include <cstdlib>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
 
 namespace Opm
 {
@@ -75,7 +84,7 @@ void ensureOutputDirExists_(const std::string& cmdline_output_dir)
 }
 
 // Setup the OpmLog backends
-FileOutputMode setupLogging(int mpi_rank_, const std::string& deck_filename, const std::string& cmdline_output_dir, const std::string& cmdline_output, bool output_cout_, const std::string& stdout_log_id) {
+FileOutputMode setupLogging(int mpi_rank_, const std::string& deck_filename, const std::string& cmdline_output_dir, const std::string& cmdline_output, bool output_cout_, const std::string& stdout_log_id, bool log_all_ranks) {
 
     if (!cmdline_output_dir.empty()) {
         ensureOutputDirExists_(cmdline_output_dir);
@@ -136,14 +145,19 @@ FileOutputMode setupLogging(int mpi_rank_, const std::string& deck_filename, con
         }
     }
 
-    if (output > FileOutputMode::OUTPUT_NONE) {
+    // The files of the non-root ranks would only be removed again at the
+    // end of the run, on large runs creating them is a burden for the
+    // file system.
+    const bool logToFiles = mpi_rank_ == 0 || log_all_ranks;
+
+    if (logToFiles && output > FileOutputMode::OUTPUT_NONE) {
         std::shared_ptr<Opm::EclipsePRTLog> prtLog = std::make_shared<Opm::EclipsePRTLog>(logFileStream.str(), Opm::Log::NoDebugMessageTypes, false, output_cout_);
         Opm::OpmLog::addBackend("ECLIPSEPRTLOG", prtLog);
         prtLog->setMessageLimiter(std::make_shared<Opm::MessageLimiter>());
         prtLog->setMessageFormatter(std::make_shared<Opm::SimpleMessageFormatter>(false));
     }
 
-    if (output >= FileOutputMode::OUTPUT_LOG_ONLY) {
+    if (logToFiles && output >= FileOutputMode::OUTPUT_LOG_ONLY) {
         std::string debugFile = debugFileStream.str();
         std::shared_ptr<Opm::StreamLog> debugLog = std::make_shared<Opm::EclipsePRTLog>(debugFileStream.str(), Opm::Log::DefaultMessageTypes, false, output_cout_);
         Opm::OpmLog::addBackend("DEBUGLOG", debugLog);
@@ -178,13 +192,114 @@ void setupMessageLimiter(const Opm::MessageLimits msgLimits,  const std::string&
                                             msgLimits.getBugPrintLimit()}};
     stream_log->setMessageLimiter(std::make_shared<Opm::MessageLimiter>(10, limits));
 }
+
+// The files of a deck: the data file and the files it includes, found by
+// scanning the files for the INCLUDE, IMPORT and GDFILE keywords without
+// parsing them. Empty if an included file can not be resolved, e.g. because
+// it uses an alias of the PATHS keyword.
+std::vector<Opm::filesystem::path> deckInputFiles(const std::string& deckFilename)
+{
+    using Opm::filesystem::path;
+    const path rootDir = path(deckFilename).parent_path();
+    std::vector<path> files{path(deckFilename)};
+    for (std::size_t fileIdx = 0; fileIdx < files.size(); ++fileIdx) {
+        std::ifstream is(files[fileIdx].string());
+        if (!is)
+            return {};
+
+        bool includesFile = false;
+        std::string line;
+        while (std::getline(is, line)) {
+            line = line.substr(0, line.find("--"));
+            std::istringstream tokens(line);
+            std::string token;
+            if (!(tokens >> token))
+                continue;
+
+            if (!includesFile) {
+                const std::string keyword = uppercase(token);
+                includesFile = keyword == "INCLUDE" || keyword == "IMPORT" || keyword == "GDFILE";
+                continue;
+            }
+            includesFile = false;
+
+            std::string fileName;
+            const auto begin = line.find_first_not_of(" \t");
+            if (line[begin] == '\'' || line[begin] == '"') {
+                const auto end = line.find(line[begin], begin + 1);
+                if (end == std::string::npos)
+                    return {};
+                fileName = line.substr(begin + 1, end - begin - 1);
+            }
+            else {
+                fileName = token.substr(0, token.find('/'));
+            }
+            if (fileName.empty() || fileName.find('$') != std::string::npos)
+                return {};
+
+            path includedFile(fileName);
+            if (includedFile.is_relative())
+                includedFile = rootDir / includedFile;
+            if (!Opm::filesystem::is_regular_file(includedFile))
+                return {};
+            files.push_back(includedFile);
+        }
+    }
+    return files;
+}
+
+// The name of the cache file of a deck, which depends on the contents of all
+// files of the deck, the options used to set it up, the actions of the parse
+// context and the build of the simulator. Empty if the files of the deck can
+// not be determined.
+std::string deckCacheFile(const std::string& deckCacheDir, const std::string& deckFilename,
+                          bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval,
+                          const Opm::ParseContext& parseContext)
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto addBytes = [&hash](const char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+    };
+    const auto addString = [&addBytes](const std::string& str)
+    {
+        addBytes(str.data(), str.size() + 1);
+    };
+
+    const auto files = deckInputFiles(deckFilename);
+    if (files.empty())
+        return {};
+
+    addString(__DATE__ " " __TIME__);
+    addString(std::to_string(initFromRestart) + " " + std::to_string(checkDeck) + " "
+              + std::to_string(outputInterval.value_or(-1)));
+    // Strict parsing and the OPM_ERRORS_* environment variables only change
+    // the actions of the parse context.
+    for (const auto& [key, action] : parseContext)
+        addString(key + " " + std::to_string(static_cast<int>(action)));
+    std::vector<char> buffer(1 << 20);
+    for (const auto& file : files) {
+        addString(file.generic_string());
+        std::ifstream is(file.string(), std::ios::binary);
+        while (is.read(buffer.data(), buffer.size()) || is.gcount() > 0)
+            addBytes(buffer.data(), is.gcount());
+    }
+
+    ensureOutputDirExists_(deckCacheDir);
+    return fmt::format("{}/{:016x}.OPMDECK", deckCacheDir, hash);
+}
 }
 
 
 void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& deck, std::unique_ptr<Opm::EclipseState>& eclipseState,
               std::unique_ptr<Opm::Schedule>& schedule, std::unique_ptr<Opm::SummaryConfig>& summaryConfig,
               std::unique_ptr<ErrorGuard> errorGuard, std::shared_ptr<Opm::Python>& python, std::unique_ptr<ParseContext> parseContext,
-              bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval)
+              bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval,
+              bool parseOnAllRanks, const std::string& deckCacheDir)
 {
     if (!errorGuard)
     {
@@ -194,36 +309,96 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
     int parseSuccess = 1; // > 0 is success
     std::string failureMessage;
 
-    if (rank==0) {
+    if (rank==0 || parseOnAllRanks) {
         try
         {
+            // The cache holds the serialized deck, schedule and summary config,
+            // the serialization is only available with MPI. The EclipseState is
+            // still set up from the deck, its serialization does not include the
+            // grid and the field properties. Restarted runs are not cached since
+            // they also depend on the restart file. A deck is only cached if
+            // it had no errors, the keywords of a cached deck are validated
+            // and checked again below, but the warnings of the parser and of
+            // setting up the schedule are not repeated.
+            std::string cacheFile;
+            bool fromCache = false;
+#if HAVE_MPI
+            if (!deckCacheDir.empty() && parseContext && !deck && !eclipseState && !schedule && !summaryConfig) {
+                cacheFile = deckCacheFile(deckCacheDir, deckFilename, initFromRestart, checkDeck,
+                                          outputInterval, *parseContext);
+                if (!cacheFile.empty() && Opm::filesystem::exists(cacheFile)) {
+                    deck = std::make_unique<Opm::Deck>();
+                    schedule = std::make_unique<Opm::Schedule>(python);
+                    summaryConfig = std::make_unique<Opm::SummaryConfig>();
+                    try {
+                        fromCache = parsedInputRead(cacheFile, *deck, *schedule, *summaryConfig);
+                    }
+                    catch (const std::exception&) {
+                        fromCache = false;
+                    }
+                    if (fromCache) {
+                        OpmLog::info("Reading the parsed deck from the cache file '" + cacheFile + "'");
+                    }
+                    else {
+                        deck.reset();
+                        schedule.reset();
+                        summaryConfig.reset();
+                    }
+                }
+            }
+#endif
+
             if ( (!deck || !schedule || !summaryConfig ) && !parseContext)
             {
                 OPM_THROW(std::logic_error, "We need a parse context if deck, schedule, or summaryConfig are not initialized");
             }
 
-            if (!deck)
+            // The keywords of a freshly parsed or cached deck are validated
+            // while the deck is checked and the EclipseState is set up, which
+            // only read the deck as well. The problems found are still
+            // reported first.
+            std::future<std::vector<Opm::KeywordValidation::ValidationError>> keywordErrors;
+            const auto reportKeywordErrors = [&keywordErrors, &parseContext, &errorGuard]()
             {
-                Opm::Parser parser;
-                deck = std::make_unique<Opm::Deck>( parser.parseFile(deckFilename , *parseContext, *errorGuard));
+                if (keywordErrors.valid())
+                    Opm::KeywordValidation::KeywordValidator::reportErrors(keywordErrors.get(), *parseContext, *errorGuard);
+            };
 
-                Opm::KeywordValidation::KeywordValidator keyword_validator(
-                    Opm::FlowKeywordValidation::unsupportedKeywords(),
-                    Opm::FlowKeywordValidation::partiallySupported<std::string>(),
-                    Opm::FlowKeywordValidation::partiallySupported<int>());
-                keyword_validator.validateDeck(*deck, *parseContext, *errorGuard);
-
-                if ( checkDeck )
-                    Opm::checkDeck(*deck, parser, *parseContext, *errorGuard);
-            }
-
-            if (!eclipseState) {
+            try
+            {
+                if (!deck || fromCache)
+                {
+                    Opm::Parser parser;
+                    if (!deck)
+                        deck = std::make_unique<Opm::Deck>( parser.parseFile(deckFilename , *parseContext, *errorGuard));
+
+                    keywordErrors = std::async(std::launch::async, [&deck]()
+                    {
+                        const Opm::KeywordValidation::KeywordValidator keyword_validator(
+                            Opm::FlowKeywordValidation::unsupportedKeywords(),
+                            Opm::FlowKeywordValidation::partiallySupported<std::string>(),
+                            Opm::FlowKeywordValidation::partiallySupported<int>());
+                        return keyword_validator.validate(*deck);
+                    });
+
+                    if ( checkDeck )
+                        Opm::checkDeck(*deck, parser, *parseContext, *errorGuard);
+                }
+
+                if (!eclipseState) {
 #if HAVE_MPI
-                eclipseState = std::make_unique<Opm::ParallelEclipseState>(*deck);
+                    eclipseState = std::make_unique<Opm::ParallelEclipseState>(*deck);
 #else
-                eclipseState = std::make_unique<Opm::EclipseState>(*deck);
+                    eclipseState = std::make_unique<Opm::EclipseState>(*deck);
 #endif
+                }
+            }
+            catch (...)
+            {
+                reportKeywordErrors();
+                throw;
             }
+            reportKeywordErrors();
             /*
               For the time being initializing wells and groups from the
               restart file is not possible, but work is underways and it is
@@ -251,6 +426,25 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
                                                                      eclipseState->aquifer(), *parseContext, *errorGuard);
 
             Opm::checkConsistentArrayDimensions(*eclipseState, *schedule, *parseContext, *errorGuard);
+
+#if HAVE_MPI
+            if (!cacheFile.empty() && !fromCache && rank == 0 && !*errorGuard
+                && !eclipseState->getInitConfig().restartRequested())
+            {
+                // Other runs may read the cache at the same time, they only
+                // see complete files.
+                const std::string tmpFile = cacheFile + ".tmp" + std::to_string(::getpid());
+                try {
+                    parsedInputWrite(tmpFile, *deck, *schedule, *summaryConfig);
+                    Opm::filesystem::rename(tmpFile, cacheFile);
+                }
+                catch (const std::exception& e) {
+                    std::error_code ec;
+                    Opm::filesystem::remove(tmpFile, ec);
+                    OpmLog::warning(fmt::format("Writing the deck cache file '{}' failed: {}", cacheFile, e.what()));
+                }
+            }
+#endif
         }
         catch(const OpmInputError& input_error) {
             failureMessage = input_error.what();
@@ -272,23 +466,26 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
             eclipseState = std::make_unique<Opm::ParallelEclipseState>();
     }
 
-    try
-    {
-        Opm::eclStateBroadcast(*eclipseState, *schedule, *summaryConfig);
-    }
-    catch(const std::exception& broadcast_error)
-    {
-        failureMessage = broadcast_error.what();
-        OpmLog::error(fmt::format("Distributing properties to all processes failed\n"
-                                  "Internal error message: {}", broadcast_error.what()));
-        parseSuccess = 0;
+    if (!parseOnAllRanks) {
+        try
+        {
+            Opm::eclStateBroadcast(*eclipseState, *schedule, *summaryConfig);
+        }
+        catch(const std::exception& broadcast_error)
+        {
+            failureMessage = broadcast_error.what();
+            OpmLog::error(fmt::format("Distributing properties to all processes failed\n"
+                                      "Internal error message: {}", broadcast_error.what()));
+            parseSuccess = 0;
+        }
     }
-
 #endif
 
     if (*errorGuard) { // errors encountered
         parseSuccess = 0;
-        errorGuard->dump();
+        // All processes see the same errors if they all parse the deck.
+        if (rank == 0)
+            errorGuard->dump();
         errorGuard->clear();
     }
 
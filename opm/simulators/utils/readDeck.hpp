@@ -46,16 +46,25 @@ enum class FileOutputMode {
     OUTPUT_ALL = 3
 };
 
-// Setup the OpmLog backends
-FileOutputMode setupLogging(int mpi_rank_, const std::string& deck_filename, const std::string& cmdline_output_dir, const std::string& cmdline_output, bool output_cout_, const std::string& stdout_log_id);
+// Setup the OpmLog backends. The non-root ranks only get log files if
+// log_all_ranks is true, their messages are otherwise discarded.
+FileOutputMode setupLogging(int mpi_rank_, const std::string& deck_filename, const std::string& cmdline_output_dir, const std::string& cmdline_output, bool output_cout_, const std::string& stdout_log_id, bool log_all_ranks);
 
 /// \brief Reads the deck and creates all necessary objects if needed
 ///
 /// If pointers already contains objects then they are used otherwise they are created and can be used outside later.
+/// By default the objects are created on the root process and broadcast to the others. If
+/// parseOnAllRanks is true every process creates them from the deck file instead, which
+/// avoids the serialization and the broadcast at the price of the memory for the global
+/// field properties on every process.
+/// If deckCacheDir is not empty, the objects created from a deck are stored in a file in
+/// that directory, and are read from it instead of parsing the deck again as long as
+/// the files of the deck are unchanged.
 void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Deck>& deck, std::unique_ptr<EclipseState>& eclipseState,
               std::unique_ptr<Schedule>& schedule, std::unique_ptr<SummaryConfig>& summaryConfig,
               std::unique_ptr<ErrorGuard> errorGuard, std::shared_ptr<Python>& python, std::unique_ptr<ParseContext> parseContext,
-              bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval);
+              bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval,
+              bool parseOnAllRanks, const std::string& deckCacheDir = "");
 } // end namespace Opm
 
 #endif // OPM_READDECK_HEADER_INCLUDED
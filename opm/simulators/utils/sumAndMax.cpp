@@ -0,0 +1,112 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/sumAndMax.hpp>
+
+#if HAVE_MPI
+
+#include <algorithm>
+#include <mpi.h>
+
+namespace
+{
+
+    // A value to reduce, isMax > 0 for a maximum and a sum otherwise.
+    struct Entry
+    {
+        double value;
+        double isMax;
+    };
+
+    void sumOrMax(void* in, void* inout, int* len, MPI_Datatype*)
+    {
+        const auto* a = static_cast<const Entry*>(in);
+        auto* b = static_cast<Entry*>(inout);
+        for (int i = 0; i < *len; ++i) {
+            b[i].value = b[i].isMax > 0.0 ? std::max(a[i].value, b[i].value)
+                                          : a[i].value + b[i].value;
+        }
+    }
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+    void sumAndMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                   std::vector<double>& sumValues,
+                   std::vector<double>& maxValues)
+    {
+        if (comm.size() == 1) {
+            return;
+        }
+
+        // Created on the first call, i.e. after MPI_Init, and kept until
+        // the end of the run.
+        static const MPI_Datatype entryType = [] {
+            MPI_Datatype type;
+            MPI_Type_contiguous(2, MPI_DOUBLE, &type);
+            MPI_Type_commit(&type);
+            return type;
+        }();
+        static const MPI_Op sumOrMaxOp = [] {
+            MPI_Op op;
+            MPI_Op_create(&sumOrMax, /*commute=*/ 1, &op);
+            return op;
+        }();
+
+        std::vector<Entry> buffer;
+        buffer.reserve(sumValues.size() + maxValues.size());
+        for (const double value : sumValues) {
+            buffer.push_back({value, 0.0});
+        }
+        for (const double value : maxValues) {
+            buffer.push_back({value, 1.0});
+        }
+
+        MPI_Allreduce(MPI_IN_PLACE, buffer.data(), buffer.size(),
+                      entryType, sumOrMaxOp, comm);
+
+        auto entry = buffer.begin();
+        for (double& value : sumValues) {
+            value = (entry++)->value;
+        }
+        for (double& value : maxValues) {
+            value = (entry++)->value;
+        }
+    }
+
+} // namespace Opm
+
+#else // HAVE_MPI
+
+namespace Opm
+{
+
+    void sumAndMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>&,
+                   std::vector<double>&,
+                   std::vector<double>&)
+    {
+    }
+
+} // namespace Opm
+
+#endif // HAVE_MPI
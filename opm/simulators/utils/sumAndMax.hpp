@@ -0,0 +1,54 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SUMANDMAX_HEADER_INCLUDED
+#define OPM_SUMANDMAX_HEADER_INCLUDED
+
+#include <dune/common/version.hh>
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+#include <dune/common/parallel/communication.hh>
+#else
+#include <dune/common/parallel/collectivecommunication.hh>
+#endif
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// Sum sumValues and take the maximum of maxValues over all processes of
+    /// comm, with a single collective operation instead of one for each.
+    void sumAndMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                   std::vector<double>& sumValues,
+                   std::vector<double>& maxValues);
+
+    /// Fallback for other communicators, with one sum and one max reduction.
+    template <class Communication>
+    void sumAndMax(const Communication& comm,
+                   std::vector<double>& sumValues,
+                   std::vector<double>& maxValues)
+    {
+        comm.sum(sumValues.data(), sumValues.size());
+        comm.max(maxValues.data(), maxValues.size());
+    }
+
+} // namespace Opm
+
+#endif // OPM_SUMANDMAX_HEADER_INCLUDED
@@ -21,6 +21,7 @@
 
 
 #include <opm/simulators/wells/ALQState.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
 
 namespace Opm {
 
@@ -114,9 +115,19 @@ std::size_t ALQState::unpack_data(const double * data) {
     return index;
 }
 
-
-
+void ALQState::writeCheckpoint(std::ostream& os) const {
+    BinaryCheckpoint::write(os, this->current_alq_);
+    BinaryCheckpoint::write(os, this->default_alq_);
+    BinaryCheckpoint::write(os, this->alq_increase_count_);
+    BinaryCheckpoint::write(os, this->alq_decrease_count_);
 }
 
+void ALQState::readCheckpoint(std::istream& is) {
+    BinaryCheckpoint::read(is, this->current_alq_);
+    BinaryCheckpoint::read(is, this->default_alq_);
+    BinaryCheckpoint::read(is, this->alq_increase_count_);
+    BinaryCheckpoint::read(is, this->alq_decrease_count_);
+}
 
 
+}
@@ -20,6 +20,7 @@
 #ifndef OPM_ALQ_STATE_HEADER_INCLUDED
 #define OPM_ALQ_STATE_HEADER_INCLUDED
 
+#include <iosfwd>
 #include <map>
 #include <string>
 #include <vector>
@@ -43,6 +44,9 @@ public:
     int  get_increment_count(const std::string& wname) const;
     int  get_decrement_count(const std::string& wname) const;
 
+    void writeCheckpoint(std::ostream& os) const;
+    void readCheckpoint(std::istream& is);
+
 private:
     std::map<std::string, double> current_alq_;
     std::map<std::string, double> default_alq_;
@@ -50,6 +50,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/Group.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GConSale.hpp>
 
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
 #include <opm/simulators/flow/countGlobalCells.hpp>
 #include <opm/simulators/wells/GasLiftSingleWell.hpp>
@@ -96,6 +97,7 @@ namespace Opm {
             typedef BlackoilModelParametersEbos<TypeTag> ModelParameters;
 
             using Grid = GetPropType<TypeTag, Properties::Grid>;
+            using GridView = GetPropType<TypeTag, Properties::GridView>;
             using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
             using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
             using Indices = GetPropType<TypeTag, Properties::Indices>;
@@ -160,20 +162,47 @@ namespace Opm {
             // </ eWoms auxiliary module stuff>
             /////////////
 
+            /*!
+             * \brief This method restores the state of the wells and groups
+             *        from a checkpoint written by serialize().
+             *
+             * The wells of the report step must be initialized already, i.e.
+             * the episode must have begun.
+             */
             template <class Restarter>
-            void deserialize(Restarter& /* res */)
+            void deserialize(Restarter& res)
             {
-                // TODO (?)
+                res.deserializeSectionBegin("BlackoilWellModel");
+                auto& is = res.deserializeStream();
+                this->active_wgstate_.well_state.readCheckpoint(is);
+                this->active_wgstate_.group_state.readCheckpoint(is);
+                this->nupcol_wgstate_.well_state.readCheckpoint(is);
+                this->nupcol_wgstate_.group_state.readCheckpoint(is);
+                res.deserializeSectionEnd();
+
+                this->active_wgstate_is_nupcol_ = false;
+                this->active_wgstate_committed_ = false;
+                this->commitWGState();
             }
 
             /*!
              * \brief This method writes the complete state of the well
              *        to the harddisk.
+             *
+             * The state is written in the binary format of BinaryCheckpoint,
+             * the structure of the wells is recreated from the schedule when
+             * the checkpoint is read.
              */
             template <class Restarter>
-            void serialize(Restarter& /* res*/)
+            void serialize(Restarter& res)
             {
-                // TODO (?)
+                res.serializeSectionBegin("BlackoilWellModel");
+                auto& os = res.serializeStream();
+                this->active_wgstate_.well_state.writeCheckpoint(os);
+                this->active_wgstate_.group_state.writeCheckpoint(os);
+                this->nupcol_wgstate_.well_state.writeCheckpoint(os);
+                this->nupcol_wgstate_.group_state.writeCheckpoint(os);
+                res.serializeSectionEnd();
             }
 
             void beginEpisode()
@@ -190,7 +219,9 @@ namespace Opm {
             }
 
             void endIteration()
-            { }
+            {
+                completeWellEqAssembly();
+            }
 
             void endTimeStep()
             {
@@ -244,6 +275,10 @@ namespace Opm {
                    currently active wellstate or a wellstate frozen at max
                    nupcol iterations. This is handled with the member
                    nupcol_well_state_ and the initNupcolWellState() function.
+
+              The mutable accessors record that the active state may have
+              changed. As long as it has not, committing, resetting and
+              updating the nupcol state do not copy anything.
             */
 
 
@@ -260,9 +295,20 @@ namespace Opm {
             */
             WellState& wellState()
             {
+                this->activeWGStateModified();
                 return this->active_wgstate_.well_state;
             }
 
+            /*
+              Bytes of the active, last valid and nupcol wellstates.
+            */
+            std::size_t wellStateMemoryUsage() const
+            {
+                return this->active_wgstate_.well_state.memoryUsage()
+                    + this->last_valid_wgstate_.well_state.memoryUsage()
+                    + this->nupcol_wgstate_.well_state.memoryUsage();
+            }
+
             /*
               Will return the last good wellstate. This is typcially used when
               initializing a new report step where the Schedule object might
@@ -296,7 +342,10 @@ namespace Opm {
             */
             void commitWGState()
             {
-                this->last_valid_wgstate_ = this->active_wgstate_;
+                if (!this->active_wgstate_committed_) {
+                    this->last_valid_wgstate_ = this->active_wgstate_;
+                    this->active_wgstate_committed_ = true;
+                }
             }
 
             /*
@@ -307,6 +356,7 @@ namespace Opm {
             void commitWGState(WGState wgstate)
             {
                 this->last_valid_wgstate_ = std::move(wgstate);
+                this->active_wgstate_committed_ = false;
             }
 
             /*
@@ -316,7 +366,11 @@ namespace Opm {
             */
             void resetWGState()
             {
-                this->active_wgstate_ = this->last_valid_wgstate_;
+                if (!this->active_wgstate_committed_) {
+                    this->active_wgstate_ = this->last_valid_wgstate_;
+                    this->active_wgstate_committed_ = true;
+                    this->active_wgstate_is_nupcol_ = false;
+                }
             }
 
             /*
@@ -326,7 +380,10 @@ namespace Opm {
             */
             void updateNupcolWGState()
             {
-                this->nupcol_wgstate_ = this->active_wgstate_;
+                if (!this->active_wgstate_is_nupcol_) {
+                    this->nupcol_wgstate_ = this->active_wgstate_;
+                    this->active_wgstate_is_nupcol_ = true;
+                }
             }
 
             const GroupState& groupState() const
@@ -354,7 +411,7 @@ namespace Opm {
             // subtract B*inv(D)*C * x from A*x
             void apply(const BVector& x, BVector& Ax) const;
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
             // accumulate the contributions of all Wells in the WellContributions object
             void getWellContributions(WellContributions& x) const;
 #endif
@@ -376,6 +433,25 @@ namespace Opm {
                 }
             }
 
+            // add an approximation of the well contributions to a copy of the
+            // jacobian which is only used by the preconditioner
+            void addWellContributionsToPreconditioner(typename SparseMatrixAdapter::IstlMatrix& mat) const
+            {
+                for ( const auto& well: well_container_ ) {
+                    well->addWellContributionsToPreconditioner(mat);
+                }
+            }
+
+            // copies of the matrices of the local wells, for dumping the linear system
+            std::vector<Helper::WellSystemBlocks> wellSystemBlocks() const
+            {
+                std::vector<Helper::WellSystemBlocks> blocks;
+                for (const auto& well : well_container_) {
+                    well->addWellSystemBlocks(blocks);
+                }
+                return blocks;
+            }
+
             // called at the beginning of a report step
             void beginReportStep(const int time_step);
 
@@ -391,16 +467,21 @@ namespace Opm {
             double wellPI(const int well_index) const;
             double wellPI(const std::string& well_name) const;
 
+            // Make sure that the intensive quantities of all the perforated cells
+            // are in the cache of the model, the wells read them from there.
             void updatePerforationIntensiveQuantities();
             // it should be able to go to prepareTimeStep(), however, the updateWellControls() and initPrimaryVariablesEvaluation()
             // makes it a little more difficult. unless we introduce if (iterationIdx != 0) to avoid doing the above functions
             // twice at the beginning of the time step
             /// Calculating the explict quantities used in the well calculation. By explicit, we mean they are cacluated
             /// at the beginning of the time step and no derivatives are included in these quantities
-            void calculateExplicitQuantities(DeferredLogger& deferred_logger) const;
+            void calculateExplicitQuantities(DeferredLogger& deferred_logger);
             // some preparation work, mostly related to group control and RESV,
             // at the beginning of each time step (Not report step)
             void prepareTimeStep(DeferredLogger& deferred_logger);
+
+            // check the operability of all the local wells in one pass
+            void updateWellsOperability(DeferredLogger& deferred_logger);
             void initPrimaryVariablesEvaluation() const;
             void updateWellControls(DeferredLogger& deferred_logger, const bool checkGroupControls);
             WellInterfacePtr getWell(const std::string& well_name) const;
@@ -423,14 +504,21 @@ namespace Opm {
             // Map from logically cartesian cell indices to compressed ones.
             // Cells not in the interior are not mapped. This deactivates
             // these for distributed wells and makes the distribution non-overlapping.
-            std::vector<int> cartesian_to_compressed_{};
+            std::unordered_map<int, int> cartesian_to_compressed_{};
 
             std::vector<bool> is_cell_perforated_{};
+            // The indices of the perforated cells, in increasing order.
+            std::vector<int> perforated_cells_{};
 
             std::function<bool(const Well&)> not_on_process_{};
 
             void initializeWellProdIndCalculators();
             void initializeWellPerfData();
+            // As initializeWellPerfData(), but the perforation data of the wells
+            // whose connections are the same as in previous_wells are taken
+            // from previous_perf_data instead of being rebuilt.
+            void initializeWellPerfData(const std::vector<Well>& previous_wells,
+                                        std::vector<std::vector<PerforationData>>& previous_perf_data);
             void initializeWellState(const int           timeStepIdx,
                                      const SummaryState& summaryState);
 
@@ -462,6 +550,10 @@ namespace Opm {
             std::vector<double> depth_{};
             bool initial_step_{};
             bool report_step_starts_{};
+
+            // Number of calls to wellTesting(), used to evaluate the well
+            // tests only every well_test_step_interval_ time steps.
+            int well_test_step_count_{0};
             bool glift_debug = false;
             bool alternative_well_rate_init_{};
 
@@ -527,7 +619,10 @@ namespace Opm {
             // setting the well_solutions_ based on well_state.
             void updatePrimaryVariables(DeferredLogger& deferred_logger);
 
-            void setupCartesianToCompressed_(const int* global_cell, int local_num__cells);
+            void setupCartesianToCompressed_(const int* global_cell);
+
+            // The compressed index of an interior cell, -1 for all other cells.
+            int compressedIndexForInterior(int cartesian_cell_idx) const;
 
             void setRepRadiusPerfLength();
 
@@ -555,8 +650,24 @@ namespace Opm {
 
             int reportStepIndex() const;
 
+            // Below this number of local wells, forEachWell() does not use threads.
+            static constexpr int minWellsForThreading = 16;
+
+            // Calls func(well, well_logger) for every well of the well container.
+            // With enough wells and no distributed ones, the wells are processed
+            // by several threads, func must then only modify the data of its own
+            // well. Each well logs to its own logger, and the loggers are appended
+            // to deferred_logger in well order. The first exception thrown by
+            // func is rethrown after all the wells have been processed.
+            template <class Func>
+            void forEachWell(DeferredLogger& deferred_logger, Func&& func);
+
             void assembleWellEq(const double dt, DeferredLogger& deferred_logger);
 
+            // finish the assembly of the distributed wells, whose equations
+            // are summed over the processes while the reservoir is assembled
+            void completeWellEqAssembly();
+
             void maybeDoGasLiftOptimize(DeferredLogger& deferred_logger);
 
             void gliftDebugShowALQ(DeferredLogger& deferred_logger);
@@ -642,7 +753,20 @@ namespace Opm {
 
              void computeWellTemperature();                       
         private:
-            GroupState& groupState() { return this->active_wgstate_.group_state; }
+            GroupState& groupState()
+            {
+                this->activeWGStateModified();
+                return this->active_wgstate_.group_state;
+            }
+
+            // Called whenever the active state may be modified, i.e. from the
+            // mutable accessors. The copies which are equal to the active
+            // state are then out of date.
+            void activeWGStateModified()
+            {
+                this->active_wgstate_committed_ = false;
+                this->active_wgstate_is_nupcol_ = false;
+            }
             BlackoilWellModel(Simulator& ebosSimulator, const PhaseUsage& pu);
             /*
               The various wellState members should be accessed and modified
@@ -654,6 +778,13 @@ namespace Opm {
             WGState last_valid_wgstate_;
             WGState nupcol_wgstate_;
 
+            // True while last_valid_wgstate_ (nupcol_wgstate_) is a copy of
+            // active_wgstate_ which has not been modified since. Committing,
+            // resetting or updating the nupcol state is then a no-op instead
+            // of a deep copy.
+            bool active_wgstate_committed_ = false;
+            bool active_wgstate_is_nupcol_ = false;
+
         };
 
 
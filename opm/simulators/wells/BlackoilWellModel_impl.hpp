@@ -20,16 +20,26 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <opm/simulators/utils/CostAccounting.hpp>
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
+#include <opm/models/parallel/threadedentityiterator.hh>
+
 #include <algorithm>
+#include <chrono>
+#include <exception>
+#include <unordered_map>
 #include <utility>
 
 #include <fmt/format.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
     template<typename TypeTag>
     BlackoilWellModel<TypeTag>::
@@ -54,9 +64,7 @@ namespace Opm {
         // Set up cartesian mapping.
         {
             const auto& grid = this->ebosSimulator_.vanguard().grid();
-            const auto& cartDims = UgGridHelpers::cartDims(grid);
-            setupCartesianToCompressed_(UgGridHelpers::globalCell(grid),
-                                        cartDims[0] * cartDims[1] * cartDims[2]);
+            setupCartesianToCompressed_(UgGridHelpers::globalCell(grid));
 
             auto& parallel_wells = ebosSimulator.vanguard().parallelWells();
             this->parallel_well_info_.assign(parallel_wells.begin(),
@@ -130,8 +138,7 @@ namespace Opm {
             for ( size_t c=0; c < connectionSet.size(); c++ )
             {
                 const auto& connection = connectionSet.get(c);
-                int compressed_idx = cartesian_to_compressed_
-                    .at(connection.global_index());
+                int compressed_idx = compressedIndexForInterior(connection.global_index());
 
                 if ( compressed_idx >= 0 ) { // Ignore connections in inactive/remote cells.
                     wellCells.push_back(compressed_idx);
@@ -265,13 +272,18 @@ namespace Opm {
 
         const Grid& grid = ebosSimulator_.vanguard().grid();
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
+        // The perforation data of the wells with unchanged connections is
+        // kept from the previous report step.
+        const auto previous_wells = std::move(wells_ecl_);
+        auto previous_perf_data = std::move(well_perf_data_);
+
         // Make wells_ecl_ contain only this partition's wells.
         wells_ecl_ = getLocalWells(timeStepIdx);
         local_parallel_well_info_ = createLocalParallelWellInfo(wells_ecl_);
 
         // The well state initialize bhp with the cell pressure in the top cell.
         // We must therefore provide it with updated cell pressures
-        this->initializeWellPerfData();
+        this->initializeWellPerfData(previous_wells, previous_perf_data);
         this->initializeWellState(timeStepIdx, summaryState);
 
         // Wells are active if they are active wells on at least
@@ -344,6 +356,13 @@ namespace Opm {
             for (auto& well : well_container_) {
                 well->updatePerforatedCell(is_cell_perforated_);
             }
+            perforated_cells_.clear();
+            for (std::size_t cellIdx = 0; cellIdx < is_cell_perforated_.size(); ++cellIdx) {
+                if (is_cell_perforated_[cellIdx]) {
+                    perforated_cells_.push_back(cellIdx);
+                }
+            }
+            updatePerforationIntensiveQuantities();
 
             // calculate the efficiency factors for each well
             calculateEfficiencyFactors(reportStepIdx);
@@ -472,6 +491,13 @@ namespace Opm {
                                             const double simulationTime,
                                             DeferredLogger& deferred_logger)
     {
+        // The wells that become due between two evaluations are still
+        // due at the next one, since only updateWells() marks them as tested.
+        const int interval = std::max(param_.well_test_step_interval_, 1);
+        if (well_test_step_count_++ % interval != 0) {
+            return;
+        }
+
         const auto& wtest_config = schedule()[timeStepIdx].wtest_config();
         if (wtest_config.size() != 0) { // there is a WTEST request
             const auto wellsForTesting = wellTestState_
@@ -673,9 +699,41 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     initializeWellPerfData()
     {
+        std::vector<std::vector<PerforationData>> no_previous_perf_data;
+        this->initializeWellPerfData({}, no_previous_perf_data);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    initializeWellPerfData(const std::vector<Well>& previous_wells,
+                           std::vector<std::vector<PerforationData>>& previous_perf_data)
+    {
+        std::unordered_map<std::string, int> previous_index;
+        for (std::size_t w = 0; w < previous_wells.size() && w < previous_perf_data.size(); ++w) {
+            previous_index.emplace(previous_wells[w].name(), w);
+        }
+
         well_perf_data_.resize(wells_ecl_.size());
         int well_index = 0;
         for (const auto& well : wells_ecl_) {
+            // The ParallelWellInfo of a well persists between the report
+            // steps, it still describes the unchanged connections. The
+            // connections are the same on all the processes sharing the
+            // well, so they all skip the collective calls below.
+            const auto prev = previous_index.find(well.name());
+            if (prev != previous_index.end() &&
+                previous_wells[prev->second].getConnections() == well.getConnections())
+            {
+                well_perf_data_[well_index] = std::move(previous_perf_data[prev->second]);
+                ++well_index;
+                continue;
+            }
+
             int completion_index = 0;
             // INVALID_ECL_INDEX marks no above perf available
             int completion_index_above = ParallelWellInfo::INVALID_ECL_INDEX;
@@ -689,7 +747,7 @@ namespace Opm {
 
             for (const auto& completion : well.getConnections()) {
                 const int active_index =
-                    cartesian_to_compressed_[completion.global_index()];
+                    compressedIndexForInterior(completion.global_index());
                 if (completion.state() == Connection::State::OPEN) {
                     if (active_index >= 0) {
                         if (firstOpenCompletion)
@@ -738,25 +796,55 @@ namespace Opm {
     initializeWellState(const int           timeStepIdx,
                         const SummaryState& summaryState)
     {
-        std::vector<double> cellPressures(this->local_num_cells_, 0.0);
-        ElementContext elemCtx(ebosSimulator_);
-
-        const auto& gridView = ebosSimulator_.vanguard().gridView();
-        const auto& elemEndIt = gridView.template end</*codim=*/0>();
-        for (auto elemIt = gridView.template begin</*codim=*/0>();
-             elemIt != elemEndIt;
-             ++elemIt)
-        {
-            if (elemIt->partitionType() != Dune::InteriorEntity) {
-                continue;
+        // Only the pressures of the perforated cells are used by the well state,
+        // so only their intensive quantities are evaluated.
+        std::vector<int> perforated_cells;
+        for (const auto& perf_data : well_perf_data_) {
+            for (const auto& perf : perf_data) {
+                perforated_cells.push_back(perf.cell_index);
+            }
+        }
+        std::sort(perforated_cells.begin(), perforated_cells.end());
+        perforated_cells.erase(std::unique(perforated_cells.begin(), perforated_cells.end()),
+                               perforated_cells.end());
+
+        auto& problem = ebosSimulator_.problem();
+        const auto& model = ebosSimulator_.model();
+        if (!model.storeIntensiveQuantities()) {
+            problem.keepIntensiveQuantities(perforated_cells);
+        } else {
+            const bool all_cached = std::all_of(perforated_cells.begin(), perforated_cells.end(),
+                                                [&model](const int cellIdx)
+                                                { return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr; });
+            if (!all_cached) {
+                const auto& gridView = ebosSimulator_.gridView();
+                ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+                {
+                    ElementContext elemCtx(ebosSimulator_);
+                    auto elemIt = threadedElemIt.beginParallel();
+                    for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                        const int elemIdx = gridView.indexSet().index(*elemIt);
+                        if (model.cachedIntensiveQuantities(elemIdx, /*timeIdx=*/0) != nullptr ||
+                            !std::binary_search(perforated_cells.begin(), perforated_cells.end(), elemIdx)) {
+                            continue;
+                        }
+                        elemCtx.updatePrimaryStencil(*elemIt);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        model.updateCachedIntensiveQuantities(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                                              elemIdx, /*timeIdx=*/0);
+                    }
+                }
             }
+        }
 
-            elemCtx.updatePrimaryStencil(*elemIt);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            const auto& fs = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0).fluidState();
+        std::vector<double> cellPressures(this->local_num_cells_, 0.0);
+        for (const int cellIdx : perforated_cells) {
+            const auto& fs = problem.cachedIntensiveQuantities(cellIdx)->fluidState();
             // copy of get perfpressure in Standard well except for value
-            double& perf_pressure = cellPressures[elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0)];
+            double& perf_pressure = cellPressures[cellIdx];
             if (Indices::oilEnabled) {
                 perf_pressure = fs.pressure(FluidSystem::oilPhaseIdx).value();
             } else if (Indices::waterEnabled) {
@@ -1088,7 +1176,12 @@ namespace Opm {
                 this->wellState(), ebosSimulator_, deferred_logger,
                 prod_wells, glift_wells, state_map);
         }
-        gasLiftOptimizationStage2(deferred_logger, prod_wells, glift_wells, state_map);
+        // there is nothing to distribute between the wells unless some of them
+        // are optimized on any process, i.e., unless the deck uses gas lift
+        // optimization
+        const auto& comm = ebosSimulator_.vanguard().grid().comm();
+        if (comm.max(static_cast<int>(!glift_wells.empty())) > 0)
+            gasLiftOptimizationStage2(deferred_logger, prod_wells, glift_wells, state_map);
         if (this->glift_debug) gliftDebugShowALQ(deferred_logger);
         this->wellState().disableGliftOptimization();
     }
@@ -1133,16 +1226,132 @@ namespace Opm {
         }
     }
 
+    template<typename TypeTag>
+    template <class Func>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWell(DeferredLogger& deferred_logger, Func&& func)
+    {
+        // Distributed wells communicate, all the processes must handle
+        // them in the same order, so they are always done in sequence.
+        const bool distributed = std::any_of(local_parallel_well_info_.begin(),
+                                             local_parallel_well_info_.end(),
+                                             [](const ParallelWellInfo* pinfo)
+                                             { return pinfo->communication().size() > 1; });
+#ifdef _OPENMP
+        const int numWells = well_container_.size();
+        if (!distributed && numWells >= minWellsForThreading && omp_get_max_threads() > 1) {
+            // One logger per well, so the messages end up in the same
+            // order as with the sequential loop.
+            std::vector<DeferredLogger> well_loggers(numWells);
+            std::vector<std::exception_ptr> exceptions(numWells);
+#pragma omp parallel for schedule(dynamic)
+            for (int w = 0; w < numWells; ++w) {
+                try {
+                    func(*well_container_[w], well_loggers[w]);
+                } catch (...) {
+                    exceptions[w] = std::current_exception();
+                }
+            }
+            for (const auto& well_logger : well_loggers) {
+                deferred_logger.append(well_logger);
+            }
+            for (const auto& exc : exceptions) {
+                if (exc) {
+                    std::rethrow_exception(exc);
+                }
+            }
+            return;
+        }
+#else
+        static_cast<void>(distributed);
+#endif
+        for (auto& well : well_container_) {
+            func(*well, deferred_logger);
+        }
+    }
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     assembleWellEq(const double dt, DeferredLogger& deferred_logger)
     {
+        auto& well_state = this->wellState();
+        auto& group_state = this->groupState();
+        auto& costs = CostAccounting::instance();
+        std::vector<double> seconds(costs.enabled() ? wells_ecl_.size() : 0, 0.0);
+
+        // The operability checks and the inner iterations update the controls
+        // and surface rates of the wells, which the control equations of the
+        // other wells of a group read, so they are done one well at a time.
         for (auto& well : well_container_) {
-            well->assembleWellEq(ebosSimulator_, dt, this->wellState(), this->groupState(), deferred_logger);
+            const auto start = std::chrono::steady_clock::now();
+            well->prepareWellBeforeAssembling(ebosSimulator_, dt, well_state, group_state, deferred_logger);
+            if (costs.enabled()) {
+                seconds[well->indexOfWell()] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        // The assembly only writes the perforation rates of the well itself,
+        // so the wells can be assembled concurrently. Every well writes the
+        // time to its own entry, the costs are recorded after the loop.
+        this->forEachWell(deferred_logger,
+                          [this, dt, &well_state, &group_state, &seconds](auto& well, DeferredLogger& well_logger)
+                          {
+                              const auto start = std::chrono::steady_clock::now();
+                              well.assembleWellEqAtCurrentState(ebosSimulator_, dt, well_state, group_state, well_logger,
+                                                                /*postponeCommunication=*/true);
+                              if (!seconds.empty()) {
+                                  seconds[well.indexOfWell()] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                              }
+                          });
+        if (!costs.enabled()) {
+            return;
+        }
+        for (const auto& well : well_container_) {
+            costs.addWellAssembly(well->name(), seconds[well->indexOfWell()]);
         }
     }
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    completeWellEqAssembly()
+    {
+        if ( ! wellsActive() ) {
+            return;
+        }
+
+        // The sums of the distributed wells were started in assembleWellEq()
+        // and have been communicated while the reservoir was assembled.
+        Dune::Timer perfTimer;
+        perfTimer.start();
+        DeferredLogger local_deferredLogger;
+        auto exc_type = ExceptionType::NONE;
+        std::string exc_msg;
+        try {
+            const double dt = ebosSimulator_.timeStepSize();
+            for (auto& well : well_container_) {
+                well->completeAssembly(ebosSimulator_, dt, this->wellState(), this->groupState(),
+                                       local_deferredLogger);
+            }
+        } catch (const std::runtime_error& e) {
+            exc_type = ExceptionType::RUNTIME_ERROR;
+            exc_msg = e.what();
+        } catch (const std::invalid_argument& e) {
+            exc_type = ExceptionType::INVALID_ARGUMENT;
+            exc_msg = e.what();
+        } catch (const std::logic_error& e) {
+            exc_type = ExceptionType::LOGIC_ERROR;
+            exc_msg = e.what();
+        } catch (const std::exception& e) {
+            exc_type = ExceptionType::DEFAULT;
+            exc_msg = e.what();
+        }
+        logAndCheckForExceptionsAndThrow(local_deferredLogger, exc_type, "completeWellEqAssembly() failed: " + exc_msg, terminal_output_);
+        last_report_.assemble_time_well += perfTimer.stop();
+    }
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1174,7 +1383,7 @@ namespace Opm {
         }
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1249,8 +1458,13 @@ namespace Opm {
         std::string exc_msg;
         try {
             if (localWellsActive()) {
+                auto& costs = CostAccounting::instance();
                 for (auto& well : well_container_) {
+                    const auto start = std::chrono::steady_clock::now();
                     well->recoverWellSolutionAndUpdateWellState(x, this->wellState(), local_deferredLogger);
+                    if (costs.enabled()) {
+                        costs.addWellSolve(well->name(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                    }
                 }
             }
         } catch (const std::runtime_error& e) {
@@ -1371,12 +1585,15 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    calculateExplicitQuantities(DeferredLogger& deferred_logger) const
+    calculateExplicitQuantities(DeferredLogger& deferred_logger)
     {
         // TODO: checking isOperable() ?
-        for (auto& well : well_container_) {
-            well->calculateExplicitQuantities(ebosSimulator_, this->wellState(), deferred_logger);
-        }
+        // The wells only update their own explicit quantities from the
+        // well state, so they are done concurrently.
+        const auto& well_state = this->wellState();
+        this->forEachWell(deferred_logger, [this, &well_state](auto& well, DeferredLogger& well_logger) {
+            well.calculateExplicitQuantities(ebosSimulator_, well_state, well_logger);
+        });
     }
 
 
@@ -1446,7 +1663,51 @@ namespace Opm {
         if (!network.active()) {
             return;
         }
-        node_pressures_ = WellGroupHelpers::computeNetworkPressures(network, this->wellState(), this->groupState(), *(vfp_properties_->getProd()), schedule(), reportStepIdx);
+
+        // The rates of the wells at THP control follow the node pressures,
+        // which is accounted for with their inflow performance relationships
+        // q = b * (thp - p), summed per leaf node over all processes.
+        std::map<std::string, WellGroupHelpers::NetworkLeafIpr> leaf_iprs;
+        if (param_.network_max_newton_iterations_ > 0) {
+            const int np = numPhases();
+            for (const auto& well : well_container_) {
+                const int w = well->indexOfWell();
+                if (!well->isProducer() || !well->isOwnerOfWell() || well->iprB().empty() ||
+                    this->wellState().currentProductionControl(w) != Well::ProducerCMode::THP) {
+                    continue;
+                }
+                auto& ipr = leaf_iprs[well->wellEcl().groupName()];
+                ipr.offset.resize(np, 0.0);
+                ipr.slope.resize(np, 0.0);
+                const double efficiency = well->wellEcl().getEfficiencyFactor();
+                const double thp = this->wellState().thp(w);
+                for (int p = 0; p < np; ++p) {
+                    ipr.slope[p] += efficiency * well->iprB()[p];
+                    ipr.offset[p] += efficiency * well->iprB()[p] * thp;
+                }
+            }
+            const auto nodes = WellGroupHelpers::networkNodesRootToChild(network);
+            std::vector<double> buffer(2 * np * nodes.size(), 0.0);
+            for (std::size_t n = 0; n < nodes.size(); ++n) {
+                const auto it = leaf_iprs.find(nodes[n]);
+                if (it != leaf_iprs.end()) {
+                    std::copy(it->second.offset.begin(), it->second.offset.end(), buffer.begin() + 2 * np * n);
+                    std::copy(it->second.slope.begin(), it->second.slope.end(), buffer.begin() + 2 * np * n + np);
+                }
+            }
+            ebosSimulator_.vanguard().grid().comm().sum(buffer.data(), buffer.size());
+            leaf_iprs.clear();
+            for (std::size_t n = 0; n < nodes.size(); ++n) {
+                const auto begin = buffer.begin() + 2 * np * n;
+                if (std::any_of(begin, begin + 2 * np, [](const double v) { return v != 0.0; })) {
+                    auto& ipr = leaf_iprs[nodes[n]];
+                    ipr.offset.assign(begin, begin + np);
+                    ipr.slope.assign(begin + np, begin + 2 * np);
+                }
+            }
+        }
+        node_pressures_ = WellGroupHelpers::computeNetworkPressures(network, this->wellState(), this->groupState(), *(vfp_properties_->getProd()), schedule(), reportStepIdx,
+                                                                    leaf_iprs, param_.network_max_newton_iterations_);
 
         // Set the thp limits of wells
         for (auto& well : well_container_) {
@@ -1514,8 +1775,7 @@ namespace Opm {
             }
         }
 
-        well_state.communicateGroupRates(comm);
-        this->groupState().communicate_rates(comm);
+        well_state.communicateGroupRates(comm, this->groupState());
         // compute wsolvent fraction for REIN wells
         updateWsolvent(fieldGroup, schedule(), reportStepIdx,  well_state_nupcol);
 
@@ -1556,13 +1816,22 @@ namespace Opm {
     {
         const int np = numPhases();
 
-        auto well_state_copy = this->wellState();
+        // The potentials of the wells are computed independently, possibly
+        // by several threads. All wells start from the same snapshot of the
+        // well state and the live well state is left untouched until every
+        // well is done, the potentials and the exception of each well are
+        // kept in its own entry of the buffers below.
+        const auto well_state_copy = this->wellState();
+        std::vector<std::vector<double>> potentials_of_well(this->wells_ecl_.size());
+        std::vector<ExceptionType::ExcEnum> exc_types(this->wells_ecl_.size(), ExceptionType::NONE);
+        std::vector<std::string> exc_msgs(this->wells_ecl_.size());
 
         const SummaryConfig& summaryConfig = ebosSimulator_.vanguard().summaryConfig();
         const bool write_restart_file = ebosSimulator_.vanguard().schedule().write_rst_file(reportStepIdx);
-        auto exc_type = ExceptionType::NONE;
-        std::string exc_msg;
-        for (const auto& well : well_container_) {
+        this->forEachWell(deferred_logger, [&](auto& well_ref, DeferredLogger& well_logger) {
+            auto* well = &well_ref;
+            auto& exc_type = exc_types[well->indexOfWell()];
+            auto& exc_msg = exc_msgs[well->indexOfWell()];
             const bool needed_for_summary =
                     ((summaryConfig.hasSummaryKey( "WWPI:" + well->name()) ||
                       summaryConfig.hasSummaryKey( "WOPI:" + well->name()) ||
@@ -1600,9 +1869,9 @@ namespace Opm {
             const bool compute_potential = needPotentialsForOutput || needPotentialsForGuideRates;
             if (compute_potential)
             {
-                std::vector<double> potentials;
+                auto& potentials = potentials_of_well[well->indexOfWell()];
                 try {
-                    well->computeWellPotentials(ebosSimulator_, well_state_copy, potentials, deferred_logger);
+                    well->computeWellPotentials(ebosSimulator_, well_state_copy, potentials, well_logger);
                  } catch (const std::runtime_error& e) {
                     exc_type = ExceptionType::RUNTIME_ERROR;
                     exc_msg = e.what();
@@ -1616,12 +1885,27 @@ namespace Opm {
                     exc_type = ExceptionType::DEFAULT;
                     exc_msg = e.what();
                 }
-                // Store it in the well state
-                // potentials is resized and set to zero in the beginning of well->ComputeWellPotentials
-                // and updated only if sucessfull. i.e. the potentials are zero for exceptions
-                for (int p = 0; p < np; ++p) {
-                    this->wellState().wellPotentials()[well->indexOfWell() * np + p] = std::abs(potentials[p]);
-                }
+            }
+        });
+
+        // Store them in the well state
+        // potentials is resized and set to zero in the beginning of well->ComputeWellPotentials
+        // and updated only if sucessfull. i.e. the potentials are zero for exceptions
+        auto& well_potentials = this->wellState().wellPotentials();
+        for (std::size_t w = 0; w < potentials_of_well.size(); ++w) {
+            const auto& potentials = potentials_of_well[w];
+            for (std::size_t p = 0; p < potentials.size(); ++p) {
+                well_potentials[w * np + p] = std::abs(potentials[p]);
+            }
+        }
+
+        // Report the exception of the last failing well.
+        auto exc_type = ExceptionType::NONE;
+        std::string exc_msg;
+        for (std::size_t w = 0; w < exc_types.size(); ++w) {
+            if (exc_types[w] != ExceptionType::NONE) {
+                exc_type = exc_types[w];
+                exc_msg = exc_msgs[w];
             }
         }
         logAndCheckForExceptionsAndThrow(deferred_logger, exc_type,
@@ -1640,9 +1924,13 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     calculateProductivityIndexValues(DeferredLogger& deferred_logger)
     {
-        for (const auto& wellPtr : this->well_container_) {
-            this->calculateProductivityIndexValues(wellPtr.get(), deferred_logger);
-        }
+        auto& well_state = this->wellState();
+        this->forEachWell(deferred_logger, [this, &well_state](const auto& well, DeferredLogger& well_logger) {
+            well.updateProductivityIndex(this->ebosSimulator_,
+                                         this->prod_index_calc_[well.indexOfWell()],
+                                         well_state,
+                                         well_logger);
+        });
     }
 
 
@@ -1691,6 +1979,24 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    updateWellsOperability(DeferredLogger& deferred_logger)
+    {
+        // The IPR and the operability of a well only depend on the reservoir
+        // and its own entries of the well state, so the wells are checked
+        // concurrently.
+        const auto& well_state = this->wellState();
+        this->forEachWell(deferred_logger, [this, &well_state](auto& well, DeferredLogger& well_logger) {
+            well.checkWellOperability(ebosSimulator_, well_state, well_logger);
+        });
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1699,9 +2005,8 @@ namespace Opm {
         auto exc_type = ExceptionType::NONE;
         std::string exc_msg;
         try {
+            updateWellsOperability(deferred_logger);
             for (const auto& well : well_container_) {
-                well->checkWellOperability(ebosSimulator_, this->wellState(), deferred_logger);
-
                 if (!well->isOperable() ) continue;
 
                 auto& events = this->wellState().events(well->indexOfWell());
@@ -1761,9 +2066,10 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    setupCartesianToCompressed_(const int* global_cell, int number_of_cartesian_cells)
+    setupCartesianToCompressed_(const int* global_cell)
     {
-        cartesian_to_compressed_.resize(number_of_cartesian_cells, -1);
+        cartesian_to_compressed_.clear();
+        cartesian_to_compressed_.reserve(local_num_cells_);
         if (global_cell) {
             auto elemIt = ebosSimulator_.gridView().template begin</*codim=*/ 0>();
             for (unsigned i = 0; i < local_num_cells_; ++i) {
@@ -1771,19 +2077,30 @@ namespace Opm {
                 if (elemIt->partitionType() == Dune::InteriorEntity)
                 {
                     assert(ebosSimulator_.gridView().indexSet().index(*elemIt) == static_cast<int>(i));
-                    cartesian_to_compressed_[global_cell[i]] = i;
+                    cartesian_to_compressed_.emplace(global_cell[i], i);
                 }
                 ++elemIt;
             }
         }
         else {
             for (unsigned i = 0; i < local_num_cells_; ++i) {
-                cartesian_to_compressed_[i] = i;
+                cartesian_to_compressed_.emplace(i, i);
             }
         }
 
     }
 
+    template<typename TypeTag>
+    int
+    BlackoilWellModel<TypeTag>::
+    compressedIndexForInterior(int cartesian_cell_idx) const
+    {
+        auto index_pair = cartesian_to_compressed_.find(cartesian_cell_idx);
+        if (index_pair == cartesian_to_compressed_.end())
+            return -1;
+        return index_pair->second;
+    }
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1920,6 +2237,24 @@ namespace Opm {
     void
     BlackoilWellModel<TypeTag>::
     updatePerforationIntensiveQuantities() {
+        // If the model does not cache the intensive quantities, the problem keeps
+        // those of the perforated cells.
+        const auto& model = ebosSimulator_.model();
+        if (!model.storeIntensiveQuantities()) {
+            ebosSimulator_.problem().keepIntensiveQuantities(perforated_cells_);
+            return;
+        }
+
+        // Normally the linearizer has already cached the intensive quantities
+        // of all the cells for the current solution, then nothing needs to be
+        // evaluated again.
+        const bool all_cached = std::all_of(perforated_cells_.begin(), perforated_cells_.end(),
+                                            [&model](const int cellIdx)
+                                            { return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr; });
+        if (all_cached) {
+            return;
+        }
+
         ElementContext elemCtx(ebosSimulator_);
         const auto& gridView = ebosSimulator_.gridView();
         const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
@@ -1927,14 +2262,15 @@ namespace Opm {
              elemIt != elemEndIt;
              ++elemIt)
         {
-
-            elemCtx.updatePrimaryStencil(*elemIt);
-            int elemIdx = elemCtx.globalSpaceIndex(0, 0);
-
-            if (!is_cell_perforated_[elemIdx]) {
+            const int elemIdx = gridView.indexSet().index(*elemIt);
+            if (!is_cell_perforated_[elemIdx] ||
+                model.cachedIntensiveQuantities(elemIdx, /*timeIdx=*/0) != nullptr) {
                 continue;
             }
+            elemCtx.updatePrimaryStencil(*elemIt);
             elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            model.updateCachedIntensiveQuantities(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                                  elemIdx, /*timeIdx=*/0);
         }
     }
 
@@ -1995,9 +2331,9 @@ namespace Opm {
                 well_state.wellRates(well_index)[ i ] = rst_well.rates.get( phs[ i ] );
             }
 
-            auto& perf_pressure = well_state.perfPress(well_index);
-            auto& perf_rates = well_state.perfRates(well_index);
-            auto * perf_phase_rates = &well_state.mutable_perfPhaseRates()[wm.second[1]*np];
+            auto * perf_pressure = well_state.perfPress(well_index);
+            auto * perf_rates = well_state.perfRates(well_index);
+            auto * perf_phase_rates = well_state.perfPhaseRates(well_index);
             const auto& perf_data = this->well_perf_data_[well_index];
 
             for (std::size_t perf_index = 0; perf_index < perf_data.size(); perf_index++) {
@@ -2756,11 +3092,14 @@ namespace Opm {
     void
     BlackoilWellModel<TypeTag>::
     updateEclWells(const int timeStepIdx, const std::unordered_set<std::string>& wells) {
+        if (wells.empty()) {
+            return;
+        }
+        // One pass over the local wells, rather than a search per affected well.
         const auto& schedule = this->ebosSimulator_.vanguard().schedule();
-        for (const auto& wname : wells) {
-            auto well_iter = std::find_if( this->wells_ecl_.begin(), this->wells_ecl_.end(), [wname] (const auto& well) -> bool { return well.name() == wname;});
-            if (well_iter != this->wells_ecl_.end()) {
-                auto well_index = std::distance( this->wells_ecl_.begin(), well_iter );
+        for (std::size_t well_index = 0; well_index < this->wells_ecl_.size(); ++well_index) {
+            const auto& wname = this->wells_ecl_[well_index].name();
+            if (wells.count(wname) > 0) {
                 this->wells_ecl_[well_index] = schedule.getWell(wname, timeStepIdx);
 
                 const auto& well = this->wells_ecl_[well_index];
@@ -2904,7 +3243,9 @@ namespace Opm {
 
         // Minimal well setup to compute PI/II values
         {
-            auto saved_previous_wgstate = this->prevWGState();
+            // Set the last valid state aside, it is restored below.
+            auto saved_previous_wgstate = std::move(this->last_valid_wgstate_);
+            this->active_wgstate_committed_ = false;
             this->commitWGState();
 
             this->well_container_ = this->createWellContainer(timeStepIdx);
@@ -3363,21 +3704,16 @@ namespace Opm {
             if (well.isInjector())
                 continue;
 
-            int connpos = 0;
-            for (int i = 0; i < wellID; ++i) {
-                connpos += well_perf_data_[i].size();
-            }
-            connpos *= np;
             double weighted_temperature = 0.0;
             double total_weight = 0.0;
 
             auto& well_info = *local_parallel_well_info_[wellID];
-            const int num_perf_this_well = well_info.communication().sum(well_perf_data_[wellID].size());
-            auto * perf_phase_rate = &this->wellState().perfPhaseRates()[connpos];
+            const int num_perf_this_well = this->wellState().numPerf(wellID);
+            const auto * perf_phase_rate = this->wellState().perfPhaseRates(wellID);
 
             for (int perf = 0; perf < num_perf_this_well; ++perf) {
                 const int cell_idx = well_perf_data_[wellID][perf].cell_index;
-                const auto& intQuants = *(ebosSimulator_.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+                const auto& intQuants = *(ebosSimulator_.problem().cachedIntensiveQuantities(cell_idx));
                 const auto& fs = intQuants.fluidState();
 
                 double cellTemperatures = fs.temperature(/*phaseIdx*/0).value();
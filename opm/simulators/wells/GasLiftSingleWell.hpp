@@ -32,6 +32,7 @@ namespace Opm {
 #include <opm/simulators/wells/StandardWell.hpp>
 #include <opm/simulators/wells/GasLiftSingleWellGeneric.hpp>
 
+#include <map>
 #include <optional>
 #include <vector>
 #include <utility>
@@ -64,6 +65,12 @@ namespace Opm
 
         const Simulator &ebos_simulator_;
         const StdWell &std_well_;
+
+        // The reservoir and the well state do not change during the
+        // optimization, so the responses to an ALQ value and a bhp value
+        // are computed once and looked up when the stages try them again.
+        mutable std::map<double, std::optional<double>> bhp_at_thp_limit_;
+        mutable std::map<double, std::vector<double>> rates_at_bhp_;
     };
 
 } // namespace Opm
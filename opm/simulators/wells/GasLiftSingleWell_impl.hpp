@@ -99,11 +99,16 @@ GasLiftSingleWell<TypeTag>::
 computeWellRates_(
     double bhp, std::vector<double> &potentials, bool debug_output) const
 {
+    if (auto it = this->rates_at_bhp_.find(bhp); it != this->rates_at_bhp_.end()) {
+        potentials = it->second;
+        return;
+    }
     // NOTE: If we do not clear the potentials here, it will accumulate
     //   the new potentials to the old values..
     std::fill(potentials.begin(), potentials.end(), 0.0);
     this->std_well_.computeWellRatesWithBhp(
         this->ebos_simulator_, bhp, potentials, this->deferred_logger_);
+    this->rates_at_bhp_.emplace(bhp, potentials);
     if (debug_output) {
         const std::string msg = fmt::format("computed well potentials given bhp {}, "
             "oil: {}, gas: {}, water: {}", bhp,
@@ -118,6 +123,9 @@ std::optional<double>
 GasLiftSingleWell<TypeTag>::
 computeBhpAtThpLimit_(double alq) const
 {
+    if (auto it = this->bhp_at_thp_limit_.find(alq); it != this->bhp_at_thp_limit_.end()) {
+        return it->second;
+    }
     auto bhp_at_thp_limit = this->std_well_.computeBhpAtThpLimitProdWithAlq(
         this->ebos_simulator_,
         this->summary_state_,
@@ -139,6 +147,7 @@ computeBhpAtThpLimit_(double alq) const
             "Failed in getting converged bhp potential from thp limit (ALQ = {})", alq);
         displayDebugMessage_(msg);
     }
+    this->bhp_at_thp_limit_.emplace(alq, bhp_at_thp_limit);
     return bhp_at_thp_limit;
 }
 
@@ -29,6 +29,7 @@
 #include <opm/simulators/wells/WellInterfaceGeneric.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <optional>
 #include <string>
@@ -453,57 +454,86 @@ getGroupGliftWellsRecursive_(const Group &group,
 
 void
 GasLiftStage2::
-mpiSyncGlobalGradVector_(std::vector<GradPair> &grads_global) const
+mpiSyncGlobalGradVectors_(std::vector<GradPair> &dec_grads_global,
+                          std::vector<GradPair> &inc_grads_global) const
 {
     if (this->comm_.size() == 1)
         return;
 
-    std::vector<GradPair> grads_local;
-    for (auto itr = grads_global.begin(); itr != grads_global.end(); itr++) {
-        if (well_state_map_.count(itr->first) > 0) {
-            grads_local.push_back(*itr);
+    auto localGrads = [this](const std::vector<GradPair> &grads_global) {
+        std::vector<GradPair> grads_local;
+        for (auto itr = grads_global.begin(); itr != grads_global.end(); itr++) {
+            if (well_state_map_.count(itr->first) > 0) {
+                grads_local.push_back(*itr);
+            }
         }
-    }
-    mpiSyncLocalToGlobalGradVector_(grads_local, grads_global);
+        return grads_local;
+    };
+    mpiSyncLocalToGlobalGradVectors_(localGrads(dec_grads_global),
+                                     localGrads(inc_grads_global),
+                                     dec_grads_global, inc_grads_global);
 }
 
+// The decremental and incremental gradients are exchanged together, with one
+// allgather of the sizes and one allgatherv of the gradients, since this is
+// done in every iteration of the ALQ redistribution.
 void
 GasLiftStage2::
-mpiSyncLocalToGlobalGradVector_(
-    const std::vector<GradPair> &grads_local, std::vector<GradPair> &grads_global) const
+mpiSyncLocalToGlobalGradVectors_(
+    const std::vector<GradPair> &dec_grads_local,
+    const std::vector<GradPair> &inc_grads_local,
+    std::vector<GradPair> &dec_grads_global,
+    std::vector<GradPair> &inc_grads_global) const
 {
     assert(this->comm_.size() > 1);  // The parent should check if comm. size is > 1
     using Pair = std::pair<int, double>;
     std::vector<Pair> grads_local_tmp;
-    grads_local_tmp.reserve(grads_local.size());
-    for (size_t i = 0; i < grads_local.size(); ++i) {
-        if(!this->well_state_.wellIsOwned(grads_local[i].first))
-            continue;
-        grads_local_tmp.push_back(
-           std::make_pair(
-              this->well_state_.wellNameToGlobalIdx(grads_local[i].first),
-              grads_local[i].second));
+    grads_local_tmp.reserve(dec_grads_local.size() + inc_grads_local.size());
+    auto addOwned = [this, &grads_local_tmp](const std::vector<GradPair> &grads_local) {
+        int num_owned = 0;
+        for (size_t i = 0; i < grads_local.size(); ++i) {
+            if(!this->well_state_.wellIsOwned(grads_local[i].first))
+                continue;
+            grads_local_tmp.push_back(
+               std::make_pair(
+                  this->well_state_.wellNameToGlobalIdx(grads_local[i].first),
+                  grads_local[i].second));
+            ++num_owned;
+        }
+        return num_owned;
+    };
+    // The block of every rank holds its decremental gradients followed by
+    // its incremental gradients.
+    const int my_counts[2] = {addOwned(dec_grads_local), addOwned(inc_grads_local)};
+
+    const int comm_size = this->comm_.size();
+    std::vector<int> counts_(2 * comm_size);
+    this->comm_.allgather(my_counts, 2, counts_.data());
+    std::vector<int> sizes_(comm_size);
+    for (int rank = 0; rank < comm_size; ++rank) {
+        sizes_[rank] = counts_[2 * rank] + counts_[2 * rank + 1];
     }
-
-    std::vector<int> sizes_(this->comm_.size());
-    std::vector<int> displ_(this->comm_.size() + 1, 0);
-    int mySize = grads_local_tmp.size();
-    this->comm_.allgather(&mySize, 1, sizes_.data());
+    std::vector<int> displ_(comm_size + 1, 0);
     std::partial_sum(sizes_.begin(), sizes_.end(), displ_.begin()+1);
     std::vector<Pair> grads_global_tmp(displ_.back());
 
     this->comm_.allgatherv(grads_local_tmp.data(), grads_local_tmp.size(),
         grads_global_tmp.data(), sizes_.data(), displ_.data());
 
-    // NOTE: This leaves the capacity of 'grads_global' unchanged, so
+    // NOTE: This leaves the capacity of the global vectors unchanged, so
     //   memory is not reallocated here
-    grads_global.clear();
-
-    for (size_t i = 0; i < grads_global_tmp.size(); ++i) {
-        grads_global.emplace_back(
-            std::make_pair(
-                well_state_.globalIdxToWellName(grads_global_tmp[i].first),
-                grads_global_tmp[i].second));
+    dec_grads_global.clear();
+    inc_grads_global.clear();
+
+    for (int rank = 0; rank < comm_size; ++rank) {
+        const int end_dec = displ_[rank] + counts_[2 * rank];
+        for (int i = displ_[rank]; i < displ_[rank + 1]; ++i) {
+            auto &grads_global = i < end_dec ? dec_grads_global : inc_grads_global;
+            grads_global.emplace_back(
+                std::make_pair(
+                    well_state_.globalIdxToWellName(grads_global_tmp[i].first),
+                    grads_global_tmp[i].second));
+        }
     }
 }
 
@@ -657,8 +687,8 @@ redistributeALQ_(std::vector<GasLiftSingleWell *> &wells,  const Group &group,
         dec_grads_local.reserve(wells.size());
         state.calculateEcoGradients(wells, inc_grads_local, dec_grads_local);
         // the gradients needs to be communicated to all ranks
-        mpiSyncLocalToGlobalGradVector_(dec_grads_local, dec_grads);
-        mpiSyncLocalToGlobalGradVector_(inc_grads_local, inc_grads);
+        mpiSyncLocalToGlobalGradVectors_(dec_grads_local, inc_grads_local,
+                                         dec_grads, inc_grads);
     }
 
     if (!state.checkAtLeastTwoWells(wells)) {
@@ -729,10 +759,7 @@ removeSurplusALQ_(const Group &group,
             min_eco_grad, controls.oil_target, controls.gas_target, max_glift };
 
     while (!stop_iteration) {
-        if (dec_grads.size() >= 2) {
-            sortGradients_(dec_grads);
-        }
-        auto dec_grad_itr = dec_grads.begin();
+        auto dec_grad_itr = minGradient_(dec_grads);
         const auto well_name = dec_grad_itr->first;
         auto eco_grad = dec_grad_itr->second;
         bool remove = false;
@@ -740,11 +767,10 @@ removeSurplusALQ_(const Group &group,
             remove = true;
         }
         else {
-            // NOTE: It is enough to check the economic gradient of the first well
-            //   in dec_grads since they are sorted according to the eco. grad.
-            //   If the first well's eco. grad. is greater than the minimum
-            //   eco. grad. then all the other wells' eco. grad. will also be
-            //   greater.
+            // NOTE: It is enough to check the economic gradient of the well
+            //   with the smallest eco. grad. in dec_grads. If its eco. grad.
+            //   is greater than the minimum eco. grad. then all the other
+            //   wells' eco. grad. will also be greater.
             if (state.checkEcoGradient(well_name, eco_grad)) remove = true;
         }
         if (remove) {
@@ -754,8 +780,7 @@ removeSurplusALQ_(const Group &group,
                         dec_grad_itr, /*increase=*/false, dec_grads, inc_grads);
 
             // The dec_grads and inc_grads needs to be syncronized across ranks
-            mpiSyncGlobalGradVector_(dec_grads);
-            mpiSyncGlobalGradVector_(inc_grads);
+            mpiSyncGlobalGradVectors_(dec_grads, inc_grads);
             // NOTE: recalculateGradientAndUpdateData_() will remove the current gradient
             //   from dec_grads if it cannot calculate a new decremental gradient.
             //   This will invalidate dec_grad_itr and well_name
@@ -808,14 +833,23 @@ saveIncGrad_(const std::string &name, GradInfo &grad)
     saveGrad_(this->inc_grads_, name, grad);
 }
 
-void
+// Only the extreme gradients are needed in every iteration, and the
+//   gradient vectors change in at most two places between iterations, so
+//   a linear search replaces sorting the vectors.
+GasLiftStage2::GradPairItr
 GasLiftStage2::
-sortGradients_(std::vector<GradPair> &grads)
+minGradient_(std::vector<GradPair> &grads)
 {
-    auto cmp = [](GradPair a, GradPair b) {
-         return a.second <  b.second;
-    };
-    std::sort(grads.begin(), grads.end(), cmp);
+    return std::min_element(grads.begin(), grads.end(),
+        [](const GradPair &a, const GradPair &b) { return a.second < b.second; });
+}
+
+GasLiftStage2::GradPairItr
+GasLiftStage2::
+maxGradient_(std::vector<GradPair> &grads)
+{
+    return std::max_element(grads.begin(), grads.end(),
+        [](const GradPair &a, const GradPair &b) { return a.second < b.second; });
 }
 
 std::optional<GasLiftStage2::GradInfo>
@@ -842,8 +876,8 @@ updateGradVector_(const std::string &name, std::vector<GradPair> &grads, double
         }
     }
     grads.push_back({name, grad});
-    // NOTE: the gradient vector is no longer sorted, but sorting will be done
-    //   later in getEcoGradients()
+    // NOTE: the order of the gradient vector does not matter, the extreme
+    //   gradients are searched for in getEcoGradients()
 }
 
 /***********************************************
@@ -907,20 +941,18 @@ GasLiftStage2::OptimizeState::
 getEcoGradients(std::vector<GradPair> &inc_grads, std::vector<GradPair> &dec_grads)
 {
     if (inc_grads.size() > 0 && dec_grads.size() > 0) {
-        this->parent.sortGradients_(inc_grads);
-        this->parent.sortGradients_(dec_grads);
-        // The largest incremental gradient is the last element
-        auto inc_grad = std::prev(inc_grads.end());
+        auto inc_grad = GasLiftStage2::maxGradient_(inc_grads);
         std::optional<GradPairItr> inc_grad_opt;
         std::optional<GradPairItr> dec_grad_opt;
-        // The smallest decremental gradient is at the beginning
+        // The smallest decremental gradient
         for (auto itr = dec_grads.begin(); itr != dec_grads.end(); itr++) {
             if (itr->first == inc_grad->first) {
                 // Don't consider decremental gradients with the same well name
                 continue;
             }
-            dec_grad_opt = itr;
-            break;
+            if (!dec_grad_opt || itr->second < (*dec_grad_opt)->second) {
+                dec_grad_opt = itr;
+            }
         }
         if (dec_grad_opt) {
             inc_grad_opt = inc_grad;
@@ -955,8 +987,7 @@ recalculateGradients(
         min_dec_grad_itr, /*increase=*/false, dec_grads, inc_grads);
 
     // The dec_grads and inc_grads needs to be syncronized across ranks
-    this->parent.mpiSyncGlobalGradVector_(dec_grads);
-    this->parent.mpiSyncGlobalGradVector_(inc_grads);
+    this->parent.mpiSyncGlobalGradVectors_(dec_grads, inc_grads);
 }
 
 // Take one ALQ increment from well1, and give it to well2
@@ -116,15 +116,20 @@ class WellState;
         void saveGrad_(GradMap &map, const std::string &name, GradInfo &grad);
         void saveDecGrad_(const std::string &name, GradInfo &grad);
         void saveIncGrad_(const std::string &name, GradInfo &grad);
-        void sortGradients_(std::vector<GradPair> &grads);
+        static GradPairItr minGradient_(std::vector<GradPair> &grads);
+        static GradPairItr maxGradient_(std::vector<GradPair> &grads);
         std::optional<GradInfo> updateGrad_(
             const std::string &name, GradInfo &grad, bool increase);
         void updateGradVector_(
             const std::string &name, std::vector<GradPair> &grads, double grad);
-        void mpiSyncGlobalGradVector_(std::vector<GradPair> &grads_global) const;
-        void mpiSyncLocalToGlobalGradVector_(
-            const std::vector<GradPair> &grads_local,
-            std::vector<GradPair> &grads_global) const;
+        void mpiSyncGlobalGradVectors_(
+            std::vector<GradPair> &dec_grads_global,
+            std::vector<GradPair> &inc_grads_global) const;
+        void mpiSyncLocalToGlobalGradVectors_(
+            const std::vector<GradPair> &dec_grads_local,
+            const std::vector<GradPair> &inc_grads_local,
+            std::vector<GradPair> &dec_grads_global,
+            std::vector<GradPair> &inc_grads_global) const;
 
 
         DeferredLogger &deferred_logger_;
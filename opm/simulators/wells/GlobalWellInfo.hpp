@@ -20,6 +20,7 @@
 #ifndef OPM_GLOBAL_WELL_INFO_HEADER_INCLUDED
 #define OPM_GLOBAL_WELL_INFO_HEADER_INCLUDED
 
+#include <algorithm>
 #include <cstddef>
 #include <map>
 #include <string>
@@ -59,9 +60,13 @@ public:
     */
     template <typename Comm>
     void communicate(const Comm& comm) {
+        // Both vectors are summed with a single sum() call.
         auto size = this->m_in_injecting_group.size();
-        comm.sum( this->m_in_injecting_group.data(), size);
-        comm.sum( this->m_in_producing_group.data(), size);
+        std::vector<int> data(this->m_in_injecting_group);
+        data.insert(data.end(), this->m_in_producing_group.begin(), this->m_in_producing_group.end());
+        comm.sum( data.data(), data.size());
+        std::copy(data.begin(), data.begin() + size, this->m_in_injecting_group.begin());
+        std::copy(data.begin() + size, data.end(), this->m_in_producing_group.begin());
     };
 
 
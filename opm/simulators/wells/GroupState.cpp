@@ -22,6 +22,7 @@
 #include <opm/json/JsonObject.hpp>
 
 #include <opm/simulators/wells/GroupState.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
 
 namespace Opm {
 
@@ -303,5 +304,32 @@ std::string GroupState::dump() const
     return root.to_string();
 }
 
+void GroupState::writeCheckpoint(std::ostream& os) const {
+    BinaryCheckpoint::write(os, this->num_phases);
+    BinaryCheckpoint::write(os, this->m_production_rates);
+    BinaryCheckpoint::write(os, this->production_controls);
+    BinaryCheckpoint::write(os, this->prod_red_rates);
+    BinaryCheckpoint::write(os, this->inj_red_rates);
+    BinaryCheckpoint::write(os, this->inj_resv_rates);
+    BinaryCheckpoint::write(os, this->inj_potentials);
+    BinaryCheckpoint::write(os, this->inj_rein_rates);
+    BinaryCheckpoint::write(os, this->inj_vrep_rate);
+    BinaryCheckpoint::write(os, this->m_grat_sales_target);
+    BinaryCheckpoint::write(os, this->injection_controls);
+}
+
+void GroupState::readCheckpoint(std::istream& is) {
+    BinaryCheckpoint::readExpected(is, this->num_phases, "number of phases");
+    BinaryCheckpoint::read(is, this->m_production_rates);
+    BinaryCheckpoint::read(is, this->production_controls);
+    BinaryCheckpoint::read(is, this->prod_red_rates);
+    BinaryCheckpoint::read(is, this->inj_red_rates);
+    BinaryCheckpoint::read(is, this->inj_resv_rates);
+    BinaryCheckpoint::read(is, this->inj_potentials);
+    BinaryCheckpoint::read(is, this->inj_rein_rates);
+    BinaryCheckpoint::read(is, this->inj_vrep_rate);
+    BinaryCheckpoint::read(is, this->m_grat_sales_target);
+    BinaryCheckpoint::read(is, this->injection_controls);
+}
 
 }
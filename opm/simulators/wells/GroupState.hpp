@@ -20,7 +20,11 @@
 #ifndef OPM_GROUPSTATE_HEADER_INCLUDED
 #define OPM_GROUPSTATE_HEADER_INCLUDED
 
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
 #include <map>
+#include <stdexcept>
 #include <vector>
 
 #include <opm/core/props/BlackoilPhases.hpp>
@@ -76,82 +80,99 @@ public:
     std::size_t distribute(const double * data);
 
 
-    template<class Comm>
-    void communicate_rates(const Comm& comm)
+    // The group rates which are summed over all processes, packed into one
+    // array. This allows the callers to add them to a larger buffer and
+    // communicate everything with a single sum() call.
+    std::size_t rates_pack_size() const
     {
-        // Note that injection_group_vrep_rates is handled separate from
-        // the forAllGroupData() function, since it contains single doubles,
-        // not vectors.
-
-        // Create a function that calls some function
-        // for all the individual data items to simplify
-        // the further code.
-        auto iterateContainer = [](auto& container, auto& func) {
-            for (auto& x : container) {
-                func(x.second);
-            }
-        };
-
-
-        auto forAllGroupData = [&](auto& func) {
-            iterateContainer(m_production_rates, func);
-            iterateContainer(prod_red_rates, func);
-            iterateContainer(inj_red_rates, func);
-            iterateContainer(inj_resv_rates, func);
-            iterateContainer(inj_rein_rates, func);
-        };
-
-        // Compute the size of the data.
         std::size_t sz = 0;
         auto computeSize = [&sz](const auto& v) {
             sz += v.size();
         };
-        forAllGroupData(computeSize);
-        sz += this->inj_vrep_rate.size();
+        this->forAllGroupRates(computeSize);
+        return sz + this->inj_vrep_rate.size();
+    }
 
-        // Make a vector and collect all data into it.
-        std::vector<double> data(sz);
+    // That the pack function mutates the group rates is an artifact for
+    // testing.
+    std::size_t pack_rates(double * data)
+    {
         std::size_t pos = 0;
-
-
-
-        // That the collect function mutates the vector v is an artifact for
-        // testing.
-        auto collect = [&data, &pos](auto& v) {
+        auto collect = [data, &pos](auto& v) {
             for (auto& x : v) {
                 data[pos++] = x;
                 x = -1;
             }
         };
-        forAllGroupData(collect);
+        this->forAllGroupRates(collect);
         for (const auto& x : this->inj_vrep_rate) {
             data[pos++] = x.second;
         }
-        if (pos != sz)
-            throw std::logic_error("Internal size mismatch when collecting groupData");
-
-        // Communicate it with a single sum() call.
-        comm.sum(data.data(), data.size());
+        return pos;
+    }
 
-        // Distribute the summed vector to the data items.
-        pos = 0;
-        auto distribute = [&data, &pos](auto& v) {
+    std::size_t unpack_rates(const double * data)
+    {
+        std::size_t pos = 0;
+        auto distribute = [data, &pos](auto& v) {
             for (auto& x : v) {
                 x = data[pos++];
             }
         };
-        forAllGroupData(distribute);
+        this->forAllGroupRates(distribute);
         for (auto& x : this->inj_vrep_rate) {
             x.second = data[pos++];
         }
-        if (pos != sz)
+        return pos;
+    }
+
+    template<class Comm>
+    void communicate_rates(const Comm& comm)
+    {
+        // Make a vector and collect all data into it.
+        const std::size_t sz = this->rates_pack_size();
+        std::vector<double> data(sz);
+        if (this->pack_rates(data.data()) != sz)
+            throw std::logic_error("Internal size mismatch when collecting groupData");
+
+        // Communicate it with a single sum() call.
+        comm.sum(data.data(), data.size());
+
+        // Distribute the summed vector to the data items.
+        if (this->unpack_rates(data.data()) != sz)
             throw std::logic_error("Internal size mismatch when distributing groupData");
     }
 
     std::string dump() const;
 
+    /// Write and read the state in a binary checkpoint.
+    void writeCheckpoint(std::ostream& os) const;
+    void readCheckpoint(std::istream& is);
+
 
 private:
+    // Call func for all the group rates vectors. Note that inj_vrep_rate is
+    // handled separately, since it contains single doubles, not vectors.
+    template<class Func>
+    void forAllGroupRates(Func& func)
+    {
+        for (auto* container : {&m_production_rates, &prod_red_rates, &inj_red_rates, &inj_resv_rates, &inj_rein_rates}) {
+            for (auto& x : *container) {
+                func(x.second);
+            }
+        }
+    }
+
+    template<class Func>
+    void forAllGroupRates(Func& func) const
+    {
+        for (const auto* container : {&m_production_rates, &prod_red_rates, &inj_red_rates, &inj_resv_rates, &inj_rein_rates}) {
+            for (const auto& x : *container) {
+                func(x.second);
+            }
+        }
+    }
+
     std::size_t num_phases;
     std::map<std::string, std::vector<double>> m_production_rates;
     std::map<std::string, Group::ProductionCMode> production_controls;
@@ -23,9 +23,13 @@
 #define OPM_MULTISEGMENTWELL_HEADER_INCLUDED
 
 #include <opm/simulators/wells/WellInterface.hpp>
+#include <opm/simulators/wells/SegmentTreeSolver.hpp>
 
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
 
+#include <array>
+#include <limits>
+
 namespace Opm
 {
     class DeferredLogger;
@@ -163,7 +167,7 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
         /// add the contribution (C, D, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 #endif
@@ -195,6 +199,8 @@ namespace Opm
 
         virtual void  addWellContributions(SparseMatrixAdapter& jacobian) const override;
 
+        virtual void addWellSystemBlocks(std::vector<Helper::WellSystemBlocks>& blocks) const override;
+
         /// number of segments for this well
         /// int number_of_segments_;
         int numberOfSegments() const;
@@ -295,8 +301,9 @@ namespace Opm
         mutable DiagMatWell duneD_;
         /// \brief solver for diagonal matrix
         ///
-        /// This is a shared_ptr as MultisegmentWell is copied in computeWellPotentials...
-        mutable std::shared_ptr<Dune::UMFPack<DiagMatWell> > duneDSolver_;
+        /// It eliminates the segments along the segment tree, and keeps the
+        /// factorisation until the next assembly.
+        mutable SegmentTreeSolver<DiagMatWell, BVectorWell> duneDSolver_;
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
@@ -345,6 +352,23 @@ namespace Opm
 
         std::vector<std::vector<EvalWell>> segment_phase_densities_;
 
+        // the arguments of the last evaluation of the segment fluid properties,
+        // the properties of a segment are only recomputed when they change
+        std::vector<std::array<EvalWell, numWellEq>> fluid_properties_primary_variables_;
+        EvalWell fluid_properties_temperature_{std::numeric_limits<double>::quiet_NaN()};
+        EvalWell fluid_properties_salt_concentration_{std::numeric_limits<double>::quiet_NaN()};
+        int fluid_properties_pvt_region_ = -1;
+
+        // the bhp where the production becomes nonzero, found by the last robust bhp(thp)
+        // solve of a producer, with the vfp table, the bhp limit and the rates at the bhp limit of that solve
+        struct BhpMaxCache {
+            int vfp_table = -1;
+            double bhp_limit = 0.0;
+            std::vector<double> rates_at_bhp_limit;
+            double bhp_max = 0.0;
+        };
+        mutable BhpMaxCache bhp_max_cache_;
+
 
         void initMatrixAndVectors(const int num_cells) const;
 
@@ -419,6 +443,7 @@ namespace Opm
                          std::vector<EvalWell>& mob) const;
 
         void computeWellRatesAtBhpLimit(const Simulator& ebosSimulator,
+                                        const WellState& well_state,
                                         std::vector<double>& well_flux,
                                         DeferredLogger& deferred_logger) const;
 
@@ -427,8 +452,16 @@ namespace Opm
                                      std::vector<double>& well_flux,
                                      DeferredLogger& deferred_logger) const;
 
+        // computes the rates at the given bhp starting from a copy of well_state
+        void computeWellRatesWithBhp(const Simulator& ebosSimulator,
+                                     const Scalar bhp,
+                                     const WellState& well_state,
+                                     std::vector<double>& well_flux,
+                                     DeferredLogger& deferred_logger) const;
+
         std::vector<double>
         computeWellPotentialWithTHP(const Simulator& ebos_simulator,
+                                    const WellState& well_state,
                                     DeferredLogger& deferred_logger) const;
 
         void assembleControlEq(const WellState& well_state,
@@ -26,6 +26,8 @@
 
 #include <string>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace Opm
 {
@@ -115,6 +117,7 @@ namespace Opm
                 segment_inlets_[outlet_segment_index].push_back(segment_index);
             }
         }
+        duneDSolver_ = SegmentTreeSolver<DiagMatWell, BVectorWell>(segment_inlets_);
 
         // calculating the depth difference between the segment and its oulet_segments
         // for the top segment, we will make its zero unless we find other purpose to use this value
@@ -419,7 +422,7 @@ namespace Opm
         duneB_.mv(x, Bx);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, Bx);
+        const BVectorWell invDBx = duneDSolver_.solve(duneD_, Bx);
 
         // Ax = Ax - duneC_^T * invDBx
         duneC_.mmtv(invDBx,Ax);
@@ -437,14 +440,14 @@ namespace Opm
         if (!this->isOperable() && !this->wellIsStopped()) return;
 
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        const BVectorWell invDrw = duneDSolver_.solve(duneD_, resWell_);
         // r = r - duneC_^T * invDrw
         duneC_.mmtv(invDrw, r);
     }
 
 
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
     template<typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -470,11 +473,36 @@ namespace Opm
             }
         }
 
-        // duneD
-        Dune::UMFPack<DiagMatWell> umfpackMatrix(duneD_, 0);
-        double *Dvals = umfpackMatrix.getInternalMatrix().getValues();
-        auto *Dcols = umfpackMatrix.getInternalMatrix().getColStart();
-        auto *Drows = umfpackMatrix.getInternalMatrix().getRowIndex();
+        // duneD, in the CSC format of Dune::UMFPack with all entries of the blocks stored.
+        // Built directly, constructing a Dune::UMFPack would factorize D just to get the format.
+        using UMFPackIndex = WellContributions::UMFPackIndex;
+        std::vector<std::vector<std::pair<int, const DiagMatrixBlockWellType*>>> blocksInCol(Mb);
+        for (auto rowD = duneD_.begin(); rowD != duneD_.end(); ++rowD) {
+            for (auto colD = rowD->begin(), endD = rowD->end(); colD != endD; ++colD) {
+                blocksInCol[colD.index()].emplace_back(rowD.index(), &(*colD));
+            }
+        }
+        std::vector<UMFPackIndex> DcolPointers;
+        std::vector<UMFPackIndex> DrowIndices;
+        std::vector<double> Dvalues;
+        DcolPointers.reserve(Mb * numWellEq + 1);
+        DrowIndices.reserve(DnumBlocks * numWellEq * numWellEq);
+        Dvalues.reserve(DnumBlocks * numWellEq * numWellEq);
+        DcolPointers.emplace_back(0);
+        for (unsigned int bc = 0; bc < Mb; ++bc) {
+            for (int j = 0; j < numWellEq; ++j) {
+                for (const auto& [br, block] : blocksInCol[bc]) {
+                    for (int i = 0; i < numWellEq; ++i) {
+                        DrowIndices.emplace_back(br * numWellEq + i);
+                        Dvalues.emplace_back((*block)[i][j]);
+                    }
+                }
+                DcolPointers.emplace_back(DrowIndices.size());
+            }
+        }
+        double *Dvals = Dvalues.data();
+        UMFPackIndex *Dcols = DcolPointers.data();
+        UMFPackIndex *Drows = DrowIndices.data();
 
         // duneB
         std::vector<unsigned int> Bcols;
@@ -565,9 +593,9 @@ namespace Opm
         // does the well have a THP related constraint?
         const auto& summaryState = ebosSimulator.vanguard().summaryState();
         if (!Base::wellHasTHPConstraints(summaryState)) {
-            computeWellRatesAtBhpLimit(ebosSimulator, well_potentials, deferred_logger);
+            computeWellRatesAtBhpLimit(ebosSimulator, well_state, well_potentials, deferred_logger);
         } else {
-            well_potentials = computeWellPotentialWithTHP(ebosSimulator, deferred_logger);
+            well_potentials = computeWellPotentialWithTHP(ebosSimulator, well_state, deferred_logger);
         }
         deferred_logger.debug("Cost in iterations of finding well potential for well "
                               + name() + ": " + std::to_string(debug_cost_counter_));
@@ -580,15 +608,16 @@ namespace Opm
     void
     MultisegmentWell<TypeTag>::
     computeWellRatesAtBhpLimit(const Simulator& ebosSimulator,
+                               const WellState& well_state,
                                std::vector<double>& well_flux,
                                DeferredLogger& deferred_logger) const
     {
         if (well_ecl_.isInjector()) {
             const auto controls = well_ecl_.injectionControls(ebosSimulator.vanguard().summaryState());
-            computeWellRatesWithBhp(ebosSimulator, controls.bhp_limit, well_flux, deferred_logger);
+            computeWellRatesWithBhp(ebosSimulator, controls.bhp_limit, well_state, well_flux, deferred_logger);
         } else {
             const auto controls = well_ecl_.productionControls(ebosSimulator.vanguard().summaryState());
-            computeWellRatesWithBhp(ebosSimulator, controls.bhp_limit, well_flux, deferred_logger);
+            computeWellRatesWithBhp(ebosSimulator, controls.bhp_limit, well_state, well_flux, deferred_logger);
         }
     }
 
@@ -601,6 +630,21 @@ namespace Opm
                             const Scalar bhp,
                             std::vector<double>& well_flux,
                             DeferredLogger& deferred_logger) const
+    {
+        computeWellRatesWithBhp(ebosSimulator, bhp, ebosSimulator.problem().wellModel().wellState(),
+                                well_flux, deferred_logger);
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    computeWellRatesWithBhp(const Simulator& ebosSimulator,
+                            const Scalar bhp,
+                            const WellState& well_state,
+                            std::vector<double>& well_flux,
+                            DeferredLogger& deferred_logger) const
     {
         // creating a copy of the well itself, to avoid messing up the explicit informations
         // during this copy, the only information not copied properly is the well controls
@@ -608,7 +652,7 @@ namespace Opm
         well_copy.debug_cost_counter_ = 0;
 
         // store a copy of the well state, we don't want to update the real well state
-        WellState well_state_copy = ebosSimulator.problem().wellModel().wellState();
+        WellState well_state_copy = well_state;
         const auto& group_state = ebosSimulator.problem().wellModel().groupState();
 
         // Get the current controls.
@@ -662,6 +706,7 @@ namespace Opm
     std::vector<double>
     MultisegmentWell<TypeTag>::
     computeWellPotentialWithTHP(const Simulator& ebos_simulator,
+                                const WellState& well_state,
                                 DeferredLogger& deferred_logger) const
     {
         std::vector<double> potentials(number_of_phases_, 0.0);
@@ -673,7 +718,7 @@ namespace Opm
             if (bhp_at_thp_limit) {
                 const auto& controls = well_ecl_.injectionControls(summary_state);
                 const double bhp = std::min(*bhp_at_thp_limit, controls.bhp_limit);
-                computeWellRatesWithBhp(ebos_simulator, bhp, potentials, deferred_logger);
+                computeWellRatesWithBhp(ebos_simulator, bhp, well_state, potentials, deferred_logger);
                 deferred_logger.debug("Converged thp based potential calculation for well "
                                       + name() + ", at bhp = " + std::to_string(bhp));
             } else {
@@ -682,14 +727,14 @@ namespace Opm
                                         + name() + ". Instead the bhp based value is used");
                 const auto& controls = well_ecl_.injectionControls(summary_state);
                 const double bhp = controls.bhp_limit;
-                computeWellRatesWithBhp(ebos_simulator, bhp, potentials, deferred_logger);
+                computeWellRatesWithBhp(ebos_simulator, bhp, well_state, potentials, deferred_logger);
             }
         } else {
             auto bhp_at_thp_limit = computeBhpAtThpLimitProd(ebos_simulator, summary_state, deferred_logger);
             if (bhp_at_thp_limit) {
                 const auto& controls = well_ecl_.productionControls(summary_state);
                 const double bhp = std::max(*bhp_at_thp_limit, controls.bhp_limit);
-                computeWellRatesWithBhp(ebos_simulator, bhp, potentials, deferred_logger);
+                computeWellRatesWithBhp(ebos_simulator, bhp, well_state, potentials, deferred_logger);
                 deferred_logger.debug("Converged thp based potential calculation for well "
                                       + name() + ", at bhp = " + std::to_string(bhp));
             } else {
@@ -698,7 +743,7 @@ namespace Opm
                                         + name() + ". Instead the bhp based value is used");
                 const auto& controls = well_ecl_.productionControls(summary_state);
                 const double bhp = controls.bhp_limit;
-                computeWellRatesWithBhp(ebos_simulator, bhp, potentials, deferred_logger);
+                computeWellRatesWithBhp(ebos_simulator, bhp, well_state, potentials, deferred_logger);
             }
         }
 
@@ -793,7 +838,7 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell);
+        xw = duneDSolver_.solve(duneD_, resWell);
     }
 
 
@@ -809,7 +854,7 @@ namespace Opm
 
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        const BVectorWell dx_well = duneDSolver_.solve(duneD_, resWell_);
 
         updateWellState(dx_well, well_state, deferred_logger);
     }
@@ -829,7 +874,7 @@ namespace Opm
             std::vector<double> density(number_of_phases_, 0.0);
 
             const int cell_idx = well_cells_[perf];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
 
             double sum_kr = 0.;
@@ -980,8 +1025,7 @@ namespace Opm
         auto fluidState = [&ebosSimulator, this](const int perf)
         {
             const auto cell_idx = this->well_cells_[perf];
-            return ebosSimulator.model()
-               .cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0)->fluidState();
+            return ebosSimulator.problem().cachedIntensiveQuantities(cell_idx)->fluidState();
         };
 
         const int np = this->number_of_phases_;
@@ -996,7 +1040,7 @@ namespace Opm
         };
 
         auto* wellPI = &well_state.productivityIndex()[this->index_of_well_*np + 0];
-        auto* connPI = &well_state.connectionProductivityIndex()[this->first_perf_*np + 0];
+        auto* connPI = well_state.connectionProductivityIndex(this->index_of_well_);
 
         setToZero(wellPI);
 
@@ -1042,10 +1086,26 @@ namespace Opm
     template<typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
-    addWellContributions(SparseMatrixAdapter& jacobian) const
+    addWellSystemBlocks(std::vector<Helper::WellSystemBlocks>& blocks) const
     {
-        const auto invDuneD = mswellhelpers::invertWithUMFPack<DiagMatWell, BVectorWell>(duneD_, duneDSolver_);
+        Helper::WellSystemBlocks well;
+        well.name = this->name();
+        well.B = Helper::SparseBlockMatrix::from(duneB_);
+        well.C = Helper::SparseBlockMatrix::from(duneC_);
+        well.D = Helper::SparseBlockMatrix::from(duneD_);
+        well.inverseD = false;
+        blocks.push_back(std::move(well));
+    }
+
+
+
+
 
+    template<typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    addWellContributions(SparseMatrixAdapter& jacobian) const
+    {
         // We need to change matrix A as follows
         // A -= C^T D^-1 B
         // D is a (nseg x nseg) block matrix with (4 x 4) blocks.
@@ -1054,16 +1114,22 @@ namespace Opm
         // perforation at cell j connected to segment i.  The code
         // assumes that no cell is connected to more than one segment,
         // i.e. the columns of B/C have no more than one nonzero.
-        for (size_t rowC = 0; rowC < duneC_.N(); ++rowC) {
-            for (auto colC = duneC_[rowC].begin(), endC = duneC_[rowC].end(); colC != endC; ++colC) {
-                const auto row_index = colC.index();
-                for (size_t rowB = 0; rowB < duneB_.N(); ++rowB) {
-                    for (auto colB = duneB_[rowB].begin(), endB = duneB_[rowB].end(); colB != endB; ++colB) {
-                        const auto col_index = colB.index();
-                        OffDiagMatrixBlockWellType tmp1;
-                        Detail::multMatrixImpl(invDuneD[rowC][rowB], (*colB), tmp1, std::true_type());
+        // The column of D^-1 B for cell j is obtained with one segment
+        // solve for all the equations together, D^-1 is never formed.
+        const auto nseg = duneD_.N();
+        std::vector<OffDiagMatrixBlockWellType> rhs(nseg);
+        for (size_t rowB = 0; rowB < duneB_.N(); ++rowB) {
+            for (auto colB = duneB_[rowB].begin(), endB = duneB_[rowB].end(); colB != endB; ++colB) {
+                const auto col_index = colB.index();
+                std::fill(rhs.begin(), rhs.end(), OffDiagMatrixBlockWellType(0.0));
+                rhs[rowB] = *colB;
+                const std::vector<OffDiagMatrixBlockWellType> invDB = duneDSolver_.solve(duneD_, rhs);
+
+                for (size_t rowC = 0; rowC < duneC_.N(); ++rowC) {
+                    for (auto colC = duneC_[rowC].begin(), endC = duneC_[rowC].end(); colC != endC; ++colC) {
+                        const auto row_index = colC.index();
                         typename SparseMatrixAdapter::MatrixBlock tmp2;
-                        Detail::multMatrixTransposedImpl((*colC), tmp1, tmp2, std::false_type());
+                        Detail::multMatrixTransposedImpl((*colC), invDB[rowC], tmp2, std::false_type());
                         jacobian.addToBlock(row_index, col_index, tmp2);
                     }
                 }
@@ -1407,7 +1473,7 @@ namespace Opm
         {
             // using the first perforated cell
             const int cell_idx = well_cells_[0];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
             temperature.setValue(fs.temperature(FluidSystem::oilPhaseIdx).value());
             saltConcentration = extendEval(fs.saltConcentration());
@@ -1425,7 +1491,28 @@ namespace Opm
             surf_dens[compIdx] = FluidSystem::referenceDensity( phaseIdx, pvt_region_index );
         }
 
+        // The properties of a segment only depend on its primary variables and on the
+        // temperature, salt concentration and pvt region, which are the same for all the
+        // segments. Segments whose primary variables did not change keep their properties.
+        if (temperature != fluid_properties_temperature_
+            || saltConcentration != fluid_properties_salt_concentration_
+            || pvt_region_index != fluid_properties_pvt_region_
+            || static_cast<int>(fluid_properties_primary_variables_.size()) != numberOfSegments()) {
+            std::array<EvalWell, numWellEq> invalid;
+            invalid.fill(std::numeric_limits<double>::quiet_NaN());
+            fluid_properties_primary_variables_.assign(numberOfSegments(), invalid);
+            fluid_properties_temperature_ = temperature;
+            fluid_properties_salt_concentration_ = saltConcentration;
+            fluid_properties_pvt_region_ = pvt_region_index;
+        }
+
         for (int seg = 0; seg < numberOfSegments(); ++seg) {
+            // NaN never compares equal, so the properties are computed the first time
+            if (fluid_properties_primary_variables_[seg] == primary_variables_evaluation_[seg]) {
+                continue;
+            }
+            fluid_properties_primary_variables_[seg] = primary_variables_evaluation_[seg];
+
             // the compostion of the components inside wellbore under surface condition
             std::vector<EvalWell> mix_s(num_components_, 0.0);
             for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
@@ -1558,8 +1645,10 @@ namespace Opm
                 density += surf_dens[comp_idx] * mix_s[comp_idx];
             }
             segment_densities_[seg] = density / volrat;
+        }
 
-            // calculate the mass rates
+        // the mass rates depend on the upwinding segments, they are always updated
+        for (int seg = 0; seg < numberOfSegments(); ++seg) {
             segment_mass_rates_[seg] = 0.;
             for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
                 const EvalWell rate = getSegmentRateUpwinding(seg, comp_idx);
@@ -1699,7 +1788,7 @@ namespace Opm
         // TODO: most of this function, if not the whole function, can be moved to the base class
         const int cell_idx = well_cells_[perf];
         assert (int(mob.size()) == num_components_);
-        const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+        const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
         const auto& materialLawManager = ebosSimulator.problem().materialLawManager();
 
         // either use mobility of the perforation cell or calcualte its own
@@ -2213,7 +2302,7 @@ namespace Opm
             getMobility(ebos_simulator, perf, mob);
 
             const int cell_idx = well_cells_[perf];
-            const auto& int_quantities = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& int_quantities = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = int_quantities.fluidState();
             // the pressure of the reservoir grid block the well connection is in
                     // pressure difference between the segment and the perforation
@@ -2442,7 +2531,7 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, group_state, deferred_logger);
 
-            const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+            const BVectorWell dx_well = duneDSolver_.solve(duneD_, resWell_);
 
             if (it > param_.strict_inner_iter_ms_wells_)
                 relax_convergence = true;
@@ -2638,12 +2727,11 @@ namespace Opm
 
             // calculating the perforation rate for each perforation that belongs to this segment
             const EvalWell seg_pressure = getSegmentPressure(seg);
-            const int rate_start_offset = first_perf_ * number_of_phases_;
-            auto * perf_rates = &well_state.mutable_perfPhaseRates()[rate_start_offset];
-            auto& perf_press_state = well_state.perfPress(this->index_of_well_);
+            auto * perf_rates = well_state.perfPhaseRates(this->index_of_well_);
+            auto * perf_press_state = well_state.perfPress(this->index_of_well_);
             for (const int perf : segment_perforations_[seg]) {
                 const int cell_idx = well_cells_[perf];
-                const auto& int_quants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+                const auto& int_quants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
                 std::vector<EvalWell> mob(num_components_, 0.0);
                 getMobility(ebosSimulator, perf, mob);
                 const double trans_mult = ebosSimulator.problem().template rockCompTransMultiplier<double>(int_quants, cell_idx);
@@ -2749,7 +2837,7 @@ namespace Opm
             for (const int perf : segment_perforations_[seg]) {
 
                 const int cell_idx = well_cells_[perf];
-                const auto& intQuants = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+                const auto& intQuants = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
                 const auto& fs = intQuants.fluidState();
 
                 // pressure difference between the segment and the perforation
@@ -2803,7 +2891,7 @@ namespace Opm
             // using the pvt region of first perforated cell
             // TODO: it should be a member of the WellInterface, initialized properly
             const int cell_idx = well_cells_[0];
-            const auto& intQuants = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            const auto& intQuants = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
             temperature.setValue(fs.temperature(FluidSystem::oilPhaseIdx).value());
             saltConcentration = extendEval(fs.saltConcentration());
@@ -3335,12 +3423,19 @@ namespace Opm
         };
 
         // Find the bhp-point where production becomes nonzero.
+        // It does not depend on the thp limit, and is reused while the rates at
+        // the bhp limit, which identify the reservoir and well state, are unchanged.
+        const std::vector<double> rates_bhp_limit = frates(controls.bhp_limit);
         double bhp_max = 0.0;
-        {
+        if (bhp_max_cache_.vfp_table == controls.vfp_table_number
+            && bhp_max_cache_.bhp_limit == controls.bhp_limit
+            && bhp_max_cache_.rates_at_bhp_limit == rates_bhp_limit) {
+            bhp_max = bhp_max_cache_.bhp_max;
+        } else {
             auto fflo = [&flo, &frates](double bhp) { return flo(frates(bhp)); };
             double low = controls.bhp_limit;
             double high = maxPerfPress(ebos_simulator) + 1.0 * unit::barsa;
-            double f_low = fflo(low);
+            double f_low = flo(rates_bhp_limit);
             double f_high = fflo(high);
             deferred_logger.debug("computeBhpAtThpLimitProd(): well = " + name() +
                                   "  low = " + std::to_string(low) +
@@ -3395,6 +3490,14 @@ namespace Opm
                                   "  f(low) = " + std::to_string(f_low) +
                                   "  f(high) = " + std::to_string(f_high) +
                                   "  bhp_max = " + std::to_string(bhp_max));
+
+            // A well without any flow at the bhp limit does not identify the state.
+            const bool flowing = std::any_of(rates_bhp_limit.begin(), rates_bhp_limit.end(),
+                                             [](const double rate) { return rate != 0.0; });
+            bhp_max_cache_.vfp_table = flowing ? controls.vfp_table_number : -1;
+            bhp_max_cache_.bhp_limit = controls.bhp_limit;
+            bhp_max_cache_.rates_at_bhp_limit = rates_bhp_limit;
+            bhp_max_cache_.bhp_max = bhp_max;
         }
 
         // Define the equation we want to solve.
@@ -3407,7 +3510,7 @@ namespace Opm
         double high = bhp_max;
         {
             double eq_high = eq(high);
-            double eq_low = eq(low);
+            double eq_low = fbhp(rates_bhp_limit) - low;
             const double eq_bhplimit = eq_low;
             deferred_logger.debug("computeBhpAtThpLimitProd(): well = " + name() +
                                   "  low = " + std::to_string(low) +
@@ -3692,7 +3795,7 @@ namespace Opm
         for (int seg = 0; seg < nseg; ++seg) {
             for (const int perf : segment_perforations_[seg]) {
                 const int cell_idx = well_cells_[perf];
-                const auto& int_quants = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+                const auto& int_quants = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
                 const auto& fs = int_quants.fluidState();
                 double pressure_cell = fs.pressure(FluidSystem::oilPhaseIdx).value();
                 max_pressure = std::max(max_pressure, pressure_cell);
@@ -3926,7 +4029,7 @@ namespace Opm
             const EvalWell seg_pressure = getSegmentPressure(seg);
             for (const int perf : segment_perforations_[seg]) {
                 const int cell_idx = well_cells_[perf];
-                const auto& int_quants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+                const auto& int_quants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
                 std::vector<EvalWell> mob(num_components_, 0.0);
                 getMobility(ebosSimulator, perf, mob);
                 const double trans_mult = ebosSimulator.problem().template rockCompTransMultiplier<double>(int_quants, cell_idx);
@@ -0,0 +1,88 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/wells/PerfData.hpp>
+
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+namespace Opm {
+
+void PerfData::init(const std::vector<int>& num_perf, int num_phases) {
+    this->num_phases_ = num_phases;
+    // Two quantities with one value per phase, the rest with one value.
+    this->values_per_perf_ = 2*num_phases + (NumFields - 2);
+
+    this->first_perf_index_.assign(num_perf.size() + 1, 0);
+    for (std::size_t w = 0; w < num_perf.size(); ++w)
+        this->first_perf_index_[w + 1] = this->first_perf_index_[w] + num_perf[w];
+
+    this->data_.assign(this->first_perf_index_.back() * this->values_per_perf_, 0.0);
+}
+
+std::size_t PerfData::numWells() const {
+    return this->first_perf_index_.empty() ? 0 : this->first_perf_index_.size() - 1;
+}
+
+int PerfData::numPerf(std::size_t well_index) const {
+    return this->first_perf_index_.at(well_index + 1) - this->first_perf_index_[well_index];
+}
+
+const std::vector<int>& PerfData::firstPerfIndex() const {
+    return this->first_perf_index_;
+}
+
+std::size_t PerfData::memoryUsage() const {
+    return this->first_perf_index_.capacity() * sizeof(int)
+        + this->data_.capacity() * sizeof(double);
+}
+
+std::size_t PerfData::fieldOffset(Field f) const {
+    switch (f) {
+    case PhaseRates:
+        return 0;
+    case ProdIndex:
+        return this->num_phases_;
+    default:
+        return 2*this->num_phases_ + (f - Pressure);
+    }
+}
+
+double* PerfData::field(std::size_t well_index, Field f) {
+    const std::size_t first = this->first_perf_index_.at(well_index);
+    return this->data_.data() + first * this->values_per_perf_ + this->fieldOffset(f) * this->numPerf(well_index);
+}
+
+const double* PerfData::field(std::size_t well_index, Field f) const {
+    const std::size_t first = this->first_perf_index_.at(well_index);
+    return this->data_.data() + first * this->values_per_perf_ + this->fieldOffset(f) * this->numPerf(well_index);
+}
+
+void PerfData::writeCheckpoint(std::ostream& os) const {
+    BinaryCheckpoint::write(os, this->first_perf_index_);
+    BinaryCheckpoint::write(os, this->data_);
+}
+
+void PerfData::readCheckpoint(std::istream& is) {
+    BinaryCheckpoint::readExpected(is, this->first_perf_index_, "well connections");
+    BinaryCheckpoint::read(is, this->data_);
+}
+
+}
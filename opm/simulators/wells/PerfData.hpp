@@ -0,0 +1,127 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PERF_DATA_HEADER_INCLUDED
+#define OPM_PERF_DATA_HEADER_INCLUDED
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace Opm {
+
+/*
+  The PerfData class stores the dynamic per connection quantities of all the
+  local wells in one array. The values of one well are stored in one
+  contiguous block, and inside the block every quantity is stored
+  contiguously for all the connections of the well:
+
+     well 0: | phase rates | productivity index | pressure | rates | ... |
+     well 1: | phase rates | productivity index | pressure | rates | ... |
+
+  The quantities with one value per phase store the values of connection i at
+  [i*num_phases, (i+1)*num_phases). Copying a PerfData is a single copy of
+  the array.
+*/
+
+class PerfData {
+public:
+    PerfData() = default;
+
+    /// Allocate the storage for num_perf[w] connections of well w,
+    /// all values are zero.
+    void init(const std::vector<int>& num_perf, int num_phases);
+
+    std::size_t numWells() const;
+    int numPerf(std::size_t well_index) const;
+
+    /// Index of the first connection of every well in the list of all
+    /// local connections, followed by the total number of connections.
+    const std::vector<int>& firstPerfIndex() const;
+
+    /// Bytes of the storage.
+    std::size_t memoryUsage() const;
+
+    /// Write and read the values in a binary checkpoint. The connections
+    /// must be allocated as when the checkpoint was written.
+    void writeCheckpoint(std::ostream& os) const;
+    void readCheckpoint(std::istream& is);
+
+    double* phaseRates(std::size_t well_index)             { return this->field(well_index, PhaseRates); }
+    const double* phaseRates(std::size_t well_index) const { return this->field(well_index, PhaseRates); }
+
+    double* prodIndex(std::size_t well_index)              { return this->field(well_index, ProdIndex); }
+    const double* prodIndex(std::size_t well_index) const  { return this->field(well_index, ProdIndex); }
+
+    double* pressure(std::size_t well_index)               { return this->field(well_index, Pressure); }
+    const double* pressure(std::size_t well_index) const   { return this->field(well_index, Pressure); }
+
+    double* rates(std::size_t well_index)                  { return this->field(well_index, Rates); }
+    const double* rates(std::size_t well_index) const      { return this->field(well_index, Rates); }
+
+    double* solventRates(std::size_t well_index)              { return this->field(well_index, SolventRates); }
+    const double* solventRates(std::size_t well_index) const  { return this->field(well_index, SolventRates); }
+
+    double* polymerRates(std::size_t well_index)              { return this->field(well_index, PolymerRates); }
+    const double* polymerRates(std::size_t well_index) const  { return this->field(well_index, PolymerRates); }
+
+    double* brineRates(std::size_t well_index)                { return this->field(well_index, BrineRates); }
+    const double* brineRates(std::size_t well_index) const    { return this->field(well_index, BrineRates); }
+
+    double* waterThroughput(std::size_t well_index)              { return this->field(well_index, WaterThroughput); }
+    const double* waterThroughput(std::size_t well_index) const  { return this->field(well_index, WaterThroughput); }
+
+    double* skinPressure(std::size_t well_index)              { return this->field(well_index, SkinPressure); }
+    const double* skinPressure(std::size_t well_index) const  { return this->field(well_index, SkinPressure); }
+
+    double* waterVelocity(std::size_t well_index)             { return this->field(well_index, WaterVelocity); }
+    const double* waterVelocity(std::size_t well_index) const { return this->field(well_index, WaterVelocity); }
+
+private:
+    // The order of the quantities inside the block of a well.
+    enum Field {
+        PhaseRates,
+        ProdIndex,
+        Pressure,
+        Rates,
+        SolventRates,
+        PolymerRates,
+        BrineRates,
+        WaterThroughput,
+        SkinPressure,
+        WaterVelocity,
+        NumFields
+    };
+
+    // Number of values per connection before the quantity in the block of a well.
+    std::size_t fieldOffset(Field f) const;
+
+    double* field(std::size_t well_index, Field f);
+    const double* field(std::size_t well_index, Field f) const;
+
+    int num_phases_ = 0;
+    // Number of values per connection, summed over all quantities.
+    std::size_t values_per_perf_ = 0;
+    std::vector<int> first_perf_index_;
+    std::vector<double> data_;
+};
+
+}
+
+#endif
@@ -26,9 +26,13 @@
 #include <opm/grid/utility/RegionMapping.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 
+#include <opm/models/parallel/threadedentityiterator.hh>
+
 #include <dune/grid/common/gridenums.hh>
 #include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -418,6 +422,18 @@ namespace Opm {
                 , rmap_ (region)
                 , attr_ (rmap_, Attributes())
             {
+                // position of every cell's region in activeRegions(), such
+                // that defineState() can sum into a flat array
+                const auto& regions = rmap_.activeRegions();
+                for (std::size_t i = 0; i < regions.size(); ++i) {
+                    for (const auto cell : rmap_.cells(regions[i])) {
+                        const auto c = static_cast<std::size_t>(cell);
+                        if (c >= regionIndex_.size()) {
+                            regionIndex_.resize(c + 1, -1);
+                        }
+                        regionIndex_[c] = static_cast<int>(i);
+                    }
+                }
             }
 
 
@@ -428,128 +444,100 @@ namespace Opm {
              * state for purpose of conversion from surface rate to
              * reservoir voidage rate.
              *
+             * The interior cells are visited once, threaded, and the
+             * cached intensive quantities are used if the model keeps
+             * them.  The sums of all regions are reduced over the
+             * processes in a single collective operation.
              */
             template <typename ElementContext, class EbosSimulator>
             void defineState(const EbosSimulator& simulator)
             {
+                using GridView = std::remove_cv_t<std::remove_reference_t<decltype(simulator.gridView())>>;
 
-                // create map from cell to region
-                // and set all attributes to zero
-                for (const auto& reg : rmap_.activeRegions()) {
-                    auto& ra = attr_.attributes(reg);
-                    ra.pressure = 0.0;
-                    ra.temperature = 0.0;
-                    ra.rs = 0.0;
-                    ra.rv = 0.0;
-                    ra.pv = 0.0;
-                    ra.saltConcentration = 0.0;
-
-                }
-
-                // quantities for pore volume average
-                std::unordered_map<RegionId, Attributes> attributes_pv;
+                const auto& regions = rmap_.activeRegions();
+                const std::size_t numRegions = regions.size();
 
-                // quantities for hydrocarbon volume average
-                std::unordered_map<RegionId, Attributes> attributes_hpv;
+                // per region the hydrocarbon pore volume weighted sums
+                // followed by the pore volume weighted sums
+                sums_.assign(numRegions * 2 * numSums, 0.0);
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                    attributes_pv.insert({reg, Attributes()});
-                    attributes_hpv.insert({reg, Attributes()});
-                }
-
-                ElementContext elemCtx( simulator );
                 const auto& gridView = simulator.gridView();
-                const auto& comm = gridView.comm();
-
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
-                     elemIt != elemEndIt;
-                     ++elemIt)
+                const auto& model = simulator.model();
+                const auto& elemMapper = model.elementMapper();
+                ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
                 {
+                    std::vector<double> localSums(sums_.size(), 0.0);
+                    ElementContext elemCtx( simulator );
+                    auto elemIt = threadedElemIt.beginParallel();
+                    for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                        const auto& elem = *elemIt;
+                        if (elem.partitionType() != Dune::InteriorEntity)
+                            continue;
+
+                        const unsigned cellIdx = elemMapper.index(elem);
+                        const auto* intQuantsPtr = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                        if (!intQuantsPtr) {
+                            elemCtx.updatePrimaryStencil(elem);
+                            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                            intQuantsPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                        }
+                        const auto& intQuants = *intQuantsPtr;
+                        const auto& fs = intQuants.fluidState();
+                        // use pore volume weighted averages.
+                        const double pv_cell =
+                                model.dofTotalVolume(cellIdx)
+                                * intQuants.porosity().value();
+
+                        // only count oil and gas filled parts of the domain
+                        double hydrocarbon = 1.0;
+                        const auto& pu = phaseUsage_;
+                        if (Details::PhaseUsed::water(pu)) {
+                            hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                        }
 
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
-                        continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = intQuants.fluidState();
-                    // use pore volume weighted averages.
-                    const double pv_cell =
-                            simulator.model().dofTotalVolume(cellIdx)
-                            * intQuants.porosity().value();
-
-                    // only count oil and gas filled parts of the domain
-                    double hydrocarbon = 1.0;
-                    const auto& pu = phaseUsage_;
-                    if (Details::PhaseUsed::water(pu)) {
-                        hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
-                    }
+                        assert(cellIdx < regionIndex_.size() && regionIndex_[cellIdx] >= 0);
+                        double* hpvSums = localSums.data() + 2 * numSums * regionIndex_[cellIdx];
+                        double* pvSums = hpvSums + numSums;
+
+                        // sum p, rs, rv, and T.
+                        const double hydrocarbonPV = pv_cell*hydrocarbon;
+                        if (hydrocarbonPV > 0.) {
+                            addCell_(fs, hydrocarbonPV, hpvSums);
+                        }
 
-                    const int reg = rmap_.region(cellIdx);
-                    assert(reg >= 0);
-
-                    // sum p, rs, rv, and T.
-                    const double hydrocarbonPV = pv_cell*hydrocarbon;
-                    if (hydrocarbonPV > 0.) {
-                        auto& attr = attributes_hpv[reg];
-                        attr.pv += hydrocarbonPV;
-                        attr.pressure += fs.pressure(FluidSystem::oilPhaseIdx).value() * hydrocarbonPV;
-                        attr.rs += fs.Rs().value() * hydrocarbonPV;
-                        attr.rv += fs.Rv().value() * hydrocarbonPV;
-                        attr.temperature += fs.temperature(FluidSystem::oilPhaseIdx).value() * hydrocarbonPV;
-                        attr.saltConcentration += fs.saltConcentration().value() * hydrocarbonPV;
+                        if (pv_cell > 0.) {
+                            addCell_(fs, pv_cell, pvSums);
+                        }
                     }
 
-                    if (pv_cell > 0.) {
-                        auto& attr = attributes_pv[reg];
-                        attr.pv += pv_cell;
-                        attr.pressure += fs.pressure(FluidSystem::oilPhaseIdx).value() * pv_cell;
-                        attr.rs += fs.Rs().value() * pv_cell;
-                        attr.rv += fs.Rv().value() * pv_cell;
-                        attr.temperature += fs.temperature(FluidSystem::oilPhaseIdx).value() * pv_cell;
-                        attr.saltConcentration += fs.saltConcentration().value() * pv_cell;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    for (std::size_t i = 0; i < sums_.size(); ++i) {
+                        sums_[i] += localSums[i];
                     }
                 }
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                      auto& ra = attr_.attributes(reg);
-                      const double hpv_sum = comm.sum(attributes_hpv[reg].pv);
-                      // TODO: should we have some epsilon here instead of zero?
-                      if (hpv_sum > 0.) {
-                          const auto& attri_hpv = attributes_hpv[reg];
-                          const double p_hpv_sum = comm.sum(attri_hpv.pressure);
-                          const double T_hpv_sum = comm.sum(attri_hpv.temperature);
-                          const double rs_hpv_sum = comm.sum(attri_hpv.rs);
-                          const double rv_hpv_sum = comm.sum(attri_hpv.rv);
-                          const double sc_hpv_sum = comm.sum(attri_hpv.saltConcentration);
-
-                          ra.pressure = p_hpv_sum / hpv_sum;
-                          ra.temperature = T_hpv_sum / hpv_sum;
-                          ra.rs = rs_hpv_sum / hpv_sum;
-                          ra.rv = rv_hpv_sum / hpv_sum;
-                          ra.pv = hpv_sum;
-                          ra.saltConcentration = sc_hpv_sum / hpv_sum;
-                      } else {
-                          // using the pore volume to do the averaging
-                          const auto& attri_pv = attributes_pv[reg];
-                          const double pv_sum = comm.sum(attri_pv.pv);
-                          assert(pv_sum > 0.);
-                          const double p_pv_sum = comm.sum(attri_pv.pressure);
-                          const double T_pv_sum = comm.sum(attri_pv.temperature);
-                          const double rs_pv_sum = comm.sum(attri_pv.rs);
-                          const double rv_pv_sum = comm.sum(attri_pv.rv);
-                          const double sc_pv_sum = comm.sum(attri_pv.saltConcentration);
-
-                          ra.pressure = p_pv_sum / pv_sum;
-                          ra.temperature = T_pv_sum / pv_sum;
-                          ra.rs = rs_pv_sum / pv_sum;
-                          ra.rv = rv_pv_sum / pv_sum;
-                          ra.pv = pv_sum;
-                          ra.saltConcentration = sc_pv_sum / pv_sum;
-                      }
+                gridView.comm().sum(sums_.data(), sums_.size());
+
+                for (std::size_t i = 0; i < numRegions; ++i) {
+                    auto& ra = attr_.attributes(regions[i]);
+                    const double* hpvSums = sums_.data() + 2 * numSums * i;
+                    const double* pvSums = hpvSums + numSums;
+                    // TODO: should we have some epsilon here instead of zero?
+                    // otherwise using the pore volume to do the averaging
+                    const double* s = hpvSums[PV] > 0. ? hpvSums : pvSums;
+                    assert(s[PV] > 0.);
+
+                    ra.pressure = s[Pressure] / s[PV];
+                    ra.temperature = s[Temperature] / s[PV];
+                    ra.rs = s[Rs] / s[PV];
+                    ra.rv = s[Rv] / s[PV];
+                    ra.pv = s[PV];
+                    ra.saltConcentration = s[SaltConcentration] / s[PV];
                 }
             }
 
@@ -800,6 +788,33 @@ namespace Opm {
 
             Details::RegionAttributes<RegionId, Attributes> attr_;
 
+            /**
+             * Layout of the volume weighted sums of a region in sums_.
+             */
+            enum SumIndex { PV, Pressure, Temperature, Rs, Rv, SaltConcentration, numSums };
+
+            /**
+             * Position of each cell's region in rmap_.activeRegions().
+             */
+            std::vector<int> regionIndex_;
+
+            /**
+             * Volume weighted sums of the last defineState(), kept to
+             * avoid reallocating them at every time step.
+             */
+            std::vector<double> sums_;
+
+            template <class FluidState>
+            static void addCell_(const FluidState& fs, const double weight, double* sums)
+            {
+                sums[PV] += weight;
+                sums[Pressure] += fs.pressure(FluidSystem::oilPhaseIdx).value() * weight;
+                sums[Temperature] += fs.temperature(FluidSystem::oilPhaseIdx).value() * weight;
+                sums[Rs] += fs.Rs().value() * weight;
+                sums[Rv] += fs.Rv().value() * weight;
+                sums[SaltConcentration] += fs.saltConcentration().value() * weight;
+            }
+
         };
     } // namespace RateConverter
 } // namespace Opm
@@ -0,0 +1,259 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+#define OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/OpmLog/OpmLog.hpp>
+
+#include <dune/common/fmatrix.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/// Direct solver for the segment equations D x = b of a multisegment well.
+///
+/// The segments of a well form a tree, and D only couples a segment with
+/// its outlet and its inlets. Eliminating the segments from the leaves
+/// towards the top segment therefore produces no fill-in: eliminating a
+/// segment only modifies the diagonal block of its outlet. Factorisation
+/// and solves cost O(number of segments) small block operations.
+///
+/// The factorisation is computed on the first solve after the
+/// construction or a reset(), and reused until the next reset().
+template <class MatrixType, class VectorType>
+class SegmentTreeSolver
+{
+public:
+    using Block = typename MatrixType::block_type;
+
+    SegmentTreeSolver() = default;
+
+    /// \param[in] segment_inlets  the inlet segments of every segment
+    explicit SegmentTreeSolver(const std::vector<std::vector<int>>& segment_inlets)
+        : outlet_(segment_inlets.size(), -1)
+    {
+        for (std::size_t seg = 0; seg < segment_inlets.size(); ++seg) {
+            for (const int inlet : segment_inlets[seg]) {
+                outlet_[inlet] = seg;
+            }
+        }
+
+        // Breadth first from the top segments gives every outlet before its
+        // inlets, the elimination order is the reverse.
+        order_.reserve(outlet_.size());
+        for (std::size_t seg = 0; seg < outlet_.size(); ++seg) {
+            if (outlet_[seg] < 0) {
+                order_.push_back(seg);
+            }
+        }
+        for (std::size_t i = 0; i < order_.size(); ++i) {
+            for (const int inlet : segment_inlets[order_[i]]) {
+                order_.push_back(inlet);
+            }
+        }
+        if (order_.size() != outlet_.size()) {
+            OPM_THROW(std::logic_error, "The segments of a multisegment well do not form a tree");
+        }
+        std::reverse(order_.begin(), order_.end());
+    }
+
+    /// Discard the factorisation, the matrix has changed.
+    void reset()
+    {
+        factorized_ = false;
+    }
+
+    /// Solve D x = b, factorising D first if needed.
+    VectorType solve(const MatrixType& D, const VectorType& b)
+    {
+        if (!factorized_) {
+            factorize(D);
+        }
+
+        // Forward substitution, from the leaves to the top.
+        VectorType y = b;
+        for (const int seg : order_) {
+            const int outlet = outlet_[seg];
+            if (outlet >= 0) {
+                lower_[seg].mmv(y[seg], y[outlet]);
+            }
+        }
+
+        // Backward substitution, from the top to the leaves.
+        VectorType x(b.size());
+        for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+            const int seg = *it;
+            const int outlet = outlet_[seg];
+            auto rhs = y[seg];
+            if (outlet >= 0) {
+                upper_[seg].mmv(x[outlet], rhs);
+            }
+            invPivot_[seg].mv(rhs, x[seg]);
+        }
+
+        // The same check as with the UMFPack solver, a nearly singular
+        // pivot might still give inf or nan values.
+        for (std::size_t i_block = 0; i_block < x.size(); ++i_block) {
+            for (std::size_t i_elem = 0; i_elem < x[i_block].size(); ++i_elem) {
+                checkFinite(x[i_block][i_elem]);
+            }
+        }
+        return x;
+    }
+
+    /// Solve D X = B for several right hand sides at once, given as one
+    /// column of blocks with Block::rows rows and any number of columns,
+    /// e.g. a column of the coupling matrix B of the well. All the right
+    /// hand sides share one pass over the factorisation.
+    template <class RhsBlock>
+    std::vector<RhsBlock> solve(const MatrixType& D, std::vector<RhsBlock> y)
+    {
+        if (!factorized_) {
+            factorize(D);
+        }
+
+        for (const int seg : order_) {
+            const int outlet = outlet_[seg];
+            if (outlet >= 0) {
+                subtractProduct(lower_[seg], y[seg], y[outlet]);
+            }
+        }
+
+        std::vector<RhsBlock> x(y.size());
+        for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+            const int seg = *it;
+            const int outlet = outlet_[seg];
+            RhsBlock& rhs = y[seg];
+            if (outlet >= 0) {
+                subtractProduct(upper_[seg], x[outlet], rhs);
+            }
+            x[seg] = 0.0;
+            addProduct(invPivot_[seg], rhs, x[seg]);
+        }
+
+        for (const auto& block : x) {
+            for (int i = 0; i < RhsBlock::rows; ++i) {
+                for (int j = 0; j < RhsBlock::cols; ++j) {
+                    checkFinite(block[i][j]);
+                }
+            }
+        }
+        return x;
+    }
+
+private:
+    static void checkFinite(const double value)
+    {
+        if (!std::isfinite(value)) {
+            const std::string msg{"nan or inf value found after the segment solve due to singular matrix"};
+            OpmLog::debug(msg);
+            OPM_THROW_NOLOG(NumericalIssue, msg);
+        }
+    }
+
+    // Y += A X
+    template <class RhsBlock>
+    static void addProduct(const Block& A, const RhsBlock& X, RhsBlock& Y)
+    {
+        for (int i = 0; i < Block::rows; ++i) {
+            for (int k = 0; k < Block::cols; ++k) {
+                const auto a = A[i][k];
+                for (int j = 0; j < RhsBlock::cols; ++j) {
+                    Y[i][j] += a * X[k][j];
+                }
+            }
+        }
+    }
+
+    // Y -= A X
+    template <class RhsBlock>
+    static void subtractProduct(const Block& A, const RhsBlock& X, RhsBlock& Y)
+    {
+        for (int i = 0; i < Block::rows; ++i) {
+            for (int k = 0; k < Block::cols; ++k) {
+                const auto a = A[i][k];
+                for (int j = 0; j < RhsBlock::cols; ++j) {
+                    Y[i][j] -= a * X[k][j];
+                }
+            }
+        }
+    }
+
+    void factorize(const MatrixType& D)
+    {
+        const std::size_t nseg = outlet_.size();
+        if (D.N() != nseg) {
+            OPM_THROW(std::logic_error, "The segment matrix does not match the segment tree");
+        }
+
+        invPivot_.resize(nseg);
+        lower_.resize(nseg);
+        upper_.resize(nseg);
+        for (std::size_t seg = 0; seg < nseg; ++seg) {
+            invPivot_[seg] = D[seg][seg];
+        }
+
+        for (const int seg : order_) {
+            // All the inlets are eliminated, the pivot is final.
+            try {
+                invPivot_[seg].invert();
+            } catch (const Dune::FMatrixError&) {
+                const std::string msg{"singular diagonal block found in the segment solve"};
+                OpmLog::debug(msg);
+                OPM_THROW_NOLOG(NumericalIssue, msg);
+            }
+
+            const int outlet = outlet_[seg];
+            if (outlet >= 0) {
+                // L = D(outlet, seg) * P^-1, U = D(seg, outlet)
+                // P(outlet) -= L * U
+                lower_[seg] = D[outlet][seg];
+                lower_[seg].rightmultiply(invPivot_[seg]);
+                upper_[seg] = D[seg][outlet];
+                Block update = lower_[seg];
+                update.rightmultiply(upper_[seg]);
+                invPivot_[outlet] -= update;
+            }
+        }
+        factorized_ = true;
+    }
+
+    // The outlet of every segment, -1 for the top segment.
+    std::vector<int> outlet_;
+    // Elimination order, every segment comes after all its inlets.
+    std::vector<int> order_;
+    // Inverses of the pivot blocks, i.e. of the diagonal blocks after the elimination of the inlets.
+    std::vector<Block> invPivot_;
+    std::vector<Block> lower_;
+    std::vector<Block> upper_;
+    bool factorized_ = false;
+};
+
+} // namespace Opm
+
+#endif // OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
@@ -23,7 +23,7 @@
 #ifndef OPM_STANDARDWELL_HEADER_INCLUDED
 #define OPM_STANDARDWELL_HEADER_INCLUDED
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 #endif
 
@@ -191,12 +191,18 @@ namespace Opm
                                                      DeferredLogger& deferred_logger,
                                                      const bool relax_tolerance = false) const override;
 
+        virtual void completeAssembly(const Simulator& ebosSimulator,
+                                      const double dt,
+                                      WellState& well_state,
+                                      const GroupState& group_state,
+                                      DeferredLogger& deferred_logger) override;
+
         /// Ax = Ax - C D^-1 B x
         virtual void apply(const BVector& x, BVector& Ax) const override;
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
         /// add the contribution (C, D^-1, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 
@@ -231,6 +237,10 @@ namespace Opm
 
         virtual void  addWellContributions(SparseMatrixAdapter& mat) const override;
 
+        virtual void addWellContributionsToPreconditioner(typename SparseMatrixAdapter::IstlMatrix& mat) const override;
+
+        virtual void addWellSystemBlocks(std::vector<Helper::WellSystemBlocks>& blocks) const override;
+
         // iterate well equations with the specified control until converged
         bool iterateWellEqWithControl(const Simulator& ebosSimulator,
                                       const double dt,
@@ -380,6 +390,9 @@ namespace Opm
         std::vector<double> perf_densities_;
         // pressure drop between different perforations
         std::vector<double> perf_pressure_diffs_;
+        // the pressures, rates and cell temperatures perf_densities_ and
+        // perf_pressure_diffs_ were computed with
+        std::vector<double> connection_pressure_inputs_;
 
         // residuals of the well equations
         BVectorWell resWell_;
@@ -393,10 +406,38 @@ namespace Opm
         // Wrapper for the parallel application of B for distributed wells
         wellhelpers::ParallelStandardWellB<Scalar> parallelB_;
 
+        // The sum of the well equations of a distributed well while it is
+        // communicated, see completeAssembly()
+        wellhelpers::NonblockingDistributedWellSum<Scalar> distributedSum_;
+
         // several vector used in the matrix calculation
         mutable BVectorWell Bx_;
         mutable BVectorWell invDrw_;
 
+        // B and C stored contiguously per perforation, used by apply() for
+        // wells that are not distributed. Entry (p, w, e) for perforation p,
+        // well equation w and reservoir equation e is at (p*numWellEq_ + w)*numEq + e.
+        std::vector<Scalar> fusedB_;
+        std::vector<Scalar> fusedC_;
+        // reservoir cell of each perforation in the order of fusedB_ and fusedC_
+        std::vector<int> fusedCells_;
+        // work array of size 2*numWellEq_ for apply()
+        mutable std::vector<Scalar> fusedWork_;
+
+        // The inflow relation sampled by the last robust bhp(thp) solve for a producer.
+        // It depends neither on the thp limit nor on the alq, so repeated solves with the
+        // same reservoir and well state, e.g. by the gas lift optimization, can reuse it.
+        // The rates at the bhp limit identify the state.
+        struct InflowSamples {
+            int vfp_table = -1;
+            double bhp_limit = 0.0;
+            std::vector<double> rates_at_bhp_limit;
+            std::vector<double> flo_samples;
+            std::vector<double> bhp_samples;
+            std::vector<std::vector<double>> rates_samples;
+        };
+        mutable InflowSamples inflow_samples_;
+
         // the values for the primary varibles
         // based on different solutioin strategies, the wells can have different primary variables
         mutable std::vector<double> primary_variables_;
@@ -425,8 +466,18 @@ namespace Opm
 
         EvalWell wellSurfaceVolumeFraction(const int phase) const;
 
+        // the surface volume fractions of all the components, the volume
+        // fraction sum is only evaluated once
+        std::vector<EvalWell> wellSurfaceVolumeFractions() const;
+
         EvalWell extendEval(const Eval& in) const;
 
+        // products and quotients of a quantity of the perforated cell, which
+        // only has derivatives with respect to the cell unknowns, and a well
+        // quantity, without extending the cell quantity to the well unknowns
+        EvalWell multiplyByCell(const Eval& cell, const EvalWell& in) const;
+        EvalWell divideByCell(const EvalWell& in, const Eval& cell) const;
+
         Eval getPerfCellPressure(const FluidState& fs) const;
 
         // xw = inv(D)*(rw - C*x)
@@ -469,9 +520,18 @@ namespace Opm
         void computeWellConnectionPressures(const Simulator& ebosSimulator,
                                             const WellState& well_state);
 
+        // whether the inputs of computeWellConnectionPressures() changed by more
+        // than the WellConnectionPressureTolerance since they were last used,
+        // stores them if so
+        bool connectionPressureInputsChanged(const Simulator& ebosSimulator,
+                                             const WellState& well_state);
+
+        // cmix_s are the wellSurfaceVolumeFractions(), they only depend on the
+        // well primary variables and are shared by all the perforations
         void computePerfRate(const IntensiveQuantities& intQuants,
                              const std::vector<EvalWell>& mob,
                              const EvalWell& bhp,
+                             const std::vector<EvalWell>& cmix_s,
                              const double Tw,
                              const int perf,
                              const bool allow_cf,
@@ -482,6 +542,7 @@ namespace Opm
 
         void computeWellRatesWithBhpPotential(const Simulator& ebosSimulator,
                                               const double& bhp,
+                                              const WellState& well_state,
                                               std::vector<double>& well_flux,
                                               DeferredLogger& deferred_logger);
 
@@ -495,14 +556,17 @@ namespace Opm
 
         virtual double getRefDensity() const override;
 
-        // get the mobility for specific perforation
+        // get the mobility for specific perforation, cmix_s are the
+        // wellSurfaceVolumeFractions() needed for the polymer shear effects
         void getMobility(const Simulator& ebosSimulator,
                          const int perf,
+                         const std::vector<EvalWell>& cmix_s,
                          std::vector<EvalWell>& mob,
                          DeferredLogger& deferred_logger) const;
 
         void updateWaterMobilityWithPolymer(const Simulator& ebos_simulator,
                                             const int perf,
+                                            const std::vector<EvalWell>& cmix_s,
                                             std::vector<EvalWell>& mob_water,
                                             DeferredLogger& deferred_logger) const;
 
@@ -524,6 +588,10 @@ namespace Opm
                                const SummaryState& summaryState,
                                DeferredLogger& deferred_logger);
 
+        // pack B and C for the fused application in apply(),
+        // to be called after the well equations have been assembled
+        void prepareFusedApply();
+
         // handle the non reasonable fractions due to numerical overshoot
         void processFractions() const;
 
@@ -542,8 +610,17 @@ namespace Opm
                                                 const GroupState& group_state,
                                                 DeferredLogger& deferred_logger);
 
+        // the part of the assembly which needs the sums over all
+        // perforations of a distributed well
+        void assembleWellEqAfterPerforations(const Simulator& ebosSimulator,
+                                             const double dt,
+                                             WellState& well_state,
+                                             const GroupState& group_state,
+                                             DeferredLogger& deferred_logger);
+
         void calculateSinglePerf(const Simulator& ebosSimulator,
                                  const int perf,
+                                 const std::vector<EvalWell>& cmix_s,
                                  WellState& well_state,
                                  std::vector<RateVector>& connectionRates,
                                  std::vector<EvalWell>& cq_s,
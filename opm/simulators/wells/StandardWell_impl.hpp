@@ -26,6 +26,7 @@
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <numeric>
 
@@ -331,6 +332,30 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    std::vector<typename StandardWell<TypeTag>::EvalWell>
+    StandardWell<TypeTag>::
+    wellSurfaceVolumeFractions() const
+    {
+        std::vector<EvalWell> fractions(num_components_, EvalWell{numWellEq_ + numEq, 0.});
+        EvalWell sum_volume_fraction_scaled(numWellEq_ + numEq, 0.);
+        for (int idx = 0; idx < num_components_; ++idx) {
+            fractions[idx] = wellVolumeFractionScaled(idx);
+            sum_volume_fraction_scaled += fractions[idx];
+        }
+
+        assert(sum_volume_fraction_scaled.value() != 0.);
+
+        for (auto& fraction : fractions) {
+            fraction /= sum_volume_fraction_scaled;
+        }
+        return fractions;
+    }
+
+
+
+
+
     template<typename TypeTag>
     typename StandardWell<TypeTag>::EvalWell
     StandardWell<TypeTag>::
@@ -347,6 +372,43 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    typename StandardWell<TypeTag>::EvalWell
+    StandardWell<TypeTag>::
+    multiplyByCell(const Eval& cell, const EvalWell& in) const
+    {
+        // the well derivatives of cell are zero
+        EvalWell out = in * cell.value();
+        for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            out.setDerivative(eqIdx, out.derivative(eqIdx) + cell.derivative(eqIdx) * in.value());
+        }
+        return out;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    typename StandardWell<TypeTag>::EvalWell
+    StandardWell<TypeTag>::
+    divideByCell(const EvalWell& in, const Eval& cell) const
+    {
+        // d(in/cell) = d(in)/cell - in/cell^2 * d(cell), and the well
+        // derivatives of cell are zero
+        const Scalar inv = 1.0 / cell.value();
+        EvalWell out = in * inv;
+        const Scalar factor = in.value() * inv * inv;
+        for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            out.setDerivative(eqIdx, out.derivative(eqIdx) - factor * cell.derivative(eqIdx));
+        }
+        return out;
+    }
+
+
+
+
+
     template<typename TypeTag>
     typename StandardWell<TypeTag>::Eval
     StandardWell<TypeTag>::getPerfCellPressure(const typename StandardWell<TypeTag>::FluidState& fs) const
@@ -371,6 +433,7 @@ namespace Opm
     computePerfRate(const IntensiveQuantities& intQuants,
                     const std::vector<EvalWell>& mob,
                     const EvalWell& bhp,
+                    const std::vector<EvalWell>& cmix_s,
                     const double Tw,
                     const int perf,
                     const bool allow_cf,
@@ -380,21 +443,26 @@ namespace Opm
                     DeferredLogger& deferred_logger) const
     {
 
+        // The cell quantities are kept with the derivatives with respect to
+        // the cell unknowns only, and are combined with the well quantities
+        // by multiplyByCell() and divideByCell(), which skip the well
+        // derivatives that are zero for them.
         const auto& fs = intQuants.fluidState();
-        const EvalWell pressure = extendEval(getPerfCellPressure(fs));
-        const EvalWell rs = extendEval(fs.Rs());
-        const EvalWell rv = extendEval(fs.Rv());
-        std::vector<EvalWell> b_perfcells_dense(num_components_, EvalWell{numWellEq_ + numEq, 0.0});
+        const Eval& pressure = getPerfCellPressure(fs);
+        const Eval& rs = fs.Rs();
+        const Eval& rv = fs.Rv();
+        std::array<Eval, numWellConservationEq> b_perfcells_dense;
+        b_perfcells_dense.fill(Eval{0.0});
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
             if (!FluidSystem::phaseIsActive(phaseIdx)) {
                 continue;
             }
 
             const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-            b_perfcells_dense[compIdx] = extendEval(fs.invB(phaseIdx));
+            b_perfcells_dense[compIdx] = fs.invB(phaseIdx);
         }
         if constexpr (has_solvent) {
-            b_perfcells_dense[contiSolventEqIdx] = extendEval(intQuants.solventInverseFormationVolumeFactor());
+            b_perfcells_dense[contiSolventEqIdx] = intQuants.solventInverseFormationVolumeFactor();
         }
 
         if constexpr (has_zFraction) {
@@ -407,7 +475,7 @@ namespace Opm
 
         // Pressure drawdown (also used to determine direction of flow)
         const EvalWell well_pressure = bhp + perf_pressure_diffs_[perf];
-        EvalWell drawdown = pressure - well_pressure;
+        EvalWell drawdown = extendEval(pressure) - well_pressure;
 
         if constexpr (Base::has_polymermw) {
             if (this->isInjector()) {
@@ -427,7 +495,7 @@ namespace Opm
             // compute component volumetric rates at standard conditions
             for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
                 const EvalWell cq_p = - Tw * (mob[componentIdx] * drawdown);
-                cq_s[componentIdx] = b_perfcells_dense[componentIdx] * cq_p;
+                cq_s[componentIdx] = multiplyByCell(b_perfcells_dense[componentIdx], cq_p);
             }
 
             if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
@@ -435,8 +503,8 @@ namespace Opm
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const EvalWell cq_sOil = cq_s[oilCompIdx];
                 const EvalWell cq_sGas = cq_s[gasCompIdx];
-                const EvalWell dis_gas = rs * cq_sOil;
-                const EvalWell vap_oil = rv * cq_sGas;
+                const EvalWell dis_gas = multiplyByCell(rs, cq_sOil);
+                const EvalWell vap_oil = multiplyByCell(rv, cq_sGas);
 
                 cq_s[gasCompIdx] += dis_gas;
                 cq_s[oilCompIdx] += vap_oil;
@@ -463,50 +531,44 @@ namespace Opm
             // injection perforations total volume rates
             const EvalWell cqt_i = - Tw * (total_mob_dense * drawdown);
 
-            // surface volume fraction of fluids within wellbore
-            std::vector<EvalWell> cmix_s(num_components_, EvalWell{numWellEq_ + numEq});
-            for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
-                cmix_s[componentIdx] = wellSurfaceVolumeFraction(componentIdx);
-            }
-
             // compute volume ratio between connection at standard conditions
             EvalWell volumeRatio(numWellEq_ + numEq, 0.);
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
-                volumeRatio += cmix_s[waterCompIdx] / b_perfcells_dense[waterCompIdx];
+                volumeRatio += divideByCell(cmix_s[waterCompIdx], b_perfcells_dense[waterCompIdx]);
             }
 
             if constexpr (has_solvent) {
-                volumeRatio += cmix_s[contiSolventEqIdx] / b_perfcells_dense[contiSolventEqIdx];
+                volumeRatio += divideByCell(cmix_s[contiSolventEqIdx], b_perfcells_dense[contiSolventEqIdx]);
             }
 
             if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 // Incorporate RS/RV factors if both oil and gas active
-                const EvalWell d = EvalWell(numWellEq_ + numEq, 1.0) - rv * rs;
+                const Eval d = 1.0 - rv * rs;
 
                 if (d.value() == 0.0) {
                     OPM_DEFLOG_THROW(NumericalIssue, "Zero d value obtained for well " << name() << " during flux calcuation"
                                                   << " with rs " << rs << " and rv " << rv, deferred_logger);
                 }
 
-                const EvalWell tmp_oil = (cmix_s[oilCompIdx] - rv * cmix_s[gasCompIdx]) / d;
+                const EvalWell tmp_oil = divideByCell(cmix_s[oilCompIdx] - multiplyByCell(rv, cmix_s[gasCompIdx]), d);
                 //std::cout << "tmp_oil " <<tmp_oil << std::endl;
-                volumeRatio += tmp_oil / b_perfcells_dense[oilCompIdx];
+                volumeRatio += divideByCell(tmp_oil, b_perfcells_dense[oilCompIdx]);
 
-                const EvalWell tmp_gas = (cmix_s[gasCompIdx] - rs * cmix_s[oilCompIdx]) / d;
+                const EvalWell tmp_gas = divideByCell(cmix_s[gasCompIdx] - multiplyByCell(rs, cmix_s[oilCompIdx]), d);
                 //std::cout << "tmp_gas " <<tmp_gas << std::endl;
-                volumeRatio += tmp_gas / b_perfcells_dense[gasCompIdx];
+                volumeRatio += divideByCell(tmp_gas, b_perfcells_dense[gasCompIdx]);
             }
             else {
                 if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
-                    volumeRatio += cmix_s[oilCompIdx] / b_perfcells_dense[oilCompIdx];
+                    volumeRatio += divideByCell(cmix_s[oilCompIdx], b_perfcells_dense[oilCompIdx]);
                 }
                 if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
-                    volumeRatio += cmix_s[gasCompIdx] / b_perfcells_dense[gasCompIdx];
+                    volumeRatio += divideByCell(cmix_s[gasCompIdx], b_perfcells_dense[gasCompIdx]);
                 }
             }
 
@@ -581,9 +643,6 @@ namespace Opm
                                        DeferredLogger& deferred_logger)
     {
 
-        // TODO: it probably can be static member for StandardWell
-        const double volume = 0.002831684659200; // 0.1 cu ft;
-
         // the solution gas rate and solution oil rate needs to be reset to be zero for well_state.
         well_state.wellVaporizedOilRates(index_of_well_) = 0.;
         well_state.wellDissolvedGasRates(index_of_well_) = 0.;
@@ -591,14 +650,17 @@ namespace Opm
         const int np = number_of_phases_;
 
         std::vector<RateVector> connectionRates = connectionRates_; // Copy to get right size.
-        const int rate_start_offset = first_perf_ * number_of_phases_;
-        auto * perf_rates = &well_state.mutable_perfPhaseRates()[rate_start_offset];
+        auto * perf_rates = well_state.perfPhaseRates(index_of_well_);
+        // surface volume fractions of the fluids within the wellbore
+        const std::vector<EvalWell> cmix_s = wellSurfaceVolumeFractions();
+        // The perforation rates are allocated once for all perforations.
+        std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.0});
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             // Calculate perforation quantities.
-            std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.0});
+            std::fill(cq_s.begin(), cq_s.end(), EvalWell{numWellEq_ + numEq, 0.0});
             EvalWell water_flux_s{numWellEq_ + numEq, 0.0};
             EvalWell cq_s_zfrac_effective{numWellEq_ + numEq, 0.0};
-            calculateSinglePerf(ebosSimulator, perf, well_state, connectionRates, cq_s, water_flux_s, cq_s_zfrac_effective, deferred_logger);
+            calculateSinglePerf(ebosSimulator, perf, cmix_s, well_state, connectionRates, cq_s, water_flux_s, cq_s_zfrac_effective, deferred_logger);
 
             // Equation assembly for this perforation.
             if constexpr (has_polymer && Base::has_polymermw) {
@@ -629,7 +691,7 @@ namespace Opm
 
                 // Store the perforation phase flux for later usage.
                 if (has_solvent && componentIdx == contiSolventEqIdx) {
-                    auto * perf_rate_solvent = &well_state.perfRateSolvent()[first_perf_];
+                    auto * perf_rate_solvent = well_state.perfRateSolvent(index_of_well_);
                     perf_rate_solvent[perf] = cq_s[componentIdx].value();
                 } else {
                     perf_rates[perf*np + ebosCompIdxToFlowCompIdx(componentIdx)] = cq_s[componentIdx].value();
@@ -646,8 +708,50 @@ namespace Opm
         connectionRates_ = connectionRates;
 
         // accumulate resWell_ and invDuneD_ in parallel to get effects of all perforations (might be distributed)
-        wellhelpers::sumDistributedWellEntries(invDuneD_[0][0], resWell_[0],
-                                            this->parallel_well_info_.communication());
+        const auto& comm = this->parallel_well_info_.communication();
+        if (this->postpone_communication_ && comm.size() > 1) {
+            // completed by completeAssembly() after the reservoir has been assembled
+            distributedSum_.start(invDuneD_[0][0], resWell_[0], comm);
+            return;
+        }
+        wellhelpers::sumDistributedWellEntries(invDuneD_[0][0], resWell_[0], comm);
+        assembleWellEqAfterPerforations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+    }
+
+
+
+
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    completeAssembly(const Simulator& ebosSimulator,
+                     const double dt,
+                     WellState& well_state,
+                     const GroupState& group_state,
+                     DeferredLogger& deferred_logger)
+    {
+        if (!distributedSum_.pending()) {
+            return;
+        }
+        distributedSum_.finish(invDuneD_[0][0], resWell_[0]);
+        assembleWellEqAfterPerforations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+    }
+
+
+
+
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    assembleWellEqAfterPerforations(const Simulator& ebosSimulator,
+                                    const double dt,
+                                    WellState& well_state,
+                                    const GroupState& group_state,
+                                    DeferredLogger& deferred_logger)
+    {
+        // TODO: it probably can be static member for StandardWell
+        const double volume = 0.002831684659200; // 0.1 cu ft;
+
         // add vol * dF/dt + Q to the well equations;
         for (int componentIdx = 0; componentIdx < numWellConservationEq; ++componentIdx) {
             // TODO: following the development in MSW, we need to convert the volume of the wellbore to be surface volume
@@ -675,6 +779,47 @@ namespace Opm
         } catch( ... ) {
             OPM_DEFLOG_THROW(NumericalIssue,"Error when inverting local well equations for well " + name(), deferred_logger);
         }
+
+        prepareFusedApply();
+    }
+
+
+
+
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    prepareFusedApply()
+    {
+        fusedB_.clear();
+        fusedC_.clear();
+        fusedCells_.clear();
+        // Distributed wells need the parallel reduction of B x done by parallelB_,
+        // and with the contributions in the matrix apply() does nothing.
+        if (this->parallel_well_info_.communication().size() > 1 || param_.matrix_add_well_contributions_) {
+            return;
+        }
+
+        const std::size_t blockSize = numWellEq_ * numEq;
+        fusedB_.resize(duneB_[0].size() * blockSize);
+        fusedC_.resize(duneC_[0].size() * blockSize);
+        fusedCells_.reserve(duneB_[0].size());
+        fusedWork_.resize(2 * numWellEq_);
+
+        std::size_t perf = 0;
+        for (auto colB = duneB_[0].begin(), colC = duneC_[0].begin(), endB = duneB_[0].end();
+             colB != endB; ++colB, ++colC, ++perf) {
+            assert(colB.index() == colC.index());
+            fusedCells_.push_back(colB.index());
+            Scalar* B = fusedB_.data() + perf * blockSize;
+            Scalar* C = fusedC_.data() + perf * blockSize;
+            for (int w = 0; w < numWellEq_; ++w) {
+                for (int e = 0; e < numEq; ++e) {
+                    B[w * numEq + e] = (*colB)[w][e];
+                    C[w * numEq + e] = (*colC)[w][e];
+                }
+            }
+        }
     }
 
 
@@ -685,6 +830,7 @@ namespace Opm
     StandardWell<TypeTag>::
     calculateSinglePerf(const Simulator& ebosSimulator,
                         const int perf,
+                        const std::vector<EvalWell>& cmix_s,
                         WellState& well_state,
                         std::vector<RateVector>& connectionRates,
                         std::vector<EvalWell>& cq_s,
@@ -695,15 +841,15 @@ namespace Opm
         const bool allow_cf = getAllowCrossFlow() || openCrossFlowAvoidSingularity(ebosSimulator);
         const EvalWell& bhp = getBhp();
         const int cell_idx = well_cells_[perf];
-        const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+        const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
         std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.});
-        getMobility(ebosSimulator, perf, mob, deferred_logger);
+        getMobility(ebosSimulator, perf, cmix_s, mob, deferred_logger);
 
         double perf_dis_gas_rate = 0.;
         double perf_vap_oil_rate = 0.;
         double trans_mult = ebosSimulator.problem().template rockCompTransMultiplier<double>(intQuants,  cell_idx);
         const double Tw = well_index_[perf] * trans_mult;
-        computePerfRate(intQuants, mob, bhp, Tw, perf, allow_cf,
+        computePerfRate(intQuants, mob, bhp, cmix_s, Tw, perf, allow_cf,
                         cq_s, perf_dis_gas_rate, perf_vap_oil_rate, deferred_logger);
 
         if constexpr (has_polymer && Base::has_polymermw) {
@@ -795,7 +941,7 @@ namespace Opm
                 cq_s_poly *= extendEval(intQuants.polymerConcentration() * intQuants.polymerViscosityCorrection());
             }
             // Note. Efficiency factor is handled in the output layer
-            auto * perf_rate_polymer = &well_state.perfRatePolymer()[first_perf_];
+            auto * perf_rate_polymer = well_state.perfRatePolymer(index_of_well_);
             perf_rate_polymer[perf] = cq_s_poly.value();
 
             cq_s_poly *= well_efficiency_factor_;
@@ -828,7 +974,7 @@ namespace Opm
                 const double dis_gas_frac = perf_dis_gas_rate / cq_s_zfrac_effective.value();
                 cq_s_zfrac_effective *= extendEval(dis_gas_frac*intQuants.xVolume() + (1.0-dis_gas_frac)*intQuants.yVolume());
             }
-            auto * perf_rate_solvent = &well_state.perfRateSolvent()[first_perf_];
+            auto * perf_rate_solvent = well_state.perfRateSolvent(index_of_well_);
             perf_rate_solvent[perf] = cq_s_zfrac_effective.value();
 
             cq_s_zfrac_effective *= well_efficiency_factor_;
@@ -845,7 +991,7 @@ namespace Opm
                 cq_s_sm *= extendEval(intQuants.fluidState().saltConcentration());
             }
             // Note. Efficiency factor is handled in the output layer
-            auto * perf_rate_brine = &well_state.perfRateBrine()[this->first_perf_];
+            auto * perf_rate_brine = well_state.perfRateBrine(this->index_of_well_);
             perf_rate_brine[perf] = cq_s_sm.value();
 
             cq_s_sm *= well_efficiency_factor_;
@@ -853,7 +999,7 @@ namespace Opm
         }
 
         // Store the perforation pressure for later usage.
-        auto& perf_press = well_state.perfPress(index_of_well_);
+        auto * perf_press = well_state.perfPress(index_of_well_);
         perf_press[perf] = well_state.bhp(index_of_well_) + perf_pressure_diffs_[perf];
     }
 
@@ -927,12 +1073,13 @@ namespace Opm
     StandardWell<TypeTag>::
     getMobility(const Simulator& ebosSimulator,
                 const int perf,
+                const std::vector<EvalWell>& cmix_s,
                 std::vector<EvalWell>& mob,
                 DeferredLogger& deferred_logger) const
     {
         const int cell_idx = well_cells_[perf];
         assert (int(mob.size()) == num_components_);
-        const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+        const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
         const auto& materialLawManager = ebosSimulator.problem().materialLawManager();
 
         // either use mobility of the perforation cell or calcualte its own
@@ -986,7 +1133,7 @@ namespace Opm
             // for the cases related to polymer molecular weight, we assume fully mixing
             // as a result, the polymer and water share the same viscosity
             if constexpr (!Base::has_polymermw) {
-                updateWaterMobilityWithPolymer(ebosSimulator, perf, mob, deferred_logger);
+                updateWaterMobilityWithPolymer(ebosSimulator, perf, cmix_s, mob, deferred_logger);
             }
         }
     }
@@ -1305,8 +1452,8 @@ namespace Opm
         // other primary variables related to polymer injectivity study
         if constexpr (Base::has_polymermw) {
             if (this->isInjector()) {
-                auto * perf_water_velocity = &well_state.perfWaterVelocity()[this->first_perf_];
-                auto * perf_skin_pressure = &well_state.perfSkinPressure()[this->first_perf_];
+                auto * perf_water_velocity = well_state.perfWaterVelocity(this->index_of_well_);
+                auto * perf_skin_pressure = well_state.perfSkinPressure(this->index_of_well_);
                 for (int perf = 0; perf < number_of_perforations_; ++perf) {
                     perf_water_velocity[perf] = primary_variables_[Bhp + 1 + perf];
                     perf_skin_pressure[perf] = primary_variables_[Bhp + 1 + number_of_perforations_ + perf];
@@ -1385,20 +1532,26 @@ namespace Opm
         std::fill(ipr_a_.begin(), ipr_a_.end(), 0.);
         std::fill(ipr_b_.begin(), ipr_b_.end(), 0.);
 
+        // The values of the connections are allocated once for all of them.
+        std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.0});
+        std::vector<double> b_perf(num_components_);
+        std::vector<double> ipr_a_perf(ipr_a_.size());
+        std::vector<double> ipr_b_perf(ipr_b_.size());
+        const std::vector<EvalWell> cmix_s = wellSurfaceVolumeFractions();
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
-            std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.0});
+            std::fill(mob.begin(), mob.end(), EvalWell{numWellEq_ + numEq, 0.0});
             // TODO: mabye we should store the mobility somewhere, so that we only need to calculate it one per iteration
-            getMobility(ebos_simulator, perf, mob, deferred_logger);
+            getMobility(ebos_simulator, perf, cmix_s, mob, deferred_logger);
 
             const int cell_idx = well_cells_[perf];
-            const auto& int_quantities = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& int_quantities = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = int_quantities.fluidState();
             // the pressure of the reservoir grid block the well connection is in
             Eval perf_pressure = getPerfCellPressure(fs);
             double p_r = perf_pressure.value();
 
             // calculating the b for the connection
-            std::vector<double> b_perf(num_components_);
+            std::fill(b_perf.begin(), b_perf.end(), 0.0);
             for (size_t phase = 0; phase < FluidSystem::numPhases; ++phase) {
                 if (!FluidSystem::phaseIsActive(phase)) {
                     continue;
@@ -1425,8 +1578,8 @@ namespace Opm
             // TODO: there might be some indices related problems here
             // phases vs components
             // ipr values for the perforation
-            std::vector<double> ipr_a_perf(ipr_a_.size());
-            std::vector<double> ipr_b_perf(ipr_b_.size());
+            std::fill(ipr_a_perf.begin(), ipr_a_perf.end(), 0.0);
+            std::fill(ipr_b_perf.begin(), ipr_b_perf.end(), 0.0);
             for (int p = 0; p < number_of_phases_; ++p) {
                 const double tw_mob = tw_perf * mob[p].value() * b_perf[p];
                 ipr_a_perf[p] += tw_mob * pressure_diff;
@@ -1565,7 +1718,7 @@ namespace Opm
 
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
-            const auto& intQuants = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            const auto& intQuants = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
 
             const double pressure = (fs.pressure(FluidSystem::oilPhaseIdx)).value();
@@ -1672,14 +1825,14 @@ namespace Opm
         }
 
         // Compute the average pressure in each well block
-        const auto& perf_press = well_state.perfPress(w);
+        const auto * perf_press = well_state.perfPress(w);
         auto p_above =  this->parallel_well_info_.communicateAboveValues(well_state.bhp(w),
-                                                                         perf_press.data(),
+                                                                         perf_press,
                                                                          nperf);
 
         for (int perf = 0; perf < nperf; ++perf) {
             const int cell_idx = well_cells_[perf];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
 
             // TODO: this is another place to show why WellState need to be a vector of WellState.
@@ -2028,8 +2181,7 @@ namespace Opm
         auto fluidState = [&ebosSimulator, this](const int perf)
         {
             const auto cell_idx = this->well_cells_[perf];
-            return ebosSimulator.model()
-               .cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0)->fluidState();
+            return ebosSimulator.problem().cachedIntensiveQuantities(cell_idx)->fluidState();
         };
 
         const int np = this->number_of_phases_;
@@ -2044,13 +2196,15 @@ namespace Opm
         };
 
         auto* wellPI = &well_state.productivityIndex()[this->index_of_well_*np + 0];
-        auto* connPI = &well_state.connectionProductivityIndex()[this->first_perf_*np + 0];
+        auto* connPI = well_state.connectionProductivityIndex(this->index_of_well_);
 
         setToZero(wellPI);
 
         const auto preferred_phase = this->well_ecl_.getPreferredPhase();
         auto subsetPerfID = 0;
 
+        std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.0});
+        const std::vector<EvalWell> cmix_s = wellSurfaceVolumeFractions();
         for (const auto& perf : *this->perf_data_) {
             auto allPerfID = perf.ecl_index;
 
@@ -2059,8 +2213,8 @@ namespace Opm
                 return wellPICalc.connectionProdIndStandard(allPerfID, mobility);
             };
 
-            std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.0});
-            getMobility(ebosSimulator, static_cast<int>(subsetPerfID), mob, deferred_logger);
+            std::fill(mob.begin(), mob.end(), EvalWell{numWellEq_ + numEq, 0.0});
+            getMobility(ebosSimulator, static_cast<int>(subsetPerfID), cmix_s, mob, deferred_logger);
 
             const auto& fs = fluidState(subsetPerfID);
             setToZero(connPI);
@@ -2105,7 +2259,7 @@ namespace Opm
         const int nperf = number_of_perforations_;
         const int np = number_of_phases_;
         std::vector<double> perfRates(b_perf.size(),0.0);
-        const auto * perf_rates_state = &well_state.perfPhaseRates()[first_perf_ * np];
+        const auto * perf_rates_state = well_state.perfPhaseRates(index_of_well_);
 
         for (int perf = 0; perf < nperf; ++perf) {
             for (int comp = 0; comp < np; ++comp) {
@@ -2114,7 +2268,7 @@ namespace Opm
         }
 
         if constexpr (has_solvent) {
-            const auto * solvent_perf_rates_state = &well_state.perfRateSolvent()[this->first_perf_];
+            const auto * solvent_perf_rates_state = well_state.perfRateSolvent(this->index_of_well_);
             for (int perf = 0; perf < nperf; ++perf) {
                 perfRates[perf * num_components_ + contiSolventEqIdx] = solvent_perf_rates_state[perf];
             }
@@ -2131,7 +2285,7 @@ namespace Opm
             }
             for (int perf = 0; perf < nperf; ++perf) {
                 const int cell_idx = well_cells_[perf];
-                const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+                const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
                 const auto& fs = intQuants.fluidState();
                 const double well_tw_fraction = well_index_[perf] / total_tw;
                 double total_mobility = 0.0;
@@ -2168,6 +2322,13 @@ namespace Opm
     computeWellConnectionPressures(const Simulator& ebosSimulator,
                                    const WellState& well_state)
     {
+         // 0. The densities and pressure differences only depend on the pressures
+         //    and rates of the well and on the perforated cells, they are reused
+         //    as long as these did not change.
+         if (!connectionPressureInputsChanged(ebosSimulator, well_state)) {
+             return;
+         }
+
          // 1. Compute properties required by computeConnectionPressureDelta().
          //    Note that some of the complexity of this part is due to the function
          //    taking std::vector<double> arguments, and not Eigen objects.
@@ -2183,6 +2344,72 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    bool
+    StandardWell<TypeTag>::
+    connectionPressureInputsChanged(const Simulator& ebosSimulator,
+                                    const WellState& well_state)
+    {
+        // the computation communicates for distributed wells, so all the
+        // processes must do it
+        if (this->parallel_well_info_.communication().size() > 1) {
+            return true;
+        }
+
+        const int w = index_of_well_;
+        const int nperf = number_of_perforations_;
+        const int np = number_of_phases_;
+        const auto * perf_press = well_state.perfPress(w);
+        const auto * perf_rates = well_state.perfPhaseRates(w);
+        const auto& well_rates = well_state.wellRates(w);
+
+        // for producers without flow, the mixture is approximated from the
+        // mobilities of the cells, which are not tracked here
+        const bool all_zero = std::all_of(perf_rates, perf_rates + nperf * np,
+                                          [](double val) { return val == 0.0; });
+        if (all_zero && this->isProducer()) {
+            connection_pressure_inputs_.clear();
+            return true;
+        }
+
+        std::vector<double> inputs;
+        inputs.reserve(1 + np + (np + 3) * nperf);
+        inputs.push_back(well_state.bhp(w));
+        inputs.insert(inputs.end(), well_rates.begin(), well_rates.end());
+        inputs.insert(inputs.end(), perf_press, perf_press + nperf);
+        inputs.insert(inputs.end(), perf_rates, perf_rates + nperf * np);
+        for (int perf = 0; perf < nperf; ++perf) {
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(well_cells_[perf]));
+            const auto& fs = intQuants.fluidState();
+            inputs.push_back(fs.temperature(FluidSystem::oilPhaseIdx).value());
+            inputs.push_back(fs.saltConcentration().value());
+            if constexpr (has_solvent) {
+                inputs.push_back(intQuants.solventInverseFormationVolumeFactor().value());
+            }
+        }
+        if constexpr (has_solvent) {
+            inputs.push_back(well_state.solventWellRate(w));
+            const auto * solvent_perf_rates = well_state.perfRateSolvent(w);
+            inputs.insert(inputs.end(), solvent_perf_rates, solvent_perf_rates + nperf);
+        }
+
+        bool changed = inputs.size() != connection_pressure_inputs_.size();
+        const double tol = param_.well_connection_pressure_tolerance_;
+        for (std::size_t i = 0; !changed && i < inputs.size(); ++i) {
+            const double a = inputs[i];
+            const double b = connection_pressure_inputs_[i];
+            changed = std::abs(a - b) > tol * std::max(std::abs(a), std::abs(b));
+        }
+        if (changed) {
+            connection_pressure_inputs_ = std::move(inputs);
+        }
+        return changed;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2244,6 +2471,42 @@ namespace Opm
             // Contributions are already in the matrix itself
             return;
         }
+        if ( !fusedCells_.empty() )
+        {
+            // Ax = Ax - C^T D^-1 B x using the packed matrices. The order of
+            // the operations is the same as for the matrix products below.
+            const std::size_t blockSize = numWellEq_ * numEq;
+            const std::size_t nperf = fusedCells_.size();
+            Scalar* Bx = fusedWork_.data();
+            Scalar* invDBx = Bx + numWellEq_;
+            std::fill(fusedWork_.begin(), fusedWork_.end(), 0.0);
+            for (std::size_t perf = 0; perf < nperf; ++perf) {
+                const auto& xc = x[fusedCells_[perf]];
+                const Scalar* B = fusedB_.data() + perf * blockSize;
+                for (int w = 0; w < numWellEq_; ++w) {
+                    for (int e = 0; e < numEq; ++e) {
+                        Bx[w] += B[w * numEq + e] * xc[e];
+                    }
+                }
+            }
+            const auto& invD = invDuneD_[0][0];
+            for (int w = 0; w < numWellEq_; ++w) {
+                for (int k = 0; k < numWellEq_; ++k) {
+                    invDBx[w] += invD[w][k] * Bx[k];
+                }
+            }
+            for (std::size_t perf = 0; perf < nperf; ++perf) {
+                auto& Axc = Ax[fusedCells_[perf]];
+                const Scalar* C = fusedC_.data() + perf * blockSize;
+                for (int w = 0; w < numWellEq_; ++w) {
+                    for (int e = 0; e < numEq; ++e) {
+                        Axc[e] -= C[w * numEq + e] * invDBx[w];
+                    }
+                }
+            }
+            return;
+        }
+
         assert( Bx_.size() == duneB_.N() );
         assert( invDrw_.size() == invDuneD_.N() );
 
@@ -2278,7 +2541,7 @@ namespace Opm
         duneC_.mmtv(invDrw_, r);
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_ROCSPARSE
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2389,20 +2652,21 @@ namespace Opm
         well_flux.resize(np, 0.0);
 
         const bool allow_cf = getAllowCrossFlow();
+        const std::vector<EvalWell> cmix_s = wellSurfaceVolumeFractions();
 
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             // flux for each perforation
             std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.});
-            getMobility(ebosSimulator, perf, mob, deferred_logger);
+            getMobility(ebosSimulator, perf, cmix_s, mob, deferred_logger);
             double trans_mult = ebosSimulator.problem().template rockCompTransMultiplier<double>(intQuants, cell_idx);
             const double Tw = well_index_[perf] * trans_mult;
 
             std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.});
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
-            computePerfRate(intQuants, mob, EvalWell(numWellEq_ + numEq, bhp), Tw, perf, allow_cf,
+            computePerfRate(intQuants, mob, EvalWell(numWellEq_ + numEq, bhp), cmix_s, Tw, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate, deferred_logger);
 
             for(int p = 0; p < np; ++p) {
@@ -2419,14 +2683,15 @@ namespace Opm
     StandardWell<TypeTag>::
     computeWellRatesWithBhpPotential(const Simulator& ebosSimulator,
                             const double& bhp,
+                            const WellState& well_state,
                             std::vector<double>& well_flux,
                             DeferredLogger& deferred_logger)
     {
 
         // iterate to get a more accurate well density
-        // create a copy of the well_state to use. If the operability checking is sucessful, we use this one
-        // to replace the original one
-        WellState well_state_copy = ebosSimulator.problem().wellModel().wellState();
+        // create a copy of the given well_state to use, the potentials of
+        // several wells may be computed concurrently from the same state
+        WellState well_state_copy = well_state;
         const auto& group_state  = ebosSimulator.problem().wellModel().groupState();
 
         //  Set current control to bhp, and bhp value in state, modify bhp limit in control object.
@@ -2724,7 +2989,7 @@ namespace Opm
             // get the bhp value based on the bhp constraints
             const double bhp = well.mostStrictBhpFromBhpLimits(summaryState);
             assert(std::abs(bhp) != std::numeric_limits<double>::max());
-            well.computeWellRatesWithBhpPotential(ebosSimulator, bhp, well_potentials, deferred_logger);
+            well.computeWellRatesWithBhpPotential(ebosSimulator, bhp, well_state, well_potentials, deferred_logger);
         } else {
             // the well has a THP related constraint
             well_potentials = well.computeWellPotentialWithTHP(ebosSimulator, deferred_logger, well_state);
@@ -2833,8 +3098,8 @@ namespace Opm
         // other primary variables related to polymer injection
         if constexpr (Base::has_polymermw) {
             if (this->isInjector()) {
-                const auto * water_velocity = &well_state.perfWaterVelocity()[first_perf_];
-                const auto * skin_pressure = &well_state.perfSkinPressure()[first_perf_];
+                const auto * water_velocity = well_state.perfWaterVelocity(index_of_well_);
+                const auto * skin_pressure = well_state.perfSkinPressure(index_of_well_);
                 for (int perf = 0; perf < number_of_perforations_; ++perf) {
                     primary_variables_[Bhp + 1 + perf] = water_velocity[perf];
                     primary_variables_[Bhp + 1 + number_of_perforations_ + perf] = skin_pressure[perf];
@@ -2907,11 +3172,12 @@ namespace Opm
     StandardWell<TypeTag>::
     updateWaterMobilityWithPolymer(const Simulator& ebos_simulator,
                                    const int perf,
+                                   const std::vector<EvalWell>& cmix_s,
                                    std::vector<EvalWell>& mob,
                                    DeferredLogger& deferred_logger) const
     {
         const int cell_idx = well_cells_[perf];
-        const auto& int_quant = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+        const auto& int_quant = *(ebos_simulator.problem().cachedIntensiveQuantities(cell_idx));
         const EvalWell polymer_concentration = extendEval(int_quant.polymerConcentration());
 
         // TODO: not sure should based on the well type or injecting/producing peforations
@@ -2939,7 +3205,7 @@ namespace Opm
             double perf_vap_oil_rate = 0.;
             double trans_mult = ebos_simulator.problem().template rockCompTransMultiplier<double>(int_quant, cell_idx);
             const double Tw = well_index_[perf] * trans_mult;
-            computePerfRate(int_quant, mob, bhp, Tw, perf, allow_cf,
+            computePerfRate(int_quant, mob, bhp, cmix_s, Tw, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate, deferred_logger);
             // TODO: make area a member
             const double area = 2 * M_PI * perf_rep_radius_[perf] * perf_length_[perf];
@@ -2967,6 +3233,19 @@ namespace Opm
         }
     }
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::addWellSystemBlocks(std::vector<Helper::WellSystemBlocks>& blocks) const
+    {
+        Helper::WellSystemBlocks well;
+        well.name = this->name();
+        well.B = Helper::SparseBlockMatrix::from(duneB_);
+        well.C = Helper::SparseBlockMatrix::from(duneC_);
+        well.D = Helper::SparseBlockMatrix::from(invDuneD_);
+        well.inverseD = true;
+        blocks.push_back(std::move(well));
+    }
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::addWellContributions(SparseMatrixAdapter& jacobian) const
@@ -2976,21 +3255,67 @@ namespace Opm
         // D is diagonal
         // B and C have 1 row, nc colums and nonzero
         // at (0,j) only if this well has a perforation at cell j.
+        // D^-1 B_j is the same for all the rows, compute it once per perforation.
+        std::vector<Dune::DynamicMatrix<Scalar>> invDB(duneB_[0].size());
+        auto invDB_j = invDB.begin();
+        for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB, ++invDB_j )
+        {
+            Detail::multMatrix(invDuneD_[0][0], (*colB), *invDB_j);
+        }
+
         typename SparseMatrixAdapter::MatrixBlock tmpMat;
-        Dune::DynamicMatrix<Scalar> tmp;
         for ( auto colC = duneC_[0].begin(), endC = duneC_[0].end(); colC != endC; ++colC )
         {
             const auto row_index = colC.index();
 
-            for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB )
+            invDB_j = invDB.begin();
+            for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB, ++invDB_j )
             {
-                Detail::multMatrix(invDuneD_[0][0],  (*colB), tmp);
-                Detail::negativeMultMatrixTransposed((*colC), tmp, tmpMat);
+                Detail::negativeMultMatrixTransposed((*colC), *invDB_j, tmpMat);
                 jacobian.addToBlock( row_index, colB.index(), tmpMat );
             }
         }
     }
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::addWellContributionsToPreconditioner(typename SparseMatrixAdapter::IstlMatrix& mat) const
+    {
+        // As addWellContributions(), but the blocks between perforated cells
+        // which are not coupled in the matrix, i.e. which are not neighbours
+        // in the grid, are lumped into the diagonal block of their row. The
+        // sparsity pattern, and with it the fill-in of the preconditioner,
+        // stays that of the reservoir.
+        std::vector<Dune::DynamicMatrix<Scalar>> invDB(duneB_[0].size());
+        auto invDB_j = invDB.begin();
+        for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB, ++invDB_j )
+        {
+            Detail::multMatrix(invDuneD_[0][0], (*colB), *invDB_j);
+        }
+
+        typename SparseMatrixAdapter::MatrixBlock tmpMat;
+        for ( auto colC = duneC_[0].begin(), endC = duneC_[0].end(); colC != endC; ++colC )
+        {
+            auto& row = mat[colC.index()];
+            const auto diag = row.find(colC.index());
+            if (diag == row.end()) {
+                continue;
+            }
+
+            invDB_j = invDB.begin();
+            for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB, ++invDB_j )
+            {
+                Detail::negativeMultMatrixTransposed((*colC), *invDB_j, tmpMat);
+                const auto entry = row.find(colB.index());
+                if (entry != row.end()) {
+                    *entry += tmpMat;
+                } else {
+                    *diag += tmpMat;
+                }
+            }
+        }
+    }
+
 
 
 
@@ -3202,7 +3527,7 @@ namespace Opm
     {
         if constexpr (Base::has_polymermw) {
             if (this->isInjector()) {
-                auto * perf_water_throughput = &well_state.perfThroughput()[first_perf_];
+                auto * perf_water_throughput = well_state.perfThroughput(index_of_well_);
                 for (int perf = 0; perf < number_of_perforations_; ++perf) {
                     const double perf_water_vel = primary_variables_[Bhp + 1 + perf];
                     // we do not consider the formation damage due to water flowing from reservoir into wellbore
@@ -3226,7 +3551,7 @@ namespace Opm
                           std::vector<EvalWell>& cq_s) const
     {
         const int cell_idx = well_cells_[perf];
-        const auto& int_quants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+        const auto& int_quants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
         const auto& fs = int_quants.fluidState();
         const EvalWell b_w = extendEval(fs.invB(FluidSystem::waterPhaseIdx));
         const double area = M_PI * bore_diameters_[perf] * perf_length_[perf];
@@ -3251,7 +3576,7 @@ namespace Opm
                                DeferredLogger& deferred_logger)
     {
         const int cell_idx = well_cells_[perf];
-        const auto& int_quants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+        const auto& int_quants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
         const auto& fs = int_quants.fluidState();
         const EvalWell b_w = extendEval(fs.invB(FluidSystem::waterPhaseIdx));
         const EvalWell water_flux_r = water_flux_s / b_w;
@@ -3263,7 +3588,7 @@ namespace Opm
         const EvalWell eq_wat_vel = primary_variables_evaluation_[wat_vel_index] - water_velocity;
         resWell_[0][wat_vel_index] = eq_wat_vel.value();
 
-        const auto * perf_water_throughput = &well_state.perfThroughput()[this->first_perf_];
+        const auto * perf_water_throughput = well_state.perfThroughput(this->index_of_well_);
         const double throughput = perf_water_throughput[perf];
         const int pskin_index = Bhp + 1 + number_of_perforations_ + perf;
 
@@ -3442,7 +3767,7 @@ namespace Opm
             const int wat_vel_index = Bhp + 1 + perf;
             const EvalWell water_velocity = primary_variables_evaluation_[wat_vel_index];
             if (water_velocity > 0.) { // injecting
-                const auto * perf_water_throughput = &well_state.perfThroughput()[this->first_perf_];
+                const auto * perf_water_throughput = well_state.perfThroughput(this->index_of_well_);
                 const double throughput = perf_water_throughput[perf];
                 const EvalWell molecular_weight = wpolymermw(throughput, water_velocity, deferred_logger);
                 cq_s_polymw *= molecular_weight;
@@ -3557,62 +3882,90 @@ namespace Opm
             return rates;
         };
 
-        // Get the flo samples, add extra samples at low rates and bhp
-        // limit point if necessary. Then the sign must be flipped
-        // since the VFP code expects that production flo values are
-        // negative.
-        std::vector<double> flo_samples = table.getFloAxis();
-        if (flo_samples[0] > 0.0) {
-            const double f0 = flo_samples[0];
-            flo_samples.insert(flo_samples.begin(), { f0/20.0, f0/10.0, f0/5.0, f0/2.0 });
-        }
-        const double flo_bhp_limit = -flo(frates(controls.bhp_limit));
-        if (flo_samples.back() < flo_bhp_limit) {
-            flo_samples.push_back(flo_bhp_limit);
-        }
-        for (double& x : flo_samples) {
-            x = -x;
-        }
-
-        // Find bhp values for inflow relation corresponding to flo samples.
-        std::vector<double> bhp_samples;
-        for (double flo_sample : flo_samples) {
-            if (flo_sample < -flo_bhp_limit) {
-                // We would have to go under the bhp limit to obtain a
-                // flow of this magnitude. We associate all such flows
-                // with simply the bhp limit. The first one
-                // encountered is considered valid, the rest not. They
-                // are therefore skipped.
-                bhp_samples.push_back(controls.bhp_limit);
-                break;
-            }
-            auto eq = [&flo, &frates, flo_sample](double bhp) {
-                return flo(frates(bhp)) - flo_sample;
-            };
-            // TODO: replace hardcoded low/high limits.
-            const double low = 10.0 * unit::barsa;
-            const double high = 600.0 * unit::barsa;
-            const int max_iteration = 50;
-            const double flo_tolerance = 1e-6 * std::fabs(flo_samples.back());
-            int iteration = 0;
-            try {
-                const double solved_bhp = RegulaFalsiBisection<>::
-                    solve(eq, low, high, max_iteration, flo_tolerance, iteration);
-                bhp_samples.push_back(solved_bhp);
+        // The rates at the bhp limit, they also identify the state in
+        // which the inflow relation was last sampled.
+        const std::vector<double> rates_bhp_limit = frates(controls.bhp_limit);
+        const double flo_bhp_limit = -flo(rates_bhp_limit);
+        auto& samples = inflow_samples_;
+        const bool reuse_samples = samples.vfp_table == controls.vfp_table_number
+            && samples.bhp_limit == controls.bhp_limit
+            && samples.rates_at_bhp_limit == rates_bhp_limit;
+        if (!reuse_samples) {
+            // Get the flo samples, add extra samples at low rates and bhp
+            // limit point if necessary. Then the sign must be flipped
+            // since the VFP code expects that production flo values are
+            // negative.
+            std::vector<double> flo_samples = table.getFloAxis();
+            if (flo_samples[0] > 0.0) {
+                const double f0 = flo_samples[0];
+                flo_samples.insert(flo_samples.begin(), { f0/20.0, f0/10.0, f0/5.0, f0/2.0 });
+            }
+            if (flo_samples.back() < flo_bhp_limit) {
+                flo_samples.push_back(flo_bhp_limit);
+            }
+            for (double& x : flo_samples) {
+                x = -x;
+            }
+
+            // Find bhp values for inflow relation corresponding to flo samples.
+            std::vector<double> bhp_samples;
+            for (double flo_sample : flo_samples) {
+                if (flo_sample < -flo_bhp_limit) {
+                    // We would have to go under the bhp limit to obtain a
+                    // flow of this magnitude. We associate all such flows
+                    // with simply the bhp limit. The first one
+                    // encountered is considered valid, the rest not. They
+                    // are therefore skipped.
+                    bhp_samples.push_back(controls.bhp_limit);
+                    break;
+                }
+                auto eq = [&flo, &frates, flo_sample](double bhp) {
+                    return flo(frates(bhp)) - flo_sample;
+                };
+                // TODO: replace hardcoded low/high limits.
+                const double low = 10.0 * unit::barsa;
+                const double high = 600.0 * unit::barsa;
+                const int max_iteration = 50;
+                const double flo_tolerance = 1e-6 * std::fabs(flo_samples.back());
+                int iteration = 0;
+                try {
+                    const double solved_bhp = RegulaFalsiBisection<>::
+                        solve(eq, low, high, max_iteration, flo_tolerance, iteration);
+                    bhp_samples.push_back(solved_bhp);
+                }
+                catch (...) {
+                    // Use previous value (or max value if at start) if we failed.
+                    bhp_samples.push_back(bhp_samples.empty() ? high : bhp_samples.back());
+                    deferred_logger.warning("FAILED_ROBUST_BHP_THP_SOLVE_EXTRACT_SAMPLES",
+                                            "Robust bhp(thp) solve failed extracting bhp values at flo samples for well " + name());
+                }
             }
-            catch (...) {
-                // Use previous value (or max value if at start) if we failed.
-                bhp_samples.push_back(bhp_samples.empty() ? high : bhp_samples.back());
-                deferred_logger.warning("FAILED_ROBUST_BHP_THP_SOLVE_EXTRACT_SAMPLES",
-                                        "Robust bhp(thp) solve failed extracting bhp values at flo samples for well " + name());
+
+            // The inflow rates at the bhp samples, the VFP relation is evaluated at these.
+            std::vector<std::vector<double>> rates_samples;
+            rates_samples.reserve(bhp_samples.size());
+            for (const double bhp_sample : bhp_samples) {
+                rates_samples.push_back(frates(bhp_sample));
             }
+
+            // A well without any flow at the bhp limit does not identify the state.
+            const bool flowing = std::any_of(rates_bhp_limit.begin(), rates_bhp_limit.end(),
+                                             [](const double rate) { return rate != 0.0; });
+            samples.vfp_table = flowing ? controls.vfp_table_number : -1;
+            samples.bhp_limit = controls.bhp_limit;
+            samples.rates_at_bhp_limit = rates_bhp_limit;
+            samples.flo_samples = std::move(flo_samples);
+            samples.bhp_samples = std::move(bhp_samples);
+            samples.rates_samples = std::move(rates_samples);
         }
+        const std::vector<double>& flo_samples = samples.flo_samples;
+        const std::vector<double>& bhp_samples = samples.bhp_samples;
 
         // Find bhp values for VFP relation corresponding to flo samples.
         const int num_samples = bhp_samples.size(); // Note that this can be smaller than flo_samples.size()
         std::vector<double> fbhp_samples(num_samples);
         for (int ii = 0; ii < num_samples; ++ii) {
-            fbhp_samples[ii] = fbhp(frates(bhp_samples[ii]));
+            fbhp_samples[ii] = fbhp(samples.rates_samples[ii]);
         }
 // #define EXTRA_THP_DEBUGGING
 #ifdef EXTRA_THP_DEBUGGING
@@ -3937,17 +4290,18 @@ namespace Opm
         std::vector<EvalWell> well_q_s(num_components_, {numWellEq_ + numEq, 0.});
         const EvalWell& bhp = getBhp();
         const bool allow_cf = getAllowCrossFlow() || openCrossFlowAvoidSingularity(ebosSimulator);
+        const std::vector<EvalWell> cmix_s = wellSurfaceVolumeFractions();
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.});
-            getMobility(ebosSimulator, perf, mob, deferred_logger);
+            getMobility(ebosSimulator, perf, cmix_s, mob, deferred_logger);
             std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.});
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
             double trans_mult = ebosSimulator.problem().template rockCompTransMultiplier<double>(intQuants,  cell_idx);
             const double Tw = well_index_[perf] * trans_mult;
-            computePerfRate(intQuants, mob, bhp, Tw, perf, allow_cf,
+            computePerfRate(intQuants, mob, bhp, cmix_s, Tw, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate, deferred_logger);
             for (int comp = 0; comp < num_components_; ++comp) {
                 well_q_s[comp] += cq_s[comp];
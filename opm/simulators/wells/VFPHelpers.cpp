@@ -27,6 +27,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPInjTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
@@ -108,14 +109,12 @@ InterpData findInterpData(const double value_in, const std::vector<double>& valu
             retval.ind_[1] = nvalues-1;
         }
         else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
-            }
+            //Search internal intervals, the axis values are sorted.
+            //The first value not less than value ends the interval.
+            const auto it = std::lower_bound(values.begin() + 1, values.end(), value);
+            const int i = it - values.begin();
+            retval.ind_[0] = i-1;
+            retval.ind_[1] = i;
         }
 
         const double start = values[retval.ind_[0]];
@@ -24,6 +24,7 @@
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
 
 #include <opm/grid/CpGrid.hpp>
+#include <opm/grid/utility/cartesianToCompressed.hpp>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 
@@ -48,15 +49,8 @@ public:
         const auto& globalCell = grid.globalCell();
         const auto& cartesianSize = grid.logicalCartesianSize();
 
-        auto size = cartesianSize[0]*cartesianSize[1]*cartesianSize[2];
-
-        std::vector<int> cartesianToCompressed(size, -1);
-        auto begin = globalCell.begin();
-
-        for ( auto cell = begin, end= globalCell.end(); cell != end; ++cell )
-        {
-          cartesianToCompressed[ *cell ] = cell - begin;
-        }
+        const auto cartesianToCompressedMap = cartesianToCompressed(globalCell.size(),
+                                                                    globalCell.data());
 
         const auto& schedule_wells = schedule.getWellsatEnd();
         wells_.reserve(schedule_wells.size());
@@ -76,11 +70,11 @@ public:
                 int j = completion.getJ();
                 int k = completion.getK();
                 int cart_grid_idx = i + cartesianSize[0]*(j + cartesianSize[1]*k);
-                int compressed_idx = cartesianToCompressed[cart_grid_idx];
+                const auto compressed = cartesianToCompressedMap.find(cart_grid_idx);
 
-                if ( compressed_idx >= 0 ) // Ignore completions in inactive/remote cells.
+                if ( compressed != cartesianToCompressedMap.end() ) // Ignore completions in inactive/remote cells.
                 {
-                    compressed_well_perforations.push_back(compressed_idx);
+                    compressed_well_perforations.push_back(compressed->second);
                 }
             }
 
@@ -33,8 +33,14 @@
 #include <opm/simulators/wells/WellState.hpp>
 #include <opm/simulators/wells/WellContainer.hpp>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <optional>
 #include <set>
 #include <stack>
 
@@ -424,6 +430,72 @@ namespace WellGroupHelpers
     }
 
 
+    namespace {
+
+    // Sum the phase rates of the wells in group and in all its subgroups, as
+    // sumWellPhaseRates() does for one phase, for all phases in one bottom-up
+    // pass over the group tree. The sums of every group in the tree are passed
+    // to store(group, sums), subgroups before their parents.
+    template <class StoreFunc>
+    std::vector<double> sumWellPhaseRatesBottomUp(const WellContainer<std::vector<double>>& rates,
+                                                  const Group& group,
+                                                  const Schedule& schedule,
+                                                  const WellState& wellState,
+                                                  const int reportStepIdx,
+                                                  const bool injector,
+                                                  StoreFunc& store)
+    {
+        const int np = wellState.numPhases();
+        std::vector<double> sums(np, 0.0);
+        for (const std::string& groupName : group.groups()) {
+            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
+            const auto subGroupSums
+                = sumWellPhaseRatesBottomUp(rates, groupTmp, schedule, wellState, reportStepIdx, injector, store);
+            for (int phase = 0; phase < np; ++phase) {
+                sums[phase] += subGroupSums[phase];
+            }
+        }
+        const auto& end = wellState.wellMap().end();
+
+        for (const std::string& wellName : group.wells()) {
+            const auto& it = wellState.wellMap().find(wellName);
+            if (it == end) // the well is not found
+                continue;
+
+            int well_index = it->second[0];
+
+            if (! wellState.wellIsOwned(well_index, wellName) ) // Only sum once
+            {
+                continue;
+            }
+
+            const auto& wellEcl = schedule.getWell(wellName, reportStepIdx);
+            // only count producers or injectors
+            if ((wellEcl.isProducer() && injector) || (wellEcl.isInjector() && !injector))
+                continue;
+
+            if (wellEcl.getStatus() == Well::Status::SHUT)
+                continue;
+
+            double factor = wellEcl.getEfficiencyFactor();
+            const auto& well_rates = rates[well_index];
+            for (int phase = 0; phase < np; ++phase) {
+                if (injector)
+                    sums[phase] += factor * well_rates[phase];
+                else
+                    sums[phase] -= factor * well_rates[phase];
+            }
+        }
+        const auto& gefac = group.getGroupEfficiencyFactor();
+        for (double& sum : sums) {
+            sum *= gefac;
+        }
+        store(group, sums);
+        return sums;
+    }
+
+    } // anonymous namespace
+
     void updateVREPForGroups(const Group& group,
                              const Schedule& schedule,
                              const int reportStepIdx,
@@ -431,22 +503,15 @@ namespace WellGroupHelpers
                              WellState& wellState,
                              GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateVREPForGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
-        }
-        const int np = wellState.numPhases();
-        double resv = 0.0;
-        for (int phase = 0; phase < np; ++phase) {
-            resv += sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                      group,
-                                      schedule,
-                                      wellState,
-                                      reportStepIdx,
-                                      phase,
-                                      /*isInjector*/ false);
-        }
-        group_state.update_injection_vrep_rate(group.name(), resv);
+        auto store = [&group_state](const Group& groupTmp, const std::vector<double>& rates) {
+            double resv = 0.0;
+            for (const double rate : rates) {
+                resv += rate;
+            }
+            group_state.update_injection_vrep_rate(groupTmp.name(), resv);
+        };
+        sumWellPhaseRatesBottomUp(wellStateNupcol.wellReservoirRates(), group, schedule, wellState,
+                                  reportStepIdx, /*isInjector*/ false, store);
     }
 
     void updateReservoirRatesInjectionGroups(const Group& group,
@@ -456,22 +521,11 @@ namespace WellGroupHelpers
                                              WellState& wellState,
                                              GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateReservoirRatesInjectionGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
-        }
-        const int np = wellState.numPhases();
-        std::vector<double> resv(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            resv[phase] = sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                            group,
-                                            schedule,
-                                            wellState,
-                                            reportStepIdx,
-                                            phase,
-                                            /*isInjector*/ true);
-        }
-        group_state.update_injection_reservoir_rates(group.name(), resv);
+        auto store = [&group_state](const Group& groupTmp, const std::vector<double>& resv) {
+            group_state.update_injection_reservoir_rates(groupTmp.name(), resv);
+        };
+        sumWellPhaseRatesBottomUp(wellStateNupcol.wellReservoirRates(), group, schedule, wellState,
+                                  reportStepIdx, /*isInjector*/ true, store);
     }
 
     void updateWellRates(const Group& group,
@@ -512,17 +566,11 @@ namespace WellGroupHelpers
                                     WellState& wellState,
                                     GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateGroupProductionRates(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
-        }
-        const int np = wellState.numPhases();
-        std::vector<double> rates(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rates[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
-        }
-        group_state.update_production_rates(group.name(), rates);
+        auto store = [&group_state](const Group& groupTmp, const std::vector<double>& rates) {
+            group_state.update_production_rates(groupTmp.name(), rates);
+        };
+        sumWellPhaseRatesBottomUp(wellStateNupcol.wellRates(), group, schedule, wellState,
+                                  reportStepIdx, /*isInjector*/ false, store);
     }
 
 
@@ -535,28 +583,43 @@ namespace WellGroupHelpers
                              WellState& wellState,
                              GroupState& group_state)
     {
-        const int np = wellState.numPhases();
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateREINForGroups(groupTmp, schedule, reportStepIdx, pu, st, wellStateNupcol, wellState, group_state);
-        }
+        auto store = [&schedule, reportStepIdx, &pu, &st, &group_state](const Group& groupTmp,
+                                                                       const std::vector<double>& rates) {
+            std::vector<double> rein = rates;
+
+            // add import rate and substract consumption rate for group for gas
+            if (schedule[reportStepIdx].gconsump().has(groupTmp.name())) {
+                const auto& gconsump = schedule[reportStepIdx].gconsump().get(groupTmp.name(), st);
+                if (pu.phase_used[BlackoilPhases::Vapour]) {
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] += gconsump.import_rate;
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] -= gconsump.consumption_rate;
+                }
+            }
+
+            group_state.update_injection_rein_rates(groupTmp.name(), rein);
+        };
+        sumWellPhaseRatesBottomUp(wellStateNupcol.wellRates(), group, schedule, wellState,
+                                  reportStepIdx, /*isInjector*/ false, store);
+    }
+
+
 
-        std::vector<double> rein(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rein[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
-        }
 
-        // add import rate and substract consumption rate for group for gas
-        if (schedule[reportStepIdx].gconsump().has(group.name())) {
-            const auto& gconsump = schedule[reportStepIdx].gconsump().get(group.name(), st);
-            if (pu.phase_used[BlackoilPhases::Vapour]) {
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] += gconsump.import_rate;
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] -= gconsump.consumption_rate;
+    std::vector<std::string>
+    networkNodesRootToChild(const Opm::Network::ExtNetwork& network)
+    {
+        std::stack<std::string> children;
+        std::vector<std::string> root_to_child_nodes;
+        children.push(network.root().name());
+        while (!children.empty()) {
+            const auto node = children.top();
+            children.pop();
+            root_to_child_nodes.push_back(node);
+            for (const auto& branch : network.downtree_branches(node)) {
+                children.push(branch.downtree_node());
             }
         }
-
-        group_state.update_injection_rein_rates(group.name(), rein);
+        return root_to_child_nodes;
     }
 
 
@@ -568,7 +631,9 @@ namespace WellGroupHelpers
                             const GroupState& group_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step)
+                            const int report_time_step,
+                            const std::map<std::string, NetworkLeafIpr>& leaf_iprs,
+                            const int max_newton_iterations)
     {
         // TODO: Only dealing with production networks for now.
 
@@ -578,105 +643,179 @@ namespace WellGroupHelpers
 
         // Fixed pressure nodes of the network are the roots of trees.
         // Leaf nodes must correspond to groups in the group structure.
-        // Let us first find all leaf nodes of the network. We also
-        // create a vector of all nodes, ordered so that a child is
-        // always after its parent.
-        std::stack<std::string> children;
-        std::set<std::string> leaf_nodes;
-        std::vector<std::string> root_to_child_nodes;
-        children.push(network.root().name());
-        while (!children.empty()) {
-            const auto node = children.top();
-            children.pop();
-            root_to_child_nodes.push_back(node);
-            auto branches = network.downtree_branches(node);
-            if (branches.empty()) {
-                leaf_nodes.insert(node);
-            }
-            for (const auto& branch : branches) {
-                children.push(branch.downtree_node());
-            }
+        // All nodes are numbered so that a child is always after its
+        // parent, and the branch data is looked up once.
+        const auto root_to_child_nodes = networkNodesRootToChild(network);
+        const int num_nodes = root_to_child_nodes.size();
+        std::map<std::string, int> node_index;
+        for (int i = 0; i < num_nodes; ++i) {
+            node_index[root_to_child_nodes[i]] = i;
         }
-        assert(children.empty());
-
-        // Starting with the leaf nodes of the network, get the flow rates
-        // from the corresponding groups.
-        std::map<std::string, std::vector<double>> node_inflows;
-        for (const auto& node : leaf_nodes) {
-            node_inflows[node] = group_state.production_rates(node);
-            // Add the ALQ amounts to the gas rates if requested.
-            if (network.node(node).add_gas_lift_gas()) {
-                const auto& group = schedule.getGroup(node, report_time_step);
-                for (const std::string& wellname : group.wells()) {
-                    node_inflows[node][BlackoilPhases::Vapour] += well_state.getALQ(wellname);
+        std::vector<int> up_node(num_nodes, -1);
+        std::vector<int> vfp_table(num_nodes, -1);
+        std::vector<std::optional<double>> fixed_pressure(num_nodes);
+        std::vector<std::vector<double>> leaf_rates(num_nodes);
+        std::vector<const NetworkLeafIpr*> leaf_ipr(num_nodes, nullptr);
+        for (int i = 0; i < num_nodes; ++i) {
+            const auto& node = root_to_child_nodes[i];
+            fixed_pressure[i] = network.node(node).terminal_pressure();
+            const auto upbranch = network.uptree_branch(node);
+            if (upbranch) {
+                up_node[i] = node_index.at((*upbranch).uptree_node());
+                const auto table = (*upbranch).vfp_table();
+                if (table) {
+                    vfp_table[i] = *table;
+                }
+            }
+            if (network.downtree_branches(node).empty()) {
+                // Starting with the leaf nodes of the network, get the flow rates
+                // from the corresponding groups.
+                leaf_rates[i] = group_state.production_rates(node);
+                // Add the ALQ amounts to the gas rates if requested.
+                if (network.node(node).add_gas_lift_gas()) {
+                    const auto& group = schedule.getGroup(node, report_time_step);
+                    for (const std::string& wellname : group.wells()) {
+                        leaf_rates[i][BlackoilPhases::Vapour] += well_state.getALQ(wellname);
+                    }
+                }
+                const auto it = leaf_iprs.find(node);
+                if (it != leaf_iprs.end()) {
+                    leaf_ipr[i] = &it->second;
                 }
             }
         }
 
-        // Accumulate in the network, towards the roots. Note that a
-        // root (i.e. fixed pressure node) can still be contributing
-        // flow towards other nodes in the network, i.e.  a node is
-        // the root of a subtree.
-        auto child_to_root_nodes = root_to_child_nodes;
-        std::reverse(child_to_root_nodes.begin(), child_to_root_nodes.end());
-        for (const auto& node : child_to_root_nodes) {
-            const auto upbranch = network.uptree_branch(node);
-            if (upbranch) {
-                // Add downbranch rates to upbranch.
-                std::vector<double>& up = node_inflows[(*upbranch).uptree_node()];
-                const std::vector<double>& down = node_inflows[node];
-                if (up.empty()) {
-                    up = down;
-                } else {
-                    assert (up.size() == down.size());
-                    for (size_t ii = 0; ii < up.size(); ++ii) {
-                        up[ii] += down[ii];
+        // Accumulate the rates in the network, towards the roots. Note
+        // that a root (i.e. fixed pressure node) can still be contributing
+        // flow towards other nodes in the network, i.e. a node is the root
+        // of a subtree. With pressures given, the leaf rates are estimated
+        // at these from the IPRs.
+        auto node_inflows = [&](const std::vector<double>* pressures) {
+            std::vector<std::vector<double>> inflows(num_nodes);
+            for (int i = num_nodes - 1; i >= 0; --i) {
+                if (!leaf_rates[i].empty()) {
+                    inflows[i] = leaf_rates[i];
+                    if (pressures && leaf_ipr[i]) {
+                        const auto& ipr = *leaf_ipr[i];
+                        assert(ipr.offset.size() == inflows[i].size());
+                        for (std::size_t ii = 0; ii < inflows[i].size(); ++ii) {
+                            inflows[i][ii] = std::max(0.0, inflows[i][ii] + ipr.offset[ii] - ipr.slope[ii] * (*pressures)[i]);
+                        }
+                    }
+                }
+                if (up_node[i] >= 0 && !inflows[i].empty()) {
+                    // Add downbranch rates to upbranch.
+                    std::vector<double>& up = inflows[up_node[i]];
+                    const std::vector<double>& down = inflows[i];
+                    if (up.empty()) {
+                        up = down;
+                    } else {
+                        assert (up.size() == down.size());
+                        for (size_t ii = 0; ii < up.size(); ++ii) {
+                            up[ii] += down[ii];
+                        }
                     }
                 }
             }
-        }
+            return inflows;
+        };
+
+        // The pressure at a node from the pressure of its uptree node and the
+        // rates through its branch, using VFP tables.
+        auto branch_pressure = [&](const int i, const double up_press, const std::vector<double>& node_rates) {
+            if (vfp_table[i] < 0) {
+                // Table number specified as 9999 in the deck, no pressure loss.
+                return up_press;
+            }
+            // The rates are here positive, but the VFP code expects the
+            // convention that production rates are negative.
+            assert(node_rates.size() == 3);
+            const double alq = 0.0; // TODO: Do not ignore ALQ
+            return vfp_prod_props.bhp(vfp_table[i],
+                                      -node_rates[BlackoilPhases::Aqua],
+                                      -node_rates[BlackoilPhases::Liquid],
+                                      -node_rates[BlackoilPhases::Vapour],
+                                      up_press,
+                                      alq);
+        };
 
         // Going the other way (from roots to leafs), calculate the pressure
-        // at each node using VFP tables and rates.
-        std::map<std::string, double> node_pressures;
-        for (const auto& node : root_to_child_nodes) {
-            auto press = network.node(node).terminal_pressure();
-            if (press) {
-                node_pressures[node] = *press;
-            } else {
-                const auto upbranch = network.uptree_branch(node);
-                assert(upbranch);
-                const double up_press = node_pressures[(*upbranch).uptree_node()];
-                const auto vfp_table = (*upbranch).vfp_table();
-                if (vfp_table) {
-                    // The rates are here positive, but the VFP code expects the
-                    // convention that production rates are negative, so we must
-                    // take a copy and flip signs.
-                    auto rates = node_inflows[node];
-                    for (auto& r : rates) { r *= -1.0; }
-                    assert(rates.size() == 3);
-                    const double alq = 0.0; // TODO: Do not ignore ALQ
-                    node_pressures[node] = vfp_prod_props.bhp(*vfp_table,
-                                                              rates[BlackoilPhases::Aqua],
-                                                              rates[BlackoilPhases::Liquid],
-                                                              rates[BlackoilPhases::Vapour],
-                                                              up_press,
-                                                              alq);
-#define EXTRA_DEBUG_NETWORK 0
-#if EXTRA_DEBUG_NETWORK
-                    std::ostringstream oss;
-                    oss << "parent: " << (*upbranch).uptree_node() << "  child: " << node
-                        << "  rates = [ " << rates[0]*86400 << ", " << rates[1]*86400 << ", " << rates[2]*86400 << " ]"
-                        << "  p(parent) = " << up_press/1e5 << "  p(child) = " << node_pressures[node]/1e5 << std::endl;
-                    OpmLog::debug(oss.str());
-#endif
+        // at each node using VFP tables and the current rates.
+        std::vector<double> pressures(num_nodes, 0.0);
+        {
+            const auto inflows = node_inflows(nullptr);
+            for (int i = 0; i < num_nodes; ++i) {
+                if (fixed_pressure[i]) {
+                    pressures[i] = *fixed_pressure[i];
                 } else {
-                    // Table number specified as 9999 in the deck, no pressure loss.
-                    node_pressures[node] = up_press;
+                    assert(up_node[i] >= 0);
+                    pressures[i] = branch_pressure(i, pressures[up_node[i]], inflows[i]);
+                }
+            }
+        }
+
+        // Solve for the node pressures at which the leaf rates from the IPRs
+        // and the branch pressure losses agree. The residual of a node is its
+        // pressure minus the one from its uptree node and branch rates, the
+        // Jacobian is computed by finite differences, as the network is
+        // small compared to the number of VFP table evaluations per residual.
+        const bool has_ipr = std::any_of(leaf_ipr.begin(), leaf_ipr.end(),
+                                         [](const NetworkLeafIpr* ipr) { return ipr != nullptr; });
+        if (has_ipr && max_newton_iterations > 0) {
+            auto residual = [&](const std::vector<double>& x) {
+                const auto inflows = node_inflows(&x);
+                Dune::DynamicVector<double> res(num_nodes);
+                for (int i = 0; i < num_nodes; ++i) {
+                    res[i] = x[i] - (fixed_pressure[i] ? *fixed_pressure[i]
+                                                       : branch_pressure(i, x[up_node[i]], inflows[i]));
+                }
+                return res;
+            };
+
+            constexpr double pressure_tolerance = 1.0e2; // Pa
+            std::vector<double> x = pressures;
+            Dune::DynamicMatrix<double> jacobian(num_nodes, num_nodes);
+            Dune::DynamicVector<double> dx(num_nodes);
+            bool converged = false;
+            try {
+                for (int iter = 0; iter <= max_newton_iterations; ++iter) {
+                    const auto res = residual(x);
+                    if (res.infinity_norm() < pressure_tolerance) {
+                        converged = true;
+                        break;
+                    }
+                    if (iter == max_newton_iterations) {
+                        break;
+                    }
+                    for (int j = 0; j < num_nodes; ++j) {
+                        const double eps = 1.0e-4 * std::max(std::abs(x[j]), 1.0e5);
+                        const double xj = x[j];
+                        x[j] += eps;
+                        const auto res_eps = residual(x);
+                        x[j] = xj;
+                        for (int i = 0; i < num_nodes; ++i) {
+                            jacobian[i][j] = (res_eps[i] - res[i]) / eps;
+                        }
+                    }
+                    jacobian.solve(dx, res);
+                    for (int i = 0; i < num_nodes; ++i) {
+                        x[i] -= dx[i];
+                    }
                 }
+            } catch (const Dune::FMatrixError&) {
+                converged = false;
+            }
+            // Otherwise the single pass is kept, which the Newton iterations
+            // of the reservoir settle as before.
+            if (converged) {
+                pressures = x;
             }
         }
 
+        std::map<std::string, double> node_pressures;
+        for (int i = 0; i < num_nodes; ++i) {
+            node_pressures[root_to_child_nodes[i]] = pressures[i];
+        }
         return node_pressures;
     }
 
@@ -915,6 +1054,17 @@ namespace WellGroupHelpers
         return total_guide_rate;
     }
     double FractionCalculator::guideRate(const std::string& name, const std::string& always_included_child)
+    {
+        auto key = std::make_pair(name, always_included_child);
+        auto it = guide_rate_cache_.find(key);
+        if (it != guide_rate_cache_.end()) {
+            return it->second;
+        }
+        const double guide_rate = computeGuideRate(name, always_included_child);
+        guide_rate_cache_.emplace(std::move(key), guide_rate);
+        return guide_rate;
+    }
+    double FractionCalculator::computeGuideRate(const std::string& name, const std::string& always_included_child)
     {
         if (schedule_.hasWell(name, report_step_)) {
             return guide_rate_->get(name, target_, getWellRateVector(well_state_, pu_, name));
@@ -939,8 +1089,15 @@ namespace WellGroupHelpers
     int FractionCalculator::groupControlledWells(const std::string& group_name,
                                                  const std::string& always_included_child)
     {
-        return ::Opm::WellGroupHelpers::groupControlledWells(
+        auto key = std::make_pair(group_name, always_included_child);
+        auto it = controlled_wells_cache_.find(key);
+        if (it != controlled_wells_cache_.end()) {
+            return it->second;
+        }
+        const int num_wells = ::Opm::WellGroupHelpers::groupControlledWells(
                                                              schedule_, well_state_, this->group_state_, report_step_, group_name, always_included_child, is_producer_, injection_phase_);
+        controlled_wells_cache_.emplace(std::move(key), num_wells);
+        return num_wells;
     }
 
     GuideRate::RateVector FractionCalculator::getGroupRateVector(const std::string& group_name)
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm
@@ -167,13 +168,32 @@ namespace WellGroupHelpers
                              WellState& wellState,
                              GroupState& group_state);
 
+    /// Linear estimate of the production rates of a leaf node of the network
+    /// at node pressure p, from the IPRs of the wells producing at THP
+    /// control: rates + offset - slope * p, where rates are the current ones.
+    struct NetworkLeafIpr
+    {
+        std::vector<double> offset;
+        std::vector<double> slope;
+    };
+
+    /// The nodes of the network, every node after its uptree node.
+    std::vector<std::string> networkNodesRootToChild(const Opm::Network::ExtNetwork& network);
+
+    /// Pressures of the network nodes. Without leaf IPRs, or with
+    /// max_newton_iterations == 0, this is a single pass from the fixed
+    /// pressure nodes with the current rates. Otherwise the node pressures
+    /// are solved for with Newton's method, such that the branch pressure
+    /// losses match the leaf rates estimated at the resulting pressures.
     std::map<std::string, double>
     computeNetworkPressures(const Opm::Network::ExtNetwork& network,
                             const WellState& well_state,
                             const GroupState& group_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step);
+                            const int report_time_step,
+                            const std::map<std::string, NetworkLeafIpr>& leaf_iprs = {},
+                            const int max_newton_iterations = 0);
 
     GuideRate::RateVector
     getWellRateVector(const WellState& well_state, const PhaseUsage& pu, const std::string& name);
@@ -232,6 +252,7 @@ namespace WellGroupHelpers
         double guideRate(const std::string& name, const std::string& always_included_child);
         int groupControlledWells(const std::string& group_name, const std::string& always_included_child);
         GuideRate::RateVector getGroupRateVector(const std::string& group_name);
+        double computeGuideRate(const std::string& name, const std::string& always_included_child);
         const Schedule& schedule_;
         const WellState& well_state_;
         const GroupState& group_state_;
@@ -241,6 +262,11 @@ namespace WellGroupHelpers
         const PhaseUsage& pu_;
         bool is_producer_;
         Phase injection_phase_;
+        // The states do not change during the lifetime of the calculator, so the
+        // guide rates and group controlled wells of the subtrees are computed once
+        // per (name, always_included_child) instead of once per level above them.
+        std::map<std::pair<std::string, std::string>, double> guide_rate_cache_;
+        std::map<std::pair<std::string, std::string>, int> controlled_wells_cache_;
     };
 
 
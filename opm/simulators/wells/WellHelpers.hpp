@@ -32,6 +32,7 @@
 #include <dune/istl/bcrsmatrix.hh>
 #include <dune/common/dynmatrix.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpitraits.hh>
 
 #include <vector>
 
@@ -187,6 +188,87 @@ namespace Opm {
             std::copy(pos, allEntries.end(), &(vec[0]));
         }
 
+        /// \brief Sums entries of the diagonal matrix and the residual of a
+        ///        distributed well without blocking.
+        ///
+        /// start() posts the reduction and finish() waits for it, the
+        /// process may do other work in between.
+        template<typename Scalar>
+        class NonblockingDistributedWellSum
+        {
+        public:
+            NonblockingDistributedWellSum() = default;
+            NonblockingDistributedWellSum(const NonblockingDistributedWellSum&) = delete;
+            NonblockingDistributedWellSum& operator=(const NonblockingDistributedWellSum&) = delete;
+
+            ~NonblockingDistributedWellSum()
+            {
+                wait_();
+            }
+
+            template<typename Comm>
+            void start(const Dune::DynamicMatrix<Scalar>& mat, const Dune::DynamicVector<Scalar>& vec,
+                       const Comm& comm)
+            {
+                // The previous sum may never have been finished, e.g. if the
+                // linearization threw before the end of the iteration. Its
+                // result is stale, but the buffer may not be touched before
+                // the request completed.
+                wait_();
+                entries_.clear();
+                entries_.reserve(mat.N()*mat.M()+vec.size());
+                for(const auto& row: mat)
+                {
+                    entries_.insert(entries_.end(), row.begin(), row.end());
+                }
+                entries_.insert(entries_.end(), vec.begin(), vec.end());
+#if HAVE_MPI
+                MPI_Iallreduce(MPI_IN_PLACE, entries_.data(), entries_.size(),
+                               Dune::MPITraits<Scalar>::getType(), MPI_SUM, comm, &request_);
+#else
+                comm.sum(entries_.data(), entries_.size());
+#endif
+                pending_ = true;
+            }
+
+            /// \brief Whether a sum was started and not finished yet.
+            bool pending() const
+            {
+                return pending_;
+            }
+
+            void finish(Dune::DynamicMatrix<Scalar>& mat, Dune::DynamicVector<Scalar>& vec)
+            {
+                wait_();
+                auto pos = entries_.begin();
+                auto cols = mat.cols();
+                for(auto&& row: mat)
+                {
+                    std::copy(pos, pos + cols, &(row[0]));
+                    pos += cols;
+                }
+                assert(std::size_t(entries_.end() - pos) == vec.size());
+                std::copy(pos, entries_.end(), &(vec[0]));
+            }
+
+        private:
+            void wait_()
+            {
+#if HAVE_MPI
+                if (pending_) {
+                    MPI_Wait(&request_, MPI_STATUS_IGNORE);
+                }
+#endif
+                pending_ = false;
+            }
+
+            std::vector<Scalar> entries_;
+#if HAVE_MPI
+            MPI_Request request_ = MPI_REQUEST_NULL;
+#endif
+            bool pending_ = false;
+        };
+
 
 
         template <int dim, class C2F, class FC>
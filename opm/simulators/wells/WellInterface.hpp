@@ -34,6 +34,8 @@
 
 #include <opm/core/props/BlackoilPhases.hpp>
 
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+
 #include <opm/simulators/wells/VFPProperties.hpp>
 #include <opm/simulators/wells/WellHelpers.hpp>
 #include <opm/simulators/wells/WellGroupHelpers.hpp>
@@ -162,11 +164,46 @@ public:
 
     virtual void solveEqAndUpdateWellState(WellState& well_state, DeferredLogger& deferred_logger) = 0;
 
+    /// Assemble the well equations. With postponeCommunication the
+    /// equations of a distributed well are only summed over the processes
+    /// by completeAssembly(), the communication may then overlap with other
+    /// work.
     void assembleWellEq(const Simulator& ebosSimulator,
                         const double dt,
                         WellState& well_state,
                         const GroupState& group_state,
-                        DeferredLogger& deferred_logger);
+                        DeferredLogger& deferred_logger,
+                        const bool postponeCommunication = false);
+
+    /// The first part of assembleWellEq(): check the operability of the
+    /// well and run the inner iterations of the well equations if needed.
+    /// This updates the controls and rates of the well, which are read by
+    /// the other wells of its groups, so the wells must be prepared one
+    /// after the other.
+    void prepareWellBeforeAssembling(const Simulator& ebosSimulator,
+                                     const double dt,
+                                     WellState& well_state,
+                                     const GroupState& group_state,
+                                     DeferredLogger& deferred_logger);
+
+    /// The second part of assembleWellEq(): assemble the well equations at
+    /// the current well state. This only writes the perforation rates of
+    /// the well to the well state and reads the controls and surface rates
+    /// of the other wells, so the wells can be assembled concurrently.
+    void assembleWellEqAtCurrentState(const Simulator& ebosSimulator,
+                                      const double dt,
+                                      WellState& well_state,
+                                      const GroupState& group_state,
+                                      DeferredLogger& deferred_logger,
+                                      const bool postponeCommunication = false);
+
+    /// Complete an assembly which assembleWellEq() left pending.
+    virtual void completeAssembly(const Simulator& /* ebosSimulator */,
+                                  const double /* dt */,
+                                  WellState& /* well_state */,
+                                  const GroupState& /* group_state */,
+                                  DeferredLogger& /* deferred_logger */)
+    {}
 
     virtual void gasLiftOptimizationStage1 (
         WellState& well_state,
@@ -226,6 +263,16 @@ public:
     // Add well contributions to matrix
     virtual void addWellContributions(SparseMatrixAdapter&) const = 0;
 
+    // Add an approximation of the well contributions to a matrix only used
+    // for preconditioning, within the sparsity pattern of the matrix. The
+    // default adds nothing.
+    virtual void addWellContributionsToPreconditioner(typename SparseMatrixAdapter::IstlMatrix&) const
+    {
+    }
+
+    // Append a copy of the B, C and D matrices of the well, for dumping the linear system
+    virtual void addWellSystemBlocks(std::vector<Helper::WellSystemBlocks>& blocks) const = 0;
+
     void addCellRates(RateVector& rates, int cellIdx) const;
 
     Scalar volumetricSurfaceRateForConnection(int cellIdx, int phaseIdx) const;
@@ -292,6 +339,23 @@ protected:
 
     bool changed_to_stopped_this_step_ = false;
 
+    // whether assembleWellEqWithoutIteration() may leave the sum of the
+    // equations of a distributed well to completeAssembly()
+    bool postpone_communication_ = false;
+
+    // The conditions under which the inner iterations in assembleWellEq()
+    // were run for the last time.
+    struct InnerIterationState {
+        bool converged = false;
+        bool operable = false;
+        double time = 0.0;
+        double dt = 0.0;
+        Well::InjectorCMode inj_cmode = Well::InjectorCMode::CMODE_UNDEFINED;
+        Well::ProducerCMode prod_cmode = Well::ProducerCMode::CMODE_UNDEFINED;
+        std::vector<double> cell_pressures;
+    };
+    InnerIterationState inner_iteration_state_;
+
     int flowPhaseToEbosCompIdx( const int phaseIdx ) const;
 
     int flowPhaseToEbosPhaseIdx( const int phaseIdx ) const;
@@ -359,6 +423,17 @@ protected:
                               const GroupState& group_state,
                               DeferredLogger& deferred_logger);
 
+    // Whether the inner iterations have to be run again, i.e. unless they
+    // converged last time in the same time step with the same control and
+    // operability, and no connection cell pressure has changed by more than
+    // the SkipInnerIterPressureChange parameter since.
+    bool innerIterationsNeeded(const Simulator& ebosSimulator,
+                               const double dt,
+                               const WellState& well_state,
+                               const std::vector<double>& cell_pressures) const;
+
+    std::vector<double> connectionCellPressures(const Simulator& ebosSimulator) const;
+
     void solveWellForTesting(const Simulator& ebosSimulator, WellState& well_state, const GroupState& group_state,
                              DeferredLogger& deferred_logger);
 
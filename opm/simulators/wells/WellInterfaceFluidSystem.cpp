@@ -846,7 +846,7 @@ checkMaxRatioLimitCompletions(const WellState& well_state,
     double max_ratio_completion = 0;
     const int np = number_of_phases_;
 
-    const auto * perf_phase_rates = &well_state.perfPhaseRates()[first_perf_ * np];
+    const auto * perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
     // look for the worst_offending_completion
     for (const auto& completion : completions_) {
         std::vector<double> completion_rates(np, 0.0);
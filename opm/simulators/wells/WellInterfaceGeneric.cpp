@@ -203,6 +203,11 @@ bool WellInterfaceGeneric::underPredictionMode() const
     return well_ecl_.predictionMode();
 }
 
+bool WellInterfaceGeneric::isOwnerOfWell() const
+{
+    return parallel_well_info_.isOwner();
+}
+
 void WellInterfaceGeneric::initCompletions()
 {
     assert(completions_.empty() );
@@ -259,7 +264,7 @@ void WellInterfaceGeneric::setWellEfficiencyFactor(const double efficiency_facto
     well_efficiency_factor_ = efficiency_factor;
 }
 
-void WellInterfaceGeneric::setRepRadiusPerfLength(const std::vector<int>& cartesian_to_compressed)
+void WellInterfaceGeneric::setRepRadiusPerfLength(const std::unordered_map<int, int>& cartesian_to_compressed)
 {
     const int nperf = number_of_perforations_;
 
@@ -276,8 +281,8 @@ void WellInterfaceGeneric::setRepRadiusPerfLength(const std::vector<int>& cartes
     CheckDistributedWellConnections checker(well_ecl_, parallel_well_info_);
     for (size_t c=0; c<connectionSet.size(); c++) {
         const auto& connection = connectionSet.get(c);
-        const int cell =
-                cartesian_to_compressed[connection.global_index()];
+        const auto cell_pair = cartesian_to_compressed.find(connection.global_index());
+        const int cell = cell_pair == cartesian_to_compressed.end() ? -1 : cell_pair->second;
         if (connection.state() != Connection::State::OPEN || cell >= 0)
         {
             checker.connectionFound(c);
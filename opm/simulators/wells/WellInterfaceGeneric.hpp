@@ -29,6 +29,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Opm
@@ -78,6 +79,13 @@ public:
     /// Returns true if the well is currently in prediction mode (i.e. not history mode).
     bool underPredictionMode() const;
 
+    /// Derivatives of the surface rates of the phases with respect to the
+    /// bottom-hole pressure, negated, as of the last IPR update.
+    const std::vector<double>& iprB() const { return ipr_b_; }
+
+    /// Whether this process owns the well, i.e. counts it in global sums.
+    bool isOwnerOfWell() const;
+
     // whether the well is operable
     bool isOperable() const;
 
@@ -87,7 +95,7 @@ public:
     void setVFPProperties(const VFPProperties* vfp_properties_arg);
     void setGuideRate(const GuideRate* guide_rate_arg);
     void setWellEfficiencyFactor(const double efficiency_factor);
-    void setRepRadiusPerfLength(const std::vector<int>& cartesian_to_compressed);
+    void setRepRadiusPerfLength(const std::unordered_map<int, int>& cartesian_to_compressed);
     void setWsolvent(const double wsolvent);
     void setDynamicThpLimit(const double thp_limit);
     void updatePerforatedCell(std::vector<bool>& is_cell_perforated);
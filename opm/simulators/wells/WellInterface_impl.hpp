@@ -423,6 +423,58 @@ namespace Opm
     }
 
 
+    template<typename TypeTag>
+    bool
+    WellInterface<TypeTag>::
+    innerIterationsNeeded(const Simulator& ebosSimulator,
+                          const double dt,
+                          const WellState& well_state,
+                          const std::vector<double>& cell_pressures) const
+    {
+        const auto& last = this->inner_iteration_state_;
+        const double max_change = param_.skip_inner_iter_pressure_change_;
+        bool needed = max_change <= 0.0
+            || !last.converged
+            || last.operable != this->isOperable()
+            || last.time != ebosSimulator.time()
+            || last.dt != dt
+            || last.inj_cmode != well_state.currentInjectionControl(this->index_of_well_)
+            || last.prod_cmode != well_state.currentProductionControl(this->index_of_well_)
+            || last.cell_pressures.size() != cell_pressures.size();
+
+        for (std::size_t perf = 0; !needed && perf < cell_pressures.size(); ++perf) {
+            needed = std::abs(cell_pressures[perf] - last.cell_pressures[perf]) > max_change;
+        }
+
+        // The inner iterations of a distributed well communicate, all the
+        // processes sharing the well must take the same decision.
+        return this->parallel_well_info_.communication().max(static_cast<int>(needed)) > 0;
+    }
+
+
+
+    template<typename TypeTag>
+    std::vector<double>
+    WellInterface<TypeTag>::
+    connectionCellPressures(const Simulator& ebosSimulator) const
+    {
+        std::vector<double> cell_pressures(this->number_of_perforations_);
+        for (int perf = 0; perf < this->number_of_perforations_; ++perf) {
+            const int cell_idx = this->well_cells_[perf];
+            const auto& fs = ebosSimulator.problem().cachedIntensiveQuantities(cell_idx)->fluidState();
+            if (Indices::oilEnabled) {
+                cell_pressures[perf] = fs.pressure(FluidSystem::oilPhaseIdx).value();
+            } else if (Indices::waterEnabled) {
+                cell_pressures[perf] = fs.pressure(FluidSystem::waterPhaseIdx).value();
+            } else {
+                cell_pressures[perf] = fs.pressure(FluidSystem::gasPhaseIdx).value();
+            }
+        }
+        return cell_pressures;
+    }
+
+
+
     template<typename TypeTag>
     void
     WellInterface<TypeTag>::
@@ -477,19 +529,64 @@ namespace Opm
                    const double dt,
                    WellState& well_state,
                    const GroupState& group_state,
-                   DeferredLogger& deferred_logger)
+                   DeferredLogger& deferred_logger,
+                   const bool postponeCommunication)
     {
+        prepareWellBeforeAssembling(ebosSimulator, dt, well_state, group_state, deferred_logger);
+        assembleWellEqAtCurrentState(ebosSimulator, dt, well_state, group_state, deferred_logger, postponeCommunication);
+    }
+
 
+
+    template <typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    prepareWellBeforeAssembling(const Simulator& ebosSimulator,
+                                const double dt,
+                                WellState& well_state,
+                                const GroupState& group_state,
+                                DeferredLogger& deferred_logger)
+    {
         checkWellOperability(ebosSimulator, well_state, deferred_logger);
 
         if (this->useInnerIterations()) {
-            this->iterateWellEquations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+            auto cell_pressures = this->connectionCellPressures(ebosSimulator);
+            if (this->innerIterationsNeeded(ebosSimulator, dt, well_state, cell_pressures)) {
+                auto& last = this->inner_iteration_state_;
+                last.converged = this->iterateWellEquations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+                last.operable = this->isOperable();
+                last.time = ebosSimulator.time();
+                last.dt = dt;
+                last.inj_cmode = well_state.currentInjectionControl(this->index_of_well_);
+                last.prod_cmode = well_state.currentProductionControl(this->index_of_well_);
+                last.cell_pressures = std::move(cell_pressures);
+            }
         }
+    }
+
+
 
+    template <typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    assembleWellEqAtCurrentState(const Simulator& ebosSimulator,
+                                 const double dt,
+                                 WellState& well_state,
+                                 const GroupState& group_state,
+                                 DeferredLogger& deferred_logger,
+                                 const bool postponeCommunication)
+    {
         const auto& summary_state = ebosSimulator.vanguard().summaryState();
         const auto inj_controls = this->well_ecl_.isInjector() ? this->well_ecl_.injectionControls(summary_state) : Well::InjectionControls(0);
         const auto prod_controls = this->well_ecl_.isProducer() ? this->well_ecl_.productionControls(summary_state) : Well::ProductionControls(0);
-        assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, group_state, deferred_logger);
+        this->postpone_communication_ = postponeCommunication;
+        try {
+            assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, group_state, deferred_logger);
+        } catch (...) {
+            this->postpone_communication_ = false;
+            throw;
+        }
+        this->postpone_communication_ = false;
     }
 
 
@@ -594,8 +691,7 @@ namespace Opm
                          DeferredLogger& deferred_logger)
     {
 
-        const bool checkOperability = EWOMS_GET_PARAM(TypeTag, bool, EnableWellOperabilityCheck);
-        if (!checkOperability) {
+        if (!param_.check_well_operability_) {
             return;
         }
 
@@ -1002,7 +1098,7 @@ namespace Opm
         }
         for (int perf = 0; perf < nperf; ++perf) {
             const int cell_idx = this->well_cells_[perf];
-            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            const auto& intQuants = *(ebosSimulator.problem().cachedIntensiveQuantities(cell_idx));
             const auto& fs = intQuants.fluidState();
             const double well_tw_fraction = this->well_index_[perf] / total_tw;
             double total_mobility = 0.0;
@@ -23,11 +23,14 @@
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/simulators/wells/GroupState.hpp>
 #include <opm/simulators/wells/ParallelWellInfo.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <numeric>
+#include <type_traits>
 
 namespace Opm
 {
@@ -40,8 +43,6 @@ void WellState::base_init(const std::vector<double>& cellPressures,
 {
     // clear old name mapping
     this->wellMap_.clear();
-    this->perfpress_.clear();
-    this->perfrates_.clear();
     this->status_.clear();
     this->well_perf_data_.clear();
     this->parallel_well_info_.clear();
@@ -54,6 +55,7 @@ void WellState::base_init(const std::vector<double>& cellPressures,
         const int nw = wells_ecl.size();
         // const int np = wells->number_of_phases;
         int connpos = 0;
+        std::vector<int> num_perf(nw);
         for (int w = 0; w < nw; ++w) {
             const Well& well = wells_ecl[w];
 
@@ -69,6 +71,13 @@ void WellState::base_init(const std::vector<double>& cellPressures,
             wellMapEntry[ 1 ] = connpos;
             wellMapEntry[ 2 ] = num_perf_this_well;
             connpos += num_perf_this_well;
+            num_perf[w] = num_perf_this_well;
+        }
+
+        // All connection quantities start out as zero, except the pressures.
+        this->perf_data_.init(num_perf, this->phase_usage_.num_phases);
+        for (int w = 0; w < nw; ++w) {
+            std::fill_n(this->perfPress(w), num_perf[w], -1e100);
         }
     }
 }
@@ -97,8 +106,6 @@ void WellState::initSingleWell(const std::vector<double>& cellPressures,
     this->wellrates_.add(well.name(), std::vector<double>(np, 0));
 
     const int num_perf_this_well = well_info->communication().sum(well_perf_data_[w].size());
-    this->perfpress_.add(well.name(), std::vector<double>(num_perf_this_well, -1e100));
-    this->perfrates_.add(well.name(), std::vector<double>(num_perf_this_well, 0));
     this->bhp_.add(well.name(), 0.0);
     this->thp_.add(well.name(), 0.0);
     if ( well.isInjector() )
@@ -249,15 +256,10 @@ void WellState::init(const std::vector<double>& cellPressures,
 
     if( nw == 0 ) return ;
 
-    // Initialize perfphaserates_, which must be done here.
+    // Initialize the perforation phase rates, which must be done here.
     const auto& pu = this->phaseUsage();
     const int np = pu.num_phases;
 
-    int nperf = 0;
-    for (const auto& wpd : well_perf_data) {
-        nperf += wpd.size();
-    }
-
     well_reservoir_rates_.clear();
     well_dissolved_gas_rates_.clear();
     well_vaporized_oil_rates_.clear();
@@ -273,31 +275,15 @@ void WellState::init(const std::vector<double>& cellPressures,
                 this->events_.add( wname, Events() );
         }
     }
-    // Ensure that we start out with zero rates by default.
-    perfphaserates_.clear();
-    perfphaserates_.resize(nperf * this->numPhases(), 0.0);
-
-    // these are only used to monitor the injectivity
-    perf_water_throughput_.clear();
-    perf_water_throughput_.resize(nperf, 0.0);
-    perf_water_velocity_.clear();
-    perf_water_velocity_.resize(nperf, 0.0);
-    perf_skin_pressure_.clear();
-    perf_skin_pressure_.resize(nperf, 0.0);
-
-    num_perf_.resize(nw, 0);
-    first_perf_index_.resize(nw, 0);
-    first_perf_index_[0] = 0;
+    // The connection rates start out as zero, base_init() has allocated them.
     for (int w = 0; w < nw; ++w) {
-        // Initialize perfphaserates_ to well
+        // Initialize the perforation phase rates to well
         // rates divided by the number of perforations.
         const auto& wname = wells_ecl[w].name();
-        const auto& well_info = this->wellMap().at(wname);
-        const int connpos = well_info[1];
-        const int num_perf_this_well = well_info[2];
+        const int num_perf_this_well = this->numPerf(w);
         const int global_num_perf_this_well = parallel_well_info[w]->communication().sum(num_perf_this_well);
-        auto& perf_press = this->perfPress(w);
-        auto * phase_rates = &this->mutable_perfPhaseRates()[connpos * this->numPhases()];
+        auto * perf_press = this->perfPress(w);
+        auto * phase_rates = this->perfPhaseRates(w);
 
         for (int perf = 0; perf < num_perf_this_well; ++perf) {
             if (wells_ecl[w].getStatus() == Well::Status::OPEN) {
@@ -307,8 +293,6 @@ void WellState::init(const std::vector<double>& cellPressures,
             }
             perf_press[perf] = cellPressures[well_perf_data[w][perf].cell_index];
         }
-        num_perf_[w] = num_perf_this_well;
-        first_perf_index_[w] = connpos;
 
         this->well_reservoir_rates_.add(wname, std::vector<double>(np, 0));
         this->well_dissolved_gas_rates_.add(wname, 0);
@@ -337,18 +321,9 @@ void WellState::init(const std::vector<double>& cellPressures,
         }
     }
 
-    perfRateSolvent_.clear();
-    perfRateSolvent_.resize(nperf, 0.0);
     productivity_index_.resize(nw * this->numPhases(), 0.0);
-    conn_productivity_index_.resize(nperf * this->numPhases(), 0.0);
     well_potentials_.resize(nw * this->numPhases(), 0.0);
 
-    perfRatePolymer_.clear();
-    perfRatePolymer_.resize(nperf, 0.0);
-
-    perfRateBrine_.clear();
-    perfRateBrine_.resize(nperf, 0.0);
-
     for (int w = 0; w < nw; ++w) {
         switch (wells_ecl[w].getStatus()) {
         case Well::Status::SHUT:
@@ -412,18 +387,8 @@ void WellState::init(const std::vector<double>& cellPressures,
                 }
 
                 // perfPhaseRates
-                const int oldPerf_idx_beg = (*it).second[ 1 ];
                 const int num_perf_old_well = (*it).second[ 2 ];
-                const auto new_iter = this->wellMap().find(well.name());
-                if (new_iter == this->wellMap().end()) {
-                    throw std::logic_error {
-                        well.name() + " is not in internal well map - "
-                        "Bug in WellState"
-                    };
-                }
-
-                const int connpos = new_iter->second[1];
-                const int num_perf_this_well = new_iter->second[2];
+                const int num_perf_this_well = this->numPerf(newIndex);
 
                 const int num_perf_changed = parallel_well_info[w]->communication()
                     .sum(static_cast<int>(num_perf_old_well != num_perf_this_well));
@@ -436,16 +401,12 @@ void WellState::init(const std::vector<double>& cellPressures,
                 // number of perforations.
                 if (global_num_perf_same)
                 {
-                    const auto * src_rates = &prevState->perfPhaseRates()[oldPerf_idx_beg* np];
-                    auto * target_rates = &this->mutable_perfPhaseRates()[connpos*np];
-                    for (int perf_index = 0; perf_index < num_perf_this_well; perf_index++) {
-                        for (int p = 0; p < np; p++) {
-                            target_rates[perf_index*np + p] = src_rates[perf_index*np + p];
-                        }
-                    }
+                    const auto * src_rates = prevState->perfPhaseRates(oldIndex);
+                    auto * target_rates = this->perfPhaseRates(newIndex);
+                    std::copy_n(src_rates, num_perf_this_well*np, target_rates);
                 } else {
                     const int global_num_perf_this_well = parallel_well_info[w]->communication().sum(num_perf_this_well);
-                    auto * target_rates = &this->mutable_perfPhaseRates()[connpos*np];
+                    auto * target_rates = this->perfPhaseRates(newIndex);
                     for (int perf_index = 0; perf_index < num_perf_this_well; perf_index++) {
                         for (int p = 0; p < np; ++p) {
                             target_rates[perf_index*np + p] = wellRates(w)[p] / double(global_num_perf_this_well);
@@ -456,23 +417,14 @@ void WellState::init(const std::vector<double>& cellPressures,
                 // perfPressures
                 if (global_num_perf_same)
                 {
-                    auto& target_press = perfPress(w);
-                    const auto& src_press = prevState->perfPress(well.name());
-                    for (int perf = 0; perf < num_perf_this_well; ++perf)
-                    {
-                        target_press[perf] = src_press[perf];
-                    }
+                    std::copy_n(prevState->perfPress(oldIndex), num_perf_this_well, this->perfPress(newIndex));
                 }
 
                 // perfSolventRates
                 if (pu.has_solvent) {
                     if (global_num_perf_same)
                     {
-                        int oldPerf_idx = oldPerf_idx_beg;
-                        for (int perf = connpos; perf < connpos + num_perf_this_well; ++perf, ++oldPerf_idx )
-                        {
-                            perfRateSolvent()[ perf ] = prevState->perfRateSolvent()[ oldPerf_idx ];
-                        }
+                        std::copy_n(prevState->perfRateSolvent(oldIndex), num_perf_this_well, this->perfRateSolvent(newIndex));
                     }
                 }
 
@@ -484,13 +436,13 @@ void WellState::init(const std::vector<double>& cellPressures,
                 if (pu.has_polymermw) {
                     if (global_num_perf_same)
                     {
-                        auto * throughput_target = &perf_water_throughput_[connpos];
-                        auto * pressure_target = &perf_skin_pressure_[connpos];
-                        auto * velocity_target = &perf_water_velocity_[connpos];
+                        auto * throughput_target = this->perfThroughput(newIndex);
+                        auto * pressure_target = this->perfSkinPressure(newIndex);
+                        auto * velocity_target = this->perfWaterVelocity(newIndex);
 
-                        const auto * throughput_src = &prevState->perfThroughput()[oldPerf_idx_beg];
-                        const auto * pressure_src = &prevState->perfSkinPressure()[oldPerf_idx_beg];
-                        const auto * velocity_src = &prevState->perfWaterVelocity()[oldPerf_idx_beg];
+                        const auto * throughput_src = prevState->perfThroughput(oldIndex);
+                        const auto * pressure_src = prevState->perfSkinPressure(oldIndex);
+                        const auto * velocity_src = prevState->perfWaterVelocity(oldIndex);
 
                         for (int perf = 0; perf < num_perf_this_well; ++perf)
                         {
@@ -758,8 +710,8 @@ void WellState::reportConnections(data::Well& well,
     const int num_perf_well = pd.size();
     well.connections.resize(num_perf_well);
 
-    const auto& perf_rates = this->perfRates(well_index);
-    const auto& perf_pressure = this->perfPress(well_index);
+    const auto * perf_rates = this->perfRates(well_index);
+    const auto * perf_pressure = this->perfPress(well_index);
     for( int i = 0; i < num_perf_well; ++i ) {
         const auto active_index = this->well_perf_data_[well_index][i].cell_index;
         auto& connection = well.connections[ i ];
@@ -789,26 +741,28 @@ void WellState::reportConnections(data::Well& well,
         phs.at( pu.phase_pos[Gas] ) = rt::gas;
         pi .at( pu.phase_pos[Gas] ) = rt::productivity_index_gas;
     }
+    const auto * perf_phase_rates = this->perfPhaseRates(well_index);
+    const auto * perf_conn_pi = this->connectionProductivityIndex(well_index);
     for( auto& comp : well.connections) {
-        const auto connPhaseOffset = np * (wt.second[1] + local_comp_index);
+        const auto connPhaseOffset = np * local_comp_index;
 
-        const auto * rates = &this->perfPhaseRates()[connPhaseOffset];
-        const auto connPI  = this->connectionProductivityIndex().begin() + connPhaseOffset;
+        const auto * rates = &perf_phase_rates[connPhaseOffset];
+        const auto * connPI = &perf_conn_pi[connPhaseOffset];
 
         for( int i = 0; i < np; ++i ) {
             comp.rates.set( phs[ i ], rates[i] );
-            comp.rates.set( pi [ i ], *(connPI + i) );
+            comp.rates.set( pi [ i ], connPI[i] );
         }
         if ( pu.has_polymer ) {
-            const auto * perf_polymer_rate = &this->perfRatePolymer()[wt.second[1]];
+            const auto * perf_polymer_rate = this->perfRatePolymer(well_index);
             comp.rates.set( rt::polymer, perf_polymer_rate[local_comp_index]);
         }
         if ( pu.has_brine ) {
-            const auto * perf_brine_rate = &this->perfRateBrine()[wt.second[1]];
+            const auto * perf_brine_rate = this->perfRateBrine(well_index);
             comp.rates.set( rt::brine, perf_brine_rate[local_comp_index]);
         }
         if ( pu.has_solvent ) {
-            const auto * perf_solvent_rate = &this->perfRateSolvent()[wt.second[1]];
+            const auto * perf_solvent_rate = this->perfRateSolvent(well_index);
             comp.rates.set( rt::solvent, perf_solvent_rate[local_comp_index] );
         }
 
@@ -838,10 +792,7 @@ void WellState::initWellStateMSWell(const std::vector<Well>& wells_ecl,
     // what we do here, is to set the segment rates and perforation rates
     for (int w = 0; w < nw; ++w) {
         const auto& well_ecl = wells_ecl[w];
-        const auto& wname = wells_ecl[w].name();
-        const auto& well_info = this->wellMap().at(wname);
-        const int connpos = well_info[1];
-        const int num_perf_this_well = well_info[2];
+        const int num_perf_this_well = this->numPerf(w);
 
         const auto& rates = this->wellRates(w);
         top_segment_index_.push_back(nseg_);
@@ -891,14 +842,12 @@ void WellState::initWellStateMSWell(const std::vector<Well>& wells_ecl,
 
             // for the seg_rates_, now it becomes a recursive solution procedure.
             {
-                const int start_perf = connpos;
-
                 // make sure the information from wells_ecl consistent with wells
                 assert((n_activeperf == num_perf_this_well) &&
                        "Inconsistent number of reservoir connections in well");
 
                 if (pu.phase_used[Gas]) {
-                    auto * perf_rates = &this->mutable_perfPhaseRates()[np * start_perf];
+                    auto * perf_rates = this->perfPhaseRates(w);
                     const int gaspos = pu.phase_pos[Gas];
                     // scale the phase rates for Gas to avoid too bad initial guess for gas fraction
                     // it will probably benefit the standard well too, while it needs to be justified
@@ -909,7 +858,7 @@ void WellState::initWellStateMSWell(const std::vector<Well>& wells_ecl,
                         perf_rates[perf*np + gaspos] *= 100;
                 }
 
-                const auto * perf_rates = &perfPhaseRates()[np*start_perf];
+                const auto * perf_rates = this->perfPhaseRates(w);
                 std::vector<double> perforation_rates(perf_rates, perf_rates + num_perf_this_well*np);
                 std::vector<double> segment_rates;
 
@@ -926,7 +875,7 @@ void WellState::initWellStateMSWell(const std::vector<Well>& wells_ecl,
                 // top segment is always the first one, and its pressure is the well bhp
                 seg_press_.push_back(bhp(w));
                 const int top_segment = top_segment_index_[w];
-                const auto& perf_press = this->perfPress(w);
+                const auto * perf_press = this->perfPress(w);
                 for (int seg = 1; seg < well_nseg; ++seg) {
                     if ( !segment_perforations[seg].empty() ) {
                         const int first_perf = segment_perforations[seg][0];
@@ -1023,20 +972,20 @@ WellState::calculateSegmentRates(const std::vector<std::vector<int>>& segment_in
 
 double WellState::solventWellRate(const int w) const
 {
-    const auto * perf_rates_solvent = &perfRateSolvent_[first_perf_index_[w]];
-    return parallel_well_info_[w]->sumPerfValues(perf_rates_solvent, perf_rates_solvent + this->num_perf_[w]);
+    const auto * perf_rates_solvent = this->perfRateSolvent(w);
+    return parallel_well_info_[w]->sumPerfValues(perf_rates_solvent, perf_rates_solvent + this->numPerf(w));
 }
 
 double WellState::polymerWellRate(const int w) const
 {
-    const auto * perf_rates_polymer = &perfRatePolymer_[first_perf_index_[w]];
-    return parallel_well_info_[w]->sumPerfValues(perf_rates_polymer, perf_rates_polymer + this->num_perf_[w]);
+    const auto * perf_rates_polymer = this->perfRatePolymer(w);
+    return parallel_well_info_[w]->sumPerfValues(perf_rates_polymer, perf_rates_polymer + this->numPerf(w));
 }
 
 double WellState::brineWellRate(const int w) const
 {
-    const auto * perf_rates_brine = &perfRateBrine_[first_perf_index_[w]];
-    return parallel_well_info_[w]->sumPerfValues(perf_rates_brine, perf_rates_brine + this->num_perf_[w]);
+    const auto * perf_rates_brine = this->perfRateBrine(w);
+    return parallel_well_info_[w]->sumPerfValues(perf_rates_brine, perf_rates_brine + this->numPerf(w));
 }
 
 int WellState::topSegmentIndex(const int w) const
@@ -1068,10 +1017,8 @@ void WellState::shutWell(int well_index)
         wpi[p]  = 0.0;
     }
 
-    const auto first = this->first_perf_index_[well_index]*np;
-    const auto last  = first + this->num_perf_[well_index]*np;
-    std::fill(this->conn_productivity_index_.begin() + first,
-              this->conn_productivity_index_.begin() + last, 0.0);
+    std::fill_n(this->connectionProductivityIndex(well_index),
+                this->numPerf(well_index)*np, 0.0);
 }
 
 void WellState::updateStatus(int well_index, Well::Status status)
@@ -1094,7 +1041,7 @@ void WellState::updateStatus(int well_index, Well::Status status)
 
 
 template<class Comm>
-void WellState::communicateGroupRates(const Comm& comm)
+void WellState::communicateGroupRates(const Comm& comm, GroupState& group_state)
 {
     // Compute the size of the data.
     std::size_t sz = 0;
@@ -1105,6 +1052,7 @@ void WellState::communicateGroupRates(const Comm& comm)
         sz += rates.size();
     }
     sz += this->alq_state.pack_size();
+    sz += group_state.rates_pack_size();
 
 
     // Make a vector and collect all data into it.
@@ -1121,6 +1069,7 @@ void WellState::communicateGroupRates(const Comm& comm)
         }
     }
     pos += this->alq_state.pack_data(&data[pos]);
+    pos += group_state.pack_rates(&data[pos]);
     assert(pos == sz);
 
     // Communicate it with a single sum() call.
@@ -1135,6 +1084,7 @@ void WellState::communicateGroupRates(const Comm& comm)
             value = data[pos++];
     }
     pos += this->alq_state.unpack_data(&data[pos]);
+    pos += group_state.unpack_rates(&data[pos]);
     assert(pos == sz);
 }
 
@@ -1204,6 +1154,36 @@ bool WellState::wellIsOwned(const std::string& wellName) const
     return wellIsOwned(well_index, wellName);
 }
 
+std::size_t WellState::memoryUsage() const
+{
+    auto vectorBytes = [](const auto& v)
+    {
+        return v.capacity() * sizeof(typename std::decay_t<decltype(v)>::value_type);
+    };
+
+    std::size_t bytes = this->perf_data_.memoryUsage();
+    for (const auto& perf_data : this->well_perf_data_) {
+        bytes += vectorBytes(perf_data);
+    }
+    for (const auto& rates : this->wellrates_) {
+        bytes += vectorBytes(rates);
+    }
+    for (const auto& rates : this->well_reservoir_rates_) {
+        bytes += vectorBytes(rates);
+    }
+    for (const auto& [name, rates] : this->well_rates) {
+        bytes += name.capacity() + vectorBytes(rates.second);
+    }
+    bytes += vectorBytes(this->seg_rates_) + vectorBytes(this->seg_press_)
+        + vectorBytes(this->top_segment_index_) + vectorBytes(this->seg_number_)
+        + vectorBytes(this->seg_pressdrop_friction_)
+        + vectorBytes(this->seg_pressdrop_hydorstatic_)
+        + vectorBytes(this->seg_pressdrop_acceleration_)
+        + vectorBytes(this->productivity_index_)
+        + vectorBytes(this->well_potentials_);
+    return bytes;
+}
+
 int WellState::numSegments(const int well_id) const
 {
     const auto topseg = this->topSegmentIndex(well_id);
@@ -1278,6 +1258,87 @@ WellState::parallelWellInfo(std::size_t well_index) const
     return *parallel_well_info_[well_index];
 }
 
+namespace {
+
+template <class T>
+void writeContainer(std::ostream& os, const WellContainer<T>& container)
+{
+    BinaryCheckpoint::write(os, container.data());
+}
+
+template <class T>
+void readContainer(std::istream& is, WellContainer<T>& container)
+{
+    std::vector<T> values;
+    BinaryCheckpoint::read(is, values);
+    if (values.size() != container.size()) {
+        throw std::runtime_error("The checkpoint does not match the wells of the simulation");
+    }
+    for (std::size_t w = 0; w < values.size(); ++w) {
+        container.update(w, std::move(values[w]));
+    }
+}
+
+}
+
+void WellState::writeCheckpoint(std::ostream& os) const
+{
+    BinaryCheckpoint::write(os, this->wellMap_);
+    this->alq_state.writeCheckpoint(os);
+    writeContainer(os, this->status_);
+    writeContainer(os, this->bhp_);
+    writeContainer(os, this->thp_);
+    writeContainer(os, this->temperature_);
+    writeContainer(os, this->wellrates_);
+    this->perf_data_.writeCheckpoint(os);
+    writeContainer(os, this->current_injection_controls_);
+    writeContainer(os, this->current_production_controls_);
+    BinaryCheckpoint::write(os, this->well_rates);
+    writeContainer(os, this->well_reservoir_rates_);
+    writeContainer(os, this->well_dissolved_gas_rates_);
+    writeContainer(os, this->well_vaporized_oil_rates_);
+    if constexpr (std::is_trivially_copyable_v<Events>) {
+        writeContainer(os, this->events_);
+    }
+    BinaryCheckpoint::write(os, this->top_segment_index_);
+    BinaryCheckpoint::write(os, this->seg_rates_);
+    BinaryCheckpoint::write(os, this->seg_press_);
+    BinaryCheckpoint::write(os, this->seg_pressdrop_friction_);
+    BinaryCheckpoint::write(os, this->seg_pressdrop_hydorstatic_);
+    BinaryCheckpoint::write(os, this->seg_pressdrop_acceleration_);
+    BinaryCheckpoint::write(os, this->productivity_index_);
+    BinaryCheckpoint::write(os, this->well_potentials_);
+}
+
+void WellState::readCheckpoint(std::istream& is)
+{
+    BinaryCheckpoint::readExpected(is, this->wellMap_, "wells");
+    this->alq_state.readCheckpoint(is);
+    readContainer(is, this->status_);
+    readContainer(is, this->bhp_);
+    readContainer(is, this->thp_);
+    readContainer(is, this->temperature_);
+    readContainer(is, this->wellrates_);
+    this->perf_data_.readCheckpoint(is);
+    readContainer(is, this->current_injection_controls_);
+    readContainer(is, this->current_production_controls_);
+    BinaryCheckpoint::read(is, this->well_rates);
+    readContainer(is, this->well_reservoir_rates_);
+    readContainer(is, this->well_dissolved_gas_rates_);
+    readContainer(is, this->well_vaporized_oil_rates_);
+    if constexpr (std::is_trivially_copyable_v<Events>) {
+        readContainer(is, this->events_);
+    }
+    BinaryCheckpoint::readExpected(is, this->top_segment_index_, "well segments");
+    BinaryCheckpoint::read(is, this->seg_rates_);
+    BinaryCheckpoint::read(is, this->seg_press_);
+    BinaryCheckpoint::read(is, this->seg_pressdrop_friction_);
+    BinaryCheckpoint::read(is, this->seg_pressdrop_hydorstatic_);
+    BinaryCheckpoint::read(is, this->seg_pressdrop_acceleration_);
+    BinaryCheckpoint::read(is, this->productivity_index_);
+    BinaryCheckpoint::read(is, this->well_potentials_);
+}
+
 template void WellState::updateGlobalIsGrup<ParallelWellInfo::Communication>(const ParallelWellInfo::Communication& comm);
-template void WellState::communicateGroupRates<ParallelWellInfo::Communication>(const ParallelWellInfo::Communication& comm);
+template void WellState::communicateGroupRates<ParallelWellInfo::Communication>(const ParallelWellInfo::Communication& comm, GroupState& group_state);
 } // namespace Opm
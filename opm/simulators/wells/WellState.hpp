@@ -23,6 +23,7 @@
 
 #include <opm/simulators/wells/ALQState.hpp>
 #include <opm/simulators/wells/GlobalWellInfo.hpp>
+#include <opm/simulators/wells/PerfData.hpp>
 #include <opm/simulators/wells/WellContainer.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
 #include <opm/simulators/wells/PerforationData.hpp>
@@ -32,6 +33,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Well/Well.hpp>
 
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <optional>
 #include <string>
@@ -41,6 +43,7 @@
 namespace Opm
 {
 
+class GroupState;
 class ParallelWellInfo;
 class Schedule;
 
@@ -56,6 +59,13 @@ public:
 
     virtual ~WellState() = default;
 
+    // The virtual destructor would otherwise suppress the moves, which
+    // turns every move of a WGState into a deep copy.
+    WellState(const WellState&) = default;
+    WellState(WellState&&) = default;
+    WellState& operator=(const WellState&) = default;
+    WellState& operator=(WellState&&) = default;
+
     // TODO: same definition with WellInterface, eventually they should go to a common header file.
     static const int Water = BlackoilPhases::Aqua;
     static const int Oil = BlackoilPhases::Liquid;
@@ -99,8 +109,11 @@ public:
                 const SummaryState& summary_state);
 
     /// One rate per phase and well connection.
-    std::vector<double>& mutable_perfPhaseRates() { return perfphaserates_; }
-    const std::vector<double>& perfPhaseRates() const { return perfphaserates_; }
+    double* perfPhaseRates(std::size_t well_index) { return perf_data_.phaseRates(well_index); }
+    const double* perfPhaseRates(std::size_t well_index) const { return perf_data_.phaseRates(well_index); }
+
+    /// Number of local connections of a well.
+    int numPerf(std::size_t well_index) const { return perf_data_.numPerf(well_index); }
 
     /// One current control per injecting well.
     Well::InjectorCMode currentInjectionControl(std::size_t well_index) const { return current_injection_controls_[well_index]; }
@@ -148,26 +161,26 @@ public:
 
     const std::vector<int>& firstPerfIndex() const
     {
-        return first_perf_index_;
+        return perf_data_.firstPerfIndex();
     }
 
     /// One rate pr well connection.
-    std::vector<double>& perfRateSolvent() { return perfRateSolvent_; }
-    const std::vector<double>& perfRateSolvent() const { return perfRateSolvent_; }
+    double* perfRateSolvent(std::size_t well_index) { return perf_data_.solventRates(well_index); }
+    const double* perfRateSolvent(std::size_t well_index) const { return perf_data_.solventRates(well_index); }
 
     /// One rate pr well
     double solventWellRate(const int w) const;
 
     /// One rate pr well connection.
-    std::vector<double>& perfRatePolymer() { return perfRatePolymer_; }
-    const std::vector<double>& perfRatePolymer() const { return perfRatePolymer_; }
+    double* perfRatePolymer(std::size_t well_index) { return perf_data_.polymerRates(well_index); }
+    const double* perfRatePolymer(std::size_t well_index) const { return perf_data_.polymerRates(well_index); }
 
     /// One rate pr well
     double polymerWellRate(const int w) const;
 
     /// One rate pr well connection.
-    std::vector<double>& perfRateBrine() { return perfRateBrine_; }
-    const std::vector<double>& perfRateBrine() const { return perfRateBrine_; }
+    double* perfRateBrine(std::size_t well_index) { return perf_data_.brineRates(well_index); }
+    const double* perfRateBrine(std::size_t well_index) const { return perf_data_.brineRates(well_index); }
 
     /// One rate pr well
     double brineWellRate(const int w) const;
@@ -270,6 +283,9 @@ public:
 
     int topSegmentIndex(const int w) const;
 
+    /// Bytes of the per well, connection and segment containers.
+    std::size_t memoryUsage() const;
+
     std::vector<double>& productivityIndex() {
         return productivity_index_;
     }
@@ -278,12 +294,13 @@ public:
         return productivity_index_;
     }
 
-    std::vector<double>& connectionProductivityIndex() {
-        return this->conn_productivity_index_;
+    /// One productivity index per phase and well connection.
+    double* connectionProductivityIndex(std::size_t well_index) {
+        return perf_data_.prodIndex(well_index);
     }
 
-    const std::vector<double>& connectionProductivityIndex() const {
-        return this->conn_productivity_index_;
+    const double* connectionProductivityIndex(std::size_t well_index) const {
+        return perf_data_.prodIndex(well_index);
     }
 
     std::vector<double>& wellPotentials() {
@@ -294,36 +311,45 @@ public:
         return well_potentials_;
     }
 
-    std::vector<double>& perfThroughput() {
-        return perf_water_throughput_;
+    double* perfThroughput(std::size_t well_index) {
+        return perf_data_.waterThroughput(well_index);
     }
 
-    const std::vector<double>& perfThroughput() const {
-        return perf_water_throughput_;
+    const double* perfThroughput(std::size_t well_index) const {
+        return perf_data_.waterThroughput(well_index);
     }
 
-    std::vector<double>& perfSkinPressure() {
-        return perf_skin_pressure_;
+    double* perfSkinPressure(std::size_t well_index) {
+        return perf_data_.skinPressure(well_index);
     }
 
-    const std::vector<double>& perfSkinPressure() const {
-        return perf_skin_pressure_;
+    const double* perfSkinPressure(std::size_t well_index) const {
+        return perf_data_.skinPressure(well_index);
     }
 
-    std::vector<double>& perfWaterVelocity() {
-        return perf_water_velocity_;
+    double* perfWaterVelocity(std::size_t well_index) {
+        return perf_data_.waterVelocity(well_index);
     }
 
-    const std::vector<double>& perfWaterVelocity() const {
-        return perf_water_velocity_;
+    const double* perfWaterVelocity(std::size_t well_index) const {
+        return perf_data_.waterVelocity(well_index);
     }
 
+    /// Sum the well rates, the ALQ values and the group rates of
+    /// group_state over all processes with a single collective call.
     template<class Comm>
-    void communicateGroupRates(const Comm& comm);
+    void communicateGroupRates(const Comm& comm, GroupState& group_state);
 
     template<class Comm>
     void updateGlobalIsGrup(const Comm& comm);
 
+    /// Write and read the dynamic state of the wells in a binary checkpoint.
+    /// Reading requires that the state was initialized for the same wells
+    /// and connections as when the checkpoint was written, e.g. by
+    /// beginning the same report step.
+    void writeCheckpoint(std::ostream& os) const;
+    void readCheckpoint(std::istream& is);
+
     bool isInjectionGrup(const std::string& name) const {
         return this->global_well_info.value().in_injecting_group(name);
     }
@@ -437,16 +463,12 @@ public:
     const std::vector<double>& wellRates(std::size_t well_index) const { return wellrates_[well_index]; }
 
     /// One rate per well connection.
-    std::vector<double>& perfRates(std::size_t well_index) { return this->perfrates_[well_index]; }
-    const std::vector<double>& perfRates(std::size_t well_index) const { return this->perfrates_[well_index]; }
-    std::vector<double>& perfRates(const std::string& wname) { return this->perfrates_[wname]; }
-    const std::vector<double>& perfRates(const std::string& wname) const { return this->perfrates_[wname]; }
+    double* perfRates(std::size_t well_index) { return perf_data_.rates(well_index); }
+    const double* perfRates(std::size_t well_index) const { return perf_data_.rates(well_index); }
 
     /// One pressure per well connection.
-    std::vector<double>& perfPress(std::size_t well_index) { return perfpress_[well_index]; }
-    const std::vector<double>& perfPress(std::size_t well_index) const { return perfpress_[well_index]; }
-    std::vector<double>& perfPress(const std::string& wname) { return perfpress_[wname]; }
-    const std::vector<double>& perfPress(const std::string& wname) const { return perfpress_[wname]; }
+    double* perfPress(std::size_t well_index) { return perf_data_.pressure(well_index); }
+    const double* perfPress(std::size_t well_index) const { return perf_data_.pressure(well_index); }
 
 
 
@@ -467,17 +489,12 @@ private:
     WellContainer<double> temperature_;
     WellContainer<std::vector<double>> wellrates_;
     PhaseUsage phase_usage_;
-    WellContainer<std::vector<double>> perfrates_;
-    WellContainer<std::vector<double>> perfpress_;
 
-    std::vector<double> perfphaserates_;
+    // All the per connection quantities, see PerfData.
+    PerfData perf_data_;
+
     WellContainer<int> is_producer_; // Size equal to number of local wells.
 
-    // vector with size number of wells +1.
-    // iterate over all perforations of a given well
-    // for (int perf = first_perf_index_[well_index]; perf < first_perf_index_[well_index] + num_perf_[well_index]; ++perf)
-    std::vector<int> first_perf_index_;
-    std::vector<int> num_perf_;
     WellContainer<Opm::Well::InjectorCMode> current_injection_controls_;
     WellContainer<Well::ProducerCMode> current_production_controls_;
 
@@ -487,25 +504,6 @@ private:
     std::map<std::string, std::pair<bool, std::vector<double>>> well_rates;
 
 
-    std::vector<double> perfRateSolvent_;
-
-    // only for output
-    std::vector<double> perfRatePolymer_;
-    std::vector<double> perfRateBrine_;
-
-    // it is the throughput of water flow through the perforations
-    // it is used as a measure of formation damage around well-bore due to particle deposition
-    // it will only be used for injectors to check the injectivity
-    std::vector<double> perf_water_throughput_;
-
-    // skin pressure of peforation
-    // it will only be used for injectors to check the injectivity
-    std::vector<double> perf_skin_pressure_;
-
-    // it will only be used for injectors to check the injectivity
-    // water velocity of perforation
-    std::vector<double> perf_water_velocity_;
-
     // phase rates under reservoir condition for wells
     // or voidage phase rates
     WellContainer<std::vector<double>> well_reservoir_rates_;
@@ -543,9 +541,6 @@ private:
     // Productivity Index
     std::vector<double> productivity_index_;
 
-    // Connection-level Productivity Index
-    std::vector<double> conn_productivity_index_;
-
     // Well potentials
     std::vector<double> well_potentials_;
 
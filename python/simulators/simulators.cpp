@@ -29,10 +29,15 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pybind11/embed.h>
+#include <pybind11/stl.h>
 // NOTE: EXIT_SUCCESS, EXIT_FAILURE is defined in cstdlib
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <opm/simulators/flow/python/simulators.hpp>
 
 namespace py = pybind11;
@@ -43,6 +48,37 @@ BlackOilSimulator::BlackOilSimulator( const std::string &deckFilename)
 {
 }
 
+BlackOilSimulator::BlackOilSimulator( const Opm::Deck& deck,
+                                      const Opm::EclipseState& eclipseState,
+                                      const Opm::Schedule& schedule,
+                                      const Opm::SummaryConfig& summaryConfig)
+    : deck_{std::make_unique<Opm::Deck>(deck)}
+    , eclipseState_{std::make_unique<Opm::EclipseState>(eclipseState)}
+    , schedule_{std::make_unique<Opm::Schedule>(schedule)}
+    , summaryConfig_{std::make_unique<Opm::SummaryConfig>(summaryConfig)}
+{
+}
+
+std::unique_ptr<Opm::Main> BlackOilSimulator::createMain_()
+{
+    if (!eclipseState_) {
+        return std::make_unique<Opm::Main>( deckFilename_ );
+    }
+    // Main takes over the input, keep a copy for a later run().
+    return std::make_unique<Opm::Main>( std::make_unique<Opm::Deck>(*deck_),
+                                        std::make_unique<Opm::EclipseState>(*eclipseState_),
+                                        std::make_unique<Opm::Schedule>(*schedule_),
+                                        std::make_unique<Opm::SummaryConfig>(*summaryConfig_) );
+}
+
+py::array_t<double> BlackOilSimulator::getPermeability()
+{
+    checkInitialized_("get_permeability()");
+    std::size_t len;
+    auto array = materialState_->getPermeability(&len);
+    return py::array_t<double>({len / 3, std::size_t{3}}, array.get());
+}
+
 py::array_t<double> BlackOilSimulator::getPorosity()
 {
     std::size_t len;
@@ -50,10 +86,69 @@ py::array_t<double> BlackOilSimulator::getPorosity()
     return py::array(len, array.get());
 }
 
+py::array_t<double> BlackOilSimulator::getPorosityView()
+{
+    checkInitialized_("get_porosity_view()");
+    std::size_t len;
+    double *data = materialState_->porosityData(&len);
+    // The simulator owns the data, the view keeps it alive.
+    return py::array_t<double>({len}, {sizeof(double)}, data, py::cast(this));
+}
+
+py::array_t<double> BlackOilSimulator::getPrimaryVariablesView()
+{
+    checkInitialized_("get_primary_variables_view()");
+    std::size_t len, numEq, cellStride;
+    double *data = materialState_->primaryVariablesData(&len, &numEq, &cellStride);
+    return py::array_t<double>({len, numEq}, {cellStride, sizeof(double)},
+                               data, py::cast(this));
+}
+
+py::array_t<double> BlackOilSimulator::getPressures()
+{
+    checkInitialized_("get_pressures()");
+    const std::size_t numPhases = materialState_->numPhases();
+    const std::size_t len = ebosSimulator_->model().numGridDof();
+    py::array_t<double> array({len, numPhases});
+    materialState_->getPressures(array.mutable_data(), array.size());
+    return array;
+}
+
+py::array_t<double> BlackOilSimulator::getSaturations()
+{
+    checkInitialized_("get_saturations()");
+    const std::size_t numPhases = materialState_->numPhases();
+    const std::size_t len = ebosSimulator_->model().numGridDof();
+    py::array_t<double> array({len, numPhases});
+    materialState_->getSaturations(array.mutable_data(), array.size());
+    return array;
+}
+
+std::vector<std::string> BlackOilSimulator::getWellNames()
+{
+    checkInitialized_("get_well_names()");
+    return wellNames_();
+}
+
+py::array_t<double> BlackOilSimulator::getWellRates()
+{
+    checkInitialized_("get_well_rates()");
+    const auto& wellState = ebosSimulator_->problem().wellModel().wellState();
+    const std::size_t numWells = wellState.numWells();
+    const std::size_t numPhases = wellState.numPhases();
+    py::array_t<double> array({numWells, numPhases});
+    double *rates = array.mutable_data();
+    for (std::size_t wellIdx = 0; wellIdx < numWells; ++wellIdx) {
+        const auto& wellRates = wellState.wellRates(wellIdx);
+        std::copy(wellRates.begin(), wellRates.end(), rates + wellIdx * numPhases);
+    }
+    return array;
+}
+
 int BlackOilSimulator::run()
 {
-    auto mainObject = Opm::Main( deckFilename_ );
-    return mainObject.runDynamic();
+    auto mainObject = createMain_();
+    return mainObject->runDynamic();
 }
 
 void BlackOilSimulator::setPorosity( py::array_t<double,
@@ -64,6 +159,48 @@ void BlackOilSimulator::setPorosity( py::array_t<double,
     materialState_->setPorosity(poro, size_);
 }
 
+void BlackOilSimulator::setPermeability( py::array_t<double,
+    py::array::c_style | py::array::forcecast> array)
+{
+    checkInitialized_("set_permeability()");
+    materialState_->setPermeability(array.data(), array.size());
+}
+
+void BlackOilSimulator::setTransmissibilities(
+    py::array_t<int, py::array::c_style | py::array::forcecast> cells1,
+    py::array_t<int, py::array::c_style | py::array::forcecast> cells2,
+    py::array_t<double, py::array::c_style | py::array::forcecast> trans)
+{
+    checkInitialized_("set_transmissibilities()");
+    if (cells1.size() != trans.size() || cells2.size() != trans.size()) {
+        throw std::runtime_error("Cannot set transmissibilities. "
+                                 "The arrays differ in size");
+    }
+    materialState_->setTransmissibilities(cells1.data(), cells2.data(),
+                                          trans.data(), trans.size());
+}
+
+void BlackOilSimulator::setWellRates( py::array_t<double,
+    py::array::c_style | py::array::forcecast> array)
+{
+    checkInitialized_("set_well_rates()");
+    auto& wellState = ebosSimulator_->problem().wellModel().wellState();
+    const std::size_t numWells = wellState.numWells();
+    const std::size_t numPhases = wellState.numPhases();
+    if (static_cast<std::size_t>(array.size()) != numWells * numPhases) {
+        std::ostringstream message;
+        message << "Cannot set well rates. Expected array of size: "
+                << numWells * numPhases << ", got array of size: " << array.size();
+        throw std::runtime_error(message.str());
+    }
+    const double *rates = array.data();
+    for (std::size_t wellIdx = 0; wellIdx < numWells; ++wellIdx) {
+        auto& wellRates = wellState.wellRates(wellIdx);
+        std::copy(rates + wellIdx * numPhases, rates + (wellIdx + 1) * numPhases,
+                  wellRates.begin());
+    }
+}
+
 int BlackOilSimulator::step()
 {
     if (!hasRunInit_) {
@@ -93,7 +230,7 @@ int BlackOilSimulator::stepInit()
             return EXIT_SUCCESS;
         }
     }
-    main_ = std::make_unique<Opm::Main>( deckFilename_ );
+    main_ = createMain_();
     int exitCode = EXIT_SUCCESS;
     mainEbos_ = main_->initFlowEbosBlackoil(exitCode);
     if (mainEbos_) {
@@ -109,6 +246,23 @@ int BlackOilSimulator::stepInit()
     }
 }
 
+void BlackOilSimulator::checkInitialized_(const char *method) const
+{
+    if (!hasRunInit_) {
+        throw std::logic_error(std::string(method) + " called before step_init()");
+    }
+}
+
+std::vector<std::string> BlackOilSimulator::wellNames_() const
+{
+    const auto& wellState = ebosSimulator_->problem().wellModel().wellState();
+    std::vector<std::string> names(wellState.numWells());
+    for (const auto& [name, entry] : wellState.wellMap()) {
+        names[entry[0]] = name;
+    }
+    return names;
+}
+
 } // namespace Opm::Pybind
 
 PYBIND11_MODULE(simulators, m)
@@ -116,10 +270,24 @@ PYBIND11_MODULE(simulators, m)
     using namespace Opm::Pybind;
     py::class_<BlackOilSimulator>(m, "BlackOilSimulator")
         .def(py::init< const std::string& >())
+        .def(py::init< const Opm::Deck&,
+                       const Opm::EclipseState&,
+                       const Opm::Schedule&,
+                       const Opm::SummaryConfig& >())
+        .def("get_permeability", &BlackOilSimulator::getPermeability)
         .def("get_porosity", &BlackOilSimulator::getPorosity,
             py::return_value_policy::copy)
+        .def("get_porosity_view", &BlackOilSimulator::getPorosityView)
+        .def("get_pressures", &BlackOilSimulator::getPressures)
+        .def("get_primary_variables_view", &BlackOilSimulator::getPrimaryVariablesView)
+        .def("get_saturations", &BlackOilSimulator::getSaturations)
+        .def("get_well_names", &BlackOilSimulator::getWellNames)
+        .def("get_well_rates", &BlackOilSimulator::getWellRates)
         .def("run", &BlackOilSimulator::run)
+        .def("set_permeability", &BlackOilSimulator::setPermeability)
         .def("set_porosity", &BlackOilSimulator::setPorosity)
+        .def("set_transmissibilities", &BlackOilSimulator::setTransmissibilities)
+        .def("set_well_rates", &BlackOilSimulator::setWellRates)
         .def("step", &BlackOilSimulator::step)
         .def("step_init", &BlackOilSimulator::stepInit)
         .def("step_cleanup", &BlackOilSimulator::stepCleanup);
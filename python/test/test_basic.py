@@ -73,3 +73,28 @@ class TestBasic(unittest.TestCase):
             poro2 = sim.get_porosity()
             self.assertAlmostEqual(poro2[0], 0.285, places=7, msg='value of porosity 2')
 
+            poro_view = sim.get_porosity_view()
+            self.assertEqual(len(poro_view), 300, 'length of porosity view')
+            poro_view[1] = 0.25
+            self.assertAlmostEqual(sim.get_porosity()[1], 0.25, places=7, msg='porosity set through view')
+            primary_vars = sim.get_primary_variables_view()
+            self.assertEqual(primary_vars.shape, (300, 3), 'shape of primary variables view')
+            saturations = sim.get_saturations()
+            self.assertEqual(saturations.shape, (300, 3), 'shape of saturations')
+            self.assertAlmostEqual(saturations[0].sum(), 1.0, places=7, msg='sum of saturations')
+            self.assertEqual(sim.get_pressures().shape, (300, 3), 'shape of pressures')
+            self.assertEqual(sorted(sim.get_well_names()), ['INJ', 'PROD'], 'well names')
+            rates = sim.get_well_rates()
+            self.assertEqual(rates.shape, (2, 3), 'shape of well rates')
+            sim.set_well_rates(rates)
+
+            perm = sim.get_permeability()
+            self.assertEqual(perm.shape, (300, 3), 'shape of permeability')
+            sim.set_permeability(perm * 0.5)
+            self.assertAlmostEqual(sim.get_permeability()[0, 0], 0.5 * perm[0, 0],
+                                   msg='permeability set from Python')
+            sim.set_transmissibilities([0], [1], [1.0e-12])
+            with self.assertRaises(RuntimeError):
+                sim.set_transmissibilities([0], [299], [1.0e-12])
+            sim.step()
+
@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# This runs a simulator with a fixed number of processes and threads,
+# sums the time of every timer over the report steps and compares the
+# totals against a baseline. A timer fails if it is slower than the
+# baseline by more than both the relative and the absolute tolerance.
+# Without a baseline, the totals of the run are stored as the baseline.
+
+INPUT_DATA_PATH="$1"
+RESULT_PATH="$2"
+BINPATH="$3"
+FILENAME="$4"
+MPI_PROCS="$5"
+THREADS="$6"
+REL_TOL="$7"
+ABS_TOL="$8"
+BASELINE_DIR="$9"
+EXE_NAME="${10}"
+shift 10
+TEST_ARGS="$@"
+
+rm -Rf ${RESULT_PATH}
+mkdir -p ${RESULT_PATH}
+cd ${RESULT_PATH}
+
+export OMP_NUM_THREADS=${THREADS}
+RUN_ARGS="${TEST_ARGS} --threads-per-process=${THREADS} --timer-csv-file-name=${RESULT_PATH}/${FILENAME}.timers.csv --output-dir=${RESULT_PATH}"
+if (( ${MPI_PROCS} > 1))
+then
+  mpirun -np ${MPI_PROCS} ${BINPATH}/${EXE_NAME} ${RUN_ARGS}
+else
+  ${BINPATH}/${EXE_NAME} ${RUN_ARGS}
+fi
+test $? -eq 0 || exit 1
+
+# Total of the slowest process over all report steps, per timer.
+# Columns: report step,timer,calls,min,average,max
+TOTALS=${RESULT_PATH}/${FILENAME}.perf.csv
+awk -F, 'NR > 1 { total[$2] += $6 } END { for (t in total) printf "%s,%.6f\n", t, total[t] }' \
+    ${RESULT_PATH}/${FILENAME}.timers.csv | sort > ${TOTALS}
+
+BASELINE=${BASELINE_DIR}/${EXE_NAME}/${FILENAME}_np${MPI_PROCS}_t${THREADS}.perf.csv
+if [ ! -f ${BASELINE} ]
+then
+  echo "=== No baseline ${BASELINE}, storing the timers of this run ==="
+  mkdir -p `dirname ${BASELINE}`
+  cp ${TOTALS} ${BASELINE}
+  exit 0
+fi
+
+echo "=== Comparing the timers against ${BASELINE} ==="
+awk -F, -v rel_tol=${REL_TOL} -v abs_tol=${ABS_TOL} '
+  NR == FNR { baseline[$1] = $2; next }
+  ($1 in baseline) {
+    base = baseline[$1]
+    status = "ok"
+    if ($2 - base > abs_tol && $2 > base * (1 + rel_tol)) {
+      status = "SLOWER"
+      failed = 1
+    }
+    printf "%-50s %12.3f %12.3f %8.1f%%  %s\n", $1, base, $2, (base > 0 ? 100 * ($2 / base - 1) : 0), status
+  }
+  END { exit failed }' ${BASELINE} ${TOTALS}
@@ -652,6 +652,23 @@ TEST_FOR_TYPE(WellType)
 TEST_FOR_TYPE(WListManager)
 
 
+BOOST_AUTO_TEST_CASE(PackedSizes)
+{
+    auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    const std::vector<double> values{1.0, 2.0, 3.0};
+    BOOST_CHECK_EQUAL(Opm::Mpi::packSize(values, comm),
+                      sizeof(std::size_t) + values.size()*sizeof(double));
+    const std::string name{"PROD"};
+    BOOST_CHECK_EQUAL(Opm::Mpi::packSize(name, comm),
+                      sizeof(std::size_t) + name.size() + 1);
+
+    // Packing more than the buffer holds is an error.
+    std::vector<char> buffer(sizeof(double));
+    int position = 0;
+    BOOST_CHECK_THROW(Opm::Mpi::pack(values, buffer, position, comm), std::logic_error);
+}
+
+
 bool init_unit_test_func()
 {
     return true;
@@ -0,0 +1,63 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/wells/PerfData.hpp>
+
+#define BOOST_TEST_MODULE PerfDataTest
+#include <boost/test/unit_test.hpp>
+
+using namespace Opm;
+
+
+BOOST_AUTO_TEST_CASE(PerfDataLayout) {
+    PerfData perf_data;
+    perf_data.init({2, 0, 3}, 3);
+
+    BOOST_CHECK_EQUAL(perf_data.numWells(), 3U);
+    BOOST_CHECK_EQUAL(perf_data.numPerf(0), 2);
+    BOOST_CHECK_EQUAL(perf_data.numPerf(1), 0);
+    BOOST_CHECK_EQUAL(perf_data.numPerf(2), 3);
+    BOOST_CHECK_EQUAL(perf_data.firstPerfIndex()[2], 2);
+    BOOST_CHECK_EQUAL(perf_data.firstPerfIndex()[3], 5);
+
+    // The quantities of one well follow each other without gaps.
+    BOOST_CHECK_EQUAL(perf_data.prodIndex(0) - perf_data.phaseRates(0), 6);
+    BOOST_CHECK_EQUAL(perf_data.pressure(0) - perf_data.prodIndex(0), 6);
+    BOOST_CHECK_EQUAL(perf_data.rates(0) - perf_data.pressure(0), 2);
+    BOOST_CHECK_EQUAL(perf_data.waterVelocity(0) - perf_data.skinPressure(0), 2);
+    BOOST_CHECK_EQUAL(perf_data.phaseRates(2) - perf_data.waterVelocity(0), 2);
+    BOOST_CHECK(perf_data.phaseRates(1) == perf_data.phaseRates(2));
+
+    for (int perf = 0; perf < 3; ++perf) {
+        BOOST_CHECK_EQUAL(perf_data.pressure(2)[perf], 0.0);
+        perf_data.pressure(2)[perf] = 100 + perf;
+        perf_data.waterVelocity(2)[perf] = perf;
+    }
+    for (int i = 0; i < 3*3; ++i)
+        perf_data.phaseRates(2)[i] = i;
+
+    const PerfData copy = perf_data;
+    BOOST_CHECK_EQUAL(copy.pressure(2)[1], 101);
+    BOOST_CHECK_EQUAL(copy.waterVelocity(2)[2], 2);
+    BOOST_CHECK_EQUAL(copy.phaseRates(2)[8], 8);
+    BOOST_CHECK_EQUAL(copy.rates(2)[0], 0);
+    BOOST_CHECK_THROW(copy.numPerf(3), std::exception);
+}
@@ -0,0 +1,80 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AdaptiveSolverSelectorTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/AdaptiveSolverSelector.hpp>
+
+BOOST_AUTO_TEST_CASE(TrialAlternatesAndPicksFaster)
+{
+    Opm::AdaptiveSolverSelector selector(2, 3.0);
+
+    // Trial: accelerator, Dune, accelerator, Dune.
+    BOOST_CHECK(selector.inTrial());
+    BOOST_CHECK(selector.useAccelerator());
+    selector.report(true, 1.0, 10, true);
+    BOOST_CHECK(!selector.useAccelerator());
+    selector.report(false, 3.0, 5, true);
+    BOOST_CHECK(selector.useAccelerator());
+    selector.report(true, 1.0, 12, true);
+    BOOST_CHECK(!selector.useAccelerator());
+    BOOST_CHECK(selector.report(false, 3.0, 5, true));
+    BOOST_CHECK(!selector.inTrial());
+    BOOST_CHECK(selector.useAccelerator());
+    BOOST_CHECK_CLOSE(selector.averageSeconds(true), 1.0, 1e-12);
+    BOOST_CHECK_CLOSE(selector.averageSeconds(false), 3.0, 1e-12);
+
+    // Stays with the accelerator while the iterations are within 3 x 12.
+    BOOST_CHECK(!selector.report(true, 1.0, 30, true));
+    BOOST_CHECK(selector.useAccelerator());
+
+    // Switches back to Dune when the iterations blow up.
+    BOOST_CHECK(selector.report(true, 5.0, 37, true));
+    BOOST_CHECK(!selector.useAccelerator());
+
+    // A new report step starts a new trial with the accelerator.
+    selector.newReportStep();
+    BOOST_CHECK(selector.inTrial());
+    BOOST_CHECK(selector.useAccelerator());
+}
+
+BOOST_AUTO_TEST_CASE(DunePickedWhenFaster)
+{
+    Opm::AdaptiveSolverSelector selector(1, 3.0);
+    selector.report(true, 2.0, 10, true);
+    selector.report(false, 1.0, 5, true);
+    BOOST_CHECK(!selector.inTrial());
+    BOOST_CHECK(!selector.useAccelerator());
+}
+
+BOOST_AUTO_TEST_CASE(AcceleratorFailureEndsTrial)
+{
+    Opm::AdaptiveSolverSelector selector(4, 3.0);
+    BOOST_CHECK(selector.report(true, 1.0, 200, false));
+    BOOST_CHECK(!selector.inTrial());
+    BOOST_CHECK(!selector.useAccelerator());
+
+    // Dune solves do not change the choice.
+    selector.report(false, 10.0, 5, true);
+    BOOST_CHECK(!selector.useAccelerator());
+}
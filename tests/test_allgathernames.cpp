@@ -0,0 +1,89 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestAllGatherNames
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/allGatherNames.hpp>
+
+#include <string>
+#include <vector>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+namespace
+{
+
+    // The names of a process, a shared one and one more of its own than the
+    // process before.
+    std::vector<std::string> namesOf(const int rank)
+    {
+        std::vector<std::string> names{"SHARED"};
+        for (int i = 0; i < rank; ++i) {
+            names.push_back("R" + std::to_string(rank) + "_" + std::to_string(i));
+        }
+        return names;
+    }
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(AllGatherNames)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+
+    const auto allNames = Opm::allGatherNames(cc, namesOf(cc.rank()));
+
+    std::vector<std::string> expected;
+    for (int rank = 0; rank < cc.size(); ++rank) {
+        const auto names = namesOf(rank);
+        expected.insert(expected.end(), names.begin(), names.end());
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(allNames.begin(), allNames.end(),
+                                  expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(EmptyNames)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+
+    // Only the last process has names, one of them empty.
+    std::vector<std::string> names;
+    if (cc.rank() == cc.size() - 1) {
+        names = {"", "LAST"};
+    }
+    const auto allNames = Opm::allGatherNames(cc, names);
+
+    BOOST_REQUIRE_EQUAL(allNames.size(), 2u);
+    BOOST_CHECK_EQUAL(allNames[0], "");
+    BOOST_CHECK_EQUAL(allNames[1], "LAST");
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
@@ -0,0 +1,82 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BinaryCheckpointTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <array>
+#include <sstream>
+
+namespace {
+
+enum class Mode { Rate, Pressure };
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+    const double value = 0.1 + 0.2;
+    const std::vector<double> rates{1.0 / 3.0, -2.5e-9, 7.0};
+    const std::vector<bool> flags{true, false, true};
+    const std::map<std::string, std::vector<double>> groupRates{{"G1", {1.0, 2.0}}, {"FIELD", {}}};
+    const std::map<std::pair<int, std::string>, Mode> controls{{{1, "G1"}, Mode::Pressure}};
+    const std::map<std::string, std::array<int, 3>> wells{{"PROD", {0, 0, 5}}, {"INJ", {1, 5, 2}}};
+
+    std::stringstream stream;
+    Opm::BinaryCheckpoint::write(stream, value);
+    Opm::BinaryCheckpoint::write(stream, rates);
+    Opm::BinaryCheckpoint::write(stream, flags);
+    Opm::BinaryCheckpoint::write(stream, groupRates);
+    Opm::BinaryCheckpoint::write(stream, controls);
+    Opm::BinaryCheckpoint::write(stream, wells);
+
+    double valueRead = 0.0;
+    std::vector<double> ratesRead;
+    std::vector<bool> flagsRead;
+    std::map<std::string, std::vector<double>> groupRatesRead{{"OLD", {3.0}}};
+    std::map<std::pair<int, std::string>, Mode> controlsRead;
+    Opm::BinaryCheckpoint::read(stream, valueRead);
+    Opm::BinaryCheckpoint::read(stream, ratesRead);
+    Opm::BinaryCheckpoint::read(stream, flagsRead);
+    Opm::BinaryCheckpoint::read(stream, groupRatesRead);
+    Opm::BinaryCheckpoint::read(stream, controlsRead);
+    Opm::BinaryCheckpoint::readExpected(stream, wells, "wells");
+
+    // bitwise identical, not only close
+    BOOST_CHECK_EQUAL(valueRead, value);
+    BOOST_CHECK(ratesRead == rates);
+    BOOST_CHECK(flagsRead == flags);
+    BOOST_CHECK(groupRatesRead == groupRates);
+    BOOST_CHECK(controlsRead == controls);
+
+    BOOST_CHECK_THROW(Opm::BinaryCheckpoint::read(stream, valueRead), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(MismatchIsDetected)
+{
+    std::stringstream stream;
+    Opm::BinaryCheckpoint::write(stream, std::vector<int>{0, 3, 5});
+    BOOST_CHECK_THROW(Opm::BinaryCheckpoint::readExpected(stream, std::vector<int>{0, 3, 6}, "well connections"),
+                      std::runtime_error);
+}
@@ -0,0 +1,144 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BinarySystemDumpTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+void checkEqual(const Opm::Helper::SparseBlockMatrix& a, const Opm::Helper::SparseBlockMatrix& b)
+{
+    BOOST_CHECK_EQUAL(a.rows, b.rows);
+    BOOST_CHECK_EQUAL(a.cols, b.cols);
+    BOOST_CHECK_EQUAL(a.blockRows, b.blockRows);
+    BOOST_CHECK_EQUAL(a.blockCols, b.blockCols);
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.rowStart.begin(), a.rowStart.end(), b.rowStart.begin(), b.rowStart.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.columns.begin(), a.columns.end(), b.columns.begin(), b.columns.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.values.begin(), a.values.end(), b.values.begin(), b.values.end());
+}
+
+Opm::Helper::BinarySystem testSystem()
+{
+    const int bz = 2;
+    const int n = 5;
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+    Matrix A(n, n, 3, 0.4, Matrix::implicit);
+    for (int row = 0; row < n; ++row) {
+        for (int col = std::max(row - 1, 0); col <= std::min(row + 1, n - 1); ++col) {
+            auto& block = A.entry(row, col);
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    block[i][j] = 1.0 + 0.1*row - 0.3*col + 0.7*i - 0.2*j;
+                }
+            }
+        }
+    }
+    A.compress();
+
+    // A standard well with 3 equations perforated in cells 1 and 3.
+    using WellMatrix = Dune::BCRSMatrix<Dune::DynamicMatrix<double>>;
+    WellMatrix B(1, n, 2, 0.4, WellMatrix::implicit);
+    B.entry(0, 1) = Dune::DynamicMatrix<double>(3, bz, 2.0);
+    B.entry(0, 3) = Dune::DynamicMatrix<double>(3, bz, -1.0);
+    B.compress();
+    WellMatrix D(1, 1, 1, 0.4, WellMatrix::implicit);
+    D.entry(0, 0) = Dune::DynamicMatrix<double>(3, 3, 0.5);
+    D.compress();
+
+    Opm::Helper::BinarySystem system;
+    system.matrix = Opm::Helper::SparseBlockMatrix::from(A);
+    system.rhs = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0};
+    system.ghostRows = {0, 0, 0, 1, 1};
+    Opm::Helper::WellSystemBlocks well;
+    well.name = "PROD \"1\"";
+    well.B = Opm::Helper::SparseBlockMatrix::from(B);
+    well.C = well.B;
+    well.D = Opm::Helper::SparseBlockMatrix::from(D);
+    well.inverseD = true;
+    system.wells.push_back(well);
+    return system;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(BlocksAreCopied)
+{
+    const auto system = testSystem();
+    const auto& A = system.matrix;
+    BOOST_CHECK_EQUAL(A.rows, 5);
+    BOOST_CHECK_EQUAL(A.blockRows, 2);
+    BOOST_REQUIRE_EQUAL(A.rowStart.size(), 6u);
+    BOOST_CHECK_EQUAL(A.rowStart[1], 2);
+    BOOST_CHECK_EQUAL(A.rowStart[5], 13);
+    // Block (1, 2), entry (1, 0)
+    BOOST_CHECK_EQUAL(A.columns[A.rowStart[1] + 2], 2);
+    BOOST_CHECK_CLOSE(A.values[(A.rowStart[1] + 2)*4 + 2], 1.0 + 0.1 - 0.6 + 0.7, 1e-12);
+
+    const auto& B = system.wells[0].B;
+    BOOST_CHECK_EQUAL(B.blockRows, 3);
+    BOOST_CHECK_EQUAL(B.blockCols, 2);
+    BOOST_CHECK_EQUAL(B.columns.size(), 2u);
+    BOOST_CHECK_EQUAL(B.values.size(), 12u);
+    BOOST_CHECK_EQUAL(B.values[6], -1.0);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+    const auto system = testSystem();
+    std::stringstream stream;
+    Opm::Helper::writeBinarySystem(stream, system);
+    const auto read = Opm::Helper::readBinarySystem(stream);
+
+    checkEqual(read.matrix, system.matrix);
+    BOOST_CHECK_EQUAL_COLLECTIONS(read.rhs.begin(), read.rhs.end(), system.rhs.begin(), system.rhs.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(read.ghostRows.begin(), read.ghostRows.end(),
+                                  system.ghostRows.begin(), system.ghostRows.end());
+    BOOST_REQUIRE_EQUAL(read.wells.size(), 1u);
+    BOOST_CHECK_EQUAL(read.wells[0].name, system.wells[0].name);
+    BOOST_CHECK(read.wells[0].inverseD);
+    checkEqual(read.wells[0].B, system.wells[0].B);
+    checkEqual(read.wells[0].C, system.wells[0].C);
+    checkEqual(read.wells[0].D, system.wells[0].D);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidInput)
+{
+    std::stringstream notASystem("%%MatrixMarket matrix coordinate real general\n");
+    BOOST_CHECK_THROW(Opm::Helper::readBinarySystem(notASystem), std::runtime_error);
+
+    std::stringstream stream;
+    Opm::Helper::writeBinarySystem(stream, testSystem());
+    const std::string data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() / 2));
+    BOOST_CHECK_THROW(Opm::Helper::readBinarySystem(truncated), std::runtime_error);
+}
@@ -0,0 +1,114 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BlockSpMVTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/simulators/linalg/blockSpMV.hpp>
+
+#include <algorithm>
+
+template <int bz>
+void checkBlockSpMV()
+{
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    // Block tridiagonal matrix with distinct entries in every block.
+    const int n = 50;
+    Matrix A(n, n, 3, 0.4, Matrix::implicit);
+    for (int row = 0; row < n; ++row) {
+        for (int col = std::max(row - 1, 0); col <= std::min(row + 1, n - 1); ++col) {
+            auto& block = A.entry(row, col);
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    block[i][j] = 1.0 + 0.1*row - 0.3*col + 0.7*i - 0.2*j + (row == col && i == j ? 4.0 : 0.0);
+                }
+            }
+        }
+    }
+    A.compress();
+
+    Vector x(n);
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            x[row][i] = 0.5 - 0.01*row + 0.25*i;
+        }
+    }
+
+    Vector yRef(n), y(n);
+    A.mv(x, yRef);
+    y = 42.0;
+    Opm::blockSpMV(A, x, y, A.N());
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            BOOST_CHECK_CLOSE(y[row][i], yRef[row][i], 1e-12);
+        }
+    }
+
+    // Only the requested leading rows are touched.
+    const std::size_t interior = n/2;
+    y = 42.0;
+    Opm::blockSpMV(A, x, y, interior);
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            const double expected = row < static_cast<int>(interior) ? yRef[row][i] : 42.0;
+            BOOST_CHECK_CLOSE(y[row][i], expected, 1e-12);
+        }
+    }
+
+    const double alpha = -0.75;
+    yRef = 1.5;
+    A.usmv(alpha, x, yRef);
+    y = 1.5;
+    Opm::blockSpMVScaleAdd(alpha, A, x, y, A.N());
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            BOOST_CHECK_CLOSE(y[row][i], yRef[row][i], 1e-12);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockSpMV1)
+{
+    checkBlockSpMV<1>();
+}
+
+BOOST_AUTO_TEST_CASE(BlockSpMV2)
+{
+    checkBlockSpMV<2>();
+}
+
+BOOST_AUTO_TEST_CASE(BlockSpMV3)
+{
+    checkBlockSpMV<3>();
+}
+
+BOOST_AUTO_TEST_CASE(BlockSpMV4)
+{
+    checkBlockSpMV<4>();
+}
@@ -0,0 +1,166 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ChainCondensationTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/ChainCondensation.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int bs = 2;
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bs, bs>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bs>>;
+
+// Four reservoir cells in a row and a chain of three cells (4, 5, 6) whose
+// first cell is connected to the reservoir cells 1 and 3.
+Matrix aquiferMatrix(const bool chainShortcut = false)
+{
+    std::vector<std::pair<int, int>> links = {{0, 1}, {1, 2}, {2, 3}, {4, 5}, {5, 6}, {4, 1}, {4, 3}};
+    if (chainShortcut) {
+        links.emplace_back(4, 6);
+    }
+    const int n = 7;
+    std::vector<std::set<int>> pattern(n);
+    for (int i = 0; i < n; ++i) {
+        pattern[i].insert(i);
+    }
+    for (const auto& [i, j] : links) {
+        pattern[i].insert(j);
+        pattern[j].insert(i);
+    }
+
+    Matrix A(n, n, Matrix::row_wise);
+    for (auto row = A.createbegin(); row != A.createend(); ++row) {
+        for (const int j : pattern[row.index()]) {
+            row.insert(j);
+        }
+    }
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            const int i = row.index();
+            const int j = col.index();
+            for (int eq = 0; eq < bs; ++eq) {
+                for (int var = 0; var < bs; ++var) {
+                    (*col)[eq][var] = i == j
+                        ? (eq == var ? 6.0 + 0.1*i : 0.3)
+                        : -0.1*(1 + (i + 2*j + 3*eq + 5*var) % 4);
+                }
+            }
+        }
+    }
+    return A;
+}
+
+Vector exactSolution()
+{
+    Vector x(7);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i][0] = 1.0 + i;
+        x[i][1] = 0.5 - 0.25*i;
+    }
+    return x;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(CondensedSystemHasSameSolution)
+{
+    Matrix A = aquiferMatrix();
+    const Vector xExact = exactSolution();
+    Vector b(A.N());
+    A.mv(xExact, b);
+
+    Opm::ChainCondensation<Matrix, Vector> condensation({{4, 5, 6}});
+    condensation.condense(A, b);
+    BOOST_CHECK_EQUAL(condensation.numChains(), 1u);
+
+    // the chain cells are decoupled from the reservoir in the matrix
+    BOOST_CHECK(A[1][4].infinity_norm() == 0.0);
+    BOOST_CHECK(A[4][1].infinity_norm() == 0.0);
+    BOOST_CHECK_EQUAL(A[5][5][0][0], 1.0);
+    BOOST_CHECK_EQUAL(A[5][5][0][1], 0.0);
+
+    // A x - B D^-1 C x, solved to machine precision
+    struct CondensedOperator : public Dune::LinearOperator<Vector, Vector>
+    {
+        CondensedOperator(const Matrix& m, const Opm::ChainCondensation<Matrix, Vector>& c)
+            : A(m), condensation(c)
+        {}
+        void apply(const Vector& x, Vector& y) const override
+        {
+            A.mv(x, y);
+            condensation.apply(x, y);
+        }
+        void applyscaleadd(double alpha, const Vector& x, Vector& y) const override
+        {
+            A.usmv(alpha, x, y);
+            condensation.applyscaleadd(alpha, x, y);
+        }
+        Dune::SolverCategory::Category category() const override
+        {
+            return Dune::SolverCategory::sequential;
+        }
+        const Matrix& A;
+        const Opm::ChainCondensation<Matrix, Vector>& condensation;
+    } op(A, condensation);
+
+    Dune::Richardson<Vector, Vector> identity;
+    Dune::RestartedGMResSolver<Vector> solver(op, identity, 1e-14, 20, 50, 0);
+    Vector x(A.N());
+    x = 0.0;
+    Dune::InverseOperatorResult result;
+    solver.apply(x, b, result);
+    BOOST_CHECK(result.converged);
+
+    condensation.recover(x);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (int k = 0; k < bs; ++k) {
+            BOOST_CHECK_CLOSE(x[i][k], xExact[i][k], 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ChainsWhichAreNotTridiagonalAreKept)
+{
+    Matrix A = aquiferMatrix(/*chainShortcut=*/true);
+    const Matrix original = A;
+    Vector b(A.N());
+    b = 1.0;
+
+    Opm::ChainCondensation<Matrix, Vector> condensation({{4, 5, 6}});
+    condensation.condense(A, b);
+    BOOST_CHECK_EQUAL(condensation.numChains(), 0u);
+    BOOST_CHECK(A[4][1] == original[4][1]);
+    BOOST_CHECK_EQUAL(b[4][0], 1.0);
+}
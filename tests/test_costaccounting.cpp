@@ -0,0 +1,99 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestCostAccounting
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/CostAccounting.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <sstream>
+#include <string>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(Cells)
+{
+    auto& costs = Opm::CostAccounting::instance();
+    costs.clear();
+    BOOST_CHECK(!costs.enabled());
+
+    costs.enable(3);
+    BOOST_CHECK(costs.enabled());
+    costs.addCellIteration(1);
+    costs.addCellIteration(1);
+    costs.addCellIteration(2);
+    BOOST_REQUIRE_EQUAL(costs.cellCosts().size(), 3u);
+    BOOST_CHECK_EQUAL(costs.cellCosts()[0], 0.0);
+    BOOST_CHECK_EQUAL(costs.cellCosts()[1], 2.0);
+    BOOST_CHECK_EQUAL(costs.cellCosts()[2], 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(Wells)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int rank = cc.rank();
+    auto& costs = Opm::CostAccounting::instance();
+    costs.clear();
+    costs.enable(0);
+
+    // A well on every process, and a well distributed over all of them.
+    const std::string own = "W" + std::to_string(rank);
+    for (int i = 0; i <= rank; ++i) {
+        costs.addWellAssembly(own, 1.0);
+    }
+    costs.addWellSolve(own, 0.5);
+    costs.addWellAssembly("SHARED", 2.0);
+    costs.addWellAssembly("SHARED", 2.0);
+
+    const auto wellCosts = costs.wellCosts(cc);
+    BOOST_REQUIRE_EQUAL(wellCosts.size(), static_cast<std::size_t>(cc.size() + 1));
+    // Most expensive first.
+    BOOST_CHECK_EQUAL(wellCosts[0].name, "SHARED");
+    BOOST_CHECK_EQUAL(wellCosts[0].assemblies, 2);
+    BOOST_CHECK_EQUAL(wellCosts[0].assemblySeconds, 4.0 * cc.size());
+    for (std::size_t i = 1; i + 1 < wellCosts.size(); ++i) {
+        const auto& cost = wellCosts[i];
+        const auto& next = wellCosts[i + 1];
+        BOOST_CHECK_GE(cost.assemblySeconds + cost.solveSeconds, next.assemblySeconds + next.solveSeconds);
+    }
+    const auto last = wellCosts.back();
+    BOOST_CHECK_EQUAL(last.name, "W0");
+    BOOST_CHECK_EQUAL(last.assemblies, 1);
+    BOOST_CHECK_EQUAL(last.assemblySeconds, 1.0);
+    BOOST_CHECK_EQUAL(last.solveSeconds, 0.5);
+
+    std::ostringstream table;
+    Opm::CostAccounting::print(table, wellCosts);
+    BOOST_CHECK(table.str().find("\nSHARED ") != std::string::npos);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
@@ -545,6 +545,32 @@ BOOST_AUTO_TEST_CASE(CapillaryInversion)
     }
 }
 
+BOOST_AUTO_TEST_CASE(TabulatedCapillaryInversion)
+{
+    // Test setup.
+    using TypeTag = Opm::Properties::TTag::TestEquilTypeTag;
+    using FluidSystem = Opm::GetPropType<TypeTag, Opm::Properties::FluidSystem>;
+    using MaterialLaw = Opm::GetPropType<TypeTag, Opm::Properties::MaterialLaw>;
+    using MaterialLawManager = typename Opm::GetProp<TypeTag, Opm::Properties::MaterialLaw>::EclMaterialLawManager;
+
+    auto simulator = initSimulator<TypeTag>("equil_capillary.DATA");
+    const auto& materialLawManager = *simulator->problem().materialLawManager();
+    const int numCells = simulator->vanguard().gridView().size(0);
+    const Opm::EQUIL::InverseCapPressTables<FluidSystem, MaterialLaw, MaterialLawManager>
+        tables(materialLawManager, numCells);
+
+    // The table lookup must agree with the inversion of the capillary pressure curves.
+    const int cell = 0;
+    for (const auto& [phase, increasing] : { std::make_pair(int(FluidSystem::waterPhaseIdx), false),
+                                             std::make_pair(int(FluidSystem::gasPhaseIdx), true) }) {
+        for (double pc = -1.0e5; pc <= 1.0e5; pc += 0.0123e5) {
+            const double s_expected = Opm::EQUIL::satFromPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, phase, cell, pc, increasing);
+            const double s_computed = tables.satFromPc(phase, cell, pc, increasing);
+            BOOST_CHECK_SMALL(s_computed - s_expected, 1.0e-8);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(DeckWithCapillary)
 {
     using TypeTag = Opm::Properties::TTag::TestEquilTypeTag;
@@ -0,0 +1,50 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE FirstTouchAllocatorTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/FirstTouchAllocator.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(SmallAndLargeVectors)
+{
+    std::vector<double, Opm::FirstTouchAllocator<double>> small(10, 1.0);
+    BOOST_CHECK_EQUAL(std::accumulate(small.begin(), small.end(), 0.0), 10.0);
+
+    // 8 MB, aligned to huge pages
+    std::vector<double, Opm::FirstTouchAllocator<double>> large(1 << 20);
+    std::iota(large.begin(), large.end(), 0.0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(large.data()) % Opm::Details::firstTouchHugePageSize, 0u);
+    BOOST_CHECK_EQUAL(large.back(), double((1 << 20) - 1));
+
+    // growing moves the values between the two kinds of allocations
+    for (int i = 0; i < 300000; ++i) {
+        small.push_back(2.0);
+    }
+    BOOST_CHECK_EQUAL(small.size(), 300010u);
+    BOOST_CHECK_EQUAL(small[9], 1.0);
+    BOOST_CHECK_EQUAL(small.back(), 2.0);
+}
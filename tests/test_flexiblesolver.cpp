@@ -37,13 +37,16 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 
 template <int bz>
-Dune::BlockVector<Dune::FieldVector<double, bz>>
-testSolver(const boost::property_tree::ptree& prm, const std::string& matrix_filename, const std::string& rhs_filename)
+std::vector<Dune::BlockVector<Dune::FieldVector<double, bz>>>
+testSolveSequence(const boost::property_tree::ptree& prm, const std::string& matrix_filename, const std::string& rhs_filename,
+                  const std::vector<double>& perturbations, std::vector<Dune::InverseOperatorResult>* results = nullptr)
 {
     using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
     using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
@@ -78,10 +81,34 @@ testSolver(const boost::property_tree::ptree& prm, const std::string& matrix_fil
     using SeqOperatorType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
     SeqOperatorType op(matrix);
     Dune::FlexibleSolver<Matrix, Vector> solver(op, prm, wc);
-    Vector x(rhs.size());
-    Dune::InverseOperatorResult res;
-    solver.apply(x, rhs, res);
-    return x;
+
+    // One solver for all right hand sides, which are perturbations of the
+    // one read, so that a solver may reuse what it kept from earlier solves.
+    std::vector<Vector> solutions;
+    for (const double perturbation : perturbations) {
+        Vector b = rhs;
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            for (int row = 0; row < bz; ++row) {
+                b[i][row] *= 1.0 + perturbation * std::sin(1.0 + bz*i + row);
+            }
+        }
+        Vector x(b.size());
+        x = 0.0;
+        Dune::InverseOperatorResult res;
+        solver.apply(x, b, res);
+        if (results) {
+            results->push_back(res);
+        }
+        solutions.push_back(x);
+    }
+    return solutions;
+}
+
+template <int bz>
+Dune::BlockVector<Dune::FieldVector<double, bz>>
+testSolver(const boost::property_tree::ptree& prm, const std::string& matrix_filename, const std::string& rhs_filename)
+{
+    return testSolveSequence<bz>(prm, matrix_filename, rhs_filename, {0.0}).front();
 }
 
 BOOST_AUTO_TEST_CASE(TestFlexibleSolver)
@@ -133,6 +160,61 @@ BOOST_AUTO_TEST_CASE(TestFlexibleSolver)
     }
 }
 
+BOOST_AUTO_TEST_CASE(TestPipelinedSolvers)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree prm;
+
+    // Read parameters.
+    {
+        std::ifstream file("options_flexiblesolver.json");
+        pt::read_json(file, prm);
+    }
+
+    // The pipelined solvers must reproduce the solution of the standard one.
+    prm.put("tol", 1e-10);
+    prm.put("maxiter", 200);
+    prm.put("verbosity", 0);
+    const int bz = 3;
+    const auto expected = testSolver<bz>(prm, "matr33.txt", "rhs3.txt");
+    for (const std::string solver_type : { "pbicgstab", "lowsyncgmres", "recycledgmres" }) {
+        prm.put("solver", solver_type);
+        auto sol = testSolver<bz>(prm, "matr33.txt", "rhs3.txt");
+        BOOST_REQUIRE_EQUAL(sol.size(), expected.size());
+        for (size_t i = 0; i < sol.size(); ++i) {
+            for (int row = 0; row < bz; ++row) {
+                BOOST_CHECK_SMALL(sol[i][row] - expected[i][row], 1e-5);
+            }
+        }
+    }
+
+    // Later solves with the same solver reuse the recycled subspace and the
+    // buffers of the earlier ones, they must still give the same solutions
+    // as the standard solver. Solving for the first right hand side again
+    // must not take more iterations than the first time.
+    prm.put("solver", "bicgstab");
+    const std::vector<double> perturbations{0.0, 0.3, -0.2, 0.0};
+    const auto expectedSequence = testSolveSequence<bz>(prm, "matr33.txt", "rhs3.txt", perturbations);
+    for (const std::string solver_type : { "pbicgstab", "lowsyncgmres", "recycledgmres" }) {
+        prm.put("solver", solver_type);
+        std::vector<Dune::InverseOperatorResult> results;
+        const auto sequence = testSolveSequence<bz>(prm, "matr33.txt", "rhs3.txt", perturbations, &results);
+        BOOST_REQUIRE_EQUAL(sequence.size(), expectedSequence.size());
+        for (std::size_t k = 0; k < sequence.size(); ++k) {
+            BOOST_CHECK(results[k].converged);
+            BOOST_REQUIRE_EQUAL(sequence[k].size(), expectedSequence[k].size());
+            for (size_t i = 0; i < sequence[k].size(); ++i) {
+                for (int row = 0; row < bz; ++row) {
+                    BOOST_CHECK_SMALL(sequence[k][i][row] - expectedSequence[k][i][row], 1e-5);
+                }
+            }
+        }
+        if (solver_type == "recycledgmres") {
+            BOOST_CHECK_LE(results.back().iterations, results.front().iterations);
+        }
+    }
+}
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
@@ -163,6 +163,13 @@ BOOST_AUTO_TEST_CASE(AllHaveOneMessage)
             expected += Log::prefixMessage(Log::MessageType::Info, "info from rank "+std::to_string(i)) + "\n";
         }
         BOOST_CHECK_EQUAL(log_stream.str(), expected);
+    } else {
+
+        // the messages are only gathered on the root process
+        global_deferredlogger.logMessages();
+
+        auto counter = OpmLog::getBackend<CounterLog>("COUNTER");
+        BOOST_CHECK_EQUAL( 0 , counter->numMessages(Log::MessageType::Info) );
     }
 }
 
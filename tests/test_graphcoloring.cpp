@@ -6,6 +6,10 @@
 
 #include <opm/simulators/linalg/GraphColoring.hpp>
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #define BOOST_TEST_MODULE GraphColoringTest
 #define BOOST_TEST_MAIN
 
@@ -99,3 +103,79 @@ BOOST_AUTO_TEST_CASE(TestWelschPowell)
                                            graph, 0);
     checkAllIndices(newOrder);
 }
+
+BOOST_AUTO_TEST_CASE(TestReverseCuthillMcKee)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+    using Graph = Dune::Amg::MatrixGraph<Matrix>;
+    const int N = 10;
+    // A 5 point stencil on a N x N grid with the cells numbered in a scattered
+    // order, i.e. with a large bandwidth.
+    std::vector<int> cell(N*N);
+    for (int index = 0; index < N*N; ++index)
+    {
+        cell[index] = (37*index) % (N*N);
+    }
+    Matrix matrix(N*N, N*N, 5, 0.4, Matrix::implicit);
+    for( int j = 0; j < N; j++)
+    {
+        for(int i = 0; i < N; i++)
+        {
+            const auto index = cell[j*N+i];
+            matrix.entry(index,index) = 1;
+            if ( i > 0 )
+            {
+                matrix.entry(index,cell[j*N+i-1]) = 1;
+            }
+            if ( i  < N - 1)
+            {
+                matrix.entry(index,cell[j*N+i+1]) = 1;
+            }
+            if ( j > 0 )
+            {
+                matrix.entry(index,cell[(j-1)*N+i]) = 1;
+            }
+            if ( j  < N - 1)
+            {
+                matrix.entry(index,cell[(j+1)*N+i]) = 1;
+            }
+        }
+    }
+    matrix.compress();
+
+    auto bandwidth = [&matrix](const std::vector<std::size_t>& ordering, std::size_t noVertices)
+    {
+        std::size_t result = 0;
+        for (auto row = matrix.begin(); row != matrix.end(); ++row)
+        {
+            for (auto col = row->begin(); col != row->end(); ++col)
+            {
+                if (row.index() < noVertices && col.index() < noVertices)
+                {
+                    const auto r = ordering[row.index()];
+                    const auto c = ordering[col.index()];
+                    result = std::max(result, r > c ? r - c : c - r);
+                }
+            }
+        }
+        return result;
+    };
+
+    Graph graph(matrix);
+    std::vector<std::size_t> identity(N*N);
+    std::iota(identity.begin(), identity.end(), 0);
+    BOOST_CHECK(bandwidth(identity, N*N) > 5*N);
+
+    auto newOrder = Opm::reorderVerticesReverseCuthillMcKee(graph, N*N);
+    checkAllIndices(newOrder);
+    BOOST_CHECK(bandwidth(newOrder, N*N) <= std::size_t(2*N));
+
+    // The vertices after the first noVertices keep their index.
+    const std::size_t noInterior = N*N - 2*N;
+    newOrder = Opm::reorderVerticesReverseCuthillMcKee(graph, noInterior);
+    checkAllIndices(newOrder);
+    for (std::size_t vertex = noInterior; vertex < newOrder.size(); ++vertex)
+    {
+        BOOST_CHECK(newOrder[vertex] == vertex);
+    }
+}
@@ -72,3 +72,37 @@ BOOST_AUTO_TEST_CASE(Invert4x4)
 
 
 
+
+BOOST_AUTO_TEST_CASE(Invert6x6GaussJordan)
+{
+    typedef Dune::FieldMatrix<double, 6, 6>  BaseType;
+    BaseType matrix;
+    BaseType inverse;
+
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            matrix[i][j] = (i == j) ? 10.0 + i : 1.0 / (i + 2*j + 1);
+        }
+    }
+    // zero pivot in the first column forces a row exchange
+    matrix[0][0] = 0.0;
+
+    inverse = matrix;
+    Dune::ISTLUtility::invertMatrix(inverse);
+    BaseType product = matrix.rightmultiply(inverse);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            if (i == j)
+                BOOST_CHECK_CLOSE(1.0, product[i][j], 1e-12);
+            else
+                BOOST_CHECK_SMALL(product[i][j], 1e-12);
+        }
+    }
+
+    BaseType matrix_sing (matrix);
+    for (int i = 0; i < 6; ++i) {
+        matrix_sing[i][5] = 0.0;
+    }
+    BOOST_CHECK_THROW(Dune::FMatrixHelp::invertMatrixGaussJordan(matrix_sing, inverse),
+                      Dune::FMatrixError);
+}
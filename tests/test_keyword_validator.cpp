@@ -456,3 +456,24 @@ ENDSCALE
                    "  In file: <memory string>, line 4\n"
                    "  This is a critical error");
 }
+
+
+BOOST_AUTO_TEST_CASE(validate_deck)
+{
+    const auto keywords_string = std::string {R"(
+ECHO
+NOECHO
+PINCH
+   0.41   GAP   1*   FOO /
+ENDSCALE
+   NODIR   REVERS  0 20 /
+)"};
+    const auto deck = Parser {}.parseString(keywords_string);
+    KeywordValidator validator(test_unsupported_keywords, test_string_items, test_int_items);
+    const auto errors = validator.validate(deck);
+    BOOST_CHECK_EQUAL(errors.size(), 4U);
+    BOOST_CHECK_EQUAL(errors[0].location.keyword, "ECHO");
+    BOOST_CHECK_EQUAL(errors[1].location.keyword, "NOECHO");
+    BOOST_CHECK_EQUAL(errors[2].location.keyword, "PINCH");
+    BOOST_CHECK_EQUAL(errors[3].location.keyword, "ENDSCALE");
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSolverAutotunerTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/LinearSolverAutotuner.hpp>
+
+namespace {
+
+boost::property_tree::ptree cprTree()
+{
+    boost::property_tree::ptree prm;
+    prm.put("solver", "bicgstab");
+    prm.put("preconditioner.type", "cpr");
+    prm.put("preconditioner.finesmoother.type", "ParOverILU0");
+    prm.put("preconditioner.coarsesolver.preconditioner.minaggsize", 4);
+    prm.put("preconditioner.coarsesolver.preconditioner.maxaggsize", 6);
+    return prm;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(CandidatesVaryOneSetting)
+{
+    const auto candidates = Opm::LinearSolverAutotuner::candidates(cprTree());
+    // configured, gmres, ILU(1) smoother, larger aggregates, reuse 1 and 3
+    BOOST_CHECK_EQUAL(candidates.size(), 6u);
+    BOOST_CHECK(candidates[0] == cprTree());
+    BOOST_CHECK_EQUAL(candidates[1].get<std::string>("solver"), "gmres");
+    BOOST_CHECK_EQUAL(candidates[1].get<std::string>("preconditioner.finesmoother.type"), "ParOverILU0");
+    BOOST_CHECK_EQUAL(candidates[2].get<std::string>("preconditioner.finesmoother.type"), "ILUn");
+    BOOST_CHECK_EQUAL(candidates[3].get<int>("preconditioner.coarsesolver.preconditioner.maxaggsize"), 9);
+    BOOST_CHECK_EQUAL(candidates[4].get<int>("cpr_reuse_setup"), 1);
+    BOOST_CHECK_EQUAL(candidates[5].get<int>("cpr_reuse_setup"), 3);
+}
+
+BOOST_AUTO_TEST_CASE(PicksFastestAndDropsFailures)
+{
+    boost::property_tree::ptree prm;
+    prm.put("solver", "bicgstab");
+    prm.put("preconditioner.type", "ParOverILU0");
+    Opm::LinearSolverAutotuner tuner(prm, 2);
+    // configured, gmres, ILU(1)
+    BOOST_CHECK_EQUAL(tuner.numCandidates(), 3u);
+
+    BOOST_CHECK(tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.currentIndex(), 0u);
+    BOOST_CHECK(!tuner.report(2.0, true));
+    BOOST_CHECK(tuner.report(2.0, true));
+
+    // gmres does not converge and is dropped after one solve, although fast
+    BOOST_CHECK_EQUAL(tuner.currentIndex(), 1u);
+    BOOST_CHECK(tuner.report(0.5, false));
+
+    BOOST_CHECK_EQUAL(tuner.currentIndex(), 2u);
+    BOOST_CHECK(!tuner.report(1.0, true));
+    BOOST_CHECK(!tuner.report(1.5, true));
+
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.best(), 2u);
+    BOOST_CHECK_CLOSE(tuner.averageSeconds(2), 1.25, 1e-12);
+    BOOST_CHECK_EQUAL(tuner.current().get<int>("preconditioner.ilulevel"), 1);
+    BOOST_CHECK(!tuner.report(10.0, true));
+}
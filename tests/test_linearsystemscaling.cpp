@@ -0,0 +1,125 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSystemScalingTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/simulators/linalg/LinearSystemScaling.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int bz = 3;
+using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+// Block tridiagonal matrix with equations of very different magnitudes.
+Matrix makeMatrix(const int n)
+{
+    Matrix A(n, n, 3, 0.4, Matrix::implicit);
+    for (int row = 0; row < n; ++row) {
+        for (int col = std::max(row - 1, 0); col <= std::min(row + 1, n - 1); ++col) {
+            auto& block = A.entry(row, col);
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    const double scale = std::pow(1000.0, i);
+                    block[i][j] = scale * ((row == col && i == j) ? 4.0 + row : -0.1 * (1 + i + j));
+                }
+            }
+        }
+    }
+    A.compress();
+    return A;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(ScalingKeepsSolution)
+{
+    const int n = 10;
+    const Matrix original = makeMatrix(n);
+    Vector x(n);
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            x[row][i] = 1.0 + 0.1*row - 0.5*i;
+        }
+    }
+    Vector b(n);
+    original.mv(x, b);
+
+    Matrix A = original;
+    Opm::LinearSystemScaling<Matrix, Vector> scaling;
+    scaling.scale(A, b);
+
+    // the largest entry of every row of the diagonal blocks is one
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            double rowMax = 0.0;
+            for (int j = 0; j < bz; ++j) {
+                rowMax = std::max(rowMax, std::abs(A[row][row][i][j]));
+            }
+            BOOST_CHECK_CLOSE(rowMax, 1.0, 1e-12);
+            BOOST_CHECK_CLOSE(scaling.factors()[row][i], 1.0 / std::pow(1000.0, i) / (4.0 + row), 1e-12);
+        }
+    }
+
+    // x still solves the scaled system
+    Vector residual(n);
+    A.mv(x, residual);
+    residual -= b;
+    BOOST_CHECK_SMALL(residual.infinity_norm(), 1e-12);
+
+    // the same factors for the next system with the same values
+    A = original;
+    original.mv(x, b);
+    scaling.scale(A, b);
+    A.mv(x, residual);
+    residual -= b;
+    BOOST_CHECK_SMALL(residual.infinity_norm(), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(FusedWeightsMatchScaledSystem)
+{
+    const int n = 10;
+    Matrix A = makeMatrix(n);
+    Vector b(n);
+    b = 1.0;
+
+    Opm::LinearSystemScaling<Matrix, Vector> scaling;
+    Vector weights;
+    scaling.scale(A, b, 1, false, weights);
+
+    const Vector expected = Opm::Amg::getQuasiImpesWeights<Matrix, Vector>(A, 1, false);
+    BOOST_REQUIRE_EQUAL(weights.size(), expected.size());
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            BOOST_CHECK_CLOSE(weights[row][i], expected[row][i], 1e-12);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSystemViewTest
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/simulators/linalg/LinearSystemView.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_CASE(CSRMatchesMatrix)
+{
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    // Block tridiagonal matrix with distinct entries in every block.
+    const int n = 20;
+    Matrix A(n, n, 3, 0.4, Matrix::implicit);
+    for (int row = 0; row < n; ++row) {
+        for (int col = std::max(row - 1, 0); col <= std::min(row + 1, n - 1); ++col) {
+            auto& block = A.entry(row, col);
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    block[i][j] = 1.0 + 0.1*row - 0.3*col + 0.7*i - 0.2*j;
+                }
+            }
+        }
+    }
+    A.compress();
+    Vector b(n);
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            b[row][i] = 0.5 - 0.01*row + 0.25*i;
+        }
+    }
+
+    Opm::LinearSystemView<Matrix, Vector> view;
+    BOOST_CHECK(view.update(A, b));
+    BOOST_CHECK_EQUAL(view.patternVersion(), 1u);
+    BOOST_REQUIRE_EQUAL(view.numBlockRows(), static_cast<std::size_t>(n));
+    BOOST_REQUIRE_EQUAL(view.numBlockNonzeroes(), A.nonzeroes());
+    BOOST_CHECK_EQUAL(view.numRows(), static_cast<std::size_t>(n * bz));
+
+    const int* rows = view.rowPointers();
+    const int* cols = view.columnIndices();
+    const double* vals = view.values();
+    BOOST_CHECK_EQUAL(rows[0], 0);
+    BOOST_CHECK_EQUAL(rows[n], static_cast<int>(A.nonzeroes()));
+    for (int row = 0; row < n; ++row) {
+        for (int k = rows[row]; k < rows[row + 1]; ++k) {
+            const auto& block = A[row][cols[k]];
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    BOOST_CHECK_EQUAL(vals[k*bz*bz + i*bz + j], block[i][j]);
+                }
+            }
+        }
+    }
+    for (int row = 0; row < n; ++row) {
+        for (int i = 0; i < bz; ++i) {
+            BOOST_CHECK_EQUAL(view.rhs()[row*bz + i], b[row][i]);
+        }
+    }
+
+    // Changing values only must not re-extract the pattern, and the view
+    // must see the new values without copying.
+    A[3][4][1][2] = 42.0;
+    BOOST_CHECK(!view.update(A, b));
+    BOOST_CHECK_EQUAL(view.patternVersion(), 1u);
+    const int k = std::find(cols + rows[3], cols + rows[4], 4) - cols;
+    BOOST_CHECK_EQUAL(view.values()[k*bz*bz + 1*bz + 2], 42.0);
+
+    view.invalidatePattern();
+    BOOST_CHECK(view.update(A, b));
+    BOOST_CHECK_EQUAL(view.patternVersion(), 2u);
+}
@@ -0,0 +1,108 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestMemoryAccounting
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/MemoryAccounting.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/common/fmatrix.hh>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(Statistics)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int rank = cc.rank();
+    auto& memory = Opm::MemoryAccounting::instance();
+    memory.clear();
+    BOOST_CHECK(!memory.enabled());
+    memory.enable();
+    BOOST_CHECK(memory.enabled());
+
+    // A subsystem on every process, growing with the rank, and one on
+    // the last process only.
+    memory.set("common", 1000 * (rank + 1));
+    memory.set("common", 2000 * (rank + 1));
+    if (rank + 1 == cc.size()) {
+        memory.set("last", 500);
+    }
+
+    const auto statistics = memory.statistics(cc);
+    BOOST_REQUIRE_EQUAL(statistics.size(), 3u);
+    BOOST_CHECK_EQUAL(statistics[0].name, "common");
+    BOOST_CHECK_EQUAL(statistics[0].min, 2000.0);
+    BOOST_CHECK_EQUAL(statistics[0].max, 2000.0 * cc.size());
+    BOOST_CHECK_EQUAL(statistics[0].maxRank, cc.size() - 1);
+    BOOST_CHECK_CLOSE(statistics[0].average, 1000.0 * (cc.size() + 1), 1e-12);
+    BOOST_CHECK_EQUAL(statistics[1].name, "last");
+    BOOST_CHECK_EQUAL(statistics[1].min, cc.size() > 1 ? 0.0 : 500.0);
+    BOOST_CHECK_EQUAL(statistics[1].max, 500.0);
+    BOOST_CHECK_EQUAL(statistics[2].name, "resident");
+    BOOST_CHECK_GT(statistics[2].min, 0.0);
+
+    std::ostringstream table;
+    Opm::MemoryAccounting::print(table, statistics);
+    BOOST_CHECK(table.str().find("\ncommon ") != std::string::npos);
+    BOOST_CHECK(table.str().find("\nresident ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Sizes)
+{
+    const std::vector<double> v(10);
+    BOOST_CHECK_EQUAL(Opm::MemoryAccounting::vectorBytes(v), 10 * sizeof(double));
+
+    // tridiagonal
+    using Block = Dune::FieldMatrix<double, 3, 3>;
+    using Matrix = Dune::BCRSMatrix<Block>;
+    const int n = 5;
+    Matrix m(n, n, 3 * n - 2, Matrix::row_wise);
+    for (auto row = m.createbegin(); row != m.createend(); ++row) {
+        for (int j = std::max(0, static_cast<int>(row.index()) - 1); j <= std::min(n - 1, static_cast<int>(row.index()) + 1); ++j) {
+            row.insert(j);
+        }
+    }
+    BOOST_CHECK_GE(Opm::MemoryAccounting::matrixBytes(m), (3 * n - 2) * sizeof(Block));
+
+    // The allocator reports at least the bytes of a large allocation.
+    const auto before = Opm::MemoryAccounting::heapBytes();
+    auto block = std::make_unique<std::vector<char>>(64 << 20, 1);
+    const auto after = Opm::MemoryAccounting::heapBytes();
+    BOOST_CHECK_GE(after, before + block->size());
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
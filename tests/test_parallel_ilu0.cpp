@@ -0,0 +1,159 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestParallelILU0
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+
+#include <cmath>
+#include <vector>
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+using Communication = Dune::OwnerOverlapCopyCommunication<int, int>;
+using Attributes = Dune::OwnerOverlapCopyAttributeSet;
+using LocalIndex = Communication::ParallelIndexSet::LocalIndex;
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+namespace
+{
+
+// A distributed 1D Laplacian, every process owns 'owned' consecutive rows and
+// has the neighbouring rows of the other processes as copy rows. The local
+// numbering of the rows is scrambled, so that a reverse Cuthill-McKee ordering
+// of the local matrix is far from the identity.
+Matrix setupLaplacian(Communication& comm, const int owned)
+{
+    const auto& cc = comm.communicator();
+    const int first = cc.rank() * owned;
+    const int globalSize = cc.size() * owned;
+    const int begin = std::max(first - 1, 0);
+    const int end = std::min(first + owned + 1, globalSize);
+    const int localSize = end - begin;
+
+    // local index of global row begin + k
+    std::vector<int> local(localSize);
+    for (int k = 0; k < localSize; ++k) {
+        local[k] = (7 * k) % localSize;
+    }
+
+    auto& indexSet = comm.indexSet();
+    indexSet.beginResize();
+    for (int k = 0; k < localSize; ++k) {
+        const int row = begin + k;
+        const bool isOwned = row >= first && row < first + owned;
+        indexSet.add(row, LocalIndex(local[k], isOwned ? Attributes::owner : Attributes::copy, true));
+    }
+    indexSet.endResize();
+    comm.remoteIndices().rebuild<false>();
+
+    Matrix A(localSize, localSize, Matrix::random);
+    for (int k = 0; k < localSize; ++k) {
+        A.setrowsize(local[k], 1 + (k > 0) + (k + 1 < localSize));
+    }
+    A.endrowsizes();
+    for (int k = 0; k < localSize; ++k) {
+        A.addindex(local[k], local[k]);
+        if (k > 0) {
+            A.addindex(local[k], local[k - 1]);
+        }
+        if (k + 1 < localSize) {
+            A.addindex(local[k], local[k + 1]);
+        }
+    }
+    A.endindices();
+
+    for (int k = 0; k < localSize; ++k) {
+        const int row = begin + k;
+        const bool isOwned = row >= first && row < first + owned;
+        // the copy rows only hold the identity, as the overlap rows of ISTL
+        A[local[k]][local[k]] = isOwned ? 2.0 : 1.0;
+        if (k > 0) {
+            A[local[k]][local[k - 1]] = isOwned ? -1.0 : 0.0;
+        }
+        if (k + 1 < localSize) {
+            A[local[k]][local[k + 1]] = isOwned ? -1.0 : 0.0;
+        }
+    }
+    return A;
+}
+
+// After apply() the copy rows must hold the values of their owners.
+void checkConsistentApply(const bool floatHalo)
+{
+    Communication comm(Dune::MPIHelper::getCommunicator());
+    const Matrix A = setupLaplacian(comm, 30);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Communication>
+        ilu(A, comm, 1.0, Opm::MILU_VARIANT::ILU, /*redblack=*/false,
+            /*reorder_sphere=*/true, /*reverse_cuthill_mckee=*/true);
+    ilu.setFloatHalo(floatHalo);
+
+    Vector d(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        d[i] = 1.0 + std::sin(1.0 + comm.communicator().rank() * 37.0 + i);
+    }
+    comm.copyOwnerToAll(d, d);
+
+    Vector v(A.N());
+    v = 0.0;
+    ilu.apply(v, d);
+
+    Vector consistent = v;
+    comm.copyOwnerToAll(consistent, consistent);
+    const double tolerance = floatHalo ? 1e-6 : 1e-14;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        BOOST_CHECK_SMALL(v[i][0] - consistent[i][0], tolerance * (1.0 + std::abs(consistent[i][0])));
+    }
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(ReverseCuthillMcKeeHalo)
+{
+    checkConsistentApply(/*floatHalo=*/false);
+}
+
+BOOST_AUTO_TEST_CASE(ReverseCuthillMcKeeFloatHalo)
+{
+    checkConsistentApply(/*floatHalo=*/true);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
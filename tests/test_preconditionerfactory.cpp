@@ -171,6 +171,76 @@ BOOST_AUTO_TEST_CASE(TestDefaultPreconditionerFactory)
 }
 
 
+BOOST_AUTO_TEST_CASE(TestFloatFactorsILU)
+{
+    pt::ptree prm;
+    prm.put("tol", 1e-12);
+    prm.put("maxiter", 200);
+    prm.put("verbosity", 0);
+    prm.put("preconditioner.type", "ILU0");
+    prm.put("preconditioner.relaxation", 1.0);
+    prm.put("preconditioner.float_factors", true);
+    prm.put("preconditioner.pressure_var_index", 1);
+
+    // Test with 1x1 block solvers.
+    test1(prm);
+
+    // Test with 3x3 block solvers.
+    test3(prm);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestILUnUpdate)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    using PrecFactory = Opm::PreconditionerFactory<Operator>;
+
+    // 2D Laplacian, which gets fill-in with ILU(1).
+    const int N = 10;
+    Matrix matrix(N*N, N*N, 5, 0.4, Matrix::implicit);
+    for (int j = 0; j < N; ++j) {
+        for (int i = 0; i < N; ++i) {
+            const int index = j*N + i;
+            matrix.entry(index, index) = 4.0;
+            if (i > 0) matrix.entry(index, index - 1) = -1.0;
+            if (i < N - 1) matrix.entry(index, index + 1) = -1.0;
+            if (j > 0) matrix.entry(index, index - N) = -1.0;
+            if (j < N - 1) matrix.entry(index, index + N) = -1.0;
+        }
+    }
+    matrix.compress();
+
+    pt::ptree prm;
+    prm.put("type", "ILUn");
+    prm.put("ilulevel", 1);
+    Operator op(matrix);
+    auto prec = PrecFactory::create(op, prm);
+
+    // Change the values, but not the structure, and update.
+    for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            *col *= (row.index() == col.index()) ? 1.5 + 0.01*row.index() : 0.5;
+        }
+    }
+    prec->update();
+    auto fresh = PrecFactory::create(op, prm);
+
+    Vector d(N*N), v1(N*N), v2(N*N);
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        d[i] = 1.0 + 0.1*i;
+    }
+    v1 = 0.0;
+    v2 = 0.0;
+    prec->apply(v1, d);
+    fresh->apply(v2, d);
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        BOOST_CHECK_CLOSE(v1[i][0], v2[i][0], 1e-10);
+    }
+}
+
+
 template <int bz>
 using M = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
 template <int bz>
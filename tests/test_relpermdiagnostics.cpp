@@ -49,6 +49,9 @@
 #include <dune/common/parallel/mpihelper.hh>
 #endif
 
+#include <cstdio>
+#include <string>
+
 BOOST_AUTO_TEST_SUITE ()
 
 BOOST_AUTO_TEST_CASE(diagnosis)
@@ -85,4 +88,23 @@ BOOST_AUTO_TEST_CASE(diagnosis)
     diagnostics.diagnosis(eclState, cartesianIndexMapper);
     BOOST_CHECK_EQUAL(1, counterLog->numMessages(Log::MessageType::Warning));
 }
+
+BOOST_AUTO_TEST_CASE(unchangedDeck)
+{
+    using namespace Opm;
+    Parser parser;
+    const Opm::Deck deck = parser.parseFile("../tests/relpermDiagnostics.DATA");
+    const auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    const std::string hashFile = "relpermDiagnostics.RPDIAG";
+    std::remove(hashFile.c_str());
+
+    BOOST_CHECK_EQUAL(RelpermDiagnostics::deckHash(deck), RelpermDiagnostics::deckHash(deck));
+    BOOST_CHECK(!RelpermDiagnostics::upToDate(deck, hashFile, comm));
+    BOOST_CHECK(RelpermDiagnostics::upToDate(deck, hashFile, comm));
+
+    // a different deck is diagnosed again
+    const Opm::Deck otherDeck = parser.parseString("RUNSPEC\nOIL\nWATER\n");
+    BOOST_CHECK(!RelpermDiagnostics::upToDate(otherDeck, hashFile, comm));
+    std::remove(hashFile.c_str());
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE RuntimeMetricsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/RuntimeMetrics.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+    Opm::RuntimeMetrics testMetrics()
+    {
+        Opm::RuntimeMetrics metrics;
+        metrics.reportStep = 3;
+        metrics.simulatedDays = 60.0;
+        metrics.totalDays = 365.0;
+        metrics.wallSeconds = 1800.0;
+        metrics.steps = 12;
+        metrics.chops = 2;
+        metrics.newtonIterations = 40;
+        metrics.linearIterations = 400;
+        metrics.pendingWrites = 1;
+        metrics.peakMemory = {100.0, 120.5};
+        return metrics;
+    }
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Throughput)
+{
+    auto metrics = testMetrics();
+    BOOST_CHECK_CLOSE(metrics.simDaysPerHour(), 120.0, 1e-12);
+    metrics.wallSeconds = 0.0;
+    BOOST_CHECK_EQUAL(metrics.simDaysPerHour(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(Json)
+{
+    std::ostringstream os;
+    testMetrics().writeJson(os);
+    const std::string json = os.str();
+    BOOST_CHECK(json.find("\"report_step\": 3,") != std::string::npos);
+    BOOST_CHECK(json.find("\"sim_days_per_hour\": 120.000,") != std::string::npos);
+    BOOST_CHECK(json.find("\"chops\": 2,") != std::string::npos);
+    BOOST_CHECK(json.find("\"pending_output_writes\": 1,") != std::string::npos);
+    BOOST_CHECK(json.find("\"peak_memory_mb\": [100.000, 120.500]") != std::string::npos);
+    BOOST_CHECK_EQUAL(json.front(), '{');
+    BOOST_CHECK_EQUAL(json.substr(json.size() - 2), "}\n");
+}
+
+BOOST_AUTO_TEST_CASE(JsonFile)
+{
+    const std::string filename = "test_runtimemetrics.json";
+    testMetrics().writeJsonFile(filename);
+    auto metrics = testMetrics();
+    metrics.reportStep = 4;
+    metrics.writeJsonFile(filename);
+
+    std::ifstream is(filename);
+    std::ostringstream contents;
+    contents << is.rdbuf();
+    std::ostringstream expected;
+    metrics.writeJson(expected);
+    BOOST_CHECK_EQUAL(contents.str(), expected.str());
+    BOOST_CHECK(!std::ifstream(filename + ".tmp").good());
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(PeakMemory)
+{
+    BOOST_CHECK(Opm::RuntimeMetrics::processPeakMemory() > 0.0);
+}
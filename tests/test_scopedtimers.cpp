@@ -0,0 +1,223 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestScopedTimers
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/ScopedTimers.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(Hierarchy)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int rank = cc.rank();
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    for (int i = 0; i <= rank; ++i) {
+        Opm::ScopedTimer outer("outer");
+        Opm::ScopedTimer inner("inner");
+    }
+    if (rank == 0) {
+        Opm::ScopedTimer timer("rank zero");
+    }
+    {
+        Opm::ScopedTimer timer("outer x");
+    }
+
+    BOOST_CHECK_EQUAL(registry.entries().at("outer").calls, rank + 1);
+    BOOST_CHECK_EQUAL(registry.entries().at("outer/inner").calls, rank + 1);
+
+    const auto stats = registry.statistics(cc);
+    BOOST_REQUIRE_EQUAL(stats.size(), 4u);
+    // Children directly after their parent.
+    BOOST_CHECK_EQUAL(stats[0].name, "outer");
+    BOOST_CHECK_EQUAL(stats[1].name, "outer/inner");
+    BOOST_CHECK_EQUAL(stats[2].name, "outer x");
+    BOOST_CHECK_EQUAL(stats[3].name, "rank zero");
+    BOOST_CHECK_EQUAL(stats[1].depth, 1);
+    BOOST_CHECK_EQUAL(stats[0].calls, cc.size());
+    for (const auto& stat : stats) {
+        BOOST_CHECK_GE(stat.min, 0.0);
+        BOOST_CHECK_LE(stat.min, stat.average);
+        BOOST_CHECK_LE(stat.average, stat.max);
+    }
+    // Missing on the other processes.
+    if (cc.size() > 1) {
+        BOOST_CHECK_EQUAL(stats[3].min, 0.0);
+    }
+
+    std::ostringstream table;
+    Opm::TimerRegistry::print(table, stats);
+    BOOST_CHECK(table.str().find("\n  inner ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Baseline)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    {
+        Opm::ScopedTimer timer("step");
+    }
+    const auto baseline = registry.entries();
+    {
+        Opm::ScopedTimer timer("step");
+    }
+    {
+        Opm::ScopedTimer timer("step");
+    }
+
+    const auto stats = registry.statistics(cc, baseline);
+    BOOST_REQUIRE_EQUAL(stats.size(), 1u);
+    BOOST_CHECK_EQUAL(stats[0].calls, 2);
+
+    std::ostringstream csv;
+    Opm::TimerRegistry::writeCsv(csv, "3", stats);
+    BOOST_CHECK_EQUAL(csv.str().rfind("3,step,2,", 0), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ChromeTrace)
+{
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    {
+        Opm::ScopedTimer timer("before");
+    }
+    registry.startTrace();
+    {
+        Opm::ScopedTimer outer("outer");
+        Opm::ScopedTimer inner("in\"ner");
+    }
+
+    std::ostringstream trace;
+    registry.writeChromeTrace(trace, 3);
+    const std::string json = trace.str();
+    BOOST_CHECK_EQUAL(json.rfind("{\"traceEvents\":[", 0), 0u);
+    BOOST_CHECK(json.find("before") == std::string::npos);
+    // The inner timer stops first, with the last part of its name.
+    const auto inner = json.find("{\"name\":\"in\\\"ner\",\"ph\":\"X\"");
+    const auto outer = json.find("{\"name\":\"outer\",\"ph\":\"X\"");
+    BOOST_CHECK(inner != std::string::npos);
+    BOOST_CHECK(outer != std::string::npos);
+    BOOST_CHECK_LT(inner, outer);
+    BOOST_CHECK(json.find("\"pid\":3,\"tid\":0}") != std::string::npos);
+    BOOST_CHECK_EQUAL(json.substr(json.size() - 3), "]}\n");
+}
+
+BOOST_AUTO_TEST_CASE(TraceLimits)
+{
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    // Nothing is quicker than an hour.
+    registry.startTrace(3.6e9);
+    {
+        Opm::ScopedTimer timer("short");
+    }
+    std::ostringstream trace;
+    registry.writeChromeTrace(trace, 0);
+    BOOST_CHECK(trace.str().find("short") == std::string::npos);
+    BOOST_CHECK_EQUAL(registry.entries().at("short").calls, 1);
+
+    registry.startTrace(0.0, 2);
+    for (int i = 0; i < 5; ++i) {
+        Opm::ScopedTimer timer("step");
+    }
+    BOOST_CHECK_EQUAL(registry.droppedTraceEvents(), 3u);
+    BOOST_CHECK_EQUAL(registry.entries().at("step").calls, 5);
+}
+
+BOOST_AUTO_TEST_CASE(KernelTimers)
+{
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    {
+        Opm::KernelTimer timer("spmv");
+    }
+    BOOST_CHECK(registry.entries().empty());
+
+    registry.enableKernelTimers();
+    {
+        Opm::ScopedTimer outer("solve");
+        Opm::KernelTimer timer("spmv");
+    }
+    BOOST_CHECK_EQUAL(registry.entries().at("solve/spmv").calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(HardwareCounters)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+
+    // The counters are often unavailable, e.g. in virtual machines.
+    const bool available = registry.enableHardwareCounters();
+    volatile double sum = 0.0;
+    {
+        Opm::ScopedTimer timer("loop");
+        for (int i = 0; i < 100000; ++i) {
+            sum += i;
+        }
+    }
+    const auto& counters = registry.entries().at("loop").counters;
+    if (available) {
+        BOOST_CHECK_GT(counters.cycles, 0.0);
+        BOOST_CHECK_GT(counters.instructions, 100000.0);
+    } else {
+        BOOST_CHECK_EQUAL(counters.cycles, 0.0);
+        BOOST_CHECK_EQUAL(counters.instructions, 0.0);
+    }
+
+    const auto stats = registry.statistics(cc);
+    std::ostringstream table;
+    Opm::TimerRegistry::print(table, stats);
+    const bool anyAvailable = cc.max(static_cast<int>(available)) == 1;
+    BOOST_CHECK_EQUAL(table.str().find("IPC") != std::string::npos, anyAvailable);
+}
+
+BOOST_AUTO_TEST_CASE(StopWithoutStart)
+{
+    auto& registry = Opm::TimerRegistry::instance();
+    registry.clear();
+    BOOST_CHECK_THROW(registry.stop(), std::logic_error);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
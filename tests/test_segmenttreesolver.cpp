@@ -0,0 +1,183 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SegmentTreeSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/SegmentTreeSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <vector>
+
+namespace {
+
+constexpr int bs = 3;
+using Block = Dune::FieldMatrix<double, bs, bs>;
+using Matrix = Dune::BCRSMatrix<Block>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bs>>;
+
+// A diagonally dominant matrix with the pattern of the segment tree.
+Matrix treeMatrix(const std::vector<std::vector<int>>& inlets)
+{
+    const int nseg = inlets.size();
+    std::vector<int> outlet(nseg, -1);
+    int nnz = nseg;
+    for (int seg = 0; seg < nseg; ++seg) {
+        for (const int inlet : inlets[seg]) {
+            outlet[inlet] = seg;
+            nnz += 2;
+        }
+    }
+
+    Matrix D(nseg, nseg, nnz, Matrix::row_wise);
+    for (auto row = D.createbegin(); row != D.createend(); ++row) {
+        const int seg = row.index();
+        if (outlet[seg] >= 0) {
+            row.insert(outlet[seg]);
+        }
+        row.insert(seg);
+        for (const int inlet : inlets[seg]) {
+            row.insert(inlet);
+        }
+    }
+
+    for (int seg = 0; seg < nseg; ++seg) {
+        for (auto col = D[seg].begin(); col != D[seg].end(); ++col) {
+            for (int i = 0; i < bs; ++i) {
+                for (int j = 0; j < bs; ++j) {
+                    (*col)[i][j] = 0.1 * (1 + seg + 2*i - j) / (1 + col.index());
+                }
+            }
+            if (col.index() == static_cast<std::size_t>(seg)) {
+                for (int i = 0; i < bs; ++i) {
+                    (*col)[i][i] += 10.0 + i;
+                }
+            }
+        }
+    }
+    return D;
+}
+
+void checkSolve(const std::vector<std::vector<int>>& inlets)
+{
+    const Matrix D = treeMatrix(inlets);
+    Vector x(inlets.size());
+    for (std::size_t seg = 0; seg < x.size(); ++seg) {
+        for (int i = 0; i < bs; ++i) {
+            x[seg][i] = 1.0 + seg - 0.5 * i;
+        }
+    }
+    Vector b(x.size());
+    D.mv(x, b);
+
+    Opm::SegmentTreeSolver<Matrix, Vector> solver(inlets);
+    const Vector y = solver.solve(D, b);
+    BOOST_REQUIRE_EQUAL(y.size(), x.size());
+    for (std::size_t seg = 0; seg < x.size(); ++seg) {
+        for (int i = 0; i < bs; ++i) {
+            BOOST_CHECK_CLOSE(y[seg][i], x[seg][i], 1e-10);
+        }
+    }
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(SingleSegment)
+{
+    checkSolve({{}});
+}
+
+BOOST_AUTO_TEST_CASE(Chain)
+{
+    // 0 <- 1 <- 2 <- 3
+    checkSolve({{1}, {2}, {3}, {}});
+}
+
+BOOST_AUTO_TEST_CASE(BranchesInAnyOrder)
+{
+    // Top segment 2, branches 2 <- 0 <- 4 and 2 <- 5 <- 1, 5 <- 3.
+    checkSolve({{4}, {}, {0, 5}, {}, {}, {1, 3}});
+}
+
+BOOST_AUTO_TEST_CASE(MultipleRightHandSides)
+{
+    // Top segment 2, branches 2 <- 0 <- 4 and 2 <- 5 <- 1, 5 <- 3.
+    const std::vector<std::vector<int>> inlets{{4}, {}, {0, 5}, {}, {}, {1, 3}};
+    const Matrix D = treeMatrix(inlets);
+    constexpr int nrhs = 2;
+    using RhsBlock = Dune::FieldMatrix<double, bs, nrhs>;
+    std::vector<RhsBlock> b(inlets.size(), RhsBlock(0.0));
+    for (int i = 0; i < bs; ++i) {
+        b[4][i][0] = 1.0 + i;
+        b[4][i][1] = -0.5 * i;
+    }
+
+    Opm::SegmentTreeSolver<Matrix, Vector> solver(inlets);
+    const std::vector<RhsBlock> x = solver.solve(D, b);
+    BOOST_REQUIRE_EQUAL(x.size(), b.size());
+    for (int r = 0; r < nrhs; ++r) {
+        Vector column(b.size());
+        for (std::size_t seg = 0; seg < b.size(); ++seg) {
+            for (int i = 0; i < bs; ++i) {
+                column[seg][i] = b[seg][i][r];
+            }
+        }
+        const Vector y = solver.solve(D, column);
+        for (std::size_t seg = 0; seg < b.size(); ++seg) {
+            for (int i = 0; i < bs; ++i) {
+                BOOST_CHECK_CLOSE(x[seg][i][r], y[seg][i], 1e-10);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ResetRefactorises)
+{
+    const std::vector<std::vector<int>> inlets{{1, 2}, {}, {}};
+    Matrix D = treeMatrix(inlets);
+    Opm::SegmentTreeSolver<Matrix, Vector> solver(inlets);
+    Vector b(3);
+    b = 1.0;
+    const Vector y1 = solver.solve(D, b);
+
+    D *= 2.0;
+    // Without reset() the old factorisation is used.
+    const Vector y2 = solver.solve(D, b);
+    solver.reset();
+    const Vector y3 = solver.solve(D, b);
+    for (std::size_t seg = 0; seg < b.size(); ++seg) {
+        for (int i = 0; i < bs; ++i) {
+            BOOST_CHECK_CLOSE(y2[seg][i], y1[seg][i], 1e-12);
+            BOOST_CHECK_CLOSE(y3[seg][i], 0.5 * y1[seg][i], 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NotATree)
+{
+    // Segment 1 is its own outlet's outlet, no top segment.
+    const std::vector<std::vector<int>> inlets{{1}, {0}};
+    BOOST_CHECK_THROW((Opm::SegmentTreeSolver<Matrix, Vector>(inlets)), std::logic_error);
+}
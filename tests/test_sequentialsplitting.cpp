@@ -0,0 +1,135 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SequentialSplittingTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/SequentialSplitting.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <algorithm>
+
+namespace {
+
+constexpr int bs = 2;
+constexpr int pressureIdx = 0;
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bs, bs>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bs>>;
+using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using PressureVector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+
+// Three cells in a row.
+Matrix chainMatrix()
+{
+    Matrix A(3, 3, 7, Matrix::row_wise);
+    for (auto row = A.createbegin(); row != A.createend(); ++row) {
+        const int i = row.index();
+        for (int j = std::max(i - 1, 0); j <= std::min(i + 1, 2); ++j) {
+            row.insert(j);
+        }
+    }
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            for (int eq = 0; eq < bs; ++eq) {
+                for (int var = 0; var < bs; ++var) {
+                    (*col)[eq][var] = 1.0 + row.index() + 2.0*col.index() + 3.0*eq + 5.0*var;
+                }
+            }
+        }
+    }
+    return A;
+}
+
+Vector vector(const double a, const double b)
+{
+    Vector v(3);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        v[i][0] = a + i;
+        v[i][1] = b - i;
+    }
+    return v;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(PressureSystem)
+{
+    const Matrix A = chainMatrix();
+    const Vector b = vector(1.0, 2.0);
+    const Vector w = vector(0.5, -1.0);
+
+    PressureMatrix Ap;
+    PressureVector bp;
+    Opm::SequentialSplitting::assemblePressureSystem(A, b, w, pressureIdx, Ap, bp);
+
+    BOOST_REQUIRE_EQUAL(Ap.N(), 3u);
+    BOOST_CHECK_EQUAL(Ap.nonzeroes(), A.nonzeroes());
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        const auto i = row.index();
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            const double expected = w[i][0] * (*col)[0][pressureIdx] + w[i][1] * (*col)[1][pressureIdx];
+            BOOST_CHECK_CLOSE(Ap[i][col.index()], expected, 1e-12);
+        }
+        BOOST_CHECK_CLOSE(bp[i][0], w[i][0] * b[i][0] + w[i][1] * b[i][1], 1e-12);
+    }
+
+    // The pattern is reused, the values are replaced.
+    const Matrix A2 = chainMatrix();
+    Opm::SequentialSplitting::assemblePressureSystem(A2, b, w, pressureIdx, Ap, bp);
+    BOOST_CHECK_EQUAL(Ap.nonzeroes(), A.nonzeroes());
+    BOOST_CHECK_CLOSE(Ap[1][2], w[1][0] * A[1][2][0][0] + w[1][1] * A[1][2][1][0], 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(TransportSystem)
+{
+    const Matrix A0 = chainMatrix();
+    const Vector b0 = vector(1.0, 2.0);
+    Vector w = vector(0.5, -1.0);
+    // Cell 0: the first equation has the largest weight.
+    w[0][0] = 1.0;
+    w[0][1] = 0.1;
+
+    Matrix A = A0;
+    Vector b = b0;
+    Opm::SequentialSplitting::restrictToTransport(A, b, w, pressureIdx);
+
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        const auto i = row.index();
+        const int pressureEq = i == 0 ? 0 : 1;
+        const int transportEq = 1 - pressureEq;
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            const auto j = col.index();
+            const auto& block = *col;
+            // The pressure equation is replaced by dp = 0.
+            BOOST_CHECK_EQUAL(block[pressureEq][pressureIdx], i == j ? 1.0 : 0.0);
+            BOOST_CHECK_EQUAL(block[pressureEq][1], 0.0);
+            // The transport equation does not see the pressure.
+            BOOST_CHECK_EQUAL(block[transportEq][pressureIdx], 0.0);
+            BOOST_CHECK_EQUAL(block[transportEq][1], A0[i][j][transportEq][1]);
+        }
+        BOOST_CHECK_EQUAL(b[i][pressureEq], 0.0);
+        BOOST_CHECK_EQUAL(b[i][transportEq], b0[i][transportEq]);
+    }
+}
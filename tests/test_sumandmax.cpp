@@ -0,0 +1,71 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestSumAndMax
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/sumAndMax.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <vector>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(SumAndMax)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int rank = cc.rank();
+    const int size = cc.size();
+
+    std::vector<double> sumValues{1.0, static_cast<double>(rank)};
+    std::vector<double> maxValues{static_cast<double>(rank), -static_cast<double>(rank), 2.0};
+    Opm::sumAndMax(cc, sumValues, maxValues);
+
+    BOOST_CHECK_EQUAL(sumValues[0], static_cast<double>(size));
+    BOOST_CHECK_EQUAL(sumValues[1], 0.5 * size * (size - 1));
+    BOOST_CHECK_EQUAL(maxValues[0], static_cast<double>(size - 1));
+    BOOST_CHECK_EQUAL(maxValues[1], 0.0);
+    BOOST_CHECK_EQUAL(maxValues[2], 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyMaxValues)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+
+    std::vector<double> sumValues{2.0};
+    std::vector<double> maxValues;
+    Opm::sumAndMax(cc, sumValues, maxValues);
+
+    BOOST_CHECK_EQUAL(sumValues[0], 2.0 * cc.size());
+    BOOST_CHECK(maxValues.empty());
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
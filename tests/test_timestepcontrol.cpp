@@ -0,0 +1,93 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TimeStepControlTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/timestepping/TimeStepControl.hpp>
+
+#include <stdexcept>
+
+namespace {
+
+struct NoRelativeChange : public Opm::RelativeChangeInterface
+{
+    double relativeChange() const
+    {
+        return 0.0;
+    }
+};
+
+Opm::SimulatorReportSingle stepReport(const bool converged, const unsigned int newtonIterations)
+{
+    Opm::SimulatorReportSingle report;
+    report.converged = converged;
+    report.total_newton_iterations = newtonIterations;
+    report.assemble_time = 0.5 * newtonIterations;
+    report.linear_solve_time = 0.5 * newtonIterations;
+    report.pre_post_time = 1.0;
+    return report;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(CostModelIterations)
+{
+    Opm::CostModelTimeStepControl control;
+    control.recordStep(1.0, stepReport(true, 4));
+    control.recordStep(2.0, stepReport(true, 6));
+    control.recordStep(4.0, stepReport(true, 8));
+
+    BOOST_CHECK_CLOSE(control.expectedNewtonIterations(2.0), 6.0, 10.0);
+    BOOST_CHECK(control.expectedNewtonIterations(8.0) > control.expectedNewtonIterations(4.0));
+    BOOST_CHECK_EQUAL(control.failureProbability(100.0), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(CostModelRecoversAfterFailure)
+{
+    const NoRelativeChange relativeChange;
+    Opm::CostModelTimeStepControl control(1.5);
+    control.recordStep(1.0, stepReport(true, 4));
+    control.recordStep(2.0, stepReport(true, 6));
+
+    // Without any failure the largest step size tried is the most efficient one.
+    BOOST_CHECK_CLOSE(control.computeTimeStepSize(2.0, 6, relativeChange, 0.0), 8.0, 1e-10);
+
+    control.recordStep(8.0, stepReport(false, 20));
+    BOOST_CHECK_CLOSE(control.failureProbability(8.0), 0.5, 1e-10);
+    const double dtAfterFailure = control.computeTimeStepSize(2.0, 6, relativeChange, 0.0);
+    BOOST_CHECK(dtAfterFailure < 8.0);
+
+    // Converged steps close to the failed step size make larger steps more likely to succeed.
+    double dt = dtAfterFailure;
+    for (int step = 0; step < 3; ++step) {
+        control.recordStep(dt, stepReport(true, 6));
+        dt = control.computeTimeStepSize(dt, 6, relativeChange, 0.0);
+    }
+    BOOST_CHECK(control.failureProbability(8.0) < 0.5);
+    BOOST_CHECK(dt > dtAfterFailure);
+}
+
+BOOST_AUTO_TEST_CASE(CostModelRecoveryRate)
+{
+    BOOST_CHECK_THROW(Opm::CostModelTimeStepControl(1.0), std::runtime_error);
+}
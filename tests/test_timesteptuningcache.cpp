@@ -0,0 +1,118 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TimeStepTuningCacheTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/TimeStepTuningCache.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(NoFile)
+{
+    const Opm::TimeStepTuningCache cache("no_such_time_step_tuning_cache");
+    BOOST_CHECK(cache.cached(0) == nullptr);
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(0, 10.0), 10.0);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+    const std::string filename = "test_timesteptuningcache_roundtrip.txt";
+    {
+        Opm::TimeStepTuningCache cache;
+        // Report step 3 chops twice before 2.5 converges.
+        cache.recordSubstep(3, 10.0, false);
+        cache.recordSubstep(3, 5.0, false);
+        cache.recordSubstep(3, 2.5, true);
+        cache.recordSubstep(3, 7.5, true);
+        // Report step 4 converges directly.
+        cache.recordSubstep(4, 20.0, true);
+        BOOST_REQUIRE(cache.save(filename));
+    }
+
+    const Opm::TimeStepTuningCache cache(filename);
+    const auto* entry = cache.cached(3);
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_CHECK_EQUAL(entry->firstAcceptedStep, 2.5);
+    BOOST_CHECK_EQUAL(entry->chops, 2);
+    BOOST_CHECK_EQUAL(entry->substeps, 4);
+
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(3, 10.0), 2.5);
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(3, 1.0), 1.0);
+    // No chops, the time step control knows best.
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(4, 30.0), 30.0);
+    BOOST_CHECK(cache.cached(5) == nullptr);
+
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(SaveKeepsUnreachedReportSteps)
+{
+    const std::string filename = "test_timesteptuningcache_merge.txt";
+    {
+        Opm::TimeStepTuningCache cache;
+        cache.recordSubstep(1, 4.0, false);
+        cache.recordSubstep(1, 2.0, true);
+        cache.recordSubstep(2, 8.0, false);
+        cache.recordSubstep(2, 1.0, true);
+        BOOST_REQUIRE(cache.save(filename));
+    }
+    {
+        // A restarted run that only reaches report step 1. It starts with
+        // the learned step and does not chop.
+        Opm::TimeStepTuningCache cache(filename);
+        BOOST_CHECK_EQUAL(cache.suggestedFirstStep(1, 4.0), 2.0);
+        cache.recordSubstep(1, 2.0, true);
+        cache.recordSubstep(1, 2.0, true);
+        BOOST_REQUIRE(cache.save(filename));
+    }
+
+    // A third run still gets the hints of both report steps.
+    const Opm::TimeStepTuningCache cache(filename);
+    BOOST_CHECK_EQUAL(cache.cached(1)->chops, 1);
+    BOOST_CHECK_EQUAL(cache.cached(1)->substeps, 2);
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(1, 4.0), 2.0);
+    BOOST_CHECK_EQUAL(cache.cached(2)->chops, 1);
+    BOOST_CHECK_EQUAL(cache.suggestedFirstStep(2, 8.0), 1.0);
+
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(UnwritableFile)
+{
+    Opm::TimeStepTuningCache cache;
+    cache.recordSubstep(1, 4.0, true);
+    BOOST_CHECK(!cache.save("no_such_directory/test_timesteptuningcache.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFile)
+{
+    const std::string filename = "test_timesteptuningcache_invalid.txt";
+    {
+        std::ofstream outfile(filename);
+        outfile << "1 2.0 not-a-number 3\n";
+    }
+    BOOST_CHECK_THROW(Opm::TimeStepTuningCache{filename}, std::runtime_error);
+    std::remove(filename.c_str());
+}
@@ -391,8 +391,9 @@ BOOST_AUTO_TEST_CASE(STOP_well)
     std::vector<Opm::ParallelWellInfo> pinfos;
     auto wstate = buildWellState(setup, 0, pinfos);
     for (std::size_t well_index = 0; well_index < setup.sched.numWells(0); well_index++) {
-        for (const auto& p : wstate.perfPress(well_index))
-            BOOST_CHECK(p > 0);
+        const auto * perf_press = wstate.perfPress(well_index);
+        for (int perf = 0; perf < wstate.numPerf(well_index); ++perf)
+            BOOST_CHECK(perf_press[perf] > 0);
     }
 }
 